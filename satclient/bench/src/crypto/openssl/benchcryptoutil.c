@@ -0,0 +1,182 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report throughput of the sealed telemetry batch api (in-place aead) for a range of batch sizes,
+   and cold vs. warm start time of non-interactive secret key provisioning for each key derivation function.
+
+ * To compare with and without aes-ni on x86, run the suite twice, the second time masking the aes-ni (and pclmulqdq) capability bits
+ * so openssl falls back to its portable implementation (run_bench_exe.sh does both):
+ *
+ * ./build/bin/bench/benchcryptoutil
+ * OPENSSL_ia32cap="~0x200000200000000" ./build/bin/bench/benchcryptoutil
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h, stdlib.h, and unistd.h so we can use "clock_gettime", "setenv", and "mkstemp" functions
+
+#include <stdio.h>          //using for "printf" function
+#include <stdlib.h>         //using for "getenv", "setenv", and "mkstemp" functions and "EXIT_..." macros
+#include <string.h>         //using for "memset" and "strlen" functions
+#include <time.h>           //using for "clock_gettime" function
+#include <unistd.h>         //using for "write", "close", and "unlink" functions
+#include "satmemory.h"      //using to free the buffers the crypto functions allocate
+#include "cryptoutil.h"     //benchmarking functions in the crypto module
+#include "keyprovisioner.h" //benchmarking key provisioning
+
+//global vars
+static const double MIN_SECONDS_PER_CASE = 1.0;                                     //keep sealing batches for at least this long per case so short batches aren't dominated by timer resolution
+static const uint32_t BATCH_SIZES[] = {256, 1024, 4096, 16384, 65536};              //batch sizes (in bytes) to measure, 256 bytes is roughly one json telemetry reading
+static const int BATCH_SIZE_COUNT = sizeof (BATCH_SIZES) / sizeof (BATCH_SIZES[0]);
+static const uint8_t master_key[SEALED_BATCH_KEY_SIZE_BYTES] = {0xfb, 0x59, 0x27, 0xf2, 0x2e, 0xaa, 0x9b, 0x2c, 0x8c, 0x17, 0x37, 0x9d, 0x83, 0xe3, 0x7f, 0xe7, \
+                                                                 0x0e, 0x4e, 0x37, 0xf7, 0x9b, 0x44, 0x37, 0x3c, 0x3b, 0x51, 0xfc, 0x47, 0xa8, 0xbd, 0xc2, 0x7f};
+static uint8_t batch[65536];                                                        //largest batch, reused for every case (sealed in place)
+static const char passphrase[] = "The sparrow flies at sunset.";                     //passphrase used to create the provisioning payloads
+static const char secret_key[] = "c2F0Y2xpZW50IGJlbmNobWFyayBzZWNyZXQga2V5IQ==";   //stand-in base64 encoded secret key
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static void bench_seal_telemetry_batch(AEAD_CIPHER, const char*);
+static void bench_provision_secret_key(KEY_DERIVATION_FUNCTION, uint32_t, const char*);
+int main(void);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//measures seal_telemetry_batch throughput (MB/s) for each batch size using the supplied algorithm
+static void bench_seal_telemetry_batch(AEAD_CIPHER cipher, const char* cipher_name)
+{
+    //local vars
+    SEALED_BATCH_CONTEXT sbcontext;
+    uint8_t nonce[SEALED_BATCH_NONCE_SIZE_BYTES];
+    uint8_t tag[SEALED_BATCH_TAG_SIZE_BYTES];
+    struct timespec start;
+    struct timespec end;
+    double elapsed_seconds;
+    long batches_sealed;
+    int index;
+    int chunk;
+
+    //if this openssl build supports the algorithm
+    if (init_sealed_batch_context(&sbcontext, cipher, master_key, SEALED_BATCH_KEY_SIZE_BYTES))
+    {
+        for (index = 0; index < BATCH_SIZE_COUNT; index++)
+        {
+            batches_sealed = 0;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            //seal batches in chunks of 64 between clock reads until the minimum case duration elapses
+            do
+            {
+                for (chunk = 0; chunk < 64; chunk++)
+                {
+                    seal_telemetry_batch(&sbcontext, NULL, 0, batch, BATCH_SIZES[index], nonce, tag);
+                }
+                batches_sealed += 64;
+                clock_gettime(CLOCK_MONOTONIC, &end);
+                elapsed_seconds = get_elapsed_seconds(&start, &end);
+            } while (elapsed_seconds < MIN_SECONDS_PER_CASE);
+
+            printf("%-18s batch=%6u bytes  %9.1f MB/s  %8.0f ns/batch\n", cipher_name, BATCH_SIZES[index], ((double)batches_sealed * BATCH_SIZES[index]) / (elapsed_seconds * 1e6), (elapsed_seconds * 1e9) / batches_sealed);
+        }
+
+        shutdown_sealed_batch_context(&sbcontext);
+    }
+    else
+    {
+        printf("%-18s unsupported by this openssl build\n", cipher_name);
+    }
+}
+
+//function definition
+//measures cold start (kdf run, cache written) and warm start (cache unsealed) key provisioning time for the supplied kdf and cost
+static void bench_provision_secret_key(KEY_DERIVATION_FUNCTION kdf, uint32_t kdf_cost, const char* kdf_name)
+{
+    //local vars
+    KEY_PROVISIONING_CONFIG config;
+    KEY_PROVISIONING_REPORT cold_report;
+    KEY_PROVISIONING_REPORT warm_report;
+    char payload_location[] = "/tmp/benchcryptoutil_payloadXXXXXX";
+    char cache_location[] = "/tmp/benchcryptoutil_cacheXXXXXX";
+    char* base64_encoded_openssl_payload;
+    uint8_t* plaintext;
+    uint32_t plaintext_size;
+    int fd;
+
+    //create a payload for this kdf and write it to a temporary file
+    if (encrypt_to_base64_encoded_openssl_payload((const uint8_t*)passphrase, strlen(passphrase), kdf, kdf_cost, (const uint8_t*)secret_key, strlen(secret_key), &base64_encoded_openssl_payload))
+    {
+        fd = mkstemp(payload_location);
+        if ((fd >= 0) && (write(fd, base64_encoded_openssl_payload, strlen(base64_encoded_openssl_payload)) == strlen(base64_encoded_openssl_payload)))
+        {
+            //reserve a cache location (the provisioner creates the file itself)
+            close(mkstemp(cache_location));
+
+            //configure provisioning from the environment, then point it at the temporary files
+            setenv("SATCLIENT_PASSPHRASE", passphrase, 1);
+            load_key_provisioning_config_from_environment(&config);
+            config.payload_file_location = payload_location;
+            config.derived_key_cache_location = cache_location;
+            config.allow_interactive_prompt = false;
+            config.kdf = kdf;
+            config.kdf_cost = kdf_cost;
+
+            //cold start (no cache yet)
+            invalidate_derived_key_cache(&config);
+            if (provision_secret_key(&config, &plaintext, &plaintext_size, &cold_report))
+            {
+                free_sat_memory(plaintext);
+
+                //warm start (passphrase no longer available, so this can only succeed from the cache)
+                if (provision_secret_key(&config, &plaintext, &plaintext_size, &warm_report) && warm_report.warm_start)
+                {
+                    free_sat_memory(plaintext);
+                    printf("%-26s cold start %10.3f ms   warm start %8.3f ms\n", kdf_name, cold_report.elapsed_ms, warm_report.elapsed_ms);
+                }
+                else
+                {
+                    printf("%-26s cold start %10.3f ms   warm start unavailable (kernel keyring inaccessible?)\n", kdf_name, cold_report.elapsed_ms);
+                }
+            }
+            else
+            {
+                printf("%-26s unsupported by this openssl build\n", kdf_name);
+            }
+
+            invalidate_derived_key_cache(&config);
+            unlink(cache_location);
+        }
+
+        if (fd >= 0)
+        {
+            close(fd);
+            unlink(payload_location);
+        }
+
+        free_sat_memory(base64_encoded_openssl_payload);
+    }
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //the contents don't matter for throughput, but keep them deterministic
+    memset(batch, 0xA5, sizeof (batch));
+
+    printf("openssl capability mask override (OPENSSL_ia32cap): %s\n", (getenv("OPENSSL_ia32cap") != NULL) ? getenv("OPENSSL_ia32cap") : "none");
+    printf("preferred aead cipher on this cpu: %s\n", (get_preferred_aead_cipher() == AES256GCM) ? "aes-256-gcm" : "chacha20-poly1305");
+
+    //run benchmarks
+    bench_seal_telemetry_batch(AES256GCM, "aes-256-gcm");
+    bench_seal_telemetry_batch(CHACHA20POLY1305, "chacha20-poly1305");
+    bench_provision_secret_key(OPENSSL_BYTESTOKEY, 1, "bytestokey (1 round)");
+    bench_provision_secret_key(PBKDF2_SHA256, 100000, "pbkdf2-sha256 (100000 iter)");
+    bench_provision_secret_key(SCRYPT, 14, "scrypt (N=2^14, r=8, p=1)");
+
+    return EXIT_SUCCESS;
+}
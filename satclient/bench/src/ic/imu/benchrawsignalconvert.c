@@ -0,0 +1,143 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost per sample of scaling FIFO sized batches (32 samples) of raw xyz readings
+   with each conversion kernel this host supports, against the per axis double precision conversion the
+   lsm9ds0 driver does one reading at a time.
+
+ * ./build/bin/bench/benchrawsignalconvert
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <time.h>               //using for "clock_gettime" function
+#include "rawsignalconvert.h"   //benchmarking the conversion kernels
+
+//global vars
+#define FIFO_SAMPLE_COUNT 32                        //samples drained from a sensor's FIFO at once
+static const uint32_t ITERATIONS = 2000000;         //batches converted per measurement
+static const float SCALE_FACTOR = 0.000061f;        //accelerometer scale factor at +/-2g
+static uint8_t buffer[FIFO_SAMPLE_COUNT * 6];
+static float x[FIFO_SAMPLE_COUNT];
+static float y[FIFO_SAMPLE_COUNT];
+static float z[FIFO_SAMPLE_COUNT];
+static volatile double sink;                        //keeps the results observable so the loops aren't optimized away
+
+//per reading representation used by the driver (see LSM9DS0_SIGNAL_READING)
+typedef struct bench_signal_reading
+{
+    double x;
+    double y;
+    double z;
+}BENCH_SIGNAL_READING;
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static double bench_per_reading_conversion(void);
+static double bench_kernel_conversion(RAW_SIGNAL_CONVERSION_KERNEL);
+int main(void);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//assemble, convert, and scale each axis of each reading separately in double precision (as get_latest_signal_reading does), returns ns per sample
+static double bench_per_reading_conversion(void)
+{
+    //local vars
+    static BENCH_SIGNAL_READING readings[FIFO_SAMPLE_COUNT];
+    const double scale_factor = SCALE_FACTOR;
+    struct timespec start;
+    struct timespec end;
+    const uint8_t* data_buffer;
+    uint32_t iteration;
+    uint32_t i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        for (i = 0; i < FIFO_SAMPLE_COUNT; i++)
+        {
+            data_buffer = &(buffer[i * 6]);
+            readings[i].x = (int16_t)((((uint16_t)data_buffer[1]) << 8) | ((uint16_t)data_buffer[0])) * scale_factor;
+            readings[i].y = (int16_t)((((uint16_t)data_buffer[3]) << 8) | ((uint16_t)data_buffer[2])) * scale_factor;
+            readings[i].z = (int16_t)((((uint16_t)data_buffer[5]) << 8) | ((uint16_t)data_buffer[4])) * scale_factor;
+        }
+        sink += readings[iteration % FIFO_SAMPLE_COUNT].x;
+        //the buffer changes every batch, as it would coming off the sensor
+        buffer[iteration % sizeof (buffer)]++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (get_elapsed_seconds(&start, &end) / ((double)ITERATIONS * FIFO_SAMPLE_COUNT)) * 1e9;
+}
+
+//function definition
+//convert whole batches with a kernel, returns ns per sample
+static double bench_kernel_conversion(RAW_SIGNAL_CONVERSION_KERNEL kernel)
+{
+    //local vars
+    struct timespec start;
+    struct timespec end;
+    uint32_t iteration;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        convert_raw_signal_buffer(kernel, buffer, FIFO_SAMPLE_COUNT, SCALE_FACTOR, x, y, z);
+        sink += x[iteration % FIFO_SAMPLE_COUNT];
+        //the buffer changes every batch, as it would coming off the sensor
+        buffer[iteration % sizeof (buffer)]++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (get_elapsed_seconds(&start, &end) / ((double)ITERATIONS * FIFO_SAMPLE_COUNT)) * 1e9;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    const RAW_SIGNAL_CONVERSION_KERNEL kernels[] = {SCALAR_CONVERSION_KERNEL, SSE2_CONVERSION_KERNEL, AVX2_CONVERSION_KERNEL, NEON_CONVERSION_KERNEL};
+    double baseline_ns;
+    double kernel_ns;
+    uint32_t i;
+
+    //synthetic raw readings
+    for (i = 0; i < sizeof (buffer); i++)
+    {
+        buffer[i] = (uint8_t)((i * 37) + 11);
+    }
+
+    baseline_ns = bench_per_reading_conversion();
+    printf("per reading (double, one axis at a time): %.2f ns per sample\n", baseline_ns);
+
+    for (i = 0; i < (sizeof (kernels) / sizeof (kernels[0])); i++)
+    {
+        //skip kernels this host can't run
+        if (!is_raw_signal_conversion_kernel_available(kernels[i]))
+        {
+            printf("%s kernel: not available on this host\n", get_raw_signal_conversion_kernel_name(kernels[i]));
+            continue;
+        }
+
+        kernel_ns = bench_kernel_conversion(kernels[i]);
+        printf("%s kernel (batches of %d): %.2f ns per sample (%.1fx)%s\n",
+               get_raw_signal_conversion_kernel_name(kernels[i]),
+               FIFO_SAMPLE_COUNT,
+               kernel_ns,
+               baseline_ns / kernel_ns,
+               (kernels[i] == get_preferred_raw_signal_conversion_kernel()) ? " <- preferred" : "");
+    }
+
+    //exit program, clean return code
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the write rate and cpu cost per sample of the columnar (memory mapped) telemetry sink,
+   relative to the ~100 samples per second the lsm9ds0 produces, and verify the file through the companion reader.
+
+ * ./build/bin/bench/benchcolumnarsink [file location]
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <time.h>               //using for "clock_gettime" function
+#include <unistd.h>             //using for "unlink" function
+#include "columnarsink.h"       //benchmarking the columnar sink
+#include "columnarfile.h"       //verifying through the columnar file reader
+
+//global vars
+static const uint32_t SAMPLE_COUNT = 4000000;                               //~11 hours of lsm9ds0 samples at 100hz
+static const double SENSOR_SAMPLE_RATE = 100.0;                             //samples per second produced by the lsm9ds0
+static const char DEFAULT_FILE_LOCATION[] = "/tmp/benchcolumnarsink.col";   //file written when none is supplied
+static TELEMETRY_BATCH batch;                                               //batch reused for every publish
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static int16_t get_synthetic_axis_value(uint32_t, uint32_t);
+static bool verify_columnar_file(const char*);
+int main(int, char**);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//deterministic stand-in for a raw axis value, so the reader can check what it gets back
+static int16_t get_synthetic_axis_value(uint32_t sample_index, uint32_t axis)
+{
+    return (int16_t)((sample_index * 31) + (axis * 4099));
+}
+
+//function definition
+//read the file back through the companion reader and check every sample
+static bool verify_columnar_file(const char* file_location)
+{
+    //local vars
+    COLUMNAR_FILE_READER reader;
+    COLUMNAR_PAGE_VIEW view;
+    uint64_t sample_count;
+    uint64_t page_index = 0;
+    uint32_t sample_index = 0;
+    uint32_t i;
+    uint32_t axis;
+    bool operation_status = false;
+
+    //if the file was successfully opened
+    if (open_columnar_file_reader(&reader, file_location))
+    {
+        sample_count = get_columnar_file_sample_count(&reader);
+        operation_status = (sample_count == SAMPLE_COUNT);
+
+        //walk every page, checking the columns
+        while (operation_status && (sample_index < sample_count) && get_columnar_file_page(&reader, page_index++, &view))
+        {
+            for (i = 0; i < view.sample_count; i++, sample_index++)
+            {
+                operation_status &= (view.timestamps_ns[i] == (int64_t)sample_index * 10000000);
+
+                for (axis = 0; axis < COLUMNAR_FILE_AXIS_COUNT; axis++)
+                {
+                    operation_status &= (view.axes[axis][i] == get_synthetic_axis_value(sample_index, axis));
+                }
+            }
+        }
+
+        operation_status &= (sample_index == SAMPLE_COUNT);
+
+        close_columnar_file_reader(&reader);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//main thread of execution
+int main(int argc, char** argv)
+{
+    //local vars
+    const char* file_location = (argc > 1) ? argv[1] : DEFAULT_FILE_LOCATION;
+    TELEMETRY_SINK* sink;
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    struct timespec start;
+    struct timespec end;
+    struct timespec cpu_start;
+    struct timespec cpu_end;
+    double elapsed_seconds;
+    double cpu_seconds;
+    uint32_t sample_index;
+    uint32_t i;
+
+    sink = new_columnar_telemetry_sink(file_location);
+
+    //if the sink was successfully created and opened
+    if ((sink != NULL) && open_telemetry_sink(sink))
+    {
+        set_sample_batch_scale_factors(&(batch.samples), 0.000061, 0.00008, 0.00875);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+
+        //publish full batches of synthetic samples (10ms apart)
+        for (sample_index = 0; sample_index < SAMPLE_COUNT; )
+        {
+            clear_telemetry_batch(&batch);
+
+            while ((batch.samples.sample_count < SAMPLE_BATCH_MAX_SAMPLES) && (sample_index < SAMPLE_COUNT))
+            {
+                for (i = 0; i < SAMPLE_BATCH_AXIS_COUNT; i++)
+                {
+                    values[i] = get_synthetic_axis_value(sample_index, i);
+                }
+
+                append_sample_to_sample_batch(&(batch.samples), (int64_t)sample_index * 10000000, values);
+                sample_index++;
+            }
+
+            publish_telemetry_batch_to_sink(sink, &batch);
+        }
+
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        free_telemetry_sink(sink);
+
+        elapsed_seconds = get_elapsed_seconds(&start, &end);
+        cpu_seconds = get_elapsed_seconds(&cpu_start, &cpu_end);
+
+        printf("columnar sink: %u samples in %.3f s -> %.2f M samples/s (%.0fx the sensor rate), %.1f ns cpu per sample, %.5f%% of one core at %.0f hz\n",
+               SAMPLE_COUNT,
+               elapsed_seconds,
+               (SAMPLE_COUNT / elapsed_seconds) / 1e6,
+               (SAMPLE_COUNT / elapsed_seconds) / SENSOR_SAMPLE_RATE,
+               (cpu_seconds / SAMPLE_COUNT) * 1e9,
+               ((cpu_seconds / SAMPLE_COUNT) * SENSOR_SAMPLE_RATE) * 100.0,
+               SENSOR_SAMPLE_RATE);
+
+        //check the file through the companion reader
+        if (verify_columnar_file(file_location))
+        {
+            printf("columnar reader: all %u samples verified\n", SAMPLE_COUNT);
+            unlink(file_location);
+
+            //exit program, clean return code
+            return EXIT_SUCCESS;
+        }
+
+        printf("columnar reader: verification FAILED\n");
+    }
+
+    //exit program, with failure
+    return EXIT_FAILURE;
+}
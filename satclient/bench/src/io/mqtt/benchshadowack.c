@@ -0,0 +1,231 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost of tracking a thing shadow update's ack with a number of other updates in
+   flight: sending the update (its client token is added to the ack slot table and timing wheel), the service's ack
+   (matched to it by client token), and a yield (the timing wheel checked for acks timing out). The cost should be the
+   same however many updates are in flight.
+
+   The mqtt client is left out, the ack handler the sdk subscribes with is captured and called with each ack.
+
+ * ./build/bin/bench/benchshadowack
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>                      //using for "printf" and "snprintf" functions
+#include <stdlib.h>                     //using for "EXIT_..." macros
+#include <string.h>                     //using for "strcpy" function
+#include <time.h>                       //using for "clock_gettime" function
+#include "aws_iot_config.h"
+#include "aws_iot_mqtt_client_interface.h"
+#include "aws_iot_shadow_actions.h"     //benchmarking the ack tracking of an update
+#include "aws_iot_shadow_records.h"
+
+//global vars
+#define DOCUMENT_SIZE 256
+#define ACK_TIMEOUT_SECONDS 30                                                  //long enough for no update to time out during a case
+static const double MIN_SECONDS_PER_CASE = 1.0;                                 //keep sending updates for at least this long per case
+static const uint32_t IN_FLIGHT_COUNTS[] = {1, 8, 32, MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME - 1};  //updates awaiting their ack as each one is sent
+static const char* const THING_NAME = "satclient";
+static const char* const ACCEPTED_TOPIC = "$aws/things/satclient/shadow/update/accepted";
+static pApplicationHandler_t ack_handler;                                       //the sdk's ack handler (captured when it subscribes)
+static uint64_t accepted_count;
+static uint64_t timed_out_count;
+static uint32_t next_sequence;
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static void count_ack(const char*, ShadowActions_t, Shadow_Ack_Status_t, const char*, void*);
+static bool send_update(void);
+static void receive_ack(uint32_t);
+static bool bench_ack_tracking(uint32_t);
+int main(void);
+
+//function definition
+//stand-in for the mqtt client's subscribe, capture the handler the sdk subscribes to the ack topics with
+IoT_Error_t aws_iot_mqtt_subscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, QoS qos, pApplicationHandler_t handler, void* handler_data)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)qos;
+    (void)handler_data;
+    ack_handler = handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's chunk handler setter (acks this small are never streamed)
+IoT_Error_t aws_iot_mqtt_set_chunk_handler(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, pApplicationChunkHandler_t handler)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's unsubscribe (the ack topics are subscribed to for good)
+IoT_Error_t aws_iot_mqtt_unsubscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's publish, the update goes nowhere
+IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, IoT_Publish_Message_Params* parameters)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)parameters;
+
+    return SUCCESS;
+}
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//ack callback of every update
+static void count_ack(const char* thing_name, ShadowActions_t action, Shadow_Ack_Status_t status, const char* document, void* context)
+{
+    (void)thing_name;
+    (void)action;
+    (void)document;
+    (void)context;
+    if (status == SHADOW_ACK_ACCEPTED)
+    {
+        accepted_count++;
+    }
+    else
+    {
+        timed_out_count++;
+    }
+}
+
+//function definition
+//send an update with the next client token (in the form the sdk fills in), returns false if it wasn't tracked
+static bool send_update(void)
+{
+    //local vars
+    char document[DOCUMENT_SIZE];
+
+    snprintf(document, sizeof (document), "{\"state\":{\"reported\":{\"gyro_odr\":190}},\"clientToken\":\"%s-%u\"}", mqttClientID, next_sequence);
+    next_sequence++;
+
+    return aws_iot_shadow_internal_action(THING_NAME, SHADOW_UPDATE, document, count_ack, NULL, ACK_TIMEOUT_SECONDS, true) == SUCCESS;
+}
+
+//function definition
+//hand the sdk the service's ack of the update with the supplied sequence number
+static void receive_ack(uint32_t sequence)
+{
+    //local vars
+    char document[DOCUMENT_SIZE];
+    IoT_Publish_Message_Params parameters;
+
+    parameters.qos = QOS0;
+    parameters.isRetained = 0;
+    parameters.isDup = 0;
+    parameters.id = 0;
+    parameters.payload = document;
+    parameters.payloadLen = (size_t)snprintf(document, sizeof (document), "{\"state\":{\"reported\":{\"gyro_odr\":190}},\"metadata\":{\"reported\":{\"gyro_odr\":{\"timestamp\":1792319094}}},\"version\":%u,\"timestamp\":1792319094,\"clientToken\":\"%s-%u\"}", sequence, mqttClientID, sequence);
+    ack_handler(NULL, (char*)ACCEPTED_TOPIC, (uint16_t)strlen(ACCEPTED_TOPIC), &parameters, NULL);
+}
+
+//function definition
+//time sending an update, receiving the oldest in flight update's ack and a yield, with the supplied number of updates in flight (reporting the time per ack)
+static bool bench_ack_tracking(uint32_t in_flight_count)
+{
+    //local vars
+    struct timespec start;
+    struct timespec end;
+    double elapsed_seconds;
+    uint64_t ack_count = 0;
+    uint32_t oldest_sequence = next_sequence;
+    uint32_t i;
+
+    //fill the in flight updates
+    for (i = 0; i < in_flight_count; i++)
+    {
+        if (!send_update())
+        {
+            fprintf(stderr, "ERROR: FAILED TO SEND UPDATE %u OF %u IN FLIGHT!\n", i + 1, in_flight_count);
+            return false;
+        }
+    }
+
+    accepted_count = 0;
+    timed_out_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        for (i = 0; i < 1000; i++)
+        {
+            if (!send_update())
+            {
+                fprintf(stderr, "ERROR: FAILED TO SEND AN UPDATE WITH %u IN FLIGHT!\n", in_flight_count);
+                return false;
+            }
+            receive_ack(oldest_sequence);
+            oldest_sequence++;
+            HandleExpiredResponseCallbacks();
+        }
+        ack_count += 1000;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsed_seconds = get_elapsed_seconds(&start, &end);
+    } while (elapsed_seconds < MIN_SECONDS_PER_CASE);
+
+    //drain the in flight updates
+    for (i = 0; i < in_flight_count; i++)
+    {
+        receive_ack(oldest_sequence);
+        oldest_sequence++;
+    }
+
+    //every update should have been accepted (and none timed out)
+    if ((accepted_count != (ack_count + in_flight_count)) || (timed_out_count != 0))
+    {
+        fprintf(stderr, "ERROR: %llu UPDATES ACCEPTED AND %llu TIMED OUT, EXPECTED %llu ACCEPTED!\n", (unsigned long long)accepted_count, (unsigned long long)timed_out_count, (unsigned long long)(ack_count + in_flight_count));
+        return false;
+    }
+
+    printf("%2u updates in flight (of %u) %8.1f ns per ack (update, ack and yield)\n", in_flight_count, MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME, (elapsed_seconds / (double)ack_count) * 1e9);
+
+    return true;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    bool operation_status = true;
+    uint32_t i;
+
+    initializeRecords(NULL);
+    strcpy(myThingName, THING_NAME);
+    strcpy(mqttClientID, "satclient-bench");
+
+    for (i = 0; i < (sizeof (IN_FLIGHT_COUNTS) / sizeof (IN_FLIGHT_COUNTS[0])); i++)
+    {
+        operation_status &= bench_ack_tracking(IN_FLIGHT_COUNTS[i]);
+    }
+
+    //exit program, return code reflects if every update was acked as expected
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,311 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost of dispatching a thing shadow delta to the registered keys, with 100 keys
+   registered and deltas (as the service sends them, state and metadata) that change a few of them:
+   - the sdk's dispatch, a single pass over the parsed tokens looking each key up in the sorted index of registered keys
+   - the dispatch it replaced, every registered key scanning the parsed tokens for itself (O(keys x tokens))
+   - the sdk's dispatch of a streamed delta, parsed incrementally as the mqtt client hands it over a read buffer's worth
+     at a time (how deltas larger than the rx buffer, which used to be dropped, are received)
+
+   The mqtt client is left out, the delta handler (and chunk handler) the sdk subscribes with is captured and called
+   with each delta.
+
+ * ./build/bin/bench/benchshadowdelta
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>                      //using for "printf" and "snprintf" functions
+#include <stdlib.h>                     //using for "EXIT_..." macros
+#include <string.h>                     //using for "memcpy" and "strlen" functions
+#include <time.h>                       //using for "clock_gettime" function
+#include "aws_iot_config.h"
+#include "aws_iot_mqtt_client_interface.h"
+#include "aws_iot_shadow_json.h"        //using for the parser the replaced dispatch used
+#include "aws_iot_shadow_records.h"     //benchmarking the delta dispatch
+
+//global vars
+#define REGISTERED_KEY_COUNT 100
+#define KEY_NAME_SIZE 32
+#define STREAMED_DELTA_SIZE 8192                                                //largest delta written for the streamed cases
+#define STREAM_CHUNK_SIZE (AWS_IOT_MQTT_RX_BUF_LEN - 64)                        //the read buffer left for payload chunks after the delta topic
+static const double MIN_SECONDS_PER_CASE = 1.0;                                 //keep dispatching deltas for at least this long per case
+static const char* const KEY_GROUPS[] = {"gyro", "accel", "magneto", "event", "window", "spectrum", "sink", "batch", "heartbeat", "orientation"};
+static const char* const KEY_FIELDS[] = {"odr", "bandwidth", "fsr", "threshold", "delta", "length", "hop", "interval", "latency_ms", "limit"};
+static const uint32_t CHANGED_KEY_COUNTS[] = {1, 3, 6};                         //keys a delta changes (6 is about all a delta with metadata fits in the rx buffer)
+static const uint32_t STREAMED_CHANGED_KEY_COUNTS[] = {6, 20, 60};              //keys a streamed delta changes (all but the first are larger than the rx buffer)
+static char key_names[REGISTERED_KEY_COUNT][KEY_NAME_SIZE];
+static jsonStruct_t keys[REGISTERED_KEY_COUNT];
+static double values[REGISTERED_KEY_COUNT];
+static uint64_t callback_count;
+static pApplicationHandler_t delta_handler;                                     //the sdk's delta handler (captured when it subscribes)
+static pApplicationChunkHandler_t delta_chunk_handler;                          //the sdk's delta chunk handler (captured when it sets it)
+static char scan_buffer[SHADOW_MAX_SIZE_OF_RX_BUFFER];                          //the replaced dispatch's copy of the delta
+
+//kinds of dispatch measured
+typedef enum dispatch_kind
+{
+    SORTED_INDEX_DISPATCH,
+    KEY_SCAN_DISPATCH,
+    STREAMED_DISPATCH
+}DISPATCH_KIND;
+
+static const char* const DISPATCH_KIND_NAMES[] = {"sorted index (single pass)", "every key scans the tokens", "streamed (incremental parse)"};
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static void count_delta_value(const char*, uint32_t, jsonStruct_t*);
+static uint32_t write_delta_document(char*, size_t, uint32_t);
+static void dispatch_delta_by_key_scan(const char*, size_t);
+static void dispatch_delta_by_stream(char*, uint32_t);
+static bool bench_dispatch(DISPATCH_KIND, uint32_t);
+int main(void);
+
+//function definition
+//stand-in for the mqtt client's subscribe, capture the handler the sdk subscribes to the delta topic with
+IoT_Error_t aws_iot_mqtt_subscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, QoS qos, pApplicationHandler_t handler, void* handler_data)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)qos;
+    (void)handler_data;
+    delta_handler = handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's chunk handler setter, capture the chunk handler the sdk sets on the delta topic
+IoT_Error_t aws_iot_mqtt_set_chunk_handler(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, pApplicationChunkHandler_t handler)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    delta_chunk_handler = handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's unsubscribe (not called by the delta dispatch)
+IoT_Error_t aws_iot_mqtt_unsubscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's publish (not called by the delta dispatch)
+IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, IoT_Publish_Message_Params* parameters)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)parameters;
+
+    return SUCCESS;
+}
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//delta callback of every registered key (the value has been parsed into the key's double by then)
+static void count_delta_value(const char* value, uint32_t value_length, jsonStruct_t* key)
+{
+    (void)value;
+    (void)value_length;
+    (void)key;
+    callback_count++;
+}
+
+//function definition
+//write a delta document changing the supplied number of keys (spread over the registered ones), returns its length (0 if it doesn't fit)
+static uint32_t write_delta_document(char* document, size_t document_size, uint32_t changed_key_count)
+{
+    //local vars
+    size_t length;
+    int written;
+    uint32_t i;
+
+    length = (size_t)snprintf(document, document_size, "{\"version\":%u,\"timestamp\":1792319094,\"state\":{", 1000 + changed_key_count);
+    for (i = 0; (i < changed_key_count) && (length < document_size); i++)
+    {
+        written = snprintf(document + length, document_size - length, "%s\"%s\":%u", (i > 0) ? "," : "", key_names[(i * 37 + 11) % REGISTERED_KEY_COUNT], 100 + i);
+        length += (size_t)written;
+    }
+    if (length < document_size)
+    {
+        length += (size_t)snprintf(document + length, document_size - length, "},\"metadata\":{");
+    }
+    for (i = 0; (i < changed_key_count) && (length < document_size); i++)
+    {
+        written = snprintf(document + length, document_size - length, "%s\"%s\":{\"timestamp\":1792319094}", (i > 0) ? "," : "", key_names[(i * 37 + 11) % REGISTERED_KEY_COUNT]);
+        length += (size_t)written;
+    }
+    if (length < document_size)
+    {
+        length += (size_t)snprintf(document + length, document_size - length, "}}");
+    }
+
+    return (length < document_size) ? (uint32_t)length : 0;
+}
+
+//function definition
+//the dispatch the sorted index replaced, each registered key scans the parsed tokens for itself
+static void dispatch_delta_by_key_scan(const char* document, size_t document_length)
+{
+    //local vars
+    int32_t token_count;
+    int32_t value_position;
+    uint32_t value_length;
+    uint32_t i;
+
+    memcpy(scan_buffer, document, document_length);
+    scan_buffer[document_length] = '\0';
+    if (isJsonValidAndParse(scan_buffer, NULL, &token_count))
+    {
+        for (i = 0; i < REGISTERED_KEY_COUNT; i++)
+        {
+            if (isJsonKeyMatchingAndUpdateValue(scan_buffer, NULL, token_count, &(keys[i]), &value_length, &value_position))
+            {
+                keys[i].cb(scan_buffer + value_position, value_length, &(keys[i]));
+            }
+        }
+    }
+}
+
+//function definition
+//hand a delta to the sdk's chunk handler a read buffer's worth at a time, as the mqtt client does with a delta larger than its read buffer
+static void dispatch_delta_by_stream(char* document, uint32_t document_length)
+{
+    //local vars
+    IoT_Publish_Message_Params parameters;
+    uint32_t offset;
+    uint32_t chunk_length;
+
+    parameters.qos = QOS0;
+    parameters.isRetained = 0;
+    parameters.isDup = 0;
+    parameters.id = 0;
+    for (offset = 0; offset < document_length; offset += chunk_length)
+    {
+        chunk_length = ((document_length - offset) < STREAM_CHUNK_SIZE) ? (document_length - offset) : STREAM_CHUNK_SIZE;
+        parameters.payload = document + offset;
+        parameters.payloadLen = chunk_length;
+        delta_chunk_handler(NULL, NULL, 0, &parameters, offset, document_length, NULL);
+    }
+}
+
+//function definition
+//time the dispatch of a delta changing the supplied number of keys (reporting the time per delta)
+static bool bench_dispatch(DISPATCH_KIND kind, uint32_t changed_key_count)
+{
+    //local vars
+    char document[STREAMED_DELTA_SIZE];
+    IoT_Publish_Message_Params parameters;
+    struct timespec start;
+    struct timespec end;
+    double elapsed_seconds;
+    uint64_t delta_count = 0;
+    uint32_t document_length;
+    uint32_t i;
+
+    //only a streamed delta may be larger than the rx buffer
+    document_length = write_delta_document(document, (kind == STREAMED_DISPATCH) ? sizeof (document) : AWS_IOT_MQTT_RX_BUF_LEN, changed_key_count);
+    if (document_length == 0)
+    {
+        fprintf(stderr, "ERROR: A DELTA CHANGING %u KEYS DOESN'T FIT THE %s!\n", changed_key_count, (kind == STREAMED_DISPATCH) ? "DOCUMENT BUFFER" : "RX BUFFER");
+        return false;
+    }
+    parameters.qos = QOS0;
+    parameters.isRetained = 0;
+    parameters.isDup = 0;
+    parameters.id = 0;
+    parameters.payload = document;
+    parameters.payloadLen = document_length;
+
+    callback_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        for (i = 0; i < 1000; i++)
+        {
+            if (kind == SORTED_INDEX_DISPATCH)
+            {
+                delta_handler(NULL, NULL, 0, &parameters, NULL);
+            }
+            else if (kind == KEY_SCAN_DISPATCH)
+            {
+                dispatch_delta_by_key_scan(document, document_length);
+            }
+            else
+            {
+                dispatch_delta_by_stream(document, document_length);
+            }
+        }
+        delta_count += 1000;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsed_seconds = get_elapsed_seconds(&start, &end);
+    } while (elapsed_seconds < MIN_SECONDS_PER_CASE);
+
+    //every changed key should have been handed its value once per delta
+    if (callback_count != (delta_count * changed_key_count))
+    {
+        fprintf(stderr, "ERROR: %s DISPATCHED %llu VALUES, EXPECTED %llu!\n", DISPATCH_KIND_NAMES[kind], (unsigned long long)callback_count, (unsigned long long)(delta_count * changed_key_count));
+        return false;
+    }
+
+    printf("%-28s %2u of %u keys changed (%4u byte delta) %8.1f ns per delta\n", DISPATCH_KIND_NAMES[kind], changed_key_count, REGISTERED_KEY_COUNT, document_length, (elapsed_seconds / (double)delta_count) * 1e9);
+
+    return true;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    bool operation_status = true;
+    uint32_t i;
+
+    //register every key, the deltas carry the same version so none is discarded as old
+    initDeltaTokens();
+    shadowDiscardOldDeltaFlag = false;
+    for (i = 0; i < REGISTERED_KEY_COUNT; i++)
+    {
+        snprintf(key_names[i], KEY_NAME_SIZE, "%s_%s", KEY_GROUPS[i / 10], KEY_FIELDS[i % 10]);
+        keys[i].pKey = key_names[i];
+        keys[i].pData = &(values[i]);
+        keys[i].type = SHADOW_JSON_DOUBLE;
+        keys[i].cb = count_delta_value;
+        if (registerJsonTokenOnDelta(&(keys[i])) != SUCCESS)
+        {
+            fprintf(stderr, "ERROR: FAILED TO REGISTER DELTA KEY %s!\n", key_names[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < (sizeof (CHANGED_KEY_COUNTS) / sizeof (CHANGED_KEY_COUNTS[0])); i++)
+    {
+        operation_status &= bench_dispatch(SORTED_INDEX_DISPATCH, CHANGED_KEY_COUNTS[i]);
+        operation_status &= bench_dispatch(KEY_SCAN_DISPATCH, CHANGED_KEY_COUNTS[i]);
+    }
+    for (i = 0; i < (sizeof (STREAMED_CHANGED_KEY_COUNTS) / sizeof (STREAMED_CHANGED_KEY_COUNTS[0])); i++)
+    {
+        operation_status &= bench_dispatch(STREAMED_DISPATCH, STREAMED_CHANGED_KEY_COUNTS[i]);
+    }
+
+    //exit program, return code reflects if every delta was dispatched as expected
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the hot path cost of the metrics: a counter increment, a histogram record, and
+   the clock read a timed section takes (twice), each from one and several threads at once, against a single
+   atomically incremented counter shared by the threads (what the per thread shards avoid).
+
+ * ./build/bin/bench/benchmetrics
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <time.h>               //using for "clock_gettime" function
+#include <pthread.h>            //using for the updating threads
+#include "metrics.h"            //benchmarking the metrics
+
+//global vars
+#define MAX_THREAD_COUNT 4
+static const uint32_t ITERATIONS = 10000000;        //updates per thread per measurement
+static const uint32_t THREAD_COUNTS[] = {1, MAX_THREAD_COUNT};
+static uint64_t shared_counter;                     //the contended alternative to a sharded counter
+static volatile int64_t sink;                       //keeps the results observable so the loops aren't optimized away
+
+//kinds of update measured
+typedef enum update_kind
+{
+    COUNTER_UPDATE,
+    HISTOGRAM_UPDATE,
+    CLOCK_READ,
+    SHARED_ATOMIC_UPDATE
+}UPDATE_KIND;
+
+static const char* const UPDATE_KIND_NAMES[] = {"increment_metrics_counter", "record_metrics_histogram", "get_metrics_time_ns", "shared __atomic_fetch_add"};
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static void* run_updates(void*);
+static bool bench_update(UPDATE_KIND, uint32_t);
+int main(void);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//make ITERATIONS updates of one kind
+static void* run_updates(void* parameter)
+{
+    //local vars
+    UPDATE_KIND kind = *((const UPDATE_KIND*)parameter);
+    int64_t total = 0;
+    uint32_t i;
+
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        switch (kind)
+        {
+            case COUNTER_UPDATE:
+                increment_metrics_counter(METRICS_BYTES_SENT, i);
+                break;
+            case HISTOGRAM_UPDATE:
+                record_metrics_histogram(METRICS_ENCODE_NS, (i & 0xFFFF) * 37);
+                break;
+            case CLOCK_READ:
+                total += get_metrics_time_ns();
+                break;
+            case SHARED_ATOMIC_UPDATE:
+                __atomic_fetch_add(&shared_counter, i, __ATOMIC_RELAXED);
+                break;
+        }
+    }
+    sink += total;
+
+    return NULL;
+}
+
+//function definition
+//time ITERATIONS updates of one kind on each of thread_count threads (reporting the wall time per update per thread)
+static bool bench_update(UPDATE_KIND kind, uint32_t thread_count)
+{
+    //local vars
+    struct timespec start;
+    struct timespec end;
+    pthread_t threads[MAX_THREAD_COUNT];
+    uint32_t i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&(threads[i]), NULL, run_updates, &kind) != 0)
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("%-28s %u thread(s) %7.2f ns per update\n", UPDATE_KIND_NAMES[kind], thread_count, (get_elapsed_seconds(&start, &end) / (double)ITERATIONS) * 1e9);
+
+    return true;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    bool operation_status = true;
+    uint32_t kind;
+    uint32_t i;
+
+    for (kind = COUNTER_UPDATE; kind <= SHARED_ATOMIC_UPDATE; kind++)
+    {
+        for (i = 0; i < (sizeof (THREAD_COUNTS) / sizeof (THREAD_COUNTS[0])); i++)
+        {
+            operation_status &= bench_update((UPDATE_KIND)kind, THREAD_COUNTS[i]);
+        }
+    }
+
+    //exit program, return code reflects if every thread was started
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
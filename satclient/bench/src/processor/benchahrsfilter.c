@@ -0,0 +1,242 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost per update of the ahrs (sensor fusion) filter against the ~10ms between
+   lsm9ds0 samples, replaying a recording made by the columnar sink (SATCLIENT_SINKS=columnar) when one is supplied,
+   or else a synthetic recording of the board spinning level at 30 dps (for which the heading error is also reported).
+
+ * ./build/bin/bench/benchahrsfilter [columnar file location]
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <math.h>               //using for "sinf", "cosf", "lrintf", and "fmodf" functions
+#include <time.h>               //using for "clock_gettime" function
+#include "ahrsfilter.h"         //benchmarking the ahrs filter
+#include "columnarfile.h"       //reading recordings made by the columnar sink
+
+//global vars
+#define TRACE_MAX_BATCHES 1875                      //60000 samples (~10 minutes at 100hz) replayed at most
+static const uint32_t MIN_UPDATES = 2000000;        //the recording is replayed until at least this many updates are measured
+static const uint32_t SYNTHETIC_SAMPLE_COUNT = 6000;    //~1 minute at 100hz
+static const float SYNTHETIC_YAW_RATE = 30.0f;      //dps
+static const double SENSOR_SAMPLE_PERIOD_NS = 10000000.0;   //~100 samples per second produced by the lsm9ds0
+static SAMPLE_BATCH batches[TRACE_MAX_BATCHES];     //recording, in the batches the processor would have filled
+static uint32_t batch_count;
+static double scale_factors[3];                     //accel, magneto, gyro scale factors of the recording
+static volatile float sink;                         //keeps the results observable so the loops aren't optimized away
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static void append_to_trace(int64_t, const int16_t*);
+static bool load_columnar_trace(const char*);
+static void load_synthetic_trace(void);
+static bool replay_trace(AHRS_FILTER*, uint64_t*);
+int main(int, char**);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//add a sample onto the end of the recording
+static void append_to_trace(int64_t timestamp_ns, const int16_t* values)
+{
+    if ((batch_count == 0) || (batches[batch_count - 1].sample_count == SAMPLE_BATCH_MAX_SAMPLES))
+    {
+        clear_sample_batch(&(batches[batch_count++]));
+    }
+
+    append_sample_to_sample_batch(&(batches[batch_count - 1]), timestamp_ns, values);
+}
+
+//function definition
+//load (the start of) a recording made by the columnar sink
+static bool load_columnar_trace(const char* file_location)
+{
+    //local vars
+    COLUMNAR_FILE_READER reader;
+    COLUMNAR_PAGE_VIEW view;
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint64_t sample_count;
+    uint64_t page_index;
+    uint32_t i;
+    uint32_t axis;
+
+    //if the file was successfully opened
+    if (open_columnar_file_reader(&reader, file_location))
+    {
+        //the columnar axes are in sample batch order
+        scale_factors[0] = reader.header->scale_factors[COLUMNAR_ACCEL_X];
+        scale_factors[1] = reader.header->scale_factors[COLUMNAR_MAGNETO_X];
+        scale_factors[2] = reader.header->scale_factors[COLUMNAR_GYRO_X];
+
+        sample_count = get_columnar_file_sample_count(&reader);
+        for (page_index = 0; (sample_count > 0) && (batch_count < TRACE_MAX_BATCHES) && get_columnar_file_page(&reader, page_index, &view); page_index++)
+        {
+            for (i = 0; (i < view.sample_count) && (sample_count > 0); i++, sample_count--)
+            {
+                for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+                {
+                    values[axis] = view.axes[axis][i];
+                }
+
+                append_to_trace(view.timestamps_ns[i], values);
+
+                //stop once the recording is full
+                if ((batch_count == TRACE_MAX_BATCHES) && (batches[batch_count - 1].sample_count == SAMPLE_BATCH_MAX_SAMPLES))
+                {
+                    break;
+                }
+            }
+        }
+
+        close_columnar_file_reader(&reader);
+
+        return (batch_count > 0);
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO OPEN COLUMNAR FILE %s!\n", file_location);
+
+    //failure
+    return false;
+}
+
+//function definition
+//synthesize a recording of the board spinning level about z (gravity straight down, the field pointing north and down), with a little sensor noise
+static void load_synthetic_trace(void)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t noise_state = 1;
+    float yaw;
+    uint32_t i;
+    uint32_t axis;
+
+    scale_factors[0] = 0.000061;
+    scale_factors[1] = 0.00008;
+    scale_factors[2] = 0.00875;
+
+    for (i = 0; i < SYNTHETIC_SAMPLE_COUNT; i++)
+    {
+        yaw = SYNTHETIC_YAW_RATE * 0.0174532925f * (float)(i * SENSOR_SAMPLE_PERIOD_NS / 1e9);
+
+        values[SAMPLE_ACCEL_X] = 0;
+        values[SAMPLE_ACCEL_Y] = 0;
+        values[SAMPLE_ACCEL_Z] = (int16_t)lrintf(1.0f / (float)scale_factors[0]);
+        values[SAMPLE_MAGNETO_X] = (int16_t)lrintf((0.3f * cosf(yaw)) / (float)scale_factors[1]);
+        values[SAMPLE_MAGNETO_Y] = (int16_t)lrintf((-0.3f * sinf(yaw)) / (float)scale_factors[1]);
+        values[SAMPLE_MAGNETO_Z] = (int16_t)lrintf(-0.5f / (float)scale_factors[1]);
+        values[SAMPLE_GYRO_X] = 0;
+        values[SAMPLE_GYRO_Y] = 0;
+        values[SAMPLE_GYRO_Z] = (int16_t)lrintf(SYNTHETIC_YAW_RATE / (float)scale_factors[2]);
+
+        //+/-8 lsb of noise on every axis
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            noise_state = (noise_state * 1103515245) + 12345;
+            values[axis] += (int16_t)((noise_state >> 16) % 17) - 8;
+        }
+
+        append_to_trace((int64_t)(i * SENSOR_SAMPLE_PERIOD_NS), values);
+    }
+}
+
+//function definition
+//fuse every sample of the recording, one at a time as the processor does (scaling included)
+static bool replay_trace(AHRS_FILTER* filter, uint64_t* update_count)
+{
+    //local vars
+    uint32_t batch_index;
+    uint32_t i;
+    bool operation_status = true;
+
+    for (batch_index = 0; batch_index < batch_count; batch_index++)
+    {
+        //force the batch to be scaled again, as a freshly acquired one would be
+        set_sample_batch_scale_factors(&(batches[batch_index]), scale_factors[0], scale_factors[1], scale_factors[2]);
+
+        for (i = 0; i < batches[batch_index].sample_count; i++)
+        {
+            operation_status &= update_ahrs_filter(filter, &(batches[batch_index]), i);
+        }
+
+        *update_count += batches[batch_index].sample_count;
+    }
+
+    sink += filter->quaternion[0];
+
+    return operation_status;
+}
+
+//function definition
+//main thread of execution
+int main(int argc, char** argv)
+{
+    //local vars
+    AHRS_FILTER filter;
+    AHRS_ORIENTATION orientation;
+    struct timespec start;
+    struct timespec end;
+    uint64_t update_count = 0;
+    uint64_t trace_sample_count;
+    double update_ns;
+    float yaw_error;
+    bool operation_status = true;
+
+    //load the recording
+    if (argc > 1)
+    {
+        if (!load_columnar_trace(argv[1]))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        load_synthetic_trace();
+    }
+    trace_sample_count = ((uint64_t)(batch_count - 1) * SAMPLE_BATCH_MAX_SAMPLES) + batches[batch_count - 1].sample_count;
+
+    //accuracy - a single pass from the identity orientation
+    init_ahrs_filter(&filter, 0.1f, 0.01f);
+    operation_status &= replay_trace(&filter, &update_count);
+    get_ahrs_orientation(&filter, &orientation);
+    printf("replayed %llu samples (%s), final orientation: w %.4f x %.4f y %.4f z %.4f, roll %.2f pitch %.2f yaw %.2f degrees\n",
+           (unsigned long long)trace_sample_count,
+           (argc > 1) ? argv[1] : "synthetic",
+           orientation.quaternion[0], orientation.quaternion[1], orientation.quaternion[2], orientation.quaternion[3],
+           orientation.roll, orientation.pitch, orientation.yaw);
+    if (argc <= 1)
+    {
+        //wrap the difference from the true heading into +/-180 degrees
+        yaw_error = fmodf(orientation.yaw - (SYNTHETIC_YAW_RATE * (float)((SYNTHETIC_SAMPLE_COUNT - 1) * SENSOR_SAMPLE_PERIOD_NS / 1e9)), 360.0f);
+        yaw_error += (yaw_error > 180.0f) ? -360.0f : ((yaw_error < -180.0f) ? 360.0f : 0.0f);
+        printf("heading error after %.0f seconds at %.0f dps: %.2f degrees\n", (SYNTHETIC_SAMPLE_COUNT * SENSOR_SAMPLE_PERIOD_NS) / 1e9, SYNTHETIC_YAW_RATE, yaw_error);
+    }
+
+    //cost - replay until enough updates have been measured
+    update_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (update_count < MIN_UPDATES)
+    {
+        operation_status &= replay_trace(&filter, &update_count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    update_ns = (get_elapsed_seconds(&start, &end) / (double)update_count) * 1e9;
+    printf("ahrs filter: %.1f ns per update (%llu updates), %.5f%% of the %.0f ms sample period\n",
+           update_ns,
+           (unsigned long long)update_count,
+           (update_ns / SENSOR_SAMPLE_PERIOD_NS) * 100.0,
+           SENSOR_SAMPLE_PERIOD_NS / 1e6);
+
+    //exit program, return code reflects if every update succeeded
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
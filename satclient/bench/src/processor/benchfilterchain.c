@@ -0,0 +1,114 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost per input sample (all 9 axes) of filter chains that take the accelerometer's
+   highest output data rate (1600hz) down to a 25hz stream, against the 625us between samples at that rate.
+
+ * ./build/bin/bench/benchfilterchain
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <time.h>               //using for "clock_gettime" function
+#include "filterchain.h"        //benchmarking the filter chain
+
+//global vars
+#define INPUT_BATCH_COUNT 64                        //distinct input batches cycled through
+static const float INPUT_RATE_HZ = 1600.0f;         //highest accelerometer output data rate
+static const uint32_t ITERATIONS = 200000;          //batches filtered per measurement
+static const char* const SPECIFICATIONS[] = {"fir:8,fir:8", "lowpass:200,fir:8,fir:8", "average:8,average:8", "lowpass:10,highpass:0.5,fir:8,fir:8"};
+static SAMPLE_BATCH inputs[INPUT_BATCH_COUNT];
+static FILTER_CHAIN chain;
+static SAMPLE_BATCH output;
+static volatile int32_t sink;                       //keeps the results observable so the loops aren't optimized away
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static bool bench_filter_chain(const char*, double*);
+int main(void);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//filter the input batches through a chain, in batches of 32 samples (a sensor's FIFO depth)
+static bool bench_filter_chain(const char* specification, double* sample_ns)
+{
+    //local vars
+    struct timespec start;
+    struct timespec end;
+    uint32_t iteration;
+    uint64_t output_count = 0;
+    bool operation_status = true;
+
+    if (!init_filter_chain(&chain, INPUT_RATE_HZ) || !add_filter_stages_from_specification(&chain, specification))
+    {
+        return false;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        clear_sample_batch(&output);
+        operation_status &= run_filter_chain(&chain, &(inputs[iteration % INPUT_BATCH_COUNT]), &output);
+        output_count += output.sample_count;
+        sink += (output.sample_count > 0) ? output.raw[SAMPLE_ACCEL_X][0] : 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    *sample_ns = (get_elapsed_seconds(&start, &end) / ((double)ITERATIONS * SAMPLE_BATCH_MAX_SAMPLES)) * 1e9;
+    printf("%-40s %6.1fhz out (%llu samples), %6.1f ns per input sample, %.4f%% of the %.0fus sample period\n",
+           specification,
+           chain.output_rate_hz,
+           (unsigned long long)output_count,
+           *sample_ns,
+           (*sample_ns / (1e9 / INPUT_RATE_HZ)) * 100.0,
+           1e6 / INPUT_RATE_HZ);
+
+    return operation_status;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t noise_state = 1;
+    double sample_ns;
+    bool operation_status = true;
+    uint32_t batch_index;
+    uint32_t axis;
+    uint32_t i;
+
+    //synthetic raw samples (pseudo random, so every axis carries content at every frequency)
+    for (batch_index = 0; batch_index < INPUT_BATCH_COUNT; batch_index++)
+    {
+        clear_sample_batch(&(inputs[batch_index]));
+        for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+        {
+            for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+            {
+                noise_state = (noise_state * 1103515245) + 12345;
+                values[axis] = (int16_t)(noise_state >> 16);
+            }
+
+            append_sample_to_sample_batch(&(inputs[batch_index]), ((int64_t)((batch_index * SAMPLE_BATCH_MAX_SAMPLES) + i) * 625000), values);
+        }
+    }
+
+    for (i = 0; i < (sizeof (SPECIFICATIONS) / sizeof (SPECIFICATIONS[0])); i++)
+    {
+        operation_status &= bench_filter_chain(SPECIFICATIONS[i], &sample_ns);
+    }
+
+    //exit program, return code reflects if every chain ran
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
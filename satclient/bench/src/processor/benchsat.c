@@ -0,0 +1,789 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite run the whole SAT process (perform_lsm9ds0_sat) end to end, from register reads to bytes on
+   the wire, for a handful of scenarios, and write the results as json so runs can be compared.
+
+   - the lsm9ds0 boards are simulated at the register level (this suite links in place of the mraa i2c device), either
+     free running (instantaneous transfers, so the client's own cost is measured) or paced at an i2c clock rate
+   - the cloud is a stand-in endpoint, every reading is framed as the mqtt (qos 0) publish the aws sink sends and written
+     over a local socket to a thread that drains it, the tls record overhead of each publish is added to the wire bytes
+   - latency is from the moment a reading's registers were read to the moment its publish was written to the socket
+   - cpu time is of the whole process (including the stand-in endpoint), allocations are the malloc/calloc/realloc calls
+     made by the client (wrapped at link time)
+
+   Each scenario is run a few times and the fastest run reported. When a previous run's json is supplied the results are
+   compared against it, and the suite fails if any scenario's throughput, cpu per sample, or p99 latency got more than 10%
+   worse, or its allocations or wire bytes per sample grew.
+
+ * ./build/bin/bench/benchsat [results json location] [baseline json location]
+ */
+
+#define _GNU_SOURCE                 //enable POSIX and GNU extensions so we can use the "clock_gettime" and "socketpair" functions
+
+#include <stdio.h>              //using for "printf", "fprintf", and "fopen" functions
+#include <stdlib.h>             //using for "qsort" and "strtod" functions and "EXIT_..." macros
+#include <string.h>             //using for "memcpy", "memset", "strstr", and "strlen" functions
+#include <math.h>               //using for "sin" function
+#include <time.h>               //using for "clock_gettime" function
+#include <unistd.h>             //using for "read", "write", and "close" functions
+#include <pthread.h>            //using for the stand-in endpoint's drain thread
+#include <sys/socket.h>         //using for "socketpair" and "shutdown" functions
+#include "i2cdevice.h"          //implementing the simulated i2c device
+#include "telemetrysink.h"      //implementing the stand-in endpoint's sink
+#include "lsm9ds0processor.h"   //benchmarking the SAT process
+#include "satconfig.h"          //using for the default configuration
+
+//global vars
+#define SIMULATED_DEVICE_MAX_COUNT (LSM9DS0_SAT_MAX_DEVICES * 2)   //two i2c devices (gyro, accel/magneto) per board
+#define LATENCY_MAX_COUNT 65536                         //readings whose latency is recorded (at most)
+#define MQTT_FRAME_MAX_SIZE (sizeof (TELEMETRY_READING) + 64)   //largest publish packet (a reading plus the fixed header and topic)
+static const char MQTT_PUBLISH_TOPIC[] = "satclient/telemetry";  //topic the stand-in publishes to (the length is all that matters)
+static const uint32_t TLS_RECORD_OVERHEAD = 29;         //bytes per tls 1.2 aes-gcm record (5 byte header, 8 byte explicit nonce, 16 byte tag)
+static const double REGRESSION_TOLERANCE = 0.10;        //largest fraction a timing metric may get worse by before a comparison fails
+static const double GROWTH_TOLERANCE = 0.01;            //largest fraction a count metric may grow by (the json is rounded)
+static const uint32_t REPETITIONS = 3;                  //runs of each scenario, the fastest is reported
+static const char DEFAULT_RESULTS_LOCATION[] = "satbench.json";
+
+//simulated i2c device representation (one per i2c address of a board)
+typedef struct simulated_i2c_device
+{
+    const I2C_DEVICE* device;       //handle the driver addresses the device through
+    int i2c_bus;
+    uint8_t address;
+    uint8_t registers[256];         //register file (configuration writes land here)
+    uint32_t reading_count;         //readings produced (drives the synthetic signal)
+}SIMULATED_I2C_DEVICE;
+
+//scenario representation
+typedef struct satbench_scenario
+{
+    const char* name;
+    uint32_t device_count;          //boards, spread across the buses (two per bus at most)
+    uint32_t bus_count;
+    uint32_t i2c_clock_hz;          //simulated bus clock (0 for instantaneous transfers)
+    bool summarize;                 //publish window summaries, orientations, and spectral features alongside the readings
+    int processing_limit;           //readings published per board
+}SATBENCH_SCENARIO;
+
+//measurements of a scenario representation
+typedef struct satbench_result
+{
+    bool operation_status;
+    double elapsed_seconds;
+    double cpu_seconds;
+    uint64_t allocation_count;
+    uint64_t reading_count;         //samples published (whose latency is known)
+    uint64_t message_count;         //mqtt publishes (readings, summaries, orientations, and features)
+    uint64_t wire_bytes;            //mqtt bytes plus tls record overhead
+    uint64_t received_bytes;        //mqtt bytes the stand-in endpoint drained
+    int64_t latency_p50_ns;
+    int64_t latency_p99_ns;
+    int64_t latency_p999_ns;
+}SATBENCH_RESULT;
+
+//stand-in endpoint representation
+typedef struct stand_in_endpoint
+{
+    int socket_fds[2];              //[0] the client's end, [1] the endpoint's end
+    pthread_t drain_thread;
+    uint64_t received_bytes;        //written by the drain thread, read once it has been joined
+}STAND_IN_ENDPOINT;
+
+static const SATBENCH_SCENARIO SCENARIOS[] =
+{
+    {"readings", 1, 1, 0, false, 100000},
+    {"readings_and_summaries", 1, 1, 0, true, 100000},
+    {"one_board_400khz", 1, 1, 400000, false, 500},
+    {"two_boards_one_bus_400khz", 2, 1, 400000, false, 500},
+    {"two_boards_two_buses_400khz", 2, 2, 400000, false, 500}
+};
+static SIMULATED_I2C_DEVICE simulated_devices[SIMULATED_DEVICE_MAX_COUNT];
+static uint32_t simulated_device_count;
+static uint32_t simulated_i2c_clock_hz;
+static STAND_IN_ENDPOINT endpoint;
+static SATBENCH_RESULT result;                          //measurements of the running scenario
+static int64_t latencies_ns[LATENCY_MAX_COUNT];
+static uint64_t allocation_count;                       //updated atomically, the bus threads allocate concurrently
+
+//function declarations
+void* __real_malloc(size_t);
+void* __real_calloc(size_t, size_t);
+void* __real_realloc(void*, size_t);
+void* __wrap_malloc(size_t);
+void* __wrap_calloc(size_t, size_t);
+void* __wrap_realloc(void*, size_t);
+static SIMULATED_I2C_DEVICE* find_simulated_i2c_device(const I2C_DEVICE*);
+static void wait_for_simulated_transfer(uint32_t);
+static void read_simulated_reading(SIMULATED_I2C_DEVICE*, uint8_t, uint8_t*);
+static bool open_stand_in_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_stand_in_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_stand_in_sink(TELEMETRY_SINK*);
+static bool close_stand_in_sink(TELEMETRY_SINK*);
+static void* run_stand_in_endpoint(void*);
+static int64_t get_monotonic_time_ns(void);
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static int compare_latencies(const void*, const void*);
+static bool run_scenario(const SATBENCH_SCENARIO*, SATBENCH_RESULT*);
+static void write_result(FILE*, const SATBENCH_SCENARIO*, const SATBENCH_RESULT*);
+static bool compare_result(const char*, const SATBENCH_SCENARIO*, const SATBENCH_RESULT*);
+static double get_baseline_metric(const char*, const char*);
+static bool check_metric(const char*, const char*, double, double, double, bool);
+int main(int, char**);
+
+//stand-in endpoint's sink implementation
+static const TELEMETRY_SINK_INTERFACE STAND_IN_SINK_INTERFACE =
+{
+    open_stand_in_sink,
+    publish_batch_to_stand_in_sink,
+    flush_stand_in_sink,
+    close_stand_in_sink,
+    NULL
+};
+
+//function definition
+//count the client's allocations
+void* __wrap_malloc(size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+//function definition
+//count the client's allocations
+void* __wrap_calloc(size_t count, size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+//function definition
+//count the client's allocations
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    __atomic_fetch_add(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_realloc(pointer, size);
+}
+
+//function definition
+//simulated i2c device: attach a handle to the device at an address on a bus (the device is created the first time it is addressed)
+bool init_i2c_device(I2C_DEVICE* device, const int i2c_bus, const uint8_t address)
+{
+    //local vars
+    uint32_t i;
+
+    for (i = 0; i < simulated_device_count; i++)
+    {
+        if ((simulated_devices[i].i2c_bus == i2c_bus) && (simulated_devices[i].address == address))
+        {
+            simulated_devices[i].device = device;
+            return true;
+        }
+    }
+
+    if (simulated_device_count == SIMULATED_DEVICE_MAX_COUNT)
+    {
+        return false;
+    }
+
+    memset(&(simulated_devices[simulated_device_count]), 0, sizeof (SIMULATED_I2C_DEVICE));
+    simulated_devices[simulated_device_count].device = device;
+    simulated_devices[simulated_device_count].i2c_bus = i2c_bus;
+    simulated_devices[simulated_device_count].address = address;
+    simulated_device_count++;
+
+    return true;
+}
+
+//function definition
+//simulated i2c device: detach the handle
+void shutdown_i2c_device(I2C_DEVICE* device)
+{
+    //local vars
+    SIMULATED_I2C_DEVICE* simulated_device = find_simulated_i2c_device(device);
+
+    if (simulated_device != NULL)
+    {
+        simulated_device->device = NULL;
+    }
+}
+
+//function definition
+//simulated i2c device: read a register (a new reading is always available, the device is free running)
+bool read_byte(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* value)
+{
+    //local vars
+    SIMULATED_I2C_DEVICE* simulated_device = find_simulated_i2c_device(device);
+    bool is_gyro;
+
+    if ((simulated_device == NULL) || (value == NULL))
+    {
+        return false;
+    }
+    is_gyro = ((simulated_device->address == LSM9DS0_GYRO_ADDRESS) || (simulated_device->address == LSM9DS0_GYRO_ALTERNATE_ADDRESS));
+
+    //address, register, address, data
+    wait_for_simulated_transfer(4);
+
+    switch (register_addr)
+    {
+        case 0x0F:                  //WHO_AM_I_G / WHO_AM_I_XM
+            *value = is_gyro ? 0xD4 : 0x49;
+            break;
+        case 0x07:                  //STATUS_REG_M (xyz data available)
+        case 0x27:                  //STATUS_REG_G / STATUS_REG_A (xyz data available)
+            *value = 0x08;
+            break;
+        case 0x31:                  //INT1_SRC_G (no interrupt)
+            *value = 0x00;
+            break;
+        default:
+            *value = simulated_device->registers[register_addr];
+            break;
+    }
+
+    return true;
+}
+
+//function definition
+//simulated i2c device: read consecutive registers (the output registers produce the next reading of a synthetic signal)
+bool read_bytes(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* values, const int count)
+{
+    //local vars
+    SIMULATED_I2C_DEVICE* simulated_device = find_simulated_i2c_device(device);
+
+    if ((simulated_device == NULL) || (values == NULL) || (count < 0))
+    {
+        return false;
+    }
+
+    //address, register, address, data
+    wait_for_simulated_transfer(3 + (uint32_t)count);
+
+    if (((register_addr == 0x28) || (register_addr == 0x08)) && (count == 6))
+    {
+        read_simulated_reading(simulated_device, register_addr, values);
+    }
+    else
+    {
+        memcpy(values, &(simulated_device->registers[register_addr]), ((register_addr + count) <= 256) ? (size_t)count : (size_t)(256 - register_addr));
+    }
+
+    return true;
+}
+
+//function definition
+//simulated i2c device: write a register
+bool write_byte(I2C_DEVICE* device, const uint8_t register_addr, const uint8_t value)
+{
+    //local vars
+    SIMULATED_I2C_DEVICE* simulated_device = find_simulated_i2c_device(device);
+
+    if (simulated_device == NULL)
+    {
+        return false;
+    }
+
+    //address, register, data
+    wait_for_simulated_transfer(3);
+    simulated_device->registers[register_addr] = value;
+
+    return true;
+}
+
+//function definition
+//simulated i2c device: write consecutive registers
+bool write_bytes(I2C_DEVICE* device, const uint8_t register_addr, const uint8_t* values, const int count)
+{
+    //local vars
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!write_byte(device, (uint8_t)(register_addr + i), values[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//function definition
+//find the simulated device a handle is attached to
+static SIMULATED_I2C_DEVICE* find_simulated_i2c_device(const I2C_DEVICE* device)
+{
+    //local vars
+    uint32_t i;
+
+    for (i = 0; i < simulated_device_count; i++)
+    {
+        if (simulated_devices[i].device == device)
+        {
+            return &(simulated_devices[i]);
+        }
+    }
+
+    return NULL;
+}
+
+//function definition
+//spin for as long as a transfer of some bytes (9 clocks each, with the ack) takes at the simulated bus clock
+static void wait_for_simulated_transfer(uint32_t byte_count)
+{
+    //local vars
+    int64_t end_ns;
+
+    if (simulated_i2c_clock_hz > 0)
+    {
+        end_ns = get_monotonic_time_ns() + (((int64_t)byte_count * 9 * 1000000000) / simulated_i2c_clock_hz);
+        while (get_monotonic_time_ns() < end_ns)
+        {
+        }
+    }
+}
+
+//function definition
+//produce the next x, y, z reading of the accelerometer (level, vibrating at 5hz), magnetometer (a fixed field), or gyroscope (swaying at 0.5hz),
+//as the little endian words the output registers hold
+static void read_simulated_reading(SIMULATED_I2C_DEVICE* simulated_device, uint8_t register_addr, uint8_t* values)
+{
+    //local vars
+    double t = simulated_device->reading_count++ / 100.0;  //seconds, at ~100 readings per second
+    int16_t words[3];
+    uint32_t i;
+
+    if ((simulated_device->address == LSM9DS0_GYRO_ADDRESS) || (simulated_device->address == LSM9DS0_GYRO_ALTERNATE_ADDRESS))
+    {
+        words[0] = (int16_t)(1143.0 * sin(2.0 * 3.14159265 * 0.5 * t));        //10 dps at 8.75 mdps per lsb
+        words[1] = 12;
+        words[2] = -7;
+    }
+    else if (register_addr == 0x28)
+    {
+        words[0] = (int16_t)(1639.0 * sin(2.0 * 3.14159265 * 5.0 * t));        //0.1g at 0.061 mg per lsb
+        words[1] = 25;
+        words[2] = 16393;                                                       //1g
+    }
+    else
+    {
+        words[0] = 2500;                                                        //0.2 gauss at 0.08 mgauss per lsb
+        words[1] = -1250;
+        words[2] = 5000;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        values[i * 2] = (uint8_t)((uint16_t)words[i] & 0xFF);
+        values[(i * 2) + 1] = (uint8_t)(((uint16_t)words[i] >> 8) & 0xFF);
+    }
+}
+
+//function definition
+//connect the stand-in sink to a new stand-in endpoint
+static bool open_stand_in_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    endpoint.received_bytes = 0;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, endpoint.socket_fds) != 0)
+    {
+        return false;
+    }
+    if (pthread_create(&(endpoint.drain_thread), NULL, run_stand_in_endpoint, NULL) != 0)
+    {
+        close(endpoint.socket_fds[0]);
+        close(endpoint.socket_fds[1]);
+        return false;
+    }
+
+    return true;
+}
+
+//function definition
+//frame every reading in the batch as an mqtt publish (qos 0, as the aws sink sends it) and write it to the stand-in endpoint,
+//then record the latency of every sample in the batch
+static bool publish_batch_to_stand_in_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    uint8_t frame[MQTT_FRAME_MAX_SIZE];
+    uint32_t topic_size = (uint32_t)strlen(MQTT_PUBLISH_TOPIC);
+    uint32_t offset = 0;
+    const char* line;
+    uint32_t line_size;
+    uint32_t remaining_length;
+    uint32_t frame_size;
+    ssize_t written_size;
+    uint32_t written_total;
+    int64_t now_ns;
+    uint32_t i;
+    bool operation_status = true;
+
+    (void)sink;
+
+    while (get_next_telemetry_batch_line(batch, &offset, &line, &line_size))
+    {
+        //fixed header (packet type, remaining length as a variable length integer), topic (length prefixed), payload
+        remaining_length = 2 + topic_size + line_size;
+        frame_size = 0;
+        frame[frame_size++] = 0x30;
+        do
+        {
+            frame[frame_size] = (uint8_t)(remaining_length & 0x7F);
+            remaining_length >>= 7;
+            frame[frame_size++] |= (remaining_length > 0) ? 0x80 : 0x00;
+        } while (remaining_length > 0);
+        frame[frame_size++] = (uint8_t)(topic_size >> 8);
+        frame[frame_size++] = (uint8_t)(topic_size & 0xFF);
+        memcpy(&(frame[frame_size]), MQTT_PUBLISH_TOPIC, topic_size);
+        frame_size += topic_size;
+        memcpy(&(frame[frame_size]), line, line_size);
+        frame_size += line_size;
+
+        for (written_total = 0; written_total < frame_size; written_total += (uint32_t)written_size)
+        {
+            written_size = write(endpoint.socket_fds[0], &(frame[written_total]), frame_size - written_total);
+            if (written_size <= 0)
+            {
+                operation_status = false;
+                break;
+            }
+        }
+
+        result.message_count++;
+        result.wire_bytes += frame_size + TLS_RECORD_OVERHEAD;
+    }
+
+    //samples are stamped with CLOCK_MONOTONIC plus the batch's wall clock offset
+    now_ns = get_monotonic_time_ns() + batch->wall_clock_offset_ns;
+    for (i = 0; i < batch->samples.sample_count; i++)
+    {
+        if (result.reading_count < LATENCY_MAX_COUNT)
+        {
+            latencies_ns[result.reading_count] = now_ns - batch->samples.timestamps_ns[i];
+        }
+        result.reading_count++;
+    }
+
+    return operation_status;
+}
+
+//function definition
+//qos 0 publishes are written straight to the connection, so there is nothing to flush
+static bool flush_stand_in_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//disconnect from the stand-in endpoint, waiting for it to drain everything that was written
+static bool close_stand_in_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    shutdown(endpoint.socket_fds[0], SHUT_WR);
+    pthread_join(endpoint.drain_thread, NULL);
+    close(endpoint.socket_fds[0]);
+    close(endpoint.socket_fds[1]);
+    result.received_bytes = endpoint.received_bytes;
+
+    return true;
+}
+
+//function definition
+//stand-in endpoint thread, drains the connection until the client disconnects
+static void* run_stand_in_endpoint(void* argument)
+{
+    //local vars
+    uint8_t buffer[16384];
+    ssize_t read_size;
+
+    (void)argument;
+
+    while ((read_size = read(endpoint.socket_fds[1], buffer, sizeof (buffer))) > 0)
+    {
+        endpoint.received_bytes += (uint64_t)read_size;
+    }
+
+    return NULL;
+}
+
+//function definition
+//returns CLOCK_MONOTONIC in nanoseconds
+static int64_t get_monotonic_time_ns(void)
+{
+    //local vars
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//orders latencies ascending (for qsort)
+static int compare_latencies(const void* a, const void* b)
+{
+    //local vars
+    int64_t first = *(const int64_t*)a;
+    int64_t second = *(const int64_t*)b;
+
+    return (first > second) - (first < second);
+}
+
+//function definition
+//run the SAT process for a scenario and measure it
+static bool run_scenario(const SATBENCH_SCENARIO* scenario, SATBENCH_RESULT* scenario_result)
+{
+    //local vars
+    LSM9DS0_SAT_OPTIONS options;
+    SAT_CONFIG config;
+    TELEMETRY_SINK* sink;
+    struct timespec start;
+    struct timespec end;
+    struct timespec cpu_start;
+    struct timespec cpu_end;
+    uint64_t allocation_start;
+    uint32_t latency_count;
+    uint32_t i;
+
+    //boards are spread across the buses, the second board on a bus is at the alternate addresses
+    memset(&options, 0, sizeof (options));
+    for (i = 0; i < scenario->device_count; i++)
+    {
+        options.devices[i].i2c_bus = LSM9DS0_DEFAULT_I2C_BUS + (int)(i % scenario->bus_count);
+        options.devices[i].gyro_address = (i < scenario->bus_count) ? LSM9DS0_GYRO_ADDRESS : LSM9DS0_GYRO_ALTERNATE_ADDRESS;
+        options.devices[i].accel_magneto_address = (i < scenario->bus_count) ? LSM9DS0_ACCEL_MAGNETO_ADDRESS : LSM9DS0_ACCEL_MAGNETO_ALTERNATE_ADDRESS;
+    }
+    options.device_count = scenario->device_count;
+    get_default_lsm9ds0_config(&(options.sensor_config));
+    options.window_type = scenario->summarize ? TUMBLING_WINDOW : NO_WINDOW;
+    options.window_length = 100;
+    options.window_hop = 100;
+    options.orientation_interval = scenario->summarize ? 10 : 0;
+    options.spectrum_length = scenario->summarize ? 256 : 0;
+    options.spectrum_hop = options.spectrum_length;
+    options.publish_readings = true;
+
+    //batches are sized and tagged as the client's default configuration has them
+    get_default_sat_config(&config);
+    options.device_id = config.device_id;
+    options.tunables = config.tunables;
+
+    memset(&result, 0, sizeof (result));
+    simulated_device_count = 0;
+    simulated_i2c_clock_hz = scenario->i2c_clock_hz;
+
+    sink = new_telemetry_sink("STAND-IN", &STAND_IN_SINK_INTERFACE, NULL);
+    if (sink == NULL)
+    {
+        return false;
+    }
+
+    allocation_start = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    result.operation_status = perform_lsm9ds0_sat(sink, scenario->processing_limit, &options);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+    result.allocation_count = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED) - allocation_start;
+    free_telemetry_sink(sink);
+
+    result.elapsed_seconds = get_elapsed_seconds(&start, &end);
+    result.cpu_seconds = get_elapsed_seconds(&cpu_start, &cpu_end);
+
+    //percentiles of the recorded latencies
+    latency_count = (result.reading_count < LATENCY_MAX_COUNT) ? (uint32_t)result.reading_count : LATENCY_MAX_COUNT;
+    if (latency_count > 0)
+    {
+        qsort(latencies_ns, latency_count, sizeof (int64_t), compare_latencies);
+        result.latency_p50_ns = latencies_ns[(uint32_t)(0.5 * (latency_count - 1))];
+        result.latency_p99_ns = latencies_ns[(uint32_t)(0.99 * (latency_count - 1))];
+        result.latency_p999_ns = latencies_ns[(uint32_t)(0.999 * (latency_count - 1))];
+    }
+
+    *scenario_result = result;
+
+    return result.operation_status && (result.reading_count > 0);
+}
+
+//function definition
+//write a scenario's results as a json object
+static void write_result(FILE* file, const SATBENCH_SCENARIO* scenario, const SATBENCH_RESULT* scenario_result)
+{
+    //local vars
+    double reading_count = (scenario_result->reading_count > 0) ? (double)scenario_result->reading_count : 1.0;
+
+    fprintf(file,
+            "{\"name\":\"%s\",\"device_count\":%u,\"bus_count\":%u,\"i2c_clock_hz\":%u,\"summarize\":%s,\"success\":%s,"
+            "\"samples\":%llu,\"elapsed_s\":%.6f,\"samples_per_sec\":%.1f,"
+            "\"latency_ns\":{\"p50\":%lld,\"p99\":%lld,\"p999\":%lld},"
+            "\"cpu_ns_per_sample\":%.1f,\"allocations_per_sample\":%.6f,"
+            "\"mqtt_messages\":%llu,\"mqtt_bytes_received\":%llu,\"wire_bytes\":%llu,\"wire_bytes_per_sample\":%.1f}",
+            scenario->name,
+            scenario->device_count,
+            scenario->bus_count,
+            scenario->i2c_clock_hz,
+            scenario->summarize ? "true" : "false",
+            scenario_result->operation_status ? "true" : "false",
+            (unsigned long long)scenario_result->reading_count,
+            scenario_result->elapsed_seconds,
+            scenario_result->reading_count / scenario_result->elapsed_seconds,
+            (long long)scenario_result->latency_p50_ns,
+            (long long)scenario_result->latency_p99_ns,
+            (long long)scenario_result->latency_p999_ns,
+            (scenario_result->cpu_seconds * 1e9) / reading_count,
+            scenario_result->allocation_count / reading_count,
+            (unsigned long long)scenario_result->message_count,
+            (unsigned long long)scenario_result->received_bytes,
+            (unsigned long long)scenario_result->wire_bytes,
+            scenario_result->wire_bytes / reading_count);
+}
+
+//function definition
+//compare a scenario's results against the same scenario in a previous run's json (a scenario missing from it isn't compared), returns false on a regression
+static bool compare_result(const char* baseline, const SATBENCH_SCENARIO* scenario, const SATBENCH_RESULT* scenario_result)
+{
+    //local vars
+    char name_key[128];
+    const char* baseline_scenario;
+    double reading_count = (scenario_result->reading_count > 0) ? (double)scenario_result->reading_count : 1.0;
+    bool operation_status = true;
+
+    snprintf(name_key, sizeof (name_key), "\"name\":\"%s\"", scenario->name);
+    baseline_scenario = strstr(baseline, name_key);
+    if (baseline_scenario == NULL)
+    {
+        return true;
+    }
+
+    operation_status &= check_metric(scenario->name, "samples_per_sec", scenario_result->reading_count / scenario_result->elapsed_seconds, get_baseline_metric(baseline_scenario, "samples_per_sec"), REGRESSION_TOLERANCE, true);
+    operation_status &= check_metric(scenario->name, "p99", (double)scenario_result->latency_p99_ns, get_baseline_metric(baseline_scenario, "p99"), REGRESSION_TOLERANCE, false);
+    operation_status &= check_metric(scenario->name, "cpu_ns_per_sample", (scenario_result->cpu_seconds * 1e9) / reading_count, get_baseline_metric(baseline_scenario, "cpu_ns_per_sample"), REGRESSION_TOLERANCE, false);
+    operation_status &= check_metric(scenario->name, "allocations_per_sample", scenario_result->allocation_count / reading_count, get_baseline_metric(baseline_scenario, "allocations_per_sample"), GROWTH_TOLERANCE, false);
+    operation_status &= check_metric(scenario->name, "wire_bytes_per_sample", scenario_result->wire_bytes / reading_count, get_baseline_metric(baseline_scenario, "wire_bytes_per_sample"), GROWTH_TOLERANCE, false);
+
+    return operation_status;
+}
+
+//function definition
+//get the value of a metric of a scenario in a previous run's json (the first occurrence of the key past the scenario's name, every scenario has every key), 0 when missing
+static double get_baseline_metric(const char* baseline_scenario, const char* metric_name)
+{
+    //local vars
+    char key[64];
+    const char* value;
+
+    snprintf(key, sizeof (key), "\"%s\":", metric_name);
+    value = strstr(baseline_scenario, key);
+
+    return (value != NULL) ? strtod(value + strlen(key), NULL) : 0.0;
+}
+
+//function definition
+//print a metric against its baseline, returns false if it got worse by more than the tolerance (a fraction of the baseline)
+static bool check_metric(const char* scenario_name, const char* metric_name, double current, double baseline, double tolerance, bool higher_is_better)
+{
+    //local vars
+    double change = (baseline != 0.0) ? ((current - baseline) / baseline) : 0.0;
+    bool is_regression = higher_is_better ? (current < (baseline * (1.0 - tolerance))) : (current > (baseline * (1.0 + tolerance)));
+
+    printf("%-28s %-24s %14.3f -> %14.3f (%+6.1f%%)%s\n", scenario_name, metric_name, baseline, current, change * 100.0, is_regression ? "  REGRESSION" : "");
+
+    return !is_regression;
+}
+
+//function definition
+//main thread of execution
+int main(int argc, char** argv)
+{
+    //local vars
+    const char* results_location = (argc > 1) ? argv[1] : DEFAULT_RESULTS_LOCATION;
+    static SATBENCH_RESULT results[sizeof (SCENARIOS) / sizeof (SCENARIOS[0])];
+    SATBENCH_RESULT repetition_result;
+    static char baseline[65536];
+    size_t baseline_size = 0;
+    FILE* file;
+    bool operation_status = true;
+    uint32_t i;
+    uint32_t j;
+
+    //run each scenario, keeping its fastest run
+    for (i = 0; i < (sizeof (SCENARIOS) / sizeof (SCENARIOS[0])); i++)
+    {
+        for (j = 0; j < REPETITIONS; j++)
+        {
+            if (!run_scenario(&(SCENARIOS[i]), &repetition_result))
+            {
+                fprintf(stderr, "ERROR: SCENARIO %s FAILED!\n", SCENARIOS[i].name);
+                operation_status = false;
+            }
+            if ((j == 0) || (repetition_result.elapsed_seconds < results[i].elapsed_seconds))
+            {
+                results[i] = repetition_result;
+            }
+        }
+    }
+
+    //summarize the results
+    for (i = 0; i < (sizeof (SCENARIOS) / sizeof (SCENARIOS[0])); i++)
+    {
+        printf("%-28s %10.1f samples/sec, latency p50 %8.3f ms p99 %8.3f ms p999 %8.3f ms, %8.1f cpu ns/sample, %.1f wire bytes/sample\n",
+               SCENARIOS[i].name,
+               results[i].reading_count / results[i].elapsed_seconds,
+               results[i].latency_p50_ns / 1e6,
+               results[i].latency_p99_ns / 1e6,
+               results[i].latency_p999_ns / 1e6,
+               (results[i].cpu_seconds * 1e9) / ((results[i].reading_count > 0) ? (double)results[i].reading_count : 1.0),
+               results[i].wire_bytes / ((results[i].reading_count > 0) ? (double)results[i].reading_count : 1.0));
+    }
+
+    //write the results
+    file = fopen(results_location, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "ERROR: FAILED TO OPEN %s!\n", results_location);
+        return EXIT_FAILURE;
+    }
+    fprintf(file, "{\"benchmark\":\"satbench\",\"scenarios\":[\n");
+    for (i = 0; i < (sizeof (SCENARIOS) / sizeof (SCENARIOS[0])); i++)
+    {
+        write_result(file, &(SCENARIOS[i]), &(results[i]));
+        fprintf(file, "%s\n", (i + 1 < (sizeof (SCENARIOS) / sizeof (SCENARIOS[0]))) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    printf("Results written to %s\n", results_location);
+
+    //compare against the baseline (when supplied)
+    if (argc > 2)
+    {
+        file = fopen(argv[2], "r");
+        if (file == NULL)
+        {
+            fprintf(stderr, "ERROR: FAILED TO OPEN %s!\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        baseline_size = fread(baseline, 1, sizeof (baseline) - 1, file);
+        baseline[baseline_size] = '\0';
+        fclose(file);
+
+        for (i = 0; i < (sizeof (SCENARIOS) / sizeof (SCENARIOS[0])); i++)
+        {
+            operation_status &= compare_result(baseline, &(SCENARIOS[i]), &(results[i]));
+        }
+    }
+
+    //exit program, return code reflects if every scenario ran and none regressed
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
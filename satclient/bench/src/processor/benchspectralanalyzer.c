@@ -0,0 +1,122 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Benchmarks in this suite report the cost of computing the spectral features of a window (all 3 accelerometer axes),
+   per window and amortized per sample, for each power of two window length at the lsm9ds0's ~100hz sample rate.
+
+ * ./build/bin/bench/benchspectralanalyzer
+ */
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdio.h>              //using for "printf" function
+#include <stdlib.h>             //using for "EXIT_..." macros
+#include <time.h>               //using for "clock_gettime" function
+#include "spectralanalyzer.h"   //benchmarking the spectral analyzer
+
+//global vars
+#define INPUT_BATCH_COUNT 64                        //distinct input batches cycled through
+static const float SAMPLE_RATE_HZ = 100.0f;         //~100 samples per second produced by the lsm9ds0
+static const uint32_t MIN_WINDOWS = 20000;          //windows computed per measurement (at least)
+static SAMPLE_BATCH inputs[INPUT_BATCH_COUNT];
+static SPECTRAL_ANALYZER analyzer;
+static volatile float sink;                         //keeps the results observable so the loops aren't optimized away
+
+//function declarations
+static double get_elapsed_seconds(const struct timespec*, const struct timespec*);
+static bool bench_spectral_analyzer(uint32_t);
+int main(void);
+
+//function definition
+//returns the number of seconds between two timestamps
+static double get_elapsed_seconds(const struct timespec* start, const struct timespec* end)
+{
+    return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+//function definition
+//add samples to an analyzer with tumbling windows of a length until enough windows have been computed
+static bool bench_spectral_analyzer(uint32_t length)
+{
+    //local vars
+    struct timespec start;
+    struct timespec end;
+    SPECTRAL_FEATURES features;
+    bool features_availability;
+    uint64_t sample_count = 0;
+    uint32_t window_count = 0;
+    uint32_t i;
+    double elapsed_seconds;
+    bool operation_status = true;
+
+    if (!init_spectral_analyzer(&analyzer, length, length, SAMPLE_RATE_HZ))
+    {
+        return false;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (window_count < MIN_WINDOWS)
+    {
+        for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+        {
+            operation_status &= add_sample_to_spectral_analyzer(&analyzer, &(inputs[sample_count % INPUT_BATCH_COUNT]), i, &features, &features_availability);
+            if (features_availability)
+            {
+                sink += features.axes[0].dominant_frequency_hz;
+                window_count++;
+            }
+        }
+        sample_count += SAMPLE_BATCH_MAX_SAMPLES;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed_seconds = get_elapsed_seconds(&start, &end);
+    printf("%4u sample windows: %8.2f us per window (%7.1f ns per sample), %.4f%% of the %.2f second window\n",
+           length,
+           (elapsed_seconds / window_count) * 1e6,
+           (elapsed_seconds / (double)sample_count) * 1e9,
+           ((elapsed_seconds / window_count) / (length / SAMPLE_RATE_HZ)) * 100.0,
+           length / SAMPLE_RATE_HZ);
+
+    return operation_status;
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t noise_state = 1;
+    bool operation_status = true;
+    uint32_t batch_index;
+    uint32_t length;
+    uint32_t axis;
+    uint32_t i;
+
+    //synthetic raw samples (pseudo random, so every bin carries content)
+    for (batch_index = 0; batch_index < INPUT_BATCH_COUNT; batch_index++)
+    {
+        clear_sample_batch(&(inputs[batch_index]));
+        set_sample_batch_scale_factors(&(inputs[batch_index]), 0.000061, 0.00008, 0.00875);
+        for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+        {
+            for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+            {
+                noise_state = (noise_state * 1103515245) + 12345;
+                values[axis] = (int16_t)(noise_state >> 16);
+            }
+
+            append_sample_to_sample_batch(&(inputs[batch_index]), ((int64_t)((batch_index * SAMPLE_BATCH_MAX_SAMPLES) + i) * 10000000), values);
+        }
+    }
+
+    for (length = SPECTRAL_ANALYZER_MIN_LENGTH; length <= SPECTRAL_ANALYZER_MAX_LENGTH; length *= 2)
+    {
+        operation_status &= bench_spectral_analyzer(length);
+    }
+
+    //exit program, return code reflects if every window was computed
+    return operation_status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
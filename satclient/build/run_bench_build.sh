@@ -0,0 +1,37 @@
+# Author: James Beasley
+# Repo: https://github.com/embeddedcognition/satclient
+
+#!/bin/bash
+
+#create the obj directory if it doesn't exist
+if [ ! -d "obj" ]; then
+  mkdir obj
+fi
+
+#create the bin directory if it doesn't exist
+if [ ! -d "bin" ]; then
+  mkdir bin
+fi
+
+#create the obj/bench directory if it doesn't exist
+if [ ! -d "obj/bench" ]; then
+  mkdir obj/bench
+fi
+
+#create the bin/bench directory if it doesn't exist
+if [ ! -d "bin/bench" ]; then
+  mkdir bin/bench
+fi
+
+#run build
+make -f make/benchcryptoutil_makefile all
+make -f make/benchcolumnarsink_makefile all
+
+make -f make/benchrawsignalconvert_makefile all
+make -f make/benchahrsfilter_makefile all
+make -f make/benchfilterchain_makefile all
+make -f make/benchspectralanalyzer_makefile all
+make -f make/benchsat_makefile all
+make -f make/benchmetrics_makefile all
+make -f make/benchshadowdelta_makefile all
+make -f make/benchshadowack_makefile all
\ No newline at end of file
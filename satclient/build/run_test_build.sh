@@ -24,4 +24,20 @@ if [ ! -d "bin/test" ]; then
 fi
 
 #run build
-make -f make/testcryptoutil_makefile all
\ No newline at end of file
+make -f make/testcryptoutil_makefile all
+make -f make/testwindowaggregator_makefile all
+make -f make/testrawsignalconvert_makefile all
+make -f make/testsamplebatch_makefile all
+make -f make/testahrsfilter_makefile all
+make -f make/testfilterchain_makefile all
+make -f make/testeventdetector_makefile all
+make -f make/testspectralanalyzer_makefile all
+make -f make/testimucalibration_makefile all
+make -f make/testmetrics_makefile all
+make -f make/testtrace_makefile all
+make -f make/testtelemetrysink_makefile all
+make -f make/testsatconfig_makefile all
+make -f make/testsatmemory_makefile all
+make -f make/testcolumnarsink_makefile all
+make -f make/testiotdeviceshadow_makefile all
+make -f make/testkeyprovisioner_makefile all
\ No newline at end of file
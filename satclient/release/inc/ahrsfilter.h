@@ -0,0 +1,50 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef AHRSFILTER_H_
+#define AHRSFILTER_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t" and "int64_t" types
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Attitude and heading reference system (AHRS) - Madgwick gradient descent sensor fusion of the accelerometer,
+    magnetometer, and gyroscope into an orientation quaternion.
+
+    The gyroscope rate is integrated every sample, with a correction step (scaled by beta) pulling the estimate
+    toward the gravity and magnetic field directions. When the magnetometer reads zero only gravity is used (no
+    heading correction), and when the accelerometer reads zero the gyroscope is integrated alone.
+
+    Float32 throughout, with all state in the filter object (no heap allocation).
+*/
+#define AHRS_FILTER_MAX_SAMPLE_PERIOD_S 0.1f    //gaps between samples longer than this fall back to the nominal sample period
+
+//ahrs filter object representation
+typedef struct ahrs_filter
+{
+    float quaternion[4];            //orientation estimate (w, x, y, z)
+    float beta;                     //gain of the correction step (higher converges faster, lower rejects more accelerometer noise)
+    float sample_period_s;          //nominal seconds between samples (used when timestamps can't be)
+    int64_t timestamp_ns;           //timestamp of the latest sample fused
+    uint32_t update_count;          //number of samples fused
+}AHRS_FILTER;
+
+//orientation object representation
+typedef struct ahrs_orientation
+{
+    int64_t timestamp_ns;           //timestamp of the latest sample fused
+    float quaternion[4];            //w, x, y, z
+    float roll;                     //rotation about x (degrees)
+    float pitch;                    //rotation about y (degrees)
+    float yaw;                      //rotation about z (degrees)
+}AHRS_ORIENTATION;
+
+//function declarations
+bool init_ahrs_filter(AHRS_FILTER*, float, float);
+bool update_ahrs_filter(AHRS_FILTER*, SAMPLE_BATCH*, uint32_t);
+bool get_ahrs_orientation(const AHRS_FILTER*, AHRS_ORIENTATION*);
+
+#endif /* AHRSFILTER_H_ */
@@ -6,7 +6,8 @@
 #ifndef AWS_IOT_CONFIG_H_
 #define AWS_IOT_CONFIG_H_
 
-// Get from console
+// Get from console (defaults only, the SAT client reads these from its config file - aws_host, aws_port, aws_client_id,
+// aws_thing_name, aws_root_ca_file, aws_certificate_file, aws_private_key_file - see satconfig.h)
 // =================================================
 #define AWS_IOT_MQTT_HOST              	"YOUR_VALUE.us-east-1.amazonaws.com"
 #define AWS_IOT_MQTT_PORT              	8883
@@ -19,7 +20,11 @@
 
 // MQTT PubSub
 #define AWS_IOT_MQTT_TX_BUF_LEN 512 ///< Any time a message is sent out through the MQTT layer. The message is copied into this buffer anytime a publish is done. This will also be used in the case of Thing Shadow
+#ifdef SATCLIENT_PROFILE_SMALL
+#define AWS_IOT_MQTT_RX_BUF_LEN 256 ///< Small profile (see satmemory.h), thing shadow documents larger than this are streamed through the incremental JSON parser rather than dropped
+#else
 #define AWS_IOT_MQTT_RX_BUF_LEN 512 ///< Any message that comes into the device should be less than this buffer size. If a received message is bigger than this buffer size the message will be dropped.
+#endif
 #define AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS 5 ///< Maximum number of topic filters the MQTT client can handle at any given time. This should be increased appropriately when using Thing Shadow
 
 // Thing Shadow specific configs
@@ -27,9 +32,15 @@
 #define MAX_SIZE_OF_UNIQUE_CLIENT_ID_BYTES 80  ///< Maximum size of the Unique Client Id. For More info on the Client Id refer \ref response "Acknowledgments"
 #define MAX_SIZE_CLIENT_ID_WITH_SEQUENCE MAX_SIZE_OF_UNIQUE_CLIENT_ID_BYTES + 10 ///< This is size of the extra sequence number that will be appended to the Unique client Id
 #define MAX_SIZE_CLIENT_TOKEN_CLIENT_SEQUENCE MAX_SIZE_CLIENT_ID_WITH_SEQUENCE + 20 ///< This is size of the the total clientToken key and value pair in the JSON
-#define MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME 10 ///< At Any given time we will wait for this many responses. This will correlate to the rate at which the shadow actions are requested
+#ifdef SATCLIENT_PROFILE_SMALL
+#define MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME 16 ///< Small profile (see satmemory.h), the SAT client has one report in flight at a time
+#define MAX_THINGNAME_HANDLED_AT_ANY_GIVEN_TIME 2 ///< Small profile, the SAT client acts on its own thing only
+#define MAX_JSON_TOKEN_EXPECTED 64 ///< Small profile, enough for any delta or ack of the SAT client's tunables that fits the RX buffer (larger ones are streamed)
+#else
+#define MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME 64 ///< At Any given time we will wait for this many responses. This will correlate to the rate at which the shadow actions are requested (matching and timing out an ack costs the same however many are awaited)
 #define MAX_THINGNAME_HANDLED_AT_ANY_GIVEN_TIME 10 ///< We could perform shadow action on any thing Name and this is maximum Thing Names we can act on at any given time
 #define MAX_JSON_TOKEN_EXPECTED 120 ///< These are the max tokens that is expected to be in the Shadow JSON document. Include the metadata that gets published
+#endif
 #define MAX_SHADOW_TOPIC_LENGTH_WITHOUT_THINGNAME 60 ///< All shadow actions have to be published or subscribed to a topic which is of the format $aws/things/{thingName}/shadow/update/accepted. This refers to the size of the topic without the Thing Name
 #define MAX_SIZE_OF_THING_NAME 20 ///< The Thing Name should not be bigger than this value. Modify this if the Thing Name needs to be bigger
 #define MAX_SHADOW_TOPIC_LENGTH_BYTES MAX_SHADOW_TOPIC_LENGTH_WITHOUT_THINGNAME + MAX_SIZE_OF_THING_NAME ///< This size includes the length of topic with Thing Name
@@ -0,0 +1,95 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef COLUMNARFILE_H_
+#define COLUMNARFILE_H_
+
+#include <stdbool.h>        //using for "bool" type
+#include <stddef.h>         //using for "size_t" type
+#include <stdint.h>         //using for "int16_t", "uint32_t", "int64_t", and "uint64_t" types
+
+/*
+    Columnar telemetry file layout (native byte order, the file is meant to be read on the host that wrote it or a host of the same endianness):
+
+    [file header]  one COLUMNAR_FILE_PAGE_SIZE_BYTES page, COLUMNAR_FILE_HEADER at offset 0
+    [data page 0]  COLUMNAR_FILE_PAGE_SIZE_BYTES
+    [data page 1]  ...
+
+    Each data page holds up to COLUMNAR_FILE_SAMPLES_PER_PAGE samples laid out as columns:
+    COLUMNAR_PAGE_HEADER, then the timestamp column (int64 ns), then one int16 raw column per axis
+    (accel x,y,z, magneto x,y,z, gyro x,y,z). Column offsets are fixed, so a reader can index a
+    column directly without parsing the page.
+
+    The writer only ever appends. It stores a sample's column values first, then publishes it by
+    advancing the page's sample count and the header's committed sample count (release stores),
+    so a reader that loads a count (acquire) can use every sample below it while the file is being written.
+*/
+#define COLUMNAR_FILE_MAGIC "SATCOL01"                                  //signature that begins a columnar telemetry file (not null terminated in the file)
+#define COLUMNAR_FILE_PAGE_SIZE_BYTES 57344                             //size of the header page and of every data page (14 x 4KiB)
+#define COLUMNAR_FILE_SAMPLES_PER_PAGE 2048                             //samples per data page
+#define COLUMNAR_FILE_AXIS_COUNT 9                                      //raw int16 columns per page
+#define COLUMNAR_PAGE_HEADER_SIZE_BYTES 64                              //size of the header at the start of each data page
+#define COLUMNAR_PAGE_TIMESTAMP_COLUMN_OFFSET COLUMNAR_PAGE_HEADER_SIZE_BYTES
+#define COLUMNAR_PAGE_AXIS_COLUMN_OFFSET(axis) (COLUMNAR_PAGE_TIMESTAMP_COLUMN_OFFSET + (COLUMNAR_FILE_SAMPLES_PER_PAGE * sizeof (int64_t)) + ((axis) * COLUMNAR_FILE_SAMPLES_PER_PAGE * sizeof (int16_t)))
+
+//enum for the raw axis columns (in page order, the same order as SAMPLE_BATCH_AXIS)
+typedef enum columnar_axis
+{
+    COLUMNAR_ACCEL_X,
+    COLUMNAR_ACCEL_Y,
+    COLUMNAR_ACCEL_Z,
+    COLUMNAR_MAGNETO_X,
+    COLUMNAR_MAGNETO_Y,
+    COLUMNAR_MAGNETO_Z,
+    COLUMNAR_GYRO_X,
+    COLUMNAR_GYRO_Y,
+    COLUMNAR_GYRO_Z
+}COLUMNAR_AXIS;
+
+//columnar file header representation (start of the file)
+typedef struct columnar_file_header
+{
+    char magic[8];                                      //COLUMNAR_FILE_MAGIC
+    uint32_t page_size;                                 //COLUMNAR_FILE_PAGE_SIZE_BYTES
+    uint32_t samples_per_page;                          //COLUMNAR_FILE_SAMPLES_PER_PAGE
+    uint32_t axis_count;                                //COLUMNAR_FILE_AXIS_COUNT
+    uint32_t reserved;                                  //keeps the following members 8 byte aligned
+    double scale_factors[COLUMNAR_FILE_AXIS_COUNT];     //per axis column, raw value * scale factor = value in the sensor's units (g, gauss, dps)
+    uint64_t committed_sample_count;                    //samples readable across all data pages (updated by the writer as samples are published)
+}COLUMNAR_FILE_HEADER;
+
+//columnar data page header representation (start of every data page)
+typedef struct columnar_page_header
+{
+    uint64_t page_index;                                //zero indexed position of the page in the file
+    uint32_t sample_count;                              //samples readable in this page
+    uint32_t reserved;
+}COLUMNAR_PAGE_HEADER;
+
+//read-only view of a data page's columns
+typedef struct columnar_page_view
+{
+    uint32_t sample_count;                              //number of readable entries in each column
+    const int64_t* timestamps_ns;                       //timestamp column
+    const int16_t* axes[COLUMNAR_FILE_AXIS_COUNT];      //raw axis columns, indexed by COLUMNAR_AXIS
+}COLUMNAR_PAGE_VIEW;
+
+//columnar file reader object representation
+typedef struct columnar_file_reader
+{
+    int fd;                                             //descriptor of the open file
+    const uint8_t* mapping;                             //read-only mapping of the file
+    size_t mapping_size;                                //size of the mapping
+    const COLUMNAR_FILE_HEADER* header;                 //header at the start of the mapping
+}COLUMNAR_FILE_READER;
+
+//function declarations
+bool open_columnar_file_reader(COLUMNAR_FILE_READER*, const char*);
+bool refresh_columnar_file_reader(COLUMNAR_FILE_READER*);
+uint64_t get_columnar_file_sample_count(const COLUMNAR_FILE_READER*);
+bool get_columnar_file_page(const COLUMNAR_FILE_READER*, uint64_t, COLUMNAR_PAGE_VIEW*);
+void close_columnar_file_reader(COLUMNAR_FILE_READER*);
+
+#endif /* COLUMNARFILE_H_ */
@@ -0,0 +1,14 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef COLUMNARSINK_H_
+#define COLUMNARSINK_H_
+
+#include "telemetrysink.h"      //using for "TELEMETRY_SINK" type
+
+//function declarations
+TELEMETRY_SINK* new_columnar_telemetry_sink(const char*);
+
+#endif /* COLUMNARSINK_H_ */
@@ -7,7 +7,16 @@
 #define CRYPTOUTIL_H_
 
 #include <stdbool.h>    //using for "bool" type
-#include <stdint.h>     //using for "uint8_t" and "uint32_t" types
+#include <stdint.h>     //using for "uint8_t", "uint32_t", and "uint64_t" types
+#include <openssl/evp.h>    //using for "EVP_CIPHER_CTX" type
+
+//the buffers the functions hand back (keys, payloads, digests, and strings) are allocated from the memory arena, the caller frees them with "free_sat_memory" (see satmemory.h)
+
+//sealed batch sizes (in bytes)
+#define SEALED_BATCH_KEY_SIZE_BYTES 32      //256-bit sealing key (same size for aes-256-gcm and chacha20-poly1305)
+#define SEALED_BATCH_SALT_SIZE_BYTES 16     //128-bit random per-context salt, a fresh subkey is derived from it (so restarts never share a key)
+#define SEALED_BATCH_NONCE_SIZE_BYTES 24    //nonce sent alongside a batch, the context's salt + 8-byte batch counter (the cipher's 96-bit iv is the counter, unique under the subkey)
+#define SEALED_BATCH_TAG_SIZE_BYTES 16      //128-bit authentication tag
 
 //enum for use in setting cipher mode (decryption=0, encryption=1)
 typedef enum cipher_mode
@@ -16,12 +25,50 @@ typedef enum cipher_mode
     ENCRYPT
 }CIPHER_MODE;
 
+//enum for the key derivation function used to turn a passphrase + salt into a cipher key and iv
+typedef enum key_derivation_function
+{
+    OPENSSL_BYTESTOKEY,     //"openssl enc -md sha256" default, a single digest round (cost is ignored), cheap to brute force
+    PBKDF2_SHA256,          //"openssl enc -pbkdf2 -iter {cost} -md sha256" (openssl 1.1.1+ command line), cost = iteration count
+    SCRYPT                  //scrypt with N = 2^{cost}, r = 8, p = 1 (openssl 1.1.0+ library), payloads created with "encrypt_to_base64_encoded_openssl_payload"
+}KEY_DERIVATION_FUNCTION;
+
+//enum for the authenticated encryption (aead) algorithm used to seal telemetry batches
+typedef enum aead_cipher
+{
+    AES256GCM,
+    CHACHA20POLY1305
+}AEAD_CIPHER;
+
+//sealed batch context object representation
+//the sealing key is derived once (at init), each context seals under its own subkey (derived from the sealing key and a random salt), and the
+//cipher context (with its expanded key schedule) is reused for every batch, opening a batch sealed by another context rekeys it to that context's subkey
+//a context is not thread safe, each thread sealing batches should own its own context
+typedef struct sealed_batch_context
+{
+    EVP_CIPHER_CTX* cipher_context;                 //cipher context handle (created once and reused throughout)
+    AEAD_CIPHER cipher;                             //algorithm selected at init
+    uint8_t sealing_key[SEALED_BATCH_KEY_SIZE_BYTES];   //key derived from the master key, subkeys are derived from it
+    uint8_t seal_salt[SEALED_BATCH_SALT_SIZE_BYTES];    //random salt of the subkey this context seals under (drawn at init)
+    uint8_t key_salt[SEALED_BATCH_SALT_SIZE_BYTES];     //salt of the subkey the cipher context currently holds
+    uint64_t batch_counter;                         //incremented for each sealed batch, the iv (unique under the context's subkey)
+}SEALED_BATCH_CONTEXT;
+
 //function declarations
 bool load_base64_encoded_openssl_payload(char**);
+bool load_base64_encoded_openssl_payload_from_file(const char*, char**);
 bool decrypt_base64_encoded_openssl_payload(const char*, uint8_t**, uint32_t*);
+bool decrypt_base64_encoded_openssl_payload_with_passphrase(const char*, const uint8_t*, const uint32_t, KEY_DERIVATION_FUNCTION, const uint32_t, uint8_t**, uint32_t*);
+bool encrypt_to_base64_encoded_openssl_payload(const uint8_t*, const uint32_t, KEY_DERIVATION_FUNCTION, const uint32_t, const uint8_t*, const uint32_t, char**);
 bool extract_salt_and_ciphertext_from_openssl_payload(const uint8_t*, const uint32_t, uint8_t**, uint32_t*, uint8_t**, uint32_t*);
 bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt(const uint8_t*, const uint32_t, const uint8_t*, const uint32_t, uint8_t**, uint32_t*, uint8_t**, uint32_t*);
+bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(KEY_DERIVATION_FUNCTION, const uint32_t, const uint8_t*, const uint32_t, const uint8_t*, const uint32_t, uint8_t**, uint32_t*, uint8_t**, uint32_t*);
 bool compute_aes256cfb_cipher(CIPHER_MODE, const uint8_t*, const uint32_t, const uint8_t*, const uint32_t, const uint8_t*, const uint32_t, uint8_t**, uint32_t*);
+AEAD_CIPHER get_preferred_aead_cipher(void);
+bool init_sealed_batch_context(SEALED_BATCH_CONTEXT*, AEAD_CIPHER, const uint8_t*, const uint32_t);
+void shutdown_sealed_batch_context(SEALED_BATCH_CONTEXT*);
+bool seal_telemetry_batch(SEALED_BATCH_CONTEXT*, const uint8_t*, const uint32_t, uint8_t*, const uint32_t, uint8_t*, uint8_t*);
+bool open_sealed_telemetry_batch(SEALED_BATCH_CONTEXT*, const uint8_t*, const uint32_t, uint8_t*, const uint32_t, const uint8_t*, const uint8_t*);
 bool compute_sha256_hmac(const uint8_t*, const uint32_t, const char*, uint8_t**, uint32_t*);
 bool compute_sha256_hmac_2(const uint8_t*, const uint32_t, const char*, uint8_t**, uint32_t*);
 char* compute_base16_string(const uint8_t*, const uint32_t);
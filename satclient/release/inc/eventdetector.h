@@ -0,0 +1,120 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef EVENTDETECTOR_H_
+#define EVENTDETECTOR_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint8_t", "uint32_t", and "int64_t" types
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Event (anomaly) detection over the accelerometer magnitude (g) and the gyroscope rates (dps), for report by
+    exception publishing - a device that is stationary most of the time only needs to send readings around events.
+
+    Detectors (each is disabled by a threshold of 0):
+    - threshold: the accelerometer magnitude departs from 1g (gravity), or a gyroscope rate exceeds, a fixed threshold
+    - baseline: a signal departs from its baseline (an exponential moving average tracking slow drift) by a delta
+    - z-score: a signal is more than a number of standard deviations from the mean of its recent history (rolling window)
+    - hardware: the gyroscope's own threshold interrupt latched a crossing (see enable_gyro_threshold_interrupt in lsm9ds0.h),
+      reported by the caller, which also catches spikes between reads
+
+    An event starts when any detector fires, and ends once none has fired for the hold length (in samples).
+
+    While no event is active every sample is kept in a ring buffer holding the pre-trigger length, plus the sample
+    that starts an event, so an event can be published with the history leading up to it.
+*/
+#define EVENT_DETECTOR_MAX_HISTORY 256          //largest number of samples the history holds (pre-trigger length + 1)
+#define EVENT_DETECTOR_MAX_ZSCORE_LENGTH 256    //largest number of samples in the z-score window
+#define EVENT_SIGNAL_COUNT 4                    //signals the detectors run on
+
+//bit field of the detectors that fired
+#define THRESHOLD_EVENT_DETECTOR 0x01
+#define BASELINE_EVENT_DETECTOR 0x02
+#define ZSCORE_EVENT_DETECTOR 0x04
+#define HARDWARE_EVENT_DETECTOR 0x08
+
+//enum for the signals the detectors run on
+typedef enum event_signal
+{
+    EVENT_ACCEL_MAGNITUDE,
+    EVENT_GYRO_X,
+    EVENT_GYRO_Y,
+    EVENT_GYRO_Z
+}EVENT_SIGNAL;
+
+//enum for what a sample did to the event state
+typedef enum event_transition
+{
+    NO_EVENT_TRANSITION,
+    EVENT_STARTED,
+    EVENT_ENDED
+}EVENT_TRANSITION;
+
+//event detector options
+typedef struct event_detector_options
+{
+    float accel_threshold_g;        //largest departure of the accelerometer magnitude from 1g (threshold detector)
+    float gyro_threshold_dps;       //largest gyroscope rate (threshold detector)
+    float accel_delta_g;            //largest departure of the accelerometer magnitude from its baseline (baseline detector)
+    float gyro_delta_dps;           //largest departure of a gyroscope rate from its baseline (baseline detector)
+    uint32_t baseline_length;       //samples the baseline averages over (the moving average weight is 1 / length)
+    float zscore_threshold;         //largest number of standard deviations from the mean (z-score detector)
+    uint32_t zscore_length;         //samples in the z-score window (the detector waits for the window to fill)
+    uint32_t hold_length;           //samples without a detection before an event ends
+    uint32_t pre_trigger_length;    //samples of history kept from before an event
+}EVENT_DETECTOR_OPTIONS;
+
+//heartbeat (summary of the samples since the last heartbeat) object representation
+typedef struct event_heartbeat
+{
+    int64_t timestamp_ns;           //timestamp of the latest sample
+    uint32_t sample_count;          //samples since the last heartbeat
+    uint32_t event_count;           //events started since the detector was initialized
+    bool event_active;              //denotes if an event is in progress
+    float accel_magnitude_mean;     //g
+    float accel_magnitude_max;      //g
+    float gyro_magnitude_max;       //dps
+}EVENT_HEARTBEAT;
+
+//event detector object representation
+typedef struct event_detector
+{
+    EVENT_DETECTOR_OPTIONS options;
+    float baselines[EVENT_SIGNAL_COUNT];                                        //per signal, exponential moving average
+    float zscore_window[EVENT_SIGNAL_COUNT][EVENT_DETECTOR_MAX_ZSCORE_LENGTH];  //per signal, the latest zscore_length values
+    double zscore_sums[EVENT_SIGNAL_COUNT];                                     //per signal, sum of the window's values
+    double zscore_sums_of_squares[EVENT_SIGNAL_COUNT];                          //per signal, sum of the window's squared values
+    uint32_t zscore_position;                                                   //position of the oldest value in the window
+    uint32_t zscore_count;                                                      //number of values in the window
+    uint32_t update_count;                                                      //samples run through the detectors
+    //event state
+    bool event_active;
+    uint8_t detections;                                                         //detectors that fired on the latest sample
+    uint8_t event_detections;                                                   //detectors that fired during the current (or last) event
+    uint32_t samples_since_detection;
+    uint32_t event_sample_count;                                                //samples in the current (or last) event
+    int64_t event_start_timestamp_ns;                                           //timestamp of the sample that started the current (or last) event
+    uint32_t event_count;                                                       //events started
+    //pre-trigger history (ring buffer, structure of arrays like a sample batch)
+    int64_t history_timestamps_ns[EVENT_DETECTOR_MAX_HISTORY];
+    int16_t history[SAMPLE_BATCH_AXIS_COUNT][EVENT_DETECTOR_MAX_HISTORY];
+    uint32_t history_position;                                                  //position of the oldest sample in the history
+    uint32_t history_count;                                                     //number of samples in the history
+    //heartbeat accumulators (since the last heartbeat)
+    int64_t heartbeat_timestamp_ns;
+    uint32_t heartbeat_sample_count;
+    double heartbeat_accel_magnitude_sum;
+    float heartbeat_accel_magnitude_max;
+    float heartbeat_gyro_magnitude_max;
+}EVENT_DETECTOR;
+
+//function declarations
+bool init_event_detector(EVENT_DETECTOR*, const EVENT_DETECTOR_OPTIONS*);
+bool update_event_detector(EVENT_DETECTOR*, SAMPLE_BATCH*, uint32_t, uint8_t, EVENT_TRANSITION*);
+uint32_t move_event_detector_history_to_sample_batch(EVENT_DETECTOR*, SAMPLE_BATCH*, uint32_t);
+bool get_event_heartbeat(EVENT_DETECTOR*, EVENT_HEARTBEAT*);
+
+#endif /* EVENTDETECTOR_H_ */
@@ -8,6 +8,7 @@
 
 #include <stdbool.h>            //using for "bool" type
 #include "messagingclient.h"    //using for messaging client library
+#include "telemetrysink.h"      //using for "TELEMETRY_READING" and "TELEMETRY_SINK" types
 
 //of the format: "amqps://{shared access key name}:{shared access token}@{service bus namespace}.servicebus.windows.net/{event hub name}"
 //event hub object representation
@@ -18,15 +19,10 @@ typedef struct event_hub
     char* shared_access_token;  //shared access signature (token)
 }EVENT_HUB;
 
-//telemetry reading object representation
-typedef struct telemetry_reading
-{
-    char json[256];  //reading formatted as json
-}TELEMETRY_READING;
-
 //function declarations
 EVENT_HUB* new_event_hub(void);
 void free_event_hub(EVENT_HUB*);
 bool publish_telemetry_to_event_hub(EVENT_HUB*, TELEMETRY_READING*);
+TELEMETRY_SINK* new_event_hub_telemetry_sink(void);
 
 #endif /* EVENTHUB_H_ */
@@ -0,0 +1,33 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef FANOUTSINK_H_
+#define FANOUTSINK_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t" and "uint64_t" types
+#include "telemetrysink.h"      //using for "TELEMETRY_SINK" type
+
+#define FANOUT_MAX_SINKS 4          //largest number of transports a fan-out sink can feed
+#ifdef SATCLIENT_PROFILE_SMALL
+#define FANOUT_MAX_QUEUE_DEPTH 8    //small profile (see satmemory.h), caps the batch slots a fan-out sink allocates
+#else
+#define FANOUT_MAX_QUEUE_DEPTH 32   //most batches each transport may fall behind by before its batches are dropped
+#endif
+#define FANOUT_DEFAULT_QUEUE_DEPTH 8
+
+//per transport delivery statistics
+typedef struct fanout_sink_statistics
+{
+    uint64_t published_batch_count;     //batches the transport accepted
+    uint64_t failed_batch_count;        //batches the transport rejected
+    uint64_t dropped_batch_count;       //batches never handed to the transport because its queue was full
+}FANOUT_SINK_STATISTICS;
+
+//function declarations
+TELEMETRY_SINK* new_fanout_telemetry_sink(TELEMETRY_SINK**, uint32_t, uint32_t, uint64_t);
+bool get_fanout_sink_statistics(TELEMETRY_SINK*, uint32_t, FANOUT_SINK_STATISTICS*);
+
+#endif /* FANOUTSINK_H_ */
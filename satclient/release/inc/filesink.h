@@ -0,0 +1,14 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef FILESINK_H_
+#define FILESINK_H_
+
+#include "telemetrysink.h"      //using for "TELEMETRY_SINK" type
+
+//function declarations
+TELEMETRY_SINK* new_file_telemetry_sink(const char*);
+
+#endif /* FILESINK_H_ */
@@ -0,0 +1,73 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef FILTERCHAIN_H_
+#define FILTERCHAIN_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t" type
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Chain of digital filter stages run over every axis of a sample batch (each axis has its own filter state).
+
+    Stages (in the order added):
+    - lowpass / highpass: 2nd order butterworth biquad (q = 0.7071) at a cutoff frequency
+    - average: moving average decimator, outputs the mean of every factor samples
+    - fir: low-pass fir decimator (windowed sinc, cutoff just under the decimated nyquist frequency), outputs every
+      factor-th sample, computing only the outputs that are kept (the saving a polyphase decimator makes)
+
+    Filtering runs on the raw values, so output batches hold raw values in the same units as the input batches
+    (rounded and saturated back to int16) and everything downstream of the chain is unchanged. An output sample
+    is stamped with the timestamp of the input sample that completed it. A chain without stages passes samples through.
+
+    A chain can be described as a comma separated list of stages, each "name:value" (cutoff in hz, or decimation factor),
+    e.g. "lowpass:200,fir:8,fir:8" to take the accelerometer's 1600hz rate down to a clean 25hz.
+*/
+#define FILTER_CHAIN_MAX_STAGES 8           //largest number of stages in a chain
+#define FILTER_STAGE_MAX_TAPS 128           //largest number of fir taps (fir decimators use 8 taps per unit of decimation, plus 1)
+#define FILTER_STAGE_MAX_DECIMATION 15      //largest decimation factor of a single stage
+
+//enum for the kinds of filter stage
+typedef enum filter_stage_type
+{
+    LOWPASS_FILTER_STAGE,
+    HIGHPASS_FILTER_STAGE,
+    AVERAGE_DECIMATOR_FILTER_STAGE,
+    FIR_DECIMATOR_FILTER_STAGE
+}FILTER_STAGE_TYPE;
+
+//filter stage object representation
+typedef struct filter_stage
+{
+    FILTER_STAGE_TYPE type;
+    uint32_t decimation_factor;                                         //inputs per output (1 for biquads)
+    uint32_t phase;                                                     //inputs since the last output (decimators)
+    bool primed;                                                        //set once the state has been primed with the first input (avoids a start up transient)
+    float coefficients[5];                                              //b0, b1, b2, a1, a2 (biquads)
+    float state[SAMPLE_BATCH_AXIS_COUNT][2];                            //per axis, delay elements (biquads) or running sum (average decimators)
+    uint32_t tap_count;                                                 //fir decimators
+    float taps[FILTER_STAGE_MAX_TAPS];                                  //fir decimators (symmetric, unity dc gain)
+    uint32_t history_position;                                          //position of the oldest input in the history (fir decimators)
+    float history[SAMPLE_BATCH_AXIS_COUNT][2 * FILTER_STAGE_MAX_TAPS];  //per axis, the latest tap_count inputs, stored twice so they're always contiguous (fir decimators)
+}FILTER_STAGE;
+
+//filter chain object representation
+typedef struct filter_chain
+{
+    float input_rate_hz;                                                //sample rate into the first stage
+    float output_rate_hz;                                               //sample rate out of the last stage
+    uint32_t stage_count;
+    FILTER_STAGE stages[FILTER_CHAIN_MAX_STAGES];
+}FILTER_CHAIN;
+
+//function declarations
+bool init_filter_chain(FILTER_CHAIN*, float);
+bool add_biquad_filter_stage(FILTER_CHAIN*, FILTER_STAGE_TYPE, float);
+bool add_decimator_filter_stage(FILTER_CHAIN*, FILTER_STAGE_TYPE, uint32_t);
+bool add_filter_stages_from_specification(FILTER_CHAIN*, const char*);
+bool run_filter_chain(FILTER_CHAIN*, const SAMPLE_BATCH*, SAMPLE_BATCH*);
+
+#endif /* FILTERCHAIN_H_ */
@@ -10,6 +10,8 @@
 #include <stdbool.h>        //using for "bool" type
 #include <mraa/i2c.h>       //using for Intel MRAA low-level library
 
+#define I2C_DEVICE_MAX_WRITE_SIZE 32    //most bytes a single write carries after the register address (a sensor's register block)
+
 //i2c device object representation
 typedef struct i2c_device
 {
@@ -0,0 +1,70 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef IMUCALIBRATION_H_
+#define IMUCALIBRATION_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "int16_t" and "uint32_t" types
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Calibration of the gyroscope and magnetometer, estimated onboard so the backend doesn't re-correct every sample.
+
+    - gyro bias: the mean rate while the board is at rest (rejected if the rates vary more than rest allows), subtracted
+      from every gyro sample
+    - magnetometer hard iron: the center of the ellipsoid the readings lie on as the board is rotated, written to the
+      sensor's offset registers so the sensor subtracts it from every reading
+    - magnetometer soft iron: the symmetric matrix that maps that ellipsoid (once centered) onto a sphere of the same
+      mean radius, applied to every magnetometer sample
+
+    The ellipsoid is fit by least squares (x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z against 1), accumulating the normal
+    equations sample by sample, so a fit over any number of samples costs a fixed amount of memory.
+
+    The software corrections (gyro bias, soft iron matrix) are applied by the sample batch as it scales, fused with
+    the scale factors (see set_sample_batch_correction), so a corrected sample costs no more than a 3x3 multiply-add.
+*/
+#define IMU_CALIBRATION_FILE_VERSION 1          //version of the persisted calibration's format
+#define MAGNETO_ELLIPSOID_FIT_TERM_COUNT 9      //terms of the ellipsoid fit
+#define MAGNETO_ELLIPSOID_FIT_MIN_SAMPLES 100   //fewest samples a fit is attempted with
+
+//calibration object representation
+typedef struct imu_calibration
+{
+    float gyro_bias[3];                 //x, y, z (gyro raw units)
+    int16_t magneto_offsets[3];         //x, y, z hard iron offsets (magnetometer raw units, subtracted by the sensor)
+    float magneto_matrix[3][3];         //soft iron correction (applied to the offset readings, identity if uncalibrated)
+}IMU_CALIBRATION;
+
+//gyro bias estimator object representation
+typedef struct gyro_bias_estimator
+{
+    uint32_t sample_count;
+    double sums[3];                     //x, y, z (gyro raw units)
+    double square_sums[3];
+}GYRO_BIAS_ESTIMATOR;
+
+//magnetometer ellipsoid fit object representation
+typedef struct magneto_ellipsoid_fit
+{
+    uint32_t sample_count;
+    double normal_matrix[MAGNETO_ELLIPSOID_FIT_TERM_COUNT][MAGNETO_ELLIPSOID_FIT_TERM_COUNT];   //sum of the terms' outer products
+    double normal_vector[MAGNETO_ELLIPSOID_FIT_TERM_COUNT];                                     //sum of the terms
+    double scale_factor;                                                                        //raw value * scale factor = gauss (from the latest sample)
+}MAGNETO_ELLIPSOID_FIT;
+
+//function declarations
+void init_imu_calibration(IMU_CALIBRATION*);
+bool load_imu_calibration(IMU_CALIBRATION*, const char*);
+bool save_imu_calibration(const IMU_CALIBRATION*, const char*);
+bool apply_imu_calibration_to_sample_batch(const IMU_CALIBRATION*, SAMPLE_BATCH*);
+void init_gyro_bias_estimator(GYRO_BIAS_ESTIMATOR*);
+bool add_sample_to_gyro_bias_estimator(GYRO_BIAS_ESTIMATOR*, const SAMPLE_BATCH*, uint32_t);
+bool compute_gyro_bias(const GYRO_BIAS_ESTIMATOR*, double, double, IMU_CALIBRATION*, bool*);
+void init_magneto_ellipsoid_fit(MAGNETO_ELLIPSOID_FIT*);
+bool add_sample_to_magneto_ellipsoid_fit(MAGNETO_ELLIPSOID_FIT*, const SAMPLE_BATCH*, uint32_t);
+bool compute_magneto_ellipsoid_fit(const MAGNETO_ELLIPSOID_FIT*, IMU_CALIBRATION*);
+
+#endif /* IMUCALIBRATION_H_ */
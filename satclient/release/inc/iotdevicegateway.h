@@ -7,23 +7,34 @@
 #define IOTDEVICEGATEWAY_H_
 
 #include <stdbool.h>                            //using for "bool" type
+#include <stdint.h>                             //using for "uint16_t" type
 #include "aws_iot_mqtt_client_interface.h"      //using for AWS IoT device gateway connection
+#include "telemetrysink.h"                      //using for "TELEMETRY_READING" and "TELEMETRY_SINK" types
+
+//iot device gateway connection settings (the strings must outlive the gateway)
+typedef struct iot_device_gateway_settings
+{
+    const char* host;                   //aws iot endpoint
+    uint16_t port;
+    const char* client_id;              //mqtt client id (unique per device)
+    const char* root_ca_file;
+    const char* certificate_file;
+    const char* private_key_file;
+    const char* topic;                  //mqtt topic telemetry is published to
+    QoS qos;                            //QOS0 (fire and forget) or QOS1 (each reading acknowledged)
+}IOT_DEVICE_GATEWAY_SETTINGS;
 
 //iot device gatway object representation
 typedef struct iot_device_gateway
 {
     AWS_IoT_Client client_context;  //aws iot client handle
+    IOT_DEVICE_GATEWAY_SETTINGS settings;
 }IOT_DEVICE_GATEWAY;
 
-//telemetry reading object representation
-typedef struct telemetry_reading
-{
-    char json[256];  //reading formatted as json
-}TELEMETRY_READING;
-
 //function declarations
 bool init_iot_device_gateway(IOT_DEVICE_GATEWAY*);
 bool shutdown_iot_device_gateway(IOT_DEVICE_GATEWAY*);
 bool publish_telemetry_to_device_gateway(IOT_DEVICE_GATEWAY*, TELEMETRY_READING*);
+TELEMETRY_SINK* new_iot_device_gateway_telemetry_sink(const IOT_DEVICE_GATEWAY_SETTINGS*);
 
 #endif /* IOTDEVICEGATEWAY_H_ */
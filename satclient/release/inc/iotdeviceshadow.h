@@ -0,0 +1,35 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef IOTDEVICESHADOW_H_
+#define IOTDEVICESHADOW_H_
+
+#include "iotdevicegateway.h"   //using for "IOT_DEVICE_GATEWAY_SETTINGS" type
+#include "satconfig.h"          //using for "SAT_CONFIG_WATCHER" type
+
+/*
+    Remote tuning of a SAT process through its AWS IoT thing shadow, e.g. a fleet's rates turned down under backend load
+    (or one device's up for diagnostics) by setting the shadow's desired state:
+
+        {"state":{"desired":{"accel_odr":50,"flush_latency_ms":1000,"filters":"lowpass:10"}}}
+
+    Every tunable can be set (batch_size, flush_latency_ms, heartbeat_interval, gyro_odr, accel_odr, magneto_odr,
+    filters, see satconfig.h). Each delta is handed to the config watcher as a single update (every value in it is taken,
+    or none), which each board takes on at its next batch boundary without stopping acquisition. The values the boards
+    actually apply are reported back as the shadow's reported state, so the delta clears once they match, and a value a
+    board rejected stays in it.
+
+    The shadow has its own connection (its client id is the gateway's suffixed "-shadow"), serviced by a thread of its
+    own, so it works with any sinks. The sdk keeps the shadow's state in globals, so a process has at most one.
+*/
+
+//iot device shadow object representation (see iotdeviceshadow.c)
+typedef struct iot_device_shadow IOT_DEVICE_SHADOW;
+
+//function declarations
+IOT_DEVICE_SHADOW* new_iot_device_shadow(const IOT_DEVICE_GATEWAY_SETTINGS*, const char*, SAT_CONFIG_WATCHER*);
+void free_iot_device_shadow(IOT_DEVICE_SHADOW*);
+
+#endif /* IOTDEVICESHADOW_H_ */
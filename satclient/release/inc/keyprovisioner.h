@@ -0,0 +1,39 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef KEYPROVISIONER_H_
+#define KEYPROVISIONER_H_
+
+#include <stdbool.h>        //using for "bool" type
+#include <stdint.h>         //using for "uint8_t" and "uint32_t" types
+#include "cryptoutil.h"     //using for "KEY_DERIVATION_FUNCTION" type
+
+//key provisioning configuration object representation
+//string members point at storage owned by the caller (e.g., the process environment) and must outlive the provisioning call
+typedef struct key_provisioning_config
+{
+    const char* payload_file_location;                  //base64 encoded openssl payload (salt header + ciphertext) holding the secret key
+    int passphrase_fd;                                  //file descriptor to read the passphrase from (e.g., a pipe from a provisioning agent), -1 to skip
+    const char* passphrase_env_name;                    //name of the environment variable holding the passphrase (unset once read), NULL to skip
+    const char* passphrase_keyring_description;         //description of a "user" key in the kernel keyring holding the passphrase, NULL to skip
+    KEY_DERIVATION_FUNCTION kdf;                        //key derivation function the payload was encrypted with
+    uint32_t kdf_cost;                                  //pbkdf2 iteration count, or log2(N) for scrypt
+    const char* derived_key_cache_location;             //sealed derived key cache file (warm starts skip the kdf), NULL to disable
+    bool allow_interactive_prompt;                      //fall back to prompting on stdin when no other source supplies the payload location/passphrase
+}KEY_PROVISIONING_CONFIG;
+
+//key provisioning report object representation (how the secret key was obtained and how long it took)
+typedef struct key_provisioning_report
+{
+    bool warm_start;            //true if the derived key came from the sealed cache (the kdf was skipped)
+    double elapsed_ms;          //wall time spent provisioning (load + derive/unseal + decrypt)
+}KEY_PROVISIONING_REPORT;
+
+//function declarations
+void load_key_provisioning_config_from_environment(KEY_PROVISIONING_CONFIG*);
+bool provision_secret_key(const KEY_PROVISIONING_CONFIG*, uint8_t**, uint32_t*, KEY_PROVISIONING_REPORT*);
+bool invalidate_derived_key_cache(const KEY_PROVISIONING_CONFIG*);
+
+#endif /* KEYPROVISIONER_H_ */
@@ -6,9 +6,17 @@
 #ifndef LSM9DS0_H_
 #define LSM9DS0_H_
 
-#include <stdint.h>         //using for "uint8_t", "uint16_t", and "int16_t" types
+#include <stdint.h>         //using for "uint8_t", "uint16_t", "int16_t", and "int64_t" types
 #include <stdbool.h>        //using for "bool" type
 #include "i2cdevice.h"      //using to access I2C bus
+#include "rawsignalconvert.h"   //using to scale buffers of raw readings
+
+//i2c locations of the board (the SA0 pins select the default or alternate addresses of each sensor)
+#define LSM9DS0_DEFAULT_I2C_BUS 1
+#define LSM9DS0_GYRO_ADDRESS 0x6B                   //SA0_G high
+#define LSM9DS0_GYRO_ALTERNATE_ADDRESS 0x6A         //SA0_G low
+#define LSM9DS0_ACCEL_MAGNETO_ADDRESS 0x1D          //SA0_XM high
+#define LSM9DS0_ACCEL_MAGNETO_ALTERNATE_ADDRESS 0x1E    //SA0_XM low
 
 //enum for use in determining which sensor to work with
 typedef enum lsm9ds0_sensor
@@ -24,8 +32,18 @@ typedef struct lsm9ds0_signal_reading
     double x;
     double y;
     double z;
+    int64_t timestamp_ns;   //CLOCK_MONOTONIC time the reading was acquired (carried over from the raw reading)
 }LSM9DS0_SIGNAL_READING;
 
+//raw (unscaled) xyz signal reading object representation - two's compliment values exactly as read from the sensor
+typedef struct lsm9ds0_raw_signal_reading
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    int64_t timestamp_ns;   //CLOCK_MONOTONIC time the reading was acquired (nanoseconds, taken just before the data registers are read)
+}LSM9DS0_RAW_SIGNAL_READING;
+
 //signal reading aggregate representation
 typedef struct lsm9ds0_signal_reading_aggregate
 {
@@ -34,23 +52,66 @@ typedef struct lsm9ds0_signal_reading_aggregate
     LSM9DS0_SIGNAL_READING gyro;
 }LSM9DS0_SIGNAL_READING_AGGREGATE;
 
+//raw signal reading aggregate representation
+typedef struct lsm9ds0_raw_signal_reading_aggregate
+{
+    LSM9DS0_RAW_SIGNAL_READING accel;
+    LSM9DS0_RAW_SIGNAL_READING magneto;
+    LSM9DS0_RAW_SIGNAL_READING gyro;
+}LSM9DS0_RAW_SIGNAL_READING_AGGREGATE;
+
+//per sensor configuration - each value must be one the sensor supports (see configure_lsm9ds0)
+typedef struct lsm9ds0_sensor_config
+{
+    double odr_hz;          //output data rate (readings per second)
+    double bandwidth_hz;    //gyro: low pass cutoff, accel: anti-alias filter bandwidth, magneto: not applicable - 0 for the sensor's default
+    double fsr;             //full scale range (+ or -) in the sensor's units (dps, g, gauss)
+}LSM9DS0_SENSOR_CONFIG;
+
+//board configuration
+//gyro - odr: 95, 190, 380, 760hz, bandwidth: per odr (95hz: 12.5, 25hz, 190hz: 12.5, 25, 50, 70hz, 380hz: 20, 25, 50, 100hz, 760hz: 30, 35, 50, 100hz), fsr: 245, 500, 2000dps
+//accel - odr: 3.125, 6.25, 12.5, 25, 50, 100, 200, 400, 800, 1600hz, bandwidth: 50, 194, 362, 773hz, fsr: 2, 4, 6, 8, 16g
+//magneto - odr: 3.125, 6.25, 12.5, 25, 50, 100hz (100hz only with an accel odr over 50hz), fsr: 2, 4, 8, 12 gauss
+typedef struct lsm9ds0_config
+{
+    LSM9DS0_SENSOR_CONFIG gyro;
+    LSM9DS0_SENSOR_CONFIG accel;
+    LSM9DS0_SENSOR_CONFIG magneto;
+}LSM9DS0_CONFIG;
+
 //lsm9ds0 object representation
 typedef struct lsm9ds0
 {
     //i2c connections
     I2C_DEVICE gyro_i2c_device;
     I2C_DEVICE accel_magneto_i2c_device;
-    //sensor scale factors
+    //active configuration (as programmed into the sensors, bandwidths resolved to the actual cutoff)
+    LSM9DS0_CONFIG config;
+    //sensor scale factors (kept consistent with the active full scale ranges)
     double gyro_scale_factor;
     double accel_scale_factor;
     double magneto_scale_factor;
+    //widest kernel this host has for scaling buffers of raw readings
+    RAW_SIGNAL_CONVERSION_KERNEL conversion_kernel;
+    //signal overruns detected (across every sensor) since the board was initialized
+    uint32_t overrun_count;
 }LSM9DS0;
 
 //function declarations
 bool init_lsm9ds0(LSM9DS0*);
+bool init_lsm9ds0_at_address(LSM9DS0*, int, uint8_t, uint8_t);
 void shutdown_lsm9ds0(LSM9DS0* lsm);
+void get_default_lsm9ds0_config(LSM9DS0_CONFIG*);
+bool configure_lsm9ds0(LSM9DS0*, const LSM9DS0_CONFIG*);
+double get_lsm9ds0_sample_rate(const LSM9DS0*);
 bool get_sensor_id(LSM9DS0*, LSM9DS0_SENSOR, uint8_t*);
 bool get_latest_signal_reading(LSM9DS0*, LSM9DS0_SENSOR, LSM9DS0_SIGNAL_READING*);
+bool get_latest_raw_signal_reading(LSM9DS0*, LSM9DS0_SENSOR, LSM9DS0_RAW_SIGNAL_READING*);
+bool scale_raw_signal_reading(LSM9DS0*, LSM9DS0_SENSOR, const LSM9DS0_RAW_SIGNAL_READING*, LSM9DS0_SIGNAL_READING*);
+bool scale_raw_signal_buffer(LSM9DS0*, LSM9DS0_SENSOR, const uint8_t*, uint32_t, float*, float*, float*);
 bool check_signal_reading_availability(LSM9DS0*, LSM9DS0_SENSOR, bool*);
+bool enable_gyro_threshold_interrupt(LSM9DS0*, double);
+bool check_gyro_threshold_interrupt(LSM9DS0*, bool*);
+bool set_magneto_hard_iron_offsets(LSM9DS0*, const int16_t*);
 
 #endif /* LSM9DS0_H_ */
@@ -6,9 +6,52 @@
 #ifndef LSM9DS0PROCESSOR_H_
 #define LSM9DS0PROCESSOR_H_
 
-#include <stdbool.h>    //using for "bool" type
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint8_t" and "uint32_t" types
+#include "telemetrysink.h"      //using for "TELEMETRY_SINK" type
+#include "windowaggregator.h"   //using for "WINDOW_TYPE" type
+#include "ahrsfilter.h"         //using for "AHRS_ORIENTATION" type
+#include "eventdetector.h"      //using for "EVENT_DETECTOR_OPTIONS" type
+#include "spectralanalyzer.h"   //using for "SPECTRAL_FEATURES" type
+#include "lsm9ds0.h"            //using for "LSM9DS0_CONFIG" type
+#include "satconfig.h"          //using for "SAT_TUNABLES" and "SAT_CONFIG_WATCHER" types
+
+#define LSM9DS0_SAT_MAX_DEVICES 4      //most boards a SAT process acquires from (two per i2c bus, at the default and alternate addresses)
+
+//board location representation
+typedef struct lsm9ds0_sat_device
+{
+    int i2c_bus;
+    uint8_t gyro_address;
+    uint8_t accel_magneto_address;
+}LSM9DS0_SAT_DEVICE;
+
+//SAT process options
+typedef struct lsm9ds0_sat_options
+{
+    const char* device_id;          //device the readings are from (tagged on every reading and batch header)
+    LSM9DS0_SAT_DEVICE devices[LSM9DS0_SAT_MAX_DEVICES];    //boards to acquire from, each is serviced by the thread of its i2c bus and its readings tagged with its index
+    uint32_t device_count;
+    LSM9DS0_CONFIG sensor_config;   //output data rate, bandwidth, and full scale range of each sensor (see lsm9ds0.h), the sample rate everything downstream is sized from
+    const char* filter_specification;   //filter stages the readings go through before anything else, e.g. "lowpass:20,fir:4" (NULL for none, see filterchain.h)
+    WINDOW_TYPE window_type;        //kind of window summaries to publish (NO_WINDOW to only publish readings)
+    uint32_t window_length;         //samples per window
+    uint32_t window_hop;            //samples between summaries (sliding windows)
+    uint32_t orientation_interval;  //samples between published orientations (0 disables sensor fusion)
+    uint32_t spectrum_length;       //samples per spectral (fft) window, a power of two (0 disables spectral features)
+    uint32_t spectrum_hop;          //samples between spectral features (the length for tumbling windows)
+    bool publish_readings;          //publish every reading (and raw sample) alongside the window summaries, orientations, and spectral features (always done when there are none)
+    bool report_by_exception;       //only publish readings during events (with the history leading up to them) and heartbeats otherwise, in place of publish_readings
+    EVENT_DETECTOR_OPTIONS event_detection;     //detectors that start events (report by exception, see eventdetector.h)
+    const char* calibration_file;   //file the gyro and magnetometer calibration is loaded from (when present) and saved to, suffixed with the board's index past the first (NULL for none, see imucalibration.h)
+    bool calibrate_gyro;            //estimate the gyro bias before acquisition starts (the board must be kept still)
+    bool calibrate_magneto;         //fit the magnetometer's hard and soft iron before acquisition starts (the board must be rotated through every orientation)
+    SAT_TUNABLES tunables;          //batch size, flush latency, and heartbeat interval the boards start with (their rates and filters are the sensor config's and filter specification's)
+    SAT_CONFIG_WATCHER* config_watcher;     //source of reloaded tunables, taken on by each board between batches (NULL to keep the ones it started with)
+    uint64_t bus_cpu_mask;          //cpus the i2c bus threads run on, a bit per cpu (0 for any)
+}LSM9DS0_SAT_OPTIONS;
 
 //function declarations
-bool perform_lsm9ds0_sat(int);
+bool perform_lsm9ds0_sat(TELEMETRY_SINK*, int, const LSM9DS0_SAT_OPTIONS*);
 
 #endif /* LSM9DS0PROCESSOR_H_ */
@@ -0,0 +1,92 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t", "uint64_t", and "int64_t" types
+#include <stddef.h>             //using for "size_t" type
+
+/*
+    Process wide metrics: counters, gauges, and latency histograms, cheap enough to update on the hot path.
+
+    Every thread updates its own cache line aligned shard (claimed the first time the thread records anything), so an update
+    is a plain add to memory no other thread writes, with no locked instruction and no false sharing. Threads past the
+    shard count share one overflow shard (updated atomically). A snapshot sums the shards, so it is slightly behind a
+    thread that is mid update, never inconsistent.
+
+    Histograms are log-linear (HDR style): values below 8 get their own bucket, above that every power of two is split
+    into 8 buckets, so a bucket is within 12.5% of any value in it, up to 2^36 (~68 seconds in nanoseconds, larger values
+    land in the last bucket).
+*/
+#ifdef SATCLIENT_PROFILE_SMALL
+#define METRICS_MAX_THREADS 4                   //small profile (see satmemory.h), the rest share the overflow shard
+#else
+#define METRICS_MAX_THREADS 16                  //threads with a shard of their own
+#endif
+#define METRICS_HISTOGRAM_SUB_BUCKET_BITS 3     //8 buckets per power of two
+#define METRICS_HISTOGRAM_MAX_MAGNITUDE 36      //largest power of two a histogram resolves
+#define METRICS_HISTOGRAM_BUCKET_COUNT ((METRICS_HISTOGRAM_MAX_MAGNITUDE - METRICS_HISTOGRAM_SUB_BUCKET_BITS + 2) << METRICS_HISTOGRAM_SUB_BUCKET_BITS)
+
+//counters (monotonic)
+typedef enum metrics_counter
+{
+    METRICS_SIGNAL_OVERRUNS,        //readings a sensor overwrote before they were read
+    METRICS_I2C_ERRORS,             //failed i2c transactions
+    METRICS_READINGS_PUBLISHED,     //readings (json lines) handed to the sink
+    METRICS_BATCHES_PUBLISHED,      //batches handed to the sink
+    METRICS_PUBLISH_FAILURES,       //batches the sink failed to take
+    METRICS_BATCHES_DROPPED,        //batches a fan-out lane dropped because its queue was full
+    METRICS_BYTES_SENT,             //payload bytes a transport sent (or wrote)
+    METRICS_TRANSPORT_CONNECTS,     //transport connections made (every one past the first is a reconnect)
+    METRICS_COUNTER_COUNT
+}METRICS_COUNTER;
+
+//gauges (current value)
+typedef enum metrics_gauge
+{
+    METRICS_QUEUE_DEPTH,            //batches queued across the fan-out lanes
+    METRICS_GAUGE_COUNT
+}METRICS_GAUGE;
+
+//histograms (nanoseconds)
+typedef enum metrics_histogram
+{
+    METRICS_I2C_TRANSACTION_NS,     //duration of an i2c transaction
+    METRICS_SAMPLE_AGE_NS,          //time from a sample's acquisition to its batch being handed to the sink
+    METRICS_ENCODE_NS,              //time to transform and encode a reading (and whatever it completes) into the batch
+    METRICS_PUBLISH_NS,             //time to hand a batch to the sink
+    METRICS_HISTOGRAM_COUNT
+}METRICS_HISTOGRAM;
+
+//histogram object representation
+typedef struct metrics_histogram_data
+{
+    uint64_t buckets[METRICS_HISTOGRAM_BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sum;
+}METRICS_HISTOGRAM_DATA;
+
+//snapshot object representation (several kilobytes)
+typedef struct metrics_snapshot
+{
+    uint64_t counters[METRICS_COUNTER_COUNT];
+    int64_t gauges[METRICS_GAUGE_COUNT];
+    METRICS_HISTOGRAM_DATA histograms[METRICS_HISTOGRAM_COUNT];
+}METRICS_SNAPSHOT;
+
+//function declarations
+int64_t get_metrics_time_ns(void);
+void increment_metrics_counter(METRICS_COUNTER, uint64_t);
+void add_to_metrics_gauge(METRICS_GAUGE, int64_t);
+void record_metrics_histogram(METRICS_HISTOGRAM, uint64_t);
+void take_metrics_snapshot(METRICS_SNAPSHOT*);
+uint64_t get_metrics_snapshot_quantile(const METRICS_SNAPSHOT*, METRICS_HISTOGRAM, double);
+bool format_metrics_snapshot_as_prometheus(const METRICS_SNAPSHOT*, char*, size_t, size_t*);
+uint32_t get_metrics_histogram_bucket_index(uint64_t);
+uint64_t get_metrics_histogram_bucket_lower_bound(uint32_t);
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,18 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef METRICSENDPOINT_H_
+#define METRICSENDPOINT_H_
+
+#include <stdint.h>             //using for "uint16_t" and "uint32_t" types
+
+//metrics endpoint object representation (see metricsendpoint.c)
+typedef struct metrics_endpoint METRICS_ENDPOINT;
+
+//function declarations
+METRICS_ENDPOINT* new_metrics_endpoint(uint16_t, uint32_t);
+void free_metrics_endpoint(METRICS_ENDPOINT*);
+
+#endif /* METRICSENDPOINT_H_ */
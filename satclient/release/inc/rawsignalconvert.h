@@ -0,0 +1,36 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef RAWSIGNALCONVERT_H_
+#define RAWSIGNALCONVERT_H_
+
+#include <stdbool.h>        //using for "bool" type
+#include <stdint.h>         //using for "uint8_t" and "uint32_t" types
+
+/*
+    Batch conversion of raw xyz signal readings, as burst read from a sensor's output (or FIFO) registers, into scaled columns.
+
+    The buffer holds sample_count packed readings of 6 bytes each: x, y, z as little endian two's compliment words
+    (OUT_X_L, OUT_X_H, OUT_Y_L, OUT_Y_H, OUT_Z_L, OUT_Z_H). Each word is converted to float and multiplied by the
+    sensor's scale factor (a single float multiply, so every kernel renders bit identical results), and the x, y,
+    and z values are written to separate arrays.
+*/
+
+//enum for the conversion kernels (the vectorized kernels are only available on hosts whose instruction set supports them)
+typedef enum raw_signal_conversion_kernel
+{
+    SCALAR_CONVERSION_KERNEL,       //portable c, always available
+    SSE2_CONVERSION_KERNEL,         //x86, 4 samples per step
+    AVX2_CONVERSION_KERNEL,         //x86 (detected at run time), 8 samples per step
+    NEON_CONVERSION_KERNEL          //arm, 8 samples per step
+}RAW_SIGNAL_CONVERSION_KERNEL;
+
+//function declarations
+bool is_raw_signal_conversion_kernel_available(RAW_SIGNAL_CONVERSION_KERNEL);
+RAW_SIGNAL_CONVERSION_KERNEL get_preferred_raw_signal_conversion_kernel(void);
+const char* get_raw_signal_conversion_kernel_name(RAW_SIGNAL_CONVERSION_KERNEL);
+bool convert_raw_signal_buffer(RAW_SIGNAL_CONVERSION_KERNEL, const uint8_t*, uint32_t, float, float*, float*, float*);
+
+#endif /* RAWSIGNALCONVERT_H_ */
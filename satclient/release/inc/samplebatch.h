@@ -0,0 +1,66 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef SAMPLEBATCH_H_
+#define SAMPLEBATCH_H_
+
+#include <stdbool.h>        //using for "bool" type
+#include <stdint.h>         //using for "int16_t", "uint32_t", and "int64_t" types
+
+/*
+    Structure of arrays batch of IMU samples.
+
+    Each axis is a column of raw int16 values exactly as read from the sensor (18 bytes of axis data per sample,
+    26 with its timestamp, against 96 for a LSM9DS0_SIGNAL_READING_AGGREGATE), so code that works on an axis walks
+    contiguous memory and the loops vectorize. Scaled float values are only computed when asked for, and only for
+    samples appended since the last time they were.
+
+    A sensor can carry a calibration correction (a 3x3 matrix and an offset, see imucalibration.h), which is fused
+    with its scale factor so its scaled values cost a single multiply-add per matrix element rather than a separate
+    correction pass: scaled = (scale factor * matrix) * raw + (scale factor * offset).
+
+    Columns are 16 byte aligned (what malloc guarantees, so batches can be embedded in heap allocated structures)
+    and are a multiple of 16 bytes long, so every column starts on a vector boundary.
+*/
+#define SAMPLE_BATCH_MAX_SAMPLES 32         //largest number of samples a batch can hold (a sensor's FIFO depth)
+#define SAMPLE_BATCH_AXIS_COUNT 9           //axes per sample
+#define SAMPLE_BATCH_SENSOR_COUNT 3         //sensors per sample (3 axes each)
+
+//enum for the sample axes (in column order)
+typedef enum sample_batch_axis
+{
+    SAMPLE_ACCEL_X,
+    SAMPLE_ACCEL_Y,
+    SAMPLE_ACCEL_Z,
+    SAMPLE_MAGNETO_X,
+    SAMPLE_MAGNETO_Y,
+    SAMPLE_MAGNETO_Z,
+    SAMPLE_GYRO_X,
+    SAMPLE_GYRO_Y,
+    SAMPLE_GYRO_Z
+}SAMPLE_BATCH_AXIS;
+
+//sample batch object representation
+typedef struct sample_batch
+{
+    int64_t timestamps_ns[SAMPLE_BATCH_MAX_SAMPLES];                            //time each sample was acquired (nanoseconds since unix epoch)
+    int16_t raw[SAMPLE_BATCH_AXIS_COUNT][SAMPLE_BATCH_MAX_SAMPLES];             //raw (unscaled) value of each sample, per axis
+    float scaled[SAMPLE_BATCH_AXIS_COUNT][SAMPLE_BATCH_MAX_SAMPLES];            //raw value * scale factor, per axis (valid below scaled_sample_count)
+    double scale_factors[SAMPLE_BATCH_AXIS_COUNT];                              //per axis, raw value * scale factor = value in the sensor's units (g, gauss, dps)
+    bool corrected[SAMPLE_BATCH_SENSOR_COUNT];                                  //per sensor (accel, magneto, gyro), denotes if a correction is applied when scaling
+    float correction_matrices[SAMPLE_BATCH_SENSOR_COUNT][3][3];                 //per sensor, applied to the raw xyz values
+    float correction_offsets[SAMPLE_BATCH_SENSOR_COUNT][3];                     //per sensor, added to the corrected raw xyz values (raw units)
+    uint32_t sample_count;                                                      //number of samples in the batch
+    uint32_t scaled_sample_count;                                               //number of samples whose scaled values are current
+}__attribute__((aligned(16))) SAMPLE_BATCH;
+
+//function declarations
+void clear_sample_batch(SAMPLE_BATCH*);
+void set_sample_batch_scale_factors(SAMPLE_BATCH*, double, double, double);
+bool set_sample_batch_correction(SAMPLE_BATCH*, SAMPLE_BATCH_AXIS, const float (*)[3], const float*);
+bool append_sample_to_sample_batch(SAMPLE_BATCH*, int64_t, const int16_t*);
+const float* get_scaled_sample_batch_column(SAMPLE_BATCH*, SAMPLE_BATCH_AXIS);
+
+#endif /* SAMPLEBATCH_H_ */
@@ -0,0 +1,113 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef SATCONFIG_H_
+#define SATCONFIG_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t" and "uint64_t" types
+#include <pthread.h>            //using for "pthread_t" type
+
+/*
+    Runtime configuration of the SAT process, read from a file at startup in place of compile-time constants.
+
+    The file holds one "key value" setting per line ("#" starts a comment), e.g.
+
+        device_id edison_alva2
+        sinks aws,file
+        aws_host abc123.iot.us-east-1.amazonaws.com
+        gyro_odr 190
+        flush_latency_ms 100
+
+    Every setting is optional (see the table in satconfig.c for the keys, their defaults, and their ranges), and each
+    can be overridden by an environment variable named after it, e.g. SATCLIENT_GYRO_ODR. Unknown keys and values that
+    don't parse or are out of range are rejected (naming the line), so a typo never silently falls back to a default.
+
+    The configuration is resolved once into an immutable struct, nothing looks a setting up while readings flow. The
+    tunables (settings a running process can take on) are reloaded from the file on SIGHUP by a config watcher thread,
+    or updated remotely (e.g. from a thing shadow's delta), and each board applies them at its next batch boundary,
+    changes to the other settings wait for a restart. The boards hand the values they actually applied back to the
+    watcher (a rejected output data rate or filter chain is left as it was), so they can be reported.
+*/
+#define SAT_CONFIG_MAX_VALUE_SIZE 256           //longest value (paths, host names, lists) including the terminator
+
+//settings a running SAT process takes on when the file is reloaded, or they are updated remotely (applied by each board between batches)
+typedef struct sat_tunables
+{
+    uint32_t batch_size;                //most readings per published batch (0 for as many as a batch holds)
+    uint32_t flush_latency_ms;          //milliseconds of readings a board batches before publishing them (at the board's sample rate)
+    uint32_t heartbeat_interval;        //readings between heartbeats (report by exception, 0 for none)
+    double gyro_odr;                    //output data rate of each sensor (see lsm9ds0.h, the sample rate everything downstream is sized from)
+    double accel_odr;
+    double magneto_odr;
+    char filters[SAT_CONFIG_MAX_VALUE_SIZE];    //filter stages, e.g. "lowpass:20,fir:4" (empty for none, see filterchain.h)
+}SAT_TUNABLES;
+
+//resolved configuration representation (strings are null terminated, "none" where a file may be left out)
+typedef struct sat_config
+{
+    char device_id[SAT_CONFIG_MAX_VALUE_SIZE];              //device the readings are from (tagged on every reading and batch header)
+    uint32_t processing_limit;                              //readings each board publishes before the SAT process stops
+    char sinks[SAT_CONFIG_MAX_VALUE_SIZE];                  //transports, a comma separated list of "aws", "azure", "file", "columnar"
+    char sink_file[SAT_CONFIG_MAX_VALUE_SIZE];              //file (or named pipe) the "file" sink appends to
+    char columnar_sink_file[SAT_CONFIG_MAX_VALUE_SIZE];     //file the "columnar" sink writes
+    uint32_t queue_depth;                                   //batches each transport may fall behind by when there are several (see fanoutsink.h)
+    char aws_host[SAT_CONFIG_MAX_VALUE_SIZE];               //aws iot device gateway endpoint
+    uint32_t aws_port;
+    char aws_client_id[SAT_CONFIG_MAX_VALUE_SIZE];          //mqtt client id (unique per device)
+    char aws_thing_name[SAT_CONFIG_MAX_VALUE_SIZE];         //thing whose shadow the device reports to
+    char aws_root_ca_file[SAT_CONFIG_MAX_VALUE_SIZE];
+    char aws_certificate_file[SAT_CONFIG_MAX_VALUE_SIZE];
+    char aws_private_key_file[SAT_CONFIG_MAX_VALUE_SIZE];
+    char aws_topic[SAT_CONFIG_MAX_VALUE_SIZE];              //mqtt topic the readings are published to
+    uint32_t aws_qos;                                       //mqtt quality of service (0: fire and forget, 1: acknowledged)
+    char devices[SAT_CONFIG_MAX_VALUE_SIZE];                //boards as i2c bus numbers, suffixed ":alt" for the alternate addresses, e.g. "1,1:alt,2" (empty for the default board)
+    double gyro_bandwidth;                                  //bandwidth and full scale range of each sensor (see lsm9ds0.h, the output data rates are tunables)
+    double gyro_fsr;
+    double accel_bandwidth;
+    double accel_fsr;
+    double magneto_fsr;
+    char window[SAT_CONFIG_MAX_VALUE_SIZE];                 //kind of window summaries ("none", "tumbling", "sliding")
+    uint32_t window_length;
+    uint32_t window_hop;
+    uint32_t orientation_interval;                          //readings between published orientations (0 disables sensor fusion)
+    uint32_t spectrum_length;                               //samples per spectral window (0 disables spectral features)
+    uint32_t spectrum_hop;                                  //samples between spectral features (0 for the length)
+    bool publish_readings;
+    bool report_by_exception;
+    double event_accel_threshold;                           //event detection thresholds (0 disables a detector, see eventdetector.h)
+    double event_gyro_threshold;
+    double event_accel_delta;
+    double event_gyro_delta;
+    double event_zscore;
+    uint32_t event_hold;
+    uint32_t event_pre_trigger;
+    char calibration_file[SAT_CONFIG_MAX_VALUE_SIZE];       //file the calibration is loaded from and saved to ("none" for no file)
+    char calibrate[SAT_CONFIG_MAX_VALUE_SIZE];              //sensors to calibrate before acquisition starts ("none", "gyro", "magneto", "all")
+    uint32_t metrics_port;                                  //loopback port the metrics are served on (0 for none)
+    uint32_t metrics_interval;                              //seconds between printed metrics summaries (0 for none)
+    char trace_file[SAT_CONFIG_MAX_VALUE_SIZE];             //file the trace is written to (trace builds)
+    uint64_t bus_cpu_mask;                                  //cpus the i2c bus threads run on, a bit per cpu (0 for any), "0,1" in the file
+    uint64_t lane_cpu_mask;                                 //cpus the fan-out sink's transport threads run on (0 for any)
+    bool aws_shadow;                                        //take the tunables from the thing shadow's desired state, reporting the ones in effect (see iotdeviceshadow.h)
+    SAT_TUNABLES tunables;
+}SAT_CONFIG;
+
+//config watcher object representation (see satconfig.c)
+typedef struct sat_config_watcher SAT_CONFIG_WATCHER;
+
+//function declarations
+void get_default_sat_config(SAT_CONFIG*);
+bool load_sat_config(SAT_CONFIG*, const char*);
+SAT_CONFIG_WATCHER* new_sat_config_watcher(const char*, const SAT_CONFIG*);
+bool reload_sat_config_tunables(SAT_CONFIG_WATCHER*);
+bool get_sat_config_tunables(SAT_CONFIG_WATCHER*, uint32_t*, SAT_TUNABLES*);
+bool update_sat_config_tunables(SAT_CONFIG_WATCHER*, const char* const*, const char* const*, uint32_t);
+void set_sat_config_applied_tunables(SAT_CONFIG_WATCHER*, const SAT_TUNABLES*);
+bool get_sat_config_applied_tunables(SAT_CONFIG_WATCHER*, uint32_t*, SAT_TUNABLES*);
+void free_sat_config_watcher(SAT_CONFIG_WATCHER*);
+bool set_thread_cpu_mask(pthread_t, uint64_t);
+
+#endif /* SATCONFIG_H_ */
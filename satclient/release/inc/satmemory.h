@@ -0,0 +1,75 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef SATMEMORY_H_
+#define SATMEMORY_H_
+
+#include <stdio.h>              //using for "FILE" type
+#include <stdint.h>             //using for "uint32_t" and "uint64_t" types
+#include <stddef.h>             //using for "size_t" type
+
+/*
+    Memory arena every SAT client module allocates from (rather than the heap), with the bytes each module holds
+    accounted for separately.
+
+    The arena's address space is reserved in one go the first time anything is allocated (pages are only backed by RAM
+    once they are touched, so an arena that is never filled costs no more than what is carved out of it). Blocks are
+    carved out of it in size classes and a freed block goes on its class's free list, where the next allocation of that
+    class picks it up, so allocating and freeing are O(1) and a module that frees and reallocates (e.g. a sink being
+    rebuilt) reuses the same memory rather than growing the arena. Size classes are log-linear like the metrics'
+    histograms: 16 byte units below 8 units, above that every power of two is split into 8 classes (a block is within
+    12.5% of the size asked for). Blocks are 16 byte aligned, the same as malloc.
+
+    Once the SAT process is running nothing is allocated at all (every module allocates what it needs as it is
+    created), the report lists what each module holds and the most it has held, build with -DSATCLIENT_MEMORY_REPORT
+    (e.g. make -f make/release_makefile footprint) to have it written when the SAT process exits.
+
+    The small profile (-DSATCLIENT_PROFILE_SMALL, e.g. make -f make/release_makefile PROFILE_FLAGS=-DSATCLIENT_PROFILE_SMALL)
+    reserves a smaller arena and shrinks the statically allocated buffers and tables (see aws_iot_config.h, trace.h,
+    metrics.h, and fanoutsink.h).
+*/
+#ifdef SATCLIENT_PROFILE_SMALL
+#define SAT_MEMORY_ARENA_SIZE (2 * 1024 * 1024)         //bytes of address space reserved for the arena
+#else
+#define SAT_MEMORY_ARENA_SIZE (8 * 1024 * 1024)
+#endif
+
+//modules that allocate from the arena (each one's usage is accounted for separately)
+typedef enum sat_memory_owner
+{
+    SAT_MEMORY_SAT_CONFIG,          //config watcher
+    SAT_MEMORY_METRICS_ENDPOINT,    //metrics endpoint
+    SAT_MEMORY_TRACE,               //trace writer and the threads' rings
+    SAT_MEMORY_LSM9DS0_PROCESSOR,   //board pipelines
+    SAT_MEMORY_TELEMETRY_SINK,      //sink objects
+    SAT_MEMORY_FANOUT_SINK,         //fan-out sink state and its batch slots
+    SAT_MEMORY_FILE_SINK,           //file sink state
+    SAT_MEMORY_COLUMNAR_SINK,       //columnar sink state
+    SAT_MEMORY_IOT_DEVICE_GATEWAY,  //aws iot mqtt client (and its buffers)
+    SAT_MEMORY_IOT_DEVICE_SHADOW,   //aws iot thing shadow client (and its buffers)
+    SAT_MEMORY_EVENT_HUB,           //azure event hub state
+    SAT_MEMORY_MESSAGING_CLIENT,    //amqp client state
+    SAT_MEMORY_CRYPTO,              //keys, payloads, and digests (handed to the caller, who frees them)
+    SAT_MEMORY_OWNER_COUNT
+}SAT_MEMORY_OWNER;
+
+//memory usage of a module
+typedef struct sat_memory_usage
+{
+    uint64_t allocated_bytes;       //bytes of the blocks the module holds (what it asked for, rounded up to a size class)
+    uint64_t peak_bytes;            //most bytes the module has held at once
+    uint64_t allocation_count;      //blocks the module has been handed
+    uint64_t failure_count;         //allocations that failed (arena full, or too large)
+}SAT_MEMORY_USAGE;
+
+//function declarations
+void* allocate_sat_memory(SAT_MEMORY_OWNER, size_t);
+void* allocate_zeroed_sat_memory(SAT_MEMORY_OWNER, size_t);
+void free_sat_memory(void*);
+void get_sat_memory_usage(SAT_MEMORY_OWNER, SAT_MEMORY_USAGE*);
+size_t get_sat_memory_arena_used_bytes(void);
+void write_sat_memory_report(FILE*);
+
+#endif /* SATMEMORY_H_ */
@@ -0,0 +1,81 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef SPECTRALANALYZER_H_
+#define SPECTRALANALYZER_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint16_t", "int16_t", "uint32_t", and "int64_t" types
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Frequency domain (vibration) features of the accelerometer axes, computed over power of two windows of samples
+    (every hop samples, so a hop of the length gives tumbling windows, a shorter hop gives sliding ones).
+
+    Each window has its mean (gravity) removed and a hann window applied, then goes through a real fft (a complex fft
+    of half the length, split into the real spectrum), rendering per axis:
+    - rms: of the window (with its mean removed), from the whole spectrum
+    - dominant frequency and amplitude: the strongest bin above dc (frequency refined by parabolic interpolation)
+    - band energies: mean square in equal width bands from dc to the nyquist frequency (they sum to the rms squared)
+
+    Twiddle factors, the bit reversal permutation, and the hann window are computed when the analyzer is initialized,
+    and the butterflies run 4 at a time (sse2 or neon), so a window costs no allocation and no trig.
+*/
+#define SPECTRAL_ANALYZER_MIN_LENGTH 16         //smallest window length (in samples) supported
+#define SPECTRAL_ANALYZER_MAX_LENGTH 1024       //largest window length (in samples) supported
+#define SPECTRAL_BAND_COUNT 8                   //bands the spectrum is divided into
+#define SPECTRAL_AXIS_COUNT 3                   //accelerometer x, y, z
+
+//per axis features object representation
+typedef struct spectral_axis_features
+{
+    float rms;                                      //g
+    float dominant_frequency_hz;
+    float dominant_amplitude;                       //g (peak)
+    float band_energies[SPECTRAL_BAND_COUNT];       //g^2 (mean square)
+}SPECTRAL_AXIS_FEATURES;
+
+//window features object representation
+typedef struct spectral_features
+{
+    uint32_t spectrum_id;                           //zero indexed, order of the windows
+    uint32_t sample_count;                          //samples in the window
+    float sample_rate_hz;
+    float band_width_hz;
+    int64_t start_timestamp_ns;                     //timestamp of the first sample in the window
+    int64_t end_timestamp_ns;                       //timestamp of the last sample in the window
+    SPECTRAL_AXIS_FEATURES axes[SPECTRAL_AXIS_COUNT];
+}SPECTRAL_FEATURES;
+
+//spectral analyzer object representation
+typedef struct spectral_analyzer
+{
+    uint32_t length;                                                    //samples per window
+    uint32_t hop;                                                       //samples between windows
+    float sample_rate_hz;
+    uint32_t position;                                                  //position the next sample is written to (the oldest sample once the history is full)
+    uint32_t count;                                                     //number of samples in the history
+    uint32_t samples_since_spectrum;
+    uint32_t spectrum_count;                                            //windows completed
+    double scale_factors[SPECTRAL_AXIS_COUNT];                          //raw value * scale factor = g (from the latest sample)
+    int16_t history[SPECTRAL_AXIS_COUNT][SPECTRAL_ANALYZER_MAX_LENGTH]; //latest length raw values, per axis (ring buffer)
+    int64_t timestamps_ns[SPECTRAL_ANALYZER_MAX_LENGTH];                //timestamps of the samples in the history
+    //tables (computed once)
+    float window[SPECTRAL_ANALYZER_MAX_LENGTH];                         //hann window
+    float window_sum;                                                   //sum of the window (its coherent gain * length)
+    float window_square_sum;                                            //sum of the window squared (its power gain * length)
+    uint16_t bit_reversal[SPECTRAL_ANALYZER_MAX_LENGTH / 2];            //input permutation of the half length complex fft
+    float stage_twiddles[2][SPECTRAL_ANALYZER_MAX_LENGTH / 2];          //real, imaginary - the twiddles of the stage with h butterflies per group start at h (contiguous per stage)
+    float split_twiddles[2][SPECTRAL_ANALYZER_MAX_LENGTH / 2];          //real, imaginary - twiddles that split the half length fft into the real spectrum
+    //working storage
+    float work[2][SPECTRAL_ANALYZER_MAX_LENGTH / 2];                    //real, imaginary - half length complex fft, in place
+    float power[(SPECTRAL_ANALYZER_MAX_LENGTH / 2) + 1];                //mean square per bin (dc to nyquist)
+}__attribute__((aligned(16))) SPECTRAL_ANALYZER;
+
+//function declarations
+bool init_spectral_analyzer(SPECTRAL_ANALYZER*, uint32_t, uint32_t, float);
+bool add_sample_to_spectral_analyzer(SPECTRAL_ANALYZER*, const SAMPLE_BATCH*, uint32_t, SPECTRAL_FEATURES*, bool*);
+
+#endif /* SPECTRALANALYZER_H_ */
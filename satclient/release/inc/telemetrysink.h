@@ -0,0 +1,120 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef TELEMETRYSINK_H_
+#define TELEMETRYSINK_H_
+
+#include <stdbool.h>        //using for "bool" type
+#include <stdint.h>         //using for "uint32_t" and "int64_t" types
+#include "samplebatch.h"    //using for "SAMPLE_BATCH" type
+
+#define TELEMETRY_BATCH_MAX_READINGS 32     //largest number of readings a single batch can carry
+#define TELEMETRY_BATCH_MAX_PAYLOAD_SIZE (TELEMETRY_BATCH_MAX_READINGS * 320)   //largest payload a single batch can carry (room for a full batch of sensor readings)
+#define TELEMETRY_BATCH_MAX_HEADER_SIZE 1536    //room for the header line at the front of the payload (on top of the readings)
+#define TELEMETRY_MAX_GAPS 8                    //most lost ranges a batch header lists (any more are only counted)
+#define TELEMETRY_MAX_SOURCES 4                 //most sources (boards) whose losses are accounted for separately
+
+/*
+    Every batch starts with a header line, so the backend can tell data that was lost on the device (and where) from
+    data that went missing on the way. The header gives the sequence ids of the readings acquired into the batch, the
+    number of readings each stage has lost since the source started (so a lost header is made up for by the next), and
+    the ranges of sequence ids lost since the last header that was delivered.
+*/
+
+//stages of the pipeline telemetry can be lost at
+typedef enum telemetry_loss_stage
+{
+    TELEMETRY_LOSS_SENSOR_OVERRUN,      //sensor overwrote readings before they were read (counted per overrun, the sensor can't tell how many, its range is the readings it occurred before)
+    TELEMETRY_LOSS_RING_DROP,           //readings in batches a fan-out lane dropped because its queue was full
+    TELEMETRY_LOSS_ENCODE_FAILURE,      //readings that couldn't be encoded into their batch
+    TELEMETRY_LOSS_PUBLISH_FAILURE,     //readings in batches a sink failed to take
+    TELEMETRY_LOSS_STAGE_COUNT
+}TELEMETRY_LOSS_STAGE;
+
+//range of sequence ids lost at a stage representation
+typedef struct telemetry_loss_gap
+{
+    TELEMETRY_LOSS_STAGE stage;
+    int first_sequence_id;
+    int last_sequence_id;
+}TELEMETRY_LOSS_GAP;
+
+//loss accounting of a source representation
+typedef struct telemetry_loss_record
+{
+    uint64_t lost_counts[TELEMETRY_LOSS_STAGE_COUNT];   //readings lost at each stage since the source started
+    uint32_t gap_count;                                 //number of ranges lost since the last delivered header
+    uint32_t omitted_gap_count;                         //number of ranges lost since then that didn't fit (only counted)
+    TELEMETRY_LOSS_GAP gaps[TELEMETRY_MAX_GAPS];
+}TELEMETRY_LOSS_RECORD;
+
+//batch header representation
+typedef struct telemetry_batch_header
+{
+    const char* device_id;              //device the batch is from (must outlive the batch, e.g. a literal)
+    uint32_t source_index;              //source (board) the batch is from, below TELEMETRY_MAX_SOURCES
+    int first_sequence_id;              //sequence ids of the readings acquired into the batch (-1 until the first is)
+    int last_sequence_id;
+    TELEMETRY_LOSS_RECORD loss;
+}TELEMETRY_BATCH_HEADER;
+
+//telemetry reading object representation
+typedef struct telemetry_reading
+{
+    char json[640];  //reading formatted as json (sized for the longest line, a window summary)
+}TELEMETRY_READING;
+
+//telemetry batch object representation (readings encoded once, as newline delimited json, and shared by every transport)
+//the payload must remain the last member, transports that copy a batch only copy the used portion of it
+typedef struct telemetry_batch
+{
+    SAMPLE_BATCH samples;                                           //raw samples (and their scale factors), for sinks that store samples rather than json
+    int64_t wall_clock_offset_ns;                                   //added to a CLOCK_MONOTONIC acquisition time to get the wall clock timestamps in the batch (sampled once per batch)
+    TELEMETRY_BATCH_HEADER header;                                  //loss accounting, encoded as the first line of the payload by "encode_telemetry_batch_header"
+    uint32_t reading_count;     //number of readings in the batch (excluding the header)
+    uint32_t header_size;       //number of bytes of the payload taken by the header line (zero until it is encoded)
+    uint32_t payload_size;      //number of bytes used in the payload (excluding the null terminator)
+    char payload[TELEMETRY_BATCH_MAX_HEADER_SIZE + TELEMETRY_BATCH_MAX_PAYLOAD_SIZE + 1];  //the header, then one json reading per line (null terminated)
+}TELEMETRY_BATCH;
+
+//forward declaration so the interface can refer to the sink
+typedef struct telemetry_sink TELEMETRY_SINK;
+
+//telemetry sink interface (implemented once per transport)
+typedef struct telemetry_sink_interface
+{
+    bool (*open)(TELEMETRY_SINK*);                                  //connect/authenticate/create the underlying transport
+    bool (*publish_batch)(TELEMETRY_SINK*, const TELEMETRY_BATCH*); //hand a batch to the transport (the batch is only borrowed for the duration of the call)
+    bool (*flush)(TELEMETRY_SINK*);                                 //push anything the transport is holding onto the wire/disk
+    bool (*close)(TELEMETRY_SINK*);                                 //disconnect/close the underlying transport
+    void (*free_context)(void*);                                    //deallocate the transport specific context
+}TELEMETRY_SINK_INTERFACE;
+
+//telemetry sink object representation
+struct telemetry_sink
+{
+    const char* name;                               //name of the transport (used in diagnostics)
+    const TELEMETRY_SINK_INTERFACE* interface;      //transport implementation
+    void* context;                                  //transport specific state (owned by the sink)
+    bool is_open;                                   //denotes if the transport is currently open
+};
+
+//function declarations
+void clear_telemetry_batch(TELEMETRY_BATCH*);
+bool append_telemetry_reading_to_batch(TELEMETRY_BATCH*, const TELEMETRY_READING*);
+bool encode_telemetry_batch_header(TELEMETRY_BATCH*);
+void record_telemetry_loss(TELEMETRY_LOSS_RECORD*, TELEMETRY_LOSS_STAGE, int, int, uint64_t);
+void merge_telemetry_loss(TELEMETRY_LOSS_RECORD*, const TELEMETRY_LOSS_RECORD*);
+void clear_telemetry_loss_gaps(TELEMETRY_LOSS_RECORD*);
+uint32_t get_telemetry_batch_used_size(const TELEMETRY_BATCH*);
+bool get_next_telemetry_batch_line(const TELEMETRY_BATCH*, uint32_t*, const char**, uint32_t*);
+TELEMETRY_SINK* new_telemetry_sink(const char*, const TELEMETRY_SINK_INTERFACE*, void*);
+void free_telemetry_sink(TELEMETRY_SINK*);
+bool open_telemetry_sink(TELEMETRY_SINK*);
+bool publish_telemetry_batch_to_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+bool flush_telemetry_sink(TELEMETRY_SINK*);
+bool close_telemetry_sink(TELEMETRY_SINK*);
+
+#endif /* TELEMETRYSINK_H_ */
@@ -0,0 +1,70 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "uint32_t", "uint64_t", and "int64_t" types
+
+/*
+    Binary tracing of the hot paths, written out as a chrome trace (json, loads in chrome://tracing and perfetto).
+
+    Every thread records into a ring of its own (a single producer, single consumer queue, so recording takes no lock
+    and never waits), a trace writer thread drains the rings to the trace file in the background. A full ring drops
+    events (counted) rather than stall the thread recording them. Event names must be string literals (or otherwise
+    outlive the trace), only the pointer is recorded.
+
+    Tracing is compiled in with -DSATCLIENT_TRACE (e.g. make -f make/release_makefile TRACE_FLAGS=-DSATCLIENT_TRACE),
+    otherwise the macros expand to nothing and cost nothing.
+*/
+#ifdef SATCLIENT_PROFILE_SMALL
+#define TRACE_MAX_THREADS 8             //small profile (see satmemory.h)
+#define TRACE_RING_SIZE 1024
+#else
+#define TRACE_MAX_THREADS 16            //threads that get a ring (events of any past that are dropped)
+#define TRACE_RING_SIZE 4096            //events each ring holds (a power of two)
+#endif
+
+//kinds of trace event (the chrome trace phases)
+typedef enum trace_phase
+{
+    TRACE_PHASE_BEGIN,          //start of a span ("B")
+    TRACE_PHASE_END,            //end of the innermost open span ("E"), a non zero value (e.g. an error code) is shown with it
+    TRACE_PHASE_COMPLETE,       //span that started at the timestamp and lasted value nanoseconds ("X")
+    TRACE_PHASE_INSTANT,        //point in time, with a value ("i")
+    TRACE_PHASE_COUNTER         //value of a counter ("C")
+}TRACE_PHASE;
+
+//trace writer object representation (see trace.c)
+typedef struct trace_writer TRACE_WRITER;
+
+#ifdef SATCLIENT_TRACE
+#define TRACE_BEGIN(name) record_trace_event(TRACE_PHASE_BEGIN, (name), get_trace_time_ns(), 0)
+#define TRACE_END(name) record_trace_event(TRACE_PHASE_END, (name), get_trace_time_ns(), 0)
+#define TRACE_END_WITH_VALUE(name, value) record_trace_event(TRACE_PHASE_END, (name), get_trace_time_ns(), (int64_t)(value))
+#define TRACE_COMPLETE(name, start_time_ns) record_trace_event(TRACE_PHASE_COMPLETE, (name), (start_time_ns), get_trace_time_ns() - (start_time_ns))
+#define TRACE_INSTANT(name, value) record_trace_event(TRACE_PHASE_INSTANT, (name), get_trace_time_ns(), (int64_t)(value))
+#define TRACE_COUNTER(name, value) record_trace_event(TRACE_PHASE_COUNTER, (name), get_trace_time_ns(), (int64_t)(value))
+#define TRACE_THREAD_NAME(name) set_trace_thread_name(name)
+#else
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+#define TRACE_END_WITH_VALUE(name, value) ((void)0)
+#define TRACE_COMPLETE(name, start_time_ns) ((void)0)
+#define TRACE_INSTANT(name, value) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+//function declarations
+int64_t get_trace_time_ns(void);
+void record_trace_event(TRACE_PHASE, const char*, int64_t, int64_t);
+void set_trace_thread_name(const char*);
+uint64_t get_trace_dropped_event_count(void);
+TRACE_WRITER* new_trace_writer(const char*, uint32_t);
+void free_trace_writer(TRACE_WRITER*);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,97 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#ifndef WINDOWAGGREGATOR_H_
+#define WINDOWAGGREGATOR_H_
+
+#include <stdbool.h>            //using for "bool" type
+#include <stdint.h>             //using for "int16_t", "uint16_t", "uint32_t", and "int64_t" types
+#include "samplebatch.h"        //using for "SAMPLE_BATCH" type
+
+/*
+    Windowed aggregation of raw IMU samples, per axis (accel x,y,z, magneto x,y,z, gyro x,y,z - the order of SAMPLE_BATCH_AXIS).
+
+    Tumbling windows summarize each block of window length samples once, then start over.
+    Sliding windows summarize the latest window length samples every hop samples (once the first window has filled).
+
+    Statistics are kept on the raw int16 values, so the running sums are exact integers and a sliding window
+    never drifts however long it runs. Every sample costs O(1): sums are updated as samples enter (and leave),
+    and the min/max are kept with monotonic queues (amortized O(1)). Scale factors are applied only when a
+    summary is produced.
+*/
+#define WINDOW_AGGREGATOR_AXIS_COUNT SAMPLE_BATCH_AXIS_COUNT   //raw axes aggregated per sample
+#define WINDOW_AGGREGATOR_MAX_LENGTH 1024       //largest window length (in samples) supported
+
+//enum for the kinds of window
+typedef enum window_type
+{
+    NO_WINDOW,          //aggregation disabled
+    TUMBLING_WINDOW,
+    SLIDING_WINDOW
+}WINDOW_TYPE;
+
+//per axis window statistics (in the sensor's units - g, gauss, dps)
+typedef struct window_axis_summary
+{
+    double mean;
+    double min;
+    double max;
+    double rms;
+    double variance;        //population variance
+    double peak_to_peak;
+}WINDOW_AXIS_SUMMARY;
+
+//window summary object representation
+typedef struct window_summary
+{
+    WINDOW_TYPE type;                                       //kind of window summarized
+    uint32_t window_id;                                     //zero indexed - order of the summaries produced
+    uint32_t sample_count;                                  //number of samples summarized
+    int64_t start_timestamp_ns;                             //timestamp of the oldest sample in the window
+    int64_t end_timestamp_ns;                               //timestamp of the newest sample in the window
+    WINDOW_AXIS_SUMMARY axes[WINDOW_AGGREGATOR_AXIS_COUNT]; //statistics per axis
+}WINDOW_SUMMARY;
+
+//monotonic queue of window positions (holds the positions of the candidate min or max values, oldest first)
+typedef struct window_extreme_queue
+{
+    uint16_t positions[WINDOW_AGGREGATOR_MAX_LENGTH];
+    uint32_t head;          //index of the oldest entry
+    uint32_t count;         //number of entries
+}WINDOW_EXTREME_QUEUE;
+
+//per axis aggregation state
+typedef struct window_axis_state
+{
+    int64_t sum;                                            //sum of the values in the window
+    int64_t sum_of_squares;                                 //sum of the squared values in the window
+    int16_t min;                                            //smallest value in the window (tumbling windows)
+    int16_t max;                                            //largest value in the window (tumbling windows)
+    int16_t values[WINDOW_AGGREGATOR_MAX_LENGTH];           //values in the window, by position (sliding windows)
+    WINDOW_EXTREME_QUEUE min_queue;                         //candidate min positions (sliding windows)
+    WINDOW_EXTREME_QUEUE max_queue;                         //candidate max positions (sliding windows)
+}WINDOW_AXIS_STATE;
+
+//window aggregator object representation
+typedef struct window_aggregator
+{
+    WINDOW_TYPE type;
+    uint32_t length;                                        //samples per window
+    uint32_t hop;                                           //samples between summaries (sliding windows)
+    double scale_factors[WINDOW_AGGREGATOR_AXIS_COUNT];     //raw value * scale factor = value in the sensor's units
+    uint32_t window_id;                                     //id given to the next summary
+    uint32_t sample_count;                                  //samples currently in the window
+    uint32_t position;                                      //position the next sample is written to (sliding windows)
+    uint32_t samples_since_summary;                         //samples added since the last summary (sliding windows)
+    int64_t start_timestamp_ns;                             //timestamp of the first sample in the window (tumbling windows)
+    int64_t timestamps_ns[WINDOW_AGGREGATOR_MAX_LENGTH];    //timestamps of the samples in the window, by position (sliding windows)
+    WINDOW_AXIS_STATE axes[WINDOW_AGGREGATOR_AXIS_COUNT];
+}WINDOW_AGGREGATOR;
+
+//function declarations
+bool init_window_aggregator(WINDOW_AGGREGATOR*, WINDOW_TYPE, uint32_t, uint32_t, double, double, double);
+bool add_sample_to_window_aggregator(WINDOW_AGGREGATOR*, const SAMPLE_BATCH*, uint32_t, WINDOW_SUMMARY*, bool*);
+
+#endif /* WINDOWAGGREGATOR_H_ */
@@ -5,17 +5,33 @@
 
 #include <stdio.h>              //using for "printf" functions
 #include <stdint.h>             //using for "uint8_t" type
-#include <stdlib.h>             //using for "malloc" and "free" functions, and "NULL"
+#include <stdlib.h>             //using for "NULL"
 #include <string.h>             //using for "strlen" function
 #include "aws_iot_config.h"
 #include "aws_iot_log.h"
+#include "satmemory.h"          //using to allocate from the memory arena
 #include "iotdevicegateway.h"
+#include "metrics.h"             //using for "increment_metrics_counter" function
 
-//global vars
-static const char MQTT_PUBLISH_TOPIC[] = "YOUR_VALUE";  //mqtt topic to publish telemetry to
+//function declarations
+static bool publish_payload_to_device_gateway(IOT_DEVICE_GATEWAY*, const char*, uint32_t);
+static bool open_iot_device_gateway_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_iot_device_gateway_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_iot_device_gateway_sink(TELEMETRY_SINK*);
+static bool close_iot_device_gateway_sink(TELEMETRY_SINK*);
+
+//aws mqtt telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE IOT_DEVICE_GATEWAY_SINK_INTERFACE =
+{
+    open_iot_device_gateway_sink,
+    publish_batch_to_iot_device_gateway_sink,
+    flush_iot_device_gateway_sink,
+    close_iot_device_gateway_sink,
+    free_sat_memory
+};
 
 //function definition
-//init the iot device gateway
+//init the iot device gateway (connecting with its settings)
 bool init_iot_device_gateway(IOT_DEVICE_GATEWAY* device_gateway)
 {
     //local vars
@@ -29,11 +45,11 @@ bool init_iot_device_gateway(IOT_DEVICE_GATEWAY* device_gateway)
     {
         //set client parameters
         client_parameters.enableAutoReconnect = false;
-        client_parameters.pHostURL = AWS_IOT_MQTT_HOST;
-        client_parameters.port = AWS_IOT_MQTT_PORT;
-        client_parameters.pRootCALocation = AWS_IOT_ROOT_CA_FILENAME;
-        client_parameters.pDeviceCertLocation = AWS_IOT_CERTIFICATE_FILENAME;
-        client_parameters.pDevicePrivateKeyLocation = AWS_IOT_PRIVATE_KEY_FILENAME;
+        client_parameters.pHostURL = (char*)device_gateway->settings.host;
+        client_parameters.port = device_gateway->settings.port;
+        client_parameters.pRootCALocation = (char*)device_gateway->settings.root_ca_file;
+        client_parameters.pDeviceCertLocation = (char*)device_gateway->settings.certificate_file;
+        client_parameters.pDevicePrivateKeyLocation = (char*)device_gateway->settings.private_key_file;
         client_parameters.mqttCommandTimeout_ms = 20000;
         client_parameters.tlsHandshakeTimeout_ms = 5000;
         client_parameters.isSSLHostnameVerify = true;
@@ -50,8 +66,8 @@ bool init_iot_device_gateway(IOT_DEVICE_GATEWAY* device_gateway)
             connection_parameters.keepAliveIntervalInSec = 10;
             connection_parameters.isCleanSession = true;
             connection_parameters.MQTTVersion = MQTT_3_1_1;
-            connection_parameters.pClientID = AWS_IOT_MQTT_CLIENT_ID;
-            connection_parameters.clientIDLen = (uint16_t)strlen(AWS_IOT_MQTT_CLIENT_ID);
+            connection_parameters.pClientID = (char*)device_gateway->settings.client_id;
+            connection_parameters.clientIDLen = (uint16_t)strlen(device_gateway->settings.client_id);
             connection_parameters.isWillMsgPresent = false;
 
             //attempt to connect to the aws device gateway
@@ -60,6 +76,8 @@ bool init_iot_device_gateway(IOT_DEVICE_GATEWAY* device_gateway)
             //if we successfully connected
             if (result_code == SUCCESS)
             {
+                increment_metrics_counter(METRICS_TRANSPORT_CONNECTS, 1);
+
                 //success
                 operation_status = true;
             }
@@ -109,35 +127,115 @@ bool shutdown_iot_device_gateway(IOT_DEVICE_GATEWAY* device_gateway)
 //function definition
 //publish a telemetry reading to the aws iot device gateway
 bool publish_telemetry_to_device_gateway(IOT_DEVICE_GATEWAY* device_gateway, TELEMETRY_READING* reading)
+{
+    //check inputs
+    if ((device_gateway != NULL) && (reading != NULL))
+    {
+        return publish_payload_to_device_gateway(device_gateway, reading->json, strlen(reading->json));
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//publish a payload (a single json reading) to the aws iot device gateway
+static bool publish_payload_to_device_gateway(IOT_DEVICE_GATEWAY* device_gateway, const char* payload, uint32_t payload_size)
 {
     //local vars
     bool operation_status = false;              //denotes success or failure of the operation
     IoT_Error_t result_code = FAILURE;          //result code from iot operation
     IoT_Publish_Message_Params msg_parameters;  //parameters of the message to publish
 
-    //check inputs
-    if ((device_gateway != NULL) && (reading != NULL))
+    //set parameters
+    msg_parameters.qos = device_gateway->settings.qos;    //QOS0 is fire and forget (it may or may not get there), QOS1 waits for the gateway's acknowledgement
+    msg_parameters.payload = (void*)payload;
+    msg_parameters.isRetained = 0;
+    msg_parameters.payloadLen = payload_size;
+
+    //attempt to publish message
+    result_code = aws_iot_mqtt_publish(&(device_gateway->client_context), device_gateway->settings.topic, (uint16_t)strlen(device_gateway->settings.topic), &msg_parameters);
+
+    //if the message was successfully published
+    if (result_code == SUCCESS)
     {
-        //set parameters
-        msg_parameters.qos = QOS0;	//fire and forget - it may or may not get there
-        msg_parameters.payload = (void*)reading->json;
-        msg_parameters.isRetained = 0;
-        msg_parameters.payloadLen = strlen(reading->json);
+        increment_metrics_counter(METRICS_BYTES_SENT, payload_size);
 
-        //attempt to publish message
-        result_code = aws_iot_mqtt_publish(&(device_gateway->client_context), MQTT_PUBLISH_TOPIC, strlen(MQTT_PUBLISH_TOPIC), &msg_parameters);
+        //success
+        operation_status = true;
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: AWS IOT PUBLISH FAILED! - %d\n", result_code);
+    }
 
-        //if the message was successfully published
-        if (result_code == SUCCESS)
-        {
-            //success
-            operation_status = true;
-        }
-        else
-        {
-            fprintf(stderr, "ERROR: AWS IOT PUBLISH FAILED! - %d\n", result_code);
-        }
+    return operation_status;
+}
+
+//function definition
+//create a telemetry sink that publishes to the aws iot device gateway (mqtt) with the supplied settings
+TELEMETRY_SINK* new_iot_device_gateway_telemetry_sink(const IOT_DEVICE_GATEWAY_SETTINGS* settings)
+{
+    //local vars
+    IOT_DEVICE_GATEWAY* device_gateway;
+
+    //check input
+    if ((settings == NULL) || (settings->host == NULL) || (settings->client_id == NULL) || (settings->topic == NULL))
+    {
+        return NULL;
+    }
+
+    //allocate iot device gateway object (owned by the sink)
+    device_gateway = allocate_sat_memory(SAT_MEMORY_IOT_DEVICE_GATEWAY, sizeof (IOT_DEVICE_GATEWAY));
+
+    //if the object was successfully created
+    if (device_gateway != NULL)
+    {
+        device_gateway->settings = *settings;
+
+        return new_telemetry_sink("AWS IOT MQTT", &IOT_DEVICE_GATEWAY_SINK_INTERFACE, device_gateway);
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//connect to the aws iot device gateway
+static bool open_iot_device_gateway_sink(TELEMETRY_SINK* sink)
+{
+    return init_iot_device_gateway((IOT_DEVICE_GATEWAY*)sink->context);
+}
+
+//function definition
+//publish each reading in the batch as its own mqtt message (the message format the backend consumes is unchanged)
+static bool publish_batch_to_iot_device_gateway_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    bool operation_status = true;       //denotes success or failure of the operation
+    uint32_t offset = 0;                //position of the next line in the batch
+    const char* line;                   //current line (reading) in the batch
+    uint32_t line_size;                 //size of the current line
+
+    //publish every line, continuing past failures (a failed reading is simply lost)
+    while (get_next_telemetry_batch_line(batch, &offset, &line, &line_size))
+    {
+        operation_status &= publish_payload_to_device_gateway((IOT_DEVICE_GATEWAY*)sink->context, line, line_size);
     }
 
     return operation_status;
 }
+
+//function definition
+//publishes are written straight to the tls connection (and qos 1 ones acknowledged before they return), so there is nothing to flush
+static bool flush_iot_device_gateway_sink(TELEMETRY_SINK* sink)
+{
+    return true;
+}
+
+//function definition
+//disconnect from the aws iot device gateway
+static bool close_iot_device_gateway_sink(TELEMETRY_SINK* sink)
+{
+    return shutdown_iot_device_gateway((IOT_DEVICE_GATEWAY*)sink->context);
+}
@@ -0,0 +1,386 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "nanosleep" function
+
+#include <stdio.h>              //using for "fprintf" and "snprintf" functions
+#include <stdlib.h>             //using for "NULL"
+#include <string.h>             //using for "strlen" and "memcpy" functions
+#include <time.h>               //using for "nanosleep" function
+#include <pthread.h>            //using for the shadow thread
+#include "aws_iot_config.h"     //using for the sdk's shadow limits
+#include "aws_iot_log.h"
+#include "aws_iot_shadow_interface.h"
+#include "trace.h"              //using to name the shadow thread in the trace
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "iotdeviceshadow.h"
+
+/*
+    The shadow thread connects (retrying until it does, the sdk reconnects it from then on), then yields to the sdk
+    every YIELD_INTERVAL_MS, which is when the delta callbacks run. Each registered key's callback only copies the value's
+    text (every key is registered as an object, so the sdk neither parses the value nor writes it into the key's data,
+    which a string value longer than the key's buffer would overrun), once the yield returns the values a delta held are
+    handed to the config watcher together, to be parsed and validated like values in the config file. Whenever the
+    boards apply tunables (and on every connection) the values in effect are reported.
+*/
+#define IOT_DEVICE_SHADOW_KEY_COUNT 7
+#define IOT_DEVICE_SHADOW_YIELD_INTERVAL_MS 200         //longest wait for an incoming message (so the longest a free waits for the thread)
+#define IOT_DEVICE_SHADOW_RETRY_INTERVAL_MS 10000       //milliseconds between connection attempts
+#define IOT_DEVICE_SHADOW_UPDATE_TIMEOUT_S 10           //seconds the service has to accept a report
+#define IOT_DEVICE_SHADOW_CLIENT_ID_SUFFIX "-shadow"
+
+//delta value representation
+typedef struct iot_device_shadow_delta_value
+{
+    char text[SAT_CONFIG_MAX_VALUE_SIZE];   //value as it appeared in the latest delta (without its quotes, for a string)
+    bool is_received;                       //set when a delta holds the key, cleared once handed to the config watcher
+    bool is_too_long;                       //set when the value didn't fit (the delta holding it is rejected)
+}IOT_DEVICE_SHADOW_DELTA_VALUE;
+
+//iot device shadow state representation
+struct iot_device_shadow
+{
+    pthread_t worker;                       //thread servicing the shadow
+    AWS_IoT_Client client_context;          //aws iot client handle (only touched by the worker)
+    IOT_DEVICE_GATEWAY_SETTINGS settings;   //connection settings
+    char client_id[MAX_SIZE_OF_UNIQUE_CLIENT_ID_BYTES];
+    char thing_name[MAX_SIZE_OF_THING_NAME];
+    SAT_CONFIG_WATCHER* watcher;
+    jsonStruct_t delta_keys[IOT_DEVICE_SHADOW_KEY_COUNT];
+    IOT_DEVICE_SHADOW_DELTA_VALUE delta_values[IOT_DEVICE_SHADOW_KEY_COUNT];
+    SAT_TUNABLES applied;                   //tunables in effect (as last handed back by a board)
+    uint32_t applied_generation;            //generation of the applied tunables last taken from the watcher
+    bool is_report_pending;                 //denotes the tunables in effect haven't been reported (or the report failed)
+    bool is_stopping;                       //set (atomically) when the shadow is being freed
+};
+
+//global vars
+static const char* const DELTA_KEYS[IOT_DEVICE_SHADOW_KEY_COUNT] = {"batch_size", "flush_latency_ms", "heartbeat_interval", "gyro_odr", "accel_odr", "magneto_odr", "filters"};
+
+//function declarations
+static void* run_iot_device_shadow_worker(void*);
+static bool connect_iot_device_shadow(IOT_DEVICE_SHADOW*);
+static void receive_iot_device_shadow_delta_value(const char*, uint32_t, jsonStruct_t*);
+static void update_tunables_from_iot_device_shadow_delta(IOT_DEVICE_SHADOW*);
+static void report_iot_device_shadow_tunables(IOT_DEVICE_SHADOW*);
+static void check_iot_device_shadow_report(const char*, ShadowActions_t, Shadow_Ack_Status_t, const char*, void*);
+static void wait_for_iot_device_shadow(IOT_DEVICE_SHADOW*, uint32_t);
+
+//function definition
+//create a device shadow, taking the tunables from the supplied thing's shadow deltas (connecting with the supplied settings)
+//and reporting the ones in effect, returns NULL on failure
+IOT_DEVICE_SHADOW* new_iot_device_shadow(const IOT_DEVICE_GATEWAY_SETTINGS* settings, const char* thing_name, SAT_CONFIG_WATCHER* watcher)
+{
+    //local vars
+    IOT_DEVICE_SHADOW* shadow;
+    int client_id_size;
+    uint32_t i;
+
+    //check inputs
+    if ((settings == NULL) || (settings->host == NULL) || (settings->client_id == NULL) || (thing_name == NULL) || (watcher == NULL))
+    {
+        return NULL;
+    }
+    if (strlen(thing_name) >= MAX_SIZE_OF_THING_NAME)
+    {
+        fprintf(stderr, "ERROR: AWS IOT THING NAME IS LONGER THAN %d CHARACTERS: %s!\n", MAX_SIZE_OF_THING_NAME - 1, thing_name);
+        return NULL;
+    }
+
+    //allocate iot device shadow object
+    shadow = allocate_sat_memory(SAT_MEMORY_IOT_DEVICE_SHADOW, sizeof (IOT_DEVICE_SHADOW));
+
+    //if the object was successfully created
+    if (shadow != NULL)
+    {
+        shadow->settings = *settings;
+        shadow->watcher = watcher;
+        shadow->applied_generation = UINT32_MAX;      //none taken yet, so the first get takes the watcher's (the configured tunables until a board applies its own)
+        shadow->is_report_pending = false;
+        shadow->is_stopping = false;
+        snprintf(shadow->thing_name, sizeof (shadow->thing_name), "%s", thing_name);
+        client_id_size = snprintf(shadow->client_id, sizeof (shadow->client_id), "%s%s", settings->client_id, IOT_DEVICE_SHADOW_CLIENT_ID_SUFFIX);
+        shadow->settings.client_id = shadow->client_id;
+
+        //every key is registered as an object, so the sdk leaves the value to the callback (which gets its text as it appeared)
+        for (i = 0; i < IOT_DEVICE_SHADOW_KEY_COUNT; i++)
+        {
+            shadow->delta_values[i].is_received = false;
+            shadow->delta_values[i].is_too_long = false;
+            shadow->delta_keys[i].pKey = DELTA_KEYS[i];
+            shadow->delta_keys[i].pData = &(shadow->delta_values[i]);
+            shadow->delta_keys[i].type = SHADOW_JSON_OBJECT;
+            shadow->delta_keys[i].cb = receive_iot_device_shadow_delta_value;
+        }
+
+        if ((client_id_size > 0) && ((size_t)client_id_size < sizeof (shadow->client_id)) && (pthread_create(&(shadow->worker), NULL, run_iot_device_shadow_worker, shadow) == 0))
+        {
+            return shadow;
+        }
+
+        fprintf(stderr, "ERROR: FAILED TO START AWS IOT SHADOW THREAD!\n");
+        free_sat_memory(shadow);
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//stop the device shadow (disconnecting it) and deallocate it
+void free_iot_device_shadow(IOT_DEVICE_SHADOW* shadow)
+{
+    //check input
+    if (shadow != NULL)
+    {
+        __atomic_store_n(&(shadow->is_stopping), true, __ATOMIC_RELEASE);
+        pthread_join(shadow->worker, NULL);
+        free_sat_memory(shadow);
+    }
+}
+
+//function definition
+//shadow thread, connects then hands on deltas and reports the tunables in effect until the shadow is stopping
+static void* run_iot_device_shadow_worker(void* parameter)
+{
+    //local vars
+    IOT_DEVICE_SHADOW* shadow = (IOT_DEVICE_SHADOW*)parameter;
+    IoT_Error_t result_code;            //result code from iot operation
+    bool is_connected = false;
+
+    TRACE_THREAD_NAME("aws iot shadow");
+    while (!__atomic_load_n(&(shadow->is_stopping), __ATOMIC_ACQUIRE))
+    {
+        //connect (reporting what is in effect as soon as it does)
+        if (!is_connected)
+        {
+            is_connected = connect_iot_device_shadow(shadow);
+            if (!is_connected)
+            {
+                wait_for_iot_device_shadow(shadow, IOT_DEVICE_SHADOW_RETRY_INTERVAL_MS);
+                continue;
+            }
+            shadow->is_report_pending = true;
+        }
+
+        //run the delta (and report) callbacks, the sdk reconnects a lost connection from in here
+        result_code = aws_iot_shadow_yield(&(shadow->client_context), IOT_DEVICE_SHADOW_YIELD_INTERVAL_MS);
+        if (result_code == NETWORK_RECONNECTED)
+        {
+            shadow->is_report_pending = true;
+        }
+        else if (result_code < SUCCESS)
+        {
+            //don't spin while the connection is down
+            wait_for_iot_device_shadow(shadow, IOT_DEVICE_SHADOW_YIELD_INTERVAL_MS);
+            continue;
+        }
+
+        update_tunables_from_iot_device_shadow_delta(shadow);
+
+        //report once the boards have applied new tunables (or a report is owed)
+        if (get_sat_config_applied_tunables(shadow->watcher, &(shadow->applied_generation), &(shadow->applied)))
+        {
+            shadow->is_report_pending = true;
+        }
+        if (shadow->is_report_pending)
+        {
+            report_iot_device_shadow_tunables(shadow);
+        }
+    }
+
+    if (is_connected)
+    {
+        aws_iot_shadow_disconnect(&(shadow->client_context));
+    }
+
+    return NULL;
+}
+
+//function definition
+//connect to the thing's shadow and listen for deltas to every tunable
+static bool connect_iot_device_shadow(IOT_DEVICE_SHADOW* shadow)
+{
+    //local vars
+    static bool is_initialized = false;     //the sdk's shadow state is global (initialized, and the deltas registered, once)
+    static bool is_registered = false;
+    IoT_Error_t result_code = SUCCESS;      //result code from iot operation
+    ShadowInitParameters_t init_parameters = ShadowInitParametersDefault;
+    ShadowConnectParameters_t connection_parameters = ShadowConnectParametersDefault;
+    uint32_t i;
+
+    if (!is_initialized)
+    {
+        init_parameters.pHost = (char*)shadow->settings.host;
+        init_parameters.port = shadow->settings.port;
+        init_parameters.pRootCA = (char*)shadow->settings.root_ca_file;
+        init_parameters.pClientCRT = (char*)shadow->settings.certificate_file;
+        init_parameters.pClientKey = (char*)shadow->settings.private_key_file;
+        init_parameters.enableAutoReconnect = false;        //enabled once connected (the sdk only reconnects an established connection)
+        init_parameters.disconnectHandler = NULL;
+
+        result_code = aws_iot_shadow_init(&(shadow->client_context), &init_parameters);
+        if (result_code != SUCCESS)
+        {
+            fprintf(stderr, "ERROR: AWS IOT SHADOW INIT FAILED! - %d\n", result_code);
+            return false;
+        }
+        is_initialized = true;
+    }
+
+    connection_parameters.pMyThingName = shadow->thing_name;
+    connection_parameters.pMqttClientId = shadow->client_id;
+    connection_parameters.mqttClientIdLen = (uint16_t)strlen(shadow->client_id);
+    connection_parameters.deleteActionHandler = NULL;
+
+    result_code = aws_iot_shadow_connect(&(shadow->client_context), &connection_parameters);
+    if (result_code != SUCCESS)
+    {
+        fprintf(stderr, "ERROR: AWS IOT SHADOW CONNECT FAILED! - %d - CONNECTING TO: %s:%d\n", result_code, shadow->settings.host, shadow->settings.port);
+        return false;
+    }
+
+    //listen for deltas to every tunable (the registrations are kept across reconnects), ignoring any older than the latest one received
+    if (!is_registered)
+    {
+        for (i = 0; (i < IOT_DEVICE_SHADOW_KEY_COUNT) && (result_code == SUCCESS); i++)
+        {
+            result_code = aws_iot_shadow_register_delta(&(shadow->client_context), &(shadow->delta_keys[i]));
+        }
+        if (result_code != SUCCESS)
+        {
+            fprintf(stderr, "ERROR: AWS IOT SHADOW DELTA REGISTRATION FAILED! - %d\n", result_code);
+            aws_iot_shadow_disconnect(&(shadow->client_context));
+            return false;
+        }
+        is_registered = true;
+    }
+    aws_iot_shadow_enable_discard_old_delta_msgs();
+    aws_iot_shadow_set_autoreconnect_status(&(shadow->client_context), true);
+
+    return true;
+}
+
+//function definition
+//delta callback (run from the yield), copy the key's value text for the worker to hand on once the whole delta has been seen
+static void receive_iot_device_shadow_delta_value(const char* value, uint32_t value_length, jsonStruct_t* key)
+{
+    //local vars
+    IOT_DEVICE_SHADOW_DELTA_VALUE* delta_value = (IOT_DEVICE_SHADOW_DELTA_VALUE*)key->pData;
+
+    delta_value->is_received = true;
+    delta_value->is_too_long = (value_length >= sizeof (delta_value->text));
+    if (!delta_value->is_too_long)
+    {
+        memcpy(delta_value->text, value, value_length);
+        delta_value->text[value_length] = '\0';
+    }
+}
+
+//function definition
+//hand the values of the latest delta to the config watcher as a single update (a rejected update is reported over, so the delta persists)
+static void update_tunables_from_iot_device_shadow_delta(IOT_DEVICE_SHADOW* shadow)
+{
+    //local vars
+    const char* keys[IOT_DEVICE_SHADOW_KEY_COUNT];
+    const char* values[IOT_DEVICE_SHADOW_KEY_COUNT];
+    uint32_t value_count = 0;
+    bool is_too_long = false;
+    uint32_t i;
+
+    for (i = 0; i < IOT_DEVICE_SHADOW_KEY_COUNT; i++)
+    {
+        if (shadow->delta_values[i].is_received)
+        {
+            keys[value_count] = DELTA_KEYS[i];
+            values[value_count] = shadow->delta_values[i].text;
+            value_count++;
+            is_too_long = (is_too_long || shadow->delta_values[i].is_too_long);
+            shadow->delta_values[i].is_received = false;
+        }
+    }
+
+    if (value_count > 0)
+    {
+        if (is_too_long)
+        {
+            fprintf(stderr, "ERROR: AWS IOT SHADOW DELTA HOLDS A VALUE LONGER THAN %d CHARACTERS, KEEPING THE CURRENT TUNABLES!\n", SAT_CONFIG_MAX_VALUE_SIZE - 1);
+            shadow->is_report_pending = true;
+        }
+        else if (!update_sat_config_tunables(shadow->watcher, keys, values, value_count))
+        {
+            shadow->is_report_pending = true;
+        }
+    }
+}
+
+//function definition
+//report the tunables in effect as the shadow's reported state (the report callback asks for another if the service doesn't accept it)
+static void report_iot_device_shadow_tunables(IOT_DEVICE_SHADOW* shadow)
+{
+    //local vars
+    IoT_Error_t result_code;                    //result code from iot operation
+    char document[AWS_IOT_MQTT_TX_BUF_LEN];
+    jsonStruct_t reported[IOT_DEVICE_SHADOW_KEY_COUNT];
+    void* reported_values[IOT_DEVICE_SHADOW_KEY_COUNT] = {&(shadow->applied.batch_size), &(shadow->applied.flush_latency_ms), &(shadow->applied.heartbeat_interval), &(shadow->applied.gyro_odr), &(shadow->applied.accel_odr), &(shadow->applied.magneto_odr), shadow->applied.filters};
+    const JsonPrimitiveType reported_types[IOT_DEVICE_SHADOW_KEY_COUNT] = {SHADOW_JSON_UINT32, SHADOW_JSON_UINT32, SHADOW_JSON_UINT32, SHADOW_JSON_DOUBLE, SHADOW_JSON_DOUBLE, SHADOW_JSON_DOUBLE, SHADOW_JSON_STRING};
+    uint32_t i;
+
+    for (i = 0; i < IOT_DEVICE_SHADOW_KEY_COUNT; i++)
+    {
+        reported[i].pKey = DELTA_KEYS[i];
+        reported[i].pData = reported_values[i];
+        reported[i].type = reported_types[i];
+        reported[i].cb = NULL;
+    }
+
+    result_code = aws_iot_shadow_init_json_document(document, sizeof (document));
+    if (result_code == SUCCESS)
+    {
+        result_code = aws_iot_shadow_add_reported(document, sizeof (document), IOT_DEVICE_SHADOW_KEY_COUNT, &(reported[0]), &(reported[1]), &(reported[2]), &(reported[3]), &(reported[4]), &(reported[5]), &(reported[6]));
+    }
+    if (result_code == SUCCESS)
+    {
+        result_code = aws_iot_finalize_json_document(document, sizeof (document));
+    }
+    if (result_code == SUCCESS)
+    {
+        result_code = aws_iot_shadow_update(&(shadow->client_context), shadow->thing_name, document, check_iot_device_shadow_report, shadow, IOT_DEVICE_SHADOW_UPDATE_TIMEOUT_S, true);
+    }
+
+    //a report that couldn't be sent is retried on the next pass
+    shadow->is_report_pending = (result_code != SUCCESS);
+}
+
+//function definition
+//report callback (run from the yield), ask for another report if the service rejected this one or didn't answer
+static void check_iot_device_shadow_report(const char* thing_name, ShadowActions_t action, Shadow_Ack_Status_t status, const char* document, void* context)
+{
+    //local vars
+    IOT_DEVICE_SHADOW* shadow = (IOT_DEVICE_SHADOW*)context;
+
+    (void)thing_name;
+    (void)action;
+    (void)document;
+    if (status != SHADOW_ACK_ACCEPTED)
+    {
+        fprintf(stderr, "WARNING: AWS IOT SHADOW REPORT %s, RETRYING!\n", (status == SHADOW_ACK_REJECTED) ? "REJECTED" : "TIMED OUT");
+        shadow->is_report_pending = true;
+    }
+}
+
+//function definition
+//sleep for up to the supplied number of milliseconds, waking early if the shadow is stopping
+static void wait_for_iot_device_shadow(IOT_DEVICE_SHADOW* shadow, uint32_t wait_ms)
+{
+    //local vars
+    struct timespec step = {0, IOT_DEVICE_SHADOW_YIELD_INTERVAL_MS * 1000000L};
+    uint32_t waited_ms;
+
+    for (waited_ms = 0; (waited_ms < wait_ms) && (!__atomic_load_n(&(shadow->is_stopping), __ATOMIC_ACQUIRE)); waited_ms += IOT_DEVICE_SHADOW_YIELD_INTERVAL_MS)
+    {
+        nanosleep(&step, NULL);
+    }
+}
@@ -6,13 +6,15 @@
 #define _GNU_SOURCE             //enable GNU extensions in stdio.h so we can use "asprintf" function
 
 #include <stdio.h>              //using for "asprintf" function
-#include <stdlib.h>             //using for "free" function and "NULL"
+#include <stdlib.h>             //using for "free" function (the asprintf buffers) and "NULL"
 #include <stdint.h>             //using for "uint8_t" and "uint32_t" types
 #include <stdbool.h>            //using for "bool" type
 #include <string.h>             //using for "strlen" function
 #include <time.h>               //using for "time" function
 #include <curl/curl.h>          //using for cURL web library
 #include "cryptoutil.h"         //using for crypto functions
+#include "keyprovisioner.h"     //using for non-interactive secret key provisioning
+#include "satmemory.h"          //using to free the buffers the crypto functions allocate
 #include "authutil.h"
 
 //global vars
@@ -166,17 +168,17 @@ char* create_shared_access_token(const char* endpoint, const char* shared_access
                                                 }
 
                                                 //free buffer
-                                                free(base64_encoded_hmac);
+                                                free_sat_memory(base64_encoded_hmac);
                                             }
                                         }
 
                                         //free buffer
-                                        free(hmac);
+                                        free_sat_memory(hmac);
                                     }
                                 }
 
                                 //free buffer
-                                free(shared_access_policy_secret_key);
+                                free_sat_memory(shared_access_policy_secret_key);
                             }
                         }
                         else
@@ -186,7 +188,7 @@ char* create_shared_access_token(const char* endpoint, const char* shared_access
                     }
 
                     //free buffer
-                    free(base64_encoded_shared_access_policy_secret_key);
+                    free_sat_memory(base64_encoded_shared_access_policy_secret_key);
                     free(message);
                 }
             }
@@ -208,43 +210,39 @@ static bool load_base64_encoded_secret_key(char** base64_encoded_secret_key)
 {
     //local vars
     bool operation_status = false;          //denotes success or failure of the operation
-    char* base64_encoded_openssl_payload;   //handle to base64 encoded openssl payload (i.e., salt header + ciphertext)
+    KEY_PROVISIONING_CONFIG config;         //where the payload and passphrase come from (environment/fd/keyring, falling back to prompts)
     uint8_t* plaintext = NULL;              //handle to decrypted data from file
     uint32_t plaintext_size;                //size (in bytes) of decrypted data from file
 
     //check input
     if (base64_encoded_secret_key != NULL)
     {
-        //if the base64 encoded openssl payload (salt header + ciphertext) was successfully loaded
-        if (load_base64_encoded_openssl_payload(&base64_encoded_openssl_payload))
+        //resolve the provisioning sources
+        load_key_provisioning_config_from_environment(&config);
+
+        //if the base64 encoded openssl payload (salt header + ciphertext) was successfully loaded and decrypted
+        if (provision_secret_key(&config, &plaintext, &plaintext_size, NULL))
         {
-            //double check if the base64 encoded openssl payload was successfully assigned
-            if (base64_encoded_openssl_payload != NULL)
+            //double check if the plaintext was successfully assigned
+            if ((plaintext != NULL) && (plaintext_size > 0))
             {
-                //if the base64 encoded openssl payload was successfully decrypted
-                if (decrypt_base64_encoded_openssl_payload(base64_encoded_openssl_payload, &plaintext, &plaintext_size))
+                //convert the plaintext byte array into a string (since its a base64 encoded secret key)
+                *base64_encoded_secret_key = compute_text_string(plaintext, plaintext_size);
+
+                //if the buffer was created successfully
+                if (*base64_encoded_secret_key != NULL)
                 {
-                    //double check if the plaintext was successfully assigned
-                    if ((plaintext != NULL) && (plaintext_size > 0))
+                    //if the string length matches the size of the byte array is was constructed from
+                    if (strlen(*base64_encoded_secret_key) == plaintext_size)
                     {
-                        //convert the plaintext byte array into a string (since its a base64 encoded secret key)
-                        *base64_encoded_secret_key = compute_text_string(plaintext, plaintext_size);
-
-                        //if the buffer was created successfully
-                        if (*base64_encoded_secret_key != NULL)
-                        {
-                            //if the string length matches the size of the byte array is was constructed from
-                            if (strlen(*base64_encoded_secret_key) == plaintext_size)
-                            {
-                                //success
-                                operation_status = true;
-                            }
-                        }
-
-                        //free buffer
-                        free(plaintext);
+                        //success
+                        operation_status = true;
                     }
                 }
+
+                //immediately zero-out and free buffer
+                memset(plaintext, 0, plaintext_size);
+                free_sat_memory(plaintext);
             }
         }
     }
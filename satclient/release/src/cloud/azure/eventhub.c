@@ -5,10 +5,12 @@
 
 #include <stdio.h>              //using for "printf" functions
 #include <stdint.h>             //using for "uint8_t" type
-#include <stdlib.h>             //using for "malloc" and "free" functions, and "NULL"
-#include <string.h>             //using for "strlen" function
+#include <stdlib.h>             //using for "free" function (the endpoint and token), and "NULL"
+#include <string.h>             //using for "strlen" and "memcpy" functions
 #include "authutil.h"           //using for azure service bus authentication/authorization functions
+#include "satmemory.h"          //using to allocate from the memory arena
 #include "eventhub.h"
+#include "metrics.h"             //using for "increment_metrics_counter" function
 
 //global vars
 static const char EVENT_HUB_NODE_NAME[] = "YOUR_VALUE";             //azure service bus event hub entity/node name
@@ -16,6 +18,21 @@ static const char SHARED_ACCESS_POLICY_NAME[] = "YOUR_VALUE";       //shared acc
 
 //function declarations
 static bool init_event_hub(EVENT_HUB*);
+static bool open_event_hub_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_event_hub_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_event_hub_sink(TELEMETRY_SINK*);
+static bool close_event_hub_sink(TELEMETRY_SINK*);
+static void free_event_hub_sink_context(void*);
+
+//azure amqp telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE EVENT_HUB_SINK_INTERFACE =
+{
+    open_event_hub_sink,
+    publish_batch_to_event_hub_sink,
+    flush_event_hub_sink,
+    close_event_hub_sink,
+    free_event_hub_sink_context
+};
 
 //function definition
 //create event hub object
@@ -25,7 +42,7 @@ EVENT_HUB* new_event_hub(void)
     EVENT_HUB* ehub;
 
     //allocate event hub object
-    ehub = malloc(sizeof (EVENT_HUB));
+    ehub = allocate_sat_memory(SAT_MEMORY_EVENT_HUB, sizeof (EVENT_HUB));
 
     //if the object was successfully created
     if (ehub != NULL)
@@ -38,7 +55,7 @@ EVENT_HUB* new_event_hub(void)
         }
 
         //deallocate event hub
-        free(ehub);
+        free_sat_memory(ehub);
     }
 
     //failure
@@ -72,6 +89,8 @@ static bool init_event_hub(EVENT_HUB* ehub)
                 //by the special claims-based security ($cbs) service bus node
                 if (authenticate_claim(ehub->mclient, ehub->shared_access_token))
                 {
+                    increment_metrics_counter(METRICS_TRANSPORT_CONNECTS, 1);
+
                     //success
                     return true;
                 }
@@ -101,7 +120,7 @@ void free_event_hub(EVENT_HUB* ehub)
         free(ehub->event_hub_endpoint);
         free(ehub->shared_access_token);
         //deallocate event hub object
-        free(ehub);
+        free_sat_memory(ehub);
     }
 }
 
@@ -112,5 +131,113 @@ bool publish_telemetry_to_event_hub(EVENT_HUB* ehub, TELEMETRY_READING* reading)
     //check inputs
 
     //publish the message
-    return publish_message(ehub->mclient, ehub->event_hub_endpoint, reading->json);
+    if (publish_message(ehub->mclient, ehub->event_hub_endpoint, reading->json))
+    {
+        increment_metrics_counter(METRICS_BYTES_SENT, strlen(reading->json));
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//create a telemetry sink that publishes to an azure event hub (amqp)
+//the event hub itself is created when the sink is opened, as that is when authentication takes place
+TELEMETRY_SINK* new_event_hub_telemetry_sink(void)
+{
+    //local vars
+    EVENT_HUB** ehub_handle;
+
+    //allocate a holder for the event hub handle (owned by the sink)
+    ehub_handle = allocate_sat_memory(SAT_MEMORY_EVENT_HUB, sizeof (EVENT_HUB*));
+
+    //if the object was successfully created
+    if (ehub_handle != NULL)
+    {
+        *ehub_handle = NULL;
+
+        return new_telemetry_sink("AZURE EVENT HUB AMQP", &EVENT_HUB_SINK_INTERFACE, ehub_handle);
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//create (authenticate) the event hub
+static bool open_event_hub_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    EVENT_HUB** ehub_handle = (EVENT_HUB**)sink->context;
+
+    *ehub_handle = new_event_hub();
+
+    return (*ehub_handle != NULL);
+}
+
+//function definition
+//publish each reading in the batch as its own amqp message (the message format the backend consumes is unchanged)
+static bool publish_batch_to_event_hub_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    bool operation_status = true;       //denotes success or failure of the operation
+    uint32_t offset = 0;                //position of the next line in the batch
+    const char* line;                   //current line (reading) in the batch
+    uint32_t line_size;                 //size of the current line
+    TELEMETRY_READING reading;          //null terminated copy of the current line (the messaging client expects a string)
+
+    //publish every line, continuing past failures
+    while (get_next_telemetry_batch_line(batch, &offset, &line, &line_size))
+    {
+        //lines were encoded from telemetry readings, so they always fit
+        if (line_size < sizeof (reading.json))
+        {
+            memcpy(reading.json, line, line_size);
+            reading.json[line_size] = '\0';
+
+            operation_status &= publish_telemetry_to_event_hub(*((EVENT_HUB**)sink->context), &reading);
+        }
+        else
+        {
+            operation_status = false;
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//each publish already sends the message, so there is nothing to flush
+static bool flush_event_hub_sink(TELEMETRY_SINK* sink)
+{
+    return true;
+}
+
+//function definition
+//deallocate the event hub (disconnects the messaging client)
+static bool close_event_hub_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    EVENT_HUB** ehub_handle = (EVENT_HUB**)sink->context;
+
+    free_event_hub(*ehub_handle);
+    *ehub_handle = NULL;
+
+    return true;
+}
+
+//function definition
+//deallocate the event hub handle holder
+static void free_event_hub_sink_context(void* context)
+{
+    //check input
+    if (context != NULL)
+    {
+        //deallocate the event hub if the sink was never closed
+        free_event_hub(*((EVENT_HUB**)context));
+        free_sat_memory(context);
+    }
 }
@@ -0,0 +1,714 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _GNU_SOURCE             //enable GNU extensions in pthread.h and sched.h so we can use the "pthread_setaffinity_np" function and "CPU_..." macros
+
+#include <stdio.h>              //using for "fopen", "fgets", "fprintf", and "snprintf" functions
+#include <stdlib.h>             //using for "getenv", "strtoul", and "strtod" functions
+#include <string.h>             //using for "strcmp", "strncmp", "strchr", "strcspn", "strlen", "memcmp", "memcpy", and "memset" functions
+#include <stddef.h>             //using for "offsetof" macro
+#include <ctype.h>              //using for "isspace", "isalnum", and "toupper" functions
+#include <math.h>               //using for "isfinite" macro
+#include <signal.h>             //using for "sigwait" and "pthread_sigmask" functions
+#include <sched.h>              //using for "cpu_set_t" type
+#include <pthread.h>            //using for the config watcher thread
+#include "aws_iot_config.h"     //using for the aws iot connection defaults
+#include "telemetrysink.h"      //using for "TELEMETRY_BATCH_MAX_READINGS" macro
+#include "fanoutsink.h"         //using for "FANOUT_MAX_QUEUE_DEPTH" and "FANOUT_DEFAULT_QUEUE_DEPTH" macros
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "satconfig.h"
+
+/*
+    Every setting is described by a row of the table below: its key, the type and range of its value, where it lives in
+    the SAT_CONFIG, its default (parsed just like a value in the file, so the defaults are validated too), and if it is a
+    tunable. Loading starts from the defaults, applies the file line by line, then the environment. The sensors default to
+    the board's power on configuration (see get_default_lsm9ds0_config).
+
+    The config watcher blocks SIGHUP in the thread that creates it (so every thread started after it, leaving it to be
+    taken by the watcher's thread with sigwait), the reload runs on the watcher's thread rather than in a signal handler.
+    The tunables it publishes (reloaded, or updated remotely) are guarded by a lock and stamped with a generation, so a
+    board only takes the lock (at a batch boundary) when the generation has moved on since it last looked. An update
+    replaces every tunable it names or none of them. The tunables the boards applied are handed back the same way.
+*/
+#define SAT_CONFIG_TEXT(value) #value
+#define SAT_CONFIG_STRINGIFY(value) SAT_CONFIG_TEXT(value)
+#define SAT_CONFIG_MAX_LINE_SIZE (SAT_CONFIG_MAX_VALUE_SIZE + 64)   //longest line (a key, then a value)
+#define SAT_CONFIG_MAX_CPUS 64                                      //cpus a cpu mask can name
+#define SAT_CONFIG_ENV_PREFIX "SATCLIENT_"                           //prefix of the environment variable overriding a setting
+
+//kinds of setting value
+typedef enum sat_config_value_type
+{
+    SAT_CONFIG_STRING,          //text (char[SAT_CONFIG_MAX_VALUE_SIZE]), optionally one of a set of choices
+    SAT_CONFIG_NAME,            //text made up of letters, digits, "_", "-", and "." (safe to write into json unescaped)
+    SAT_CONFIG_UINT,            //whole number (uint32_t)
+    SAT_CONFIG_REAL,            //number (double)
+    SAT_CONFIG_FLAG,            //"0" or "1" (bool)
+    SAT_CONFIG_CPUS             //comma separated list of cpu numbers (uint64_t, a bit per cpu)
+}SAT_CONFIG_VALUE_TYPE;
+
+//setting description representation
+typedef struct sat_config_setting
+{
+    const char* key;
+    SAT_CONFIG_VALUE_TYPE type;
+    size_t offset;                  //position of the value in the SAT_CONFIG
+    double minimum;                 //range of a number
+    double maximum;
+    const char* choices;            //values a string may take, separated by "|" (NULL for any)
+    const char* default_value;      //parsed like a value in the file
+    bool is_tunable;                //denotes the setting is taken on by a running process when the file is reloaded
+}SAT_CONFIG_SETTING;
+
+//config watcher state representation
+struct sat_config_watcher
+{
+    pthread_t worker;                       //thread waiting for SIGHUP
+    char file_location[SAT_CONFIG_MAX_VALUE_SIZE];  //file reloaded (empty when the process started without one)
+    SAT_CONFIG config;                      //configuration the process started with (read only)
+    pthread_mutex_t lock;                   //guards the tunables and the applied tunables
+    SAT_TUNABLES tunables;                  //latest tunables
+    uint32_t generation;                    //incremented (atomically, under the lock) whenever the tunables are replaced
+    SAT_TUNABLES applied;                   //tunables a board applied last (the values in effect)
+    uint32_t applied_generation;            //incremented (atomically, under the lock) whenever a board applies tunables
+    bool is_stopping;                       //set (atomically) when the watcher is being freed
+};
+
+//global vars
+static const SAT_CONFIG_SETTING SETTINGS[] =
+{
+    {"device_id", SAT_CONFIG_NAME, offsetof(SAT_CONFIG, device_id), 0, 0, NULL, "edison_alva1", false},
+    {"processing_limit", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, processing_limit), 1, INT32_MAX, NULL, "3000", false},
+    {"sinks", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, sinks), 0, 0, NULL, "aws", false},
+    {"sink_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, sink_file), 0, 0, NULL, "/home/root/satclient_telemetry.ndjson", false},
+    {"columnar_sink_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, columnar_sink_file), 0, 0, NULL, "/home/root/satclient_telemetry.col", false},
+    {"queue_depth", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, queue_depth), 1, FANOUT_MAX_QUEUE_DEPTH, NULL, SAT_CONFIG_STRINGIFY(FANOUT_DEFAULT_QUEUE_DEPTH), false},
+    {"aws_host", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_host), 0, 0, NULL, AWS_IOT_MQTT_HOST, false},
+    {"aws_port", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, aws_port), 1, UINT16_MAX, NULL, SAT_CONFIG_STRINGIFY(AWS_IOT_MQTT_PORT), false},
+    {"aws_client_id", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_client_id), 0, 0, NULL, AWS_IOT_MQTT_CLIENT_ID, false},
+    {"aws_thing_name", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_thing_name), 0, 0, NULL, AWS_IOT_MY_THING_NAME, false},
+    {"aws_root_ca_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_root_ca_file), 0, 0, NULL, AWS_IOT_ROOT_CA_FILENAME, false},
+    {"aws_certificate_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_certificate_file), 0, 0, NULL, AWS_IOT_CERTIFICATE_FILENAME, false},
+    {"aws_private_key_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_private_key_file), 0, 0, NULL, AWS_IOT_PRIVATE_KEY_FILENAME, false},
+    {"aws_topic", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, aws_topic), 0, 0, NULL, "YOUR_VALUE", false},
+    {"aws_qos", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, aws_qos), 0, 1, NULL, "0", false},
+    {"devices", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, devices), 0, 0, NULL, "", false},
+    {"gyro_odr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, tunables.gyro_odr), 0, 10000, NULL, "95", true},
+    {"gyro_bandwidth", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, gyro_bandwidth), 0, 10000, NULL, "12.5", false},
+    {"gyro_fsr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, gyro_fsr), 0, 10000, NULL, "245", false},
+    {"accel_odr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, tunables.accel_odr), 0, 10000, NULL, "100", true},
+    {"accel_bandwidth", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, accel_bandwidth), 0, 10000, NULL, "773", false},
+    {"accel_fsr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, accel_fsr), 0, 10000, NULL, "2", false},
+    {"magneto_odr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, tunables.magneto_odr), 0, 10000, NULL, "100", true},
+    {"magneto_fsr", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, magneto_fsr), 0, 10000, NULL, "2", false},
+    {"filters", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, tunables.filters), 0, 0, NULL, "", true},
+    {"window", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, window), 0, 0, "none|tumbling|sliding", "none", false},
+    {"window_length", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, window_length), 1, UINT32_MAX, NULL, "300", false},
+    {"window_hop", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, window_hop), 1, UINT32_MAX, NULL, "100", false},
+    {"orientation_interval", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, orientation_interval), 0, UINT32_MAX, NULL, "0", false},
+    {"spectrum_length", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, spectrum_length), 0, UINT32_MAX, NULL, "0", false},
+    {"spectrum_hop", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, spectrum_hop), 0, UINT32_MAX, NULL, "0", false},
+    {"publish_readings", SAT_CONFIG_FLAG, offsetof(SAT_CONFIG, publish_readings), 0, 0, NULL, "0", false},
+    {"report_by_exception", SAT_CONFIG_FLAG, offsetof(SAT_CONFIG, report_by_exception), 0, 0, NULL, "0", false},
+    {"event_accel_threshold", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, event_accel_threshold), 0, 16, NULL, "0.25", false},
+    {"event_gyro_threshold", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, event_gyro_threshold), 0, 2000, NULL, "30", false},
+    {"event_accel_delta", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, event_accel_delta), 0, 16, NULL, "0.1", false},
+    {"event_gyro_delta", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, event_gyro_delta), 0, 2000, NULL, "10", false},
+    {"event_zscore", SAT_CONFIG_REAL, offsetof(SAT_CONFIG, event_zscore), 0, 1000, NULL, "6", false},
+    {"event_hold", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, event_hold), 1, UINT32_MAX, NULL, "200", false},
+    {"event_pre_trigger", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, event_pre_trigger), 0, UINT32_MAX, NULL, "100", false},
+    {"calibration_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, calibration_file), 0, 0, NULL, "/home/root/satclient_calibration.txt", false},
+    {"calibrate", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, calibrate), 0, 0, "none|gyro|magneto|all", "none", false},
+    {"metrics_port", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, metrics_port), 0, UINT16_MAX, NULL, "9464", false},
+    {"metrics_interval", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, metrics_interval), 0, UINT32_MAX, NULL, "60", false},
+    {"trace_file", SAT_CONFIG_STRING, offsetof(SAT_CONFIG, trace_file), 0, 0, NULL, "/home/root/satclient_trace.json", false},
+    {"bus_cpus", SAT_CONFIG_CPUS, offsetof(SAT_CONFIG, bus_cpu_mask), 0, 0, NULL, "", false},
+    {"lane_cpus", SAT_CONFIG_CPUS, offsetof(SAT_CONFIG, lane_cpu_mask), 0, 0, NULL, "", false},
+    {"aws_shadow", SAT_CONFIG_FLAG, offsetof(SAT_CONFIG, aws_shadow), 0, 0, NULL, "0", false},
+    {"batch_size", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, tunables.batch_size), 0, TELEMETRY_BATCH_MAX_READINGS, NULL, "0", true},
+    {"flush_latency_ms", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, tunables.flush_latency_ms), 1, 60000, NULL, "250", true},
+    {"heartbeat_interval", SAT_CONFIG_UINT, offsetof(SAT_CONFIG, tunables.heartbeat_interval), 0, UINT32_MAX, NULL, "1000", true}
+};
+static const uint32_t SETTING_COUNT = sizeof (SETTINGS) / sizeof (SETTINGS[0]);
+
+//function declarations
+static const SAT_CONFIG_SETTING* find_sat_config_setting(const char*, uint32_t);
+static bool parse_sat_config_value(SAT_CONFIG*, const SAT_CONFIG_SETTING*, const char*);
+static bool is_sat_config_choice(const char*, const char*);
+static size_t get_sat_config_value_size(const SAT_CONFIG_SETTING*);
+static bool apply_sat_config_file(SAT_CONFIG*, const char*);
+static bool apply_sat_config_environment(SAT_CONFIG*);
+static void print_sat_config_tunables(const char*, const SAT_TUNABLES*);
+static void* run_sat_config_watcher_worker(void*);
+
+//function definition
+//set every setting to its default
+void get_default_sat_config(SAT_CONFIG* config)
+{
+    //local vars
+    uint32_t i;
+
+    //check input
+    if (config != NULL)
+    {
+        //strings are zero filled past their terminator, so two configurations can be compared a setting at a time
+        memset(config, 0, sizeof (SAT_CONFIG));
+
+        for (i = 0; i < SETTING_COUNT; i++)
+        {
+            parse_sat_config_value(config, &(SETTINGS[i]), SETTINGS[i].default_value);
+        }
+    }
+}
+
+//function definition
+//resolve the configuration from the defaults, the supplied file (NULL for none), then the environment
+//reports every setting that is rejected, returns false if any was
+bool load_sat_config(SAT_CONFIG* config, const char* file_location)
+{
+    //local vars
+    bool operation_status;      //denotes success or failure of the operation
+
+    //check input
+    if (config == NULL)
+    {
+        return false;
+    }
+
+    get_default_sat_config(config);
+    operation_status = (file_location == NULL) || apply_sat_config_file(config, file_location);
+    operation_status &= apply_sat_config_environment(config);
+
+    return operation_status;
+}
+
+//function definition
+//create a config watcher, reloading the tunables from the supplied file (NULL for none) each time the process gets SIGHUP
+//must be called before any other thread is started (so none of them take the signal), returns NULL on failure
+SAT_CONFIG_WATCHER* new_sat_config_watcher(const char* file_location, const SAT_CONFIG* config)
+{
+    //local vars
+    SAT_CONFIG_WATCHER* watcher;
+    sigset_t signals;
+
+    //check inputs
+    if ((config != NULL) && ((file_location == NULL) || (strlen(file_location) < SAT_CONFIG_MAX_VALUE_SIZE)))
+    {
+        //allocate config watcher object
+        watcher = allocate_sat_memory(SAT_MEMORY_SAT_CONFIG, sizeof (SAT_CONFIG_WATCHER));
+
+        //if the object was successfully created
+        if (watcher != NULL)
+        {
+            snprintf(watcher->file_location, sizeof (watcher->file_location), "%s", (file_location != NULL) ? file_location : "");
+            watcher->config = *config;
+            watcher->tunables = config->tunables;
+            watcher->generation = 0;
+            watcher->applied = config->tunables;
+            watcher->applied_generation = 0;
+            watcher->is_stopping = false;
+            pthread_mutex_init(&(watcher->lock), NULL);
+
+            //leave SIGHUP to the watcher's thread (this thread's mask is inherited by every thread it starts)
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGHUP);
+            if ((pthread_sigmask(SIG_BLOCK, &signals, NULL) == 0) && (pthread_create(&(watcher->worker), NULL, run_sat_config_watcher_worker, watcher) == 0))
+            {
+                return watcher;
+            }
+
+            fprintf(stderr, "ERROR: FAILED TO START CONFIG WATCHER THREAD!\n");
+            pthread_mutex_destroy(&(watcher->lock));
+            free_sat_memory(watcher);
+        }
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//reload the configuration, publishing its tunables (the current ones are kept if the file is rejected)
+//the other settings are left as the process started with them (those that changed are reported)
+bool reload_sat_config_tunables(SAT_CONFIG_WATCHER* watcher)
+{
+    //local vars
+    SAT_CONFIG reloaded;
+    const uint8_t* started_value;
+    const uint8_t* reloaded_value;
+    uint32_t i;
+
+    //check input
+    if (watcher == NULL)
+    {
+        return false;
+    }
+
+    if (!load_sat_config(&reloaded, (watcher->file_location[0] != '\0') ? watcher->file_location : NULL))
+    {
+        fprintf(stderr, "ERROR: FAILED TO RELOAD CONFIG, KEEPING THE CURRENT TUNABLES!\n");
+
+        //failure
+        return false;
+    }
+
+    //report the settings that only take effect on a restart
+    for (i = 0; i < SETTING_COUNT; i++)
+    {
+        started_value = (const uint8_t*)&(watcher->config) + SETTINGS[i].offset;
+        reloaded_value = (const uint8_t*)&reloaded + SETTINGS[i].offset;
+        if ((!SETTINGS[i].is_tunable) && (memcmp(started_value, reloaded_value, get_sat_config_value_size(&(SETTINGS[i]))) != 0))
+        {
+            fprintf(stderr, "WARNING: CONFIG SETTING %s ONLY CHANGES ON A RESTART!\n", SETTINGS[i].key);
+        }
+    }
+
+    //publish the tunables
+    pthread_mutex_lock(&(watcher->lock));
+    watcher->tunables = reloaded.tunables;
+    __atomic_store_n(&(watcher->generation), watcher->generation + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&(watcher->lock));
+
+    print_sat_config_tunables("RELOADED", &(reloaded.tunables));
+
+    //success
+    return true;
+}
+
+//function definition
+//get the latest tunables, if they have been replaced since the supplied generation (which is advanced to theirs)
+//returns false when there is nothing new (a single atomic load), or no watcher
+bool get_sat_config_tunables(SAT_CONFIG_WATCHER* watcher, uint32_t* generation, SAT_TUNABLES* tunables)
+{
+    //check inputs
+    if ((watcher == NULL) || (generation == NULL) || (tunables == NULL) || (__atomic_load_n(&(watcher->generation), __ATOMIC_ACQUIRE) == *generation))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&(watcher->lock));
+    *tunables = watcher->tunables;
+    *generation = watcher->generation;
+    pthread_mutex_unlock(&(watcher->lock));
+
+    return true;
+}
+
+//function definition
+//update the tunables named by the supplied keys with the supplied values (parsed and validated like values in the file)
+//every value is taken or, if any is rejected (or names a setting that isn't a tunable), none of them
+bool update_sat_config_tunables(SAT_CONFIG_WATCHER* watcher, const char* const* keys, const char* const* values, uint32_t key_count)
+{
+    //local vars
+    bool operation_status = true;       //denotes success or failure of the operation
+    SAT_CONFIG updated;
+    const SAT_CONFIG_SETTING* setting;
+    uint32_t i;
+
+    //check inputs
+    if ((watcher == NULL) || (keys == NULL) || (values == NULL) || (key_count == 0))
+    {
+        return false;
+    }
+
+    //apply the values over the latest tunables, publishing them if every one was taken (under the lock, so a reload can't come in between)
+    updated = watcher->config;
+    pthread_mutex_lock(&(watcher->lock));
+    updated.tunables = watcher->tunables;
+    for (i = 0; i < key_count; i++)
+    {
+        setting = find_sat_config_setting(keys[i], (uint32_t)strlen(keys[i]));
+        if ((setting == NULL) || (!setting->is_tunable))
+        {
+            fprintf(stderr, "ERROR: CONFIG SETTING %s CAN'T BE UPDATED WHILE RUNNING!\n", keys[i]);
+            operation_status = false;
+        }
+        else if (!parse_sat_config_value(&updated, setting, values[i]))
+        {
+            fprintf(stderr, "ERROR: INVALID VALUE FOR CONFIG SETTING %s: %s!\n", setting->key, values[i]);
+            operation_status = false;
+        }
+    }
+    if (operation_status)
+    {
+        watcher->tunables = updated.tunables;
+        __atomic_store_n(&(watcher->generation), watcher->generation + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&(watcher->lock));
+
+    if (!operation_status)
+    {
+        fprintf(stderr, "ERROR: CONFIG UPDATE REJECTED, KEEPING THE CURRENT TUNABLES!\n");
+
+        //failure
+        return false;
+    }
+
+    print_sat_config_tunables("UPDATED", &(updated.tunables));
+
+    //success
+    return true;
+}
+
+//function definition
+//hand back the tunables a board applied (the values in effect, which may differ from those it was given)
+void set_sat_config_applied_tunables(SAT_CONFIG_WATCHER* watcher, const SAT_TUNABLES* tunables)
+{
+    //check inputs
+    if ((watcher != NULL) && (tunables != NULL))
+    {
+        pthread_mutex_lock(&(watcher->lock));
+        watcher->applied = *tunables;
+        __atomic_store_n(&(watcher->applied_generation), watcher->applied_generation + 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&(watcher->lock));
+    }
+}
+
+//function definition
+//get the tunables a board applied last, if a board has applied any since the supplied generation (which is advanced to theirs)
+//returns false when there is nothing new (a single atomic load), or no watcher
+bool get_sat_config_applied_tunables(SAT_CONFIG_WATCHER* watcher, uint32_t* generation, SAT_TUNABLES* tunables)
+{
+    //check inputs
+    if ((watcher == NULL) || (generation == NULL) || (tunables == NULL) || (__atomic_load_n(&(watcher->applied_generation), __ATOMIC_ACQUIRE) == *generation))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&(watcher->lock));
+    *tunables = watcher->applied;
+    *generation = watcher->applied_generation;
+    pthread_mutex_unlock(&(watcher->lock));
+
+    return true;
+}
+
+//function definition
+//stop the config watcher and deallocate it
+void free_sat_config_watcher(SAT_CONFIG_WATCHER* watcher)
+{
+    //check input
+    if (watcher != NULL)
+    {
+        //wake the worker from its wait
+        __atomic_store_n(&(watcher->is_stopping), true, __ATOMIC_RELEASE);
+        pthread_kill(watcher->worker, SIGHUP);
+        pthread_join(watcher->worker, NULL);
+
+        pthread_mutex_destroy(&(watcher->lock));
+        free_sat_memory(watcher);
+    }
+}
+
+//function definition
+//restrict a thread to the cpus of a mask (a bit per cpu, 0 leaves the thread free to run on any)
+bool set_thread_cpu_mask(pthread_t thread, uint64_t cpu_mask)
+{
+    //local vars
+    cpu_set_t cpus;
+    uint32_t i;
+
+    if (cpu_mask == 0)
+    {
+        return true;
+    }
+
+    CPU_ZERO(&cpus);
+    for (i = 0; i < SAT_CONFIG_MAX_CPUS; i++)
+    {
+        if ((cpu_mask & ((uint64_t)1 << i)) != 0)
+        {
+            CPU_SET(i, &cpus);
+        }
+    }
+
+    if (pthread_setaffinity_np(thread, sizeof (cpus), &cpus) != 0)
+    {
+        fprintf(stderr, "ERROR: FAILED TO SET THREAD CPU AFFINITY (MASK 0x%llX)!\n", (unsigned long long)cpu_mask);
+
+        //failure
+        return false;
+    }
+
+    //success
+    return true;
+}
+
+//function definition
+//find the setting with the supplied key (of the supplied size, it needn't be null terminated), NULL if there is none
+static const SAT_CONFIG_SETTING* find_sat_config_setting(const char* key, uint32_t key_size)
+{
+    //local vars
+    uint32_t i;
+
+    for (i = 0; i < SETTING_COUNT; i++)
+    {
+        if ((strlen(SETTINGS[i].key) == key_size) && (strncmp(SETTINGS[i].key, key, key_size) == 0))
+        {
+            return &(SETTINGS[i]);
+        }
+    }
+
+    return NULL;
+}
+
+//function definition
+//parse and validate a setting's value, storing it in the configuration (which is left as it was if the value is rejected)
+static bool parse_sat_config_value(SAT_CONFIG* config, const SAT_CONFIG_SETTING* setting, const char* text)
+{
+    //local vars
+    uint8_t* value = (uint8_t*)config + setting->offset;
+    char* end;
+    unsigned long whole_number;
+    double number;
+    uint64_t cpu_mask = 0;
+    size_t text_size = strlen(text);
+    size_t i;
+
+    switch (setting->type)
+    {
+        case SAT_CONFIG_NAME:
+            for (i = 0; i < text_size; i++)
+            {
+                if ((!isalnum((unsigned char)text[i])) && (text[i] != '_') && (text[i] != '-') && (text[i] != '.'))
+                {
+                    return false;
+                }
+            }
+            if (text_size == 0)
+            {
+                return false;
+            }
+            //fall through (stored like any other string)
+        case SAT_CONFIG_STRING:
+            if ((text_size >= SAT_CONFIG_MAX_VALUE_SIZE) || ((setting->choices != NULL) && (!is_sat_config_choice(setting->choices, text))))
+            {
+                return false;
+            }
+            memset(value, 0, SAT_CONFIG_MAX_VALUE_SIZE);
+            memcpy(value, text, text_size);
+            return true;
+        case SAT_CONFIG_UINT:
+            whole_number = strtoul(text, &end, 10);
+            if ((end == text) || (*end != '\0') || (text[0] == '-') || ((double)whole_number < setting->minimum) || ((double)whole_number > setting->maximum))
+            {
+                return false;
+            }
+            *((uint32_t*)value) = (uint32_t)whole_number;
+            return true;
+        case SAT_CONFIG_REAL:
+            number = strtod(text, &end);
+            if ((end == text) || (*end != '\0') || (!isfinite(number)) || (number < setting->minimum) || (number > setting->maximum))
+            {
+                return false;
+            }
+            *((double*)value) = number;
+            return true;
+        case SAT_CONFIG_FLAG:
+            if ((strcmp(text, "0") != 0) && (strcmp(text, "1") != 0))
+            {
+                return false;
+            }
+            *((bool*)value) = (text[0] == '1');
+            return true;
+        case SAT_CONFIG_CPUS:
+            while (*text != '\0')
+            {
+                whole_number = strtoul(text, &end, 10);
+                if ((end == text) || (text[0] == '-') || (whole_number >= SAT_CONFIG_MAX_CPUS) || ((*end != ',') && (*end != '\0')))
+                {
+                    return false;
+                }
+                cpu_mask |= (uint64_t)1 << whole_number;
+                text = (*end == ',') ? (end + 1) : end;
+            }
+            *((uint64_t*)value) = cpu_mask;
+            return true;
+    }
+
+    return false;
+}
+
+//function definition
+//determine if a string is one of the "|" separated choices
+static bool is_sat_config_choice(const char* choices, const char* text)
+{
+    //local vars
+    size_t choice_size;
+
+    while (*choices != '\0')
+    {
+        choice_size = strcspn(choices, "|");
+        if ((strlen(text) == choice_size) && (strncmp(choices, text, choice_size) == 0))
+        {
+            return true;
+        }
+
+        choices += choice_size;
+        if (*choices == '|')
+        {
+            choices++;
+        }
+    }
+
+    return false;
+}
+
+//function definition
+//get the size of a setting's value in the SAT_CONFIG
+static size_t get_sat_config_value_size(const SAT_CONFIG_SETTING* setting)
+{
+    switch (setting->type)
+    {
+        case SAT_CONFIG_UINT:
+            return sizeof (uint32_t);
+        case SAT_CONFIG_REAL:
+            return sizeof (double);
+        case SAT_CONFIG_FLAG:
+            return sizeof (bool);
+        case SAT_CONFIG_CPUS:
+            return sizeof (uint64_t);
+        default:
+            return SAT_CONFIG_MAX_VALUE_SIZE;
+    }
+}
+
+//function definition
+//apply every "key value" line of a file (reporting each line that is rejected, returns false if any was)
+static bool apply_sat_config_file(SAT_CONFIG* config, const char* file_location)
+{
+    //local vars
+    bool operation_status = true;       //denotes success or failure of the operation
+    FILE* file_handle;
+    char line[SAT_CONFIG_MAX_LINE_SIZE];
+    const SAT_CONFIG_SETTING* setting;
+    char* key;
+    char* value;
+    char* end;
+    uint32_t key_size;
+    uint32_t line_number = 0;
+    int character;
+
+    file_handle = fopen(file_location, "r");
+    if (file_handle == NULL)
+    {
+        fprintf(stderr, "ERROR: FAILED TO OPEN CONFIG FILE: %s!\n", file_location);
+
+        //failure
+        return false;
+    }
+
+    while (fgets(line, sizeof (line), file_handle) != NULL)
+    {
+        line_number++;
+
+        //a line that doesn't fit is rejected (skipping the rest of it)
+        if ((strchr(line, '\n') == NULL) && (!feof(file_handle)))
+        {
+            fprintf(stderr, "ERROR: CONFIG FILE %s LINE %u IS TOO LONG!\n", file_location, line_number);
+            operation_status = false;
+            while (((character = fgetc(file_handle)) != EOF) && (character != '\n'))
+            {
+            }
+            continue;
+        }
+
+        //drop the comment and the surrounding whitespace, skipping lines left empty
+        line[strcspn(line, "#\r\n")] = '\0';
+        for (key = line; isspace((unsigned char)*key); key++)
+        {
+        }
+        for (end = key + strlen(key); (end > key) && isspace((unsigned char)end[-1]); end--)
+        {
+        }
+        *end = '\0';
+        if (*key == '\0')
+        {
+            continue;
+        }
+
+        //split the key from its value (the rest of the line)
+        key_size = (uint32_t)strcspn(key, " \t");
+        for (value = key + key_size; isspace((unsigned char)*value); value++)
+        {
+        }
+
+        setting = find_sat_config_setting(key, key_size);
+        if (setting == NULL)
+        {
+            fprintf(stderr, "ERROR: CONFIG FILE %s LINE %u HAS AN UNKNOWN SETTING: %.*s!\n", file_location, line_number, (int)key_size, key);
+            operation_status = false;
+        }
+        else if (!parse_sat_config_value(config, setting, value))
+        {
+            fprintf(stderr, "ERROR: CONFIG FILE %s LINE %u HAS AN INVALID VALUE FOR %s: %s!\n", file_location, line_number, setting->key, value);
+            operation_status = false;
+        }
+    }
+
+    fclose(file_handle);
+
+    return operation_status;
+}
+
+//function definition
+//apply the environment variable of each setting that has one set (reporting each that is rejected, returns false if any was)
+static bool apply_sat_config_environment(SAT_CONFIG* config)
+{
+    //local vars
+    bool operation_status = true;       //denotes success or failure of the operation
+    char env_name[64];
+    const char* env_value;
+    size_t prefix_size = strlen(SAT_CONFIG_ENV_PREFIX);
+    size_t i;
+    uint32_t j;
+
+    for (j = 0; j < SETTING_COUNT; j++)
+    {
+        //the variable is the key upper cased, with the prefix
+        snprintf(env_name, sizeof (env_name), "%s%s", SAT_CONFIG_ENV_PREFIX, SETTINGS[j].key);
+        for (i = prefix_size; env_name[i] != '\0'; i++)
+        {
+            env_name[i] = (char)toupper((unsigned char)env_name[i]);
+        }
+
+        env_value = getenv(env_name);
+        if ((env_value != NULL) && (env_value[0] != '\0') && (!parse_sat_config_value(config, &(SETTINGS[j]), env_value)))
+        {
+            fprintf(stderr, "ERROR: ENVIRONMENT VARIABLE %s HAS AN INVALID VALUE: %s!\n", env_name, env_value);
+            operation_status = false;
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//print the tunables (with what happened to them)
+static void print_sat_config_tunables(const char* action, const SAT_TUNABLES* tunables)
+{
+    fprintf(stdout, "CONFIG: %s - BATCH SIZE %u FLUSH LATENCY %ums HEARTBEAT INTERVAL %u ODR %g/%g/%ghz FILTERS \"%s\"\n", action, tunables->batch_size, tunables->flush_latency_ms,
+            tunables->heartbeat_interval, tunables->gyro_odr, tunables->accel_odr, tunables->magneto_odr, tunables->filters);
+}
+
+//function definition
+//config watcher thread, reloads the tunables each time the process gets SIGHUP until the watcher is stopping
+static void* run_sat_config_watcher_worker(void* parameter)
+{
+    //local vars
+    SAT_CONFIG_WATCHER* watcher = (SAT_CONFIG_WATCHER*)parameter;
+    sigset_t signals;
+    int signal_number;
+
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+
+    while ((sigwait(&signals, &signal_number) == 0) && (!__atomic_load_n(&(watcher->is_stopping), __ATOMIC_ACQUIRE)))
+    {
+        reload_sat_config_tunables(watcher);
+    }
+
+    return NULL;
+}
@@ -5,13 +5,16 @@
 
 #define _GNU_SOURCE             //enable GNU extensions in stdio.h so we can use "getline" function
 
-#include <stdio.h>              //using for "sprintf" function
-#include <stdlib.h>             //using for "malloc" function, "size_t", and "ssize_t" types
+#include <stdio.h>              //using for "sprintf", "fopen", and "getline" functions
+#include <stdlib.h>             //using for "free" function (the getline buffers), "size_t", and "ssize_t" types
 #include <string.h>             //using for "strlen", "memcpy", and "memset" functions
 #include <openssl/hmac.h>       //using for "HMAC" function
 #include <openssl/bio.h>        //using for "BIO*" functions
-#include <openssl/evp.h>        //using for "EVP_sha256" and "EVP_BytesToKey" functions
+#include <openssl/evp.h>        //using for "EVP_sha256", "EVP_BytesToKey", "PKCS5_PBKDF2_HMAC", and "EVP_PBE_scrypt" functions
 #include <openssl/buffer.h>     //using for "BUF_MEM" structure
+#include <openssl/rand.h>       //using for "RAND_bytes" function
+#include <openssl/crypto.h>     //using for "OPENSSL_cleanse" function
+#include "satmemory.h"          //using to allocate from the memory arena
 #include "cryptoutil.h"
 
 //global vars
@@ -19,24 +22,30 @@ static const int GET_LINE_FAILED = -1;                              //failure co
 static const int OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES = 16;  //size (in bytes) of the openssl salt signature ("Salted__") and value
 static const int OPENSSL_SALT_VALUE_SIZE_BYTES = 8;                 //size (in bytes) of the AES-256 salt value
 static const int OPENSSL_EVP_CIPHER_SUCCESS = 1;                    //openssl evp cipher function was a success
-static const int OPENSSL_EVP_BYTESTOKEY_ITERATION_COUNT = 1;        //algorithm iteration count, "openssl enc" does not currently support an option for iteration count but defaults to 1, therefore we must use only one iteration when deriving the key and iv
+static const int OPENSSL_EVP_BYTESTOKEY_ITERATION_COUNT = 1;        //algorithm iteration count, "openssl enc" does not currently support an option for iteration count but defaults to 1, therefore we must use only one iteration when deriving the key and iv (use PBKDF2_SHA256 or SCRYPT for a tunable cost)
+static const char OPENSSL_SALT_SIGNATURE[] = "Salted__";            //signature that begins the openssl salt header
 static const int EXPECTED_HMAC_SECRET_KEY_SIZE_BYTES = 32;          //expected size (in bytes) of the HMAC SHA-256 secret key
 static const int NUL_TERMINATED_STRING = -1;                        //indicates the supplied buffer to BIO_new_mem_buf is nul '\0' terminated
 static const int BASE64_BYTE_BLOCK_SIZE = 3;                        //size in bytes of a base64 block (24 bits divided by 8 bits per byte)
 static const int BASE64_CHAR_BLOCK_SIZE = 4;                        //size in characters of a base64 block (24 bits divided by 6 bits per character)
+static const char SEALED_BATCH_KEY_DERIVATION_LABEL[] = "satclient sealed telemetry batch key v1";    //message hmac'd with the master key to derive the sealing key (keeps the sealing key distinct from any other use of the master key)
+static const char SEALED_BATCH_SUBKEY_DERIVATION_LABEL[] = "satclient sealed telemetry batch subkey v1";  //message (followed by a context's salt) hmac'd with the sealing key to derive the context's subkey
+#define SEALED_BATCH_IV_SIZE_BYTES 12                                       //96-bit cipher iv, 4 zero bytes + the 8-byte batch counter
+#define SEALED_BATCH_COUNTER_SIZE_BYTES (SEALED_BATCH_NONCE_SIZE_BYTES - SEALED_BATCH_SALT_SIZE_BYTES)
 
 //function declarations
 static int compute_base64_decode_byte_array_size(const char*);
+static const EVP_CIPHER* get_aead_evp_cipher(AEAD_CIPHER);
+static bool set_sealed_batch_subkey(SEALED_BATCH_CONTEXT*, const uint8_t*);
+static void compute_sealed_batch_iv(const uint8_t*, uint8_t*);
 
 //function definition
-//load the base64 encoded openssl payload (salt header + ciphertext) from the local file
+//load the base64 encoded openssl payload (salt header + ciphertext) from the local file, prompting the user for its location
 //the file contents are encrypted and base64 encoded beforehand using: openssl enc -e -aes-256-cfb -salt -md sha256 -pass pass:"YOUR_PASSPHRASE_HERE" -base64 -A -in secret_key.plaintext -out secret_key.base64_encoded_ciphertext
 bool load_base64_encoded_openssl_payload(char** base64_encoded_openssl_payload)
 {
     //local vars
     bool operation_status = false;                  //denotes success or failure of the operation
-    FILE* file_handle;                              //file containing encrypted secret key
-    int file_content_size;                          //size (in bytes) of the file content
     char* file_location_input = NULL;               //user input denoting location of file containing AES-256 encrypted secret key
     size_t file_location_input_buffer_size = 0;     //size of buffer allocated by getline()
     ssize_t file_location_input_size;               //size of location input
@@ -59,22 +68,52 @@ bool load_base64_encoded_openssl_payload(char** base64_encoded_openssl_payload)
             //zero out the new line at the end of the file location string (place a nul character to terminate the string there)
             file_location_input[file_location_input_size - 1] = '\0';
 
-            //open file
-            file_handle = fopen(file_location_input, "r");
+            //load the file contents
+            operation_status = load_base64_encoded_openssl_payload_from_file(file_location_input, base64_encoded_openssl_payload);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO OBTAIN LOCATION OF BASE64 ENCODED OPENSSL PAYLOAD FILE FROM USER!\n");
+        }
 
-            //if the file stream was opened successfully
-            if (file_handle != NULL)
-            {
-                //determine the size (in bytes) of the file contents
-                //advance the file pointer to the end of the file
-                fseek(file_handle, 0, SEEK_END);
-                //determine the size (in bytes) of the file contents
-                file_content_size = ftell(file_handle);
-                //move file pointer back to beginning of file
-                rewind(file_handle);
+        //free user input (even if failure occurred getline may have allocated buffers)
+        free(file_location_input);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//load the base64 encoded openssl payload (salt header + ciphertext) from the supplied file location (no user interaction)
+bool load_base64_encoded_openssl_payload_from_file(const char* file_location, char** base64_encoded_openssl_payload)
+{
+    //local vars
+    bool operation_status = false;                  //denotes success or failure of the operation
+    FILE* file_handle;                              //file containing encrypted secret key
+    long file_content_size;                         //size (in bytes) of the file content
 
+    //check inputs
+    if ((file_location != NULL) && (base64_encoded_openssl_payload != NULL))
+    {
+        //open file
+        file_handle = fopen(file_location, "r");
+
+        //if the file stream was opened successfully
+        if (file_handle != NULL)
+        {
+            //determine the size (in bytes) of the file contents
+            //advance the file pointer to the end of the file
+            fseek(file_handle, 0, SEEK_END);
+            //determine the size (in bytes) of the file contents
+            file_content_size = ftell(file_handle);
+            //move file pointer back to beginning of file
+            rewind(file_handle);
+
+            //if the file isn't empty
+            if (file_content_size > 0)
+            {
                 //allocate a byte buffer to store the entire file contents + 1 cell at the end for the nul character
-                *base64_encoded_openssl_payload = malloc((file_content_size + 1) * (sizeof (char)));
+                *base64_encoded_openssl_payload = allocate_sat_memory(SAT_MEMORY_CRYPTO, (file_content_size + 1) * (sizeof (char)));
 
                 //if the byte buffer was created successfully
                 if (*base64_encoded_openssl_payload != NULL)
@@ -98,27 +137,28 @@ bool load_base64_encoded_openssl_payload(char** base64_encoded_openssl_payload)
                     else
                     {
                         fprintf(stderr, "ERROR: FAILED TO LOAD BASE64 ENCODED OPENSSL PAYLOAD FILE CONTAINING ENCRYPTED DATA!\n");
+
+                        //free buffer
+                        free_sat_memory(*base64_encoded_openssl_payload);
+                        *base64_encoded_openssl_payload = NULL;
                     }
                 }
-
-                //close file handle
-                fclose(file_handle);
             }
+
+            //close file handle
+            fclose(file_handle);
         }
         else
         {
-            fprintf(stderr, "ERROR: FAILED TO OBTAIN LOCATION OF BASE64 ENCODED OPENSSL PAYLOAD FILE FROM USER!\n");
+            fprintf(stderr, "ERROR: FAILED TO OPEN BASE64 ENCODED OPENSSL PAYLOAD FILE: %s\n", file_location);
         }
-
-        //free user input (even if failure occurred getline may have allocated buffers)
-        free(file_location_input);
     }
 
     return operation_status;
 }
 
 //function definition
-//decrypt the supplied base64 encoded openssl payload (salt header + ciphertext)
+//decrypt the supplied base64 encoded openssl payload (salt header + ciphertext), prompting the user for the passphrase
 bool decrypt_base64_encoded_openssl_payload(const char* base64_encoded_openssl_payload, uint8_t** output_plaintext, uint32_t* output_plaintext_size)
 {
     //local vars
@@ -126,16 +166,6 @@ bool decrypt_base64_encoded_openssl_payload(const char* base64_encoded_openssl_p
     char* passphrase_input = NULL;                  //user input denoting passphrase used to encrypt the secret key in the file
     size_t passphrase_input_buffer_size = 0;        //size of buffer allocated by getline()
     ssize_t passphrase_input_size;                  //size of passphrase input
-    uint8_t* openssl_payload;                       //handle to openssl payload (i.e., salt header + ciphertext) loaded from file
-    uint32_t openssl_payload_size;                  //size (in bytes) of openssl_payload
-    uint8_t* openssl_payload_salt;                  //handle to salt extracted from openssl_payload, 8-byte (64-bit) salt (random data) that is combined with the passphrase (to discourage a dictionary attack) to generate the key and iv
-    uint32_t openssl_payload_salt_size;             //size (in bytes) of openssl_payload_salt
-    uint8_t* openssl_payload_ciphertext;            //handle to ciphertext extracted from openssl_payload
-    uint32_t openssl_payload_ciphertext_size;       //size (in bytes) of openssl_payload_ciphertext
-    uint8_t* cipher_key = NULL;                     //handle to cipher key (used to decrypt payload)
-    uint32_t cipher_key_size;                       //size (in bytes) of cipher key
-    uint8_t* cipher_iv = NULL;                      //handle to cipher iv (used to decrypt payload)
-    uint32_t cipher_iv_size;                        //size (in bytes) of cipher iv
 
     //check inputs
     if ((base64_encoded_openssl_payload != NULL) && (output_plaintext != NULL) && (output_plaintext_size != NULL))
@@ -155,81 +185,175 @@ bool decrypt_base64_encoded_openssl_payload(const char* base64_encoded_openssl_p
             //zero out the new line at the end of the passphrase string (place a nul character to terminate the string there)
             passphrase_input[passphrase_input_size - 1] = '\0';
 
-            //if base64 decoding was successful
-            //the openssl payload (salt header + ciphertext) is base64 encoded for easy handling, so we must first strip off the encoding to get the raw (binary) payload
-            if (compute_base64_decode(base64_encoded_openssl_payload, &openssl_payload, &openssl_payload_size))
+            //decrypt using the single iteration key derivation of "openssl enc"
+            //passphrase_input_length is factoring in '\n' in the last cell, so we subtract that out
+            operation_status = decrypt_base64_encoded_openssl_payload_with_passphrase(base64_encoded_openssl_payload, (uint8_t*)passphrase_input, (passphrase_input_size - 1), OPENSSL_BYTESTOKEY, OPENSSL_EVP_BYTESTOKEY_ITERATION_COUNT, output_plaintext, output_plaintext_size);
+
+            //immediately zero-out the memory that stored the passphrase
+            OPENSSL_cleanse(passphrase_input, passphrase_input_size);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO OBTAIN ENCRYPTION PASSPHRASE FROM USER!\n");
+        }
+
+        //free user input (even if failure occurred getline may have allocated buffers)
+        free(passphrase_input);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//decrypt the supplied base64 encoded openssl payload (salt header + ciphertext) using the supplied passphrase and key derivation function (no user interaction)
+bool decrypt_base64_encoded_openssl_payload_with_passphrase(const char* base64_encoded_openssl_payload, const uint8_t* passphrase, const uint32_t passphrase_size, KEY_DERIVATION_FUNCTION kdf, const uint32_t kdf_cost, uint8_t** output_plaintext, uint32_t* output_plaintext_size)
+{
+    //local vars
+    bool operation_status = false;                  //denotes success or failure of the operation
+    uint8_t* openssl_payload;                       //handle to openssl payload (i.e., salt header + ciphertext) loaded from file
+    uint32_t openssl_payload_size;                  //size (in bytes) of openssl_payload
+    uint8_t* openssl_payload_salt;                  //handle to salt extracted from openssl_payload, 8-byte (64-bit) salt (random data) that is combined with the passphrase (to discourage a dictionary attack) to generate the key and iv
+    uint32_t openssl_payload_salt_size;             //size (in bytes) of openssl_payload_salt
+    uint8_t* openssl_payload_ciphertext;            //handle to ciphertext extracted from openssl_payload
+    uint32_t openssl_payload_ciphertext_size;       //size (in bytes) of openssl_payload_ciphertext
+    uint8_t* cipher_key = NULL;                     //handle to cipher key (used to decrypt payload)
+    uint32_t cipher_key_size;                       //size (in bytes) of cipher key
+    uint8_t* cipher_iv = NULL;                      //handle to cipher iv (used to decrypt payload)
+    uint32_t cipher_iv_size;                        //size (in bytes) of cipher iv
+
+    //check inputs
+    if ((base64_encoded_openssl_payload != NULL) && (passphrase != NULL) && (passphrase_size > 0) && (output_plaintext != NULL) && (output_plaintext_size != NULL))
+    {
+        //if base64 decoding was successful
+        //the openssl payload (salt header + ciphertext) is base64 encoded for easy handling, so we must first strip off the encoding to get the raw (binary) payload
+        if (compute_base64_decode(base64_encoded_openssl_payload, &openssl_payload, &openssl_payload_size))
+        {
+            //double check if the openssl payload was successfully assigned
+            if ((openssl_payload != NULL) && (openssl_payload_size > 0))
             {
-                //double check if the openssl payload was successfully assigned
-                if ((openssl_payload != NULL) && (openssl_payload_size > 0))
+                //if the salt and ciphertext were successfully extracted from the openssl_payload
+                if (extract_salt_and_ciphertext_from_openssl_payload(openssl_payload, openssl_payload_size, &openssl_payload_salt, &openssl_payload_salt_size, &openssl_payload_ciphertext, &openssl_payload_ciphertext_size))
                 {
-                    //if the salt and ciphertext were successfully extracted from the openssl_payload
-                    if (extract_salt_and_ciphertext_from_openssl_payload(openssl_payload, openssl_payload_size, &openssl_payload_salt, &openssl_payload_salt_size, &openssl_payload_ciphertext, &openssl_payload_ciphertext_size))
+                    //double check if the salt and ciphertext were successfully assigned
+                    if ((openssl_payload_salt != NULL) && (openssl_payload_salt_size > 0) && (openssl_payload_ciphertext != NULL) && (openssl_payload_ciphertext_size > 0))
                     {
-                        //double check if the salt and ciphertext were successfully assigned
-                        if ((openssl_payload_salt != NULL) && (openssl_payload_salt_size > 0) && (openssl_payload_ciphertext != NULL) && (openssl_payload_ciphertext_size > 0))
+                        //derive the cipher key and iv from the supplied passphrase and salt
+                        if (derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(kdf, kdf_cost, passphrase, passphrase_size, openssl_payload_salt, openssl_payload_salt_size, &cipher_key, &cipher_key_size, &cipher_iv, &cipher_iv_size))
                         {
-                            //derive the cipher key and iv from the supplied passphrase and salt
-                            //passphrase_input_length is factoring in '\n' in the last cell, so we subtract that out
-                            if (derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt((uint8_t*)passphrase_input, (passphrase_input_size - 1), openssl_payload_salt, openssl_payload_salt_size, &cipher_key, &cipher_key_size, &cipher_iv, &cipher_iv_size))
+                            //double check if the key and iv were successfully assigned
+                            if ((cipher_key != NULL) && (cipher_key_size > 0) && (cipher_iv != NULL) && (cipher_iv_size > 0))
                             {
-                                //double check if the key and iv were successfully assigned
-                                if ((cipher_key != NULL) && (cipher_key_size > 0) && (cipher_iv != NULL) && (cipher_iv_size > 0))
+                                //if decryption was successful
+                                if (compute_aes256cfb_cipher(DECRYPT, cipher_key, cipher_key_size, cipher_iv, cipher_iv_size, openssl_payload_ciphertext, openssl_payload_ciphertext_size, output_plaintext, output_plaintext_size))
                                 {
-                                    //if decryption was successful
-                                    if (compute_aes256cfb_cipher(DECRYPT, cipher_key, cipher_key_size, cipher_iv, cipher_iv_size, openssl_payload_ciphertext, openssl_payload_ciphertext_size, output_plaintext, output_plaintext_size))
+                                    //double check if the plaintext was successfully assigned
+                                    if ((*output_plaintext != NULL) && (*output_plaintext_size > 0))
                                     {
-                                        //double check if the plaintext was successfully assigned
-                                        if ((*output_plaintext != NULL) && (*output_plaintext_size > 0))
+                                        //ensure a line feed '\n' character (hex = "0x0a") isn't present at the end of the byte string (could've been appended when the plaintext was originally saved), if so zero it out
+                                        if ((*output_plaintext)[*output_plaintext_size - 1] == 0x0a)
                                         {
-                                            //ensure a line feed '\n' character (hex = "0x0a") isn't present at the end of the byte string (could've been appended when the plaintext was originally saved), if so zero it out
-                                            if ((*output_plaintext)[*output_plaintext_size - 1] == 0x0a)
-                                            {
-                                                //zero out line feed character and decrement the size of the buffer so it's not used
-                                                (*output_plaintext)[*output_plaintext_size - 1] = 0;
-                                                (*output_plaintext_size)--;
-                                            }
-
-                                            //success
-                                            operation_status = true;
+                                            //zero out line feed character and decrement the size of the buffer so it's not used
+                                            (*output_plaintext)[*output_plaintext_size - 1] = 0;
+                                            (*output_plaintext_size)--;
                                         }
-                                    }
-                                    else
-                                    {
-                                        fprintf(stderr, "ERROR: FAILED TO DECRYPT OPENSSL PAYLOAD!\n");
-                                    }
 
-                                    //free buffers
-                                    free(cipher_key);
-                                    free(cipher_iv);
+                                        //success
+                                        operation_status = true;
+                                    }
+                                }
+                                else
+                                {
+                                    fprintf(stderr, "ERROR: FAILED TO DECRYPT OPENSSL PAYLOAD!\n");
                                 }
-                            }
-                            else
-                            {
-                                fprintf(stderr, "ERROR: FAILED TO DERIVE CIPHER KEY & IV FROM ENCRYPTION PASSPHRASE & SALT!\n");
-                            }
 
-                            //free buffers
-                            free(openssl_payload_salt);
-                            free(openssl_payload_ciphertext);
+                                //zero-out and free buffers
+                                OPENSSL_cleanse(cipher_key, cipher_key_size);
+                                OPENSSL_cleanse(cipher_iv, cipher_iv_size);
+                                free_sat_memory(cipher_key);
+                                free_sat_memory(cipher_iv);
+                            }
+                        }
+                        else
+                        {
+                            fprintf(stderr, "ERROR: FAILED TO DERIVE CIPHER KEY & IV FROM ENCRYPTION PASSPHRASE & SALT!\n");
                         }
-                    }
 
-                    //free buffers
-                    free(openssl_payload);
+                        //free buffers
+                        free_sat_memory(openssl_payload_salt);
+                        free_sat_memory(openssl_payload_ciphertext);
+                    }
                 }
-            }
-            else
-            {
-                fprintf(stderr, "ERROR: FAILED TO DECODE BASE64 STRING!\n");
+
+                //free buffers
+                free_sat_memory(openssl_payload);
             }
         }
         else
         {
-            fprintf(stderr, "ERROR: FAILED TO OBTAIN ENCRYPTION PASSPHRASE FROM USER!\n");
+            fprintf(stderr, "ERROR: FAILED TO DECODE BASE64 STRING!\n");
         }
+    }
 
-        //free user input (even if failure occurred getline may have allocated buffers)
-        free(passphrase_input);
+    return operation_status;
+}
+
+//function definition
+/*
+    Encrypts the supplied plaintext into a base64 encoded openssl payload (salt header + ciphertext) using a random salt and the supplied
+    key derivation function. For OPENSSL_BYTESTOKEY and PBKDF2_SHA256 the output is byte compatible with "openssl enc -d -aes-256-cfb -md sha256
+    -base64 -A" (adding "-pbkdf2 -iter {cost}" for the latter), scrypt payloads can only be produced here since "openssl enc" lacks scrypt.
+*/
+bool encrypt_to_base64_encoded_openssl_payload(const uint8_t* passphrase, const uint32_t passphrase_size, KEY_DERIVATION_FUNCTION kdf, const uint32_t kdf_cost, const uint8_t* plaintext, const uint32_t plaintext_size, char** output_base64_encoded_openssl_payload)
+{
+    //local vars
+    bool operation_status = false;                  //denotes success or failure of the operation
+    uint8_t* openssl_payload;                       //salt header + ciphertext
+    uint32_t openssl_payload_size;                  //size (in bytes) of openssl_payload
+    uint8_t* ciphertext = NULL;                     //encrypted plaintext
+    uint32_t ciphertext_size;                       //size (in bytes) of ciphertext
+    uint8_t* cipher_key = NULL;                     //handle to cipher key
+    uint32_t cipher_key_size;                       //size (in bytes) of cipher key
+    uint8_t* cipher_iv = NULL;                      //handle to cipher iv
+    uint32_t cipher_iv_size;                        //size (in bytes) of cipher iv
+
+    //check inputs
+    if ((passphrase != NULL) && (passphrase_size > 0) && (plaintext != NULL) && (plaintext_size > 0) && (output_base64_encoded_openssl_payload != NULL))
+    {
+        //allocate a buffer for the salt header and ciphertext (in cfb mode the ciphertext is the same size as the plaintext)
+        openssl_payload_size = OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES + plaintext_size;
+        openssl_payload = allocate_sat_memory(SAT_MEMORY_CRYPTO, openssl_payload_size * (sizeof (uint8_t)));
+
+        //if the buffer was successfully created
+        if (openssl_payload != NULL)
+        {
+            //write the salt signature followed by a random salt value
+            memcpy(openssl_payload, OPENSSL_SALT_SIGNATURE, (OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES - OPENSSL_SALT_VALUE_SIZE_BYTES));
+
+            //if the salt was generated and the key and iv derived from it
+            if ((RAND_bytes(&(openssl_payload[OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES - OPENSSL_SALT_VALUE_SIZE_BYTES]), OPENSSL_SALT_VALUE_SIZE_BYTES) == 1) &&
+                derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(kdf, kdf_cost, passphrase, passphrase_size, &(openssl_payload[OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES - OPENSSL_SALT_VALUE_SIZE_BYTES]), OPENSSL_SALT_VALUE_SIZE_BYTES, &cipher_key, &cipher_key_size, &cipher_iv, &cipher_iv_size))
+            {
+                //if encryption was successful
+                if (compute_aes256cfb_cipher(ENCRYPT, cipher_key, cipher_key_size, cipher_iv, cipher_iv_size, plaintext, plaintext_size, &ciphertext, &ciphertext_size))
+                {
+                    //append the ciphertext after the salt header and base64 encode the whole payload
+                    memcpy(&(openssl_payload[OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES]), ciphertext, ciphertext_size);
+                    operation_status = compute_base64_encode(openssl_payload, openssl_payload_size, output_base64_encoded_openssl_payload);
+
+                    //free buffer
+                    free_sat_memory(ciphertext);
+                }
+
+                //zero-out and free buffers
+                OPENSSL_cleanse(cipher_key, cipher_key_size);
+                OPENSSL_cleanse(cipher_iv, cipher_iv_size);
+                free_sat_memory(cipher_key);
+                free_sat_memory(cipher_iv);
+            }
+
+            //free buffer
+            free_sat_memory(openssl_payload);
+        }
     }
 
     return operation_status;
@@ -246,8 +370,8 @@ bool extract_salt_and_ciphertext_from_openssl_payload(const uint8_t* openssl_pay
     if ((openssl_payload != NULL) && (openssl_payload_size > OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES) && (output_openssl_payload_salt != NULL) && (output_openssl_payload_salt_size != NULL) && (output_openssl_payload_ciphertext != NULL) && (output_openssl_payload_ciphertext_size != NULL))
     {
         ///allocate a buffers to hold extracted salt and ciphertext
-        *output_openssl_payload_salt = malloc(OPENSSL_SALT_VALUE_SIZE_BYTES * (sizeof (uint8_t)));
-        *output_openssl_payload_ciphertext = malloc((openssl_payload_size - OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES) * (sizeof (uint8_t)));
+        *output_openssl_payload_salt = allocate_sat_memory(SAT_MEMORY_CRYPTO, OPENSSL_SALT_VALUE_SIZE_BYTES * (sizeof (uint8_t)));
+        *output_openssl_payload_ciphertext = allocate_sat_memory(SAT_MEMORY_CRYPTO, (openssl_payload_size - OPENSSL_SALT_SIGNATURE_AND_VALUE_SIZE_BYTES) * (sizeof (uint8_t)));
 
         //if the buffers were successfully created
         if ((*output_openssl_payload_salt != NULL) && (*output_openssl_payload_ciphertext != NULL))
@@ -272,8 +396,8 @@ bool extract_salt_and_ciphertext_from_openssl_payload(const uint8_t* openssl_pay
         if (!operation_status)
         {
             //free buffers
-            free(*output_openssl_payload_salt);
-            free(*output_openssl_payload_ciphertext);
+            free_sat_memory(*output_openssl_payload_salt);
+            free_sat_memory(*output_openssl_payload_ciphertext);
             //zero size values
             *output_openssl_payload_salt_size = 0;
             *output_openssl_payload_ciphertext_size = 0;
@@ -294,8 +418,8 @@ bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt(const uint8_t*
     if ((passphrase != NULL) && (passphrase_size > 0) && (salt != NULL) && (salt_size == OPENSSL_SALT_VALUE_SIZE_BYTES) && (output_cipher_key != NULL) && (output_cipher_key_size != NULL) && (output_cipher_iv != NULL) && (output_cipher_iv_size != NULL))
     {
         ///allocate a buffer to hold the key and iv
-        *output_cipher_key = malloc(EVP_CIPHER_key_length(EVP_aes_256_cfb()) * (sizeof (uint8_t))); //should be 32 bytes
-        *output_cipher_iv = malloc(EVP_CIPHER_iv_length(EVP_aes_256_cfb()) * (sizeof (uint8_t))); //should be 16 bytes
+        *output_cipher_key = allocate_sat_memory(SAT_MEMORY_CRYPTO, EVP_CIPHER_key_length(EVP_aes_256_cfb()) * (sizeof (uint8_t))); //should be 32 bytes
+        *output_cipher_iv = allocate_sat_memory(SAT_MEMORY_CRYPTO, EVP_CIPHER_iv_length(EVP_aes_256_cfb()) * (sizeof (uint8_t))); //should be 16 bytes
 
         //if the buffers were successfully created
         if ((*output_cipher_key != NULL) && (*output_cipher_iv != NULL))
@@ -317,8 +441,8 @@ bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt(const uint8_t*
         if (!operation_status)
         {
             //free buffers
-            free(*output_cipher_key);
-            free(*output_cipher_iv);
+            free_sat_memory(*output_cipher_key);
+            free_sat_memory(*output_cipher_iv);
             //zero size values
             *output_cipher_key_size = 0;
             *output_cipher_iv_size = 0;
@@ -328,6 +452,92 @@ bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt(const uint8_t*
     return operation_status;
 }
 
+//function definition
+/*
+    Derive the secret key and iv used for encryption from the supplied passphrase and salt using the supplied key derivation function.
+    For PBKDF2_SHA256 and SCRYPT the kdf output is 48 bytes, the first 32 form the key and the remaining 16 the iv (the same split
+    "openssl enc -pbkdf2" uses). The cost is the pbkdf2 iteration count, or log2 of the scrypt N parameter.
+*/
+bool derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(KEY_DERIVATION_FUNCTION kdf, const uint32_t kdf_cost, const uint8_t* passphrase, const uint32_t passphrase_size, const uint8_t* salt, const uint32_t salt_size, uint8_t** output_cipher_key, uint32_t* output_cipher_key_size, uint8_t** output_cipher_iv, uint32_t* output_cipher_iv_size)
+{
+    //local vars
+    bool operation_status = false;          //denotes success or failure of the operation
+    uint8_t key_and_iv[48];                 //kdf output, key followed by iv
+    int key_size;                           //size (in bytes) of the aes-256-cfb key
+    int iv_size;                            //size (in bytes) of the aes-256-cfb iv
+    int kdf_status = 0;                     //return value of the kdf (1 = success)
+
+    //the original single round derivation is handled by the existing function
+    if (kdf == OPENSSL_BYTESTOKEY)
+    {
+        return derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt(passphrase, passphrase_size, salt, salt_size, output_cipher_key, output_cipher_key_size, output_cipher_iv, output_cipher_iv_size);
+    }
+
+    //check inputs
+    if ((passphrase != NULL) && (passphrase_size > 0) && (salt != NULL) && (salt_size == OPENSSL_SALT_VALUE_SIZE_BYTES) && (kdf_cost > 0) && (output_cipher_key != NULL) && (output_cipher_key_size != NULL) && (output_cipher_iv != NULL) && (output_cipher_iv_size != NULL))
+    {
+        //determine the sizes
+        key_size = EVP_CIPHER_key_length(EVP_aes_256_cfb()); //should be 32 bytes
+        iv_size = EVP_CIPHER_iv_length(EVP_aes_256_cfb()); //should be 16 bytes
+
+        //run the selected kdf
+        switch (kdf)
+        {
+            case PBKDF2_SHA256:
+                kdf_status = PKCS5_PBKDF2_HMAC((const char*)passphrase, passphrase_size, salt, salt_size, kdf_cost, EVP_sha256(), (key_size + iv_size), key_and_iv);
+                break;
+            case SCRYPT:
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L) && !defined(OPENSSL_NO_SCRYPT)
+                //N = 2^cost (must stay below 2^64), r = 8, p = 1, let openssl pick the default memory ceiling
+                if (kdf_cost < 64)
+                {
+                    kdf_status = EVP_PBE_scrypt((const char*)passphrase, passphrase_size, salt, salt_size, ((uint64_t)1 << kdf_cost), 8, 1, 0, key_and_iv, (key_size + iv_size));
+                }
+#else
+                fprintf(stderr, "ERROR: SCRYPT IS UNSUPPORTED BY THIS OPENSSL BUILD!\n");
+#endif
+                break;
+            case OPENSSL_BYTESTOKEY:
+                break;                                          //unnecessary (handled above) but added for consistency
+        }
+
+        //if the kdf succeeded
+        if (kdf_status == 1)
+        {
+            //allocate a buffer to hold the key and iv
+            *output_cipher_key = allocate_sat_memory(SAT_MEMORY_CRYPTO, key_size * (sizeof (uint8_t)));
+            *output_cipher_iv = allocate_sat_memory(SAT_MEMORY_CRYPTO, iv_size * (sizeof (uint8_t)));
+
+            //if the buffers were successfully created
+            if ((*output_cipher_key != NULL) && (*output_cipher_iv != NULL))
+            {
+                //split the kdf output into key and iv
+                memcpy(*output_cipher_key, key_and_iv, key_size);
+                memcpy(*output_cipher_iv, &(key_and_iv[key_size]), iv_size);
+                *output_cipher_key_size = key_size;
+                *output_cipher_iv_size = iv_size;
+
+                //success
+                operation_status = true;
+            }
+            else
+            {
+                //free buffers
+                free_sat_memory(*output_cipher_key);
+                free_sat_memory(*output_cipher_iv);
+                //zero size values
+                *output_cipher_key_size = 0;
+                *output_cipher_iv_size = 0;
+            }
+        }
+
+        //immediately zero-out the kdf output
+        OPENSSL_cleanse(key_and_iv, sizeof (key_and_iv));
+    }
+
+    return operation_status;
+}
+
 //function definition
 //performs AES-256-CFB encryption/decryption on the supplied byte array (could be ciphertext (for decryption mode) or plaintext (for encryption mode)
 bool compute_aes256cfb_cipher(CIPHER_MODE cmode, const uint8_t* key, const uint32_t key_size, const uint8_t* iv, const uint32_t iv_size, const uint8_t* input_byte_array, const uint32_t input_byte_array_size, uint8_t** output_byte_array, uint32_t* output_byte_array_size)
@@ -350,7 +560,7 @@ bool compute_aes256cfb_cipher(CIPHER_MODE cmode, const uint8_t* key, const uint3
             if (cipher_context != NULL)
             {
                 //allocate a buffer to hold the output bytes
-                *output_byte_array = malloc(input_byte_array_size * (sizeof (uint8_t)));
+                *output_byte_array = allocate_sat_memory(SAT_MEMORY_CRYPTO, input_byte_array_size * (sizeof (uint8_t)));
 
                 //if the buffer was successfully created
                 if (*output_byte_array != NULL)
@@ -387,7 +597,7 @@ bool compute_aes256cfb_cipher(CIPHER_MODE cmode, const uint8_t* key, const uint3
                     {
                         fprintf(stderr, "ERROR: CIPHER OPERATION FAILED, INPUT/OUTPUT DATA BUFFER SIZES DON'T MATCH!\n");
                         //free buffer
-                        free(*output_byte_array);
+                        free_sat_memory(*output_byte_array);
                         *output_byte_array_size = 0;
                     }
                 }
@@ -405,6 +615,202 @@ bool compute_aes256cfb_cipher(CIPHER_MODE cmode, const uint8_t* key, const uint3
     return operation_status;
 }
 
+//function definition
+//returns the aead algorithm best suited to this cpu, aes-256-gcm when the cpu has aes instructions (aes-ni), otherwise chacha20-poly1305 (if this openssl build provides it)
+AEAD_CIPHER get_preferred_aead_cipher(void)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L) && !defined(OPENSSL_NO_CHACHA) && !defined(OPENSSL_NO_POLY1305)
+#if defined(__x86_64__) || defined(__i386__)
+    //without aes-ni, table based aes (and especially the ghash portion of gcm) is several times slower than chacha20-poly1305
+    if (!__builtin_cpu_supports("aes"))
+    {
+        return CHACHA20POLY1305;
+    }
+#endif
+#endif
+
+    return AES256GCM;
+}
+
+//function definition
+//init the sealed batch context, the sealing key is derived from the supplied 32-byte master key once here rather than per batch
+bool init_sealed_batch_context(SEALED_BATCH_CONTEXT* sbcontext, AEAD_CIPHER cipher, const uint8_t* master_key, const uint32_t master_key_size)
+{
+    //local vars
+    bool operation_status = false;      //denotes success or failure of the operation
+    const EVP_CIPHER* evp_cipher;       //openssl cipher implementation for the selected algorithm
+    uint8_t* sealing_key = NULL;        //key derived from the master key
+    uint32_t sealing_key_size;          //size (in bytes) of the sealing key
+
+    //check inputs
+    if ((sbcontext != NULL) && (master_key != NULL) && (master_key_size == SEALED_BATCH_KEY_SIZE_BYTES))
+    {
+        //get the cipher implementation
+        evp_cipher = get_aead_evp_cipher(cipher);
+
+        //if this openssl build supports the selected algorithm
+        if (evp_cipher != NULL)
+        {
+            //derive the sealing key (hmac sha-256 of a fixed label, keyed with the master key)
+            if (compute_sha256_hmac_2(master_key, master_key_size, SEALED_BATCH_KEY_DERIVATION_LABEL, &sealing_key, &sealing_key_size))
+            {
+                //create cipher context
+                sbcontext->cipher_context = EVP_CIPHER_CTX_new();
+
+                //if the context was successfully created
+                if (sbcontext->cipher_context != NULL)
+                {
+                    //set the algorithm and the subkey once, subsequent calls only supply a fresh iv so the key schedule isn't recomputed per batch
+                    //the salt is random (128 bits) so every context seals under its own subkey, even if the same master key is used across restarts (the batch counter starts over at zero)
+                    memcpy(sbcontext->sealing_key, sealing_key, SEALED_BATCH_KEY_SIZE_BYTES);
+                    if ((EVP_CipherInit_ex(sbcontext->cipher_context, evp_cipher, NULL, NULL, NULL, ENCRYPT) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+                        (EVP_CIPHER_CTX_ctrl(sbcontext->cipher_context, EVP_CTRL_GCM_SET_IVLEN, SEALED_BATCH_IV_SIZE_BYTES, NULL) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+                        (RAND_bytes(sbcontext->seal_salt, SEALED_BATCH_SALT_SIZE_BYTES) == 1) &&
+                        set_sealed_batch_subkey(sbcontext, sbcontext->seal_salt))
+                    {
+                        sbcontext->cipher = cipher;
+                        sbcontext->batch_counter = 0;
+
+                        //success
+                        operation_status = true;
+                    }
+                    else
+                    {
+                        fprintf(stderr, "ERROR: FAILED TO INITIALIZE SEALED BATCH CIPHER CONTEXT!\n");
+
+                        //free context
+                        EVP_CIPHER_CTX_free(sbcontext->cipher_context);
+                        sbcontext->cipher_context = NULL;
+                        OPENSSL_cleanse(sbcontext->sealing_key, SEALED_BATCH_KEY_SIZE_BYTES);
+                    }
+                }
+
+                //immediately zero-out and free the derived key (the context holds its own copy)
+                OPENSSL_cleanse(sealing_key, sealing_key_size);
+                free_sat_memory(sealing_key);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: SELECTED AEAD CIPHER IS UNSUPPORTED BY THIS OPENSSL BUILD!\n");
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//deinit the sealed batch context
+void shutdown_sealed_batch_context(SEALED_BATCH_CONTEXT* sbcontext)
+{
+    //check input
+    if (sbcontext != NULL)
+    {
+        //free context (openssl cleanses the key schedule held in the context)
+        EVP_CIPHER_CTX_free(sbcontext->cipher_context);
+        sbcontext->cipher_context = NULL;
+        OPENSSL_cleanse(sbcontext->sealing_key, SEALED_BATCH_KEY_SIZE_BYTES);
+    }
+}
+
+//function definition
+/*
+    Seals (encrypts and authenticates) a telemetry batch in place. The batch buffer is overwritten with ciphertext of the same size,
+    the nonce used (the context's salt and the batch counter) and the authentication tag are written to the caller supplied output buffers
+    (SEALED_BATCH_NONCE_SIZE_BYTES and SEALED_BATCH_TAG_SIZE_BYTES respectively) so they can be sent or stored alongside the batch. The additional authenticated data (aad),
+    e.g., a batch header, is authenticated but not encrypted and may be NULL. No memory is allocated.
+*/
+bool seal_telemetry_batch(SEALED_BATCH_CONTEXT* sbcontext, const uint8_t* aad, const uint32_t aad_size, uint8_t* batch, const uint32_t batch_size, uint8_t* output_nonce, uint8_t* output_tag)
+{
+    //local vars
+    bool operation_status = false;      //denotes success or failure of the operation
+    int bytes_output_size;              //# of bytes outputted by the cipher operation
+    uint64_t batch_counter;             //counter of this batch (consumed from the context)
+    uint8_t iv[SEALED_BATCH_IV_SIZE_BYTES];
+    int index;                          //index for the loop
+
+    //check inputs
+    if ((sbcontext != NULL) && (sbcontext->cipher_context != NULL) && ((aad != NULL) || (aad_size == 0)) && (batch != NULL) && (batch_size > 0) && (output_nonce != NULL) && (output_tag != NULL))
+    {
+        //a nonce must never repeat under the same key, refuse to wrap the counter
+        if (sbcontext->batch_counter != UINT64_MAX)
+        {
+            //build a fresh nonce for this batch, the salt followed by the counter (most significant byte first)
+            batch_counter = sbcontext->batch_counter;
+            sbcontext->batch_counter++;
+            memcpy(output_nonce, sbcontext->seal_salt, SEALED_BATCH_SALT_SIZE_BYTES);
+            for (index = (SEALED_BATCH_NONCE_SIZE_BYTES - 1); index >= SEALED_BATCH_SALT_SIZE_BYTES; index--)
+            {
+                output_nonce[index] = (uint8_t)(batch_counter & 0xFF);
+                batch_counter >>= 8;
+            }
+            compute_sealed_batch_iv(output_nonce, iv);
+
+            //if the context's subkey is in place (opening another context's batch rekeys it), the iv was set, the aad absorbed, and the batch encrypted in place
+            if (((memcmp(sbcontext->key_salt, sbcontext->seal_salt, SEALED_BATCH_SALT_SIZE_BYTES) == 0) || set_sealed_batch_subkey(sbcontext, sbcontext->seal_salt)) &&
+                (EVP_CipherInit_ex(sbcontext->cipher_context, NULL, NULL, NULL, iv, ENCRYPT) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+                ((aad_size == 0) || (EVP_CipherUpdate(sbcontext->cipher_context, NULL, &bytes_output_size, aad, aad_size) == OPENSSL_EVP_CIPHER_SUCCESS)) &&
+                (EVP_CipherUpdate(sbcontext->cipher_context, batch, &bytes_output_size, batch, batch_size) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+                (bytes_output_size == batch_size) &&
+                (EVP_CipherFinal_ex(sbcontext->cipher_context, NULL, &bytes_output_size) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+                (EVP_CIPHER_CTX_ctrl(sbcontext->cipher_context, EVP_CTRL_GCM_GET_TAG, SEALED_BATCH_TAG_SIZE_BYTES, output_tag) == OPENSSL_EVP_CIPHER_SUCCESS))
+            {
+                //success
+                operation_status = true;
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: FAILED TO SEAL TELEMETRY BATCH!\n");
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: SEALED BATCH NONCE SPACE EXHAUSTED, RE-INITIALIZE THE CONTEXT!\n");
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//opens (verifies and decrypts) a telemetry batch sealed by "seal_telemetry_batch" in place, if verification fails the batch buffer is zeroed so unauthenticated plaintext is never handed back
+bool open_sealed_telemetry_batch(SEALED_BATCH_CONTEXT* sbcontext, const uint8_t* aad, const uint32_t aad_size, uint8_t* batch, const uint32_t batch_size, const uint8_t* nonce, const uint8_t* tag)
+{
+    //local vars
+    bool operation_status = false;      //denotes success or failure of the operation
+    int bytes_output_size;              //# of bytes outputted by the cipher operation
+    uint8_t iv[SEALED_BATCH_IV_SIZE_BYTES];
+
+    //check inputs
+    if ((sbcontext != NULL) && (sbcontext->cipher_context != NULL) && ((aad != NULL) || (aad_size == 0)) && (batch != NULL) && (batch_size > 0) && (nonce != NULL) && (tag != NULL))
+    {
+        compute_sealed_batch_iv(nonce, iv);
+
+        //if the subkey of the context that sealed the batch is in place (derived from the nonce's salt unless it already is), the iv was set,
+        //the aad absorbed, the batch decrypted in place, and the tag verified (the tag ctrl takes a non-const pointer but only reads from it)
+        if (((memcmp(sbcontext->key_salt, nonce, SEALED_BATCH_SALT_SIZE_BYTES) == 0) || set_sealed_batch_subkey(sbcontext, nonce)) &&
+            (EVP_CipherInit_ex(sbcontext->cipher_context, NULL, NULL, NULL, iv, DECRYPT) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+            ((aad_size == 0) || (EVP_CipherUpdate(sbcontext->cipher_context, NULL, &bytes_output_size, aad, aad_size) == OPENSSL_EVP_CIPHER_SUCCESS)) &&
+            (EVP_CipherUpdate(sbcontext->cipher_context, batch, &bytes_output_size, batch, batch_size) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+            (bytes_output_size == batch_size) &&
+            (EVP_CIPHER_CTX_ctrl(sbcontext->cipher_context, EVP_CTRL_GCM_SET_TAG, SEALED_BATCH_TAG_SIZE_BYTES, (void*)tag) == OPENSSL_EVP_CIPHER_SUCCESS) &&
+            (EVP_CipherFinal_ex(sbcontext->cipher_context, NULL, &bytes_output_size) == OPENSSL_EVP_CIPHER_SUCCESS))
+        {
+            //success
+            operation_status = true;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO AUTHENTICATE SEALED TELEMETRY BATCH!\n");
+
+            //don't leave unauthenticated plaintext behind
+            OPENSSL_cleanse(batch, batch_size);
+        }
+    }
+
+    return operation_status;
+}
+
 //function definition
 //computes a keyed-hash (SHA-256) message authentication code (HMAC) for a particular message (formatted as a 32-byte binary digest)
 bool compute_sha256_hmac(const uint8_t* secret_key, const uint32_t secret_key_size, const char* message, uint8_t** output_hmac, uint32_t* output_hmac_size)
@@ -417,7 +823,7 @@ bool compute_sha256_hmac(const uint8_t* secret_key, const uint32_t secret_key_si
     if ((secret_key != NULL) && (secret_key_size == EXPECTED_HMAC_SECRET_KEY_SIZE_BYTES) && (message != NULL) && (output_hmac != NULL) && (output_hmac_size != NULL))
     {
         //create a buffer to hold the outputted 32-byte hmac (digest size should be 32-byte since we're using a 256-bit secret key)
-        *output_hmac = malloc(EVP_MD_size(EVP_sha256()) * (sizeof (uint8_t)));
+        *output_hmac = allocate_sat_memory(SAT_MEMORY_CRYPTO, EVP_MD_size(EVP_sha256()) * (sizeof (uint8_t)));
 
         //if the buffer was successfully created
         if (*output_hmac != NULL)
@@ -453,7 +859,7 @@ bool compute_sha256_hmac(const uint8_t* secret_key, const uint32_t secret_key_si
         if (!operation_status)
         {
             //free buffer
-            free(*output_hmac);
+            free_sat_memory(*output_hmac);
             //set to NULL & zero size buffer
             *output_hmac = NULL;
             *output_hmac_size = 0;
@@ -474,7 +880,7 @@ bool compute_sha256_hmac_2(const uint8_t* secret_key, const uint32_t secret_key_
     if ((secret_key != NULL) && (secret_key_size == EXPECTED_HMAC_SECRET_KEY_SIZE_BYTES) && (message != NULL) && (output_hmac != NULL) && (output_hmac_size != NULL))
     {
         //create a buffer to hold the outputted 32-byte hmac (digest size should be 32-byte since we're using a 256-bit secret key)
-        *output_hmac = malloc(EVP_MD_size(EVP_sha256()) * (sizeof (uint8_t)));
+        *output_hmac = allocate_sat_memory(SAT_MEMORY_CRYPTO, EVP_MD_size(EVP_sha256()) * (sizeof (uint8_t)));
 
         //if the buffer was successfully created
         if (*output_hmac != NULL)
@@ -497,7 +903,7 @@ bool compute_sha256_hmac_2(const uint8_t* secret_key, const uint32_t secret_key_
         if (!operation_status)
         {
             //free buffer
-            free(*output_hmac);
+            free_sat_memory(*output_hmac);
             //set to NULL & zero size buffer
             *output_hmac = NULL;
             *output_hmac_size = 0;
@@ -519,7 +925,7 @@ char* compute_base16_string(const uint8_t* byte_array, const uint32_t byte_array
     if ((byte_array != NULL) && (byte_array_size > 0))
     {
         //create a 2n-character buffer to hold the hexadecimal string value of the n-byte data (adding 1 cell at the end for the nul character)
-        hex_string = malloc(((byte_array_size * 2) + 1) * (sizeof (char)));
+        hex_string = allocate_sat_memory(SAT_MEMORY_CRYPTO, ((byte_array_size * 2) + 1) * (sizeof (char)));
 
         //if the buffer was successfully created
         if (hex_string != NULL)
@@ -562,7 +968,7 @@ char* compute_text_string(const uint8_t* byte_array, const uint32_t byte_array_s
     if ((byte_array != NULL) && (byte_array_size > 0))
     {
         //create a character buffer to hold the string representation of the n-byte data (adding 1 cell at the end for the nul character)
-        text_string = malloc(((byte_array_size) + 1) * (sizeof (char)));
+        text_string = allocate_sat_memory(SAT_MEMORY_CRYPTO, ((byte_array_size) + 1) * (sizeof (char)));
 
         //if the buffer was successfully created
         if (text_string != NULL)
@@ -627,7 +1033,7 @@ bool compute_base64_encode(const uint8_t* byte_array, const uint32_t byte_array_
                 BIO_get_mem_ptr(memory_sink, &memory_buffer_handle);
 
                 //create a buffer to hold the base64 encoded string (adding 1 cell at the end for the nil character)
-                *output_base64_encoded_string = malloc(((memory_buffer_handle->length) + 1) * (sizeof (char)));
+                *output_base64_encoded_string = allocate_sat_memory(SAT_MEMORY_CRYPTO, ((memory_buffer_handle->length) + 1) * (sizeof (char)));
 
                 //if the buffer was successfully created
                 if (*output_base64_encoded_string != NULL)
@@ -687,7 +1093,7 @@ bool compute_base64_decode(const char* base64_encoded_string, uint8_t** output_b
             if (computed_output_byte_array_size > 0)
             {
                 //create byte buffer to hold decoded data
-                *output_byte_array = malloc(computed_output_byte_array_size * (sizeof (uint8_t)));
+                *output_byte_array = allocate_sat_memory(SAT_MEMORY_CRYPTO, computed_output_byte_array_size * (sizeof (uint8_t)));
 
                 //if the buffer was successfully created
                 if (*output_byte_array != NULL)
@@ -706,7 +1112,7 @@ bool compute_base64_decode(const char* base64_encoded_string, uint8_t** output_b
                     else //failure
                     {
                         //free buffer
-                        free(*output_byte_array);
+                        free_sat_memory(*output_byte_array);
                         //set to null to indicate failure
                         *output_byte_array = NULL;
                         *output_byte_array_size = 0;
@@ -775,3 +1181,67 @@ static int compute_base64_decode_byte_array_size(const char* base64_encoded_stri
     //return the computed length
     return computed_byte_array_size;
 }
+
+//function definition
+//returns the openssl cipher implementation for the supplied aead algorithm (or NULL if this openssl build doesn't provide it)
+static const EVP_CIPHER* get_aead_evp_cipher(AEAD_CIPHER cipher)
+{
+    switch (cipher)
+    {
+        case AES256GCM:
+            return EVP_aes_256_gcm();
+        case CHACHA20POLY1305:
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L) && !defined(OPENSSL_NO_CHACHA) && !defined(OPENSSL_NO_POLY1305)
+            return EVP_chacha20_poly1305();
+#else
+            return NULL;
+#endif
+    }
+
+    //no match
+    return NULL;
+}
+
+//function definition
+//derive the subkey for the supplied salt (hmac sha-256 of a fixed label followed by the salt, keyed with the sealing key) and put it in the cipher context
+static bool set_sealed_batch_subkey(SEALED_BATCH_CONTEXT* sbcontext, const uint8_t* salt)
+{
+    //local vars
+    bool operation_status = false;      //denotes success or failure of the operation
+    uint8_t message[sizeof (SEALED_BATCH_SUBKEY_DERIVATION_LABEL) - 1 + SEALED_BATCH_SALT_SIZE_BYTES];
+    uint8_t subkey[SEALED_BATCH_KEY_SIZE_BYTES];
+    unsigned int subkey_size = 0;       //size (in bytes) of the subkey
+
+    memcpy(message, SEALED_BATCH_SUBKEY_DERIVATION_LABEL, sizeof (SEALED_BATCH_SUBKEY_DERIVATION_LABEL) - 1);
+    memcpy(&(message[sizeof (SEALED_BATCH_SUBKEY_DERIVATION_LABEL) - 1]), salt, SEALED_BATCH_SALT_SIZE_BYTES);
+
+    //if the subkey was derived and the key schedule expanded from it
+    if ((HMAC(EVP_sha256(), sbcontext->sealing_key, SEALED_BATCH_KEY_SIZE_BYTES, message, sizeof (message), subkey, &subkey_size) != NULL) &&
+        (subkey_size == SEALED_BATCH_KEY_SIZE_BYTES) &&
+        (EVP_CipherInit_ex(sbcontext->cipher_context, NULL, NULL, subkey, NULL, -1) == OPENSSL_EVP_CIPHER_SUCCESS))
+    {
+        memcpy(sbcontext->key_salt, salt, SEALED_BATCH_SALT_SIZE_BYTES);
+
+        //success
+        operation_status = true;
+    }
+    else
+    {
+        //the cipher context no longer holds a known subkey
+        memset(sbcontext->key_salt, 0, SEALED_BATCH_SALT_SIZE_BYTES);
+        fprintf(stderr, "ERROR: FAILED TO DERIVE SEALED BATCH SUBKEY!\n");
+    }
+
+    //immediately zero-out the subkey (the cipher context holds its own expanded copy)
+    OPENSSL_cleanse(subkey, sizeof (subkey));
+
+    return operation_status;
+}
+
+//function definition
+//builds the 12-byte cipher iv for the batch with the supplied nonce, 4 zero bytes followed by the nonce's 8-byte batch counter (big endian)
+static void compute_sealed_batch_iv(const uint8_t* nonce, uint8_t* output_iv)
+{
+    memset(output_iv, 0, SEALED_BATCH_IV_SIZE_BYTES - SEALED_BATCH_COUNTER_SIZE_BYTES);
+    memcpy(&(output_iv[SEALED_BATCH_IV_SIZE_BYTES - SEALED_BATCH_COUNTER_SIZE_BYTES]), &(nonce[SEALED_BATCH_SALT_SIZE_BYTES]), SEALED_BATCH_COUNTER_SIZE_BYTES);
+}
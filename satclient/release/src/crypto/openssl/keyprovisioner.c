@@ -0,0 +1,617 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _GNU_SOURCE             //enable GNU extensions in unistd.h so we can use the "syscall" function
+
+#include <stdio.h>              //using for "printf" and "snprintf" functions
+#include <stdlib.h>             //using for "getenv" and "strtol" functions and "NULL"
+#include <string.h>             //using for "strlen", "strcmp", "memcpy", and "memcmp" functions
+#include <errno.h>              //using for "errno" and "ENOENT"
+#include <fcntl.h>              //using for "open" function
+#include <time.h>               //using for "clock_gettime" function
+#include <unistd.h>             //using for "read", "write", "close", "fsync", "unlink", and "syscall" functions
+#include <sys/syscall.h>        //using for "__NR_add_key", "__NR_request_key", and "__NR_keyctl" syscall numbers
+#include <linux/keyctl.h>       //using for "KEY_SPEC_..." and "KEYCTL_..." constants
+#include <openssl/rand.h>       //using for "RAND_bytes" function
+#include <openssl/crypto.h>     //using for "OPENSSL_cleanse" function
+#include "satmemory.h"          //using to free the buffers the crypto functions allocate
+#include "keyprovisioner.h"
+
+//global vars
+static const char PAYLOAD_FILE_ENV_NAME[] = "SATCLIENT_KEY_FILE";                       //environment variable holding the payload file location
+static const char PASSPHRASE_FD_ENV_NAME[] = "SATCLIENT_PASSPHRASE_FD";                 //environment variable holding the passphrase file descriptor number
+static const char PASSPHRASE_ENV_NAME[] = "SATCLIENT_PASSPHRASE";                       //environment variable holding the passphrase itself
+static const char KDF_ENV_NAME[] = "SATCLIENT_KDF";                                     //environment variable selecting the kdf ("bytestokey", "pbkdf2", or "scrypt")
+static const char KDF_COST_ENV_NAME[] = "SATCLIENT_KDF_COST";                           //environment variable overriding the kdf cost
+static const char KEY_CACHE_ENV_NAME[] = "SATCLIENT_KEY_CACHE";                         //environment variable holding the sealed derived key cache file location
+static const char NONINTERACTIVE_ENV_NAME[] = "SATCLIENT_NONINTERACTIVE";               //if set, never prompt on stdin
+static const char PASSPHRASE_KEYRING_DESCRIPTION[] = "satclient:passphrase";            //kernel keyring "user" key holding the passphrase
+static const char CACHE_KEY_KEYRING_DESCRIPTION[] = "satclient:derived-key-cache";      //kernel keyring "user" key holding the random key that seals the derived key cache
+static const uint32_t DEFAULT_PBKDF2_ITERATION_COUNT = 100000;                          //default pbkdf2 cost
+static const uint32_t DEFAULT_SCRYPT_LOG2_N = 14;                                       //default scrypt cost (N = 16384, r = 8 -> 16 MiB, inside openssl's default 32 MiB ceiling)
+static const char DERIVED_KEY_CACHE_MAGIC[8] = {'S', 'A', 'T', 'K', 'C', '0', '0', '2'};  //signature that begins a derived key cache file
+#define MAX_PASSPHRASE_SIZE_BYTES 1024                                                  //longest passphrase accepted from any source
+#define CACHE_KEY_SIZE_BYTES SEALED_BATCH_KEY_SIZE_BYTES                                //size (in bytes) of the key sealing the cache
+#define AES256_KEY_SIZE_BYTES 32                                                        //size (in bytes) of the aes-256-cfb key
+#define DERIVED_KEY_AND_IV_SIZE_BYTES 48                                                //aes-256 key (32) + cfb iv (16)
+#define OPENSSL_SALT_VALUE_SIZE_BYTES 8                                                 //size (in bytes) of the openssl salt value
+/*
+    Derived key cache file layout (all integers big endian):
+    [0..7]   magic
+    [8]      kdf
+    [9]      aead cipher used to seal the cache
+    [10..13] kdf cost
+    [14..21] payload salt
+    -- bytes 0..21 form the header, authenticated (not encrypted) so a changed payload, kdf, or cost invalidates the cache --
+    [22..45] nonce (salt + counter)
+    [46..61] tag
+    [62..109] sealed key and iv
+*/
+#define DERIVED_KEY_CACHE_HEADER_SIZE_BYTES 22
+#define DERIVED_KEY_CACHE_FILE_SIZE_BYTES (DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES + SEALED_BATCH_TAG_SIZE_BYTES + DERIVED_KEY_AND_IV_SIZE_BYTES)
+
+//function declarations
+static bool obtain_passphrase(const KEY_PROVISIONING_CONFIG*, uint8_t*, uint32_t*);
+static bool read_passphrase_from_fd(int, bool, uint8_t*, uint32_t*, bool*);
+static bool read_user_key_from_keyring(const char*, uint8_t*, const uint32_t, uint32_t*, bool*);
+static bool obtain_derived_key_cache_key(bool, uint8_t*);
+static void build_derived_key_cache_header(const KEY_PROVISIONING_CONFIG*, AEAD_CIPHER, const uint8_t*, uint8_t*);
+static bool load_derived_key_and_iv_from_cache(const KEY_PROVISIONING_CONFIG*, const uint8_t*, uint8_t*);
+static bool store_derived_key_and_iv_in_cache(const KEY_PROVISIONING_CONFIG*, const uint8_t*, const uint8_t*);
+static double get_monotonic_ms(void);
+
+//function definition
+//fill the key provisioning config from the process environment (unset variables fall back to the interactive defaults of earlier releases)
+void load_key_provisioning_config_from_environment(KEY_PROVISIONING_CONFIG* config)
+{
+    //local vars
+    const char* env_value;      //value of a particular environment variable
+
+    //check input
+    if (config != NULL)
+    {
+        config->payload_file_location = getenv(PAYLOAD_FILE_ENV_NAME);
+        config->passphrase_fd = ((env_value = getenv(PASSPHRASE_FD_ENV_NAME)) != NULL) ? (int)strtol(env_value, NULL, 10) : -1;
+        config->passphrase_env_name = PASSPHRASE_ENV_NAME;
+        config->passphrase_keyring_description = PASSPHRASE_KEYRING_DESCRIPTION;
+        config->derived_key_cache_location = getenv(KEY_CACHE_ENV_NAME);
+        config->allow_interactive_prompt = (getenv(NONINTERACTIVE_ENV_NAME) == NULL);
+
+        //select the kdf, payloads created by plain "openssl enc" use the single round derivation
+        env_value = getenv(KDF_ENV_NAME);
+        if ((env_value != NULL) && (strcmp(env_value, "pbkdf2") == 0))
+        {
+            config->kdf = PBKDF2_SHA256;
+            config->kdf_cost = DEFAULT_PBKDF2_ITERATION_COUNT;
+        }
+        else if ((env_value != NULL) && (strcmp(env_value, "scrypt") == 0))
+        {
+            config->kdf = SCRYPT;
+            config->kdf_cost = DEFAULT_SCRYPT_LOG2_N;
+        }
+        else
+        {
+            config->kdf = OPENSSL_BYTESTOKEY;
+            config->kdf_cost = 1;
+        }
+
+        //override the cost if requested
+        env_value = getenv(KDF_COST_ENV_NAME);
+        if ((env_value != NULL) && (strtol(env_value, NULL, 10) > 0))
+        {
+            config->kdf_cost = (uint32_t)strtol(env_value, NULL, 10);
+        }
+    }
+}
+
+//function definition
+/*
+    Load and decrypt the secret key held in the configured openssl payload without user interaction (unless allowed as a last resort).
+    Warm start: the key and iv derived on a previous run are unsealed from the cache file using a random cache key kept in the kernel
+    user keyring, so the (deliberately slow) kdf is skipped. The keyring doesn't survive a reboot, so the first start after boot is always
+    cold. Cold start: the passphrase is read from the configured fd, environment variable, or keyring (in that order), the kdf is run, and
+    the result is sealed into the cache for the next start. The report (optional) records which path was taken and how long it took.
+*/
+bool provision_secret_key(const KEY_PROVISIONING_CONFIG* config, uint8_t** output_plaintext, uint32_t* output_plaintext_size, KEY_PROVISIONING_REPORT* report)
+{
+    //local vars
+    bool operation_status = false;                          //denotes success or failure of the operation
+    bool warm_start = false;                                //denotes the key and iv came from the cache
+    bool key_and_iv_available = false;                      //denotes the key and iv were unsealed (warm) or derived (cold)
+    double start_ms;                                        //provisioning start time
+    double elapsed_ms;                                      //provisioning duration
+    char* base64_encoded_openssl_payload = NULL;            //handle to base64 encoded openssl payload (i.e., salt header + ciphertext)
+    uint8_t* openssl_payload;                               //handle to binary openssl payload
+    uint32_t openssl_payload_size;                          //size (in bytes) of openssl_payload
+    uint8_t* openssl_payload_salt;                          //handle to salt extracted from openssl_payload
+    uint32_t openssl_payload_salt_size;                     //size (in bytes) of openssl_payload_salt
+    uint8_t* openssl_payload_ciphertext;                    //handle to ciphertext extracted from openssl_payload
+    uint32_t openssl_payload_ciphertext_size;               //size (in bytes) of openssl_payload_ciphertext
+    uint8_t key_and_iv[DERIVED_KEY_AND_IV_SIZE_BYTES];      //derived key followed by iv
+    uint8_t passphrase[MAX_PASSPHRASE_SIZE_BYTES];          //passphrase (cold start only)
+    uint32_t passphrase_size;                               //size (in bytes) of passphrase
+    uint8_t* cipher_key;                                    //handle to derived key (cold start only)
+    uint32_t cipher_key_size;                               //size (in bytes) of cipher_key
+    uint8_t* cipher_iv;                                     //handle to derived iv (cold start only)
+    uint32_t cipher_iv_size;                                //size (in bytes) of cipher_iv
+
+    //check inputs
+    if ((config != NULL) && (output_plaintext != NULL) && (output_plaintext_size != NULL))
+    {
+        //start the clock
+        start_ms = get_monotonic_ms();
+
+        //load the payload from the configured location (or ask for it as a last resort)
+        if (config->payload_file_location != NULL)
+        {
+            load_base64_encoded_openssl_payload_from_file(config->payload_file_location, &base64_encoded_openssl_payload);
+        }
+        else if (config->allow_interactive_prompt)
+        {
+            load_base64_encoded_openssl_payload(&base64_encoded_openssl_payload);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: NO BASE64 ENCODED OPENSSL PAYLOAD FILE CONFIGURED (SET %s)!\n", PAYLOAD_FILE_ENV_NAME);
+        }
+
+        //if the payload was loaded, base64 decoded, and split into salt and ciphertext
+        if ((base64_encoded_openssl_payload != NULL) && compute_base64_decode(base64_encoded_openssl_payload, &openssl_payload, &openssl_payload_size))
+        {
+            if (extract_salt_and_ciphertext_from_openssl_payload(openssl_payload, openssl_payload_size, &openssl_payload_salt, &openssl_payload_salt_size, &openssl_payload_ciphertext, &openssl_payload_ciphertext_size))
+            {
+                //warm start - try the cache first
+                if (config->derived_key_cache_location != NULL)
+                {
+                    warm_start = load_derived_key_and_iv_from_cache(config, openssl_payload_salt, key_and_iv);
+                    key_and_iv_available = warm_start;
+                }
+
+                //cold start - obtain the passphrase and run the kdf
+                if (!warm_start)
+                {
+                    if (obtain_passphrase(config, passphrase, &passphrase_size))
+                    {
+                        if (derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(config->kdf, config->kdf_cost, passphrase, passphrase_size, openssl_payload_salt, openssl_payload_salt_size, &cipher_key, &cipher_key_size, &cipher_iv, &cipher_iv_size))
+                        {
+                            //if the key and iv are the expected size, gather them in one place
+                            if ((cipher_key_size + cipher_iv_size) == DERIVED_KEY_AND_IV_SIZE_BYTES)
+                            {
+                                memcpy(key_and_iv, cipher_key, cipher_key_size);
+                                memcpy(&(key_and_iv[cipher_key_size]), cipher_iv, cipher_iv_size);
+                                key_and_iv_available = true;
+
+                                //seal the result for the next start (failure here only costs the next start a kdf run)
+                                if (config->derived_key_cache_location != NULL)
+                                {
+                                    store_derived_key_and_iv_in_cache(config, openssl_payload_salt, key_and_iv);
+                                }
+                            }
+
+                            //zero-out and free buffers
+                            OPENSSL_cleanse(cipher_key, cipher_key_size);
+                            OPENSSL_cleanse(cipher_iv, cipher_iv_size);
+                            free_sat_memory(cipher_key);
+                            free_sat_memory(cipher_iv);
+                        }
+                        else
+                        {
+                            fprintf(stderr, "ERROR: FAILED TO DERIVE CIPHER KEY & IV FROM ENCRYPTION PASSPHRASE & SALT!\n");
+                        }
+
+                        //immediately zero-out the passphrase
+                        OPENSSL_cleanse(passphrase, sizeof (passphrase));
+                    }
+                    else
+                    {
+                        fprintf(stderr, "ERROR: FAILED TO OBTAIN ENCRYPTION PASSPHRASE FROM ANY CONFIGURED SOURCE!\n");
+                    }
+                }
+
+                //if the key and iv were obtained (warm) or derived (cold), decrypt the payload
+                if (key_and_iv_available &&
+                    compute_aes256cfb_cipher(DECRYPT, key_and_iv, AES256_KEY_SIZE_BYTES, &(key_and_iv[AES256_KEY_SIZE_BYTES]), (DERIVED_KEY_AND_IV_SIZE_BYTES - AES256_KEY_SIZE_BYTES), openssl_payload_ciphertext, openssl_payload_ciphertext_size, output_plaintext, output_plaintext_size))
+                {
+                    //ensure a line feed '\n' character (hex = "0x0a") isn't present at the end of the byte string, if so zero it out
+                    if ((*output_plaintext_size > 0) && ((*output_plaintext)[*output_plaintext_size - 1] == 0x0a))
+                    {
+                        (*output_plaintext)[*output_plaintext_size - 1] = 0;
+                        (*output_plaintext_size)--;
+                    }
+
+                    //a line feed alone leaves no secret key, free the plaintext here (the caller only gets a buffer on success)
+                    if (*output_plaintext_size > 0)
+                    {
+                        //success
+                        operation_status = true;
+                    }
+                    else
+                    {
+                        fprintf(stderr, "ERROR: DECRYPTED SECRET KEY IS EMPTY!\n");
+                        free_sat_memory(*output_plaintext);
+                        *output_plaintext = NULL;
+                    }
+                }
+
+                //immediately zero-out the key and iv
+                OPENSSL_cleanse(key_and_iv, sizeof (key_and_iv));
+
+                //free buffers
+                free_sat_memory(openssl_payload_salt);
+                free_sat_memory(openssl_payload_ciphertext);
+            }
+
+            //free buffer
+            free_sat_memory(openssl_payload);
+        }
+
+        //free buffer
+        free_sat_memory(base64_encoded_openssl_payload);
+
+        //report how the key was obtained and how long it took
+        elapsed_ms = get_monotonic_ms() - start_ms;
+        printf("Key provisioning (%s start): %.3f ms\n", (warm_start ? "warm" : "cold"), elapsed_ms);
+        if (report != NULL)
+        {
+            report->warm_start = warm_start;
+            report->elapsed_ms = elapsed_ms;
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//remove the sealed derived key cache file so the next start is cold (e.g., after rotating the passphrase)
+bool invalidate_derived_key_cache(const KEY_PROVISIONING_CONFIG* config)
+{
+    //check input
+    if ((config != NULL) && (config->derived_key_cache_location != NULL))
+    {
+        //a missing cache is already invalid
+        if ((unlink(config->derived_key_cache_location) == 0) || (errno == ENOENT))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//obtain the passphrase from the first configured source that supplies one (fd, environment, keyring, then stdin if allowed)
+//a passphrase longer than MAX_PASSPHRASE_SIZE_BYTES is an error (rather than cut short, which would derive a different key, or skipped for the next source)
+static bool obtain_passphrase(const KEY_PROVISIONING_CONFIG* config, uint8_t* passphrase, uint32_t* passphrase_size)
+{
+    //local vars
+    char* env_value;            //value of the passphrase environment variable
+    size_t env_value_size;      //size (in bytes) of the passphrase environment variable
+    bool is_too_long = false;   //denotes the source supplied a passphrase longer than we accept
+
+    //file descriptor (e.g., a pipe or memfd handed over by a provisioning agent), closed once read
+    if ((config->passphrase_fd >= 0) && read_passphrase_from_fd(config->passphrase_fd, true, passphrase, passphrase_size, &is_too_long))
+    {
+        return true;
+    }
+    if (is_too_long)
+    {
+        fprintf(stderr, "ERROR: PASSPHRASE READ FROM FD %d IS LONGER THAN %u BYTES!\n", config->passphrase_fd, (unsigned int)MAX_PASSPHRASE_SIZE_BYTES);
+        return false;
+    }
+
+    //environment variable, unset once read so child processes don't inherit it
+    if ((config->passphrase_env_name != NULL) && ((env_value = getenv(config->passphrase_env_name)) != NULL))
+    {
+        env_value_size = strlen(env_value);
+
+        if (env_value_size > MAX_PASSPHRASE_SIZE_BYTES)
+        {
+            OPENSSL_cleanse(env_value, env_value_size);
+            unsetenv(config->passphrase_env_name);
+            fprintf(stderr, "ERROR: PASSPHRASE IN %s IS LONGER THAN %u BYTES!\n", config->passphrase_env_name, (unsigned int)MAX_PASSPHRASE_SIZE_BYTES);
+            return false;
+        }
+
+        if (env_value_size > 0)
+        {
+            *passphrase_size = (uint32_t)env_value_size;
+            memcpy(passphrase, env_value, *passphrase_size);
+            OPENSSL_cleanse(env_value, *passphrase_size);
+            unsetenv(config->passphrase_env_name);
+            return true;
+        }
+    }
+
+    //kernel keyring (e.g., "keyctl padd user satclient:passphrase @u")
+    if ((config->passphrase_keyring_description != NULL) && read_user_key_from_keyring(config->passphrase_keyring_description, passphrase, MAX_PASSPHRASE_SIZE_BYTES, passphrase_size, &is_too_long))
+    {
+        return true;
+    }
+    if (is_too_long)
+    {
+        fprintf(stderr, "ERROR: PASSPHRASE IN KERNEL KEYRING KEY %s IS LONGER THAN %u BYTES!\n", config->passphrase_keyring_description, (unsigned int)MAX_PASSPHRASE_SIZE_BYTES);
+        return false;
+    }
+
+    //last resort - ask (stdin stays open)
+    if (config->allow_interactive_prompt)
+    {
+        printf("Enter the passphrase used to encrypt the openssl payload the file: ");
+        fflush(stdout);
+
+        if (read_passphrase_from_fd(STDIN_FILENO, false, passphrase, passphrase_size, &is_too_long))
+        {
+            return true;
+        }
+        if (is_too_long)
+        {
+            fprintf(stderr, "ERROR: PASSPHRASE ENTERED IS LONGER THAN %u BYTES!\n", (unsigned int)MAX_PASSPHRASE_SIZE_BYTES);
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//read a passphrase (terminated by a line feed or end of file) from the supplied file descriptor without buffering past the line feed
+//a line longer than MAX_PASSPHRASE_SIZE_BYTES is consumed in full but yields no passphrase (is_too_long is set)
+static bool read_passphrase_from_fd(int fd, bool close_fd_when_done, uint8_t* passphrase, uint32_t* passphrase_size, bool* is_too_long)
+{
+    //local vars
+    ssize_t read_return_value;  //return value of the read function
+    uint8_t byte;               //byte read
+
+    *passphrase_size = 0;
+    *is_too_long = false;
+
+    //read a byte at a time so nothing after the line feed is consumed (the fd may be stdin)
+    while (((read_return_value = read(fd, &byte, 1)) == 1) && (byte != '\n'))
+    {
+        if (*passphrase_size < MAX_PASSPHRASE_SIZE_BYTES)
+        {
+            passphrase[(*passphrase_size)++] = byte;
+        }
+        else
+        {
+            *is_too_long = true;
+        }
+    }
+
+    //close the fd if it was handed to us solely for this purpose
+    if (close_fd_when_done)
+    {
+        close(fd);
+    }
+
+    //a passphrase that didn't fit is of no use (cut short it would derive a different key)
+    if (*is_too_long)
+    {
+        OPENSSL_cleanse(passphrase, *passphrase_size);
+        *passphrase_size = 0;
+        return false;
+    }
+
+    //a read error or an empty line yields no passphrase
+    return ((read_return_value >= 0) && (*passphrase_size > 0));
+}
+
+//function definition
+//read the payload of a "user" key from the kernel keyrings visible to this process (thread, process, session, then the user keyring)
+//a payload larger than the output buffer yields nothing (is_too_large is set)
+static bool read_user_key_from_keyring(const char* description, uint8_t* output_buffer, const uint32_t output_buffer_size, uint32_t* output_size, bool* is_too_large)
+{
+    //local vars
+    long key_serial;    //serial number of the key
+    long key_size;      //size (in bytes) of the key payload
+
+    *is_too_large = false;
+
+    //search the process' keyrings (request_key won't upcall without callout info)
+    key_serial = syscall(__NR_request_key, "user", description, NULL, 0);
+
+    //not found there, search the user keyring explicitly (it isn't always linked into the session keyring, e.g., under a service manager)
+    if (key_serial < 0)
+    {
+        key_serial = syscall(__NR_keyctl, KEYCTL_SEARCH, KEY_SPEC_USER_KEYRING, "user", description, 0);
+    }
+
+    //if the key was found
+    if (key_serial >= 0)
+    {
+        //read its payload (returns the full payload size even if the buffer is smaller)
+        key_size = syscall(__NR_keyctl, KEYCTL_READ, key_serial, output_buffer, output_buffer_size);
+
+        if ((key_size > 0) && (key_size <= output_buffer_size))
+        {
+            *output_size = (uint32_t)key_size;
+            return true;
+        }
+
+        //the buffer holds the start of a payload too large for it
+        if (key_size > output_buffer_size)
+        {
+            OPENSSL_cleanse(output_buffer, output_buffer_size);
+            *is_too_large = true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//obtain the random key that seals the derived key cache from the kernel user keyring, optionally creating it if it doesn't exist yet
+static bool obtain_derived_key_cache_key(bool create_if_missing, uint8_t* cache_key)
+{
+    //local vars
+    uint32_t cache_key_size;    //size (in bytes) of the key read from the keyring
+    bool is_too_large;          //unused, a key of the wrong size is replaced when a fresh one is created
+
+    //if the key already exists
+    if (read_user_key_from_keyring(CACHE_KEY_KEYRING_DESCRIPTION, cache_key, CACHE_KEY_SIZE_BYTES, &cache_key_size, &is_too_large) && (cache_key_size == CACHE_KEY_SIZE_BYTES))
+    {
+        return true;
+    }
+
+    //generate a fresh key and place it in the user keyring (lives until reboot or until the user's keyring is purged)
+    if (create_if_missing && (RAND_bytes(cache_key, CACHE_KEY_SIZE_BYTES) == 1))
+    {
+        if (syscall(__NR_add_key, "user", CACHE_KEY_KEYRING_DESCRIPTION, cache_key, CACHE_KEY_SIZE_BYTES, KEY_SPEC_USER_KEYRING) >= 0)
+        {
+            return true;
+        }
+
+        fprintf(stderr, "WARNING: FAILED TO ADD DERIVED KEY CACHE KEY TO KERNEL KEYRING, CACHE DISABLED!\n");
+    }
+
+    //failure
+    OPENSSL_cleanse(cache_key, CACHE_KEY_SIZE_BYTES);
+    return false;
+}
+
+//function definition
+//build the authenticated cache header binding the sealed key and iv to this payload's salt and the kdf settings
+static void build_derived_key_cache_header(const KEY_PROVISIONING_CONFIG* config, AEAD_CIPHER cipher, const uint8_t* salt, uint8_t* header)
+{
+    memcpy(header, DERIVED_KEY_CACHE_MAGIC, sizeof (DERIVED_KEY_CACHE_MAGIC));
+    header[8] = (uint8_t)config->kdf;
+    header[9] = (uint8_t)cipher;
+    header[10] = (uint8_t)(config->kdf_cost >> 24);
+    header[11] = (uint8_t)(config->kdf_cost >> 16);
+    header[12] = (uint8_t)(config->kdf_cost >> 8);
+    header[13] = (uint8_t)(config->kdf_cost);
+    memcpy(&(header[14]), salt, OPENSSL_SALT_VALUE_SIZE_BYTES);
+}
+
+//function definition
+//unseal the cached key and iv, fails (forcing a cold start) if the cache is missing, stale, tampered with, or its key is no longer in the keyring
+static bool load_derived_key_and_iv_from_cache(const KEY_PROVISIONING_CONFIG* config, const uint8_t* salt, uint8_t* key_and_iv)
+{
+    //local vars
+    bool operation_status = false;                          //denotes success or failure of the operation
+    uint8_t cache_file_content[DERIVED_KEY_CACHE_FILE_SIZE_BYTES];
+    uint8_t expected_header[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES];
+    uint8_t cache_key[CACHE_KEY_SIZE_BYTES];
+    SEALED_BATCH_CONTEXT sbcontext;
+    int fd;                                                 //cache file descriptor
+    ssize_t read_return_value;                              //return value of the read function
+
+    //read the whole cache file
+    fd = open(config->derived_key_cache_location, O_RDONLY);
+    if (fd >= 0)
+    {
+        read_return_value = read(fd, cache_file_content, sizeof (cache_file_content));
+        close(fd);
+
+        //the whole file must have been read (before its header is looked at)
+        if (read_return_value == DERIVED_KEY_CACHE_FILE_SIZE_BYTES)
+        {
+            //the header must match this payload and configuration exactly (checked before touching the keyring)
+            build_derived_key_cache_header(config, (AEAD_CIPHER)cache_file_content[9], salt, expected_header);
+
+            if (memcmp(cache_file_content, expected_header, DERIVED_KEY_CACHE_HEADER_SIZE_BYTES) == 0)
+            {
+                //if the cache key is still in the keyring
+                if (obtain_derived_key_cache_key(false, cache_key))
+                {
+                    if (init_sealed_batch_context(&sbcontext, (AEAD_CIPHER)cache_file_content[9], cache_key, CACHE_KEY_SIZE_BYTES))
+                    {
+                        //unseal in place, the header is the additional authenticated data
+                        if (open_sealed_telemetry_batch(&sbcontext, cache_file_content, DERIVED_KEY_CACHE_HEADER_SIZE_BYTES, &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES + SEALED_BATCH_TAG_SIZE_BYTES]), DERIVED_KEY_AND_IV_SIZE_BYTES, &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES]), &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES])))
+                        {
+                            memcpy(key_and_iv, &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES + SEALED_BATCH_TAG_SIZE_BYTES]), DERIVED_KEY_AND_IV_SIZE_BYTES);
+
+                            //success
+                            operation_status = true;
+                        }
+
+                        shutdown_sealed_batch_context(&sbcontext);
+                    }
+
+                    OPENSSL_cleanse(cache_key, sizeof (cache_key));
+                }
+            }
+        }
+
+        //immediately zero-out the (possibly unsealed) file content
+        OPENSSL_cleanse(cache_file_content, sizeof (cache_file_content));
+    }
+
+    return operation_status;
+}
+
+//function definition
+//seal the derived key and iv and atomically replace the cache file (owner read/write only)
+static bool store_derived_key_and_iv_in_cache(const KEY_PROVISIONING_CONFIG* config, const uint8_t* salt, const uint8_t* key_and_iv)
+{
+    //local vars
+    bool operation_status = false;                          //denotes success or failure of the operation
+    uint8_t cache_file_content[DERIVED_KEY_CACHE_FILE_SIZE_BYTES];
+    uint8_t cache_key[CACHE_KEY_SIZE_BYTES];
+    char temporary_location[4096];                          //cache is written here first then renamed over the real location
+    SEALED_BATCH_CONTEXT sbcontext;
+    AEAD_CIPHER cipher;                                     //algorithm sealing the cache
+    int fd;                                                 //cache file descriptor
+
+    //if the cache key could be obtained (or created) and the temporary location formed
+    if (obtain_derived_key_cache_key(true, cache_key) && (snprintf(temporary_location, sizeof (temporary_location), "%s.tmp", config->derived_key_cache_location) < (int)sizeof (temporary_location)))
+    {
+        cipher = get_preferred_aead_cipher();
+
+        if (init_sealed_batch_context(&sbcontext, cipher, cache_key, CACHE_KEY_SIZE_BYTES))
+        {
+            //build the header and copy the key and iv into place, then seal them in place
+            build_derived_key_cache_header(config, cipher, salt, cache_file_content);
+            memcpy(&(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES + SEALED_BATCH_TAG_SIZE_BYTES]), key_and_iv, DERIVED_KEY_AND_IV_SIZE_BYTES);
+
+            if (seal_telemetry_batch(&sbcontext, cache_file_content, DERIVED_KEY_CACHE_HEADER_SIZE_BYTES, &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES + SEALED_BATCH_TAG_SIZE_BYTES]), DERIVED_KEY_AND_IV_SIZE_BYTES, &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES]), &(cache_file_content[DERIVED_KEY_CACHE_HEADER_SIZE_BYTES + SEALED_BATCH_NONCE_SIZE_BYTES])))
+            {
+                //write the temporary file, flush it to storage, then rename it over the cache so readers never see a partial file
+                fd = open(temporary_location, (O_WRONLY | O_CREAT | O_TRUNC), 0600);
+                if (fd >= 0)
+                {
+                    if ((write(fd, cache_file_content, sizeof (cache_file_content)) == sizeof (cache_file_content)) && (fsync(fd) == 0))
+                    {
+                        operation_status = (rename(temporary_location, config->derived_key_cache_location) == 0);
+                    }
+
+                    close(fd);
+
+                    //clean up the temporary file on failure
+                    if (!operation_status)
+                    {
+                        unlink(temporary_location);
+                    }
+                }
+            }
+
+            shutdown_sealed_batch_context(&sbcontext);
+        }
+
+        OPENSSL_cleanse(cache_key, sizeof (cache_key));
+    }
+
+    if (!operation_status)
+    {
+        fprintf(stderr, "WARNING: FAILED TO WRITE DERIVED KEY CACHE, NEXT START WILL BE COLD!\n");
+    }
+
+    return operation_status;
+}
+
+//function definition
+//returns the monotonic clock in milliseconds
+static double get_monotonic_ms(void)
+{
+    //local vars
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((double)now.tv_sec * 1e3) + ((double)now.tv_nsec / 1e6);
+}
@@ -3,26 +3,40 @@
    Repo: https://github.com/embeddedcognition/satclient
 */
 
+#include <time.h>           //using for "clock_gettime" function
+#include <math.h>           //using for "fabs" function
 #include "lsm9ds0.h"
 #include "lsm9ds0_private.h"
+#include "metrics.h"        //using for "increment_metrics_counter" function
+#include "trace.h"          //using for "TRACE_INSTANT" macro
 
 //function definition
-//init the lsm9ds0 board (the sensors on this specific integrated circuit)
+//init the lsm9ds0 board (the sensors on this specific integrated circuit) at its default bus and addresses
 bool init_lsm9ds0(LSM9DS0* lsm)
+{
+    return init_lsm9ds0_at_address(lsm, LSM9DS0_DEFAULT_I2C_BUS, LSM9DS0_GYRO_ADDRESS, LSM9DS0_ACCEL_MAGNETO_ADDRESS);
+}
+
+//function definition
+//init the lsm9ds0 board on the supplied i2c bus, with its gyro and accel/magneto at the supplied addresses (e.g. the alternate SA0 addresses, so two boards share a bus)
+bool init_lsm9ds0_at_address(LSM9DS0* lsm, int i2c_bus, uint8_t gyro_address, uint8_t accel_magneto_address)
 {
     //check input
     if (lsm != NULL)
     {
         //if the i2c device connections were successfully initialized
-        if (init_i2c_device(&(lsm->accel_magneto_i2c_device), I2C_BUS, ACCEL_MAGNETO_ADDR) && init_i2c_device(&(lsm->gyro_i2c_device), I2C_BUS, GYRO_ADDR))
+        if (init_i2c_device(&(lsm->accel_magneto_i2c_device), i2c_bus, accel_magneto_address) && init_i2c_device(&(lsm->gyro_i2c_device), i2c_bus, gyro_address))
         {
-            //if the sensors were successfully initialized
-            if (init_gyro(&(lsm->gyro_i2c_device)) && init_accel(&(lsm->accel_magneto_i2c_device)) && init_magneto(&(lsm->accel_magneto_i2c_device)))
+            //get the default configuration (the rate, bandwidth, and full scale range of each sensor)
+            get_default_lsm9ds0_config(&(lsm->config));
+
+            //if the sensors were successfully initialized and configured (which also sets the scale factors)
+            if (init_gyro(&(lsm->gyro_i2c_device)) && init_accel(&(lsm->accel_magneto_i2c_device)) && init_magneto(&(lsm->accel_magneto_i2c_device)) &&
+                configure_lsm9ds0(lsm, &(lsm->config)))
             {
-                //get scale factor (based on FSR sensitivity) to apply to raw signal reading
-                lsm->gyro_scale_factor = get_fsr_scale_factor(GYRO_FSR_245DPS);
-                lsm->accel_scale_factor = get_fsr_scale_factor(ACCEL_FSR_2G);
-                lsm->magneto_scale_factor = get_fsr_scale_factor(MAGNETO_FSR_2GS);
+                //pick the conversion kernel once, rather than on every buffer
+                lsm->conversion_kernel = get_preferred_raw_signal_conversion_kernel();
+                lsm->overrun_count = 0;
 
                 //success
                 return true;
@@ -54,15 +68,13 @@ static bool init_gyro(I2C_DEVICE* device)
     if (device != NULL)
     {
         //if the bit fields were successfully set
-        //CTRL_REG1_G - set output data rate of 95hz & 12.5 cutoff 0000=0, normal mode and xyz enabled 1111=F
+        //CTRL_REG1_G - output data rate, cutoff, and power mode (set by configure_lsm9ds0)
         //CTRL_REG2_G - defaults
         //CTRL_REG3_G - defaults
-        //CTRL_REG4_G - defaults
+        //CTRL_REG4_G - full scale range (set by configure_lsm9ds0)
         //CTRL_REG5_G - defaults
-        if (write_byte(device, CTRL_REG1_G, 0x0F) &&
-            write_byte(device, CTRL_REG2_G, 0x00) &&
+        if (write_byte(device, CTRL_REG2_G, 0x00) &&
             write_byte(device, CTRL_REG3_G, 0x00) &&
-            write_byte(device, CTRL_REG4_G, 0x00) &&
             write_byte(device, CTRL_REG5_G, 0x00))
         {
             //success
@@ -83,12 +95,10 @@ static bool init_accel(I2C_DEVICE* device)
     {
         //if the bit fields were successfully set
         //CTRL_REG0_XM - defaults
-        //CTRL_REG1_XM - set output data rate of 100hz 0110=6, continuous update and xyz enabled 0111=7
-        //CTRL_REG2_XM - set anti-alias filter to 773hz 00, acceleration full scale to 2g 000, self-test to normal 00, serial interface to 4-wire 0 (default)
+        //CTRL_REG1_XM - output data rate, continuous update, and xyz enabled (set by configure_lsm9ds0)
+        //CTRL_REG2_XM - anti-alias filter and full scale range (set by configure_lsm9ds0), self-test to normal, serial interface to 4-wire
         //CTRL_REG3_XM - don't set interrupts
         if (write_byte(device, CTRL_REG0_XM, 0x00) &&
-            write_byte(device, CTRL_REG1_XM, 0x67) &&
-            write_byte(device, CTRL_REG2_XM, 0x00) &&
             write_byte(device, CTRL_REG3_XM, 0x00))
         {
             //success
@@ -109,12 +119,10 @@ static bool init_magneto(I2C_DEVICE* device)
     {
         //if the bit fields were successfully set
         //CTRL_REG4_XM - don't set interrupts
-        //CTRL_REG5_XM - set temperature sensor to off 0, resolution to high 11, output data rate to 100hz 101, don't set interrupts 00 -> 0111=7, 0100=4
-        //CTRL_REG6_XM - set to +-2 gauss
+        //CTRL_REG5_XM - temperature sensor, resolution, and output data rate (set by configure_lsm9ds0)
+        //CTRL_REG6_XM - full scale range (set by configure_lsm9ds0)
         //CTRL_REG7_XM - defaults
         if (write_byte(device, CTRL_REG4_XM, 0x00) &&
-            write_byte(device, CTRL_REG5_XM, 0x74) &&
-            write_byte(device, CTRL_REG6_XM, 0x00) &&
             write_byte(device, CTRL_REG7_XM, 0x00))
         {
             //success
@@ -126,6 +134,137 @@ static bool init_magneto(I2C_DEVICE* device)
     return false;
 }
 
+//function definition
+//get the default configuration - gyro 95hz (12.5hz cutoff) +-245dps, accel 100hz (773hz anti-alias) +-2g, magneto 100hz +-2 gauss
+void get_default_lsm9ds0_config(LSM9DS0_CONFIG* config)
+{
+    //check input
+    if (config != NULL)
+    {
+        config->gyro.odr_hz = 95.0;
+        config->gyro.bandwidth_hz = 12.5;
+        config->gyro.fsr = 245.0;
+        config->accel.odr_hz = 100.0;
+        config->accel.bandwidth_hz = 773.0;
+        config->accel.fsr = 2.0;
+        config->magneto.odr_hz = 100.0;
+        config->magneto.bandwidth_hz = 0.0;
+        config->magneto.fsr = 2.0;
+    }
+}
+
+//function definition
+//program each sensor's output data rate, bandwidth, and full scale range, and recompute the scale factors to match
+//(fails, leaving the board as it was, if any value isn't one the sensor supports - see lsm9ds0.h)
+//note: values in raw units already handed out (e.g. the gyro threshold interrupt's, or calibration offsets) are tied to the full scale range they were computed at
+bool configure_lsm9ds0(LSM9DS0* lsm, const LSM9DS0_CONFIG* config)
+{
+    //local vars
+    uint8_t gyro_odr;
+    uint8_t gyro_bandwidth = 0;     //lowest cutoff for the rate by default
+    uint8_t gyro_fsr;
+    uint8_t accel_odr;
+    uint8_t accel_bandwidth = 0;    //773hz by default
+    uint8_t accel_fsr;
+    uint8_t magneto_odr;
+    uint8_t magneto_fsr;
+
+    //check inputs
+    if ((lsm == NULL) || (config == NULL))
+    {
+        return false;
+    }
+
+    //find each value's bit field encoding
+    if (!(find_config_value(GYRO_ODRS, sizeof (GYRO_ODRS) / sizeof (double), config->gyro.odr_hz, &gyro_odr) &&
+          ((config->gyro.bandwidth_hz == 0.0) || find_config_value(GYRO_BANDWIDTHS[gyro_odr], 4, config->gyro.bandwidth_hz, &gyro_bandwidth)) &&
+          find_config_value(GYRO_FSRS, sizeof (GYRO_FSRS) / sizeof (double), config->gyro.fsr, &gyro_fsr) &&
+          find_config_value(ACCEL_ODRS, sizeof (ACCEL_ODRS) / sizeof (double), config->accel.odr_hz, &accel_odr) &&
+          ((config->accel.bandwidth_hz == 0.0) || find_config_value(ACCEL_BANDWIDTHS, sizeof (ACCEL_BANDWIDTHS) / sizeof (double), config->accel.bandwidth_hz, &accel_bandwidth)) &&
+          find_config_value(ACCEL_FSRS, sizeof (ACCEL_FSRS) / sizeof (double), config->accel.fsr, &accel_fsr) &&
+          find_config_value(MAGNETO_ODRS, sizeof (MAGNETO_ODRS) / sizeof (double), config->magneto.odr_hz, &magneto_odr) &&
+          find_config_value(MAGNETO_FSRS, sizeof (MAGNETO_FSRS) / sizeof (double), config->magneto.fsr, &magneto_fsr) &&
+          ((MAGNETO_ODRS[magneto_odr] < 100.0) || (ACCEL_ODRS[accel_odr] > MAGNETO_MAX_ODR_ACCEL_MIN_ODR))))
+    {
+        fprintf(stderr, "ERROR: UNSUPPORTED LSM9DS0 OUTPUT DATA RATE, BANDWIDTH, OR FULL SCALE RANGE!\n");
+        return false;
+    }
+
+    //if the bit fields were successfully set
+    //CTRL_REG1_G - output data rate & cutoff, normal mode and xyz enabled 1111=F
+    //CTRL_REG4_G - full scale range, everything else default
+    //CTRL_REG1_XM - output data rate (the index + 1), continuous update and xyz enabled 0111=7
+    //CTRL_REG2_XM - anti-alias filter & full scale range, self-test to normal 00, serial interface to 4-wire 0
+    //CTRL_REG5_XM - temperature sensor to off 0, resolution to high 11, output data rate, don't set interrupts 00
+    //CTRL_REG6_XM - full scale range
+    if (write_byte(&(lsm->gyro_i2c_device), CTRL_REG1_G, (uint8_t)((gyro_odr << 6) | (gyro_bandwidth << 4) | 0x0F)) &&
+        write_byte(&(lsm->gyro_i2c_device), CTRL_REG4_G, (uint8_t)(gyro_fsr << 4)) &&
+        write_byte(&(lsm->accel_magneto_i2c_device), CTRL_REG1_XM, (uint8_t)(((accel_odr + 1) << 4) | 0x07)) &&
+        write_byte(&(lsm->accel_magneto_i2c_device), CTRL_REG2_XM, (uint8_t)((accel_bandwidth << 6) | (accel_fsr << 3))) &&
+        write_byte(&(lsm->accel_magneto_i2c_device), CTRL_REG5_XM, (uint8_t)(0x60 | (magneto_odr << 2))) &&
+        write_byte(&(lsm->accel_magneto_i2c_device), CTRL_REG6_XM, (uint8_t)(magneto_fsr << 5)))
+    {
+        //keep the active configuration (with the bandwidths that were actually set)
+        lsm->config.gyro.odr_hz = GYRO_ODRS[gyro_odr];
+        lsm->config.gyro.bandwidth_hz = GYRO_BANDWIDTHS[gyro_odr][gyro_bandwidth];
+        lsm->config.gyro.fsr = GYRO_FSRS[gyro_fsr];
+        lsm->config.accel.odr_hz = ACCEL_ODRS[accel_odr];
+        lsm->config.accel.bandwidth_hz = ACCEL_BANDWIDTHS[accel_bandwidth];
+        lsm->config.accel.fsr = ACCEL_FSRS[accel_fsr];
+        lsm->config.magneto.odr_hz = MAGNETO_ODRS[magneto_odr];
+        lsm->config.magneto.bandwidth_hz = 0.0;
+        lsm->config.magneto.fsr = MAGNETO_FSRS[magneto_fsr];
+
+        //get scale factor (based on FSR sensitivity) to apply to raw signal reading (the fsr enum lists each sensor's ranges in encoding order)
+        lsm->gyro_scale_factor = get_fsr_scale_factor((SENSOR_FSR)(GYRO_FSR_245DPS + gyro_fsr));
+        lsm->accel_scale_factor = get_fsr_scale_factor((SENSOR_FSR)(ACCEL_FSR_2G + accel_fsr));
+        lsm->magneto_scale_factor = get_fsr_scale_factor((SENSOR_FSR)(MAGNETO_FSR_2GS + magneto_fsr));
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get the rate readings are acquired at (a reading is taken whenever any sensor has a new one, so the fastest sensor's output data rate)
+double get_lsm9ds0_sample_rate(const LSM9DS0* lsm)
+{
+    //local vars
+    double sample_rate = 0.0;
+
+    //check input
+    if (lsm != NULL)
+    {
+        sample_rate = lsm->config.gyro.odr_hz;
+        sample_rate = (lsm->config.accel.odr_hz > sample_rate) ? lsm->config.accel.odr_hz : sample_rate;
+        sample_rate = (lsm->config.magneto.odr_hz > sample_rate) ? lsm->config.magneto.odr_hz : sample_rate;
+    }
+
+    return sample_rate;
+}
+
+//function definition
+//find the index (the bit field encoding) of a supported configuration value, the first if it's listed more than once
+static bool find_config_value(const double* values, uint32_t value_count, double value, uint8_t* index)
+{
+    //local vars
+    uint32_t i;
+
+    for (i = 0; i < value_count; i++)
+    {
+        if (fabs(values[i] - value) < 1e-6)
+        {
+            *index = (uint8_t)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 //function definition
 //get whoami id associated with a particular sensor
 bool get_sensor_id(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, uint8_t* sensor_id)
@@ -167,35 +306,50 @@ bool get_sensor_id(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, uint8_t* sensor_id)
 }
 
 //function definition
-//get latest xyz reading from a particular sensor
+//get latest xyz reading from a particular sensor (scaled to the sensor's units)
 bool get_latest_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_SIGNAL_READING* signal_reading)
+{
+    //local vars
+    LSM9DS0_RAW_SIGNAL_READING raw_signal_reading;
+
+    //if we successfully read the raw reading and scaled it
+    if (get_latest_raw_signal_reading(lsm, sensor, &raw_signal_reading) && scale_raw_signal_reading(lsm, sensor, &raw_signal_reading, signal_reading))
+    {
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get latest raw (unscaled) xyz reading from a particular sensor
+bool get_latest_raw_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_RAW_SIGNAL_READING* raw_signal_reading)
 {
     //local vars
     uint8_t data_buffer[READ_BYTES_BLOCK_SIZE];
     uint8_t register_addr;
-    double scale_factor;
     I2C_DEVICE* device;
     bool signal_reading_overrun_occurrence;
+    struct timespec acquisition_time;           //monotonic time the data registers were read
 
     //check inputs
-    if ((lsm != NULL) && (signal_reading != NULL))
+    if ((lsm != NULL) && (raw_signal_reading != NULL))
     {
-        //set the register address, scale factor, and device based on the sensor type
+        //set the register address and device based on the sensor type
         switch (sensor)
         {
             case ACCEL:
                 register_addr = OUT_X_L_A;                      //read from address OUT_X_L_A to OUT_Z_H_A
-                scale_factor = lsm->accel_scale_factor;         //get scale factor for this sensor
                 device = &(lsm->accel_magneto_i2c_device);      //set accel_magneto device
                 break;
             case GYRO:
                 register_addr = OUT_X_L_G;                      //read from address OUT_X_L_G to OUT_Z_H_G
-                scale_factor = lsm->gyro_scale_factor;          //set calculated resolution for this sensor
                 device = &(lsm->gyro_i2c_device);               //set gyro device
                 break;
             case MAGNETO:
                 register_addr = OUT_X_L_M;                      //read from address OUT_X_L_M to OUT_Z_H_M
-                scale_factor = lsm->magneto_scale_factor;       //set calculated resolution for this sensor
                 device = &(lsm->accel_magneto_i2c_device);      //set accel_magneto device
                 break;                                          //unnecessary but added for consistency
         }
@@ -207,6 +361,9 @@ bool get_latest_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_SIGN
             if (signal_reading_overrun_occurrence)
             {
                 fprintf(stderr, "WARNING: SIGNAL OVERRUN OCCURRED!\n");
+                lsm->overrun_count++;
+                increment_metrics_counter(METRICS_SIGNAL_OVERRUNS, 1);
+                TRACE_INSTANT("signal overrun", sensor);
             }
         }
         else
@@ -214,6 +371,9 @@ bool get_latest_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_SIGN
             fprintf(stderr, "ERROR: FAILED TO CHECK FOR SIGNAL OVERRUN OCCURRENCE!\n");
         }
 
+        //timestamp the reading as close to the register read as possible (monotonic, so it can't jump with wall clock adjustments)
+        clock_gettime(CLOCK_MONOTONIC, &acquisition_time);
+
         //read 6 bytes of data (3 words - x,y,z) - each word is in two's compliment (little endian)
         //if we successfully read 6 bytes
         if (read_bytes(device, register_addr, data_buffer, READ_BYTES_BLOCK_SIZE))
@@ -229,20 +389,20 @@ bool get_latest_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_SIGN
                 Next we convert to decimal, resulting in 2018. Finally, applying a negative gives us the actual number (e.g., -2018).
                 In practice, this conversion operation is not necessary as casting to a signed decimal type (int16_t) automatically
                 does the conversion. We aren't done yet, as the number is still a raw value and must be scaled before actual use
-                (e.g., -2018 * 0.000061 = -0.123098 g).
+                (e.g., -2018 * 0.000061 = -0.123098 g), see "scale_raw_signal_reading".
             */
 
             //bytes 1 (MSB) & 0 (LSB) form a word representing the x axis value
-            signal_reading->x = (int16_t)((((uint16_t)data_buffer[1]) << 8) | ((uint16_t)data_buffer[0]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
-            signal_reading->x *= scale_factor;                                                              //apply scale factor to raw reading
+            raw_signal_reading->x = (int16_t)((((uint16_t)data_buffer[1]) << 8) | ((uint16_t)data_buffer[0]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
 
             //bytes 3 (MSB) & 2 (LSB) form a word representing the y axis value
-            signal_reading->y = (int16_t)((((uint16_t)data_buffer[3]) << 8) | ((uint16_t)data_buffer[2]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
-            signal_reading->y *= scale_factor;                                                              //apply scale factor to raw reading
+            raw_signal_reading->y = (int16_t)((((uint16_t)data_buffer[3]) << 8) | ((uint16_t)data_buffer[2]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
 
             //bytes 5 (MSB) & 4 (LSB) form a word representing the z axis value
-            signal_reading->z = (int16_t)((((uint16_t)data_buffer[5]) << 8) | ((uint16_t)data_buffer[4]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
-            signal_reading->z *= scale_factor;                                                              //apply scale factor to raw reading
+            raw_signal_reading->z = (int16_t)((((uint16_t)data_buffer[5]) << 8) | ((uint16_t)data_buffer[4]));  //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
+
+            //record when the reading was acquired
+            raw_signal_reading->timestamp_ns = ((int64_t)acquisition_time.tv_sec * 1000000000) + acquisition_time.tv_nsec;
 
             //success
             return true;
@@ -253,6 +413,77 @@ bool get_latest_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, LSM9DS0_SIGN
     return false;
 }
 
+//function definition
+//apply a particular sensor's scale factor to a raw xyz reading
+bool scale_raw_signal_reading(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, const LSM9DS0_RAW_SIGNAL_READING* raw_signal_reading, LSM9DS0_SIGNAL_READING* signal_reading)
+{
+    //local vars
+    double scale_factor;
+
+    //check inputs
+    if ((lsm != NULL) && (raw_signal_reading != NULL) && (signal_reading != NULL))
+    {
+        //set the scale factor based on the sensor type
+        switch (sensor)
+        {
+            case ACCEL:
+                scale_factor = lsm->accel_scale_factor;         //get scale factor for this sensor
+                break;
+            case GYRO:
+                scale_factor = lsm->gyro_scale_factor;          //set calculated resolution for this sensor
+                break;
+            case MAGNETO:
+                scale_factor = lsm->magneto_scale_factor;       //set calculated resolution for this sensor
+                break;                                          //unnecessary but added for consistency
+        }
+
+        //apply scale factor to raw reading
+        signal_reading->x = raw_signal_reading->x * scale_factor;
+        signal_reading->y = raw_signal_reading->y * scale_factor;
+        signal_reading->z = raw_signal_reading->z * scale_factor;
+
+        //the scaled reading was acquired when the raw reading was
+        signal_reading->timestamp_ns = raw_signal_reading->timestamp_ns;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//apply a particular sensor's scale factor to a buffer of packed raw xyz readings (as burst read from its output registers), rendering x, y, and z columns
+bool scale_raw_signal_buffer(LSM9DS0* lsm, LSM9DS0_SENSOR sensor, const uint8_t* buffer, uint32_t sample_count, float* x, float* y, float* z)
+{
+    //local vars
+    double scale_factor;
+
+    //check input
+    if (lsm != NULL)
+    {
+        //set the scale factor based on the sensor type
+        switch (sensor)
+        {
+            case ACCEL:
+                scale_factor = lsm->accel_scale_factor;
+                break;
+            case GYRO:
+                scale_factor = lsm->gyro_scale_factor;
+                break;
+            case MAGNETO:
+                scale_factor = lsm->magneto_scale_factor;
+                break;
+        }
+
+        return convert_raw_signal_buffer(lsm->conversion_kernel, buffer, sample_count, (float)scale_factor, x, y, z);
+    }
+
+    //failure
+    return false;
+}
+
 //function definition
 //get scale factor (sensitivity) based on supplied sensor FSR (full scale range)
 //from table 3, page 13 of data sheet comment in lsm9ds0_private header file
@@ -403,3 +634,94 @@ static bool check_signal_reading_overrun_occurrence(LSM9DS0* lsm, LSM9DS0_SENSOR
     //failure
     return false;
 }
+
+//function definition
+//have the gyro latch an interrupt whenever a rate (any axis) rises above a threshold in dps, so crossings that happen between reads aren't missed
+//(also routed to the INT_G pin, for hosts that wire it up to wake on motion)
+bool enable_gyro_threshold_interrupt(LSM9DS0* lsm, double threshold_dps)
+{
+    //local vars
+    double raw_threshold;
+    uint16_t threshold;
+
+    //check inputs
+    if ((lsm != NULL) && (threshold_dps > 0) && (lsm->gyro_scale_factor > 0))
+    {
+        //convert the threshold to the raw units the comparison is done in (clamped to what the registers hold)
+        raw_threshold = threshold_dps / lsm->gyro_scale_factor;
+        threshold = (raw_threshold < GYRO_INTERRUPT_MAX_THRESHOLD) ? (uint16_t)raw_threshold : GYRO_INTERRUPT_MAX_THRESHOLD;
+
+        //if the bit fields were successfully set
+        //INT1_THS_XH_G..INT1_THS_ZL_G - the threshold (high 7 bits, low 8 bits) for each axis
+        //INT1_DURATION_G - no wait, the interrupt fires on the first sample above the threshold
+        //INT1_CFG_G - or combination of events 0, latch the interrupt until INT1_SRC_G is read 1, z/y/x high events enabled 101010 -> 0110=6, 1010=A
+        //CTRL_REG3_G - interrupt enabled on the INT_G pin 1, everything else default -> 1000=8, 0000=0
+        if (write_byte(&(lsm->gyro_i2c_device), INT1_THS_XH_G, (uint8_t)((threshold >> 8) & 0x7F)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_THS_XL_G, (uint8_t)(threshold & 0xFF)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_THS_YH_G, (uint8_t)((threshold >> 8) & 0x7F)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_THS_YL_G, (uint8_t)(threshold & 0xFF)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_THS_ZH_G, (uint8_t)((threshold >> 8) & 0x7F)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_THS_ZL_G, (uint8_t)(threshold & 0xFF)) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_DURATION_G, 0x00) &&
+            write_byte(&(lsm->gyro_i2c_device), INT1_CFG_G, 0x6A) &&
+            write_byte(&(lsm->gyro_i2c_device), CTRL_REG3_G, 0x80))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//check if the gyro latched a threshold interrupt since the last check (reading the source register clears the latch)
+bool check_gyro_threshold_interrupt(LSM9DS0* lsm, bool* interrupt_occurrence)
+{
+    //local vars
+    uint8_t source_bit_field;
+
+    //check inputs
+    if ((lsm != NULL) && (interrupt_occurrence != NULL))
+    {
+        //if we successfully read a byte (the interrupt source bit field)
+        if (read_byte(&(lsm->gyro_i2c_device), INT1_SRC_G, &source_bit_field))
+        {
+            //determine if an interrupt was generated by anding with appropriate mask
+            *interrupt_occurrence = ((source_bit_field & GYRO_INTERRUPT_ACTIVE) != 0);
+
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//write the magnetometer's hard iron offsets (x, y, z in raw units, two's compliment) to its offset registers, the sensor subtracts them from every reading
+//(so they also apply to readings taken before any software correction, zero offsets restore the uncorrected readings)
+bool set_magneto_hard_iron_offsets(LSM9DS0* lsm, const int16_t* offsets)
+{
+    //check inputs
+    if ((lsm != NULL) && (offsets != NULL))
+    {
+        //if the bit fields were successfully set
+        //OFFSET_X_L_M..OFFSET_Z_H_M - the offset (low 8 bits, high 8 bits) for each axis
+        if (write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_X_L_M, (uint8_t)((uint16_t)offsets[0] & 0xFF)) &&
+            write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_X_H_M, (uint8_t)(((uint16_t)offsets[0] >> 8) & 0xFF)) &&
+            write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_Y_L_M, (uint8_t)((uint16_t)offsets[1] & 0xFF)) &&
+            write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_Y_H_M, (uint8_t)(((uint16_t)offsets[1] >> 8) & 0xFF)) &&
+            write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_Z_L_M, (uint8_t)((uint16_t)offsets[2] & 0xFF)) &&
+            write_byte(&(lsm->accel_magneto_i2c_device), OFFSET_Z_H_M, (uint8_t)(((uint16_t)offsets[2] >> 8) & 0xFF)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
@@ -11,11 +11,6 @@
 
 //global vars
 //** register address constants **
-//i2c bus the lsm9ds0 board communicates on
-static const int I2C_BUS = 1;
-//i2c addresses for sensors
-static const uint8_t GYRO_ADDR = 0x6B;
-static const uint8_t ACCEL_MAGNETO_ADDR = 0x1D;
 //lsm9ds0 data sheet - http://www.st.com/st-web-ui/static/active/en/resource/technical/document/datasheet/DM00087365.pdf
 //not all registers are utilized in this implementation but nonetheless included
 //device ID register - readonly - multiple sensors could reside on a particular device (e.g. accelerometer & magnetometer)
@@ -137,9 +132,26 @@ static const uint8_t ACT_DUR = 0x3F;
 //** bit mask constants **
 static const uint8_t NEW_SIGNAL_READING_AVAILABLE = 0x08;   //binary: 00001000 <- bit 5 is set to 1 signifying a new xyz reading is available
 static const uint8_t XYZ_SIGNAL_OVERRUN_OCCURRED = 0x80;    //binary: 10000000 <- LSB is set to 1 signifying an xyz overrun has occurred
+static const uint8_t GYRO_INTERRUPT_ACTIVE = 0x40;          //binary: 01000000 <- IA bit of INT1_SRC_G is set to 1 signifying an interrupt was generated
+static const uint16_t GYRO_INTERRUPT_MAX_THRESHOLD = 0x7FFF; //thresholds are 15 bit unsigned values (in the gyro's raw units)
 
 static const int READ_BYTES_BLOCK_SIZE = 6;     //the number of bytes to read in a single read_bytes() call
 
+//** configuration constants **
+//supported values, in the order of their bit field encodings
+//gyro - CTRL_REG1_G DR (bits 7-6) & BW (bits 5-4, cutoff per output data rate), CTRL_REG4_G FS (bits 5-4)
+static const double GYRO_ODRS[] = {95.0, 190.0, 380.0, 760.0};
+static const double GYRO_BANDWIDTHS[][4] = {{12.5, 25.0, 25.0, 25.0}, {12.5, 25.0, 50.0, 70.0}, {20.0, 25.0, 50.0, 100.0}, {30.0, 35.0, 50.0, 100.0}};
+static const double GYRO_FSRS[] = {245.0, 500.0, 2000.0};
+//accel - CTRL_REG1_XM AODR (bits 7-4, 0000 is power down so the encoding is the index + 1), CTRL_REG2_XM ABW (bits 7-6) & AFS (bits 5-3)
+static const double ACCEL_ODRS[] = {3.125, 6.25, 12.5, 25.0, 50.0, 100.0, 200.0, 400.0, 800.0, 1600.0};
+static const double ACCEL_BANDWIDTHS[] = {773.0, 194.0, 362.0, 50.0};
+static const double ACCEL_FSRS[] = {2.0, 4.0, 6.0, 8.0, 16.0};
+//magneto - CTRL_REG5_XM M_ODR (bits 4-2), CTRL_REG6_XM MFS (bits 6-5)
+static const double MAGNETO_ODRS[] = {3.125, 6.25, 12.5, 25.0, 50.0, 100.0};
+static const double MAGNETO_FSRS[] = {2.0, 4.0, 8.0, 12.0};
+static const double MAGNETO_MAX_ODR_ACCEL_MIN_ODR = 50.0;   //the magneto's highest odr needs the accel to run faster than this
+
 //enum for sensor full scale range (+ or -)
 typedef enum sensor_fsr
 {
@@ -166,6 +178,7 @@ static bool init_gyro(I2C_DEVICE*);
 static bool init_accel(I2C_DEVICE*);
 static bool init_magneto(I2C_DEVICE*);
 static double get_fsr_scale_factor(SENSOR_FSR);
+static bool find_config_value(const double*, uint32_t, double, uint8_t*);
 static bool check_signal_reading_overrun_occurrence(LSM9DS0*, LSM9DS0_SENSOR, bool*);
 
 #endif /* LSM9DS0_PRIVATE_H_ */
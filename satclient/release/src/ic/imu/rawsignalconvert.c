@@ -0,0 +1,253 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include "rawsignalconvert.h"
+
+//the vectorized kernels load the words straight from the buffer, so they rely on a little endian host (the scalar kernel doesn't)
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define X86_CONVERSION_KERNELS
+    #include <immintrin.h>      //using for sse2 and avx2 intrinsics
+#endif
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    #define NEON_CONVERSION_KERNELS
+    #include <arm_neon.h>       //using for neon intrinsics
+#endif
+
+//function declarations
+static void convert_raw_signal_buffer_using_scalar(const uint8_t*, uint32_t, float, float*, float*, float*);
+#ifdef X86_CONVERSION_KERNELS
+static uint32_t convert_raw_signal_buffer_using_sse2(const uint8_t*, uint32_t, float, float*, float*, float*);
+static uint32_t convert_raw_signal_buffer_using_avx2(const uint8_t*, uint32_t, float, float*, float*, float*);
+#endif
+#ifdef NEON_CONVERSION_KERNELS
+static uint32_t convert_raw_signal_buffer_using_neon(const uint8_t*, uint32_t, float, float*, float*, float*);
+#endif
+
+//function definition
+//determine if a kernel can be used on this host
+bool is_raw_signal_conversion_kernel_available(RAW_SIGNAL_CONVERSION_KERNEL kernel)
+{
+    switch (kernel)
+    {
+        case SCALAR_CONVERSION_KERNEL:
+            return true;
+#ifdef X86_CONVERSION_KERNELS
+        case SSE2_CONVERSION_KERNEL:
+            return __builtin_cpu_supports("sse2");
+        case AVX2_CONVERSION_KERNEL:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef NEON_CONVERSION_KERNELS
+        case NEON_CONVERSION_KERNEL:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+//function definition
+//get the widest kernel available on this host
+RAW_SIGNAL_CONVERSION_KERNEL get_preferred_raw_signal_conversion_kernel(void)
+{
+    if (is_raw_signal_conversion_kernel_available(AVX2_CONVERSION_KERNEL))
+    {
+        return AVX2_CONVERSION_KERNEL;
+    }
+    if (is_raw_signal_conversion_kernel_available(NEON_CONVERSION_KERNEL))
+    {
+        return NEON_CONVERSION_KERNEL;
+    }
+    if (is_raw_signal_conversion_kernel_available(SSE2_CONVERSION_KERNEL))
+    {
+        return SSE2_CONVERSION_KERNEL;
+    }
+
+    return SCALAR_CONVERSION_KERNEL;
+}
+
+//function definition
+//get the name of a kernel (used in diagnostics)
+const char* get_raw_signal_conversion_kernel_name(RAW_SIGNAL_CONVERSION_KERNEL kernel)
+{
+    switch (kernel)
+    {
+        case SCALAR_CONVERSION_KERNEL:
+            return "scalar";
+        case SSE2_CONVERSION_KERNEL:
+            return "sse2";
+        case AVX2_CONVERSION_KERNEL:
+            return "avx2";
+        case NEON_CONVERSION_KERNEL:
+            return "neon";
+        default:
+            return "unknown";
+    }
+}
+
+//function definition
+//convert a buffer of packed raw xyz readings into scaled x, y, and z columns (each sample_count floats long)
+bool convert_raw_signal_buffer(RAW_SIGNAL_CONVERSION_KERNEL kernel, const uint8_t* buffer, uint32_t sample_count, float scale_factor, float* x, float* y, float* z)
+{
+    //local vars
+    uint32_t converted_count = 0;       //samples converted by the vectorized kernel (the rest are done by the scalar kernel)
+
+    //check inputs
+    if ((buffer != NULL) && (x != NULL) && (y != NULL) && (z != NULL) && is_raw_signal_conversion_kernel_available(kernel))
+    {
+        switch (kernel)
+        {
+#ifdef X86_CONVERSION_KERNELS
+            case SSE2_CONVERSION_KERNEL:
+                converted_count = convert_raw_signal_buffer_using_sse2(buffer, sample_count, scale_factor, x, y, z);
+                break;
+            case AVX2_CONVERSION_KERNEL:
+                converted_count = convert_raw_signal_buffer_using_avx2(buffer, sample_count, scale_factor, x, y, z);
+                break;
+#endif
+#ifdef NEON_CONVERSION_KERNELS
+            case NEON_CONVERSION_KERNEL:
+                converted_count = convert_raw_signal_buffer_using_neon(buffer, sample_count, scale_factor, x, y, z);
+                break;
+#endif
+            default:
+                break;
+        }
+
+        //finish off whatever didn't fill a vector
+        convert_raw_signal_buffer_using_scalar(&(buffer[converted_count * 6]), sample_count - converted_count, scale_factor, &(x[converted_count]), &(y[converted_count]), &(z[converted_count]));
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//one sample at a time (the reference every other kernel must match)
+static void convert_raw_signal_buffer_using_scalar(const uint8_t* buffer, uint32_t sample_count, float scale_factor, float* x, float* y, float* z)
+{
+    //local vars
+    uint32_t i;
+
+    for (i = 0; i < sample_count; i++, buffer += 6)
+    {
+        //bytes are little endian, so swap them and combine into a uint16_t, then casting to int16_t auto converts from two's compliment to decimal
+        //(a 16 bit integer times a float is exact before rounding, even at x87 extended precision, so this rounds exactly as a vector multiply does)
+        x[i] = (float)(int16_t)((((uint16_t)buffer[1]) << 8) | ((uint16_t)buffer[0])) * scale_factor;
+        y[i] = (float)(int16_t)((((uint16_t)buffer[3]) << 8) | ((uint16_t)buffer[2])) * scale_factor;
+        z[i] = (float)(int16_t)((((uint16_t)buffer[5]) << 8) | ((uint16_t)buffer[4])) * scale_factor;
+    }
+}
+
+#ifdef X86_CONVERSION_KERNELS
+//function definition
+//4 samples (12 words) per step - the words are converted and scaled in buffer order, then the three vectors are shuffled apart into x, y, and z
+__attribute__((target("sse2")))
+static uint32_t convert_raw_signal_buffer_using_sse2(const uint8_t* buffer, uint32_t sample_count, float scale_factor, float* x, float* y, float* z)
+{
+    //local vars
+    const __m128 scale = _mm_set1_ps(scale_factor);
+    __m128i words;
+    __m128i tail_words;
+    __m128 a;       //x0 y0 z0 x1
+    __m128 b;       //y1 z1 x2 y2
+    __m128 c;       //z2 x3 y3 z3
+    __m128 u;
+    __m128 v;
+    uint32_t i;
+
+    for (i = 0; (i + 4) <= sample_count; i += 4, buffer += 24)
+    {
+        //load the 12 words (16 + 8 bytes, staying inside the 24 bytes of the step)
+        words = _mm_loadu_si128((const __m128i*)buffer);
+        tail_words = _mm_loadl_epi64((const __m128i*)&(buffer[16]));
+
+        //sign extend each word to 32 bits (duplicate it into both halves, then shift the upper copy down arithmetically), convert, and scale
+        a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16)), scale);
+        b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16)), scale);
+        c = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(tail_words, tail_words), 16)), scale);
+
+        //x = a0 a3 b2 c1
+        u = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0));
+        v = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+        _mm_storeu_ps(&(x[i]), _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0)));
+
+        //y = a1 b0 b3 c2
+        u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+        v = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+        _mm_storeu_ps(&(y[i]), _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0)));
+
+        //z = a2 b1 c0 c3
+        u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+        v = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+        _mm_storeu_ps(&(z[i]), _mm_shuffle_ps(u, v, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+
+    return i;
+}
+
+//function definition
+//8 samples (24 words) per step - the words are converted and scaled in buffer order, then each of x, y, and z
+//is blended together from the lanes of the three vectors that hold it and permuted into sample order
+__attribute__((target("avx2")))
+static uint32_t convert_raw_signal_buffer_using_avx2(const uint8_t* buffer, uint32_t sample_count, float scale_factor, float* x, float* y, float* z)
+{
+    //local vars
+    const __m256 scale = _mm256_set1_ps(scale_factor);
+    const __m256i x_order = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);     //lane of x0..x7 once blended
+    const __m256i y_order = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);     //lane of y0..y7 once blended
+    const __m256i z_order = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);     //lane of z0..z7 once blended
+    __m256 a;       //words 0-7
+    __m256 b;       //words 8-15
+    __m256 c;       //words 16-23
+    uint32_t i;
+
+    for (i = 0; (i + 8) <= sample_count; i += 8, buffer += 48)
+    {
+        //sign extend each word to 32 bits, convert, and scale
+        a = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)buffer))), scale);
+        b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&(buffer[16])))), scale);
+        c = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&(buffer[32])))), scale);
+
+        //x is in lanes 0,3,6 of a, 1,4,7 of b, and 2,5 of c
+        _mm256_storeu_ps(&(x[i]), _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24), x_order));
+        //y is in lanes 1,4,7 of a, 2,5 of b, and 0,3,6 of c
+        _mm256_storeu_ps(&(y[i]), _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49), y_order));
+        //z is in lanes 2,5 of a, 0,3,6 of b, and 1,4,7 of c
+        _mm256_storeu_ps(&(z[i]), _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92), z_order));
+    }
+
+    return i;
+}
+#endif
+
+#ifdef NEON_CONVERSION_KERNELS
+//function definition
+//8 samples per step - the structured load separates x, y, and z, then each is widened, converted, and scaled
+static uint32_t convert_raw_signal_buffer_using_neon(const uint8_t* buffer, uint32_t sample_count, float scale_factor, float* x, float* y, float* z)
+{
+    //local vars
+    int16x8x3_t words;
+    uint32_t i;
+
+    for (i = 0; (i + 8) <= sample_count; i += 8, buffer += 48)
+    {
+        words = vld3q_s16((const int16_t*)buffer);
+
+        vst1q_f32(&(x[i]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(words.val[0]))), scale_factor));
+        vst1q_f32(&(x[i + 4]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(words.val[0]))), scale_factor));
+        vst1q_f32(&(y[i]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(words.val[1]))), scale_factor));
+        vst1q_f32(&(y[i + 4]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(words.val[1]))), scale_factor));
+        vst1q_f32(&(z[i]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(words.val[2]))), scale_factor));
+        vst1q_f32(&(z[i + 4]), vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(words.val[2]))), scale_factor));
+    }
+
+    return i;
+}
+#endif
@@ -4,9 +4,10 @@
 */
 
 #include <stdio.h>              //using for "printf" function
-#include <stdlib.h>             //using for "malloc" and "free" functions, and "NULL"
+#include <stdlib.h>             //using for "NULL"
 #include <string.h>             //using for "strlen" function
 #include <proton/message.h>     //using for qpid proton amqp client
+#include "satmemory.h"          //using to allocate from the memory arena
 #include <messagingclient.h>
 
 //https://github.com/Azure/azure-service-bus-samples/blob/master/proton-c-queues-and-topics/sender.c
@@ -35,7 +36,7 @@ MESSAGING_CLIENT* new_messaging_client(void)
     MESSAGING_CLIENT* mclient;
 
     //allocate messaging client object
-    mclient = malloc(sizeof (MESSAGING_CLIENT));
+    mclient = allocate_sat_memory(SAT_MEMORY_MESSAGING_CLIENT, sizeof (MESSAGING_CLIENT));
 
     //if the object was successfully created
     if (mclient != NULL)
@@ -48,7 +49,7 @@ MESSAGING_CLIENT* new_messaging_client(void)
         }
 
         //deallocate messaging client
-        free(mclient);
+        free_sat_memory(mclient);
     }
 
     //failure
@@ -113,7 +114,7 @@ void free_messaging_client(MESSAGING_CLIENT* mclient)
         pn_message_free(mclient->reusable_message);
 
         //deallocate event hub object
-        free(mclient);
+        free_sat_memory(mclient);
     }
 }
 
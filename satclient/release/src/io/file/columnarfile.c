@@ -0,0 +1,184 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "fprintf" function
+#include <string.h>             //using for "memcmp" function
+#include <fcntl.h>              //using for "open" function
+#include <unistd.h>             //using for "close" function
+#include <sys/mman.h>           //using for "mmap" and "munmap" functions
+#include <sys/stat.h>           //using for "fstat" function
+#include "columnarfile.h"
+
+//function declarations
+static bool map_columnar_file(COLUMNAR_FILE_READER*);
+
+//function definition
+//open a columnar telemetry file for reading (the file may still be being written)
+bool open_columnar_file_reader(COLUMNAR_FILE_READER* reader, const char* file_location)
+{
+    //check inputs
+    if ((reader != NULL) && (file_location != NULL))
+    {
+        reader->mapping = NULL;
+        reader->mapping_size = 0;
+        reader->header = NULL;
+        reader->fd = open(file_location, O_RDONLY | O_CLOEXEC);
+
+        //if the file was successfully opened
+        if (reader->fd >= 0)
+        {
+            //if the file was successfully mapped and is a columnar telemetry file we understand
+            if (map_columnar_file(reader) &&
+                (memcmp(reader->header->magic, COLUMNAR_FILE_MAGIC, sizeof (reader->header->magic)) == 0) &&
+                (reader->header->page_size == COLUMNAR_FILE_PAGE_SIZE_BYTES) &&
+                (reader->header->samples_per_page == COLUMNAR_FILE_SAMPLES_PER_PAGE) &&
+                (reader->header->axis_count == COLUMNAR_FILE_AXIS_COUNT))
+            {
+                //success
+                return true;
+            }
+
+            fprintf(stderr, "ERROR: %s IS NOT A READABLE COLUMNAR TELEMETRY FILE!\n", file_location);
+
+            close_columnar_file_reader(reader);
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//remap the file if the writer has grown it since it was last mapped (call before reading pages appended since)
+bool refresh_columnar_file_reader(COLUMNAR_FILE_READER* reader)
+{
+    //local vars
+    struct stat file_status;
+
+    //check input
+    if ((reader != NULL) && (reader->fd >= 0) && (fstat(reader->fd, &file_status) == 0))
+    {
+        //nothing to do if the file hasn't grown
+        if ((size_t)file_status.st_size == reader->mapping_size)
+        {
+            return true;
+        }
+
+        //drop the old mapping and map the file at its new size
+        munmap((void*)reader->mapping, reader->mapping_size);
+        reader->mapping = NULL;
+
+        return map_columnar_file(reader);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get the number of samples that can currently be read
+uint64_t get_columnar_file_sample_count(const COLUMNAR_FILE_READER* reader)
+{
+    //check input
+    if ((reader != NULL) && (reader->header != NULL))
+    {
+        //pairs with the writer's release store, every sample below this count is fully written
+        return __atomic_load_n(&(reader->header->committed_sample_count), __ATOMIC_ACQUIRE);
+    }
+
+    return 0;
+}
+
+//function definition
+//get a view of a data page's columns (pointers straight into the mapping, valid until the next refresh/close)
+bool get_columnar_file_page(const COLUMNAR_FILE_READER* reader, uint64_t page_index, COLUMNAR_PAGE_VIEW* view)
+{
+    //local vars
+    const uint8_t* page;
+    uint64_t page_offset;
+    uint32_t axis;
+
+    //check inputs
+    if ((reader != NULL) && (reader->mapping != NULL) && (view != NULL))
+    {
+        //data pages follow the header page
+        page_offset = (page_index + 1) * COLUMNAR_FILE_PAGE_SIZE_BYTES;
+
+        //if the page is inside the current mapping
+        if ((page_offset + COLUMNAR_FILE_PAGE_SIZE_BYTES) <= reader->mapping_size)
+        {
+            page = &(reader->mapping[page_offset]);
+
+            //pairs with the writer's release store, every sample below this count is fully written
+            view->sample_count = __atomic_load_n(&(((const COLUMNAR_PAGE_HEADER*)page)->sample_count), __ATOMIC_ACQUIRE);
+            view->timestamps_ns = (const int64_t*)&(page[COLUMNAR_PAGE_TIMESTAMP_COLUMN_OFFSET]);
+            for (axis = 0; axis < COLUMNAR_FILE_AXIS_COUNT; axis++)
+            {
+                view->axes[axis] = (const int16_t*)&(page[COLUMNAR_PAGE_AXIS_COLUMN_OFFSET(axis)]);
+            }
+
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//unmap and close the file
+void close_columnar_file_reader(COLUMNAR_FILE_READER* reader)
+{
+    //check input
+    if (reader != NULL)
+    {
+        if (reader->mapping != NULL)
+        {
+            munmap((void*)reader->mapping, reader->mapping_size);
+        }
+
+        if (reader->fd >= 0)
+        {
+            close(reader->fd);
+        }
+
+        reader->fd = -1;
+        reader->mapping = NULL;
+        reader->mapping_size = 0;
+        reader->header = NULL;
+    }
+}
+
+//function definition
+//map the whole file read-only
+static bool map_columnar_file(COLUMNAR_FILE_READER* reader)
+{
+    //local vars
+    struct stat file_status;
+    void* mapping;
+
+    //if the file is at least big enough to hold its header
+    if ((fstat(reader->fd, &file_status) == 0) && (file_status.st_size >= COLUMNAR_FILE_PAGE_SIZE_BYTES))
+    {
+        mapping = mmap(NULL, file_status.st_size, PROT_READ, MAP_SHARED, reader->fd, 0);
+
+        //if the file was successfully mapped
+        if (mapping != MAP_FAILED)
+        {
+            reader->mapping = (const uint8_t*)mapping;
+            reader->mapping_size = file_status.st_size;
+            reader->header = (const COLUMNAR_FILE_HEADER*)mapping;
+
+            //success
+            return true;
+        }
+    }
+
+    reader->header = NULL;
+
+    //failure
+    return false;
+}
@@ -0,0 +1,262 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in fcntl.h so we can use the "posix_fallocate" function
+
+#include <stdio.h>              //using for "fprintf" function
+#include <stdlib.h>             //using for "NULL"
+#include <string.h>             //using for "memcpy" function
+#include <fcntl.h>              //using for "open" and "posix_fallocate" functions
+#include <unistd.h>             //using for "close" function
+#include <sys/mman.h>           //using for "mmap", "munmap", and "msync" functions
+#include "columnarfile.h"       //using for the columnar file layout
+#include "samplebatch.h"        //using for the batch's raw sample columns
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "columnarsink.h"
+
+//columnar sink state representation
+typedef struct columnar_sink_context
+{
+    const char* file_location;          //file the samples are written to
+    int fd;                             //descriptor of the open file
+    COLUMNAR_FILE_HEADER* header;       //mapping of the header page
+    uint8_t* page;                      //mapping of the data page currently being filled (NULL before the first sample)
+    uint64_t page_index;                //index of the data page currently being filled
+    uint32_t page_sample_count;         //samples written to the current data page
+    uint64_t committed_sample_count;    //samples written across all data pages
+}COLUMNAR_SINK_CONTEXT;
+
+//function declarations
+static bool open_columnar_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_columnar_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_columnar_sink(TELEMETRY_SINK*);
+static bool close_columnar_sink(TELEMETRY_SINK*);
+static bool map_next_columnar_page(COLUMNAR_SINK_CONTEXT*);
+
+//columnar file telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE COLUMNAR_SINK_INTERFACE =
+{
+    open_columnar_sink,
+    publish_batch_to_columnar_sink,
+    flush_columnar_sink,
+    close_columnar_sink,
+    free_sat_memory
+};
+
+//function definition
+//create a telemetry sink that writes raw samples into a memory mapped columnar file (see columnarfile.h)
+//the file location must outlive the sink
+TELEMETRY_SINK* new_columnar_telemetry_sink(const char* file_location)
+{
+    //local vars
+    COLUMNAR_SINK_CONTEXT* context;
+
+    //check input
+    if (file_location != NULL)
+    {
+        //allocate columnar sink state (owned by the sink)
+        context = allocate_sat_memory(SAT_MEMORY_COLUMNAR_SINK, sizeof (COLUMNAR_SINK_CONTEXT));
+
+        //if the object was successfully created
+        if (context != NULL)
+        {
+            context->file_location = file_location;
+            context->fd = -1;
+            context->header = NULL;
+            context->page = NULL;
+
+            return new_telemetry_sink("COLUMNAR FILE", &COLUMNAR_SINK_INTERFACE, context);
+        }
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//create (replacing any previous run's file) the columnar file and map its header page
+static bool open_columnar_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    COLUMNAR_SINK_CONTEXT* context = (COLUMNAR_SINK_CONTEXT*)sink->context;
+    void* mapping;
+
+    context->page = NULL;
+    context->page_index = 0;
+    context->page_sample_count = 0;
+    context->committed_sample_count = 0;
+    context->fd = open(context->file_location, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    //if the file was successfully created and sized to hold the header page
+    if ((context->fd >= 0) && (posix_fallocate(context->fd, 0, COLUMNAR_FILE_PAGE_SIZE_BYTES) == 0))
+    {
+        mapping = mmap(NULL, COLUMNAR_FILE_PAGE_SIZE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, context->fd, 0);
+
+        //if the header page was successfully mapped
+        if (mapping != MAP_FAILED)
+        {
+            //fill in the header (scale factors are filled in with the first batch, the file reads as empty until then)
+            context->header = (COLUMNAR_FILE_HEADER*)mapping;
+            memcpy(context->header->magic, COLUMNAR_FILE_MAGIC, sizeof (context->header->magic));
+            context->header->page_size = COLUMNAR_FILE_PAGE_SIZE_BYTES;
+            context->header->samples_per_page = COLUMNAR_FILE_SAMPLES_PER_PAGE;
+            context->header->axis_count = COLUMNAR_FILE_AXIS_COUNT;
+            context->header->committed_sample_count = 0;
+
+            //success
+            return true;
+        }
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO CREATE COLUMNAR TELEMETRY FILE: %s!\n", context->file_location);
+
+    //close the file if it was opened
+    if (context->fd >= 0)
+    {
+        close(context->fd);
+        context->fd = -1;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//copy the batch's raw sample columns into the page columns, then publish them to readers
+static bool publish_batch_to_columnar_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    COLUMNAR_SINK_CONTEXT* context = (COLUMNAR_SINK_CONTEXT*)sink->context;
+    const SAMPLE_BATCH* samples = &(batch->samples);
+    uint32_t sample_index = 0;      //next sample of the batch to copy
+    uint32_t n;                     //samples copied into the current page at once
+    uint32_t axis;
+
+    //the scale factors are fixed for the run, record them before the first sample is published
+    if (context->committed_sample_count == 0)
+    {
+        for (axis = 0; axis < COLUMNAR_FILE_AXIS_COUNT; axis++)
+        {
+            context->header->scale_factors[axis] = samples->scale_factors[axis];
+        }
+    }
+
+    //the batch and page columns are both in axis order, so each run of samples that fits in the current page is a copy per column
+    while (sample_index < samples->sample_count)
+    {
+        //move to a new page when the current one is full (or none is mapped yet)
+        if ((context->page == NULL) || (context->page_sample_count == COLUMNAR_FILE_SAMPLES_PER_PAGE))
+        {
+            if (!map_next_columnar_page(context))
+            {
+                //failure
+                return false;
+            }
+        }
+
+        //copy as many samples as fit in the current page
+        n = samples->sample_count - sample_index;
+        if (n > (COLUMNAR_FILE_SAMPLES_PER_PAGE - context->page_sample_count))
+        {
+            n = COLUMNAR_FILE_SAMPLES_PER_PAGE - context->page_sample_count;
+        }
+
+        memcpy(&(((int64_t*)&(context->page[COLUMNAR_PAGE_TIMESTAMP_COLUMN_OFFSET]))[context->page_sample_count]), &(samples->timestamps_ns[sample_index]), n * sizeof (int64_t));
+        for (axis = 0; axis < COLUMNAR_FILE_AXIS_COUNT; axis++)
+        {
+            memcpy(&(((int16_t*)&(context->page[COLUMNAR_PAGE_AXIS_COLUMN_OFFSET(axis)]))[context->page_sample_count]), &(samples->raw[axis][sample_index]), n * sizeof (int16_t));
+        }
+
+        //publish the samples (column values first, then the counts readers rely on)
+        sample_index += n;
+        context->page_sample_count += n;
+        context->committed_sample_count += n;
+        __atomic_store_n(&(((COLUMNAR_PAGE_HEADER*)context->page)->sample_count), context->page_sample_count, __ATOMIC_RELEASE);
+        __atomic_store_n(&(context->header->committed_sample_count), context->committed_sample_count, __ATOMIC_RELEASE);
+    }
+
+    //success
+    return true;
+}
+
+//function definition
+//write the dirty pages back to storage
+static bool flush_columnar_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    COLUMNAR_SINK_CONTEXT* context = (COLUMNAR_SINK_CONTEXT*)sink->context;
+    bool operation_status = true;
+
+    //full pages were synced as they were retired, so only the current page and the header are outstanding
+    if (context->page != NULL)
+    {
+        operation_status &= (msync(context->page, COLUMNAR_FILE_PAGE_SIZE_BYTES, MS_SYNC) == 0);
+    }
+    operation_status &= (msync(context->header, COLUMNAR_FILE_PAGE_SIZE_BYTES, MS_SYNC) == 0);
+
+    return operation_status;
+}
+
+//function definition
+//unmap and close the file
+static bool close_columnar_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    COLUMNAR_SINK_CONTEXT* context = (COLUMNAR_SINK_CONTEXT*)sink->context;
+
+    if (context->page != NULL)
+    {
+        munmap(context->page, COLUMNAR_FILE_PAGE_SIZE_BYTES);
+        context->page = NULL;
+    }
+    munmap(context->header, COLUMNAR_FILE_PAGE_SIZE_BYTES);
+    context->header = NULL;
+
+    //success if the file closed cleanly
+    return (close(context->fd) == 0);
+}
+
+//function definition
+//retire the current data page (if any) and grow the file by, and map, the next one
+static bool map_next_columnar_page(COLUMNAR_SINK_CONTEXT* context)
+{
+    //local vars
+    off_t page_offset;
+    void* mapping;
+
+    //retire the full page (let the kernel start writing it back, we never touch it again)
+    if (context->page != NULL)
+    {
+        msync(context->page, COLUMNAR_FILE_PAGE_SIZE_BYTES, MS_ASYNC);
+        munmap(context->page, COLUMNAR_FILE_PAGE_SIZE_BYTES);
+        context->page = NULL;
+        context->page_index++;
+    }
+
+    //data pages follow the header page
+    page_offset = (off_t)(context->page_index + 1) * COLUMNAR_FILE_PAGE_SIZE_BYTES;
+
+    //reserve the storage up front, so running out of space is reported here rather than as a fault when the mapping is written
+    if (posix_fallocate(context->fd, page_offset, COLUMNAR_FILE_PAGE_SIZE_BYTES) == 0)
+    {
+        mapping = mmap(NULL, COLUMNAR_FILE_PAGE_SIZE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, context->fd, page_offset);
+
+        //if the page was successfully mapped
+        if (mapping != MAP_FAILED)
+        {
+            context->page = (uint8_t*)mapping;
+            context->page_sample_count = 0;
+            ((COLUMNAR_PAGE_HEADER*)context->page)->page_index = context->page_index;
+
+            //success
+            return true;
+        }
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO GROW COLUMNAR TELEMETRY FILE: %s!\n", context->file_location);
+
+    //failure
+    return false;
+}
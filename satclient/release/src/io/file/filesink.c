@@ -0,0 +1,147 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "fprintf" function
+#include <stdlib.h>             //using for "NULL"
+#include <errno.h>              //using for "errno" and "EINTR"
+#include <fcntl.h>              //using for "open" function
+#include <unistd.h>             //using for "write", "fdatasync", and "close" functions
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "filesink.h"
+#include "metrics.h"             //using for "increment_metrics_counter" function
+
+//file sink state representation
+typedef struct file_sink_context
+{
+    const char* file_location;  //file (or named pipe) the batches are appended to
+    int fd;                     //descriptor of the open file
+}FILE_SINK_CONTEXT;
+
+//function declarations
+static bool open_file_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_file_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_file_sink(TELEMETRY_SINK*);
+static bool close_file_sink(TELEMETRY_SINK*);
+
+//local file telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE FILE_SINK_INTERFACE =
+{
+    open_file_sink,
+    publish_batch_to_file_sink,
+    flush_file_sink,
+    close_file_sink,
+    free_sat_memory
+};
+
+//function definition
+//create a telemetry sink that appends batches (newline delimited json) to a local file or named pipe
+//the file location must outlive the sink
+TELEMETRY_SINK* new_file_telemetry_sink(const char* file_location)
+{
+    //local vars
+    FILE_SINK_CONTEXT* context;
+
+    //check input
+    if (file_location != NULL)
+    {
+        //allocate file sink state (owned by the sink)
+        context = allocate_sat_memory(SAT_MEMORY_FILE_SINK, sizeof (FILE_SINK_CONTEXT));
+
+        //if the object was successfully created
+        if (context != NULL)
+        {
+            context->file_location = file_location;
+            context->fd = -1;
+
+            return new_telemetry_sink("FILE", &FILE_SINK_INTERFACE, context);
+        }
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//open (creating if needed) the file for appending
+static bool open_file_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FILE_SINK_CONTEXT* context = (FILE_SINK_CONTEXT*)sink->context;
+
+    context->fd = open(context->file_location, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+    //if the file couldn't be opened
+    if (context->fd < 0)
+    {
+        fprintf(stderr, "ERROR: FAILED TO OPEN TELEMETRY FILE: %s!\n", context->file_location);
+
+        //failure
+        return false;
+    }
+
+    //success
+    return true;
+}
+
+//function definition
+//append the batch payload in a single write where possible
+static bool publish_batch_to_file_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    FILE_SINK_CONTEXT* context = (FILE_SINK_CONTEXT*)sink->context;
+    uint32_t bytes_written = 0;
+    ssize_t result;
+
+    //loop until the whole payload is written (a pipe may accept a partial write)
+    while (bytes_written < batch->payload_size)
+    {
+        result = write(context->fd, &(batch->payload[bytes_written]), batch->payload_size - bytes_written);
+
+        //if the write failed for a reason other than being interrupted
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                fprintf(stderr, "ERROR: FAILED TO WRITE TELEMETRY BATCH TO FILE: %s!\n", context->file_location);
+
+                //failure
+                return false;
+            }
+        }
+        else
+        {
+            bytes_written += (uint32_t)result;
+        }
+    }
+
+    increment_metrics_counter(METRICS_BYTES_SENT, bytes_written);
+
+    //success
+    return true;
+}
+
+//function definition
+//push written batches to storage (a pipe has nothing to sync, which is not a failure)
+static bool flush_file_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FILE_SINK_CONTEXT* context = (FILE_SINK_CONTEXT*)sink->context;
+
+    return ((fdatasync(context->fd) == 0) || (errno == EINVAL));
+}
+
+//function definition
+//close the file
+static bool close_file_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FILE_SINK_CONTEXT* context = (FILE_SINK_CONTEXT*)sink->context;
+    bool operation_status;
+
+    operation_status = (close(context->fd) == 0);
+    context->fd = -1;
+
+    return operation_status;
+}
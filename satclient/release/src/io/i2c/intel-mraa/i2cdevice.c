@@ -4,9 +4,11 @@
 */
 
 #include <stdio.h>          //using for "printf" function
-#include <stdlib.h>         //using for "malloc" and "free" functions, and "NULL" macro
+#include <stdlib.h>         //using for "NULL" macro
 #include <string.h>         //using "memcpy" function
 #include "i2cdevice.h"
+#include "metrics.h"        //using for "get_metrics_time_ns", "record_metrics_histogram", and "increment_metrics_counter" functions
+#include "trace.h"          //using for "TRACE_COMPLETE" macro
 
 //global vars
 static const int READ_BYTE_FAILURE = -1;
@@ -18,6 +20,9 @@ static const int READ_BYTE_FAILURE = -1;
 */
 static const uint8_t ENABLE_ADDRESS_AUTO_INCREMENT = 0x80;
 
+//function declarations
+static bool record_i2c_transaction(int64_t, bool);
+
 //function definition
 //init the i2c device
 bool init_i2c_device(I2C_DEVICE* device, const int bus, const uint8_t device_addr)
@@ -65,15 +70,17 @@ bool read_byte(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* data_bu
 {
     //local vars
     int read_result;    //byte read is returned as int since a signed error code is also a possible result, therefore we check for error code then cast to byte
+    int64_t start_time; //when the transaction started
 
     //check inputs
     if ((device != NULL) && (data_buffer != NULL))
     {
         //read byte (returned as int)
+        start_time = get_metrics_time_ns();
         read_result = mraa_i2c_read_byte_data(device->i2c_context, register_addr);
 
         //check result status (if no error)
-        if (read_result != READ_BYTE_FAILURE)
+        if (record_i2c_transaction(start_time, (read_result != READ_BYTE_FAILURE)))
         {
             //cast read_result to byte and store in supplied byte buffer
             *data_buffer = (uint8_t)read_result;
@@ -95,11 +102,15 @@ bool read_byte(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* data_bu
 */
 bool read_bytes(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* data_buffer, const int count_of_bytes_to_read)
 {
+    //local vars
+    int64_t start_time; //when the transaction started
+
     //check inputs
     if ((device != NULL) && (data_buffer != NULL))
     {
         //read bytes and check result status
-        if (mraa_i2c_read_bytes_data(device->i2c_context, (register_addr | ENABLE_ADDRESS_AUTO_INCREMENT), data_buffer, count_of_bytes_to_read) == count_of_bytes_to_read)
+        start_time = get_metrics_time_ns();
+        if (record_i2c_transaction(start_time, (mraa_i2c_read_bytes_data(device->i2c_context, (register_addr | ENABLE_ADDRESS_AUTO_INCREMENT), data_buffer, count_of_bytes_to_read) == count_of_bytes_to_read)))
         {
             //success
             return true;
@@ -114,11 +125,15 @@ bool read_bytes(I2C_DEVICE* device, const uint8_t register_addr, uint8_t* data_b
 //write a byte of data to the device at a particular register address
 bool write_byte(I2C_DEVICE* device, const uint8_t register_addr, const uint8_t data)
 {
+    //local vars
+    int64_t start_time; //when the transaction started
+
     //check input
     if (device != NULL)
     {
         //write byte and check result status
-        if (mraa_i2c_write_byte_data(device->i2c_context, data, register_addr) == MRAA_SUCCESS)
+        start_time = get_metrics_time_ns();
+        if (record_i2c_transaction(start_time, (mraa_i2c_write_byte_data(device->i2c_context, data, register_addr) == MRAA_SUCCESS)))
         {
             //success
             return true;
@@ -139,39 +154,45 @@ bool write_bytes(I2C_DEVICE* device, const uint8_t register_addr, const uint8_t*
 {
     //local vars
     mraa_result_t result;
-    uint8_t* write_buffer;
+    uint8_t write_buffer[I2C_DEVICE_MAX_WRITE_SIZE + 1];   //the register and the data to write (on the stack, so a write never allocates)
+    int64_t start_time; //when the transaction started
 
-    //check input
-    if (device != NULL)
+    //check inputs
+    if ((device != NULL) && (count_of_bytes_to_write >= 0) && (count_of_bytes_to_write <= I2C_DEVICE_MAX_WRITE_SIZE))
     {
-        //allocate a buffer that can hold the register and the data to write
-        //(no need to zero memory (e.g. calloc) as we're writing to it immediately
-        write_buffer = malloc((count_of_bytes_to_write + 1) * (sizeof (uint8_t)));
-
-        //if the buffer was successfully created
-        if (write_buffer != NULL)
-        {
-            //write register addr
-            write_buffer[0] = (register_addr | ENABLE_ADDRESS_AUTO_INCREMENT);
+        //write register addr
+        write_buffer[0] = (register_addr | ENABLE_ADDRESS_AUTO_INCREMENT);
 
-            //tag on the rest of the data to be written at the particular register addr
-            memcpy(&(write_buffer[1]), data, count_of_bytes_to_write);
+        //tag on the rest of the data to be written at the particular register addr
+        memcpy(&(write_buffer[1]), data, count_of_bytes_to_write);
 
-            //write bytes
-            result = mraa_i2c_write(device->i2c_context, write_buffer, count_of_bytes_to_write);
+        //write bytes
+        start_time = get_metrics_time_ns();
+        result = mraa_i2c_write(device->i2c_context, write_buffer, count_of_bytes_to_write);
 
-            //deallocate buffer
-            free(write_buffer);
-
-            //check result status
-            if (result == MRAA_SUCCESS)
-            {
-                //success
-                return true;
-            }
+        //check result status
+        if (record_i2c_transaction(start_time, (result == MRAA_SUCCESS)))
+        {
+            //success
+            return true;
         }
     }
 
     //failure
     return false;
 }
+
+//function definition
+//record the duration of a transaction (and whether it failed), passes through whether it succeeded
+static bool record_i2c_transaction(int64_t start_time, bool succeeded)
+{
+    record_metrics_histogram(METRICS_I2C_TRANSACTION_NS, (uint64_t)(get_metrics_time_ns() - start_time));
+    TRACE_COMPLETE("i2c transaction", start_time);
+
+    if (!succeeded)
+    {
+        increment_metrics_counter(METRICS_I2C_ERRORS, 1);
+    }
+
+    return succeeded;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2010-2015 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/**
+ * @file aws_iot_json_stream.h
+ * @brief Incremental JSON parsing for documents larger than the receive buffer
+ *
+ * The stream parser is fed a JSON document in chunks (e.g. as the MQTT client reads a large publish) and can be
+ * resumed at any byte. It keeps no more than the parser state, the key of each enclosing member, and the value
+ * being parsed, so a document of any length is parsed in bounded memory. Every string and primitive value is handed
+ * to a callback as soon as it ends, along with its depth and the keys leading to it, rather than as tokens of the
+ * whole document (which the JSON utilities need to hold in memory).
+ *
+ * Values are handed over as they appear in the document (strings without their quotes, escapes untouched, as jsmn
+ * does). Objects and arrays aren't handed over, only the values inside them.
+ */
+
+#ifndef AWS_IOT_SDK_SRC_JSON_STREAM_H_
+#define AWS_IOT_SDK_SRC_JSON_STREAM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aws_iot_error.h"
+
+#define JSON_STREAM_MAX_DEPTH 8 ///< Deepest nesting of objects and arrays a streamed document may have
+#define JSON_STREAM_MAX_KEY_SIZE 64 ///< Longest key kept (including the terminator), longer keys match nothing
+
+typedef struct _JsonStream JsonStream_t;
+
+/**
+ * @brief Stream Value Callback
+ *
+ * Called with every string and primitive value once it ends (the value is null terminated). A value longer than the
+ * value buffer is handed over truncated to its size, with isTruncated set.
+ */
+typedef void (*jsonStreamValueCallback_t)(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength,
+										  bool isString, bool isTruncated, void *pContext);
+
+typedef enum {
+	JSON_STREAM_EXPECT_DOCUMENT, JSON_STREAM_EXPECT_KEY, JSON_STREAM_IN_KEY, JSON_STREAM_EXPECT_COLON,
+	JSON_STREAM_EXPECT_VALUE, JSON_STREAM_IN_STRING, JSON_STREAM_IN_PRIMITIVE, JSON_STREAM_EXPECT_NEXT,
+	JSON_STREAM_COMPLETE, JSON_STREAM_ERROR
+} JsonStreamState_t;
+
+/**
+ * @brief Stream Parser
+ *
+ * Parser state between chunks. The depth and keys may be read from the value callback (see
+ * aws_iot_json_stream_get_key), the rest is private to the parser.
+ */
+struct _JsonStream {
+	JsonStreamState_t state;
+	uint8_t depth; ///< Objects and arrays enclosing the current value (1 for a member of the top level object)
+	uint32_t arrayDepths; ///< Bit per depth, set when that depth is an array
+	char keys[JSON_STREAM_MAX_DEPTH][JSON_STREAM_MAX_KEY_SIZE]; ///< Key of the current member at each depth ("" in an array)
+	bool isKeyTruncated[JSON_STREAM_MAX_DEPTH];
+	uint16_t keyLength; ///< Length of the key being parsed
+	char *pValueBuffer;
+	size_t valueBufferSize;
+	size_t valueLength;
+	bool isValueTruncated;
+	bool isEscaped; ///< The previous character of the current string was an unescaped backslash
+	jsonStreamValueCallback_t callback;
+	void *pContext;
+};
+
+/**
+ * @brief Initialize a Stream Parser
+ *
+ * Called before the first chunk of each document.
+ *
+ * @param pStream Parser to initialize
+ * @param pValueBuffer Buffer each value is gathered in (the longest value handed over is one less than its size)
+ * @param valueBufferSize Size of the value buffer
+ * @param callback Called with every string and primitive value
+ * @param pContext Passed to the callback
+ */
+void aws_iot_json_stream_init(JsonStream_t *pStream, char *pValueBuffer, size_t valueBufferSize,
+							  jsonStreamValueCallback_t callback, void *pContext);
+
+/**
+ * @brief Parse the next chunk of a document
+ *
+ * The value callback is called from here for every value that ends in the chunk. Once the document's top level
+ * object is complete, anything but whitespace (or null terminators) after it is an error.
+ *
+ * @param pStream Parser the document is being fed to
+ * @param pChunk Next bytes of the document
+ * @param chunkLength Number of bytes in the chunk
+ *
+ * @return SUCCESS if the document is valid so far, JSON_PARSE_ERROR (from then on) if it isn't
+ */
+IoT_Error_t aws_iot_json_stream_feed(JsonStream_t *pStream, const char *pChunk, size_t chunkLength);
+
+/**
+ * @brief Check if a whole document has been parsed
+ *
+ * @param pStream Parser the document was fed to
+ *
+ * @return true if the document's top level object is complete (and valid)
+ */
+bool aws_iot_json_stream_is_complete(const JsonStream_t *pStream);
+
+/**
+ * @brief Get the key leading to the current value at a depth
+ *
+ * @param pStream Parser the document is being fed to
+ * @param depth Depth of the key (1 for the top level object's member, up to the current value's depth)
+ *
+ * @return The key ("" in an array or beyond the current depth), NULL if it was too long to keep
+ */
+const char *aws_iot_json_stream_get_key(const JsonStream_t *pStream, uint8_t depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AWS_IOT_SDK_SRC_JSON_STREAM_H_
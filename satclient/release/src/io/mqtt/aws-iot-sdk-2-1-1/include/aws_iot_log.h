@@ -35,6 +35,10 @@ extern "C" {
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifdef SATCLIENT_TRACE
+#include "trace.h"
+#endif
+
 /**
  * @brief Debug level logging macro.
  *
@@ -47,6 +51,9 @@ extern "C" {
 	printf(__VA_ARGS__); \
 	printf("\n"); \
 	}
+#elif defined(SATCLIENT_TRACE)
+/* records an instant event (the line) in the binary trace instead of formatting the message */
+#define IOT_DEBUG(...) TRACE_INSTANT(__func__, __LINE__)
 #else
 #define IOT_DEBUG(...)
 #endif
@@ -56,7 +63,22 @@ extern "C" {
  *
  * Macro to print message function entry and exit
  */
-#ifdef ENABLE_IOT_TRACE
+#if defined(SATCLIENT_TRACE) && !defined(ENABLE_IOT_TRACE)
+/* records function spans (and their return codes) in the binary trace, see trace.h */
+#define FUNC_ENTRY    \
+	{\
+	TRACE_BEGIN(__func__);  \
+	}
+#define FUNC_EXIT    \
+	{\
+	TRACE_END(__func__);  \
+	}
+#define FUNC_EXIT_RC(x)    \
+	{\
+	TRACE_END_WITH_VALUE(__func__, x);  \
+	return x; \
+	}
+#elif defined(ENABLE_IOT_TRACE)
 #define FUNC_ENTRY    \
 	{\
 	printf("FUNC_ENTRY:   %s L#%d \n", __func__, __LINE__);  \
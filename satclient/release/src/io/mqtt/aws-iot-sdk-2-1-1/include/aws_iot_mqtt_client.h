@@ -220,6 +220,19 @@ typedef enum _ClientState {
 typedef void (*pApplicationHandler_t)(AWS_IoT_Client *pClient, char *pTopicName, uint16_t topicNameLen,
 									  IoT_Publish_Message_Params *pParams, void *pClientData);
 
+/**
+ * @brief Application Chunk Callback Handler Type
+ *
+ * Defining a TYPE for definition of application chunk callback function pointers.
+ * Used to send incoming publishes larger than the read buffer to the application, a chunk at a time as they are
+ * read. The params' payload and payloadLen are those of the chunk, which starts at payloadOffset of a payload of
+ * payloadTotalLen bytes. Chunks are handed over in order, the last one ends at payloadTotalLen.
+ *
+ */
+typedef void (*pApplicationChunkHandler_t)(AWS_IoT_Client *pClient, char *pTopicName, uint16_t topicNameLen,
+										   IoT_Publish_Message_Params *pParams, size_t payloadOffset,
+										   size_t payloadTotalLen, void *pClientData);
+
 /**
  * @brief MQTT Message Handler
  *
@@ -232,6 +245,7 @@ typedef struct _MessageHandlers {
 	uint16_t topicNameLen;
 	QoS qos;
 	pApplicationHandler_t pApplicationHandler;
+	pApplicationChunkHandler_t pApplicationChunkHandler; ///< Called with publishes larger than the read buffer (dropped if NULL)
 	void *pApplicationHandlerData;
 } MessageHandlers;   /* Message handlers are indexed by subscription topic */
 
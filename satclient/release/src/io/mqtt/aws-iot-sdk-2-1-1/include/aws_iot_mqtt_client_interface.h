@@ -132,6 +132,23 @@ IoT_Error_t aws_iot_mqtt_subscribe(AWS_IoT_Client *pClient, const char *pTopicNa
  */
 IoT_Error_t aws_iot_mqtt_resubscribe(AWS_IoT_Client *pClient);
 
+/**
+ * @brief Set the chunk handler of a subscription
+ *
+ * Called to have publishes on a subscribed topic that are larger than the read buffer handed to the application a
+ * chunk at a time, as they are read, rather than dropped. Publishes that fit the read buffer still go to the
+ * subscription's handler. The chunk handler is kept across resubscribes and removed on unsubscribe.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicFilter Topic filter the subscription was made with
+ * @param topicFilterLen Length of the topic filter
+ * @param pApplicationChunkHandler Reference to the chunk handler function for the subscription (NULL to drop large publishes)
+ *
+ * @return SUCCESS, or FAILURE if there is no subscription to the topic filter
+ */
+IoT_Error_t aws_iot_mqtt_set_chunk_handler(AWS_IoT_Client *pClient, const char *pTopicFilter, uint16_t topicFilterLen,
+										   pApplicationChunkHandler_t pApplicationChunkHandler);
+
 /**
  * @brief Unsubscribe to an MQTT topic.
  *
@@ -167,7 +167,7 @@ typedef enum {
  * @param pThingName Thing Name of the response received
  * @param action The response of the action
  * @param status Informs if the action was Accepted/Rejected or Timed out
- * @param pReceivedJsonDocument Received JSON document
+ * @param pReceivedJsonDocument Received JSON document (empty if it was larger than the RX buffer, it was then only read for its client token and version)
  * @param pContextData the void* data passed in during the action call(update, get or delete)
  *
  */
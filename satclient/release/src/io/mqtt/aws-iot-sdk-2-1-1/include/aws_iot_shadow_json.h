@@ -31,6 +31,12 @@ bool isJsonValidAndParse(const char *pJsonDocument, void *pJsonHandler, int32_t
 bool isJsonKeyMatchingAndUpdateValue(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount,
 									 jsonStruct_t *pDataStruct, uint32_t *pDataLength, int32_t *pDataPosition);
 
+bool getJsonKeyOfToken(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount, int32_t tokenIndex,
+					   const char **ppKey, uint32_t *pKeyLength);
+
+void updateValueOfJsonKeyToken(const char *pJsonDocument, void *pJsonHandler, int32_t tokenIndex,
+							   jsonStruct_t *pDataStruct, uint32_t *pDataLength, int32_t *pDataPosition);
+
 void aws_iot_shadow_internal_get_request_json(char *pJsonDocument);
 
 void aws_iot_shadow_internal_delete_request_json(char *pJsonDocument);
@@ -44,6 +50,12 @@ void FillWithClientToken(char *pStringToUpdateClientToken);
 
 bool extractClientToken(const char *pJsonDocumentToBeSent, char *pExtractedClientToken);
 
+bool extractClientTokenFromTokens(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount,
+								  char *pExtractedClientToken);
+
+IoT_Error_t updateValueOfStreamedJsonKey(const char *pValue, uint32_t valueLength, bool isString,
+										 jsonStruct_t *pDataStruct);
+
 bool extractVersionNumber(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount, uint32_t *pVersionNumber);
 
 #ifdef __cplusplus
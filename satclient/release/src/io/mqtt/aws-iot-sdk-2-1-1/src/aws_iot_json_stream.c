@@ -0,0 +1,259 @@
+/*
+ * Copyright 2010-2015 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/**
+ * @file aws_iot_json_stream.c
+ * @brief Incremental JSON parsing definitions
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "aws_iot_json_stream.h"
+
+#include <string.h>
+
+// local helper functions
+static bool isJsonWhitespace(char c);
+
+static bool isJsonPrimitiveCharacter(char c);
+
+static bool pushJsonContainer(JsonStream_t *pStream, bool isArray);
+
+static bool popJsonContainer(JsonStream_t *pStream, bool isArray);
+
+static void appendJsonValueCharacter(JsonStream_t *pStream, char c);
+
+static void endJsonValue(JsonStream_t *pStream, bool isString);
+
+static bool isJsonWhitespace(char c) {
+	return (' ' == c || '\t' == c || '\n' == c || '\r' == c);
+}
+
+static bool isJsonPrimitiveCharacter(char c) {
+	return ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || '-' == c || '+' == c ||
+			'.' == c);
+}
+
+static bool pushJsonContainer(JsonStream_t *pStream, bool isArray) {
+	if(pStream->depth >= JSON_STREAM_MAX_DEPTH) {
+		return false;
+	}
+
+	if(isArray) {
+		pStream->arrayDepths |= (1u << pStream->depth);
+	} else {
+		pStream->arrayDepths &= ~(1u << pStream->depth);
+	}
+	pStream->keys[pStream->depth][0] = '\0';
+	pStream->isKeyTruncated[pStream->depth] = false;
+	pStream->depth++;
+
+	return true;
+}
+
+static bool popJsonContainer(JsonStream_t *pStream, bool isArray) {
+	bool isCurrentArray;
+
+	if(0 == pStream->depth) {
+		return false;
+	}
+
+	isCurrentArray = (0 != (pStream->arrayDepths & (1u << (pStream->depth - 1))));
+	if(isCurrentArray != isArray) {
+		return false;
+	}
+	pStream->depth--;
+
+	return true;
+}
+
+static void appendJsonValueCharacter(JsonStream_t *pStream, char c) {
+	if(pStream->valueLength + 1 < pStream->valueBufferSize) {
+		pStream->pValueBuffer[pStream->valueLength] = c;
+		pStream->valueLength++;
+	} else {
+		pStream->isValueTruncated = true;
+	}
+}
+
+static void endJsonValue(JsonStream_t *pStream, bool isString) {
+	if(pStream->valueBufferSize > 0) {
+		pStream->pValueBuffer[pStream->valueLength] = '\0';
+	}
+	if(NULL != pStream->callback) {
+		pStream->callback(pStream, pStream->pValueBuffer, (uint32_t) pStream->valueLength, isString,
+						  pStream->isValueTruncated, pStream->pContext);
+	}
+}
+
+void aws_iot_json_stream_init(JsonStream_t *pStream, char *pValueBuffer, size_t valueBufferSize,
+							  jsonStreamValueCallback_t callback, void *pContext) {
+	pStream->state = JSON_STREAM_EXPECT_DOCUMENT;
+	pStream->depth = 0;
+	pStream->arrayDepths = 0;
+	pStream->keyLength = 0;
+	pStream->pValueBuffer = pValueBuffer;
+	pStream->valueBufferSize = (NULL != pValueBuffer) ? valueBufferSize : 0;
+	pStream->valueLength = 0;
+	pStream->isValueTruncated = false;
+	pStream->isEscaped = false;
+	pStream->callback = callback;
+	pStream->pContext = pContext;
+}
+
+IoT_Error_t aws_iot_json_stream_feed(JsonStream_t *pStream, const char *pChunk, size_t chunkLength) {
+	size_t i;
+	char c;
+	bool isArray;
+	char *pKey;
+
+	for(i = 0; i < chunkLength && JSON_STREAM_ERROR != pStream->state; i++) {
+		c = pChunk[i];
+		isArray = (pStream->depth > 0 && 0 != (pStream->arrayDepths & (1u << (pStream->depth - 1))));
+
+		// a primitive ends at the first character that isn't part of it, which is then parsed as what follows it
+		if(JSON_STREAM_IN_PRIMITIVE == pStream->state) {
+			if(isJsonPrimitiveCharacter(c)) {
+				appendJsonValueCharacter(pStream, c);
+				continue;
+			}
+			endJsonValue(pStream, false);
+			pStream->state = JSON_STREAM_EXPECT_NEXT;
+		}
+
+		switch(pStream->state) {
+			case JSON_STREAM_EXPECT_DOCUMENT:
+				if('{' == c) {
+					pushJsonContainer(pStream, false);
+					pStream->state = JSON_STREAM_EXPECT_KEY;
+				} else if(!isJsonWhitespace(c)) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			case JSON_STREAM_EXPECT_KEY:
+				if('"' == c) {
+					pStream->keyLength = 0;
+					pStream->keys[pStream->depth - 1][0] = '\0';
+					pStream->isKeyTruncated[pStream->depth - 1] = false;
+					pStream->isEscaped = false;
+					pStream->state = JSON_STREAM_IN_KEY;
+				} else if('}' == c) {
+					// an empty object (or a trailing comma, which jsmn allows as well)
+					popJsonContainer(pStream, false);
+					pStream->state = (0 == pStream->depth) ? JSON_STREAM_COMPLETE : JSON_STREAM_EXPECT_NEXT;
+				} else if(!isJsonWhitespace(c)) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			case JSON_STREAM_IN_KEY:
+				pKey = pStream->keys[pStream->depth - 1];
+				if('"' == c && !pStream->isEscaped) {
+					pKey[pStream->keyLength] = '\0';
+					pStream->state = JSON_STREAM_EXPECT_COLON;
+				} else {
+					pStream->isEscaped = ('\\' == c && !pStream->isEscaped);
+					if(pStream->keyLength + 1 < JSON_STREAM_MAX_KEY_SIZE) {
+						pKey[pStream->keyLength] = c;
+						pStream->keyLength++;
+					} else {
+						pStream->isKeyTruncated[pStream->depth - 1] = true;
+					}
+				}
+				break;
+			case JSON_STREAM_EXPECT_COLON:
+				if(':' == c) {
+					pStream->state = JSON_STREAM_EXPECT_VALUE;
+				} else if(!isJsonWhitespace(c)) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			case JSON_STREAM_EXPECT_VALUE:
+				pStream->valueLength = 0;
+				pStream->isValueTruncated = false;
+				if('"' == c) {
+					pStream->isEscaped = false;
+					pStream->state = JSON_STREAM_IN_STRING;
+				} else if('{' == c) {
+					pStream->state = pushJsonContainer(pStream, false) ? JSON_STREAM_EXPECT_KEY : JSON_STREAM_ERROR;
+				} else if('[' == c) {
+					pStream->state = pushJsonContainer(pStream, true) ? JSON_STREAM_EXPECT_VALUE : JSON_STREAM_ERROR;
+				} else if(']' == c && isArray) {
+					// an empty array
+					popJsonContainer(pStream, true);
+					pStream->state = JSON_STREAM_EXPECT_NEXT;
+				} else if(isJsonPrimitiveCharacter(c)) {
+					appendJsonValueCharacter(pStream, c);
+					pStream->state = JSON_STREAM_IN_PRIMITIVE;
+				} else if(!isJsonWhitespace(c)) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			case JSON_STREAM_IN_STRING:
+				if('"' == c && !pStream->isEscaped) {
+					endJsonValue(pStream, true);
+					pStream->state = JSON_STREAM_EXPECT_NEXT;
+				} else {
+					pStream->isEscaped = ('\\' == c && !pStream->isEscaped);
+					appendJsonValueCharacter(pStream, c);
+				}
+				break;
+			case JSON_STREAM_EXPECT_NEXT:
+				if(',' == c) {
+					pStream->state = isArray ? JSON_STREAM_EXPECT_VALUE : JSON_STREAM_EXPECT_KEY;
+				} else if('}' == c || ']' == c) {
+					if(!popJsonContainer(pStream, (']' == c))) {
+						pStream->state = JSON_STREAM_ERROR;
+					} else if(0 == pStream->depth) {
+						pStream->state = JSON_STREAM_COMPLETE;
+					}
+				} else if(!isJsonWhitespace(c)) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			case JSON_STREAM_COMPLETE:
+				// the document may be null terminated, as the ones jsmn parses
+				if(!isJsonWhitespace(c) && '\0' != c) {
+					pStream->state = JSON_STREAM_ERROR;
+				}
+				break;
+			default:
+				pStream->state = JSON_STREAM_ERROR;
+				break;
+		}
+	}
+
+	return (JSON_STREAM_ERROR == pStream->state) ? JSON_PARSE_ERROR : SUCCESS;
+}
+
+bool aws_iot_json_stream_is_complete(const JsonStream_t *pStream) {
+	return (JSON_STREAM_COMPLETE == pStream->state);
+}
+
+const char *aws_iot_json_stream_get_key(const JsonStream_t *pStream, uint8_t depth) {
+	if(0 == depth || depth > pStream->depth) {
+		return "";
+	}
+	if(pStream->isKeyTruncated[depth - 1]) {
+		return NULL;
+	}
+
+	return pStream->keys[depth - 1];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -345,18 +345,209 @@ static IoT_Error_t _aws_iot_mqtt_internal_decode_packet_remaining_len(AWS_IoT_Cl
 	FUNC_EXIT_RC(rc);
 }
 
-static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, Timer *pTimer, uint8_t *pPacketType) {
-	size_t len, rem_len, total_bytes_read, bytes_to_be_read, read_len;
+// assume topic filter and name is in correct format
+// # can only be at end
+// + and # can only be next to separator
+static char _aws_iot_mqtt_internal_is_topic_matched(char *pTopicFilter, char *pTopicName, uint16_t topicNameLen) {
+
+	char *curf, *curn, *curn_end;
+
+	if(NULL == pTopicFilter || NULL == pTopicName) {
+		return NULL_VALUE_ERROR;
+	}
+
+	curf = pTopicFilter;
+	curn = pTopicName;
+	curn_end = curn + topicNameLen;
+
+	while(*curf && (curn < curn_end)) {
+		if(*curn == '/' && *curf != '/') {
+			break;
+		}
+		if(*curf != '+' && *curf != '#' && *curf != *curn) {
+			break;
+		}
+		if(*curf == '+') {
+			/* skip until we meet the next separator, or end of string */
+			char *nextpos = curn + 1;
+			while(nextpos < curn_end && *nextpos != '/')
+				nextpos = ++curn + 1;
+		} else if(*curf == '#') {
+			/* skip until end of string */
+			curn = curn_end - 1;
+		}
+
+		curf++;
+		curn++;
+	};
+
+	return (curn == curn_end) && (*curf == '\0');
+}
+
+static void _aws_iot_mqtt_internal_drain_packet(AWS_IoT_Client *pClient, size_t remLen, Timer *pTimer) {
+	size_t total_bytes_read, bytes_to_be_read, read_len;
 	IoT_Error_t rc;
+
+	total_bytes_read = 0;
+	read_len = 0;
+	rc = SUCCESS;
+	while(total_bytes_read < remLen && SUCCESS == rc) {
+		if((remLen - total_bytes_read) >= pClient->clientData.readBufSize) {
+			bytes_to_be_read = pClient->clientData.readBufSize;
+		} else {
+			bytes_to_be_read = remLen - total_bytes_read;
+		}
+		rc = pClient->networkStack.read(&(pClient->networkStack), pClient->clientData.readBuf, bytes_to_be_read,
+										pTimer, &read_len);
+		if(SUCCESS == rc) {
+			total_bytes_read += read_len;
+		}
+	}
+}
+
+/**
+ * @brief Stream a publish larger than the read buffer to the chunk handlers of its subscriptions
+ *
+ * Called once the fixed header has been read. The variable header (topic name and packet id) is kept at the start of
+ * the read buffer, the rest of it is filled with a chunk of the payload at a time which is handed to every chunk
+ * handler before the next one is read, so a payload of any length is received in the read buffer. The publish is
+ * acknowledged once it has been streamed. If no subscription takes chunks the publish is drained and dropped.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param remLen Remaining length of the publish
+ * @param pTimer Timer for reading the publish
+ * @param pAckTimer Timer for acknowledging the publish, the one a publish read whole is acknowledged with
+ *
+ * @return SUCCESS if the publish was streamed, MQTT_RX_BUFFER_TOO_SHORT_ERROR if it was dropped
+ */
+static IoT_Error_t _aws_iot_mqtt_internal_stream_publish(AWS_IoT_Client *pClient, size_t remLen, Timer *pTimer,
+														   Timer *pAckTimer) {
+	unsigned char *curData;
+	unsigned char *pChunk;
+	char *pTopicName;
+	uint16_t topicNameLen;
+	size_t variableHeaderLen, chunkBufLen, payloadOffset, payloadTotalLen, chunkLen, read_len;
+	uint32_t itr, len;
+	bool isHandlerMatched[AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS];
+	bool isAnyHandlerMatched;
+	IoT_Publish_Message_Params msg;
 	MQTTHeader header = {0};
+	ClientState clientState;
+	IoT_Error_t rc;
+
+	FUNC_ENTRY;
+
+	header.byte = pClient->clientData.readBuf[0];
+	msg.qos = (QoS) header.bits.qos;
+	msg.isRetained = header.bits.retain;
+	msg.isDup = header.bits.dup;
+
+	/* the topic name length, the fixed header byte stays at the start of the buffer */
+	read_len = 0;
+	rc = pClient->networkStack.read(&(pClient->networkStack), pClient->clientData.readBuf + 1, 2, pTimer, &read_len);
+	if(SUCCESS != rc || 2 != read_len) {
+		FUNC_EXIT_RC(FAILURE);
+	}
+	curData = pClient->clientData.readBuf + 1;
+	topicNameLen = aws_iot_mqtt_internal_read_uint16_t(&curData);
+	variableHeaderLen = 2 + (size_t) topicNameLen + ((QOS0 != msg.qos) ? 2 : 0);
+
+	/* the variable header has to leave room in the buffer for chunks of the payload */
+	if(variableHeaderLen > remLen || (1 + variableHeaderLen) >= pClient->clientData.readBufSize) {
+		_aws_iot_mqtt_internal_drain_packet(pClient, remLen - 2, pTimer);
+		FUNC_EXIT_RC(MQTT_RX_BUFFER_TOO_SHORT_ERROR);
+	}
+
+	rc = pClient->networkStack.read(&(pClient->networkStack), curData, variableHeaderLen - 2, pTimer, &read_len);
+	if(SUCCESS != rc || (variableHeaderLen - 2) != read_len) {
+		FUNC_EXIT_RC(FAILURE);
+	}
+	pTopicName = (char *) curData;
+	curData += topicNameLen;
+
+	msg.id = (QOS0 != msg.qos) ? aws_iot_mqtt_internal_read_uint16_t(&curData) : 0;
+
+	/* Find the right message handlers - indexed by topic */
+	isAnyHandlerMatched = false;
+	for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++itr) {
+		isHandlerMatched[itr] = false;
+		if(NULL != pClient->clientData.messageHandlers[itr].topicName &&
+		   NULL != pClient->clientData.messageHandlers[itr].pApplicationChunkHandler) {
+			if(((topicNameLen == pClient->clientData.messageHandlers[itr].topicNameLen)
+				&&
+				(strncmp(pTopicName, (char *) pClient->clientData.messageHandlers[itr].topicName, topicNameLen) == 0))
+			   || _aws_iot_mqtt_internal_is_topic_matched((char *) pClient->clientData.messageHandlers[itr].topicName,
+														  pTopicName, topicNameLen)) {
+				isHandlerMatched[itr] = true;
+				isAnyHandlerMatched = true;
+			}
+		}
+	}
+
+	payloadTotalLen = remLen - variableHeaderLen;
+	if(!isAnyHandlerMatched) {
+		_aws_iot_mqtt_internal_drain_packet(pClient, payloadTotalLen, pTimer);
+		FUNC_EXIT_RC(MQTT_RX_BUFFER_TOO_SHORT_ERROR);
+	}
+
+	/* Yield should not be called while the chunk handlers run, as for message handlers */
+	clientState = aws_iot_mqtt_get_client_state(pClient);
+	aws_iot_mqtt_set_client_state(pClient, clientState, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN);
+
+	pChunk = pClient->clientData.readBuf + 1 + variableHeaderLen;
+	chunkBufLen = pClient->clientData.readBufSize - 1 - variableHeaderLen;
+	for(payloadOffset = 0; payloadOffset < payloadTotalLen && SUCCESS == rc; payloadOffset += chunkLen) {
+		chunkLen = payloadTotalLen - payloadOffset;
+		if(chunkLen > chunkBufLen) {
+			chunkLen = chunkBufLen;
+		}
+		rc = pClient->networkStack.read(&(pClient->networkStack), pChunk, chunkLen, pTimer, &read_len);
+		if(SUCCESS != rc || chunkLen != read_len) {
+			rc = FAILURE;
+			break;
+		}
+
+		msg.payload = pChunk;
+		msg.payloadLen = chunkLen;
+		for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++itr) {
+			if(isHandlerMatched[itr]) {
+				pClient->clientData.messageHandlers[itr].pApplicationChunkHandler(pClient, pTopicName, topicNameLen,
+																				  &msg, payloadOffset, payloadTotalLen,
+																				  pClient->clientData.messageHandlers[itr].pApplicationHandlerData);
+			}
+		}
+	}
+
+	aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN, clientState);
+	if(SUCCESS != rc || QOS0 == msg.qos) {
+		FUNC_EXIT_RC(rc);
+	}
+
+	/* Message assumed to be QoS1 since we do not support QoS2 at this time */
+	len = 0;
+	rc = aws_iot_mqtt_internal_serialize_ack(pClient->clientData.writeBuf, pClient->clientData.writeBufSize,
+											 PUBACK, 0, msg.id, &len);
+	if(SUCCESS != rc) {
+		FUNC_EXIT_RC(rc);
+	}
+
+	rc = aws_iot_mqtt_internal_send_packet(pClient, len, pAckTimer);
+
+	FUNC_EXIT_RC(rc);
+}
+
+static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, Timer *pTimer, uint8_t *pPacketType,
+													   bool *pIsStreamed) {
+	size_t len, rem_len, read_len;
+	IoT_Error_t rc;
+	MQTTHeader header = {0};
+	Timer *pAckTimer = pTimer;
 	Timer packetTimer;
 	init_timer(&packetTimer);
 	countdown_ms(&packetTimer, pClient->clientData.packetTimeoutMs);
 
 	len = 0;
 	rem_len = 0;
-	total_bytes_read = 0;
-	bytes_to_be_read = 0;
 	read_len = 0;
 
 	rc = pClient->networkStack.read(&(pClient->networkStack), pClient->clientData.readBuf, 1, pTimer, &read_len);
@@ -381,22 +572,21 @@ static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, T
 		return rc;
 	}
 
-	/* if the buffer is too short then the message will be dropped silently */
-	if(rem_len >= pClient->clientData.readBufSize) {
-		bytes_to_be_read = pClient->clientData.readBufSize;
-		do {
-			rc = pClient->networkStack.read(&(pClient->networkStack), pClient->clientData.readBuf, bytes_to_be_read,
-											pTimer, &read_len);
-			if(SUCCESS == rc) {
-				total_bytes_read += read_len;
-				if((rem_len - total_bytes_read) >= pClient->clientData.readBufSize) {
-					bytes_to_be_read = pClient->clientData.readBufSize;
-				} else {
-					bytes_to_be_read = rem_len - total_bytes_read;
-				}
-			}
-		} while(total_bytes_read < rem_len && SUCCESS == rc);
-		return MQTT_RX_BUFFER_TOO_SHORT_ERROR;
+	/* if the buffer is too short for the whole packet (fixed header included) then a publish is streamed to the chunk
+	 * handlers of its subscriptions, any other message (or a publish no subscription takes chunks of) will be dropped
+	 * silently */
+	header.byte = pClient->clientData.readBuf[0];
+	*pPacketType = header.bits.type;
+	*pIsStreamed = false;
+	if(aws_iot_mqtt_internal_get_final_packet_length_from_remaining_length((uint32_t) rem_len) >
+	   pClient->clientData.readBufSize) {
+		if(PUBLISH != header.bits.type) {
+			_aws_iot_mqtt_internal_drain_packet(pClient, rem_len, pTimer);
+			return MQTT_RX_BUFFER_TOO_SHORT_ERROR;
+		}
+		rc = _aws_iot_mqtt_internal_stream_publish(pClient, rem_len, pTimer, pAckTimer);
+		*pIsStreamed = (SUCCESS == rc);
+		return rc;
 	}
 
 	/* put the original remaining length into the read buffer */
@@ -411,51 +601,9 @@ static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, T
 		}
 	}
 
-	header.byte = pClient->clientData.readBuf[0];
-	*pPacketType = header.bits.type;
-
 	FUNC_EXIT_RC(rc);
 }
 
-// assume topic filter and name is in correct format
-// # can only be at end
-// + and # can only be next to separator
-static char _aws_iot_mqtt_internal_is_topic_matched(char *pTopicFilter, char *pTopicName, uint16_t topicNameLen) {
-
-	char *curf, *curn, *curn_end;
-
-	if(NULL == pTopicFilter || NULL == pTopicName) {
-		return NULL_VALUE_ERROR;
-	}
-
-	curf = pTopicFilter;
-	curn = pTopicName;
-	curn_end = curn + topicNameLen;
-
-	while(*curf && (curn < curn_end)) {
-		if(*curn == '/' && *curf != '/') {
-			break;
-		}
-		if(*curf != '+' && *curf != '#' && *curf != *curn) {
-			break;
-		}
-		if(*curf == '+') {
-			/* skip until we meet the next separator, or end of string */
-			char *nextpos = curn + 1;
-			while(nextpos < curn_end && *nextpos != '/')
-				nextpos = ++curn + 1;
-		} else if(*curf == '#') {
-			/* skip until end of string */
-			curn = curn_end - 1;
-		}
-
-		curf++;
-		curn++;
-	};
-
-	return (curn == curn_end) && (*curf == '\0');
-}
-
 static IoT_Error_t _aws_iot_mqtt_internal_deliver_message(AWS_IoT_Client *pClient, char *pTopicName,
 														  uint16_t topicNameLen,
 														  IoT_Publish_Message_Params *pMessageParams) {
@@ -547,6 +695,7 @@ static IoT_Error_t _aws_iot_mqtt_internal_handle_publish(AWS_IoT_Client *pClient
 
 IoT_Error_t aws_iot_mqtt_internal_cycle_read(AWS_IoT_Client *pClient, Timer *pTimer, uint8_t *pPacketType) {
 	IoT_Error_t rc;
+	bool isStreamed = false;
 
 #ifdef _ENABLE_THREAD_SUPPORT_
 	IoT_Error_t threadRc;
@@ -564,7 +713,7 @@ IoT_Error_t aws_iot_mqtt_internal_cycle_read(AWS_IoT_Client *pClient, Timer *pTi
 #endif
 
 	/* read the socket, see what work is due */
-	rc = _aws_iot_mqtt_internal_read_packet(pClient, pTimer, pPacketType);
+	rc = _aws_iot_mqtt_internal_read_packet(pClient, pTimer, pPacketType, &isStreamed);
 
 #ifdef _ENABLE_THREAD_SUPPORT_
 	threadRc = aws_iot_mqtt_client_unlock_mutex(pClient, &(pClient->clientData.tls_read_mutex));
@@ -588,7 +737,10 @@ IoT_Error_t aws_iot_mqtt_internal_cycle_read(AWS_IoT_Client *pClient, Timer *pTi
 			/* SDK is blocking, these responses will be forwarded to calling function to process */
 			break;
 		case PUBLISH: {
-			rc = _aws_iot_mqtt_internal_handle_publish(pClient, pTimer);
+			/* a streamed publish has been delivered (and acknowledged) as it was read */
+			if(!isStreamed) {
+				rc = _aws_iot_mqtt_internal_handle_publish(pClient, pTimer);
+			}
 			break;
 		}
 		case PUBREC:
@@ -262,6 +262,7 @@ static IoT_Error_t _aws_iot_mqtt_internal_subscribe(AWS_IoT_Client *pClient, con
 			topicNameLen;
 	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].pApplicationHandler =
 			pApplicationHandler;
+	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].pApplicationChunkHandler = NULL;
 	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].pApplicationHandlerData =
 			pApplicationHandlerData;
 	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].qos = qos;
@@ -321,6 +322,43 @@ IoT_Error_t aws_iot_mqtt_subscribe(AWS_IoT_Client *pClient, const char *pTopicNa
 	FUNC_EXIT_RC(subRc);
 }
 
+/**
+ * @brief Set the chunk handler of a subscription
+ *
+ * Called to have publishes on a subscribed topic that are larger than the read buffer handed to the application a
+ * chunk at a time, as they are read, rather than dropped. Only the subscription's handler entry is changed, nothing
+ * is sent to the broker.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicFilter Topic filter the subscription was made with
+ * @param topicFilterLen Length of the topic filter
+ * @param pApplicationChunkHandler Reference to the chunk handler function for the subscription (NULL to drop large publishes)
+ *
+ * @return SUCCESS, or FAILURE if there is no subscription to the topic filter
+ */
+IoT_Error_t aws_iot_mqtt_set_chunk_handler(AWS_IoT_Client *pClient, const char *pTopicFilter, uint16_t topicFilterLen,
+										   pApplicationChunkHandler_t pApplicationChunkHandler) {
+	uint32_t itr;
+	IoT_Error_t rc = FAILURE;
+
+	FUNC_ENTRY;
+
+	if(NULL == pClient || NULL == pTopicFilter) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; itr++) {
+		if(NULL != pClient->clientData.messageHandlers[itr].topicName &&
+		   topicFilterLen == pClient->clientData.messageHandlers[itr].topicNameLen &&
+		   0 == strncmp(pClient->clientData.messageHandlers[itr].topicName, pTopicFilter, topicFilterLen)) {
+			pClient->clientData.messageHandlers[itr].pApplicationChunkHandler = pApplicationChunkHandler;
+			rc = SUCCESS;
+		}
+	}
+
+	FUNC_EXIT_RC(rc);
+}
+
 /**
  * @brief Subscribe to an MQTT topic.
  *
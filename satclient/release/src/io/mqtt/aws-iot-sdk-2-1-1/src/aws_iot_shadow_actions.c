@@ -35,7 +35,7 @@ IoT_Error_t aws_iot_shadow_internal_action(const char *pThingName, ShadowActions
 	IoT_Error_t ret_val = SUCCESS;
 	bool isClientTokenPresent = false;
 	bool isAckWaitListFree = false;
-	uint8_t indexAckWaitList;
+	uint16_t indexAckWaitList;
 	char extractedClientToken[MAX_SIZE_CLIENT_ID_WITH_SEQUENCE];
 
 	FUNC_ENTRY;
@@ -47,7 +47,7 @@ IoT_Error_t aws_iot_shadow_internal_action(const char *pThingName, ShadowActions
 	isClientTokenPresent = extractClientToken(pJsonDocumentToBeSent, extractedClientToken);
 
 	if(isClientTokenPresent && (NULL != callback)) {
-		if(getNextFreeIndexOfAckWaitList(&indexAckWaitList)) {
+		if(getNextFreeIndexOfAckWaitList(extractedClientToken, &indexAckWaitList)) {
 			isAckWaitListFree = true;
 		}
 
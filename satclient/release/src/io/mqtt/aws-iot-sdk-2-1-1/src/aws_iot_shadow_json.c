@@ -395,6 +395,34 @@ bool isJsonKeyMatchingAndUpdateValue(const char *pJsonDocument, void *pJsonHandl
 	return false;
 }
 
+/* A key is a string token followed by its value (jsmn counts the value as the key's only child), so a string value
+ * with the same text as a key is never mistaken for one */
+bool getJsonKeyOfToken(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount, int32_t tokenIndex,
+					   const char **ppKey, uint32_t *pKeyLength) {
+	IOT_UNUSED(pJsonHandler);
+
+	if(tokenIndex < 1 || tokenIndex + 1 >= tokenCount || jsonTokenStruct[tokenIndex].type != JSMN_STRING ||
+	   jsonTokenStruct[tokenIndex].size != 1) {
+		return false;
+	}
+
+	*ppKey = pJsonDocument + jsonTokenStruct[tokenIndex].start;
+	*pKeyLength = (uint32_t) (jsonTokenStruct[tokenIndex].end - jsonTokenStruct[tokenIndex].start);
+	return true;
+}
+
+void updateValueOfJsonKeyToken(const char *pJsonDocument, void *pJsonHandler, int32_t tokenIndex,
+							   jsonStruct_t *pDataStruct, uint32_t *pDataLength, int32_t *pDataPosition) {
+	jsmntok_t dataToken;
+
+	IOT_UNUSED(pJsonHandler);
+
+	dataToken = jsonTokenStruct[tokenIndex + 1];
+	UpdateValueIfNoObject(pJsonDocument, pDataStruct, dataToken);
+	*pDataPosition = dataToken.start;
+	*pDataLength = (uint32_t) (dataToken.end - dataToken.start);
+}
+
 bool isReceivedJsonValid(const char *pJsonDocument) {
 	int32_t tokenCount;
 
@@ -417,9 +445,8 @@ bool isReceivedJsonValid(const char *pJsonDocument) {
 }
 
 bool extractClientToken(const char *pJsonDocument, char *pExtractedClientToken) {
-	int32_t tokenCount, i;
-	uint8_t length;
-	jsmntok_t ClientJsonToken;
+	int32_t tokenCount;
+
 	jsmn_init(&shadowJsonParser);
 
 	tokenCount = jsmn_parse(&shadowJsonParser, pJsonDocument, strlen(pJsonDocument), jsonTokenStruct,
@@ -435,10 +462,26 @@ bool extractClientToken(const char *pJsonDocument, char *pExtractedClientToken)
 		return false;
 	}
 
-	for(i = 1; i < tokenCount; i++) {
+	return extractClientTokenFromTokens(pJsonDocument, NULL, tokenCount, pExtractedClientToken);
+}
+
+/* Takes the tokens isJsonValidAndParse left of the document rather than parsing it again */
+bool extractClientTokenFromTokens(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount,
+								  char *pExtractedClientToken) {
+	int32_t i;
+	uint32_t length;
+	jsmntok_t ClientJsonToken;
+
+	IOT_UNUSED(pJsonHandler);
+
+	for(i = 1; i + 1 < tokenCount; i++) {
 		if(jsoneq(pJsonDocument, &jsonTokenStruct[i], SHADOW_CLIENT_TOKEN_STRING) == 0) {
 			ClientJsonToken = jsonTokenStruct[i + 1];
-			length = (uint8_t) (ClientJsonToken.end - ClientJsonToken.start);
+			length = (uint32_t) (ClientJsonToken.end - ClientJsonToken.start);
+			if(length >= MAX_SIZE_CLIENT_TOKEN_CLIENT_SEQUENCE) {
+				IOT_WARN("Client token longer than expected");
+				return false;
+			}
 			strncpy(pExtractedClientToken, pJsonDocument + ClientJsonToken.start, length);
 			pExtractedClientToken[length] = '\0';
 			return true;
@@ -448,6 +491,19 @@ bool extractClientToken(const char *pJsonDocument, char *pExtractedClientToken)
 	return false;
 }
 
+/* A streamed value is parsed as the value of a token spanning all of it */
+IoT_Error_t updateValueOfStreamedJsonKey(const char *pValue, uint32_t valueLength, bool isString,
+										 jsonStruct_t *pDataStruct) {
+	jsmntok_t dataToken;
+
+	dataToken.type = isString ? JSMN_STRING : JSMN_PRIMITIVE;
+	dataToken.start = 0;
+	dataToken.end = (int) valueLength;
+	dataToken.size = 0;
+
+	return UpdateValueIfNoObject(pValue, pDataStruct, dataToken);
+}
+
 bool extractVersionNumber(const char *pJsonDocument, void *pJsonHandler, int32_t tokenCount, uint32_t *pVersionNumber) {
 	int32_t i;
 	IoT_Error_t ret_val = SUCCESS;
@@ -29,8 +29,10 @@ extern "C" {
 
 #include "timer_interface.h"
 #include "aws_iot_json_utils.h"
+#include "aws_iot_json_stream.h"
 #include "aws_iot_log.h"
 #include "aws_iot_shadow_json.h"
+#include "aws_iot_shadow_key.h"
 #include "aws_iot_config.h"
 
 typedef struct {
@@ -40,7 +42,10 @@ typedef struct {
 	fpActionCallback_t callback;
 	void *pCallbackContext;
 	bool isFree;
-	Timer timer;
+	uint32_t wheelDueTick; ///< Tick of the timing wheel the ack times out at, its slot comes up once a turn until then
+	uint16_t wheelSlot;
+	uint16_t wheelNext; ///< Next ack in the same timing wheel slot
+	uint16_t wheelPrev;
 } ToBeReceivedAckRecord_t;
 
 typedef struct {
@@ -48,6 +53,7 @@ typedef struct {
 	void *pStruct;
 	jsonStructCallback_t callback;
 	bool isFree;
+	uint32_t matchedDeltaNum;
 } JsonTokenTable_t;
 
 typedef struct {
@@ -61,8 +67,28 @@ typedef enum {
 	SHADOW_ACCEPTED, SHADOW_REJECTED, SHADOW_ACTION
 } ShadowAckTopicTypes_t;
 
+/* Acks are kept in the slot their client token's sequence number hashes to (the next free one after it if taken), so
+ * an ack is matched with a single compare however many are awaited, as the sequence numbers of the acks in flight are
+ * consecutive. Their timeouts are kept in a hashed timing wheel of one second slots, so a yield only looks at the acks
+ * due in the seconds that have passed since the last one. The wheel's ticks are counted from when the records were
+ * initialized, so a yield that comes late still times out every ack that came due, at the tick it was due. */
 ToBeReceivedAckRecord_t AckWaitList[MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME];
 
+#define NO_ACK_RECORD 0xFFFF
+#define ACK_TIMER_WHEEL_SLOTS 64
+#define ACK_TIMER_WHEEL_TICK_MS 1000
+/* The wheel's clock counts down from ACK_TIMER_WHEEL_CLOCK_SPAN_MS, it's restarted a whole number of ticks later (the
+ * ticks then added to ackTimerWheelClockBaseTick) before it runs out */
+#define ACK_TIMER_WHEEL_CLOCK_SPAN_MS (1UL << 30)
+static uint16_t ackTimerWheel[ACK_TIMER_WHEEL_SLOTS];
+static Timer ackTimerWheelClock;
+static uint32_t ackTimerWheelClockBaseTick = 0;
+/* Last tick whose slot has been looked at */
+static uint32_t ackTimerWheelTick = 0;
+/* Furthest an awaited ack is from the slot its client token hashes to, which is as far as a lookup has to look */
+static uint16_t ackMaxProbeDistance = 0;
+static uint16_t ackInFlightCount = 0;
+
 AWS_IoT_Client *pMqttClient;
 
 char myThingName[MAX_SIZE_OF_THING_NAME];
@@ -78,41 +104,163 @@ char shadowRxBuf[SHADOW_MAX_SIZE_OF_RX_BUFFER];
 
 static JsonTokenTable_t tokenTable[MAX_JSON_TOKEN_EXPECTED];
 static uint32_t tokenTableIndex = 0;
+/* Indices of tokenTable sorted by key (registration order among equal keys), so each key in a delta is looked up with
+ * a binary search during a single pass over the parsed tokens, rather than every registered key scanning the tokens */
+static uint16_t tokenTableSortedIndex[MAX_JSON_TOKEN_EXPECTED];
+/* Sequence number of the delta being dispatched, a registered key only takes the first occurrence of its key in a delta */
+static uint32_t deltaNum = 0;
 static bool deltaTopicSubscribedFlag = false;
 uint32_t shadowJsonVersionNum = 0;
 bool shadowDiscardOldDeltaFlag = true;
 
+/* Documents larger than the RX buffer are streamed through a parser as the MQTT client reads them, with the values
+ * gathered in shadowRxBuf. What a streamed document is read for is kept here until it is complete. */
+static JsonStream_t shadowRxStream;
+static bool isStreamedDeltaDiscarded = false;
+static char streamedAckTopic[MAX_SHADOW_TOPIC_LENGTH_BYTES];
+static char streamedAckClientToken[MAX_SIZE_CLIENT_TOKEN_CLIENT_SEQUENCE];
+static bool isStreamedAckClientTokenFound = false;
+static uint32_t streamedAckVersionNumber = 0;
+static bool isStreamedAckVersionFound = false;
+
 // local helper functions
 static void AckStatusCallback(AWS_IoT_Client *pClient, char *topicName,
 							  uint16_t topicNameLen, IoT_Publish_Message_Params *params, void *pData);
 
+static void AckStatusChunkCallback(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
+								   IoT_Publish_Message_Params *params, size_t payloadOffset, size_t payloadTotalLen,
+								   void *pData);
+
+static void AckStatusStreamValueCallback(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength,
+										 bool isString, bool isTruncated, void *pContext);
+
+static void dispatchAckStatus(const char *pTopicName, const char *pClientToken, const char *pReceivedJsonDocument);
+
 static void shadow_delta_callback(AWS_IoT_Client *pClient, char *topicName,
 								  uint16_t topicNameLen, IoT_Publish_Message_Params *params, void *pData);
 
+static void shadow_delta_chunk_callback(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
+										IoT_Publish_Message_Params *params, size_t payloadOffset,
+										size_t payloadTotalLen, void *pData);
+
+static void shadow_delta_stream_value_callback(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength,
+											   bool isString, bool isTruncated, void *pContext);
+
 static void topicNameFromThingAndAction(char *pTopic, const char *pThingName, ShadowActions_t action,
 										ShadowAckTopicTypes_t ackType);
 
 static int16_t getNextFreeIndexOfSubscriptionList(void);
 
-static void unsubscribeFromAcceptedAndRejected(uint8_t index);
+static void unsubscribeFromAcceptedAndRejected(uint16_t index);
+
+static uint16_t homeIndexOfClientToken(const char *pClientToken);
+
+static bool findIndexOfAckWaitList(const char *pClientToken, uint16_t *pIndex);
+
+static uint32_t getAckTimerWheelElapsedMs(void);
+
+static void addToAckTimerWheel(uint16_t index, uint32_t timeout_seconds);
+
+static void removeFromAckTimerWheel(uint16_t index);
+
+static void freeAckWaitListEntry(uint16_t index);
+
+static int compareKeyWithJsonKey(const char *pKey, const char *pJsonKey, uint32_t jsonKeyLength);
+
+static uint32_t findFirstSortedTokenNotBelow(const char *pJsonKey, uint32_t jsonKeyLength);
+
+static void beginDeltaDispatch(void);
+
+static JsonTokenTable_t *takeNextEntryOfDeltaKey(const char *pJsonKey, uint32_t jsonKeyLength, uint32_t *pPosition);
 
 void initDeltaTokens(void) {
 	uint32_t i;
 	for(i = 0; i < MAX_JSON_TOKEN_EXPECTED; i++) {
 		tokenTable[i].isFree = true;
+		tokenTable[i].matchedDeltaNum = 0;
 	}
 	tokenTableIndex = 0;
+	deltaNum = 0;
 	deltaTopicSubscribedFlag = false;
 }
 
+/* strcmp of a registered key with a key in a JSON document (which isn't null terminated) */
+static int compareKeyWithJsonKey(const char *pKey, const char *pJsonKey, uint32_t jsonKeyLength) {
+	int result = strncmp(pKey, pJsonKey, jsonKeyLength);
+
+	// equal so far means pKey is at least jsonKeyLength long, it only matches if it ends there
+	if(0 == result && '\0' != pKey[jsonKeyLength]) {
+		result = 1;
+	}
+
+	return result;
+}
+
+/* Position in tokenTableSortedIndex of the first registered key that isn't below the supplied one */
+static uint32_t findFirstSortedTokenNotBelow(const char *pJsonKey, uint32_t jsonKeyLength) {
+	uint32_t low = 0;
+	uint32_t high = tokenTableIndex;
+	uint32_t middle;
+
+	while(low < high) {
+		middle = low + ((high - low) / 2);
+		if(compareKeyWithJsonKey(tokenTable[tokenTableSortedIndex[middle]].pKey, pJsonKey, jsonKeyLength) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+/* Number the delta about to be dispatched (starting the numbering over if it wraps, so no registered key looks matched
+ * already) */
+static void beginDeltaDispatch(void) {
+	uint32_t i;
+
+	deltaNum++;
+	if(0 == deltaNum) {
+		for(i = 0; i < tokenTableIndex; i++) {
+			tokenTable[i].matchedDeltaNum = 0;
+		}
+		deltaNum = 1;
+	}
+}
+
+/* Next registered entry of a key in the delta, from *pPosition on in tokenTableSortedIndex (start from
+ * findFirstSortedTokenNotBelow), that hasn't taken a value from this delta yet. NULL once there are no more. */
+static JsonTokenTable_t *takeNextEntryOfDeltaKey(const char *pJsonKey, uint32_t jsonKeyLength, uint32_t *pPosition) {
+	JsonTokenTable_t *pEntry;
+
+	while(*pPosition < tokenTableIndex) {
+		pEntry = &tokenTable[tokenTableSortedIndex[*pPosition]];
+		if(0 != compareKeyWithJsonKey(pEntry->pKey, pJsonKey, jsonKeyLength)) {
+			break;
+		}
+		(*pPosition)++;
+		if(!pEntry->isFree && deltaNum != pEntry->matchedDeltaNum) {
+			pEntry->matchedDeltaNum = deltaNum;
+			return pEntry;
+		}
+	}
+
+	return NULL;
+}
+
 IoT_Error_t registerJsonTokenOnDelta(jsonStruct_t *pStruct) {
 
 	IoT_Error_t rc = SUCCESS;
+	uint32_t position;
 
 	if(!deltaTopicSubscribedFlag) {
 		snprintf(shadowDeltaTopic, MAX_SHADOW_TOPIC_LENGTH_BYTES, "$aws/things/%s/shadow/update/delta", myThingName);
 		rc = aws_iot_mqtt_subscribe(pMqttClient, shadowDeltaTopic, (uint16_t) strlen(shadowDeltaTopic), QOS0,
 									shadow_delta_callback, NULL);
+		if(SUCCESS == rc) {
+			rc = aws_iot_mqtt_set_chunk_handler(pMqttClient, shadowDeltaTopic, (uint16_t) strlen(shadowDeltaTopic),
+												shadow_delta_chunk_callback);
+		}
 		deltaTopicSubscribedFlag = true;
 	}
 
@@ -124,6 +272,15 @@ IoT_Error_t registerJsonTokenOnDelta(jsonStruct_t *pStruct) {
 	tokenTable[tokenTableIndex].callback = pStruct->cb;
 	tokenTable[tokenTableIndex].pStruct = pStruct;
 	tokenTable[tokenTableIndex].isFree = false;
+	tokenTable[tokenTableIndex].matchedDeltaNum = 0;
+
+	// insert after any registered keys that sort at or below this one (keeping equal keys in registration order)
+	position = tokenTableIndex;
+	while(position > 0 && strcmp(tokenTable[tokenTableSortedIndex[position - 1]].pKey, pStruct->pKey) > 0) {
+		tokenTableSortedIndex[position] = tokenTableSortedIndex[position - 1];
+		position--;
+	}
+	tokenTableSortedIndex[position] = (uint16_t) tokenTableIndex;
 	tokenTableIndex++;
 
 	return rc;
@@ -180,7 +337,6 @@ static bool isAckForMyThingName(const char *pTopicName) {
 static void AckStatusCallback(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
 							  IoT_Publish_Message_Params *params, void *pData) {
 	int32_t tokenCount;
-	uint8_t i;
 	void *pJsonHandler = NULL;
 	char temporaryClientToken[MAX_SIZE_CLIENT_TOKEN_CLIENT_SEQUENCE];
 
@@ -210,28 +366,203 @@ static void AckStatusCallback(AWS_IoT_Client *pClient, char *topicName, uint16_t
 		}
 	}
 
-	if(extractClientToken(shadowRxBuf, temporaryClientToken)) {
-		for(i = 0; i < MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME; i++) {
-			if(!AckWaitList[i].isFree) {
-				if(strcmp(AckWaitList[i].clientTokenID, temporaryClientToken) == 0) {
-					Shadow_Ack_Status_t status;
-					if(strstr(topicName, "accepted") != NULL) {
-						status = SHADOW_ACK_ACCEPTED;
-					} else if(strstr(topicName, "rejected") != NULL) {
-						status = SHADOW_ACK_REJECTED;
-					}
-					if(status == SHADOW_ACK_ACCEPTED || status == SHADOW_ACK_REJECTED) {
-						if(AckWaitList[i].callback != NULL) {
-							AckWaitList[i].callback(AckWaitList[i].thingName, AckWaitList[i].action, status,
-													shadowRxBuf, AckWaitList[i].pCallbackContext);
-						}
-						unsubscribeFromAcceptedAndRejected(i);
-						AckWaitList[i].isFree = true;
-						return;
-					}
-				}
-			}
+	if(extractClientTokenFromTokens(shadowRxBuf, pJsonHandler, tokenCount, temporaryClientToken)) {
+		dispatchAckStatus(topicName, temporaryClientToken, shadowRxBuf);
+	}
+}
+
+/* An ack larger than the RX buffer is streamed, keeping only its top level client token and version */
+static void AckStatusChunkCallback(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
+								   IoT_Publish_Message_Params *params, size_t payloadOffset, size_t payloadTotalLen,
+								   void *pData) {
+	IOT_UNUSED(pClient);
+	IOT_UNUSED(pData);
+
+	if(0 == payloadOffset) {
+		// the topic is only valid during each chunk, it's kept (as a string) to dispatch the ack once complete
+		if(topicNameLen >= MAX_SHADOW_TOPIC_LENGTH_BYTES) {
+			topicNameLen = MAX_SHADOW_TOPIC_LENGTH_BYTES - 1;
+		}
+		memcpy(streamedAckTopic, topicName, topicNameLen);
+		streamedAckTopic[topicNameLen] = '\0';
+		isStreamedAckClientTokenFound = false;
+		isStreamedAckVersionFound = false;
+		aws_iot_json_stream_init(&shadowRxStream, shadowRxBuf, SHADOW_MAX_SIZE_OF_RX_BUFFER,
+								 AckStatusStreamValueCallback, NULL);
+	}
+
+	aws_iot_json_stream_feed(&shadowRxStream, (const char *) params->payload, params->payloadLen);
+	if(payloadOffset + params->payloadLen < payloadTotalLen) {
+		return;
+	}
+
+	if(!aws_iot_json_stream_is_complete(&shadowRxStream)) {
+		IOT_WARN("Received JSON is not valid");
+		return;
+	}
+
+	if(isStreamedAckVersionFound && isAckForMyThingName(streamedAckTopic)) {
+		if(streamedAckVersionNumber > shadowJsonVersionNum) {
+			shadowJsonVersionNum = streamedAckVersionNumber;
+		}
+	}
+
+	if(isStreamedAckClientTokenFound) {
+		dispatchAckStatus(streamedAckTopic, streamedAckClientToken, "");
+	}
+}
+
+static void AckStatusStreamValueCallback(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength,
+										 bool isString, bool isTruncated, void *pContext) {
+	const char *pKey;
+	jsonStruct_t versionStruct;
+
+	IOT_UNUSED(pContext);
+
+	pKey = aws_iot_json_stream_get_key(pStream, 1);
+	if(1 != pStream->depth || NULL == pKey || isTruncated) {
+		return;
+	}
+
+	if(isString && !isStreamedAckClientTokenFound && 0 == strcmp(pKey, SHADOW_CLIENT_TOKEN_STRING)) {
+		if(valueLength < MAX_SIZE_CLIENT_TOKEN_CLIENT_SEQUENCE) {
+			memcpy(streamedAckClientToken, pValue, valueLength + 1);
+			isStreamedAckClientTokenFound = true;
 		}
+	} else if(!isString && !isStreamedAckVersionFound && 0 == strcmp(pKey, SHADOW_VERSION_STRING)) {
+		versionStruct.pKey = SHADOW_VERSION_STRING;
+		versionStruct.pData = &streamedAckVersionNumber;
+		versionStruct.type = SHADOW_JSON_UINT32;
+		versionStruct.cb = NULL;
+		isStreamedAckVersionFound = (SUCCESS == updateValueOfStreamedJsonKey(pValue, valueLength, false,
+																			 &versionStruct));
+	}
+}
+
+/* Hand an ack to the callback of the action waiting on its client token. The document is empty for an ack that was
+ * streamed (larger than the RX buffer), as only its client token and version were kept. */
+static void dispatchAckStatus(const char *pTopicName, const char *pClientToken, const char *pReceivedJsonDocument) {
+	uint16_t i;
+	Shadow_Ack_Status_t status;
+
+	if(!findIndexOfAckWaitList(pClientToken, &i)) {
+		return;
+	}
+
+	if(strstr(pTopicName, "accepted") != NULL) {
+		status = SHADOW_ACK_ACCEPTED;
+	} else if(strstr(pTopicName, "rejected") != NULL) {
+		status = SHADOW_ACK_REJECTED;
+	} else {
+		return;
+	}
+
+	if(AckWaitList[i].callback != NULL) {
+		AckWaitList[i].callback(AckWaitList[i].thingName, AckWaitList[i].action, status, pReceivedJsonDocument,
+								AckWaitList[i].pCallbackContext);
+	}
+	// freed first, an ack read while the unsubscribe waits for its reply mustn't find it
+	freeAckWaitListEntry(i);
+	unsubscribeFromAcceptedAndRejected(i);
+}
+
+/* Slot of the ack list a client token hashes to, its sequence number for the tokens the SDK fills in (so the acks in
+ * flight, having consecutive sequence numbers, each get their own slot) */
+static uint16_t homeIndexOfClientToken(const char *pClientToken) {
+	const char *pSequence;
+	const char *pChar;
+	uint32_t sequence = 0;
+	uint32_t hash = 5381;
+
+	pSequence = strrchr(pClientToken, '-');
+	if(NULL != pSequence && '\0' != pSequence[1]) {
+		for(pChar = pSequence + 1; *pChar >= '0' && *pChar <= '9'; pChar++) {
+			sequence = (sequence * 10) + (uint32_t) (*pChar - '0');
+		}
+		if('\0' == *pChar) {
+			return (uint16_t) (sequence % MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME);
+		}
+	}
+
+	// a token that doesn't end with a sequence number (one put in the document by the application) is hashed
+	for(pChar = pClientToken; '\0' != *pChar; pChar++) {
+		hash = (hash * 33) + (uint8_t) *pChar;
+	}
+
+	return (uint16_t) (hash % MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME);
+}
+
+static bool findIndexOfAckWaitList(const char *pClientToken, uint16_t *pIndex) {
+	uint16_t i;
+	uint16_t distance;
+
+	i = homeIndexOfClientToken(pClientToken);
+	for(distance = 0; distance <= ackMaxProbeDistance; distance++) {
+		if(!AckWaitList[i].isFree && strcmp(AckWaitList[i].clientTokenID, pClientToken) == 0) {
+			*pIndex = i;
+			return true;
+		}
+		i = (uint16_t) ((i + 1) % MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME);
+	}
+
+	return false;
+}
+
+/* Milliseconds since ackTimerWheelClockBaseTick, restarting the clock first if it's about to run out */
+static uint32_t getAckTimerWheelElapsedMs(void) {
+	uint32_t elapsedMs = (uint32_t) (ACK_TIMER_WHEEL_CLOCK_SPAN_MS - left_ms(&ackTimerWheelClock));
+
+	if(elapsedMs > ACK_TIMER_WHEEL_CLOCK_SPAN_MS / 2) {
+		ackTimerWheelClockBaseTick += elapsedMs / ACK_TIMER_WHEEL_TICK_MS;
+		elapsedMs %= ACK_TIMER_WHEEL_TICK_MS;
+		countdown_ms(&ackTimerWheelClock, (uint32_t) (ACK_TIMER_WHEEL_CLOCK_SPAN_MS - elapsedMs));
+	}
+
+	return elapsedMs;
+}
+
+/* The ack times out at the first tick at least timeout_seconds from now, so a timeout is never early, and late by less
+ * than a tick plus however late the yield that notices it is. It's never due at a tick whose slot has been looked at
+ * already, as it would then wait a whole turn. */
+static void addToAckTimerWheel(uint16_t index, uint32_t timeout_seconds) {
+	uint32_t elapsedMs = getAckTimerWheelElapsedMs();
+	uint32_t dueTick = ackTimerWheelClockBaseTick + elapsedMs / ACK_TIMER_WHEEL_TICK_MS +
+					   (uint32_t) ((uint64_t) timeout_seconds * 1000 / ACK_TIMER_WHEEL_TICK_MS) +
+					   ((0 != elapsedMs % ACK_TIMER_WHEEL_TICK_MS) ? 1 : 0);
+	uint16_t slot;
+
+	if(dueTick <= ackTimerWheelTick) {
+		dueTick = ackTimerWheelTick + 1;
+	}
+	slot = (uint16_t) (dueTick % ACK_TIMER_WHEEL_SLOTS);
+
+	AckWaitList[index].wheelDueTick = dueTick;
+	AckWaitList[index].wheelSlot = slot;
+	AckWaitList[index].wheelPrev = NO_ACK_RECORD;
+	AckWaitList[index].wheelNext = ackTimerWheel[slot];
+	if(NO_ACK_RECORD != ackTimerWheel[slot]) {
+		AckWaitList[ackTimerWheel[slot]].wheelPrev = index;
+	}
+	ackTimerWheel[slot] = index;
+}
+
+static void removeFromAckTimerWheel(uint16_t index) {
+	if(NO_ACK_RECORD != AckWaitList[index].wheelPrev) {
+		AckWaitList[AckWaitList[index].wheelPrev].wheelNext = AckWaitList[index].wheelNext;
+	} else {
+		ackTimerWheel[AckWaitList[index].wheelSlot] = AckWaitList[index].wheelNext;
+	}
+	if(NO_ACK_RECORD != AckWaitList[index].wheelNext) {
+		AckWaitList[AckWaitList[index].wheelNext].wheelPrev = AckWaitList[index].wheelPrev;
+	}
+}
+
+static void freeAckWaitListEntry(uint16_t index) {
+	removeFromAckTimerWheel(index);
+	AckWaitList[index].isFree = true;
+	ackInFlightCount--;
+	if(0 == ackInFlightCount) {
+		ackMaxProbeDistance = 0;
 	}
 }
 
@@ -247,7 +578,7 @@ static int16_t findIndexOfSubscriptionList(const char *pTopic) {
 	return -1;
 }
 
-static void unsubscribeFromAcceptedAndRejected(uint8_t index) {
+static void unsubscribeFromAcceptedAndRejected(uint16_t index) {
 
 	char TemporaryTopicNameAccepted[MAX_SHADOW_TOPIC_LENGTH_BYTES];
 	char TemporaryTopicNameRejected[MAX_SHADOW_TOPIC_LENGTH_BYTES];
@@ -288,10 +619,19 @@ static void unsubscribeFromAcceptedAndRejected(uint8_t index) {
 }
 
 void initializeRecords(AWS_IoT_Client *pClient) {
-	uint8_t i;
+	uint16_t i;
 	for(i = 0; i < MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME; i++) {
 		AckWaitList[i].isFree = true;
 	}
+	for(i = 0; i < ACK_TIMER_WHEEL_SLOTS; i++) {
+		ackTimerWheel[i] = NO_ACK_RECORD;
+	}
+	init_timer(&ackTimerWheelClock);
+	countdown_ms(&ackTimerWheelClock, (uint32_t) ACK_TIMER_WHEEL_CLOCK_SPAN_MS);
+	ackTimerWheelClockBaseTick = 0;
+	ackTimerWheelTick = 0;
+	ackMaxProbeDistance = 0;
+	ackInFlightCount = 0;
 	for(i = 0; i < MAX_TOPICS_AT_ANY_GIVEN_TIME; i++) {
 		SubscriptionList[i].isFree = true;
 		SubscriptionList[i].count = 0;
@@ -345,6 +685,9 @@ IoT_Error_t subscribeToShadowActionAcks(const char *pThingName, ShadowActions_t
 										 (uint16_t) strlen(SubscriptionList[indexAcceptedSubList].Topic), QOS0,
 										 AckStatusCallback, NULL);
 		if(ret_val == SUCCESS) {
+			aws_iot_mqtt_set_chunk_handler(pMqttClient, SubscriptionList[indexAcceptedSubList].Topic,
+										   (uint16_t) strlen(SubscriptionList[indexAcceptedSubList].Topic),
+										   AckStatusChunkCallback);
 			SubscriptionList[indexAcceptedSubList].count = 1;
 			SubscriptionList[indexAcceptedSubList].isSticky = isSticky;
 			topicNameFromThingAndAction(SubscriptionList[indexRejectedSubList].Topic, pThingName, action,
@@ -353,6 +696,9 @@ IoT_Error_t subscribeToShadowActionAcks(const char *pThingName, ShadowActions_t
 											 (uint16_t) strlen(SubscriptionList[indexRejectedSubList].Topic), QOS0,
 											 AckStatusCallback, NULL);
 			if(ret_val == SUCCESS) {
+				aws_iot_mqtt_set_chunk_handler(pMqttClient, SubscriptionList[indexRejectedSubList].Topic,
+											   (uint16_t) strlen(SubscriptionList[indexRejectedSubList].Topic),
+											   AckStatusChunkCallback);
 				SubscriptionList[indexRejectedSubList].count = 1;
 				SubscriptionList[indexRejectedSubList].isSticky = isSticky;
 				clearBothEntriesFromList = false;
@@ -418,50 +764,86 @@ IoT_Error_t publishToShadowAction(const char *pThingName, ShadowActions_t action
 	return ret_val;
 }
 
-bool getNextFreeIndexOfAckWaitList(uint8_t *pIndex) {
-	uint8_t i;
-	bool rc = false;
+bool getNextFreeIndexOfAckWaitList(const char *pClientToken, uint16_t *pIndex) {
+	uint16_t i;
+	uint16_t distance;
 
-	if(NULL == pIndex) {
+	if(NULL == pClientToken || NULL == pIndex) {
 		return false;
 	}
 
-	for(i = 0; i < MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME; i++) {
+	i = homeIndexOfClientToken(pClientToken);
+	for(distance = 0; distance < MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME; distance++) {
 		if(AckWaitList[i].isFree) {
 			*pIndex = i;
-			rc = true;
-			break;
+			return true;
 		}
+		i = (uint16_t) ((i + 1) % MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME);
 	}
 
-	return rc;
+	return false;
 }
 
-void addToAckWaitList(uint8_t indexAckWaitList, const char *pThingName, ShadowActions_t action,
+void addToAckWaitList(uint16_t indexAckWaitList, const char *pThingName, ShadowActions_t action,
 					  const char *pExtractedClientToken, fpActionCallback_t callback, void *pCallbackContext,
 					  uint32_t timeout_seconds) {
+	uint16_t distance;
+
 	AckWaitList[indexAckWaitList].callback = callback;
 	strncpy(AckWaitList[indexAckWaitList].clientTokenID, pExtractedClientToken, MAX_SIZE_CLIENT_ID_WITH_SEQUENCE);
 	strncpy(AckWaitList[indexAckWaitList].thingName, pThingName, MAX_SIZE_OF_THING_NAME);
 	AckWaitList[indexAckWaitList].pCallbackContext = pCallbackContext;
 	AckWaitList[indexAckWaitList].action = action;
-	init_timer(&(AckWaitList[indexAckWaitList].timer));
-	countdown_sec(&(AckWaitList[indexAckWaitList].timer), timeout_seconds);
+	addToAckTimerWheel(indexAckWaitList, timeout_seconds);
 	AckWaitList[indexAckWaitList].isFree = false;
+	ackInFlightCount++;
+
+	distance = (uint16_t) ((indexAckWaitList + MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME -
+							homeIndexOfClientToken(pExtractedClientToken)) % MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME);
+	if(distance > ackMaxProbeDistance) {
+		ackMaxProbeDistance = distance;
+	}
 }
 
+/* Turn the timing wheel through the slot of every tick that has passed since the last yield (each slot once at most,
+ * however late the yield is), timing out the acks in them that are due by now. The wheel is at the new tick before the
+ * timeout callbacks run, so an ack they wait for is due at a later one. A timeout callback, and the unsubscribe after
+ * it (which reads acks while waiting for its reply), may take or free other acks, so a slot is looked at afresh after
+ * each timeout, the acks left in it that are due being fewer each time. */
 void HandleExpiredResponseCallbacks(void) {
-	uint8_t i;
-	for(i = 0; i < MAX_ACKS_TO_COMEIN_AT_ANY_GIVEN_TIME; i++) {
-		if(!AckWaitList[i].isFree) {
-			if(has_timer_expired(&(AckWaitList[i].timer))) {
-				if(AckWaitList[i].callback != NULL) {
-					AckWaitList[i].callback(AckWaitList[i].thingName, AckWaitList[i].action, SHADOW_ACK_TIMEOUT,
-											shadowRxBuf, AckWaitList[i].pCallbackContext);
-				}
-				AckWaitList[i].isFree = true;
-				unsubscribeFromAcceptedAndRejected(i);
+	uint32_t nowTick;
+	uint32_t lastTick;
+	uint32_t turns;
+	uint32_t turn;
+	uint16_t slot;
+	uint16_t i;
+
+	nowTick = getAckTimerWheelElapsedMs() / ACK_TIMER_WHEEL_TICK_MS + ackTimerWheelClockBaseTick;
+	if(nowTick <= ackTimerWheelTick) {
+		return;
+	}
+	lastTick = ackTimerWheelTick;
+	ackTimerWheelTick = nowTick;
+	turns = nowTick - lastTick;
+	if(turns > ACK_TIMER_WHEEL_SLOTS) {
+		turns = ACK_TIMER_WHEEL_SLOTS;
+	}
+
+	for(turn = 1; turn <= turns; turn++) {
+		slot = (uint16_t) ((lastTick + turn) % ACK_TIMER_WHEEL_SLOTS);
+		i = ackTimerWheel[slot];
+		while(NO_ACK_RECORD != i) {
+			if(AckWaitList[i].wheelDueTick > nowTick) {
+				i = AckWaitList[i].wheelNext;
+				continue;
 			}
+			if(AckWaitList[i].callback != NULL) {
+				AckWaitList[i].callback(AckWaitList[i].thingName, AckWaitList[i].action, SHADOW_ACK_TIMEOUT,
+										shadowRxBuf, AckWaitList[i].pCallbackContext);
+			}
+			freeAckWaitListEntry(i);
+			unsubscribeFromAcceptedAndRejected(i);
+			i = ackTimerWheel[slot];
 		}
 	}
 }
@@ -469,11 +851,15 @@ void HandleExpiredResponseCallbacks(void) {
 static void shadow_delta_callback(AWS_IoT_Client *pClient, char *topicName,
 								  uint16_t topicNameLen, IoT_Publish_Message_Params *params, void *pData) {
 	int32_t tokenCount;
+	int32_t tokenIndex;
 	uint32_t i = 0;
 	void *pJsonHandler = NULL;
 	int32_t DataPosition;
 	uint32_t dataLength;
 	uint32_t tempVersionNumber = 0;
+	const char *pJsonKey;
+	uint32_t jsonKeyLength;
+	JsonTokenTable_t *pEntry;
 
 	FUNC_ENTRY;
 
@@ -507,16 +893,105 @@ static void shadow_delta_callback(AWS_IoT_Client *pClient, char *topicName,
 		}
 	}
 
-	for(i = 0; i < tokenTableIndex; i++) {
-		if(!tokenTable[i].isFree) {
-			if(isJsonKeyMatchingAndUpdateValue(shadowRxBuf, pJsonHandler, tokenCount,
-											   (jsonStruct_t *) tokenTable[i].pStruct, &dataLength, &DataPosition)) {
-				if(tokenTable[i].callback != NULL) {
-					tokenTable[i].callback(shadowRxBuf + DataPosition, dataLength,
-										   (jsonStruct_t *) tokenTable[i].pStruct);
+	beginDeltaDispatch();
+
+	// a single pass over the parsed tokens, looking each key up in the sorted index
+	for(tokenIndex = 1; tokenIndex < tokenCount; tokenIndex++) {
+		if(!getJsonKeyOfToken(shadowRxBuf, pJsonHandler, tokenCount, tokenIndex, &pJsonKey, &jsonKeyLength)) {
+			continue;
+		}
+		i = findFirstSortedTokenNotBelow(pJsonKey, jsonKeyLength);
+		while(NULL != (pEntry = takeNextEntryOfDeltaKey(pJsonKey, jsonKeyLength, &i))) {
+			updateValueOfJsonKeyToken(shadowRxBuf, pJsonHandler, tokenIndex, (jsonStruct_t *) pEntry->pStruct,
+									  &dataLength, &DataPosition);
+			if(pEntry->callback != NULL) {
+				pEntry->callback(shadowRxBuf + DataPosition, dataLength, (jsonStruct_t *) pEntry->pStruct);
+			}
+		}
+	}
+}
+
+/* A delta larger than the RX buffer is streamed, each value under the state being dispatched as soon as it is parsed
+ * (so the version has to come before the state, as the service sends it, for an old delta to be discarded). Only
+ * values that fit the RX buffer are dispatched. */
+static void shadow_delta_chunk_callback(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
+										IoT_Publish_Message_Params *params, size_t payloadOffset,
+										size_t payloadTotalLen, void *pData) {
+	FUNC_ENTRY;
+
+	IOT_UNUSED(pClient);
+	IOT_UNUSED(topicName);
+	IOT_UNUSED(topicNameLen);
+	IOT_UNUSED(pData);
+
+	if(0 == payloadOffset) {
+		isStreamedDeltaDiscarded = false;
+		beginDeltaDispatch();
+		aws_iot_json_stream_init(&shadowRxStream, shadowRxBuf, SHADOW_MAX_SIZE_OF_RX_BUFFER,
+								 shadow_delta_stream_value_callback, NULL);
+	}
+
+	aws_iot_json_stream_feed(&shadowRxStream, (const char *) params->payload, params->payloadLen);
+	if(payloadOffset + params->payloadLen == payloadTotalLen && !aws_iot_json_stream_is_complete(&shadowRxStream)) {
+		IOT_WARN("Received JSON is not valid");
+	}
+}
+
+static void shadow_delta_stream_value_callback(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength,
+											   bool isString, bool isTruncated, void *pContext) {
+	const char *pTopKey;
+	const char *pJsonKey;
+	uint32_t i;
+	uint32_t tempVersionNumber = 0;
+	jsonStruct_t versionStruct;
+	JsonTokenTable_t *pEntry;
+
+	IOT_UNUSED(pContext);
+
+	if(isStreamedDeltaDiscarded) {
+		return;
+	}
+
+	pTopKey = aws_iot_json_stream_get_key(pStream, 1);
+	if(NULL == pTopKey) {
+		return;
+	}
+
+	if(1 == pStream->depth) {
+		if(shadowDiscardOldDeltaFlag && !isString && !isTruncated && 0 == strcmp(pTopKey, SHADOW_VERSION_STRING)) {
+			versionStruct.pKey = SHADOW_VERSION_STRING;
+			versionStruct.pData = &tempVersionNumber;
+			versionStruct.type = SHADOW_JSON_UINT32;
+			versionStruct.cb = NULL;
+			if(SUCCESS == updateValueOfStreamedJsonKey(pValue, valueLength, false, &versionStruct)) {
+				if(tempVersionNumber > shadowJsonVersionNum) {
+					shadowJsonVersionNum = tempVersionNumber;
+				} else {
+					IOT_WARN("Old Delta Message received - Ignoring rx: %d local: %d", tempVersionNumber,
+							 shadowJsonVersionNum);
+					isStreamedDeltaDiscarded = true;
 				}
 			}
 		}
+		return;
+	}
+
+	pJsonKey = aws_iot_json_stream_get_key(pStream, 2);
+	if(2 != pStream->depth || NULL == pJsonKey || 0 != strcmp(pTopKey, SHADOW_STATE_STRING)) {
+		return;
+	}
+
+	if(isTruncated) {
+		IOT_WARN("Delta value of %s larger than RX Buffer", pJsonKey);
+		return;
+	}
+
+	i = findFirstSortedTokenNotBelow(pJsonKey, (uint32_t) strlen(pJsonKey));
+	while(NULL != (pEntry = takeNextEntryOfDeltaKey(pJsonKey, (uint32_t) strlen(pJsonKey), &i))) {
+		updateValueOfStreamedJsonKey(pValue, valueLength, isString, (jsonStruct_t *) pEntry->pStruct);
+		if(pEntry->callback != NULL) {
+			pEntry->callback(pValue, valueLength, (jsonStruct_t *) pEntry->pStruct);
+		}
 	}
 }
 
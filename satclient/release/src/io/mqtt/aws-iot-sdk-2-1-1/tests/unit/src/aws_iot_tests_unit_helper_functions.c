@@ -271,7 +271,7 @@ void setTLSRxBufferDelay(int seconds, int microseconds) {
 
 void setTLSRxBufferWithMsgOnSubscribedTopic(char *topicName, size_t topicNameLen, QoS qos,
 											IoT_Publish_Message_Params params, char *pMsg) {
-	size_t VariableLen = topicNameLen + 2 + 2;
+	size_t VariableLen = topicNameLen + 2 + ((QOS0 != qos) ? 2 : 0); // packet id only for QoS 1 or 2
 	size_t i = 0, cursor = 0, packetIdStartLoc = 0, payloadStartLoc = 0, VarHeaderStartLoc = 0;
 	size_t PayloadLen = strlen(pMsg) + 1;
 
@@ -306,7 +306,7 @@ void setTLSRxBufferWithMsgOnSubscribedTopic(char *topicName, size_t topicNameLen
 		RxBuffer.pBuffer[payloadStartLoc + i] = (unsigned char) pMsg[i];
 	}
 
-	RxBuffer.len = VariableLen + PayloadLen + 2; // 2 for fixed header
+	RxBuffer.len = cursor + VariableLen + PayloadLen; // fixed header, the remaining length can take more than a byte
 	RxIndex = 0;
 	//printBuffer(RxBuffer.pBuffer, RxBuffer.len);
 }
@@ -0,0 +1,47 @@
+/*
+* Copyright 2015-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+* http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+/**
+ * @file aws_iot_tests_unit_json_stream.cpp
+ * @brief IoT Client Unit Testing - JSON Stream Parser Tests
+ */
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness_c.h>
+
+TEST_GROUP_C(JsonStream) {
+	TEST_GROUP_C_SETUP_WRAPPER(JsonStream)
+	TEST_GROUP_C_TEARDOWN_WRAPPER(JsonStream)
+};
+
+TEST_GROUP_C_WRAPPER(JsonStream, SingleChunk)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitInsideKey)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitInsideString)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitInsideNumber)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitInsideLiteral)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitAfterEscape)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitInsideUnicodeEscape)
+TEST_GROUP_C_WRAPPER(JsonStream, ChunkSplitAtEveryByte)
+
+TEST_GROUP_C_WRAPPER(JsonStream, NestingAtDepthLimit)
+TEST_GROUP_C_WRAPPER(JsonStream, NestingDeeperThanDepthLimit)
+TEST_GROUP_C_WRAPPER(JsonStream, TruncatedDocumentIsIncomplete)
+TEST_GROUP_C_WRAPPER(JsonStream, MalformedDocumentIsError)
+TEST_GROUP_C_WRAPPER(JsonStream, ErrorIsKeptForLaterChunks)
+TEST_GROUP_C_WRAPPER(JsonStream, NullTerminatedDocument)
+
+TEST_GROUP_C_WRAPPER(JsonStream, ValueFillingValueBuffer)
+TEST_GROUP_C_WRAPPER(JsonStream, ValueOneByteLargerThanValueBuffer)
+TEST_GROUP_C_WRAPPER(JsonStream, KeyLongerThanKeySize)
@@ -0,0 +1,389 @@
+/*
+* Copyright 2015-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+* http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+/**
+ * @file aws_iot_tests_unit_json_stream_helper.c
+ * @brief IoT Client Unit Testing - JSON Stream Parser Tests helper
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <CppUTest/TestHarness_c.h>
+
+#include "aws_iot_json_stream.h"
+#include "aws_iot_log.h"
+
+#define TEST_VALUE_BUFFER_SIZE 16
+
+#define TEST_JSON_DOCUMENT "{\"state\":{\"desired\":{\"temperature\":-21.5e1,\"name\":\"sat\\\"ellite\",\"unit\":\"\\u00b0C\"," \
+							"\"on\":true,\"limits\":[1,null,{\"max\":false}]}},\"version\":12345}"
+#define TEST_JSON_DOCUMENT_VALUES "state.desired.temperature=-21.5e1;state.desired.name=\"sat\\\"ellite\";" \
+								  "state.desired.unit=\"\\u00b0C\";state.desired.on=true;state.desired.limits=1;" \
+								  "state.desired.limits=null;state.desired.limits.max=false;version=12345;"
+
+static JsonStream_t stream;
+static char valueBuffer[TEST_VALUE_BUFFER_SIZE];
+static char streamedValues[512];
+
+/* Record each value as its keys joined with '.', then '=' and the value (quoted if it's a string, '~' after it if it
+ * was truncated) */
+static void recordStreamedValue(const JsonStream_t *pStream, const char *pValue, uint32_t valueLength, bool isString,
+								bool isTruncated, void *pContext) {
+	uint8_t depth;
+	const char *pKey;
+	size_t length = strlen(streamedValues);
+
+	IOT_UNUSED(pContext);
+
+	for(depth = 1; depth <= pStream->depth; depth++) {
+		pKey = aws_iot_json_stream_get_key(pStream, depth);
+		if(NULL == pKey) {
+			pKey = "?";
+		}
+		if('\0' == pKey[0]) {
+			continue;
+		}
+		length += (size_t) snprintf(streamedValues + length, sizeof(streamedValues) - length, "%s%s",
+									(1 == depth) ? "" : ".", pKey);
+	}
+	CHECK_EQUAL_C_INT(valueLength, strlen(pValue));
+	snprintf(streamedValues + length, sizeof(streamedValues) - length, isString ? "=\"%s\"%s;" : "=%s%s;", pValue,
+			 isTruncated ? "~" : "");
+}
+
+/* Feed a document in two chunks, split before the first occurrence of pSplitBefore plus splitOffset */
+static IoT_Error_t feedInTwoChunks(const char *pDocument, const char *pSplitBefore, size_t splitOffset) {
+	size_t splitAt;
+	IoT_Error_t rc;
+
+	CHECK_C(NULL != strstr(pDocument, pSplitBefore));
+	splitAt = (size_t) (strstr(pDocument, pSplitBefore) - pDocument) + splitOffset;
+
+	rc = aws_iot_json_stream_feed(&stream, pDocument, splitAt);
+	if(SUCCESS == rc) {
+		rc = aws_iot_json_stream_feed(&stream, pDocument + splitAt, strlen(pDocument) - splitAt);
+	}
+
+	return rc;
+}
+
+TEST_GROUP_C_SETUP(JsonStream) {
+	streamedValues[0] = '\0';
+	aws_iot_json_stream_init(&stream, valueBuffer, sizeof(valueBuffer), recordStreamedValue, NULL);
+}
+
+TEST_GROUP_C_TEARDOWN(JsonStream) {
+
+}
+
+TEST_C(JsonStream, SingleChunk) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Document in a single chunk \n");
+
+	rc = aws_iot_json_stream_feed(&stream, TEST_JSON_DOCUMENT, strlen(TEST_JSON_DOCUMENT));
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitInsideKey) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split inside a key \n");
+
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "temperature", 4);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitInsideString) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split inside a string \n");
+
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "sat", 2);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitInsideNumber) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split inside a number \n");
+
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "21.5e1", 3);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+
+	// a number only ends with what follows it, so one at the end of a chunk isn't handed over until the next
+	streamedValues[0] = '\0';
+	aws_iot_json_stream_init(&stream, valueBuffer, sizeof(valueBuffer), recordStreamedValue, NULL);
+	rc = aws_iot_json_stream_feed(&stream, "{\"version\":123", strlen("{\"version\":123"));
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_STRING("", streamedValues);
+	rc = aws_iot_json_stream_feed(&stream, "45}", strlen("45}"));
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("version=12345;", streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitInsideLiteral) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split inside a literal \n");
+
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "true", 2);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+
+	streamedValues[0] = '\0';
+	aws_iot_json_stream_init(&stream, valueBuffer, sizeof(valueBuffer), recordStreamedValue, NULL);
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "null", 3);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitAfterEscape) {
+	IoT_Error_t rc;
+	const char *pDocument = "{\"path\":\"a\\\\\",\"quote\":\"b\\\"c\"}";
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split after a backslash \n");
+
+	// the escaped quote must not end the string even though its backslash was in the previous chunk
+	rc = feedInTwoChunks(pDocument, "\\\"c", 1);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("path=\"a\\\\\";quote=\"b\\\"c\";", streamedValues);
+
+	// and an escaped backslash must not escape the quote after it
+	streamedValues[0] = '\0';
+	aws_iot_json_stream_init(&stream, valueBuffer, sizeof(valueBuffer), recordStreamedValue, NULL);
+	rc = feedInTwoChunks(pDocument, "\\\\\"", 2);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("path=\"a\\\\\";quote=\"b\\\"c\";", streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitInsideUnicodeEscape) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Chunk split inside a unicode escape \n");
+
+	rc = feedInTwoChunks(TEST_JSON_DOCUMENT, "\\u00b0", 4);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, ChunkSplitAtEveryByte) {
+	IoT_Error_t rc = SUCCESS;
+	size_t i;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Document a byte at a time \n");
+
+	for(i = 0; i < strlen(TEST_JSON_DOCUMENT) && SUCCESS == rc; i++) {
+		CHECK_C(!aws_iot_json_stream_is_complete(&stream));
+		rc = aws_iot_json_stream_feed(&stream, TEST_JSON_DOCUMENT + i, 1);
+	}
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(TEST_JSON_DOCUMENT_VALUES, streamedValues);
+}
+
+TEST_C(JsonStream, NestingAtDepthLimit) {
+	IoT_Error_t rc;
+	char document[100] = "";
+	uint8_t depth;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Nesting at the depth limit \n");
+
+	// the top level object, nested objects and then an array at JSON_STREAM_MAX_DEPTH
+	strcat(document, "{");
+	for(depth = 2; depth < JSON_STREAM_MAX_DEPTH; depth++) {
+		strcat(document, "\"k\":{");
+	}
+	strcat(document, "\"k\":[1]");
+	for(depth = 1; depth < JSON_STREAM_MAX_DEPTH; depth++) {
+		strcat(document, "}");
+	}
+
+	rc = aws_iot_json_stream_feed(&stream, document, strlen(document));
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("k.k.k.k.k.k.k=1;", streamedValues);
+}
+
+TEST_C(JsonStream, NestingDeeperThanDepthLimit) {
+	IoT_Error_t rc;
+	char document[100] = "";
+	uint8_t depth;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Nesting deeper than the depth limit \n");
+
+	strcat(document, "{");
+	for(depth = 2; depth <= JSON_STREAM_MAX_DEPTH + 1; depth++) {
+		strcat(document, "\"k\":{");
+	}
+	strcat(document, "\"v\":1");
+	for(depth = 1; depth <= JSON_STREAM_MAX_DEPTH + 1; depth++) {
+		strcat(document, "}");
+	}
+
+	rc = aws_iot_json_stream_feed(&stream, document, strlen(document));
+
+	CHECK_EQUAL_C_INT(JSON_PARSE_ERROR, rc);
+	CHECK_C(!aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("", streamedValues);
+}
+
+TEST_C(JsonStream, TruncatedDocumentIsIncomplete) {
+	IoT_Error_t rc;
+	size_t length = strlen(TEST_JSON_DOCUMENT) - 1;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Truncated document \n");
+
+	// valid so far, every value but the last one (which isn't known to have ended) is handed over
+	rc = aws_iot_json_stream_feed(&stream, TEST_JSON_DOCUMENT, length);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(!aws_iot_json_stream_is_complete(&stream));
+	CHECK_C(NULL == strstr(streamedValues, "version"));
+	CHECK_C(NULL != strstr(streamedValues, "state.desired.limits.max=false;"));
+}
+
+TEST_C(JsonStream, MalformedDocumentIsError) {
+	const char *malformedDocuments[] = {
+			"[1,2]",               // not an object
+			"{\"a\" 1}",           // no colon
+			"{\"a\":1 \"b\":2}",   // no comma
+			"{\"a\":[1}",          // mismatched close
+			"{\"a\":1}}",          // closed twice
+			"{\"a\":1}x",          // anything after the document
+			"{\"a\":@}"            // not a value
+	};
+	size_t i;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Malformed documents \n");
+
+	for(i = 0; i < sizeof(malformedDocuments) / sizeof(malformedDocuments[0]); i++) {
+		aws_iot_json_stream_init(&stream, valueBuffer, sizeof(valueBuffer), recordStreamedValue, NULL);
+		CHECK_EQUAL_C_INT(JSON_PARSE_ERROR,
+						  aws_iot_json_stream_feed(&stream, malformedDocuments[i], strlen(malformedDocuments[i])));
+		CHECK_C(!aws_iot_json_stream_is_complete(&stream));
+	}
+}
+
+TEST_C(JsonStream, ErrorIsKeptForLaterChunks) {
+	IoT_Error_t rc;
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Error kept for later chunks \n");
+
+	rc = aws_iot_json_stream_feed(&stream, "{\"a\"", strlen("{\"a\""));
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	rc = aws_iot_json_stream_feed(&stream, "}", 1);
+	CHECK_EQUAL_C_INT(JSON_PARSE_ERROR, rc);
+
+	// the rest of a valid document doesn't bring it back
+	rc = aws_iot_json_stream_feed(&stream, ":1,\"b\":2}", strlen(":1,\"b\":2}"));
+	CHECK_EQUAL_C_INT(JSON_PARSE_ERROR, rc);
+	CHECK_C(!aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("", streamedValues);
+}
+
+TEST_C(JsonStream, NullTerminatedDocument) {
+	IoT_Error_t rc;
+	const char *pDocument = "{\"a\":1} \n";
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Document followed by whitespace and its terminator \n");
+
+	rc = aws_iot_json_stream_feed(&stream, pDocument, strlen(pDocument) + 1);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("a=1;", streamedValues);
+}
+
+TEST_C(JsonStream, ValueFillingValueBuffer) {
+	IoT_Error_t rc;
+	char document[50];
+	char expectedValues[50];
+	char value[TEST_VALUE_BUFFER_SIZE];
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Value filling the value buffer \n");
+
+	// the value buffer holds a value one less than its size (and the terminator)
+	memset(value, 'v', sizeof(value) - 1);
+	value[sizeof(value) - 1] = '\0';
+	snprintf(document, sizeof(document), "{\"s\":\"%s\",\"n\":%s}", value, "123456789012345");
+	snprintf(expectedValues, sizeof(expectedValues), "s=\"%s\";n=%s;", value, "123456789012345");
+
+	rc = aws_iot_json_stream_feed(&stream, document, strlen(document));
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(expectedValues, streamedValues);
+}
+
+TEST_C(JsonStream, ValueOneByteLargerThanValueBuffer) {
+	IoT_Error_t rc;
+	char document[80];
+	char expectedValues[80];
+	char value[TEST_VALUE_BUFFER_SIZE + 1];
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Value one byte larger than the value buffer \n");
+
+	// handed over truncated to the buffer, and the document is still parsed past it
+	memset(value, 'v', sizeof(value) - 1);
+	value[sizeof(value) - 1] = '\0';
+	snprintf(document, sizeof(document), "{\"s\":\"%s\",\"n\":%s,\"a\":1}", value, "1234567890123456");
+	value[sizeof(value) - 2] = '\0';
+	snprintf(expectedValues, sizeof(expectedValues), "s=\"%s\"~;n=%s~;a=1;", value, "123456789012345");
+
+	rc = aws_iot_json_stream_feed(&stream, document, strlen(document));
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING(expectedValues, streamedValues);
+}
+
+TEST_C(JsonStream, KeyLongerThanKeySize) {
+	IoT_Error_t rc;
+	char document[JSON_STREAM_MAX_KEY_SIZE + 20];
+	char key[JSON_STREAM_MAX_KEY_SIZE + 1];
+
+	IOT_DEBUG("\n-->Running Json Stream Tests - Key longer than the key size \n");
+
+	// a key too long to keep matches nothing (get_key gives NULL), the value is still handed over
+	memset(key, 'k', sizeof(key) - 1);
+	key[sizeof(key) - 1] = '\0';
+	snprintf(document, sizeof(document), "{\"%s\":1,\"b\":2}", key);
+
+	rc = aws_iot_json_stream_feed(&stream, document, strlen(document));
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_C(aws_iot_json_stream_is_complete(&stream));
+	CHECK_EQUAL_C_STRING("?=1;b=2;", streamedValues);
+}
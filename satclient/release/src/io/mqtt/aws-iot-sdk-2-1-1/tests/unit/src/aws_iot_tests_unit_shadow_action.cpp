@@ -44,5 +44,10 @@ TEST_GROUP_C_WRAPPER(ShadowActionTests, GetVersionFromAckStatus)
 TEST_GROUP_C_WRAPPER(ShadowActionTests, StickyNonStickyNeverConflict)
 TEST_GROUP_C_WRAPPER(ShadowActionTests, ACKWaitingMoreThanAllowed)
 TEST_GROUP_C_WRAPPER(ShadowActionTests, InboundDataTooBigForBuffer)
+TEST_GROUP_C_WRAPPER(ShadowActionTests, InboundDataFillingBuffer)
+TEST_GROUP_C_WRAPPER(ShadowActionTests, InboundDataOneByteLargerThanBuffer)
 TEST_GROUP_C_WRAPPER(ShadowActionTests, NoClientTokenForShadowAction)
 TEST_GROUP_C_WRAPPER(ShadowActionTests, NoCallbackForShadowAction)
+TEST_GROUP_C_WRAPPER(ShadowActionTests, TimeoutsDueBeforeALateYield)
+TEST_GROUP_C_WRAPPER(ShadowActionTests, AcksSharingASlot)
+TEST_GROUP_C_WRAPPER(ShadowActionTests, SlotReusedAfterTimeout)
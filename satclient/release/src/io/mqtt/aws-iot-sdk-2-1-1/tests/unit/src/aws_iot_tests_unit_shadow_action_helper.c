@@ -45,7 +45,7 @@ static ShadowInitParameters_t shadowInitParams;
 static ShadowConnectParameters_t shadowConnectParams;
 
 static Shadow_Ack_Status_t ackStatusRx;
-static char jsonFullDocument[200];
+static char jsonFullDocument[SHADOW_MAX_SIZE_OF_RX_BUFFER];
 static ShadowActions_t actionRx;
 
 static void topicNameFromThingAndAction(char *pTopic, const char *pThingName, ShadowActions_t action) {
@@ -781,12 +781,94 @@ TEST_C(ShadowActionTests, InboundDataTooBigForBuffer) {
 	setTLSRxBufferWithMsgOnSubscribedTopic(GET_ACCEPTED_TOPIC, strlen(GET_ACCEPTED_TOPIC), QOS0, params,
 										   params.payload);
 	ret_val = aws_iot_shadow_yield(&client, 200);
-	CHECK_EQUAL_C_INT(MQTT_RX_BUFFER_TOO_SHORT_ERROR, ret_val);
-	CHECK_EQUAL_C_STRING("NOT_VISITED", jsonFullDocument);
+
+	// streamed, only its client token (and version) were kept, so the callback gets an empty document
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_STRING("", jsonFullDocument);
+	CHECK_EQUAL_C_INT(SHADOW_GET, actionRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
 
 	IOT_DEBUG("-->Success - Inbound data too big for buffer \n");
 }
 
+/* A get response whose publish on the accepted topic is packetLen bytes long (with its fixed header, and the null
+ * terminator the mocked broker sends after the payload) */
+static void getResponseForPacketLength(char *pDocument, size_t packetLen) {
+	const char *pPrefix = "{\"clientToken\":\"" AWS_IOT_MQTT_CLIENT_ID "-0\",\"state\":{\"reported\":{\"file\":\"";
+	const char *pSuffix = "\"}}}";
+	size_t remainingLenBytes = 2; // the test packets are between 128 and 16383 bytes
+	size_t documentLen = packetLen - 1 - remainingLenBytes - 2 - strlen(GET_ACCEPTED_TOPIC) - 1;
+	size_t paddingLen = documentLen - strlen(pPrefix) - strlen(pSuffix);
+
+	strcpy(pDocument, pPrefix);
+	memset(pDocument + strlen(pPrefix), 'a', paddingLen);
+	strcpy(pDocument + strlen(pPrefix) + paddingLen, pSuffix);
+}
+
+TEST_C(ShadowActionTests, InboundDataFillingBuffer) {
+	IoT_Error_t ret_val = SUCCESS;
+	char getRequestJson[120];
+	char getResponseJson[AWS_IOT_MQTT_RX_BUF_LEN];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Shadow Action Tests - Inbound data filling the buffer \n");
+
+	snprintf(jsonFullDocument, 200, "NOT_VISITED");
+
+	aws_iot_shadow_internal_get_request_json(getRequestJson);
+	ret_val = aws_iot_shadow_internal_action(AWS_IOT_MY_THING_NAME, SHADOW_GET, getRequestJson, actionCallback, NULL, 4,
+											 false);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+
+	getResponseForPacketLength(getResponseJson, AWS_IOT_MQTT_RX_BUF_LEN);
+	params.payloadLen = strlen(getResponseJson);
+	params.payload = getResponseJson;
+	params.qos = QOS0;
+	setTLSRxBufferWithMsgOnSubscribedTopic(GET_ACCEPTED_TOPIC, strlen(GET_ACCEPTED_TOPIC), QOS0, params,
+										   params.payload);
+	ret_val = aws_iot_shadow_yield(&client, 200);
+
+	// the largest publish that isn't streamed, the callback gets the whole document
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_STRING(getResponseJson, jsonFullDocument);
+	CHECK_EQUAL_C_INT(SHADOW_GET, actionRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
+
+	IOT_DEBUG("-->Success - Inbound data filling the buffer \n");
+}
+
+TEST_C(ShadowActionTests, InboundDataOneByteLargerThanBuffer) {
+	IoT_Error_t ret_val = SUCCESS;
+	char getRequestJson[120];
+	char getResponseJson[AWS_IOT_MQTT_RX_BUF_LEN + 1];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Shadow Action Tests - Inbound data one byte larger than the buffer \n");
+
+	snprintf(jsonFullDocument, 200, "NOT_VISITED");
+
+	aws_iot_shadow_internal_get_request_json(getRequestJson);
+	ret_val = aws_iot_shadow_internal_action(AWS_IOT_MY_THING_NAME, SHADOW_GET, getRequestJson, actionCallback, NULL, 4,
+											 false);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+
+	getResponseForPacketLength(getResponseJson, AWS_IOT_MQTT_RX_BUF_LEN + 1);
+	params.payloadLen = strlen(getResponseJson);
+	params.payload = getResponseJson;
+	params.qos = QOS0;
+	setTLSRxBufferWithMsgOnSubscribedTopic(GET_ACCEPTED_TOPIC, strlen(GET_ACCEPTED_TOPIC), QOS0, params,
+										   params.payload);
+	ret_val = aws_iot_shadow_yield(&client, 200);
+
+	// the smallest publish that is streamed, the callback gets an empty document
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_STRING("", jsonFullDocument);
+	CHECK_EQUAL_C_INT(SHADOW_GET, actionRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
+
+	IOT_DEBUG("-->Success - Inbound data one byte larger than the buffer \n");
+}
+
 #define TEST_JSON_RESPONSE_NO_TOKEN "{\"state\":{\"reported\":{\"sensor1\":98}}}"
 
 TEST_C(ShadowActionTests, NoClientTokenForShadowAction) {
@@ -868,3 +950,159 @@ TEST_C(ShadowActionTests, NoCallbackForShadowAction) {
 
 	IOT_DEBUG("-->Success - No callback for shadow action");
 }
+
+static uint32_t ackCallbackCount;
+static const char *pAckContextRx;
+
+static void countingActionCallback(const char *pThingName, ShadowActions_t action, Shadow_Ack_Status_t status,
+								   const char *pReceivedJsonDocument, void *pContextData) {
+	IOT_UNUSED(pThingName);
+	IOT_UNUSED(pReceivedJsonDocument);
+	actionRx = action;
+	ackStatusRx = status;
+	pAckContextRx = (const char *) pContextData;
+	ackCallbackCount++;
+}
+
+/* A get whose client token ends with pSequence, which is also the context its callback gets. The subscription is
+ * sticky so that a timeout doesn't wait on an unsubscribe. */
+static IoT_Error_t getWithClientTokenSequence(const char *pSequence, uint32_t timeout_seconds) {
+	char getRequestJson[120];
+
+	snprintf(getRequestJson, 120, "{\"clientToken\":\"%s-%s\"}", AWS_IOT_MQTT_CLIENT_ID, pSequence);
+	return aws_iot_shadow_internal_action(AWS_IOT_MY_THING_NAME, SHADOW_GET, getRequestJson, countingActionCallback,
+										  (void *) pSequence, timeout_seconds, true);
+}
+
+static IoT_Error_t acceptGetWithClientTokenSequence(const char *pSequence) {
+	char getResponseJson[120];
+	IoT_Publish_Message_Params params;
+
+	snprintf(getResponseJson, 120, "{\"state\":{\"reported\":{\"sensor1\":98}}, \"clientToken\":\"%s-%s\"}",
+			 AWS_IOT_MQTT_CLIENT_ID, pSequence);
+	params.payloadLen = strlen(getResponseJson);
+	params.payload = getResponseJson;
+	params.qos = QOS0;
+	setTLSRxBufferWithMsgOnSubscribedTopic(GET_ACCEPTED_TOPIC, strlen(GET_ACCEPTED_TOPIC), QOS0, params,
+										   params.payload);
+	return aws_iot_shadow_yield(&client, 200);
+}
+
+TEST_C(ShadowActionTests, TimeoutsDueBeforeALateYield) {
+	IoT_Error_t ret_val = SUCCESS;
+
+	IOT_DEBUG("-->Running Shadow Action Tests - Every timeout due before a late yield \n");
+
+	ackCallbackCount = 0;
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("1", 1));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("2", 2));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("3", 3));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("4", 10));
+
+	ret_val = aws_iot_shadow_yield(&client, 200);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(0, ackCallbackCount);
+
+	// the only yield in the four seconds these timeouts come due in
+	sleep(3 + 1);
+
+	ret_val = aws_iot_shadow_yield(&client, 200);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(3, ackCallbackCount);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_TIMEOUT, ackStatusRx);
+
+	// the one with a longer timeout is still awaited
+	ret_val = acceptGetWithClientTokenSequence("4");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(4, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("4", pAckContextRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
+
+	IOT_DEBUG("-->Success - Every timeout due before a late yield \n");
+}
+
+TEST_C(ShadowActionTests, AcksSharingASlot) {
+	IoT_Error_t ret_val = SUCCESS;
+
+	IOT_DEBUG("-->Running Shadow Action Tests - Acks whose client tokens share a slot \n");
+
+	// 3, 13 and 23 share a slot, so 13, 23 and then 4 are each kept further from their own
+	ackCallbackCount = 0;
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("3", 10));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("13", 10));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("23", 10));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("4", 10));
+
+	ret_val = acceptGetWithClientTokenSequence("4");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(1, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("4", pAckContextRx);
+
+	ret_val = acceptGetWithClientTokenSequence("23");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(2, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("23", pAckContextRx);
+
+	ret_val = acceptGetWithClientTokenSequence("3");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(3, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("3", pAckContextRx);
+
+	// sharing the slot, but not awaited
+	ret_val = acceptGetWithClientTokenSequence("33");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(3, ackCallbackCount);
+
+	// still found once the ones before it in the slot are gone
+	ret_val = acceptGetWithClientTokenSequence("13");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(4, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("13", pAckContextRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
+
+	// an ack is only handed over once
+	ret_val = acceptGetWithClientTokenSequence("13");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(4, ackCallbackCount);
+
+	IOT_DEBUG("-->Success - Acks whose client tokens share a slot \n");
+}
+
+TEST_C(ShadowActionTests, SlotReusedAfterTimeout) {
+	IoT_Error_t ret_val = SUCCESS;
+
+	IOT_DEBUG("-->Running Shadow Action Tests - Slot reused after a timeout \n");
+
+	ackCallbackCount = 0;
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("5", 1));
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("15", 1));
+
+	sleep(1 + 1);
+
+	ret_val = aws_iot_shadow_yield(&client, 200);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(2, ackCallbackCount);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_TIMEOUT, ackStatusRx);
+
+	// a late ack for a get that timed out is dropped
+	ret_val = acceptGetWithClientTokenSequence("15");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(2, ackCallbackCount);
+
+	// the slot is taken again, the timeout of the get that had it doesn't carry over
+	CHECK_EQUAL_C_INT(SUCCESS, getWithClientTokenSequence("25", 3));
+
+	sleep(1 + 1);
+
+	ret_val = aws_iot_shadow_yield(&client, 200);
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(2, ackCallbackCount);
+
+	ret_val = acceptGetWithClientTokenSequence("25");
+	CHECK_EQUAL_C_INT(SUCCESS, ret_val);
+	CHECK_EQUAL_C_INT(3, ackCallbackCount);
+	CHECK_EQUAL_C_STRING("25", pAckContextRx);
+	CHECK_EQUAL_C_INT(SHADOW_ACK_ACCEPTED, ackStatusRx);
+
+	IOT_DEBUG("-->Success - Slot reused after a timeout \n");
+}
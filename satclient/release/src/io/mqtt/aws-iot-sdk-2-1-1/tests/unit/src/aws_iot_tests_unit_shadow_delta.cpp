@@ -31,3 +31,8 @@ TEST_GROUP_C_WRAPPER(ShadowDeltaTest, registerDeltaInt)
 TEST_GROUP_C_WRAPPER(ShadowDeltaTest, registerDeltaIntNoCallback)
 TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaNestedObject)
 TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaVersionIgnoreOldVersion)
+TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaDuplicateAndPrefixSharingKeys)
+TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaMissingRegisteredKey)
+TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaKeyNeverRegistered)
+TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaCallbacksInDocumentOrder)
+TEST_GROUP_C_WRAPPER(ShadowDeltaTest, DeltaRegisterAfterDispatch)
@@ -49,6 +49,56 @@ void nestedObjectCallback(const char *pJsonStringData, uint32_t JsonStringDataLe
 	snprintf(receivedNestedObject, 100, "%.*s", JsonStringDataLen, pJsonStringData);
 }
 
+static char callbackOrder[100] = "";
+
+void orderRecordingCallback(const char *pJsonStringData, uint32_t JsonStringDataLen, jsonStruct_t *pContext) {
+	IOT_UNUSED(pJsonStringData);
+	IOT_UNUSED(JsonStringDataLen);
+	strncat(callbackOrder, pContext->pKey, sizeof(callbackOrder) - strlen(callbackOrder) - 2);
+	strcat(callbackOrder, ",");
+}
+
+static void setupIntHandler(jsonStruct_t *pHandler, const char *pKey, int32_t *pData) {
+	pHandler->cb = orderRecordingCallback;
+	pHandler->pKey = pKey;
+	pHandler->type = SHADOW_JSON_INT32;
+	pHandler->pData = pData;
+}
+
+/* The first key registered subscribes to the delta topic, the mocked broker has to acknowledge it */
+static IoT_Error_t registerDeltaHandlers(jsonStruct_t *pHandlers, uint32_t handlerCount) {
+	IoT_Publish_Message_Params params;
+	IoT_Error_t rc = SUCCESS;
+	uint32_t i;
+
+	params.payloadLen = 0;
+	params.payload = NULL;
+	params.qos = QOS0;
+
+	ResetTLSBuffer();
+	setTLSRxBufferForSuback(shadowDeltaTopic, strlen(shadowDeltaTopic), QOS0, params);
+
+	for(i = 0; i < handlerCount && SUCCESS == rc; i++) {
+		rc = aws_iot_shadow_register_delta(&client, &pHandlers[i]);
+	}
+
+	return rc;
+}
+
+static IoT_Error_t receiveDelta(char *pDeltaJSONString) {
+	IoT_Publish_Message_Params params;
+
+	params.payloadLen = strlen(pDeltaJSONString);
+	params.payload = pDeltaJSONString;
+	params.qos = QOS0;
+
+	callbackOrder[0] = '\0';
+	ResetTLSBuffer();
+	setTLSRxBufferWithMsgOnSubscribedTopic(shadowDeltaTopic, strlen(shadowDeltaTopic), QOS0, params, params.payload);
+
+	return aws_iot_shadow_yield(&client, 100);
+}
+
 TEST_GROUP_C_SETUP(ShadowDeltaTest) {
 	IoT_Error_t ret_val = SUCCESS;
 
@@ -317,3 +367,121 @@ TEST_C(ShadowDeltaTest, DeltaVersionIgnoreOldVersion) {
 	aws_iot_shadow_yield(&client, 100);
 	CHECK_EQUAL_C_STRING(sentNestedObjectData, receivedNestedObject);
 }
+
+TEST_C(ShadowDeltaTest, DeltaDuplicateAndPrefixSharingKeys) {
+	jsonStruct_t handlers[4];
+	int32_t firstTempData = 0;
+	int32_t secondTempData = 0;
+	int32_t tempSetData = 0;
+	int32_t teData = 0;
+	char deltaJSONString[] = "{\"state\":{\"tempSet\":25,\"temp\":21,\"temp\":30}}";
+
+	IOT_DEBUG("\n-->Running Shadow Delta Tests - Delta dispatched to duplicate and prefix sharing keys \n");
+
+	setupIntHandler(&handlers[0], "temp", &firstTempData);
+	setupIntHandler(&handlers[1], "tempSet", &tempSetData);
+	setupIntHandler(&handlers[2], "te", &teData);
+	setupIntHandler(&handlers[3], "temp", &secondTempData);
+	CHECK_EQUAL_C_INT(SUCCESS, registerDeltaHandlers(handlers, 4));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(deltaJSONString));
+
+	// both handlers of "temp" take its first occurrence, in registration order, and "te" matches neither key
+	CHECK_EQUAL_C_INT(21, firstTempData);
+	CHECK_EQUAL_C_INT(21, secondTempData);
+	CHECK_EQUAL_C_INT(25, tempSetData);
+	CHECK_EQUAL_C_INT(0, teData);
+	CHECK_EQUAL_C_STRING("tempSet,temp,temp,", callbackOrder);
+}
+
+TEST_C(ShadowDeltaTest, DeltaMissingRegisteredKey) {
+	jsonStruct_t handlers[2];
+	int32_t windowData = 0;
+	int32_t lengthData = 0;
+	char deltaJSONString[] = "{\"state\":{\"length\":7}}";
+
+	IOT_DEBUG("\n-->Running Shadow Delta Tests - Delta without a registered key \n");
+
+	setupIntHandler(&handlers[0], "window", &windowData);
+	setupIntHandler(&handlers[1], "length", &lengthData);
+	CHECK_EQUAL_C_INT(SUCCESS, registerDeltaHandlers(handlers, 2));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(deltaJSONString));
+
+	CHECK_EQUAL_C_INT(0, windowData);
+	CHECK_EQUAL_C_INT(7, lengthData);
+	CHECK_EQUAL_C_STRING("length,", callbackOrder);
+}
+
+TEST_C(ShadowDeltaTest, DeltaKeyNeverRegistered) {
+	jsonStruct_t handlers[2];
+	int32_t lengthData = 0;
+	int32_t zoomData = 0;
+	char deltaJSONString[] = "{\"state\":{\"aaa\":1,\"lengthy\":2,\"length\":7,\"zzz\":3}}";
+
+	IOT_DEBUG("\n-->Running Shadow Delta Tests - Delta with keys that were never registered \n");
+
+	setupIntHandler(&handlers[0], "length", &lengthData);
+	setupIntHandler(&handlers[1], "zoom", &zoomData);
+	CHECK_EQUAL_C_INT(SUCCESS, registerDeltaHandlers(handlers, 2));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(deltaJSONString));
+
+	// keys sorting before, between and after the registered ones are skipped
+	CHECK_EQUAL_C_INT(7, lengthData);
+	CHECK_EQUAL_C_INT(0, zoomData);
+	CHECK_EQUAL_C_STRING("length,", callbackOrder);
+}
+
+TEST_C(ShadowDeltaTest, DeltaCallbacksInDocumentOrder) {
+	jsonStruct_t handlers[3];
+	int32_t zetaData = 0;
+	int32_t alphaData = 0;
+	int32_t midData = 0;
+	char deltaJSONString[] = "{\"state\":{\"mid\":1,\"zeta\":2,\"alpha\":3}}";
+
+	IOT_DEBUG("\n-->Running Shadow Delta Tests - Delta callbacks in document order \n");
+
+	setupIntHandler(&handlers[0], "zeta", &zetaData);
+	setupIntHandler(&handlers[1], "alpha", &alphaData);
+	setupIntHandler(&handlers[2], "mid", &midData);
+	CHECK_EQUAL_C_INT(SUCCESS, registerDeltaHandlers(handlers, 3));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(deltaJSONString));
+
+	// neither in registration order nor in key order
+	CHECK_EQUAL_C_STRING("mid,zeta,alpha,", callbackOrder);
+	CHECK_EQUAL_C_INT(1, midData);
+	CHECK_EQUAL_C_INT(2, zetaData);
+	CHECK_EQUAL_C_INT(3, alphaData);
+}
+
+TEST_C(ShadowDeltaTest, DeltaRegisterAfterDispatch) {
+	jsonStruct_t handlers[3];
+	int32_t betaData = 0;
+	int32_t alphaData = 0;
+	int32_t secondBetaData = 0;
+	char deltaJSONString[] = "{\"state\":{\"alpha\":1,\"beta\":2}}";
+	char secondDeltaJSONString[] = "{\"state\":{\"beta\":4,\"alpha\":3}}";
+
+	IOT_DEBUG("\n-->Running Shadow Delta Tests - Delta key registered after a delta was dispatched \n");
+
+	setupIntHandler(&handlers[0], "beta", &betaData);
+	setupIntHandler(&handlers[1], "alpha", &alphaData);
+	setupIntHandler(&handlers[2], "beta", &secondBetaData);
+	CHECK_EQUAL_C_INT(SUCCESS, registerDeltaHandlers(handlers, 1));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(deltaJSONString));
+	CHECK_EQUAL_C_STRING("beta,", callbackOrder);
+	CHECK_EQUAL_C_INT(2, betaData);
+
+	// the delta topic is already subscribed, these only go into the index
+	CHECK_EQUAL_C_INT(SUCCESS, aws_iot_shadow_register_delta(&client, &handlers[1]));
+	CHECK_EQUAL_C_INT(SUCCESS, aws_iot_shadow_register_delta(&client, &handlers[2]));
+
+	CHECK_EQUAL_C_INT(SUCCESS, receiveDelta(secondDeltaJSONString));
+	CHECK_EQUAL_C_STRING("beta,beta,alpha,", callbackOrder);
+	CHECK_EQUAL_C_INT(4, betaData);
+	CHECK_EQUAL_C_INT(4, secondBetaData);
+	CHECK_EQUAL_C_INT(3, alphaData);
+}
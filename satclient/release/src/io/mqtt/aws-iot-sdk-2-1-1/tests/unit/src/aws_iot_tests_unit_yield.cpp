@@ -52,3 +52,11 @@ TEST_GROUP_C_WRAPPER(YieldTests, disconnectAutoReconnectSuccess)
 TEST_GROUP_C_WRAPPER(YieldTests, disconnectManualAutoReconnect)
 /* G:12 - Yield, resubscribe to all topics on reconnect */
 TEST_GROUP_C_WRAPPER(YieldTests, resubscribeSuccessfulReconnect)
+/* G:13 - Yield, publish larger than the read buffer streamed to the chunk handler */
+TEST_GROUP_C_WRAPPER(YieldTests, StreamedPublishToChunkHandler)
+/* G:14 - Yield, publish filling the read buffer goes to the message handler */
+TEST_GROUP_C_WRAPPER(YieldTests, PublishFillingReadBuffer)
+/* G:15 - Yield, publish one byte larger than the read buffer streamed to the chunk handler */
+TEST_GROUP_C_WRAPPER(YieldTests, PublishOneByteLargerThanReadBuffer)
+/* G:16 - Yield, publish larger than the read buffer dropped without a chunk handler */
+TEST_GROUP_C_WRAPPER(YieldTests, LargePublishWithoutChunkHandlerDropped)
\ No newline at end of file
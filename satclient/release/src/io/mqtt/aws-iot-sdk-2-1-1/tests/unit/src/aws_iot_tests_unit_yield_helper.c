@@ -38,6 +38,12 @@ static uint16_t subTopicLen = 8;
 
 static bool dcHandlerInvoked = false;
 
+static unsigned char ReceivedPayload[TLSMaxBufferSize];
+static size_t receivedPayloadLen;
+static size_t receivedPayloadTotalLen;
+static uint32_t chunkHandlerCallCount;
+static uint32_t messageHandlerCallCount;
+
 static void iot_tests_unit_acr_subscribe_callback_handler(AWS_IoT_Client *pClient, char *topicName,
 														  uint16_t topicNameLen,
 														  IoT_Publish_Message_Params *params, void *pData) {
@@ -74,6 +80,75 @@ static void iot_tests_unit_yield_test_subscribe_callback_handler(AWS_IoT_Client
 	}
 }
 
+static void iot_tests_unit_whole_publish_callback_handler(AWS_IoT_Client *pClient, char *topicName,
+														  uint16_t topicNameLen,
+														  IoT_Publish_Message_Params *params, void *pData) {
+	IOT_UNUSED(pClient);
+	IOT_UNUSED(topicName);
+	IOT_UNUSED(topicNameLen);
+	IOT_UNUSED(pData);
+
+	memcpy(ReceivedPayload, params->payload, params->payloadLen);
+	receivedPayloadLen = params->payloadLen;
+	messageHandlerCallCount++;
+}
+
+static void iot_tests_unit_chunk_callback_handler(AWS_IoT_Client *pClient, char *topicName, uint16_t topicNameLen,
+												  IoT_Publish_Message_Params *params, size_t payloadOffset,
+												  size_t payloadTotalLen, void *pData) {
+	IoT_Error_t rc = SUCCESS;
+
+	IOT_UNUSED(pData);
+
+	CHECK_EQUAL_C_INT(subTopicLen, topicNameLen);
+	CHECK_C(0 == strncmp(subTopic, topicName, topicNameLen));
+
+	// chunks come in order, and without gaps, up to the total length
+	CHECK_EQUAL_C_INT(receivedPayloadLen, payloadOffset);
+	CHECK_C(payloadOffset + params->payloadLen <= payloadTotalLen);
+	memcpy(ReceivedPayload + payloadOffset, params->payload, params->payloadLen);
+	receivedPayloadLen += params->payloadLen;
+	receivedPayloadTotalLen = payloadTotalLen;
+	chunkHandlerCallCount++;
+
+	rc = aws_iot_mqtt_yield(pClient, 1000);
+	CHECK_EQUAL_C_INT(MQTT_CLIENT_NOT_IDLE_ERROR, rc);
+}
+
+/* A payload for the subscribed topic that makes a publish packetLen bytes long (with its fixed header, and the null
+ * terminator the mocked broker sends after the payload) */
+/* A QoS1 publish on subTopic is packetLen bytes long with this payload (and the null terminator the mocked broker
+ * sends after it) */
+static void setPayloadForPacketLength(char *pPayload, size_t packetLen) {
+	size_t remainingLenBytes = 2; // the test packets are between 128 and 16383 bytes
+	size_t payloadLen = packetLen - 1 - remainingLenBytes - 2 - subTopicLen - 2 - 1;
+	size_t i;
+
+	for(i = 0; i < payloadLen; i++) {
+		pPayload[i] = (char) ('a' + (i % 26));
+	}
+	pPayload[payloadLen] = '\0';
+}
+
+static void subscribeWithChunkHandler(bool isChunkHandlerSet) {
+	IoT_Error_t rc = SUCCESS;
+
+	receivedPayloadLen = 0;
+	receivedPayloadTotalLen = 0;
+	chunkHandlerCallCount = 0;
+	messageHandlerCallCount = 0;
+
+	setTLSRxBufferForSuback(subTopic, subTopicLen, QOS1, testPubMsgParams);
+	rc = aws_iot_mqtt_subscribe(&iotClient, subTopic, subTopicLen, QOS1,
+								iot_tests_unit_whole_publish_callback_handler, NULL);
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	if(isChunkHandlerSet) {
+		rc = aws_iot_mqtt_set_chunk_handler(&iotClient, subTopic, subTopicLen, iot_tests_unit_chunk_callback_handler);
+		CHECK_EQUAL_C_INT(SUCCESS, rc);
+	}
+	ResetTLSBuffer();
+}
+
 void iot_tests_unit_disconnect_handler(AWS_IoT_Client *pClient, void *disconParam) {
 	IOT_UNUSED(pClient);
 	IOT_UNUSED(disconParam);
@@ -450,3 +525,108 @@ TEST_C(YieldTests, resubscribeSuccessfulReconnect) {
 
 	IOT_DEBUG("-->Success - G:12 - Yield, resubscribe to all topics on reconnect \n");
 }
+
+/* G:13 - Yield, publish larger than the read buffer streamed to the chunk handler */
+TEST_C(YieldTests, StreamedPublishToChunkHandler) {
+	IoT_Error_t rc = SUCCESS;
+	char payload[TLSMaxBufferSize];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Yield Tests - G:13 - Yield, publish larger than the read buffer streamed to the chunk handler \n");
+
+	subscribeWithChunkHandler(true);
+
+	setPayloadForPacketLength(payload, AWS_IOT_MQTT_RX_BUF_LEN + 300);
+	params.qos = QOS1;
+	params.payload = payload;
+	params.payloadLen = strlen(payload);
+	setTLSRxBufferWithMsgOnSubscribedTopic(subTopic, subTopicLen, QOS1, params, payload);
+	rc = aws_iot_mqtt_yield(&iotClient, 100);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_INT(0, messageHandlerCallCount);
+	CHECK_EQUAL_C_INT(2, chunkHandlerCallCount);
+	CHECK_EQUAL_C_INT(strlen(payload) + 1, receivedPayloadTotalLen);
+	CHECK_EQUAL_C_INT(receivedPayloadTotalLen, receivedPayloadLen);
+	CHECK_EQUAL_C_STRING(payload, (char *) ReceivedPayload);
+	CHECK_EQUAL_C_INT(1, isLastTLSTxMessagePuback());
+
+	IOT_DEBUG("-->Success - G:13 - Yield, publish larger than the read buffer streamed to the chunk handler \n");
+}
+
+/* G:14 - Yield, publish filling the read buffer goes to the message handler */
+TEST_C(YieldTests, PublishFillingReadBuffer) {
+	IoT_Error_t rc = SUCCESS;
+	char payload[TLSMaxBufferSize];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Yield Tests - G:14 - Yield, publish filling the read buffer goes to the message handler \n");
+
+	subscribeWithChunkHandler(true);
+
+	setPayloadForPacketLength(payload, AWS_IOT_MQTT_RX_BUF_LEN);
+	params.qos = QOS1;
+	params.payload = payload;
+	params.payloadLen = strlen(payload);
+	setTLSRxBufferWithMsgOnSubscribedTopic(subTopic, subTopicLen, QOS1, params, payload);
+	rc = aws_iot_mqtt_yield(&iotClient, 100);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_INT(0, chunkHandlerCallCount);
+	CHECK_EQUAL_C_INT(1, messageHandlerCallCount);
+	CHECK_EQUAL_C_INT(strlen(payload) + 1, receivedPayloadLen);
+	CHECK_EQUAL_C_STRING(payload, (char *) ReceivedPayload);
+
+	IOT_DEBUG("-->Success - G:14 - Yield, publish filling the read buffer goes to the message handler \n");
+}
+
+/* G:15 - Yield, publish one byte larger than the read buffer streamed to the chunk handler */
+TEST_C(YieldTests, PublishOneByteLargerThanReadBuffer) {
+	IoT_Error_t rc = SUCCESS;
+	char payload[TLSMaxBufferSize];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Yield Tests - G:15 - Yield, publish one byte larger than the read buffer streamed to the chunk handler \n");
+
+	subscribeWithChunkHandler(true);
+
+	setPayloadForPacketLength(payload, AWS_IOT_MQTT_RX_BUF_LEN + 1);
+	params.qos = QOS1;
+	params.payload = payload;
+	params.payloadLen = strlen(payload);
+	setTLSRxBufferWithMsgOnSubscribedTopic(subTopic, subTopicLen, QOS1, params, payload);
+	rc = aws_iot_mqtt_yield(&iotClient, 100);
+
+	CHECK_EQUAL_C_INT(SUCCESS, rc);
+	CHECK_EQUAL_C_INT(0, messageHandlerCallCount);
+	CHECK_EQUAL_C_INT(1, chunkHandlerCallCount);
+	CHECK_EQUAL_C_INT(strlen(payload) + 1, receivedPayloadTotalLen);
+	CHECK_EQUAL_C_INT(receivedPayloadTotalLen, receivedPayloadLen);
+	CHECK_EQUAL_C_STRING(payload, (char *) ReceivedPayload);
+
+	IOT_DEBUG("-->Success - G:15 - Yield, publish one byte larger than the read buffer streamed to the chunk handler \n");
+}
+
+/* G:16 - Yield, publish larger than the read buffer dropped without a chunk handler */
+TEST_C(YieldTests, LargePublishWithoutChunkHandlerDropped) {
+	IoT_Error_t rc = SUCCESS;
+	char payload[TLSMaxBufferSize];
+	IoT_Publish_Message_Params params;
+
+	IOT_DEBUG("-->Running Yield Tests - G:16 - Yield, publish larger than the read buffer dropped without a chunk handler \n");
+
+	subscribeWithChunkHandler(false);
+
+	setPayloadForPacketLength(payload, AWS_IOT_MQTT_RX_BUF_LEN + 1);
+	params.qos = QOS1;
+	params.payload = payload;
+	params.payloadLen = strlen(payload);
+	setTLSRxBufferWithMsgOnSubscribedTopic(subTopic, subTopicLen, QOS1, params, payload);
+	rc = aws_iot_mqtt_yield(&iotClient, 100);
+
+	CHECK_EQUAL_C_INT(MQTT_RX_BUFFER_TOO_SHORT_ERROR, rc);
+	CHECK_EQUAL_C_INT(0, messageHandlerCallCount);
+	CHECK_EQUAL_C_INT(0, chunkHandlerCallCount);
+
+	IOT_DEBUG("-->Success - G:16 - Yield, publish larger than the read buffer dropped without a chunk handler \n");
+}
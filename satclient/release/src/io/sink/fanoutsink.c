@@ -0,0 +1,532 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "printf" and "fprintf" functions
+#include <stdlib.h>             //using for "NULL"
+#include <string.h>             //using for "memcpy" and "memset" functions
+#include <pthread.h>            //using for worker threads, mutex, and condition variables
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "fanoutsink.h"
+#include "metrics.h"             //using for "add_to_metrics_gauge" and "increment_metrics_counter" functions
+#include "trace.h"               //using to trace the lanes' publishing
+#include "satconfig.h"           //using for "set_thread_cpu_mask" function
+
+/*
+    Each downstream sink (a lane) gets its own worker thread and a bounded queue of batch slots.
+    A published batch is copied once into a free slot from a shared pool, and the slot is queued to
+    every lane that has room (reference counted). A lane that is full has the batch dropped (and counted)
+    rather than stalling the producer, so a slow transport can never hold up a fast one.
+    The pool holds enough slots for every lane to be full and busy, plus one, so a free slot always exists (it is sized
+    from the queue depth the sink is created with, as each slot is a whole batch).
+
+    Readings a lane loses (batches dropped from its queue, or rejected by its sink) are only lost to that lane's sink,
+    so each lane accounts for them per source, and adds them to the header of the next batch it publishes from that
+    source. As the slots are shared, the lane publishes a copy of that batch (only once it has lost readings).
+*/
+//shared batch slot representation
+typedef struct fanout_batch_slot
+{
+    TELEMETRY_BATCH batch;          //batch contents (read-only while referenced)
+    uint32_t reference_count;       //number of lanes that still have to publish this batch
+}FANOUT_BATCH_SLOT;
+
+//lane (one per downstream sink) representation
+typedef struct fanout_lane
+{
+    struct fanout_context* context;             //fan-out sink state the lane belongs to
+    TELEMETRY_SINK* sink;                       //downstream sink (owned by the fan-out sink)
+    pthread_t worker;                           //thread publishing to the sink
+    pthread_cond_t work_available;              //signaled when a batch is queued or the lane is stopping
+    uint32_t queue[FANOUT_MAX_QUEUE_DEPTH];     //ring of slot indices waiting to be published (queue_depth of them are used)
+    uint32_t queue_head;                        //index of the oldest queued slot
+    uint32_t queue_count;                       //number of queued slots
+    bool is_busy;                               //denotes the worker is currently publishing a batch
+    FANOUT_SINK_STATISTICS statistics;          //delivery statistics for the sink
+    TELEMETRY_LOSS_RECORD losses[TELEMETRY_MAX_SOURCES];   //readings of each source lost to the sink (and the ranges not yet reported)
+    TELEMETRY_BATCH amended_batch;              //copy of the batch being published, when its header has the lane's losses added (only touched by the worker)
+}FANOUT_LANE;
+
+//fan-out sink state representation
+typedef struct fanout_context
+{
+    pthread_mutex_t lock;                       //guards the lanes and the slot reference counts
+    pthread_cond_t lane_idle;                   //signaled whenever a lane finishes a batch
+    bool is_stopping;                           //denotes the workers should drain their queues and exit
+    uint32_t lane_count;                        //number of lanes in use
+    uint32_t queue_depth;                       //batches each lane may have queued
+    uint64_t cpu_mask;                          //cpus the workers run on (0 for any)
+    FANOUT_LANE lanes[FANOUT_MAX_SINKS];        //one lane per downstream sink
+    uint32_t slot_count;                        //lanes * (queue depth + 1) + 1
+    FANOUT_BATCH_SLOT* slots;                   //batch pool shared by every lane
+}FANOUT_CONTEXT;
+
+//function declarations
+static bool open_fanout_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_fanout_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_fanout_sink(TELEMETRY_SINK*);
+static bool close_fanout_sink(TELEMETRY_SINK*);
+static void free_fanout_sink_context(void*);
+static void* run_fanout_lane_worker(void*);
+static void stop_fanout_lane_workers(FANOUT_CONTEXT*, uint32_t);
+static TELEMETRY_LOSS_RECORD* get_fanout_lane_loss_record(FANOUT_LANE*, const TELEMETRY_BATCH*);
+
+//fan-out telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE FANOUT_SINK_INTERFACE =
+{
+    open_fanout_sink,
+    publish_batch_to_fanout_sink,
+    flush_fanout_sink,
+    close_fanout_sink,
+    free_fanout_sink_context
+};
+
+//function definition
+//create a telemetry sink that publishes every batch to each of the supplied sinks in parallel, each sink's worker thread
+//restricted to the cpus of the mask (0 for any), and queueing up to queue depth batches for it
+//the fan-out sink takes ownership of the supplied sinks (they are freed along with it, or immediately on failure)
+TELEMETRY_SINK* new_fanout_telemetry_sink(TELEMETRY_SINK** sinks, uint32_t sink_count, uint32_t queue_depth, uint64_t cpu_mask)
+{
+    //local vars
+    FANOUT_CONTEXT* context;
+    uint32_t i;
+
+    //check inputs
+    if ((sinks != NULL) && (sink_count > 0) && (sink_count <= FANOUT_MAX_SINKS) && (queue_depth > 0) && (queue_depth <= FANOUT_MAX_QUEUE_DEPTH))
+    {
+        //allocate fan-out sink state (owned by the sink), and its slots
+        context = allocate_sat_memory(SAT_MEMORY_FANOUT_SINK, sizeof (FANOUT_CONTEXT));
+        if (context != NULL)
+        {
+            context->slot_count = (sink_count * (queue_depth + 1)) + 1;
+            context->slots = allocate_sat_memory(SAT_MEMORY_FANOUT_SINK, context->slot_count * sizeof (FANOUT_BATCH_SLOT));
+            if (context->slots == NULL)
+            {
+                free_sat_memory(context);
+                context = NULL;
+            }
+        }
+
+        //if the object was successfully created
+        if (context != NULL)
+        {
+            pthread_mutex_init(&(context->lock), NULL);
+            pthread_cond_init(&(context->lane_idle), NULL);
+            context->is_stopping = false;
+            context->lane_count = sink_count;
+            context->queue_depth = queue_depth;
+            context->cpu_mask = cpu_mask;
+
+            //set up each lane
+            for (i = 0; i < sink_count; i++)
+            {
+                context->lanes[i].context = context;
+                context->lanes[i].sink = sinks[i];
+                pthread_cond_init(&(context->lanes[i].work_available), NULL);
+                context->lanes[i].queue_head = 0;
+                context->lanes[i].queue_count = 0;
+                context->lanes[i].is_busy = false;
+                context->lanes[i].statistics.published_batch_count = 0;
+                context->lanes[i].statistics.failed_batch_count = 0;
+                context->lanes[i].statistics.dropped_batch_count = 0;
+                memset(context->lanes[i].losses, 0, sizeof (context->lanes[i].losses));
+            }
+
+            //every slot starts free
+            for (i = 0; i < context->slot_count; i++)
+            {
+                context->slots[i].reference_count = 0;
+            }
+
+            return new_telemetry_sink("FAN-OUT", &FANOUT_SINK_INTERFACE, context);
+        }
+    }
+
+    //we own the supplied sinks, so release them on failure
+    if (sinks != NULL)
+    {
+        for (i = 0; i < sink_count; i++)
+        {
+            free_telemetry_sink(sinks[i]);
+        }
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//get the delivery statistics for one of the fan-out sink's downstream sinks
+bool get_fanout_sink_statistics(TELEMETRY_SINK* sink, uint32_t sink_index, FANOUT_SINK_STATISTICS* statistics)
+{
+    //local vars
+    FANOUT_CONTEXT* context;
+
+    //check inputs
+    if ((sink != NULL) && (sink->interface == &FANOUT_SINK_INTERFACE) && (statistics != NULL))
+    {
+        context = (FANOUT_CONTEXT*)sink->context;
+
+        //if the index refers to a lane in use
+        if (sink_index < context->lane_count)
+        {
+            pthread_mutex_lock(&(context->lock));
+            *statistics = context->lanes[sink_index].statistics;
+            pthread_mutex_unlock(&(context->lock));
+
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//open every downstream sink (on the calling thread, as some prompt for input), then start a worker per sink
+static bool open_fanout_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FANOUT_CONTEXT* context = (FANOUT_CONTEXT*)sink->context;
+    uint32_t opened_count;
+    uint32_t started_count;
+
+    //open the downstream sinks
+    for (opened_count = 0; opened_count < context->lane_count; opened_count++)
+    {
+        if (!open_telemetry_sink(context->lanes[opened_count].sink))
+        {
+            break;
+        }
+    }
+
+    //if every downstream sink was opened
+    if (opened_count == context->lane_count)
+    {
+        context->is_stopping = false;
+
+        //start a worker for each lane
+        for (started_count = 0; started_count < context->lane_count; started_count++)
+        {
+            if (pthread_create(&(context->lanes[started_count].worker), NULL, run_fanout_lane_worker, &(context->lanes[started_count])) != 0)
+            {
+                fprintf(stderr, "ERROR: FAILED TO START FAN-OUT WORKER FOR %s TELEMETRY SINK!\n", context->lanes[started_count].sink->name);
+                break;
+            }
+            set_thread_cpu_mask(context->lanes[started_count].worker, context->cpu_mask);
+        }
+
+        //if every worker was started
+        if (started_count == context->lane_count)
+        {
+            //success
+            return true;
+        }
+
+        //stop the workers that did start
+        stop_fanout_lane_workers(context, started_count);
+    }
+
+    //close the downstream sinks that were opened
+    while (opened_count > 0)
+    {
+        close_telemetry_sink(context->lanes[--opened_count].sink);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//copy the batch into a pooled slot once and queue it to every lane with room (never blocks on a slow lane)
+static bool publish_batch_to_fanout_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    FANOUT_CONTEXT* context = (FANOUT_CONTEXT*)sink->context;
+    FANOUT_BATCH_SLOT* slot = NULL;
+    FANOUT_LANE* lane;
+    TELEMETRY_LOSS_RECORD* loss;
+    uint32_t slot_index;
+    uint32_t accepted_count = 0;        //number of lanes the batch was queued to
+    uint32_t dropped_lanes = 0;         //bit per lane the batch was dropped by
+    uint32_t i;
+
+    //find a free slot (one always exists, see slot_count)
+    pthread_mutex_lock(&(context->lock));
+    for (slot_index = 0; slot_index < context->slot_count; slot_index++)
+    {
+        if (context->slots[slot_index].reference_count == 0)
+        {
+            slot = &(context->slots[slot_index]);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&(context->lock));
+
+    //if no slot was found (cannot happen while publishing from a single thread)
+    if (slot == NULL)
+    {
+        //failure
+        return false;
+    }
+
+    //copy the batch (only the used portion of the payload) outside of the lock, workers never touch an unreferenced slot
+    memcpy(&(slot->batch), batch, get_telemetry_batch_used_size(batch));
+
+    //queue the slot to each lane that has room
+    pthread_mutex_lock(&(context->lock));
+    for (i = 0; i < context->lane_count; i++)
+    {
+        lane = &(context->lanes[i]);
+
+        if (lane->queue_count < context->queue_depth)
+        {
+            lane->queue[(lane->queue_head + lane->queue_count) % context->queue_depth] = slot_index;
+            lane->queue_count++;
+            slot->reference_count++;
+            accepted_count++;
+            add_to_metrics_gauge(METRICS_QUEUE_DEPTH, 1);
+            pthread_cond_signal(&(lane->work_available));
+        }
+        else
+        {
+            lane->statistics.dropped_batch_count++;
+            increment_metrics_counter(METRICS_BATCHES_DROPPED, 1);
+            dropped_lanes |= (1u << i);
+        }
+    }
+
+    //account for the readings each lane that dropped the batch lost (when every lane dropped it the publish fails, and the publisher accounts for them instead)
+    for (i = 0; (i < context->lane_count) && (accepted_count > 0); i++)
+    {
+        loss = get_fanout_lane_loss_record(&(context->lanes[i]), batch);
+        if (((dropped_lanes & (1u << i)) != 0) && (loss != NULL))
+        {
+            record_telemetry_loss(loss, TELEMETRY_LOSS_RING_DROP, batch->header.first_sequence_id, batch->header.last_sequence_id, batch->reading_count);
+        }
+    }
+    pthread_mutex_unlock(&(context->lock));
+
+    //success if at least one lane took the batch
+    return (accepted_count > 0);
+}
+
+//function definition
+//wait for every lane to drain its queue, then flush each downstream sink
+static bool flush_fanout_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FANOUT_CONTEXT* context = (FANOUT_CONTEXT*)sink->context;
+    bool operation_status = true;       //denotes success or failure of the operation
+    bool is_drained;
+    uint32_t i;
+
+    //wait until no lane has queued or in-flight batches
+    pthread_mutex_lock(&(context->lock));
+    do
+    {
+        is_drained = true;
+
+        for (i = 0; i < context->lane_count; i++)
+        {
+            if ((context->lanes[i].queue_count > 0) || (context->lanes[i].is_busy))
+            {
+                is_drained = false;
+            }
+        }
+
+        if (!is_drained)
+        {
+            pthread_cond_wait(&(context->lane_idle), &(context->lock));
+        }
+    }
+    while (!is_drained);
+    pthread_mutex_unlock(&(context->lock));
+
+    //the workers are idle and only the caller can queue more, so flushing from this thread is safe
+    for (i = 0; i < context->lane_count; i++)
+    {
+        operation_status &= flush_telemetry_sink(context->lanes[i].sink);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//let the workers drain their queues, then close every downstream sink
+static bool close_fanout_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    FANOUT_CONTEXT* context = (FANOUT_CONTEXT*)sink->context;
+    bool operation_status = true;       //denotes success or failure of the operation
+    uint32_t i;
+
+    //stop (and join) the workers
+    stop_fanout_lane_workers(context, context->lane_count);
+
+    //close the downstream sinks and report how each one fared
+    for (i = 0; i < context->lane_count; i++)
+    {
+        printf("%s telemetry sink - published: %llu, failed: %llu, dropped: %llu\n",
+               context->lanes[i].sink->name,
+               (unsigned long long)context->lanes[i].statistics.published_batch_count,
+               (unsigned long long)context->lanes[i].statistics.failed_batch_count,
+               (unsigned long long)context->lanes[i].statistics.dropped_batch_count);
+
+        operation_status &= close_telemetry_sink(context->lanes[i].sink);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//deallocate the fan-out sink state along with the downstream sinks it owns
+static void free_fanout_sink_context(void* sink_context)
+{
+    //local vars
+    FANOUT_CONTEXT* context;
+    uint32_t i;
+
+    //check input
+    if (sink_context != NULL)
+    {
+        context = (FANOUT_CONTEXT*)sink_context;
+
+        for (i = 0; i < context->lane_count; i++)
+        {
+            free_telemetry_sink(context->lanes[i].sink);
+            pthread_cond_destroy(&(context->lanes[i].work_available));
+        }
+
+        pthread_cond_destroy(&(context->lane_idle));
+        pthread_mutex_destroy(&(context->lock));
+
+        free_sat_memory(context->slots);
+        free_sat_memory(sink_context);
+    }
+}
+
+//function definition
+//lane worker - publish queued batches to the lane's sink until stopped (remaining batches are drained first)
+static void* run_fanout_lane_worker(void* parameter)
+{
+    //local vars
+    FANOUT_LANE* lane = (FANOUT_LANE*)parameter;
+    FANOUT_CONTEXT* context = lane->context;
+    FANOUT_BATCH_SLOT* slot;
+    const TELEMETRY_BATCH* batch;           //batch published (the slot's, or the lane's amended copy of it)
+    TELEMETRY_LOSS_RECORD* loss;
+    TELEMETRY_LOSS_RECORD reported_loss;    //losses added to the amended copy's header (or listed by a rejected one)
+    bool publish_status;
+
+    TRACE_THREAD_NAME("fan-out lane");
+    pthread_mutex_lock(&(context->lock));
+
+    //loop forever
+    while (true)
+    {
+        //wait for work
+        while ((lane->queue_count == 0) && (!context->is_stopping))
+        {
+            pthread_cond_wait(&(lane->work_available), &(context->lock));
+        }
+
+        //exit once stopping and drained
+        if (lane->queue_count == 0)
+        {
+            break;
+        }
+
+        //take the oldest queued batch
+        slot = &(context->slots[lane->queue[lane->queue_head]]);
+        lane->queue_head = (lane->queue_head + 1) % context->queue_depth;
+        lane->queue_count--;
+        lane->is_busy = true;
+        add_to_metrics_gauge(METRICS_QUEUE_DEPTH, -1);
+
+        //if the lane has lost readings of the batch's source, take them (to add to the header of a copy of the batch)
+        batch = &(slot->batch);
+        loss = get_fanout_lane_loss_record(lane, batch);
+        if ((loss != NULL) && ((loss->lost_counts[TELEMETRY_LOSS_RING_DROP] > 0) || (loss->lost_counts[TELEMETRY_LOSS_PUBLISH_FAILURE] > 0)))
+        {
+            reported_loss = *loss;
+            clear_telemetry_loss_gaps(loss);
+            batch = &(lane->amended_batch);
+        }
+
+        //publish outside of the lock (the slot can't be reused while we hold a reference to it)
+        pthread_mutex_unlock(&(context->lock));
+        if (batch == &(lane->amended_batch))
+        {
+            memcpy(&(lane->amended_batch), &(slot->batch), get_telemetry_batch_used_size(&(slot->batch)));
+            merge_telemetry_loss(&(lane->amended_batch.header.loss), &reported_loss);
+            encode_telemetry_batch_header(&(lane->amended_batch));
+        }
+        TRACE_BEGIN(lane->sink->name);
+        publish_status = publish_telemetry_batch_to_sink(lane->sink, batch);
+        TRACE_END_WITH_VALUE(lane->sink->name, !publish_status);
+        pthread_mutex_lock(&(context->lock));
+
+        //record the outcome and release our reference
+        if (publish_status)
+        {
+            lane->statistics.published_batch_count++;
+        }
+        else
+        {
+            lane->statistics.failed_batch_count++;
+
+            //account for the readings the sink lost, and have the ranges the rejected header listed reported again (without counting them twice)
+            if (loss != NULL)
+            {
+                reported_loss = batch->header.loss;
+                memset(reported_loss.lost_counts, 0, sizeof (reported_loss.lost_counts));
+                merge_telemetry_loss(loss, &reported_loss);
+                record_telemetry_loss(loss, TELEMETRY_LOSS_PUBLISH_FAILURE, batch->header.first_sequence_id, batch->header.last_sequence_id, batch->reading_count);
+            }
+        }
+
+        slot->reference_count--;
+        lane->is_busy = false;
+        pthread_cond_broadcast(&(context->lane_idle));
+    }
+
+    pthread_mutex_unlock(&(context->lock));
+
+    return NULL;
+}
+
+//function definition
+//signal the first "worker_count" lane workers to drain and exit, then wait for them
+static void stop_fanout_lane_workers(FANOUT_CONTEXT* context, uint32_t worker_count)
+{
+    //local vars
+    uint32_t i;
+
+    pthread_mutex_lock(&(context->lock));
+    context->is_stopping = true;
+    for (i = 0; i < worker_count; i++)
+    {
+        pthread_cond_signal(&(context->lanes[i].work_available));
+    }
+    pthread_mutex_unlock(&(context->lock));
+
+    for (i = 0; i < worker_count; i++)
+    {
+        pthread_join(context->lanes[i].worker, NULL);
+    }
+}
+
+//function definition
+//get the record of the lane's losses of a batch's source (NULL for a batch without a header)
+static TELEMETRY_LOSS_RECORD* get_fanout_lane_loss_record(FANOUT_LANE* lane, const TELEMETRY_BATCH* batch)
+{
+    if ((batch->header_size > 0) && (batch->header.source_index < TELEMETRY_MAX_SOURCES))
+    {
+        return &(lane->losses[batch->header.source_index]);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,402 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdarg.h>             //using for "va_list" type
+#include <stdio.h>              //using for "fprintf" and "vsnprintf" functions
+#include <stdlib.h>             //using for "NULL"
+#include <stddef.h>             //using for "offsetof" macro
+#include <string.h>             //using for "strnlen", "memcpy", "memmove", and "memchr" functions
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "telemetrysink.h"
+
+//global vars
+static const char* const LOSS_STAGE_NAMES[TELEMETRY_LOSS_STAGE_COUNT] = {"sensor_overrun", "ring_drop", "encode_failure", "publish_failure"};
+
+//function declarations
+static bool append_to_buffer(char*, size_t, size_t*, const char*, ...) __attribute__((format(printf, 4, 5)));
+
+//function definition
+//empty a batch so it can be refilled (scale factors, and the header's source and loss accounting, are left as they are)
+void clear_telemetry_batch(TELEMETRY_BATCH* batch)
+{
+    //check input
+    if (batch != NULL)
+    {
+        clear_sample_batch(&(batch->samples));
+        batch->header.first_sequence_id = -1;
+        batch->header.last_sequence_id = -1;
+        batch->reading_count = 0;
+        batch->header_size = 0;
+        batch->payload_size = 0;
+        batch->payload[0] = '\0';
+    }
+}
+
+//function definition
+//encode a reading onto the end of a batch (as a single line of json)
+bool append_telemetry_reading_to_batch(TELEMETRY_BATCH* batch, const TELEMETRY_READING* reading)
+{
+    //local vars
+    uint32_t json_size;
+
+    //check inputs
+    if ((batch != NULL) && (reading != NULL) && (batch->reading_count < TELEMETRY_BATCH_MAX_READINGS))
+    {
+        //get the size of the reading (it is never longer than its buffer)
+        json_size = strnlen(reading->json, sizeof (reading->json) - 1);
+
+        //if the reading (and its newline) won't fit in what's left of the payload (the header has room of its own)
+        if ((batch->payload_size - batch->header_size + json_size + 1) > TELEMETRY_BATCH_MAX_PAYLOAD_SIZE)
+        {
+            //failure
+            return false;
+        }
+
+        //copy the reading and terminate the line
+        memcpy(&(batch->payload[batch->payload_size]), reading->json, json_size);
+        batch->payload_size += json_size;
+        batch->payload[batch->payload_size++] = '\n';
+        batch->payload[batch->payload_size] = '\0';
+        batch->reading_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//encode the batch's header as the first line of its payload, ahead of the readings (replacing the header if it was already encoded)
+bool encode_telemetry_batch_header(TELEMETRY_BATCH* batch)
+{
+    //local vars
+    bool operation_status;              //denotes success or failure of the operation
+    char header[TELEMETRY_BATCH_MAX_HEADER_SIZE];
+    size_t header_size = 0;
+    const TELEMETRY_LOSS_RECORD* loss;
+    uint32_t i;
+
+    //check input
+    if ((batch != NULL) && (batch->header.device_id != NULL))
+    {
+        loss = &(batch->header.loss);
+
+        operation_status = append_to_buffer(header, sizeof (header), &header_size,
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"batch\":"
+                    "{"
+                      "\"first_sequence_id\":%d,"
+                      "\"last_sequence_id\":%d,"
+                      "\"reading_count\":%u,"
+                      "\"lost\":{\"%s\":%llu,\"%s\":%llu,\"%s\":%llu,\"%s\":%llu},"
+                      "\"omitted_gap_count\":%u,"
+                      "\"gaps\":[",
+                batch->header.device_id,
+                batch->header.source_index,
+                batch->header.first_sequence_id,
+                batch->header.last_sequence_id,
+                batch->reading_count,
+                LOSS_STAGE_NAMES[0], (unsigned long long)loss->lost_counts[0],
+                LOSS_STAGE_NAMES[1], (unsigned long long)loss->lost_counts[1],
+                LOSS_STAGE_NAMES[2], (unsigned long long)loss->lost_counts[2],
+                LOSS_STAGE_NAMES[3], (unsigned long long)loss->lost_counts[3],
+                loss->omitted_gap_count);
+        for (i = 0; i < loss->gap_count; i++)
+        {
+            operation_status &= append_to_buffer(header, sizeof (header), &header_size, "%s{\"stage\":\"%s\",\"first_sequence_id\":%d,\"last_sequence_id\":%d}",
+                                                 (i == 0) ? "" : ",", LOSS_STAGE_NAMES[loss->gaps[i].stage], loss->gaps[i].first_sequence_id, loss->gaps[i].last_sequence_id);
+        }
+        operation_status &= append_to_buffer(header, sizeof (header), &header_size, "]}}\n");
+
+        //if the header fit in its room
+        if (operation_status)
+        {
+            //move the readings (and the null terminator) up against the header, then copy the header in front of them
+            memmove(&(batch->payload[header_size]), &(batch->payload[batch->header_size]), batch->payload_size - batch->header_size + 1);
+            memcpy(batch->payload, header, header_size);
+            batch->payload_size = batch->payload_size - batch->header_size + (uint32_t)header_size;
+            batch->header_size = (uint32_t)header_size;
+
+            //success
+            return true;
+        }
+
+        fprintf(stderr, "ERROR: FAILED TO ENCODE TELEMETRY BATCH HEADER!\n");
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//account for readings lost at a stage, first_sequence_id to last_sequence_id are the range they were lost in (a range that continues the latest one at the same stage extends it)
+void record_telemetry_loss(TELEMETRY_LOSS_RECORD* record, TELEMETRY_LOSS_STAGE stage, int first_sequence_id, int last_sequence_id, uint64_t lost_count)
+{
+    //local vars
+    TELEMETRY_LOSS_GAP* latest_gap;
+
+    //check inputs
+    if ((record != NULL) && (stage < TELEMETRY_LOSS_STAGE_COUNT) && (first_sequence_id <= last_sequence_id))
+    {
+        record->lost_counts[stage] += lost_count;
+
+        //if the range continues (or overlaps) the latest one lost at the same stage
+        latest_gap = (record->gap_count > 0) ? &(record->gaps[record->gap_count - 1]) : NULL;
+        if ((latest_gap != NULL) && (latest_gap->stage == stage) && (first_sequence_id >= latest_gap->first_sequence_id) && (first_sequence_id <= (latest_gap->last_sequence_id + 1)))
+        {
+            latest_gap->last_sequence_id = (last_sequence_id > latest_gap->last_sequence_id) ? last_sequence_id : latest_gap->last_sequence_id;
+        }
+        else if (record->gap_count < TELEMETRY_MAX_GAPS)
+        {
+            record->gaps[record->gap_count].stage = stage;
+            record->gaps[record->gap_count].first_sequence_id = first_sequence_id;
+            record->gaps[record->gap_count].last_sequence_id = last_sequence_id;
+            record->gap_count++;
+        }
+        else
+        {
+            record->omitted_gap_count++;
+        }
+    }
+}
+
+//function definition
+//add another record's losses (its counts and ranges) to a record
+void merge_telemetry_loss(TELEMETRY_LOSS_RECORD* record, const TELEMETRY_LOSS_RECORD* other)
+{
+    //local vars
+    uint32_t i;
+
+    //check inputs
+    if ((record != NULL) && (other != NULL))
+    {
+        for (i = 0; i < TELEMETRY_LOSS_STAGE_COUNT; i++)
+        {
+            record->lost_counts[i] += other->lost_counts[i];
+        }
+        for (i = 0; i < other->gap_count; i++)
+        {
+            record_telemetry_loss(record, other->gaps[i].stage, other->gaps[i].first_sequence_id, other->gaps[i].last_sequence_id, 0);
+        }
+        record->omitted_gap_count += other->omitted_gap_count;
+    }
+}
+
+//function definition
+//forget the ranges lost since the last delivered header, once a header listing them has been delivered (the counts are kept)
+void clear_telemetry_loss_gaps(TELEMETRY_LOSS_RECORD* record)
+{
+    //check input
+    if (record != NULL)
+    {
+        record->gap_count = 0;
+        record->omitted_gap_count = 0;
+    }
+}
+
+//function definition
+//get the number of bytes of a batch that are in use (everything up to and including the payload's null terminator)
+uint32_t get_telemetry_batch_used_size(const TELEMETRY_BATCH* batch)
+{
+    return (uint32_t)(offsetof(TELEMETRY_BATCH, payload) + batch->payload_size + 1);
+}
+
+//function definition
+//walk the lines (readings) of a batch, for transports that send one reading per message
+//offset should start at zero, line receives a pointer into the batch (not null terminated) and line_size its length excluding the newline
+bool get_next_telemetry_batch_line(const TELEMETRY_BATCH* batch, uint32_t* offset, const char** line, uint32_t* line_size)
+{
+    //local vars
+    const char* line_end;
+
+    //check inputs
+    if ((batch != NULL) && (offset != NULL) && (line != NULL) && (line_size != NULL) && (*offset < batch->payload_size))
+    {
+        //find the end of the current line
+        *line = &(batch->payload[*offset]);
+        line_end = memchr(*line, '\n', batch->payload_size - *offset);
+
+        //if the line is terminated (it always is when built by "append_telemetry_reading_to_batch")
+        if (line_end != NULL)
+        {
+            *line_size = (uint32_t)(line_end - *line);
+            *offset += *line_size + 1;
+        }
+        else
+        {
+            *line_size = batch->payload_size - *offset;
+            *offset = batch->payload_size;
+        }
+
+        //success
+        return true;
+    }
+
+    //no more lines
+    return false;
+}
+
+//function definition
+//create telemetry sink object (takes ownership of the context, which is released through the interface's "free_context" function)
+TELEMETRY_SINK* new_telemetry_sink(const char* name, const TELEMETRY_SINK_INTERFACE* interface, void* context)
+{
+    //local vars
+    TELEMETRY_SINK* sink;
+
+    //check inputs
+    if ((name != NULL) && (interface != NULL))
+    {
+        //allocate telemetry sink object
+        sink = allocate_sat_memory(SAT_MEMORY_TELEMETRY_SINK, sizeof (TELEMETRY_SINK));
+
+        //if the object was successfully created
+        if (sink != NULL)
+        {
+            sink->name = name;
+            sink->interface = interface;
+            sink->context = context;
+            sink->is_open = false;
+
+            //return handle to new object
+            return sink;
+        }
+    }
+
+    //release the context so the caller doesn't need to on failure
+    if ((interface != NULL) && (interface->free_context != NULL))
+    {
+        interface->free_context(context);
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//deinit the telemetry sink (closing it first if it is still open)
+void free_telemetry_sink(TELEMETRY_SINK* sink)
+{
+    //check input
+    if (sink != NULL)
+    {
+        //close the transport if the caller didn't
+        close_telemetry_sink(sink);
+
+        //deallocate the transport specific context
+        if (sink->interface->free_context != NULL)
+        {
+            sink->interface->free_context(sink->context);
+        }
+
+        //deallocate telemetry sink object
+        free_sat_memory(sink);
+    }
+}
+
+//function definition
+//open the sink's underlying transport
+bool open_telemetry_sink(TELEMETRY_SINK* sink)
+{
+    //check input
+    if (sink != NULL)
+    {
+        //if the transport was successfully opened
+        if (sink->is_open || sink->interface->open(sink))
+        {
+            sink->is_open = true;
+
+            //success
+            return true;
+        }
+
+        fprintf(stderr, "ERROR: FAILED TO OPEN %s TELEMETRY SINK!\n", sink->name);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//publish a batch of telemetry readings to the sink
+bool publish_telemetry_batch_to_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //check inputs
+    if ((sink != NULL) && (batch != NULL) && (sink->is_open))
+    {
+        //nothing to send is not a failure
+        if ((batch->reading_count == 0) && (batch->samples.sample_count == 0))
+        {
+            return true;
+        }
+
+        return sink->interface->publish_batch(sink, batch);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//flush anything the sink is holding
+bool flush_telemetry_sink(TELEMETRY_SINK* sink)
+{
+    //check input
+    if ((sink != NULL) && (sink->is_open))
+    {
+        return sink->interface->flush(sink);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//close the sink's underlying transport
+bool close_telemetry_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    bool operation_status = false;      //denotes success or failure of the operation
+
+    //check input
+    if ((sink != NULL) && (sink->is_open))
+    {
+        operation_status = sink->interface->close(sink);
+        sink->is_open = false;
+    }
+
+    return operation_status;
+}
+
+//function definition
+//append formatted text to a buffer, returns false (leaving the buffer null terminated) if it didn't fit
+static bool append_to_buffer(char* buffer, size_t buffer_size, size_t* size, const char* format, ...)
+{
+    //local vars
+    va_list arguments;
+    int appended_size;
+
+    if (*size >= buffer_size)
+    {
+        return false;
+    }
+
+    va_start(arguments, format);
+    appended_size = vsnprintf(&(buffer[*size]), buffer_size - *size, format, arguments);
+    va_end(arguments);
+
+    if ((appended_size < 0) || ((size_t)appended_size >= (buffer_size - *size)))
+    {
+        *size = buffer_size - 1;
+        return false;
+    }
+
+    *size += (size_t)appended_size;
+
+    return true;
+}
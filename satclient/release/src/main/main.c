@@ -3,21 +3,111 @@
    Repo: https://github.com/embeddedcognition/satclient
 */
 
-#include <stdlib.h>              //using for "EXIT_..." macros
+#include <stdio.h>               //using for "fprintf" function
+#include <stdlib.h>              //using for "strtol" function and "EXIT_..." macros
+#include <string.h>              //using for "strcspn", "strncmp", and "strcmp" functions
+#include <unistd.h>              //using for "access" function
+#include "satconfig.h"           //using to load the SAT client's configuration (and reload its tunables on SIGHUP)
+#include "iotdevicegateway.h"    //using for aws iot mqtt telemetry sink
+#include "iotdeviceshadow.h"     //using to take the tunables from the aws iot thing shadow
+#include "eventhub.h"            //using for azure event hub amqp telemetry sink
+#include "filesink.h"            //using for local file telemetry sink
+#include "columnarsink.h"        //using for local columnar (memory mapped) file telemetry sink
+#include "fanoutsink.h"          //using to publish to several telemetry sinks at once
 #include "lsm9ds0processor.h"    //using SAT processor logic
+#include "metricsendpoint.h"     //using to expose the SAT process metrics
+#include "trace.h"               //using to write the SAT process trace (trace builds)
+#include "satmemory.h"           //using to report the memory each module used (memory report builds)
 
 //global vars
-static const int DESIRED_PROCESSING_LIMIT = 3000;   //stop the SAT process after it has sent the desired number of messages
+static const char DEFAULT_CONFIG_FILE[] = "/home/root/satclient.conf";         //config file read when none is named on the command line (the defaults are used if it doesn't exist, see satconfig.h)
+static const uint32_t DEFAULT_EVENT_BASELINE_LENGTH = 500;                      //~5 seconds
+static const uint32_t DEFAULT_EVENT_ZSCORE_LENGTH = 100;                        //~1 second
+#ifdef SATCLIENT_TRACE
+static const uint32_t TRACE_FLUSH_INTERVAL_MS = 100;                            //milliseconds between writes of the traced events
+#endif
+static SAT_CONFIG config;                                                       //resolved configuration (the sinks and options refer to its strings for the life of the process)
 
 //function declarations
 int main(const int, const char**);
+static TELEMETRY_SINK* new_telemetry_sink_from_config(const SAT_CONFIG*, uint32_t);
+static void get_gateway_settings_from_config(const SAT_CONFIG*, IOT_DEVICE_GATEWAY_SETTINGS*);
+static bool get_sat_options_from_config(const SAT_CONFIG*, LSM9DS0_SAT_OPTIONS*);
+static bool get_devices_from_config(const SAT_CONFIG*, LSM9DS0_SAT_OPTIONS*);
 
 //function definition
-//main thread of execution
+//main thread of execution (the config file may be named as the only argument)
 int main(const int argc, const char** argv)
 {
+    //local vars
+    TELEMETRY_SINK* sink = NULL;
+    METRICS_ENDPOINT* metrics_endpoint;
+    SAT_CONFIG_WATCHER* config_watcher = NULL;
+    IOT_DEVICE_SHADOW* shadow = NULL;
+    IOT_DEVICE_GATEWAY_SETTINGS gateway_settings;
+#ifdef SATCLIENT_TRACE
+    TRACE_WRITER* trace_writer;
+#endif
+    LSM9DS0_SAT_OPTIONS options;
+    const char* config_file;
+    bool operation_status = false;      //denotes success or failure of the operation
+
+    //read the configuration (the default file is optional, a named one isn't)
+    config_file = (argc > 1) ? argv[1] : ((access(DEFAULT_CONFIG_FILE, R_OK) == 0) ? DEFAULT_CONFIG_FILE : NULL);
+
+    //create the telemetry sink(s) the SAT process publishes to (once the configuration is known to be valid)
+    if (load_sat_config(&config, config_file) && get_sat_options_from_config(&config, &options))
+    {
+        //reload the tunables on SIGHUP (before any other thread is started, so the watcher's is the one that takes the signal)
+        //the SAT process runs with the tunables it started with if they can't be
+        config_watcher = new_sat_config_watcher(config_file, &config);
+        options.config_watcher = config_watcher;
+
+        sink = new_telemetry_sink_from_config(&config, options.device_count);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: INVALID CONFIGURATION%s%s!\n", (config_file != NULL) ? " IN " : "", (config_file != NULL) ? config_file : "");
+    }
+
+    //if the sink was successfully created
+    if (sink != NULL)
+    {
+        //expose the metrics while the SAT process runs (it runs without them if they can't be)
+        metrics_endpoint = new_metrics_endpoint((uint16_t)config.metrics_port, config.metrics_interval);
+#ifdef SATCLIENT_TRACE
+        trace_writer = new_trace_writer(config.trace_file, TRACE_FLUSH_INTERVAL_MS);
+#endif
+
+        //take the tunables from the thing shadow (the SAT process runs with the configured ones if it can't)
+        if (config.aws_shadow && (config_watcher != NULL))
+        {
+            get_gateway_settings_from_config(&config, &gateway_settings);
+            shadow = new_iot_device_shadow(&gateway_settings, config.aws_thing_name, config_watcher);
+        }
+
+        //run the SAT process
+        operation_status = perform_lsm9ds0_sat(sink, (int)config.processing_limit, &options);
+
+        //deallocate the shadow, the trace writer (writing the rest of the trace), the metrics endpoint, and the sink
+        free_iot_device_shadow(shadow);
+#ifdef SATCLIENT_TRACE
+        free_trace_writer(trace_writer);
+#endif
+        free_metrics_endpoint(metrics_endpoint);
+        free_telemetry_sink(sink);
+    }
+
+    //stop reloading the tunables
+    free_sat_config_watcher(config_watcher);
+
+#ifdef SATCLIENT_MEMORY_REPORT
+    //report the memory each module used (anything still held once everything is freed is a leak)
+    write_sat_memory_report(stdout);
+#endif
+
     //if the SAT process was successful
-    if (perform_lsm9ds0_sat(DESIRED_PROCESSING_LIMIT))
+    if (operation_status)
     {
         //exit program, clean return code
         return EXIT_SUCCESS;
@@ -28,3 +118,283 @@ int main(const int argc, const char** argv)
         return EXIT_FAILURE;
     }
 }
+
+//function definition
+//create the sink(s) named in the configuration, combined with a fan-out sink when more than one is requested
+//(the columnar sink has no column for the board a sample came from, so it is only available with a single board)
+static TELEMETRY_SINK* new_telemetry_sink_from_config(const SAT_CONFIG* config, uint32_t device_count)
+{
+    //local vars
+    const char* name;
+    uint32_t name_size;
+    TELEMETRY_SINK* sinks[FANOUT_MAX_SINKS];
+    uint32_t sink_count = 0;
+    IOT_DEVICE_GATEWAY_SETTINGS gateway_settings;
+    uint32_t i;
+
+    //the aws sink connects with the configured endpoint, credentials, and topic
+    get_gateway_settings_from_config(config, &gateway_settings);
+
+    //create a sink for each comma separated name
+    name = config->sinks;
+    while (*name != '\0')
+    {
+        name_size = strcspn(name, ",");
+
+        //if we're out of room
+        if (sink_count == FANOUT_MAX_SINKS)
+        {
+            fprintf(stderr, "ERROR: TOO MANY TELEMETRY SINKS REQUESTED (MAX %d)!\n", FANOUT_MAX_SINKS);
+            break;
+        }
+
+        if ((name_size == 3) && (strncmp(name, "aws", name_size) == 0))
+        {
+            sinks[sink_count] = new_iot_device_gateway_telemetry_sink(&gateway_settings);
+        }
+        else if ((name_size == 5) && (strncmp(name, "azure", name_size) == 0))
+        {
+            sinks[sink_count] = new_event_hub_telemetry_sink();
+        }
+        else if ((name_size == 4) && (strncmp(name, "file", name_size) == 0))
+        {
+            sinks[sink_count] = new_file_telemetry_sink(config->sink_file);
+        }
+        else if ((name_size == 8) && (strncmp(name, "columnar", name_size) == 0) && (device_count == 1))
+        {
+            sinks[sink_count] = new_columnar_telemetry_sink(config->columnar_sink_file);
+        }
+        else if ((name_size == 8) && (strncmp(name, "columnar", name_size) == 0))
+        {
+            fprintf(stderr, "ERROR: THE COLUMNAR TELEMETRY SINK ONLY SUPPORTS A SINGLE DEVICE!\n");
+            sinks[sink_count] = NULL;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: UNKNOWN TELEMETRY SINK: %.*s!\n", (int)name_size, name);
+            sinks[sink_count] = NULL;
+        }
+
+        //if the sink couldn't be created
+        if (sinks[sink_count] == NULL)
+        {
+            break;
+        }
+
+        sink_count++;
+
+        //advance past the name (and the comma)
+        name += name_size;
+        if (*name == ',')
+        {
+            name++;
+        }
+    }
+
+    //if every requested sink was created
+    if ((*name == '\0') && (sink_count > 0))
+    {
+        //a single sink is used directly, several are fed through a fan-out sink
+        if (sink_count == 1)
+        {
+            return sinks[0];
+        }
+
+        return new_fanout_telemetry_sink(sinks, sink_count, config->queue_depth, config->lane_cpu_mask);
+    }
+
+    //deallocate the sinks that were created
+    for (i = 0; i < sink_count; i++)
+    {
+        free_telemetry_sink(sinks[i]);
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO CREATE TELEMETRY SINK(S) FROM: %s!\n", config->sinks);
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//get the aws iot connection settings (endpoint, credentials, and topic) from the configuration
+static void get_gateway_settings_from_config(const SAT_CONFIG* config, IOT_DEVICE_GATEWAY_SETTINGS* settings)
+{
+    settings->host = config->aws_host;
+    settings->port = (uint16_t)config->aws_port;
+    settings->client_id = config->aws_client_id;
+    settings->root_ca_file = config->aws_root_ca_file;
+    settings->certificate_file = config->aws_certificate_file;
+    settings->private_key_file = config->aws_private_key_file;
+    settings->topic = config->aws_topic;
+    settings->qos = (config->aws_qos == 1) ? QOS1 : QOS0;
+}
+
+//function definition
+//get the SAT process options from the configuration (its values are validated as it is loaded, the combinations of them here)
+static bool get_sat_options_from_config(const SAT_CONFIG* config, LSM9DS0_SAT_OPTIONS* options)
+{
+    //get the boards (every board gets the same sensor configuration, validated when the board is configured, a bandwidth of 0 is the sensor's default)
+    options->device_id = config->device_id;
+    if (!get_devices_from_config(config, options))
+    {
+        //failure
+        return false;
+    }
+    options->sensor_config.gyro.odr_hz = config->tunables.gyro_odr;
+    options->sensor_config.gyro.bandwidth_hz = config->gyro_bandwidth;
+    options->sensor_config.gyro.fsr = config->gyro_fsr;
+    options->sensor_config.accel.odr_hz = config->tunables.accel_odr;
+    options->sensor_config.accel.bandwidth_hz = config->accel_bandwidth;
+    options->sensor_config.accel.fsr = config->accel_fsr;
+    options->sensor_config.magneto.odr_hz = config->tunables.magneto_odr;
+    options->sensor_config.magneto.bandwidth_hz = 0;
+    options->sensor_config.magneto.fsr = config->magneto_fsr;
+
+    //get the filter stages (validated when the chain is built)
+    options->filter_specification = (config->tunables.filters[0] != '\0') ? config->tunables.filters : NULL;
+
+    //get the kind of window and its sizing
+    options->window_type = NO_WINDOW;
+    if (strcmp(config->window, "tumbling") == 0)
+    {
+        options->window_type = TUMBLING_WINDOW;
+    }
+    else if (strcmp(config->window, "sliding") == 0)
+    {
+        options->window_type = SLIDING_WINDOW;
+    }
+    options->window_length = config->window_length;
+    options->window_hop = config->window_hop;
+
+    //get the orientation rate, and the spectral window sizing (the hop defaults to the length, tumbling windows)
+    options->orientation_interval = config->orientation_interval;
+    options->spectrum_length = config->spectrum_length;
+    options->spectrum_hop = (config->spectrum_hop > 0) ? config->spectrum_hop : config->spectrum_length;
+
+    //determine if readings are published alongside the summaries, orientations, and spectral features, or only around events, and get the detection settings
+    options->publish_readings = config->publish_readings;
+    options->report_by_exception = config->report_by_exception;
+    options->event_detection.accel_threshold_g = (float)config->event_accel_threshold;
+    options->event_detection.gyro_threshold_dps = (float)config->event_gyro_threshold;
+    options->event_detection.accel_delta_g = (float)config->event_accel_delta;
+    options->event_detection.gyro_delta_dps = (float)config->event_gyro_delta;
+    options->event_detection.baseline_length = DEFAULT_EVENT_BASELINE_LENGTH;
+    options->event_detection.zscore_threshold = (float)config->event_zscore;
+    options->event_detection.zscore_length = DEFAULT_EVENT_ZSCORE_LENGTH;
+    options->event_detection.hold_length = config->event_hold;
+    options->event_detection.pre_trigger_length = config->event_pre_trigger;
+
+    //get the calibration file, and the sensors to calibrate
+    options->calibration_file = (strcmp(config->calibration_file, "none") == 0) ? NULL : config->calibration_file;
+    options->calibrate_gyro = (strcmp(config->calibrate, "gyro") == 0) || (strcmp(config->calibrate, "all") == 0);
+    options->calibrate_magneto = (strcmp(config->calibrate, "magneto") == 0) || (strcmp(config->calibrate, "all") == 0);
+
+    //get the tunables the boards start with (a config watcher is added once the options are known to be valid), and where the bus threads run
+    options->tunables = config->tunables;
+    options->config_watcher = NULL;
+    options->bus_cpu_mask = config->bus_cpu_mask;
+
+    //the window must fit in the aggregator
+    if ((options->window_type != NO_WINDOW) && ((options->window_length > WINDOW_AGGREGATOR_MAX_LENGTH) || ((options->window_type == SLIDING_WINDOW) && (options->window_hop > options->window_length))))
+    {
+        fprintf(stderr, "ERROR: WINDOW LENGTH MUST NOT EXCEED %d AND HOP MUST NOT EXCEED THE LENGTH!\n", WINDOW_AGGREGATOR_MAX_LENGTH);
+
+        //failure
+        return false;
+    }
+
+    //the spectral window must be a power of two the analyzer supports
+    if ((options->spectrum_length > 0) &&
+        ((options->spectrum_length < SPECTRAL_ANALYZER_MIN_LENGTH) || (options->spectrum_length > SPECTRAL_ANALYZER_MAX_LENGTH) || ((options->spectrum_length & (options->spectrum_length - 1)) != 0) || (options->spectrum_hop > options->spectrum_length)))
+    {
+        fprintf(stderr, "ERROR: SPECTRUM LENGTH MUST BE A POWER OF TWO FROM %d TO %d AND HOP MUST NOT EXCEED THE LENGTH!\n", SPECTRAL_ANALYZER_MIN_LENGTH, SPECTRAL_ANALYZER_MAX_LENGTH);
+
+        //failure
+        return false;
+    }
+
+    //the pre-trigger history must fit in the event detector
+    if (options->report_by_exception && (options->event_detection.pre_trigger_length >= EVENT_DETECTOR_MAX_HISTORY))
+    {
+        fprintf(stderr, "ERROR: EVENT PRE-TRIGGER LENGTH MUST BE LESS THAN %d!\n", EVENT_DETECTOR_MAX_HISTORY);
+
+        //failure
+        return false;
+    }
+
+    //success
+    return true;
+}
+
+//function definition
+//get the boards from the configuration (the default board when there are none)
+static bool get_devices_from_config(const SAT_CONFIG* config, LSM9DS0_SAT_OPTIONS* options)
+{
+    //local vars
+    const char* device;
+    char* bus_end;
+    long bus;
+    uint32_t i;
+
+    //default board
+    options->devices[0].i2c_bus = LSM9DS0_DEFAULT_I2C_BUS;
+    options->devices[0].gyro_address = LSM9DS0_GYRO_ADDRESS;
+    options->devices[0].accel_magneto_address = LSM9DS0_ACCEL_MAGNETO_ADDRESS;
+    options->device_count = 1;
+    if (config->devices[0] == '\0')
+    {
+        //success
+        return true;
+    }
+
+    //parse each comma separated board
+    options->device_count = 0;
+    device = config->devices;
+    while (*device != '\0')
+    {
+        bus = strtol(device, &bus_end, 10);
+        if ((bus_end == device) || (bus < 0) || (options->device_count == LSM9DS0_SAT_MAX_DEVICES))
+        {
+            fprintf(stderr, "ERROR: INVALID DEVICES (AT MOST %d, AS I2C BUS NUMBERS): %s!\n", LSM9DS0_SAT_MAX_DEVICES, config->devices);
+
+            //failure
+            return false;
+        }
+
+        options->devices[options->device_count].i2c_bus = (int)bus;
+        options->devices[options->device_count].gyro_address = LSM9DS0_GYRO_ADDRESS;
+        options->devices[options->device_count].accel_magneto_address = LSM9DS0_ACCEL_MAGNETO_ADDRESS;
+        if (strncmp(bus_end, ":alt", 4) == 0)
+        {
+            options->devices[options->device_count].gyro_address = LSM9DS0_GYRO_ALTERNATE_ADDRESS;
+            options->devices[options->device_count].accel_magneto_address = LSM9DS0_ACCEL_MAGNETO_ALTERNATE_ADDRESS;
+            bus_end += 4;
+        }
+        if ((*bus_end != ',') && (*bus_end != '\0'))
+        {
+            fprintf(stderr, "ERROR: INVALID DEVICE: %s!\n", device);
+
+            //failure
+            return false;
+        }
+
+        //two boards can't share a bus and addresses
+        for (i = 0; i < options->device_count; i++)
+        {
+            if ((options->devices[i].i2c_bus == options->devices[options->device_count].i2c_bus) && (options->devices[i].gyro_address == options->devices[options->device_count].gyro_address))
+            {
+                fprintf(stderr, "ERROR: DUPLICATE DEVICE: %s!\n", device);
+
+                //failure
+                return false;
+            }
+        }
+        options->device_count++;
+
+        //advance past the board (and the comma)
+        device = (*bus_end == ',') ? (bus_end + 1) : bus_end;
+    }
+
+    //success (when there was at least one board)
+    return (options->device_count > 0);
+}
@@ -0,0 +1,289 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _DEFAULT_SOURCE             //enable BSD/SVID extensions in sys/mman.h so we can use the "MAP_ANONYMOUS" and "MAP_NORESERVE" flags
+
+#include <stdio.h>              //using for "fprintf" function
+#include <stdbool.h>            //using for "bool" type
+#include <string.h>             //using for "memset" function
+#include <sys/mman.h>           //using for "mmap" function
+#include <pthread.h>            //using for the arena lock
+#include "satmemory.h"
+
+/*
+    Every block starts with a header (the class it was carved out for, and who holds it), the caller is handed the
+    memory after it. A freed block keeps its header (and the link to the next free block of its class is kept in it),
+    blocks are never split or merged, so a block is only ever reused by an allocation of the same class.
+*/
+#define SAT_MEMORY_UNIT_SIZE 16                 //bytes per unit (the alignment of every block)
+#define SAT_MEMORY_SUB_CLASS_BITS 3             //8 classes per power of two
+#define SAT_MEMORY_SUB_CLASS_COUNT (1 << SAT_MEMORY_SUB_CLASS_BITS)
+#define SAT_MEMORY_MAX_MAGNITUDE 31             //largest power of two (in units) a class resolves (far more than any arena)
+#define SAT_MEMORY_CLASS_COUNT ((SAT_MEMORY_MAX_MAGNITUDE - SAT_MEMORY_SUB_CLASS_BITS + 2) << SAT_MEMORY_SUB_CLASS_BITS)
+
+//block header representation (one unit)
+typedef struct sat_memory_block
+{
+    struct sat_memory_block* next_free;     //next free block of the class (only while the block is free)
+    uint32_t size_class;                    //class the block was carved out for
+    uint16_t owner;                         //module holding the block
+    uint16_t is_allocated;                  //denotes if the block is held (catches a double free)
+} __attribute__((aligned(SAT_MEMORY_UNIT_SIZE))) SAT_MEMORY_BLOCK;
+
+//global vars
+static pthread_mutex_t arena_lock = PTHREAD_MUTEX_INITIALIZER;    //guards everything below
+static uint8_t* arena;                                              //reserved address space (NULL until the first allocation)
+static bool is_arena_unavailable;                                   //denotes if the address space couldn't be reserved (not tried again)
+static size_t arena_used_bytes;                                     //bytes carved out of the arena so far (the rest has never been touched)
+static SAT_MEMORY_BLOCK* free_blocks[SAT_MEMORY_CLASS_COUNT];       //free list of each class
+static SAT_MEMORY_USAGE usages[SAT_MEMORY_OWNER_COUNT];
+static const char* const OWNER_NAMES[SAT_MEMORY_OWNER_COUNT] =
+{
+    "satconfig", "metricsendpoint", "trace", "lsm9ds0processor", "telemetrysink", "fanoutsink", "filesink", "columnarsink",
+    "iotdevicegateway", "iotdeviceshadow", "eventhub", "messagingclient", "cryptoutil"
+};
+
+//function declarations
+static uint32_t get_sat_memory_class(size_t);
+static size_t get_sat_memory_class_size(uint32_t);
+static SAT_MEMORY_BLOCK* take_sat_memory_block(uint32_t);
+
+//function definition
+//allocate a block (uninitialized) for the supplied module, returns NULL if the arena is full (or the size is larger than it)
+void* allocate_sat_memory(SAT_MEMORY_OWNER owner, size_t size)
+{
+    //local vars
+    SAT_MEMORY_BLOCK* block = NULL;
+    uint32_t size_class = 0;
+    size_t class_size = 0;
+
+    //check input
+    if (owner >= SAT_MEMORY_OWNER_COUNT)
+    {
+        return NULL;
+    }
+
+    //the header plus the size asked for (in units), rounded up to its class (a block larger than the whole arena can't be had)
+    if (size <= SAT_MEMORY_ARENA_SIZE)
+    {
+        size_class = get_sat_memory_class(((size + SAT_MEMORY_UNIT_SIZE - 1) / SAT_MEMORY_UNIT_SIZE) + 1);
+        class_size = get_sat_memory_class_size(size_class);
+    }
+
+    pthread_mutex_lock(&arena_lock);
+
+    if ((class_size > 0) && (class_size <= SAT_MEMORY_ARENA_SIZE))
+    {
+        block = take_sat_memory_block(size_class);
+    }
+
+    if (block != NULL)
+    {
+        block->owner = (uint16_t)owner;
+        block->is_allocated = true;
+        usages[owner].allocated_bytes += class_size;
+        usages[owner].peak_bytes = (usages[owner].allocated_bytes > usages[owner].peak_bytes) ? usages[owner].allocated_bytes : usages[owner].peak_bytes;
+        usages[owner].allocation_count++;
+    }
+    else
+    {
+        usages[owner].failure_count++;
+    }
+
+    pthread_mutex_unlock(&arena_lock);
+
+    //if the arena is full
+    if (block == NULL)
+    {
+        fprintf(stderr, "ERROR: SAT MEMORY ARENA IS FULL, FAILED TO ALLOCATE %zu BYTES FOR %s!\n", size, OWNER_NAMES[owner]);
+        return NULL;
+    }
+
+    //hand over the memory after the header
+    return (block + 1);
+}
+
+//function definition
+//allocate a zeroed block for the supplied module, returns NULL if the arena is full (or the size is larger than it)
+void* allocate_zeroed_sat_memory(SAT_MEMORY_OWNER owner, size_t size)
+{
+    //local vars
+    void* memory;
+
+    memory = allocate_sat_memory(owner, size);
+
+    //a reused block holds whatever its last holder left in it
+    if (memory != NULL)
+    {
+        memset(memory, 0, size);
+    }
+
+    return memory;
+}
+
+//function definition
+//free a block (putting it on its class's free list), NULL is ignored
+void free_sat_memory(void* memory)
+{
+    //local vars
+    SAT_MEMORY_BLOCK* block;
+    bool is_double_free = false;
+
+    //check input
+    if (memory != NULL)
+    {
+        block = ((SAT_MEMORY_BLOCK*)memory) - 1;
+
+        pthread_mutex_lock(&arena_lock);
+
+        if (block->is_allocated)
+        {
+            block->is_allocated = false;
+            usages[block->owner].allocated_bytes -= get_sat_memory_class_size(block->size_class);
+            block->next_free = free_blocks[block->size_class];
+            free_blocks[block->size_class] = block;
+        }
+        else
+        {
+            is_double_free = true;
+        }
+
+        pthread_mutex_unlock(&arena_lock);
+
+        if (is_double_free)
+        {
+            fprintf(stderr, "ERROR: SAT MEMORY BLOCK FREED TWICE!\n");
+        }
+    }
+}
+
+//function definition
+//get the memory usage of the supplied module
+void get_sat_memory_usage(SAT_MEMORY_OWNER owner, SAT_MEMORY_USAGE* usage)
+{
+    //check inputs
+    if ((owner < SAT_MEMORY_OWNER_COUNT) && (usage != NULL))
+    {
+        pthread_mutex_lock(&arena_lock);
+        *usage = usages[owner];
+        pthread_mutex_unlock(&arena_lock);
+    }
+}
+
+//function definition
+//get the bytes carved out of the arena (the most of it that has been backed by RAM)
+size_t get_sat_memory_arena_used_bytes(void)
+{
+    //local vars
+    size_t used_bytes;
+
+    pthread_mutex_lock(&arena_lock);
+    used_bytes = arena_used_bytes;
+    pthread_mutex_unlock(&arena_lock);
+
+    return used_bytes;
+}
+
+//function definition
+//write the memory usage of the arena and of every module that has allocated from it
+void write_sat_memory_report(FILE* file)
+{
+    //local vars
+    SAT_MEMORY_USAGE usage;
+    uint32_t i;
+
+    //check input
+    if (file != NULL)
+    {
+        fprintf(file, "MEMORY: ARENA %zu OF %u BYTES USED\n", get_sat_memory_arena_used_bytes(), (unsigned int)SAT_MEMORY_ARENA_SIZE);
+
+        for (i = 0; i < SAT_MEMORY_OWNER_COUNT; i++)
+        {
+            get_sat_memory_usage((SAT_MEMORY_OWNER)i, &usage);
+            if ((usage.allocation_count > 0) || (usage.failure_count > 0))
+            {
+                fprintf(file, "MEMORY: %s HOLDS %llu BYTES PEAK %llu ALLOCATIONS %llu FAILED %llu\n", OWNER_NAMES[i], (unsigned long long)usage.allocated_bytes,
+                        (unsigned long long)usage.peak_bytes, (unsigned long long)usage.allocation_count, (unsigned long long)usage.failure_count);
+            }
+        }
+    }
+}
+
+//function definition
+//get the class of a block of the supplied number of units (the smallest class its blocks are at least that large)
+static uint32_t get_sat_memory_class(size_t unit_count)
+{
+    //local vars
+    uint64_t value = (uint64_t)unit_count - 1;
+    uint32_t magnitude;
+
+    //a class per unit count below the sub class count
+    if (value < SAT_MEMORY_SUB_CLASS_COUNT)
+    {
+        return (uint32_t)value;
+    }
+
+    //otherwise a class per sub division of the power of two
+    magnitude = 63 - (uint32_t)__builtin_clzll(value);
+
+    return ((magnitude - SAT_MEMORY_SUB_CLASS_BITS + 1) << SAT_MEMORY_SUB_CLASS_BITS) + (uint32_t)((value >> (magnitude - SAT_MEMORY_SUB_CLASS_BITS)) & (SAT_MEMORY_SUB_CLASS_COUNT - 1));
+}
+
+//function definition
+//get the size (in bytes, header included) of the blocks of the supplied class (where the next class starts)
+static size_t get_sat_memory_class_size(uint32_t size_class)
+{
+    //local vars
+    uint32_t next_class = size_class + 1;
+
+    if (next_class < SAT_MEMORY_SUB_CLASS_COUNT)
+    {
+        return (size_t)next_class * SAT_MEMORY_UNIT_SIZE;
+    }
+
+    return ((size_t)(SAT_MEMORY_SUB_CLASS_COUNT + (next_class & (SAT_MEMORY_SUB_CLASS_COUNT - 1))) << ((next_class >> SAT_MEMORY_SUB_CLASS_BITS) - 1)) * SAT_MEMORY_UNIT_SIZE;
+}
+
+//function definition
+//take a block of the supplied class off its free list, or carve a new one out of the arena (reserving it first), with the lock held
+static SAT_MEMORY_BLOCK* take_sat_memory_block(uint32_t size_class)
+{
+    //local vars
+    SAT_MEMORY_BLOCK* block = free_blocks[size_class];
+    size_t class_size = get_sat_memory_class_size(size_class);
+    void* reserved;
+
+    //if a block of the class was freed
+    if (block != NULL)
+    {
+        free_blocks[size_class] = block->next_free;
+        return block;
+    }
+
+    //reserve the arena's address space the first time it is needed (pages are only backed once touched)
+    if ((arena == NULL) && !is_arena_unavailable)
+    {
+        reserved = mmap(NULL, SAT_MEMORY_ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserved != MAP_FAILED)
+        {
+            arena = reserved;
+        }
+        else
+        {
+            is_arena_unavailable = true;
+            fprintf(stderr, "ERROR: FAILED TO RESERVE SAT MEMORY ARENA!\n");
+        }
+    }
+
+    //carve a new block out of the arena (if there is room)
+    if ((arena != NULL) && (class_size <= (SAT_MEMORY_ARENA_SIZE - arena_used_bytes)))
+    {
+        block = (SAT_MEMORY_BLOCK*)&(arena[arena_used_bytes]);
+        block->size_class = size_class;
+        arena_used_bytes += class_size;
+    }
+
+    return block;
+}
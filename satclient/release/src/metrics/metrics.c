@@ -0,0 +1,359 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" function
+
+#include <stdarg.h>             //using for "va_list" type
+#include <stdio.h>              //using for "vsnprintf" function
+#include <string.h>             //using for "memset" function
+#include <time.h>               //using for "clock_gettime" function
+#include "metrics.h"
+
+//global vars
+#define METRICS_SUB_BUCKET_COUNT (1 << METRICS_HISTOGRAM_SUB_BUCKET_BITS)
+#define METRICS_PROMETHEUS_MIN_MAGNITUDE 10     //the exposed histograms' buckets are the powers of two from 2^10 ns (~1 us) up
+
+//per thread metrics (aligned so no two threads' shards share a cache line)
+typedef struct metrics_shard
+{
+    uint64_t counters[METRICS_COUNTER_COUNT];
+    METRICS_HISTOGRAM_DATA histograms[METRICS_HISTOGRAM_COUNT];
+}__attribute__((aligned(64))) METRICS_SHARD;
+
+//gauge (on a cache line of its own)
+typedef struct metrics_gauge_cell
+{
+    int64_t value;
+}__attribute__((aligned(64))) METRICS_GAUGE_CELL;
+
+static METRICS_SHARD shards[METRICS_MAX_THREADS + 1];  //the last is the overflow shard (updated atomically, by every thread past the shard count)
+static uint32_t claimed_shard_count;
+static METRICS_GAUGE_CELL gauges[METRICS_GAUGE_COUNT];
+static __thread METRICS_SHARD* thread_shard;            //shard of the calling thread (claimed on first use)
+
+static const char* const COUNTER_NAMES[METRICS_COUNTER_COUNT] =
+{
+    "satclient_signal_overruns_total",
+    "satclient_i2c_errors_total",
+    "satclient_readings_published_total",
+    "satclient_batches_published_total",
+    "satclient_publish_failures_total",
+    "satclient_batches_dropped_total",
+    "satclient_bytes_sent_total",
+    "satclient_transport_connects_total"
+};
+static const char* const COUNTER_HELP[METRICS_COUNTER_COUNT] =
+{
+    "Readings a sensor overwrote before they were read.",
+    "Failed i2c transactions.",
+    "Readings (json lines) handed to the sink.",
+    "Batches handed to the sink.",
+    "Batches the sink failed to take.",
+    "Batches a fan-out lane dropped because its queue was full.",
+    "Payload bytes sent (or written) by the transports.",
+    "Transport connections made (every one past the first is a reconnect)."
+};
+static const char* const GAUGE_NAMES[METRICS_GAUGE_COUNT] =
+{
+    "satclient_queue_depth"
+};
+static const char* const GAUGE_HELP[METRICS_GAUGE_COUNT] =
+{
+    "Batches queued across the fan-out lanes."
+};
+static const char* const HISTOGRAM_NAMES[METRICS_HISTOGRAM_COUNT] =
+{
+    "satclient_i2c_transaction_seconds",
+    "satclient_sample_age_seconds",
+    "satclient_encode_seconds",
+    "satclient_publish_seconds"
+};
+static const char* const HISTOGRAM_HELP[METRICS_HISTOGRAM_COUNT] =
+{
+    "Duration of an i2c transaction.",
+    "Time from a sample's acquisition to its batch being handed to the sink.",
+    "Time to transform and encode a reading into its batch.",
+    "Time to hand a batch to the sink."
+};
+
+//function declarations
+static METRICS_SHARD* get_thread_shard(void);
+static void add_to_shard_value(const METRICS_SHARD*, uint64_t*, uint64_t);
+static bool append_to_buffer(char*, size_t, size_t*, const char*, ...) __attribute__((format(printf, 4, 5)));
+
+//function definition
+//get the current CLOCK_MONOTONIC time in nanoseconds (the clock every metric is timed with)
+int64_t get_metrics_time_ns(void)
+{
+    //local vars
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+//function definition
+//add to a counter
+void increment_metrics_counter(METRICS_COUNTER counter, uint64_t amount)
+{
+    //local vars
+    METRICS_SHARD* shard = get_thread_shard();
+
+    add_to_shard_value(shard, &(shard->counters[counter]), amount);
+}
+
+//function definition
+//add to (or, with a negative amount, subtract from) a gauge
+void add_to_metrics_gauge(METRICS_GAUGE gauge, int64_t amount)
+{
+    __atomic_fetch_add(&(gauges[gauge].value), amount, __ATOMIC_RELAXED);
+}
+
+//function definition
+//record a value (nanoseconds) in a histogram
+void record_metrics_histogram(METRICS_HISTOGRAM histogram, uint64_t value)
+{
+    //local vars
+    METRICS_SHARD* shard = get_thread_shard();
+    METRICS_HISTOGRAM_DATA* data = &(shard->histograms[histogram]);
+
+    add_to_shard_value(shard, &(data->buckets[get_metrics_histogram_bucket_index(value)]), 1);
+    add_to_shard_value(shard, &(data->count), 1);
+    add_to_shard_value(shard, &(data->sum), value);
+}
+
+//function definition
+//sum every thread's metrics into a snapshot
+void take_metrics_snapshot(METRICS_SNAPSHOT* snapshot)
+{
+    //local vars
+    uint32_t shard_count;
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+
+    //check input
+    if (snapshot == NULL)
+    {
+        return;
+    }
+
+    memset(snapshot, 0, sizeof (METRICS_SNAPSHOT));
+
+    //claimed shards, plus the overflow shard
+    shard_count = __atomic_load_n(&claimed_shard_count, __ATOMIC_ACQUIRE);
+    shard_count = (shard_count > METRICS_MAX_THREADS) ? METRICS_MAX_THREADS : shard_count;
+    for (i = 0; i <= shard_count; i++)
+    {
+        const METRICS_SHARD* shard = &(shards[(i == shard_count) ? METRICS_MAX_THREADS : i]);
+
+        for (j = 0; j < METRICS_COUNTER_COUNT; j++)
+        {
+            snapshot->counters[j] += __atomic_load_n(&(shard->counters[j]), __ATOMIC_RELAXED);
+        }
+        for (j = 0; j < METRICS_HISTOGRAM_COUNT; j++)
+        {
+            for (k = 0; k < METRICS_HISTOGRAM_BUCKET_COUNT; k++)
+            {
+                snapshot->histograms[j].buckets[k] += __atomic_load_n(&(shard->histograms[j].buckets[k]), __ATOMIC_RELAXED);
+            }
+            snapshot->histograms[j].count += __atomic_load_n(&(shard->histograms[j].count), __ATOMIC_RELAXED);
+            snapshot->histograms[j].sum += __atomic_load_n(&(shard->histograms[j].sum), __ATOMIC_RELAXED);
+        }
+    }
+
+    for (i = 0; i < METRICS_GAUGE_COUNT; i++)
+    {
+        snapshot->gauges[i] = __atomic_load_n(&(gauges[i].value), __ATOMIC_RELAXED);
+    }
+}
+
+//function definition
+//estimate a quantile (0 to 1) of a histogram in a snapshot, as the lower bound of the bucket it falls in (0 when the histogram is empty)
+uint64_t get_metrics_snapshot_quantile(const METRICS_SNAPSHOT* snapshot, METRICS_HISTOGRAM histogram, double quantile)
+{
+    //local vars
+    const METRICS_HISTOGRAM_DATA* data;
+    uint64_t rank;
+    uint64_t cumulative_count = 0;
+    uint32_t i;
+
+    //check inputs
+    if ((snapshot == NULL) || (quantile < 0.0) || (quantile > 1.0))
+    {
+        return 0;
+    }
+
+    //the rank of the value (a snapshot taken mid update may have its count and bucket totals off by that update)
+    data = &(snapshot->histograms[histogram]);
+    rank = (uint64_t)(quantile * (double)data->count);
+    if ((rank >= data->count) && (rank > 0))
+    {
+        rank = data->count - 1;
+    }
+    for (i = 0; i < METRICS_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        cumulative_count += data->buckets[i];
+        if ((cumulative_count > rank) && (cumulative_count > 0))
+        {
+            return get_metrics_histogram_bucket_lower_bound(i);
+        }
+    }
+
+    return 0;
+}
+
+//function definition
+//format a snapshot in the prometheus text exposition format (histograms in seconds, with a bucket per power of two), returns false if the buffer is too small
+bool format_metrics_snapshot_as_prometheus(const METRICS_SNAPSHOT* snapshot, char* buffer, size_t buffer_size, size_t* output_size)
+{
+    //local vars
+    const METRICS_HISTOGRAM_DATA* data;
+    uint64_t cumulative_count;
+    uint32_t bucket_index;
+    uint32_t magnitude;
+    uint32_t i;
+    size_t size = 0;
+    bool operation_status = true;
+
+    //check inputs
+    if ((snapshot == NULL) || (buffer == NULL) || (buffer_size == 0) || (output_size == NULL))
+    {
+        return false;
+    }
+
+    for (i = 0; i < METRICS_COUNTER_COUNT; i++)
+    {
+        operation_status &= append_to_buffer(buffer, buffer_size, &size, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", COUNTER_NAMES[i], COUNTER_HELP[i], COUNTER_NAMES[i], COUNTER_NAMES[i], (unsigned long long)snapshot->counters[i]);
+    }
+    for (i = 0; i < METRICS_GAUGE_COUNT; i++)
+    {
+        operation_status &= append_to_buffer(buffer, buffer_size, &size, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n", GAUGE_NAMES[i], GAUGE_HELP[i], GAUGE_NAMES[i], GAUGE_NAMES[i], (long long)snapshot->gauges[i]);
+    }
+    for (i = 0; i < METRICS_HISTOGRAM_COUNT; i++)
+    {
+        data = &(snapshot->histograms[i]);
+        operation_status &= append_to_buffer(buffer, buffer_size, &size, "# HELP %s %s\n# TYPE %s histogram\n", HISTOGRAM_NAMES[i], HISTOGRAM_HELP[i], HISTOGRAM_NAMES[i]);
+
+        //each power of two's bucket counts every fine bucket below it
+        cumulative_count = 0;
+        bucket_index = 0;
+        for (magnitude = METRICS_PROMETHEUS_MIN_MAGNITUDE; magnitude <= METRICS_HISTOGRAM_MAX_MAGNITUDE; magnitude++)
+        {
+            for (; bucket_index < get_metrics_histogram_bucket_index((uint64_t)1 << magnitude); bucket_index++)
+            {
+                cumulative_count += data->buckets[bucket_index];
+            }
+            operation_status &= append_to_buffer(buffer, buffer_size, &size, "%s_bucket{le=\"%.9g\"} %llu\n", HISTOGRAM_NAMES[i], (double)((uint64_t)1 << magnitude) / 1e9, (unsigned long long)cumulative_count);
+        }
+        operation_status &= append_to_buffer(buffer, buffer_size, &size, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n",
+                                             HISTOGRAM_NAMES[i], (unsigned long long)data->count, HISTOGRAM_NAMES[i], (double)data->sum / 1e9, HISTOGRAM_NAMES[i], (unsigned long long)data->count);
+    }
+
+    *output_size = size;
+
+    return operation_status;
+}
+
+//function definition
+//get the histogram bucket a value falls in
+uint32_t get_metrics_histogram_bucket_index(uint64_t value)
+{
+    //local vars
+    uint32_t magnitude;
+
+    //values below the sub bucket count get a bucket each
+    if (value < METRICS_SUB_BUCKET_COUNT)
+    {
+        return (uint32_t)value;
+    }
+
+    //the power of two the value is in (clamped to the largest one resolved), then the sub bucket within it
+    magnitude = 63 - (uint32_t)__builtin_clzll(value);
+    if (magnitude > METRICS_HISTOGRAM_MAX_MAGNITUDE)
+    {
+        return METRICS_HISTOGRAM_BUCKET_COUNT - 1;
+    }
+
+    return ((magnitude - METRICS_HISTOGRAM_SUB_BUCKET_BITS + 1) << METRICS_HISTOGRAM_SUB_BUCKET_BITS) + (uint32_t)((value >> (magnitude - METRICS_HISTOGRAM_SUB_BUCKET_BITS)) & (METRICS_SUB_BUCKET_COUNT - 1));
+}
+
+//function definition
+//get the smallest value a histogram bucket holds
+uint64_t get_metrics_histogram_bucket_lower_bound(uint32_t bucket_index)
+{
+    if (bucket_index < METRICS_SUB_BUCKET_COUNT)
+    {
+        return bucket_index;
+    }
+
+    return (uint64_t)(METRICS_SUB_BUCKET_COUNT + (bucket_index & (METRICS_SUB_BUCKET_COUNT - 1))) << ((bucket_index >> METRICS_HISTOGRAM_SUB_BUCKET_BITS) - 1);
+}
+
+//function definition
+//get the calling thread's shard, claiming one the first time (the overflow shard once they're all claimed)
+static METRICS_SHARD* get_thread_shard(void)
+{
+    //local vars
+    uint32_t shard_index;
+
+    if (thread_shard == NULL)
+    {
+        shard_index = __atomic_fetch_add(&claimed_shard_count, 1, __ATOMIC_ACQ_REL);
+        if (shard_index < METRICS_MAX_THREADS)
+        {
+            thread_shard = &(shards[shard_index]);
+        }
+        else
+        {
+            thread_shard = &(shards[METRICS_MAX_THREADS]);
+        }
+    }
+
+    return thread_shard;
+}
+
+//function definition
+//add to a value in a shard (a plain add when only the calling thread writes the shard, an atomic one for the overflow shard)
+static void add_to_shard_value(const METRICS_SHARD* shard, uint64_t* value, uint64_t amount)
+{
+    if (shard != &(shards[METRICS_MAX_THREADS]))
+    {
+        __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_add(value, amount, __ATOMIC_RELAXED);
+    }
+}
+
+//function definition
+//append formatted text to a buffer, returns false (leaving the buffer null terminated) if it didn't fit
+static bool append_to_buffer(char* buffer, size_t buffer_size, size_t* size, const char* format, ...)
+{
+    //local vars
+    va_list arguments;
+    int appended_size;
+
+    if (*size >= buffer_size)
+    {
+        return false;
+    }
+
+    va_start(arguments, format);
+    appended_size = vsnprintf(&(buffer[*size]), buffer_size - *size, format, arguments);
+    va_end(arguments);
+
+    if ((appended_size < 0) || ((size_t)appended_size >= (buffer_size - *size)))
+    {
+        *size = buffer_size - 1;
+        return false;
+    }
+
+    *size += (size_t)appended_size;
+
+    return true;
+}
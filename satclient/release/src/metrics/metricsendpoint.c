@@ -0,0 +1,285 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "printf", "snprintf", and "fprintf" functions
+#include <stdlib.h>             //using for "NULL"
+#include <stdbool.h>            //using for "bool" type
+#include <string.h>             //using for "memset" function
+#include <errno.h>              //using for "errno" and "EINTR"
+#include <unistd.h>             //using for "read", "write", and "close" functions
+#include <poll.h>               //using for "poll" function
+#include <pthread.h>            //using for the endpoint thread
+#include <sys/socket.h>         //using for "socket", "bind", "listen", and "accept" functions
+#include <netinet/in.h>         //using for "sockaddr_in" type
+#include <arpa/inet.h>          //using for "htons" and "htonl" functions
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "metrics.h"
+#include "metricsendpoint.h"
+
+/*
+    A thread of its own serves the metrics (prometheus text format) to every connection made to a loopback port,
+    and prints a one line summary of them every snapshot interval. It waits on the listening socket with a timeout,
+    so it notices it is stopping (and the summary is due) within a second, and never touches the acquisition threads
+    beyond reading their metrics.
+*/
+#define METRICS_ENDPOINT_POLL_TIMEOUT_MS 1000       //longest the thread waits for a connection before checking if it is stopping
+#define METRICS_ENDPOINT_BUFFER_SIZE 32768          //largest response (the exposition of every metric is ~10KB)
+
+//metrics endpoint state representation
+struct metrics_endpoint
+{
+    pthread_t worker;                       //thread serving the metrics
+    int listen_fd;                          //listening socket (-1 when not serving)
+    uint32_t snapshot_interval_s;           //seconds between printed summaries (0 for none)
+    bool is_stopping;                       //set (atomically) when the endpoint is being freed
+    METRICS_SNAPSHOT snapshot;              //latest snapshot (only touched by the thread while it runs)
+    char response[METRICS_ENDPOINT_BUFFER_SIZE];    //response being sent (only touched by the thread)
+};
+
+//global vars
+static const char RESPONSE_HEADER[] = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n";
+
+//function declarations
+static int open_metrics_listener(uint16_t);
+static void* run_metrics_endpoint_worker(void*);
+static void serve_metrics_connection(METRICS_ENDPOINT*, int);
+static void print_metrics_summary(METRICS_ENDPOINT*);
+static bool write_all_to_socket(int, const char*, size_t);
+
+//function definition
+//create the metrics endpoint, serving the metrics on the supplied loopback port (0 for none) and printing a summary every
+//snapshot interval seconds (0 for none), returns NULL on failure (or when neither is requested)
+METRICS_ENDPOINT* new_metrics_endpoint(uint16_t port, uint32_t snapshot_interval_s)
+{
+    //local vars
+    METRICS_ENDPOINT* endpoint;
+
+    //check inputs
+    if ((port == 0) && (snapshot_interval_s == 0))
+    {
+        return NULL;
+    }
+
+    //allocate endpoint object
+    endpoint = allocate_sat_memory(SAT_MEMORY_METRICS_ENDPOINT, sizeof (METRICS_ENDPOINT));
+
+    //if the object was successfully created
+    if (endpoint != NULL)
+    {
+        endpoint->snapshot_interval_s = snapshot_interval_s;
+        endpoint->is_stopping = false;
+        endpoint->listen_fd = -1;
+
+        //if the port was requested and can't be listened on, carry on with just the summaries
+        if (port != 0)
+        {
+            endpoint->listen_fd = open_metrics_listener(port);
+        }
+
+        //if there is still something to do, start the thread
+        if ((endpoint->listen_fd >= 0) || (snapshot_interval_s > 0))
+        {
+            if (pthread_create(&(endpoint->worker), NULL, run_metrics_endpoint_worker, endpoint) == 0)
+            {
+                return endpoint;
+            }
+
+            fprintf(stderr, "ERROR: FAILED TO START METRICS ENDPOINT THREAD!\n");
+        }
+
+        if (endpoint->listen_fd >= 0)
+        {
+            close(endpoint->listen_fd);
+        }
+        free_sat_memory(endpoint);
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//stop the metrics endpoint (printing a final summary) and deallocate it
+void free_metrics_endpoint(METRICS_ENDPOINT* endpoint)
+{
+    //check input
+    if (endpoint != NULL)
+    {
+        __atomic_store_n(&(endpoint->is_stopping), true, __ATOMIC_RELEASE);
+        pthread_join(endpoint->worker, NULL);
+
+        if (endpoint->snapshot_interval_s > 0)
+        {
+            print_metrics_summary(endpoint);
+        }
+
+        if (endpoint->listen_fd >= 0)
+        {
+            close(endpoint->listen_fd);
+        }
+        free_sat_memory(endpoint);
+    }
+}
+
+//function definition
+//listen on the supplied port of the loopback interface, returns the socket (-1 on failure)
+static int open_metrics_listener(uint16_t port)
+{
+    //local vars
+    int listen_fd;
+    int reuse_address = 1;
+    struct sockaddr_in address;
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    //if the socket was successfully created
+    if (listen_fd >= 0)
+    {
+        memset(&address, 0, sizeof (address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+
+        //allow a restarted process to take the port straight back
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof (reuse_address));
+
+        if ((bind(listen_fd, (struct sockaddr*)&address, sizeof (address)) == 0) && (listen(listen_fd, 4) == 0))
+        {
+            return listen_fd;
+        }
+
+        close(listen_fd);
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO LISTEN FOR METRICS ON PORT: %u!\n", port);
+
+    //failure
+    return -1;
+}
+
+//function definition
+//serve connections and print summaries until the endpoint is stopping
+static void* run_metrics_endpoint_worker(void* parameter)
+{
+    //local vars
+    METRICS_ENDPOINT* endpoint = (METRICS_ENDPOINT*)parameter;
+    struct pollfd listener;
+    int64_t next_summary_time = get_metrics_time_ns() + ((int64_t)endpoint->snapshot_interval_s * 1000000000);
+    int connection_fd;
+
+    listener.fd = endpoint->listen_fd;
+    listener.events = POLLIN;
+
+    while (!__atomic_load_n(&(endpoint->is_stopping), __ATOMIC_ACQUIRE))
+    {
+        //wait for a connection (a negative descriptor is ignored by poll, so with no listener this just sleeps)
+        listener.revents = 0;
+        if ((poll(&listener, 1, METRICS_ENDPOINT_POLL_TIMEOUT_MS) > 0) && ((listener.revents & POLLIN) != 0))
+        {
+            connection_fd = accept(endpoint->listen_fd, NULL, NULL);
+            if (connection_fd >= 0)
+            {
+                serve_metrics_connection(endpoint, connection_fd);
+                close(connection_fd);
+            }
+        }
+
+        //print the summary once it is due
+        if ((endpoint->snapshot_interval_s > 0) && (get_metrics_time_ns() >= next_summary_time))
+        {
+            print_metrics_summary(endpoint);
+            next_summary_time += (int64_t)endpoint->snapshot_interval_s * 1000000000;
+        }
+    }
+
+    return NULL;
+}
+
+//function definition
+//answer a connection with the metrics (whatever was requested, the endpoint only serves one thing)
+static void serve_metrics_connection(METRICS_ENDPOINT* endpoint, int connection_fd)
+{
+    //local vars
+    struct pollfd connection;
+    size_t response_size;
+
+    //consume the request if it has arrived (a scraper sends it straight away, but a slow client mustn't hold up the thread)
+    connection.fd = connection_fd;
+    connection.events = POLLIN;
+    if (poll(&connection, 1, 100) > 0)
+    {
+        if (read(connection_fd, endpoint->response, sizeof (endpoint->response)) < 0)
+        {
+            return;
+        }
+    }
+
+    take_metrics_snapshot(&(endpoint->snapshot));
+    if (!format_metrics_snapshot_as_prometheus(&(endpoint->snapshot), endpoint->response, sizeof (endpoint->response), &response_size))
+    {
+        fprintf(stderr, "ERROR: METRICS DID NOT FIT IN THE RESPONSE!\n");
+    }
+
+    if (write_all_to_socket(connection_fd, RESPONSE_HEADER, sizeof (RESPONSE_HEADER) - 1))
+    {
+        write_all_to_socket(connection_fd, endpoint->response, response_size);
+    }
+}
+
+//function definition
+//print a one line summary of the metrics (latencies are the median and 99th percentile, in milliseconds)
+static void print_metrics_summary(METRICS_ENDPOINT* endpoint)
+{
+    //local vars
+    const METRICS_SNAPSHOT* snapshot = &(endpoint->snapshot);
+
+    take_metrics_snapshot(&(endpoint->snapshot));
+    fprintf(stdout, "METRICS: READINGS %llu BATCHES %llu FAILED %llu DROPPED %llu OVERRUNS %llu I2C ERRORS %llu BYTES %llu CONNECTS %llu QUEUED %lld "
+                    "I2C MS %.3f/%.3f ENCODE MS %.3f/%.3f PUBLISH MS %.3f/%.3f AGE MS %.3f/%.3f\n",
+            (unsigned long long)snapshot->counters[METRICS_READINGS_PUBLISHED],
+            (unsigned long long)snapshot->counters[METRICS_BATCHES_PUBLISHED],
+            (unsigned long long)snapshot->counters[METRICS_PUBLISH_FAILURES],
+            (unsigned long long)snapshot->counters[METRICS_BATCHES_DROPPED],
+            (unsigned long long)snapshot->counters[METRICS_SIGNAL_OVERRUNS],
+            (unsigned long long)snapshot->counters[METRICS_I2C_ERRORS],
+            (unsigned long long)snapshot->counters[METRICS_BYTES_SENT],
+            (unsigned long long)snapshot->counters[METRICS_TRANSPORT_CONNECTS],
+            (long long)snapshot->gauges[METRICS_QUEUE_DEPTH],
+            get_metrics_snapshot_quantile(snapshot, METRICS_I2C_TRANSACTION_NS, 0.5) / 1e6, get_metrics_snapshot_quantile(snapshot, METRICS_I2C_TRANSACTION_NS, 0.99) / 1e6,
+            get_metrics_snapshot_quantile(snapshot, METRICS_ENCODE_NS, 0.5) / 1e6, get_metrics_snapshot_quantile(snapshot, METRICS_ENCODE_NS, 0.99) / 1e6,
+            get_metrics_snapshot_quantile(snapshot, METRICS_PUBLISH_NS, 0.5) / 1e6, get_metrics_snapshot_quantile(snapshot, METRICS_PUBLISH_NS, 0.99) / 1e6,
+            get_metrics_snapshot_quantile(snapshot, METRICS_SAMPLE_AGE_NS, 0.5) / 1e6, get_metrics_snapshot_quantile(snapshot, METRICS_SAMPLE_AGE_NS, 0.99) / 1e6);
+}
+
+//function definition
+//write the whole buffer to a socket (looping over partial writes)
+static bool write_all_to_socket(int fd, const char* buffer, size_t size)
+{
+    //local vars
+    size_t bytes_written = 0;
+    ssize_t result;
+
+    while (bytes_written < size)
+    {
+        result = send(fd, &(buffer[bytes_written]), size - bytes_written, MSG_NOSIGNAL);
+
+        //if the write failed for a reason other than being interrupted
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                //failure
+                return false;
+            }
+        }
+        else
+        {
+            bytes_written += (size_t)result;
+        }
+    }
+
+    //success
+    return true;
+}
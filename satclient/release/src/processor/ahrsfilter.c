@@ -0,0 +1,317 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include <math.h>               //using for "sqrtf", "atan2f", and "asinf" functions
+#include "ahrsfilter.h"
+
+//global vars
+static const float DEGREES_TO_RADIANS = 0.0174532925f;
+static const float RADIANS_TO_DEGREES = 57.2957795f;
+
+//function declarations
+static void fuse_marg_sample(AHRS_FILTER*, float, float, float, float, float, float, float, float, float, float);
+static void fuse_imu_sample(AHRS_FILTER*, float, float, float, float, float, float, float);
+static void integrate_quaternion_rate(AHRS_FILTER*, float*, float);
+
+//function definition
+//init the filter at the identity orientation
+bool init_ahrs_filter(AHRS_FILTER* filter, float beta, float sample_period_s)
+{
+    //check inputs
+    if ((filter != NULL) && (beta >= 0.0f) && (sample_period_s > 0.0f))
+    {
+        filter->quaternion[0] = 1.0f;
+        filter->quaternion[1] = 0.0f;
+        filter->quaternion[2] = 0.0f;
+        filter->quaternion[3] = 0.0f;
+        filter->beta = beta;
+        filter->sample_period_s = sample_period_s;
+        filter->timestamp_ns = 0;
+        filter->update_count = 0;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//fuse a sample (by its index in a batch) into the orientation estimate
+bool update_ahrs_filter(AHRS_FILTER* filter, SAMPLE_BATCH* batch, uint32_t sample_index)
+{
+    //local vars
+    const float* columns[SAMPLE_BATCH_AXIS_COUNT];
+    float values[SAMPLE_BATCH_AXIS_COUNT];
+    int64_t timestamp_ns;
+    float sample_period_s;
+    uint32_t axis;
+
+    //check inputs
+    if ((filter != NULL) && (batch != NULL) && (sample_index < batch->sample_count))
+    {
+        //get the sample's scaled values (g, gauss, dps)
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            columns[axis] = get_scaled_sample_batch_column(batch, axis);
+            values[axis] = columns[axis][sample_index];
+        }
+
+        //use the time since the previous sample, unless there isn't one (or the gap is implausible)
+        timestamp_ns = batch->timestamps_ns[sample_index];
+        sample_period_s = (float)(timestamp_ns - filter->timestamp_ns) / 1e9f;
+        if ((filter->update_count == 0) || (sample_period_s <= 0.0f) || (sample_period_s > AHRS_FILTER_MAX_SAMPLE_PERIOD_S))
+        {
+            sample_period_s = filter->sample_period_s;
+        }
+
+        //fuse the magnetometer too, if it read anything
+        if ((values[SAMPLE_MAGNETO_X] != 0.0f) || (values[SAMPLE_MAGNETO_Y] != 0.0f) || (values[SAMPLE_MAGNETO_Z] != 0.0f))
+        {
+            fuse_marg_sample(filter,
+                             values[SAMPLE_GYRO_X] * DEGREES_TO_RADIANS, values[SAMPLE_GYRO_Y] * DEGREES_TO_RADIANS, values[SAMPLE_GYRO_Z] * DEGREES_TO_RADIANS,
+                             values[SAMPLE_ACCEL_X], values[SAMPLE_ACCEL_Y], values[SAMPLE_ACCEL_Z],
+                             values[SAMPLE_MAGNETO_X], values[SAMPLE_MAGNETO_Y], values[SAMPLE_MAGNETO_Z],
+                             sample_period_s);
+        }
+        else
+        {
+            fuse_imu_sample(filter,
+                            values[SAMPLE_GYRO_X] * DEGREES_TO_RADIANS, values[SAMPLE_GYRO_Y] * DEGREES_TO_RADIANS, values[SAMPLE_GYRO_Z] * DEGREES_TO_RADIANS,
+                            values[SAMPLE_ACCEL_X], values[SAMPLE_ACCEL_Y], values[SAMPLE_ACCEL_Z],
+                            sample_period_s);
+        }
+
+        filter->timestamp_ns = timestamp_ns;
+        filter->update_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get the current orientation estimate, as a quaternion and as euler angles (aerospace sequence - yaw, then pitch, then roll)
+bool get_ahrs_orientation(const AHRS_FILTER* filter, AHRS_ORIENTATION* orientation)
+{
+    //local vars
+    const float* q;
+    float sin_pitch;
+
+    //check inputs
+    if ((filter != NULL) && (orientation != NULL))
+    {
+        q = filter->quaternion;
+
+        orientation->timestamp_ns = filter->timestamp_ns;
+        orientation->quaternion[0] = q[0];
+        orientation->quaternion[1] = q[1];
+        orientation->quaternion[2] = q[2];
+        orientation->quaternion[3] = q[3];
+
+        //clamp so rounding can't push asin out of its domain at +/-90 degrees of pitch
+        sin_pitch = 2.0f * ((q[0] * q[2]) - (q[3] * q[1]));
+        sin_pitch = (sin_pitch > 1.0f) ? 1.0f : ((sin_pitch < -1.0f) ? -1.0f : sin_pitch);
+
+        orientation->roll = atan2f(2.0f * ((q[0] * q[1]) + (q[2] * q[3])), 1.0f - (2.0f * ((q[1] * q[1]) + (q[2] * q[2])))) * RADIANS_TO_DEGREES;
+        orientation->pitch = asinf(sin_pitch) * RADIANS_TO_DEGREES;
+        orientation->yaw = atan2f(2.0f * ((q[0] * q[3]) + (q[1] * q[2])), 1.0f - (2.0f * ((q[2] * q[2]) + (q[3] * q[3])))) * RADIANS_TO_DEGREES;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//fuse gyroscope (rad/s), accelerometer, and magnetometer readings (magnetic, angular rate, and gravity - marg)
+//the correction step is a gradient descent step on the error between the measured and estimated gravity and magnetic field directions
+static void fuse_marg_sample(AHRS_FILTER* filter, float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float sample_period_s)
+{
+    //local vars
+    float q0 = filter->quaternion[0];
+    float q1 = filter->quaternion[1];
+    float q2 = filter->quaternion[2];
+    float q3 = filter->quaternion[3];
+    float rate[4];
+    float s0, s1, s2, s3;
+    float norm;
+    float hx, hy;
+    float _2bx, _2bz, _4bx, _4bz;
+    float _2q0mx, _2q0my, _2q0mz, _2q1mx;
+    float _2q0, _2q1, _2q2, _2q3, _2q0q2, _2q2q3;
+    float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+
+    //without an accelerometer reading there's nothing to correct against
+    if ((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))
+    {
+        fuse_imu_sample(filter, gx, gy, gz, ax, ay, az, sample_period_s);
+        return;
+    }
+
+    //rate of change of the quaternion from the gyroscope
+    rate[0] = 0.5f * ((-q1 * gx) - (q2 * gy) - (q3 * gz));
+    rate[1] = 0.5f * ((q0 * gx) + (q2 * gz) - (q3 * gy));
+    rate[2] = 0.5f * ((q0 * gy) - (q1 * gz) + (q3 * gx));
+    rate[3] = 0.5f * ((q0 * gz) + (q1 * gy) - (q2 * gx));
+
+    //only directions matter, normalize the measurements
+    norm = 1.0f / sqrtf((ax * ax) + (ay * ay) + (az * az));
+    ax *= norm;
+    ay *= norm;
+    az *= norm;
+    norm = 1.0f / sqrtf((mx * mx) + (my * my) + (mz * mz));
+    mx *= norm;
+    my *= norm;
+    mz *= norm;
+
+    //repeated products
+    _2q0mx = 2.0f * q0 * mx;
+    _2q0my = 2.0f * q0 * my;
+    _2q0mz = 2.0f * q0 * mz;
+    _2q1mx = 2.0f * q1 * mx;
+    _2q0 = 2.0f * q0;
+    _2q1 = 2.0f * q1;
+    _2q2 = 2.0f * q2;
+    _2q3 = 2.0f * q3;
+    _2q0q2 = 2.0f * q0 * q2;
+    _2q2q3 = 2.0f * q2 * q3;
+    q0q0 = q0 * q0;
+    q0q1 = q0 * q1;
+    q0q2 = q0 * q2;
+    q0q3 = q0 * q3;
+    q1q1 = q1 * q1;
+    q1q2 = q1 * q2;
+    q1q3 = q1 * q3;
+    q2q2 = q2 * q2;
+    q2q3 = q2 * q3;
+    q3q3 = q3 * q3;
+
+    //direction of the earth's magnetic field in the earth frame (rotated so it has no east component)
+    hx = (mx * q0q0) - (_2q0my * q3) + (_2q0mz * q2) + (mx * q1q1) + (_2q1 * my * q2) + (_2q1 * mz * q3) - (mx * q2q2) - (mx * q3q3);
+    hy = (_2q0mx * q3) + (my * q0q0) - (_2q0mz * q1) + (_2q1mx * q2) - (my * q1q1) + (my * q2q2) + (_2q2 * mz * q3) - (my * q3q3);
+    _2bx = sqrtf((hx * hx) + (hy * hy));
+    _2bz = (-_2q0mx * q2) + (_2q0my * q1) + (mz * q0q0) + (_2q1mx * q3) - (mz * q1q1) + (_2q2 * my * q3) - (mz * q2q2) + (mz * q3q3);
+    _4bx = 2.0f * _2bx;
+    _4bz = 2.0f * _2bz;
+
+    //gradient of the objective function (jacobian transpose times the error)
+    s0 = (-_2q2 * ((2.0f * q1q3) - _2q0q2 - ax)) + (_2q1 * ((2.0f * q0q1) + _2q2q3 - ay)) - (_2bz * q2 * ((_2bx * (0.5f - q2q2 - q3q3)) + (_2bz * (q1q3 - q0q2)) - mx)) +
+         (((-_2bx * q3) + (_2bz * q1)) * ((_2bx * (q1q2 - q0q3)) + (_2bz * (q0q1 + q2q3)) - my)) + (_2bx * q2 * ((_2bx * (q0q2 + q1q3)) + (_2bz * (0.5f - q1q1 - q2q2)) - mz));
+    s1 = (_2q3 * ((2.0f * q1q3) - _2q0q2 - ax)) + (_2q0 * ((2.0f * q0q1) + _2q2q3 - ay)) - (4.0f * q1 * (1.0f - (2.0f * q1q1) - (2.0f * q2q2) - az)) +
+         (_2bz * q3 * ((_2bx * (0.5f - q2q2 - q3q3)) + (_2bz * (q1q3 - q0q2)) - mx)) + (((_2bx * q2) + (_2bz * q0)) * ((_2bx * (q1q2 - q0q3)) + (_2bz * (q0q1 + q2q3)) - my)) +
+         (((_2bx * q3) - (_4bz * q1)) * ((_2bx * (q0q2 + q1q3)) + (_2bz * (0.5f - q1q1 - q2q2)) - mz));
+    s2 = (-_2q0 * ((2.0f * q1q3) - _2q0q2 - ax)) + (_2q3 * ((2.0f * q0q1) + _2q2q3 - ay)) - (4.0f * q2 * (1.0f - (2.0f * q1q1) - (2.0f * q2q2) - az)) +
+         (((-_4bx * q2) - (_2bz * q0)) * ((_2bx * (0.5f - q2q2 - q3q3)) + (_2bz * (q1q3 - q0q2)) - mx)) + (((_2bx * q1) + (_2bz * q3)) * ((_2bx * (q1q2 - q0q3)) + (_2bz * (q0q1 + q2q3)) - my)) +
+         (((_2bx * q0) - (_4bz * q2)) * ((_2bx * (q0q2 + q1q3)) + (_2bz * (0.5f - q1q1 - q2q2)) - mz));
+    s3 = (_2q1 * ((2.0f * q1q3) - _2q0q2 - ax)) + (_2q2 * ((2.0f * q0q1) + _2q2q3 - ay)) + (((-_4bx * q3) + (_2bz * q1)) * ((_2bx * (0.5f - q2q2 - q3q3)) + (_2bz * (q1q3 - q0q2)) - mx)) +
+         (((-_2bx * q0) + (_2bz * q2)) * ((_2bx * (q1q2 - q0q3)) + (_2bz * (q0q1 + q2q3)) - my)) + (_2bx * q1 * ((_2bx * (q0q2 + q1q3)) + (_2bz * (0.5f - q1q1 - q2q2)) - mz));
+
+    //step against the (normalized) gradient, unless the estimate is already exact
+    norm = sqrtf((s0 * s0) + (s1 * s1) + (s2 * s2) + (s3 * s3));
+    if (norm > 0.0f)
+    {
+        norm = filter->beta / norm;
+        rate[0] -= norm * s0;
+        rate[1] -= norm * s1;
+        rate[2] -= norm * s2;
+        rate[3] -= norm * s3;
+    }
+
+    integrate_quaternion_rate(filter, rate, sample_period_s);
+}
+
+//function definition
+//fuse gyroscope (rad/s) and accelerometer readings (no heading correction)
+static void fuse_imu_sample(AHRS_FILTER* filter, float gx, float gy, float gz, float ax, float ay, float az, float sample_period_s)
+{
+    //local vars
+    float q0 = filter->quaternion[0];
+    float q1 = filter->quaternion[1];
+    float q2 = filter->quaternion[2];
+    float q3 = filter->quaternion[3];
+    float rate[4];
+    float s0, s1, s2, s3;
+    float norm;
+    float _2q0, _2q1, _2q2, _2q3, _4q0, _4q1, _4q2, _8q1, _8q2;
+    float q0q0, q1q1, q2q2, q3q3;
+
+    //rate of change of the quaternion from the gyroscope
+    rate[0] = 0.5f * ((-q1 * gx) - (q2 * gy) - (q3 * gz));
+    rate[1] = 0.5f * ((q0 * gx) + (q2 * gz) - (q3 * gy));
+    rate[2] = 0.5f * ((q0 * gy) - (q1 * gz) + (q3 * gx));
+    rate[3] = 0.5f * ((q0 * gz) + (q1 * gy) - (q2 * gx));
+
+    //correct against gravity if the accelerometer read anything
+    if ((ax != 0.0f) || (ay != 0.0f) || (az != 0.0f))
+    {
+        norm = 1.0f / sqrtf((ax * ax) + (ay * ay) + (az * az));
+        ax *= norm;
+        ay *= norm;
+        az *= norm;
+
+        //repeated products
+        _2q0 = 2.0f * q0;
+        _2q1 = 2.0f * q1;
+        _2q2 = 2.0f * q2;
+        _2q3 = 2.0f * q3;
+        _4q0 = 4.0f * q0;
+        _4q1 = 4.0f * q1;
+        _4q2 = 4.0f * q2;
+        _8q1 = 8.0f * q1;
+        _8q2 = 8.0f * q2;
+        q0q0 = q0 * q0;
+        q1q1 = q1 * q1;
+        q2q2 = q2 * q2;
+        q3q3 = q3 * q3;
+
+        //gradient of the objective function (jacobian transpose times the error)
+        s0 = (_4q0 * q2q2) + (_2q2 * ax) + (_4q0 * q1q1) - (_2q1 * ay);
+        s1 = (_4q1 * q3q3) - (_2q3 * ax) + (4.0f * q0q0 * q1) - (_2q0 * ay) - _4q1 + (_8q1 * q1q1) + (_8q1 * q2q2) + (_4q1 * az);
+        s2 = (4.0f * q0q0 * q2) + (_2q0 * ax) + (_4q2 * q3q3) - (_2q3 * ay) - _4q2 + (_8q2 * q1q1) + (_8q2 * q2q2) + (_4q2 * az);
+        s3 = (4.0f * q1q1 * q3) - (_2q1 * ax) + (4.0f * q2q2 * q3) - (_2q2 * ay);
+
+        //step against the (normalized) gradient, unless the estimate is already exact
+        norm = sqrtf((s0 * s0) + (s1 * s1) + (s2 * s2) + (s3 * s3));
+        if (norm > 0.0f)
+        {
+            norm = filter->beta / norm;
+            rate[0] -= norm * s0;
+            rate[1] -= norm * s1;
+            rate[2] -= norm * s2;
+            rate[3] -= norm * s3;
+        }
+    }
+
+    integrate_quaternion_rate(filter, rate, sample_period_s);
+}
+
+//function definition
+//advance the quaternion by its rate of change over a sample period, keeping it unit length
+static void integrate_quaternion_rate(AHRS_FILTER* filter, float* rate, float sample_period_s)
+{
+    //local vars
+    float* q = filter->quaternion;
+    float norm;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        q[i] += rate[i] * sample_period_s;
+    }
+
+    norm = 1.0f / sqrtf((q[0] * q[0]) + (q[1] * q[1]) + (q[2] * q[2]) + (q[3] * q[3]));
+    for (i = 0; i < 4; i++)
+    {
+        q[i] *= norm;
+    }
+}
@@ -0,0 +1,306 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include <math.h>               //using for "sqrtf" and "fabsf" functions
+#include "eventdetector.h"
+
+//global vars
+//smallest standard deviation the z-score detector divides by, per signal (roughly the sensor noise at rest, so a
+//perfectly still window doesn't turn every lsb of noise into an event)
+static const float ZSCORE_MIN_DEVIATIONS[EVENT_SIGNAL_COUNT] = {0.002f, 0.2f, 0.2f, 0.2f};
+
+//function declarations
+static uint8_t run_event_detectors(EVENT_DETECTOR*, const float*);
+static void add_sample_to_event_detector_history(EVENT_DETECTOR*, SAMPLE_BATCH*, uint32_t);
+
+//function definition
+//init the detector (no event in progress, empty history)
+bool init_event_detector(EVENT_DETECTOR* detector, const EVENT_DETECTOR_OPTIONS* options)
+{
+    //check inputs
+    if ((detector != NULL) && (options != NULL) &&
+        (options->accel_threshold_g >= 0.0f) && (options->gyro_threshold_dps >= 0.0f) &&
+        (options->accel_delta_g >= 0.0f) && (options->gyro_delta_dps >= 0.0f) && (options->baseline_length > 0) &&
+        (options->zscore_threshold >= 0.0f) && (options->zscore_length > 1) && (options->zscore_length <= EVENT_DETECTOR_MAX_ZSCORE_LENGTH) &&
+        (options->pre_trigger_length < EVENT_DETECTOR_MAX_HISTORY))
+    {
+        detector->options = *options;
+        detector->zscore_position = 0;
+        detector->zscore_count = 0;
+        detector->update_count = 0;
+        detector->event_active = false;
+        detector->detections = 0;
+        detector->event_detections = 0;
+        detector->samples_since_detection = 0;
+        detector->event_sample_count = 0;
+        detector->event_start_timestamp_ns = 0;
+        detector->event_count = 0;
+        detector->history_position = 0;
+        detector->history_count = 0;
+        detector->heartbeat_timestamp_ns = 0;
+        detector->heartbeat_sample_count = 0;
+        detector->heartbeat_accel_magnitude_sum = 0.0;
+        detector->heartbeat_accel_magnitude_max = 0.0f;
+        detector->heartbeat_gyro_magnitude_max = 0.0f;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//run a sample (by its index in a batch) through the detectors, along with any hardware detections since the previous sample (HARDWARE_EVENT_DETECTOR or 0),
+//rendering whether it started or ended an event
+bool update_event_detector(EVENT_DETECTOR* detector, SAMPLE_BATCH* batch, uint32_t sample_index, uint8_t hardware_detections, EVENT_TRANSITION* transition)
+{
+    //local vars
+    const float* columns[SAMPLE_BATCH_AXIS_COUNT];
+    float signals[EVENT_SIGNAL_COUNT];
+    float gyro_magnitude;
+    uint32_t axis;
+
+    //check inputs
+    if ((detector != NULL) && (batch != NULL) && (sample_index < batch->sample_count) && (transition != NULL))
+    {
+        //get the sample's scaled values (g, gauss, dps)
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            columns[axis] = get_scaled_sample_batch_column(batch, axis);
+        }
+
+        signals[EVENT_ACCEL_MAGNITUDE] = sqrtf((columns[SAMPLE_ACCEL_X][sample_index] * columns[SAMPLE_ACCEL_X][sample_index]) +
+                                               (columns[SAMPLE_ACCEL_Y][sample_index] * columns[SAMPLE_ACCEL_Y][sample_index]) +
+                                               (columns[SAMPLE_ACCEL_Z][sample_index] * columns[SAMPLE_ACCEL_Z][sample_index]));
+        signals[EVENT_GYRO_X] = columns[SAMPLE_GYRO_X][sample_index];
+        signals[EVENT_GYRO_Y] = columns[SAMPLE_GYRO_Y][sample_index];
+        signals[EVENT_GYRO_Z] = columns[SAMPLE_GYRO_Z][sample_index];
+
+        detector->detections = run_event_detectors(detector, signals) | (hardware_detections & HARDWARE_EVENT_DETECTOR);
+        detector->update_count++;
+
+        //update the event state
+        *transition = NO_EVENT_TRANSITION;
+        if (detector->detections != 0)
+        {
+            detector->samples_since_detection = 0;
+
+            //start an event (the history now leads up to this sample)
+            if (!detector->event_active)
+            {
+                detector->event_active = true;
+                detector->event_detections = 0;
+                detector->event_sample_count = 0;
+                detector->event_start_timestamp_ns = batch->timestamps_ns[sample_index];
+                detector->event_count++;
+                add_sample_to_event_detector_history(detector, batch, sample_index);
+                *transition = EVENT_STARTED;
+            }
+
+            detector->event_detections |= detector->detections;
+        }
+        else if (detector->event_active)
+        {
+            //end the event once it has been quiet for the hold length (the history refills from here)
+            detector->samples_since_detection++;
+            if (detector->samples_since_detection >= detector->options.hold_length)
+            {
+                detector->event_active = false;
+                detector->history_position = 0;
+                detector->history_count = 0;
+                *transition = EVENT_ENDED;
+            }
+        }
+        else
+        {
+            //keep the sample in case an event follows
+            add_sample_to_event_detector_history(detector, batch, sample_index);
+        }
+
+        //the sample that ends an event is the last one in it
+        if (detector->event_active || (*transition == EVENT_ENDED))
+        {
+            detector->event_sample_count++;
+        }
+
+        //accumulate the heartbeat
+        gyro_magnitude = sqrtf((signals[EVENT_GYRO_X] * signals[EVENT_GYRO_X]) + (signals[EVENT_GYRO_Y] * signals[EVENT_GYRO_Y]) + (signals[EVENT_GYRO_Z] * signals[EVENT_GYRO_Z]));
+        detector->heartbeat_timestamp_ns = batch->timestamps_ns[sample_index];
+        detector->heartbeat_accel_magnitude_sum += signals[EVENT_ACCEL_MAGNITUDE];
+        detector->heartbeat_accel_magnitude_max = ((detector->heartbeat_sample_count == 0) || (signals[EVENT_ACCEL_MAGNITUDE] > detector->heartbeat_accel_magnitude_max)) ? signals[EVENT_ACCEL_MAGNITUDE] : detector->heartbeat_accel_magnitude_max;
+        detector->heartbeat_gyro_magnitude_max = ((detector->heartbeat_sample_count == 0) || (gyro_magnitude > detector->heartbeat_gyro_magnitude_max)) ? gyro_magnitude : detector->heartbeat_gyro_magnitude_max;
+        detector->heartbeat_sample_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//move (up to max_count of) the oldest samples in the history onto the end of a batch (as many as fit), returns the number moved
+uint32_t move_event_detector_history_to_sample_batch(EVENT_DETECTOR* detector, SAMPLE_BATCH* batch, uint32_t max_count)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t moved_count = 0;
+    uint32_t axis;
+
+    //check inputs
+    if ((detector != NULL) && (batch != NULL))
+    {
+        while ((moved_count < max_count) && (detector->history_count > 0) && (batch->sample_count < SAMPLE_BATCH_MAX_SAMPLES))
+        {
+            for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+            {
+                values[axis] = detector->history[axis][detector->history_position];
+            }
+            append_sample_to_sample_batch(batch, detector->history_timestamps_ns[detector->history_position], values);
+
+            detector->history_position = (detector->history_position + 1) % EVENT_DETECTOR_MAX_HISTORY;
+            detector->history_count--;
+            moved_count++;
+        }
+    }
+
+    return moved_count;
+}
+
+//function definition
+//get the summary of the samples since the last heartbeat (starting the next one)
+bool get_event_heartbeat(EVENT_DETECTOR* detector, EVENT_HEARTBEAT* heartbeat)
+{
+    //check inputs
+    if ((detector != NULL) && (heartbeat != NULL))
+    {
+        heartbeat->timestamp_ns = detector->heartbeat_timestamp_ns;
+        heartbeat->sample_count = detector->heartbeat_sample_count;
+        heartbeat->event_count = detector->event_count;
+        heartbeat->event_active = detector->event_active;
+        heartbeat->accel_magnitude_mean = (detector->heartbeat_sample_count > 0) ? (float)(detector->heartbeat_accel_magnitude_sum / detector->heartbeat_sample_count) : 0.0f;
+        heartbeat->accel_magnitude_max = detector->heartbeat_accel_magnitude_max;
+        heartbeat->gyro_magnitude_max = detector->heartbeat_gyro_magnitude_max;
+
+        //start the next heartbeat
+        detector->heartbeat_sample_count = 0;
+        detector->heartbeat_accel_magnitude_sum = 0.0;
+        detector->heartbeat_accel_magnitude_max = 0.0f;
+        detector->heartbeat_gyro_magnitude_max = 0.0f;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//run the software detectors on a sample's signals (updating their baselines and windows), returns the detectors that fired
+static uint8_t run_event_detectors(EVENT_DETECTOR* detector, const float* signals)
+{
+    //local vars
+    const EVENT_DETECTOR_OPTIONS* options = &(detector->options);
+    uint8_t detections = 0;
+    float delta;
+    float mean;
+    float variance;
+    float deviation;
+    uint32_t signal;
+
+    //threshold - the accelerometer magnitude against gravity, the gyroscope rates against zero
+    if ((options->accel_threshold_g > 0.0f) && (fabsf(signals[EVENT_ACCEL_MAGNITUDE] - 1.0f) > options->accel_threshold_g))
+    {
+        detections |= THRESHOLD_EVENT_DETECTOR;
+    }
+    for (signal = EVENT_GYRO_X; (options->gyro_threshold_dps > 0.0f) && (signal <= EVENT_GYRO_Z); signal++)
+    {
+        if (fabsf(signals[signal]) > options->gyro_threshold_dps)
+        {
+            detections |= THRESHOLD_EVENT_DETECTOR;
+        }
+    }
+
+    for (signal = 0; signal < EVENT_SIGNAL_COUNT; signal++)
+    {
+        //baseline - starts at the first sample, then follows the signal slowly
+        delta = (signal == EVENT_ACCEL_MAGNITUDE) ? options->accel_delta_g : options->gyro_delta_dps;
+        if (detector->update_count == 0)
+        {
+            detector->baselines[signal] = signals[signal];
+        }
+        else if ((delta > 0.0f) && (fabsf(signals[signal] - detector->baselines[signal]) > delta))
+        {
+            detections |= BASELINE_EVENT_DETECTOR;
+        }
+        detector->baselines[signal] += (signals[signal] - detector->baselines[signal]) / (float)options->baseline_length;
+
+        //z-score - against the window before the sample is added (so a spike can't dampen itself)
+        if ((options->zscore_threshold > 0.0f) && (detector->zscore_count == options->zscore_length))
+        {
+            mean = (float)(detector->zscore_sums[signal] / detector->zscore_count);
+            variance = (float)((detector->zscore_sums_of_squares[signal] / detector->zscore_count) - ((double)mean * mean));
+            deviation = (variance > (ZSCORE_MIN_DEVIATIONS[signal] * ZSCORE_MIN_DEVIATIONS[signal])) ? sqrtf(variance) : ZSCORE_MIN_DEVIATIONS[signal];
+            if ((fabsf(signals[signal] - mean) / deviation) > options->zscore_threshold)
+            {
+                detections |= ZSCORE_EVENT_DETECTOR;
+            }
+        }
+    }
+
+    //slide the z-score window (the oldest value drops out once it is full)
+    for (signal = 0; signal < EVENT_SIGNAL_COUNT; signal++)
+    {
+        if (detector->zscore_count == options->zscore_length)
+        {
+            detector->zscore_sums[signal] -= detector->zscore_window[signal][detector->zscore_position];
+            detector->zscore_sums_of_squares[signal] -= (double)detector->zscore_window[signal][detector->zscore_position] * detector->zscore_window[signal][detector->zscore_position];
+        }
+        else if (detector->zscore_count == 0)
+        {
+            detector->zscore_sums[signal] = 0.0;
+            detector->zscore_sums_of_squares[signal] = 0.0;
+        }
+
+        detector->zscore_window[signal][detector->zscore_position] = signals[signal];
+        detector->zscore_sums[signal] += signals[signal];
+        detector->zscore_sums_of_squares[signal] += (double)signals[signal] * signals[signal];
+    }
+    detector->zscore_position = (detector->zscore_position + 1) % options->zscore_length;
+    if (detector->zscore_count < options->zscore_length)
+    {
+        detector->zscore_count++;
+    }
+
+    return detections;
+}
+
+//function definition
+//keep a sample (by its index in a batch) in the history, dropping the oldest once it holds the pre-trigger length (+1, the sample that starts an event)
+static void add_sample_to_event_detector_history(EVENT_DETECTOR* detector, SAMPLE_BATCH* batch, uint32_t sample_index)
+{
+    //local vars
+    uint32_t position;
+    uint32_t axis;
+
+    if (detector->history_count == (detector->options.pre_trigger_length + 1))
+    {
+        detector->history_position = (detector->history_position + 1) % EVENT_DETECTOR_MAX_HISTORY;
+        detector->history_count--;
+    }
+
+    position = (detector->history_position + detector->history_count) % EVENT_DETECTOR_MAX_HISTORY;
+    detector->history_timestamps_ns[position] = batch->timestamps_ns[sample_index];
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        detector->history[axis][position] = batch->raw[axis][sample_index];
+    }
+    detector->history_count++;
+}
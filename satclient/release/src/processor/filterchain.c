@@ -0,0 +1,514 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "fprintf" function and "NULL" macro
+#include <stdlib.h>             //using for "strtof" and "strtoul" functions
+#include <string.h>             //using for "strcspn" and "strncmp" functions
+#include <math.h>               //using for "sinf", "cosf", "tanf", "sqrtf", and "lrintf" functions
+#include "filterchain.h"
+
+//the fir dot product has a vectorized kernel where the instruction set is always available (sse2 on x86-64, neon on aarch64)
+#if defined(__SSE2__)
+    #define SSE2_DOT_PRODUCT_KERNEL
+    #include <emmintrin.h>      //using for sse2 intrinsics
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define NEON_DOT_PRODUCT_KERNEL
+    #include <arm_neon.h>       //using for neon intrinsics
+#endif
+
+//global vars
+static const float PI = 3.14159265f;
+static const float BUTTERWORTH_Q = 0.70710678f;     //maximally flat passband
+static const float FIR_CUTOFF_RATIO = 0.8f;         //fir decimator cutoff, as a fraction of the decimated nyquist frequency
+
+//function declarations
+static void run_biquad_stage(FILTER_STAGE*, float (*)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t);
+static uint32_t run_average_decimator_stage(FILTER_STAGE*, float (*)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t*, uint32_t);
+static uint32_t run_fir_decimator_stage(FILTER_STAGE*, float (*)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t*, uint32_t);
+static uint32_t compact_decimated_indices(uint32_t, uint32_t, uint32_t*, uint32_t);
+static float compute_dot_product(const float*, const float*, uint32_t);
+static int16_t saturate_to_raw_value(float);
+
+//function definition
+//init an empty chain (passes samples through until stages are added)
+bool init_filter_chain(FILTER_CHAIN* chain, float input_rate_hz)
+{
+    //check inputs
+    if ((chain != NULL) && (input_rate_hz > 0.0f))
+    {
+        chain->input_rate_hz = input_rate_hz;
+        chain->output_rate_hz = input_rate_hz;
+        chain->stage_count = 0;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add a 2nd order butterworth low-pass or high-pass stage (the cutoff must be below the nyquist frequency at this point in the chain)
+bool add_biquad_filter_stage(FILTER_CHAIN* chain, FILTER_STAGE_TYPE type, float cutoff_hz)
+{
+    //local vars
+    FILTER_STAGE* stage;
+    float omega;
+    float alpha;
+    float cos_omega;
+    float a0;
+
+    //check inputs
+    if ((chain != NULL) && (chain->stage_count < FILTER_CHAIN_MAX_STAGES) && ((type == LOWPASS_FILTER_STAGE) || (type == HIGHPASS_FILTER_STAGE)))
+    {
+        if ((cutoff_hz <= 0.0f) || (cutoff_hz >= (chain->output_rate_hz / 2.0f)))
+        {
+            fprintf(stderr, "ERROR: FILTER CUTOFF MUST BE BETWEEN 0 AND %f HZ!\n", chain->output_rate_hz / 2.0f);
+
+            //failure
+            return false;
+        }
+
+        stage = &(chain->stages[chain->stage_count]);
+        stage->type = type;
+        stage->decimation_factor = 1;
+        stage->phase = 0;
+        stage->primed = false;
+
+        //bilinear transform coefficients (robert bristow-johnson's audio eq cookbook), normalized by a0
+        omega = 2.0f * PI * (cutoff_hz / chain->output_rate_hz);
+        cos_omega = cosf(omega);
+        alpha = sinf(omega) / (2.0f * BUTTERWORTH_Q);
+        a0 = 1.0f + alpha;
+        if (type == LOWPASS_FILTER_STAGE)
+        {
+            stage->coefficients[0] = ((1.0f - cos_omega) / 2.0f) / a0;
+            stage->coefficients[1] = (1.0f - cos_omega) / a0;
+        }
+        else
+        {
+            stage->coefficients[0] = ((1.0f + cos_omega) / 2.0f) / a0;
+            stage->coefficients[1] = -(1.0f + cos_omega) / a0;
+        }
+        stage->coefficients[2] = stage->coefficients[0];
+        stage->coefficients[3] = (-2.0f * cos_omega) / a0;
+        stage->coefficients[4] = (1.0f - alpha) / a0;
+
+        chain->stage_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add a moving average or fir decimator stage
+bool add_decimator_filter_stage(FILTER_CHAIN* chain, FILTER_STAGE_TYPE type, uint32_t decimation_factor)
+{
+    //local vars
+    FILTER_STAGE* stage;
+    float cutoff;
+    float center;
+    float offset;
+    float sum = 0.0f;
+    uint32_t i;
+
+    //check inputs
+    if ((chain != NULL) && (chain->stage_count < FILTER_CHAIN_MAX_STAGES) && ((type == AVERAGE_DECIMATOR_FILTER_STAGE) || (type == FIR_DECIMATOR_FILTER_STAGE)))
+    {
+        if ((decimation_factor < 2) || (decimation_factor > FILTER_STAGE_MAX_DECIMATION))
+        {
+            fprintf(stderr, "ERROR: DECIMATION FACTOR MUST BE BETWEEN 2 AND %d!\n", FILTER_STAGE_MAX_DECIMATION);
+
+            //failure
+            return false;
+        }
+
+        stage = &(chain->stages[chain->stage_count]);
+        stage->type = type;
+        stage->decimation_factor = decimation_factor;
+        stage->phase = 0;
+        stage->primed = false;
+
+        if (type == FIR_DECIMATOR_FILTER_STAGE)
+        {
+            //hamming windowed sinc, cutoff (in cycles per input sample) just under the decimated nyquist frequency
+            stage->tap_count = (8 * decimation_factor) + 1;
+            stage->history_position = 0;
+            cutoff = (FIR_CUTOFF_RATIO * 0.5f) / (float)decimation_factor;
+            center = (float)(stage->tap_count - 1) / 2.0f;
+            for (i = 0; i < stage->tap_count; i++)
+            {
+                offset = (float)i - center;
+                stage->taps[i] = (offset == 0.0f) ? (2.0f * cutoff) : (sinf(2.0f * PI * cutoff * offset) / (PI * offset));
+                stage->taps[i] *= 0.54f - (0.46f * cosf((2.0f * PI * (float)i) / (float)(stage->tap_count - 1)));
+                sum += stage->taps[i];
+            }
+
+            //unity gain at dc
+            for (i = 0; i < stage->tap_count; i++)
+            {
+                stage->taps[i] /= sum;
+            }
+        }
+
+        chain->output_rate_hz /= (float)decimation_factor;
+        chain->stage_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add the stages described by a comma separated list of "name:value" entries - lowpass:<hz>, highpass:<hz>, average:<factor>, fir:<factor>
+bool add_filter_stages_from_specification(FILTER_CHAIN* chain, const char* specification)
+{
+    //local vars
+    const char* entry;
+    size_t entry_size;
+    size_t name_size;
+    bool operation_status;
+
+    //check inputs
+    if ((chain != NULL) && (specification != NULL))
+    {
+        for (entry = specification; *entry != '\0'; entry += entry_size + ((entry[entry_size] == ',') ? 1 : 0))
+        {
+            entry_size = strcspn(entry, ",");
+            name_size = strcspn(entry, ":,");
+
+            //every entry has a value
+            if (entry[name_size] != ':')
+            {
+                operation_status = false;
+            }
+            else if ((name_size == 7) && (strncmp(entry, "lowpass", name_size) == 0))
+            {
+                operation_status = add_biquad_filter_stage(chain, LOWPASS_FILTER_STAGE, strtof(&(entry[name_size + 1]), NULL));
+            }
+            else if ((name_size == 8) && (strncmp(entry, "highpass", name_size) == 0))
+            {
+                operation_status = add_biquad_filter_stage(chain, HIGHPASS_FILTER_STAGE, strtof(&(entry[name_size + 1]), NULL));
+            }
+            else if ((name_size == 7) && (strncmp(entry, "average", name_size) == 0))
+            {
+                operation_status = add_decimator_filter_stage(chain, AVERAGE_DECIMATOR_FILTER_STAGE, (uint32_t)strtoul(&(entry[name_size + 1]), NULL, 10));
+            }
+            else if ((name_size == 3) && (strncmp(entry, "fir", name_size) == 0))
+            {
+                operation_status = add_decimator_filter_stage(chain, FIR_DECIMATOR_FILTER_STAGE, (uint32_t)strtoul(&(entry[name_size + 1]), NULL, 10));
+            }
+            else
+            {
+                operation_status = false;
+            }
+
+            if (!operation_status)
+            {
+                fprintf(stderr, "ERROR: INVALID FILTER STAGE: %.*s!\n", (int)entry_size, entry);
+
+                //failure
+                return false;
+            }
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//filter a batch of samples, appending the chain's outputs (if any) onto the output batch
+//(the output batch must have room for as many samples as the input batch holds)
+bool run_filter_chain(FILTER_CHAIN* chain, const SAMPLE_BATCH* input, SAMPLE_BATCH* output)
+{
+    //local vars
+    float work[SAMPLE_BATCH_AXIS_COUNT][SAMPLE_BATCH_MAX_SAMPLES];     //per axis, the samples between stages
+    uint32_t indices[SAMPLE_BATCH_MAX_SAMPLES];                         //input sample each of the samples between stages was completed by
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t count;
+    uint32_t axis;
+    uint32_t i;
+
+    //check inputs
+    if ((chain != NULL) && (input != NULL) && (output != NULL) && ((output->sample_count + input->sample_count) <= SAMPLE_BATCH_MAX_SAMPLES))
+    {
+        count = input->sample_count;
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            for (i = 0; i < count; i++)
+            {
+                work[axis][i] = input->raw[axis][i];
+            }
+        }
+        for (i = 0; i < count; i++)
+        {
+            indices[i] = i;
+        }
+
+        //run each stage over every axis
+        for (i = 0; (i < chain->stage_count) && (count > 0); i++)
+        {
+            switch (chain->stages[i].type)
+            {
+                case LOWPASS_FILTER_STAGE:
+                case HIGHPASS_FILTER_STAGE:
+                    run_biquad_stage(&(chain->stages[i]), work, count);
+                    break;
+                case AVERAGE_DECIMATOR_FILTER_STAGE:
+                    count = run_average_decimator_stage(&(chain->stages[i]), work, indices, count);
+                    break;
+                case FIR_DECIMATOR_FILTER_STAGE:
+                    count = run_fir_decimator_stage(&(chain->stages[i]), work, indices, count);
+                    break;
+            }
+        }
+
+        //append the outputs
+        for (i = 0; i < count; i++)
+        {
+            for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+            {
+                values[axis] = saturate_to_raw_value(work[axis][i]);
+            }
+
+            append_sample_to_sample_batch(output, input->timestamps_ns[indices[i]], values);
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//filter each axis in place (transposed direct form II, primed so a constant input is already at steady state)
+static void run_biquad_stage(FILTER_STAGE* stage, float (*work)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t count)
+{
+    //local vars
+    const float b0 = stage->coefficients[0];
+    const float b1 = stage->coefficients[1];
+    const float b2 = stage->coefficients[2];
+    const float a1 = stage->coefficients[3];
+    const float a2 = stage->coefficients[4];
+    const float dc_gain = (b0 + b1 + b2) / (1.0f + a1 + a2);
+    float z1;
+    float z2;
+    float x;
+    float y;
+    uint32_t axis;
+    uint32_t i;
+
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        //steady state for the first input
+        if (!stage->primed)
+        {
+            x = work[axis][0];
+            y = dc_gain * x;
+            stage->state[axis][1] = (b2 * x) - (a2 * y);
+            stage->state[axis][0] = (b1 * x) - (a1 * y) + stage->state[axis][1];
+        }
+
+        z1 = stage->state[axis][0];
+        z2 = stage->state[axis][1];
+        for (i = 0; i < count; i++)
+        {
+            x = work[axis][i];
+            y = (b0 * x) + z1;
+            z1 = (b1 * x) - (a1 * y) + z2;
+            z2 = (b2 * x) - (a2 * y);
+            work[axis][i] = y;
+        }
+        stage->state[axis][0] = z1;
+        stage->state[axis][1] = z2;
+    }
+
+    stage->primed = true;
+}
+
+//function definition
+//average every decimation factor inputs of each axis into one output (in place), returns the number of outputs
+static uint32_t run_average_decimator_stage(FILTER_STAGE* stage, float (*work)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t* indices, uint32_t count)
+{
+    //local vars
+    const float scale = 1.0f / (float)stage->decimation_factor;
+    uint32_t phase;
+    uint32_t output_count = 0;
+    float sum;
+    uint32_t axis;
+    uint32_t i;
+
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        phase = stage->phase;
+        sum = (phase == 0) ? 0.0f : stage->state[axis][0];
+        output_count = 0;
+
+        for (i = 0; i < count; i++)
+        {
+            sum += work[axis][i];
+            if (++phase == stage->decimation_factor)
+            {
+                work[axis][output_count++] = sum * scale;
+                sum = 0.0f;
+                phase = 0;
+            }
+        }
+
+        stage->state[axis][0] = sum;
+    }
+
+    stage->phase = compact_decimated_indices(stage->phase, stage->decimation_factor, indices, count);
+
+    return output_count;
+}
+
+//function definition
+//low-pass filter and decimate each axis (in place), returns the number of outputs
+static uint32_t run_fir_decimator_stage(FILTER_STAGE* stage, float (*work)[SAMPLE_BATCH_MAX_SAMPLES], uint32_t* indices, uint32_t count)
+{
+    //local vars
+    const uint32_t tap_count = stage->tap_count;
+    float* history;
+    uint32_t position;
+    uint32_t phase;
+    uint32_t output_count = 0;
+    uint32_t axis;
+    uint32_t i;
+
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        history = stage->history[axis];
+
+        //start with the history full of the first input (a constant input is already at steady state)
+        if (!stage->primed)
+        {
+            for (i = 0; i < (2 * tap_count); i++)
+            {
+                history[i] = work[axis][0];
+            }
+        }
+
+        position = stage->history_position;
+        phase = stage->phase;
+        output_count = 0;
+
+        for (i = 0; i < count; i++)
+        {
+            //replace the oldest input, the window [position, position + tap_count) then runs oldest to newest
+            history[position] = work[axis][i];
+            history[position + tap_count] = work[axis][i];
+            position = (position + 1) % tap_count;
+
+            //only the kept outputs are computed
+            if (++phase == stage->decimation_factor)
+            {
+                work[axis][output_count++] = compute_dot_product(&(history[position]), stage->taps, tap_count);
+                phase = 0;
+            }
+        }
+    }
+
+    stage->primed = true;
+    stage->history_position = (stage->history_position + count) % tap_count;
+    stage->phase = compact_decimated_indices(stage->phase, stage->decimation_factor, indices, count);
+
+    return output_count;
+}
+
+//function definition
+//keep the indices of the inputs that completed an output (the same for every axis), returns the decimator's new phase
+static uint32_t compact_decimated_indices(uint32_t phase, uint32_t decimation_factor, uint32_t* indices, uint32_t count)
+{
+    //local vars
+    uint32_t output_count = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (++phase == decimation_factor)
+        {
+            indices[output_count++] = indices[i];
+            phase = 0;
+        }
+    }
+
+    return phase;
+}
+
+//function definition
+//sum of the products of two float arrays (the taps are symmetric, so the order they're applied in doesn't matter)
+static float compute_dot_product(const float* a, const float* b, uint32_t count)
+{
+    //local vars
+    uint32_t i = 0;
+    float sum;
+#if defined(SSE2_DOT_PRODUCT_KERNEL)
+    __m128 vector_sum = _mm_setzero_ps();
+    float lanes[4];
+
+    //4 products at a time
+    for (; (i + 4) <= count; i += 4)
+    {
+        vector_sum = _mm_add_ps(vector_sum, _mm_mul_ps(_mm_loadu_ps(&(a[i])), _mm_loadu_ps(&(b[i]))));
+    }
+    _mm_storeu_ps(lanes, vector_sum);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(NEON_DOT_PRODUCT_KERNEL)
+    float32x4_t vector_sum = vdupq_n_f32(0.0f);
+    float32x2_t pair_sum;
+
+    //4 products at a time
+    for (; (i + 4) <= count; i += 4)
+    {
+        vector_sum = vmlaq_f32(vector_sum, vld1q_f32(&(a[i])), vld1q_f32(&(b[i])));
+    }
+    pair_sum = vadd_f32(vget_low_f32(vector_sum), vget_high_f32(vector_sum));
+    sum = vget_lane_f32(vpadd_f32(pair_sum, pair_sum), 0);
+#else
+    sum = 0.0f;
+#endif
+
+    //remaining products
+    for (; i < count; i++)
+    {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+//function definition
+//round a filtered value back to a raw value, saturating at the int16 limits
+static int16_t saturate_to_raw_value(float value)
+{
+    //local vars
+    long rounded_value = lrintf(value);
+
+    if (rounded_value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (rounded_value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t)rounded_value;
+}
@@ -0,0 +1,627 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "fopen", "fprintf", and "fscanf" functions
+#include <math.h>               //using for "sqrt", "fabs", "pow", and "lround" functions
+#include "imucalibration.h"
+
+//global vars
+static const uint32_t JACOBI_MAX_SWEEPS = 50;       //sweeps of the eigen decomposition before giving up on convergence
+static const double FIT_PIVOT_TOLERANCE = 1e-12;    //smallest pivot (relative to the largest) the fit's equations are solved with
+
+//function declarations
+static bool solve_linear_system(double (*)[MAGNETO_ELLIPSOID_FIT_TERM_COUNT + 1], uint32_t, double*);
+static bool invert_symmetric_matrix(const double (*)[3], double (*)[3]);
+static void decompose_symmetric_matrix(const double (*)[3], double*, double (*)[3]);
+
+//function definition
+//init the calibration to no correction (zero bias, zero offsets, identity matrix)
+void init_imu_calibration(IMU_CALIBRATION* calibration)
+{
+    //local vars
+    uint32_t row;
+    uint32_t column;
+
+    //check input
+    if (calibration != NULL)
+    {
+        for (row = 0; row < 3; row++)
+        {
+            calibration->gyro_bias[row] = 0.0f;
+            calibration->magneto_offsets[row] = 0;
+            for (column = 0; column < 3; column++)
+            {
+                calibration->magneto_matrix[row][column] = (row == column) ? 1.0f : 0.0f;
+            }
+        }
+    }
+}
+
+//function definition
+//load a calibration from the supplied file location (the calibration is left untouched unless the whole file is read)
+bool load_imu_calibration(IMU_CALIBRATION* calibration, const char* file_location)
+{
+    //local vars
+    bool operation_status = false;                  //denotes success or failure of the operation
+    FILE* file_handle;                              //file containing the calibration
+    IMU_CALIBRATION loaded_calibration;
+    unsigned int version;
+    int offsets[3];
+    uint32_t i;
+
+    //check inputs
+    if ((calibration != NULL) && (file_location != NULL))
+    {
+        //open file
+        file_handle = fopen(file_location, "r");
+
+        //if the file stream was opened successfully
+        if (file_handle != NULL)
+        {
+            //if every value was read, in a version of the format we understand, with offsets the sensor can hold
+            if ((fscanf(file_handle, " version %u", &version) == 1) && (version == IMU_CALIBRATION_FILE_VERSION) &&
+                (fscanf(file_handle, " gyro_bias %f %f %f", &(loaded_calibration.gyro_bias[0]), &(loaded_calibration.gyro_bias[1]), &(loaded_calibration.gyro_bias[2])) == 3) &&
+                (fscanf(file_handle, " magneto_offsets %d %d %d", &(offsets[0]), &(offsets[1]), &(offsets[2])) == 3) &&
+                (fscanf(file_handle, " magneto_matrix %f %f %f %f %f %f %f %f %f",
+                        &(loaded_calibration.magneto_matrix[0][0]), &(loaded_calibration.magneto_matrix[0][1]), &(loaded_calibration.magneto_matrix[0][2]),
+                        &(loaded_calibration.magneto_matrix[1][0]), &(loaded_calibration.magneto_matrix[1][1]), &(loaded_calibration.magneto_matrix[1][2]),
+                        &(loaded_calibration.magneto_matrix[2][0]), &(loaded_calibration.magneto_matrix[2][1]), &(loaded_calibration.magneto_matrix[2][2])) == 9) &&
+                (offsets[0] >= INT16_MIN) && (offsets[0] <= INT16_MAX) && (offsets[1] >= INT16_MIN) && (offsets[1] <= INT16_MAX) &&
+                (offsets[2] >= INT16_MIN) && (offsets[2] <= INT16_MAX))
+            {
+                for (i = 0; i < 3; i++)
+                {
+                    loaded_calibration.magneto_offsets[i] = (int16_t)offsets[i];
+                }
+                *calibration = loaded_calibration;
+
+                //success
+                operation_status = true;
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: FAILED TO LOAD IMU CALIBRATION FILE: %s\n", file_location);
+            }
+
+            //close file handle
+            fclose(file_handle);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO OPEN IMU CALIBRATION FILE: %s\n", file_location);
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//save a calibration to the supplied file location (one line per part, so it can be read or edited by hand)
+bool save_imu_calibration(const IMU_CALIBRATION* calibration, const char* file_location)
+{
+    //local vars
+    bool operation_status = false;                  //denotes success or failure of the operation
+    FILE* file_handle;                              //file containing the calibration
+    const float (*matrix)[3];
+
+    //check inputs
+    if ((calibration != NULL) && (file_location != NULL))
+    {
+        //open file
+        file_handle = fopen(file_location, "w");
+
+        //if the file stream was opened successfully
+        if (file_handle != NULL)
+        {
+            matrix = calibration->magneto_matrix;
+
+            //write each part (floats with enough digits to be read back exactly)
+            operation_status = (fprintf(file_handle, "version %u\n", IMU_CALIBRATION_FILE_VERSION) > 0) &&
+                               (fprintf(file_handle, "gyro_bias %.9g %.9g %.9g\n", calibration->gyro_bias[0], calibration->gyro_bias[1], calibration->gyro_bias[2]) > 0) &&
+                               (fprintf(file_handle, "magneto_offsets %d %d %d\n", calibration->magneto_offsets[0], calibration->magneto_offsets[1], calibration->magneto_offsets[2]) > 0) &&
+                               (fprintf(file_handle, "magneto_matrix %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n",
+                                        matrix[0][0], matrix[0][1], matrix[0][2], matrix[1][0], matrix[1][1], matrix[1][2], matrix[2][0], matrix[2][1], matrix[2][2]) > 0);
+
+            //close file handle (which flushes what was written)
+            operation_status &= (fclose(file_handle) == 0);
+
+            if (!operation_status)
+            {
+                fprintf(stderr, "ERROR: FAILED TO SAVE IMU CALIBRATION FILE: %s\n", file_location);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO OPEN IMU CALIBRATION FILE: %s\n", file_location);
+        }
+    }
+
+    return operation_status;
+}
+
+//function definition
+//set a batch to apply the calibration's software corrections as it scales (gyro bias, magnetometer soft iron matrix),
+//the hard iron offsets are applied by the sensor itself so they're not part of the batch's correction
+bool apply_imu_calibration_to_sample_batch(const IMU_CALIBRATION* calibration, SAMPLE_BATCH* batch)
+{
+    //local vars
+    float gyro_offsets[3];
+    bool gyro_corrected = false;
+    bool magneto_corrected = false;
+    uint32_t row;
+    uint32_t column;
+
+    //check inputs
+    if ((calibration != NULL) && (batch != NULL))
+    {
+        //only correct a sensor that has a correction, so an uncalibrated sensor keeps the plain (single multiply) scaling
+        for (row = 0; row < 3; row++)
+        {
+            gyro_offsets[row] = -calibration->gyro_bias[row];
+            gyro_corrected |= (calibration->gyro_bias[row] != 0.0f);
+            for (column = 0; column < 3; column++)
+            {
+                magneto_corrected |= (calibration->magneto_matrix[row][column] != ((row == column) ? 1.0f : 0.0f));
+            }
+        }
+
+        return set_sample_batch_correction(batch, SAMPLE_GYRO_X, NULL, (gyro_corrected ? gyro_offsets : NULL)) &&
+               set_sample_batch_correction(batch, SAMPLE_MAGNETO_X, (magneto_corrected ? calibration->magneto_matrix : NULL), NULL);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//init the estimator (no samples)
+void init_gyro_bias_estimator(GYRO_BIAS_ESTIMATOR* estimator)
+{
+    //local vars
+    uint32_t axis;
+
+    //check input
+    if (estimator != NULL)
+    {
+        estimator->sample_count = 0;
+        for (axis = 0; axis < 3; axis++)
+        {
+            estimator->sums[axis] = 0.0;
+            estimator->square_sums[axis] = 0.0;
+        }
+    }
+}
+
+//function definition
+//add a sample's (by its index in a batch) raw gyro rates to the estimator
+bool add_sample_to_gyro_bias_estimator(GYRO_BIAS_ESTIMATOR* estimator, const SAMPLE_BATCH* batch, uint32_t sample_index)
+{
+    //local vars
+    double value;
+    uint32_t axis;
+
+    //check inputs
+    if ((estimator != NULL) && (batch != NULL) && (sample_index < batch->sample_count))
+    {
+        for (axis = 0; axis < 3; axis++)
+        {
+            value = (double)batch->raw[SAMPLE_GYRO_X + axis][sample_index];
+            estimator->sums[axis] += value;
+            estimator->square_sums[axis] += value * value;
+        }
+        estimator->sample_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//compute the gyro bias (the mean rate) into the calibration if the board was at rest, meaning no axis' rate had a standard deviation
+//over the max (in dps, given the gyro's scale factor) - the calibration is left untouched if it wasn't
+bool compute_gyro_bias(const GYRO_BIAS_ESTIMATOR* estimator, double scale_factor, double max_deviation_dps, IMU_CALIBRATION* calibration, bool* at_rest)
+{
+    //local vars
+    double means[3];
+    double variance;
+    uint32_t axis;
+
+    //check inputs
+    if ((estimator != NULL) && (estimator->sample_count > 1) && (scale_factor > 0.0) && (max_deviation_dps > 0.0) && (calibration != NULL) && (at_rest != NULL))
+    {
+        *at_rest = true;
+        for (axis = 0; axis < 3; axis++)
+        {
+            means[axis] = estimator->sums[axis] / estimator->sample_count;
+            variance = (estimator->square_sums[axis] / estimator->sample_count) - (means[axis] * means[axis]);
+            *at_rest &= ((sqrt((variance > 0.0) ? variance : 0.0) * scale_factor) <= max_deviation_dps);
+        }
+
+        if (*at_rest)
+        {
+            for (axis = 0; axis < 3; axis++)
+            {
+                calibration->gyro_bias[axis] = (float)means[axis];
+            }
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//init the fit (no samples)
+void init_magneto_ellipsoid_fit(MAGNETO_ELLIPSOID_FIT* fit)
+{
+    //local vars
+    uint32_t row;
+    uint32_t column;
+
+    //check input
+    if (fit != NULL)
+    {
+        fit->sample_count = 0;
+        fit->scale_factor = 0.0;
+        for (row = 0; row < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; row++)
+        {
+            for (column = 0; column < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; column++)
+            {
+                fit->normal_matrix[row][column] = 0.0;
+            }
+            fit->normal_vector[row] = 0.0;
+        }
+    }
+}
+
+//function definition
+//add a sample's (by its index in a batch) magnetometer reading to the fit's normal equations
+//(in gauss rather than raw units, so the squared and linear terms are of similar size and the equations are well conditioned)
+bool add_sample_to_magneto_ellipsoid_fit(MAGNETO_ELLIPSOID_FIT* fit, const SAMPLE_BATCH* batch, uint32_t sample_index)
+{
+    //local vars
+    double terms[MAGNETO_ELLIPSOID_FIT_TERM_COUNT];
+    double x;
+    double y;
+    double z;
+    uint32_t row;
+    uint32_t column;
+
+    //check inputs
+    if ((fit != NULL) && (batch != NULL) && (sample_index < batch->sample_count) && (batch->scale_factors[SAMPLE_MAGNETO_X] > 0.0))
+    {
+        fit->scale_factor = batch->scale_factors[SAMPLE_MAGNETO_X];
+        x = batch->raw[SAMPLE_MAGNETO_X][sample_index] * fit->scale_factor;
+        y = batch->raw[SAMPLE_MAGNETO_Y][sample_index] * fit->scale_factor;
+        z = batch->raw[SAMPLE_MAGNETO_Z][sample_index] * fit->scale_factor;
+
+        terms[0] = x * x;
+        terms[1] = y * y;
+        terms[2] = z * z;
+        terms[3] = 2.0 * x * y;
+        terms[4] = 2.0 * x * z;
+        terms[5] = 2.0 * y * z;
+        terms[6] = 2.0 * x;
+        terms[7] = 2.0 * y;
+        terms[8] = 2.0 * z;
+
+        for (row = 0; row < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; row++)
+        {
+            for (column = 0; column < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; column++)
+            {
+                fit->normal_matrix[row][column] += terms[row] * terms[column];
+            }
+            fit->normal_vector[row] += terms[row];
+        }
+        fit->sample_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//compute the hard iron offsets and soft iron matrix from the fit into the calibration, failing (calibration untouched) if the readings don't describe an ellipsoid
+//(e.g. too few samples, or the board wasn't rotated through enough orientations) - the fit's center is added to the calibration's offsets,
+//as the sensor had already subtracted them from the readings that were fit
+bool compute_magneto_ellipsoid_fit(const MAGNETO_ELLIPSOID_FIT* fit, IMU_CALIBRATION* calibration)
+{
+    //local vars
+    double system[MAGNETO_ELLIPSOID_FIT_TERM_COUNT][MAGNETO_ELLIPSOID_FIT_TERM_COUNT + 1];
+    double parameters[MAGNETO_ELLIPSOID_FIT_TERM_COUNT];
+    double quadric[3][3];
+    double inverse[3][3];
+    double center[3];
+    double eigenvalues[3];
+    double eigenvectors[3][3];
+    double radius_squared = 1.0;
+    double radius;
+    double offsets[3];
+    double element;
+    uint32_t row;
+    uint32_t column;
+    uint32_t i;
+
+    //check inputs
+    if ((fit == NULL) || (calibration == NULL) || (fit->sample_count < MAGNETO_ELLIPSOID_FIT_MIN_SAMPLES))
+    {
+        return false;
+    }
+
+    //solve the normal equations for the quadric x'Ax + 2b'x = 1 (a, b, c, d, e, f are A's unique elements, g, h, i are b)
+    for (row = 0; row < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; row++)
+    {
+        for (column = 0; column < MAGNETO_ELLIPSOID_FIT_TERM_COUNT; column++)
+        {
+            system[row][column] = fit->normal_matrix[row][column];
+        }
+        system[row][MAGNETO_ELLIPSOID_FIT_TERM_COUNT] = fit->normal_vector[row];
+    }
+    if (!solve_linear_system(system, MAGNETO_ELLIPSOID_FIT_TERM_COUNT, parameters))
+    {
+        return false;
+    }
+    quadric[0][0] = parameters[0];
+    quadric[1][1] = parameters[1];
+    quadric[2][2] = parameters[2];
+    quadric[0][1] = quadric[1][0] = parameters[3];
+    quadric[0][2] = quadric[2][0] = parameters[4];
+    quadric[1][2] = quadric[2][1] = parameters[5];
+
+    //the center is -A^-1 b, around which the quadric is (x - c)'A(x - c) = 1 + c'Ac
+    if (!invert_symmetric_matrix(quadric, inverse))
+    {
+        return false;
+    }
+    for (row = 0; row < 3; row++)
+    {
+        center[row] = -((inverse[row][0] * parameters[6]) + (inverse[row][1] * parameters[7]) + (inverse[row][2] * parameters[8]));
+    }
+    for (row = 0; row < 3; row++)
+    {
+        for (column = 0; column < 3; column++)
+        {
+            radius_squared += center[row] * quadric[row][column] * center[column];
+        }
+    }
+    if (radius_squared <= 0.0)
+    {
+        return false;
+    }
+    for (row = 0; row < 3; row++)
+    {
+        for (column = 0; column < 3; column++)
+        {
+            quadric[row][column] /= radius_squared;
+        }
+    }
+
+    //the readings lie on an ellipsoid only if A is positive definite, its eigenvalues are 1 / the squared lengths of its axes
+    decompose_symmetric_matrix(quadric, eigenvalues, eigenvectors);
+    if ((eigenvalues[0] <= 0.0) || (eigenvalues[1] <= 0.0) || (eigenvalues[2] <= 0.0))
+    {
+        return false;
+    }
+
+    //the offsets (in raw units, added to those already applied) must fit the sensor's registers
+    for (row = 0; row < 3; row++)
+    {
+        offsets[row] = calibration->magneto_offsets[row] + (double)lround(center[row] / fit->scale_factor);
+        if ((offsets[row] < INT16_MIN) || (offsets[row] > INT16_MAX))
+        {
+            return false;
+        }
+    }
+
+    //the soft iron matrix is A^1/2 (mapping the centered ellipsoid onto the unit sphere) scaled by the ellipsoid's
+    //mean radius (the geometric mean of its axes), so the corrected field keeps its magnitude
+    radius = pow(eigenvalues[0] * eigenvalues[1] * eigenvalues[2], -1.0 / 6.0);
+    for (row = 0; row < 3; row++)
+    {
+        for (column = 0; column < 3; column++)
+        {
+            element = 0.0;
+            for (i = 0; i < 3; i++)
+            {
+                element += eigenvectors[row][i] * sqrt(eigenvalues[i]) * eigenvectors[column][i];
+            }
+            calibration->magneto_matrix[row][column] = (float)(radius * element);
+        }
+        calibration->magneto_offsets[row] = (int16_t)offsets[row];
+    }
+
+    //success
+    return true;
+}
+
+//function definition
+//solve an augmented system (n equations, the right hand side in column n) by gaussian elimination with partial pivoting, in place
+static bool solve_linear_system(double (*system)[MAGNETO_ELLIPSOID_FIT_TERM_COUNT + 1], uint32_t n, double* solution)
+{
+    //local vars
+    double largest_pivot = 0.0;
+    double factor;
+    double swap;
+    uint32_t pivot_row;
+    uint32_t row;
+    uint32_t column;
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        //pivot on the largest remaining value in the column
+        pivot_row = i;
+        for (row = i + 1; row < n; row++)
+        {
+            if (fabs(system[row][i]) > fabs(system[pivot_row][i]))
+            {
+                pivot_row = row;
+            }
+        }
+        if (fabs(system[pivot_row][i]) > largest_pivot)
+        {
+            largest_pivot = fabs(system[pivot_row][i]);
+        }
+        if ((largest_pivot == 0.0) || (fabs(system[pivot_row][i]) <= (largest_pivot * FIT_PIVOT_TOLERANCE)))
+        {
+            //singular (or nearly so)
+            return false;
+        }
+        for (column = i; column <= n; column++)
+        {
+            swap = system[i][column];
+            system[i][column] = system[pivot_row][column];
+            system[pivot_row][column] = swap;
+        }
+
+        //eliminate the column below the pivot
+        for (row = i + 1; row < n; row++)
+        {
+            factor = system[row][i] / system[i][i];
+            for (column = i; column <= n; column++)
+            {
+                system[row][column] -= factor * system[i][column];
+            }
+        }
+    }
+
+    //back substitute
+    for (row = n; row-- > 0;)
+    {
+        solution[row] = system[row][n];
+        for (column = row + 1; column < n; column++)
+        {
+            solution[row] -= system[row][column] * solution[column];
+        }
+        solution[row] /= system[row][row];
+    }
+
+    return true;
+}
+
+//function definition
+//invert a symmetric 3x3 matrix (by its adjugate), failing if it's singular
+static bool invert_symmetric_matrix(const double (*matrix)[3], double (*inverse)[3])
+{
+    //local vars
+    double determinant;
+    uint32_t row;
+    uint32_t column;
+
+    inverse[0][0] = (matrix[1][1] * matrix[2][2]) - (matrix[1][2] * matrix[2][1]);
+    inverse[0][1] = (matrix[0][2] * matrix[2][1]) - (matrix[0][1] * matrix[2][2]);
+    inverse[0][2] = (matrix[0][1] * matrix[1][2]) - (matrix[0][2] * matrix[1][1]);
+    inverse[1][1] = (matrix[0][0] * matrix[2][2]) - (matrix[0][2] * matrix[2][0]);
+    inverse[1][2] = (matrix[0][2] * matrix[1][0]) - (matrix[0][0] * matrix[1][2]);
+    inverse[2][2] = (matrix[0][0] * matrix[1][1]) - (matrix[0][1] * matrix[1][0]);
+    inverse[1][0] = inverse[0][1];
+    inverse[2][0] = inverse[0][2];
+    inverse[2][1] = inverse[1][2];
+
+    determinant = (matrix[0][0] * inverse[0][0]) + (matrix[0][1] * inverse[1][0]) + (matrix[0][2] * inverse[2][0]);
+    if (determinant == 0.0)
+    {
+        return false;
+    }
+
+    for (row = 0; row < 3; row++)
+    {
+        for (column = 0; column < 3; column++)
+        {
+            inverse[row][column] /= determinant;
+        }
+    }
+
+    return true;
+}
+
+//function definition
+//decompose a symmetric 3x3 matrix into its eigenvalues and eigenvectors (the columns) by jacobi rotations
+static void decompose_symmetric_matrix(const double (*matrix)[3], double* eigenvalues, double (*eigenvectors)[3])
+{
+    //local vars
+    double work[3][3];
+    double theta;
+    double t;
+    double c;
+    double s;
+    double p_value;
+    double q_value;
+    uint32_t sweep;
+    uint32_t p;
+    uint32_t q;
+    uint32_t k;
+
+    for (p = 0; p < 3; p++)
+    {
+        for (q = 0; q < 3; q++)
+        {
+            work[p][q] = matrix[p][q];
+            eigenvectors[p][q] = (p == q) ? 1.0 : 0.0;
+        }
+    }
+
+    for (sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++)
+    {
+        //converged once the off diagonal elements are negligible next to the diagonal ones
+        if ((fabs(work[0][1]) + fabs(work[0][2]) + fabs(work[1][2])) <= (1e-15 * (fabs(work[0][0]) + fabs(work[1][1]) + fabs(work[2][2]))))
+        {
+            break;
+        }
+
+        for (p = 0; p < 2; p++)
+        {
+            for (q = p + 1; q < 3; q++)
+            {
+                if (work[p][q] == 0.0)
+                {
+                    continue;
+                }
+
+                //the rotation that zeroes the (p, q) element
+                theta = (work[q][q] - work[p][p]) / (2.0 * work[p][q]);
+                t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt((theta * theta) + 1.0));
+                c = 1.0 / sqrt((t * t) + 1.0);
+                s = t * c;
+
+                for (k = 0; k < 3; k++)
+                {
+                    p_value = work[k][p];
+                    q_value = work[k][q];
+                    work[k][p] = (c * p_value) - (s * q_value);
+                    work[k][q] = (s * p_value) + (c * q_value);
+                }
+                for (k = 0; k < 3; k++)
+                {
+                    p_value = work[p][k];
+                    q_value = work[q][k];
+                    work[p][k] = (c * p_value) - (s * q_value);
+                    work[q][k] = (s * p_value) + (c * q_value);
+                }
+                for (k = 0; k < 3; k++)
+                {
+                    p_value = eigenvectors[k][p];
+                    q_value = eigenvectors[k][q];
+                    eigenvectors[k][p] = (c * p_value) - (s * q_value);
+                    eigenvectors[k][q] = (s * p_value) + (c * q_value);
+                }
+            }
+        }
+    }
+
+    for (p = 0; p < 3; p++)
+    {
+        eigenvalues[p] = work[p][p];
+    }
+}
@@ -3,119 +3,768 @@
    Repo: https://github.com/embeddedcognition/satclient
 */
 
-#include <stdio.h>              //used for "printf/sprintf" functions and "NULL" macro
-#include <stdint.h>             //using for "uint8_t" type
-#include <time.h>               //using for "time" function
+#include <stdio.h>              //used for "printf/snprintf" functions and "NULL" macro
+#include <stdint.h>             //using for "uint8_t" type and "UINT32_MAX" macro
+#include <time.h>               //using for "clock_gettime", "gmtime_r", and "strftime" functions
+#include <string.h>             //using for "memset" function
+#include <unistd.h>             //using for "access" function
+#include <pthread.h>            //using for the bus threads and the sink lock
 #include "lsm9ds0.h"            //using lsm9ds0 board
-#include "iotdevicegateway.h"   //using to publish events to aws iot device gateway
+#include "telemetrysink.h"      //using to publish telemetry batches to the configured transport(s)
+#include "windowaggregator.h"   //using to summarize the readings over windows
+#include "ahrsfilter.h"         //using to fuse the readings into an orientation
+#include "filterchain.h"        //using to filter (and decimate) the readings before they are encoded
+#include "eventdetector.h"      //using to only publish readings around events (report by exception)
+#include "spectralanalyzer.h"   //using to extract frequency domain (vibration) features of the accelerometer readings
+#include "imucalibration.h"     //using to correct the gyro bias and magnetometer hard/soft iron
+#include "metrics.h"            //using to time the encoding and publishing of readings
+#include "trace.h"              //using to trace the acquisition, encoding, and publishing of readings
+#include "satconfig.h"          //using to take on reloaded tunables, and to pin the bus threads to their cpus
+#include "satmemory.h"          //using to allocate from the memory arena
 #include "lsm9ds0processor.h"
 
 //global vars
-static const int DESIRED_WINDOW_SIZE = 300; //~3 seconds - ~100 samples per second - accelerometer & magnetometer generate 100 samples per second, gyroscope generates 95 samples per second
+static const float DEBUG_PRINT_DURATION = 3.0f; //seconds between printed accelerometer readings
+static const float AHRS_BETA = 0.1f; //sensor fusion gain (converges in a few seconds at ~100 samples per second)
+static const float GYRO_CALIBRATION_DURATION = 3.0f; //seconds of readings the gyro bias is averaged over
+static const double GYRO_CALIBRATION_MAX_DEVIATION = 1.0; //dps - largest standard deviation of a gyro rate considered at rest
+static const float MAGNETO_CALIBRATION_DURATION = 30.0f; //seconds of readings the magnetometer's ellipsoid is fit to
+
+/*
+    Every board gets its own pipeline (its filter chain, window, spectrum, ahrs filter, event detector, and batch), so boards
+    never share state and their readings are tagged with the board's index (its position in the options' devices).
+
+    The boards are serviced by one thread per i2c bus. Transfers on a bus are serialized by the bus anyway, so a bus thread
+    polls each of its boards in turn and runs the pipeline of whichever has a reading ready, while boards on other buses
+    are acquired in parallel. A single bus (the common case) is serviced on the calling thread.
+
+    The sink is shared, publishing to it is serialized by a lock (a batch is only copied into the sink while it is held,
+    the transport i/o happens on the fan-out sink's lane threads when several sinks are configured).
+
+    The tunables (batch size, flush latency, heartbeat interval, output data rates, filters) are copied into each pipeline,
+    and replaced there between batches when the config watcher has newer ones, so the readings are never handled with a mix
+    of old and new values. New rates or filters reconfigure the board and rebuild its filter chain (restarting the spectrum,
+    which can't mix rates), both or neither: a combination the board or chain rejects leaves the board as it was. Each
+    pipeline hands the values it ended up with back to the watcher, so they can be reported.
+
+    Each board accounts for the readings it loses (sensor overruns, readings that couldn't be encoded, and batches the
+    sink rejected) in its batch's header, which the batch clearing leaves alone. The ranges lost are reported by the
+    header of the next batch the sink takes.
+*/
+
+//per board state representation (heap allocated as it is tens of kilobytes)
+typedef struct lsm9ds0_sat_pipeline
+{
+    uint32_t device_index;                  //index of the board in the options' devices (tags every reading it publishes)
+    int i2c_bus;                            //bus the board is on (so the thread servicing the bus)
+    LSM9DS0 lsm;
+    IMU_CALIBRATION calibration;
+    TELEMETRY_BATCH batch;                  //batch currently being filled
+    WINDOW_AGGREGATOR aggregator;
+    FILTER_CHAIN filter_chain;
+    SAMPLE_BATCH acquired_samples;          //latest reading, before it is filtered
+    EVENT_DETECTOR detector;
+    SPECTRAL_ANALYZER spectrum;
+    SPECTRAL_FEATURES features;
+    AHRS_FILTER ahrs;
+    int sequence_id;                        //zero indexed - order of signal readings (each telemetry reading is tagged with a sequence number)
+    uint32_t accounted_overrun_count;       //board's signal overruns already accounted for in the batch header
+    uint8_t hardware_detections;            //gyro threshold interrupts latched since the latest reading was filtered
+    uint32_t batch_size;                    //readings per published batch (at the filtered rate, from the tunables)
+    SAT_TUNABLES tunables;                  //tunables the pipeline runs with (the values in effect)
+    uint32_t tunables_generation;           //generation of the config watcher's tunables the pipeline last took
+    uint32_t debug_print_interval;          //readings between printed accelerometer readings (at the filtered rate)
+    bool is_complete;                       //denotes the board has published its limit of readings
+}LSM9DS0_SAT_PIPELINE;
+
+//state shared by the bus threads representation
+typedef struct lsm9ds0_sat_scheduler
+{
+    const LSM9DS0_SAT_OPTIONS* options;
+    TELEMETRY_SINK* sink;
+    pthread_mutex_t sink_lock;              //serializes publishing to the sink
+    int desired_processing_limit;           //readings published per board
+    bool publish_readings;                  //denotes if every reading is published (rather than only the window summaries)
+    uint32_t pipeline_count;
+    LSM9DS0_SAT_PIPELINE* pipelines[LSM9DS0_SAT_MAX_DEVICES];
+}LSM9DS0_SAT_SCHEDULER;
+
+//bus thread representation
+typedef struct lsm9ds0_sat_bus_worker
+{
+    LSM9DS0_SAT_SCHEDULER* scheduler;
+    int i2c_bus;                            //bus whose boards the thread services
+    pthread_t thread;
+}LSM9DS0_SAT_BUS_WORKER;
 
 //function declarations
-static void display_sensor_info(LSM9DS0*);
+static LSM9DS0_SAT_PIPELINE* new_lsm9ds0_sat_pipeline(const LSM9DS0_SAT_OPTIONS*, uint32_t);
+static void free_lsm9ds0_sat_pipeline(LSM9DS0_SAT_PIPELINE*);
+static void* run_lsm9ds0_sat_bus_worker(void*);
+static void process_lsm9ds0_sat_reading(LSM9DS0_SAT_SCHEDULER*, LSM9DS0_SAT_PIPELINE*);
+static void publish_lsm9ds0_sat_batch(LSM9DS0_SAT_SCHEDULER*, TELEMETRY_BATCH*);
+static void append_reading_to_lsm9ds0_sat_batch(TELEMETRY_BATCH*, const TELEMETRY_READING*, int);
+static void add_sequence_id_to_lsm9ds0_sat_batch(TELEMETRY_BATCH*, int);
+static void apply_lsm9ds0_sat_tunables(const LSM9DS0_SAT_OPTIONS*, LSM9DS0_SAT_PIPELINE*, const SAT_TUNABLES*);
+static bool rebuild_lsm9ds0_sat_filter_chain(const LSM9DS0_SAT_OPTIONS*, LSM9DS0_SAT_PIPELINE*, const char*);
+static void size_lsm9ds0_sat_batch(LSM9DS0_SAT_PIPELINE*);
+static void display_sensor_info(LSM9DS0*, uint32_t, const LSM9DS0_SAT_DEVICE*);
+static bool check_for_signal_readings(LSM9DS0*);
 static void poll_for_signal_readings(LSM9DS0*);
-static bool convert_lsm9ds0_signal_reading_aggregate_to_telemetry_reading(LSM9DS0_SIGNAL_READING_AGGREGATE*, TELEMETRY_READING*, int);
+static bool calibrate_lsm9ds0(LSM9DS0*, const LSM9DS0_SAT_OPTIONS*, const char*, IMU_CALIBRATION*);
+static bool acquire_calibration_sample(LSM9DS0*, SAMPLE_BATCH*);
+static int64_t get_wall_clock_offset(void);
+static bool append_lsm9ds0_raw_signal_reading_aggregate_to_sample_batch(LSM9DS0_RAW_SIGNAL_READING_AGGREGATE*, SAMPLE_BATCH*, int64_t);
+static bool convert_sample_to_telemetry_reading(SAMPLE_BATCH*, uint32_t, TELEMETRY_READING*, const char*, uint32_t, int);
+static bool convert_window_summary_to_telemetry_reading(WINDOW_SUMMARY*, uint32_t, TELEMETRY_READING*, const char*, uint32_t);
+static bool convert_ahrs_orientation_to_telemetry_reading(AHRS_ORIENTATION*, TELEMETRY_READING*, const char*, uint32_t, int);
+static uint32_t get_samples_per_duration(float, float, uint32_t);
+static uint32_t move_event_history_to_telemetry_batch(LSM9DS0_SAT_SCHEDULER*, LSM9DS0_SAT_PIPELINE*);
+static bool convert_event_transition_to_telemetry_reading(EVENT_DETECTOR*, EVENT_TRANSITION, TELEMETRY_READING*, const char*, uint32_t, int);
+static bool convert_event_heartbeat_to_telemetry_reading(EVENT_HEARTBEAT*, TELEMETRY_READING*, const char*, uint32_t, int);
+static bool convert_spectral_features_to_telemetry_reading(SPECTRAL_FEATURES*, uint32_t, TELEMETRY_READING*, const char*, uint32_t);
 
 //function definition
-//performs signal acquisition and telemetry process until desired limit is reached
-bool perform_lsm9ds0_sat(int desired_processing_limit)
+//performs signal acquisition and telemetry process on every board until each has reached the desired limit, publishing to the supplied sink
+bool perform_lsm9ds0_sat(TELEMETRY_SINK* sink, int desired_processing_limit, const LSM9DS0_SAT_OPTIONS* options)
 {
     //local vars
     bool operation_status = false;          //denotes success or failure of the operation
-    int sequence_id = 0;                    //zero indexed - order of signal readings (each telemetry reading is tagged with a sequence number)
-    int window_id = 0;                      //zero indexed - each telemetry reading is clustered in an interval (window) of 'x' readings equal to the desired_window_size
-    LSM9DS0 lsm;
-    IOT_DEVICE_GATEWAY device_gateway;
-    LSM9DS0_SIGNAL_READING_AGGREGATE signal_reading_aggregate;
-    TELEMETRY_READING telemetry;
+    LSM9DS0_SAT_SCHEDULER scheduler;
+    LSM9DS0_SAT_BUS_WORKER workers[LSM9DS0_SAT_MAX_DEVICES];
+    uint32_t worker_count = 0;
+    uint32_t started_count = 0;
+    uint32_t i;
+    uint32_t j;
 
-    //if the board and gateway were successfully initialized
-    if (init_lsm9ds0(&lsm) && init_iot_device_gateway(&device_gateway))
+    //check input
+    if ((options == NULL) || (options->device_id == NULL) || (options->device_count == 0) || (options->device_count > LSM9DS0_SAT_MAX_DEVICES))
     {
-        //display sensor info
-        display_sensor_info(&lsm);
+        return false;
+    }
+
+    scheduler.options = options;
+    scheduler.sink = sink;
+    scheduler.desired_processing_limit = desired_processing_limit;
+    scheduler.pipeline_count = 0;
 
-        //loop forever
-        while (true)
+    //without a window, orientation, or spectrum there is nothing to publish but the readings
+    scheduler.publish_readings = ((options->window_type == NO_WINDOW) && (options->orientation_interval == 0) && (options->spectrum_length == 0)) || options->publish_readings;
+
+    //create a pipeline per board (configuring and calibrating each in turn), and a bus thread per distinct bus
+    for (i = 0; i < options->device_count; i++)
+    {
+        scheduler.pipelines[i] = new_lsm9ds0_sat_pipeline(options, i);
+        if (scheduler.pipelines[i] == NULL)
         {
-            //block until new signal readings are available
-            poll_for_signal_readings(&lsm);
+            break;
+        }
+        scheduler.pipeline_count++;
 
-            //** perform signal acquisition **
-            //get the latest accelerometer, magnetometer, and gyroscope readings (will also check for any overruns)
-            if (get_latest_signal_reading(&lsm, ACCEL, &(signal_reading_aggregate.accel)) &&
-                get_latest_signal_reading(&lsm, MAGNETO, &(signal_reading_aggregate.magneto)) &&
-                get_latest_signal_reading(&lsm, GYRO, &(signal_reading_aggregate.gyro)))
+        for (j = 0; (j < worker_count) && (workers[j].i2c_bus != options->devices[i].i2c_bus); j++)
+        {
+        }
+        if (j == worker_count)
+        {
+            workers[worker_count].scheduler = &scheduler;
+            workers[worker_count].i2c_bus = options->devices[i].i2c_bus;
+            worker_count++;
+        }
+    }
+
+    //if every board was successfully initialized, and the sink and its lock
+    if ((scheduler.pipeline_count == options->device_count) && (pthread_mutex_init(&(scheduler.sink_lock), NULL) == 0))
+    {
+        if (open_telemetry_sink(sink))
+        {
+            //a single bus is serviced on this thread, otherwise each bus gets its own
+            if (worker_count == 1)
             {
-                //** perform signal transformation **
-                //convert signal reading aggregate to telemetry reading
-                //if successful conversion
-                if (convert_lsm9ds0_signal_reading_aggregate_to_telemetry_reading(&signal_reading_aggregate, &telemetry, sequence_id))
+                set_thread_cpu_mask(pthread_self(), options->bus_cpu_mask);
+                run_lsm9ds0_sat_bus_worker(&(workers[0]));
+                operation_status = true;
+            }
+            else
+            {
+                for (started_count = 0; started_count < worker_count; started_count++)
                 {
-                    //** perform data transmission **
-                    //publish telemetry reading to aws iot device gateway (fire and forget)
-                    publish_telemetry_to_device_gateway(&device_gateway, &telemetry);
-
-                    //advance our window id if we've sent a set of messages equal to our desired window size
-                    if ((sequence_id % DESIRED_WINDOW_SIZE) == 0)
+                    if (pthread_create(&(workers[started_count].thread), NULL, run_lsm9ds0_sat_bus_worker, &(workers[started_count])) != 0)
                     {
-                        window_id++;
-                        //print current accelerometer payload to stdout for testing purposes
-                        //the readings are in Gauss (g) (earth gravitation units) and we must convert them to
-                        //meters per second per second or meters per square second, by multiplying by the conversion factor 9.81
-                        //1 g = 9.81 m/s^2
-                        fprintf(stdout, "ACCEL X READING: %lf\n", signal_reading_aggregate.accel.x * 9.81);
-                        fprintf(stdout, "ACCEL Y READING: %lf\n", signal_reading_aggregate.accel.y * 9.81);
-                        fprintf(stdout, "ACCEL Z READING: %lf\n", signal_reading_aggregate.accel.z * 9.81);
-                    }
-
-                    //break out if we've sent our limit of messages for this run of the SAT client
-                    if (sequence_id == desired_processing_limit)
-                    {
-                        //success
-                        operation_status = true;
+                        fprintf(stderr, "ERROR: FAILED TO START I2C BUS %d THREAD!\n", workers[started_count].i2c_bus);
                         break;
                     }
-
-                    //advance the sequence id
-                    sequence_id++;
+                    set_thread_cpu_mask(workers[started_count].thread, options->bus_cpu_mask);
                 }
-                else
+
+                //the started threads run until their boards have published their limit
+                for (i = 0; i < started_count; i++)
                 {
-                    fprintf(stderr, "ERROR: FAILED TO CONVERT SIGNAL READING AGGREGATE TO TELEMETRY READING!\n");
+                    pthread_join(workers[i].thread, NULL);
                 }
+                operation_status = (started_count == worker_count);
+            }
+
+            //wait for what was published to go out
+            flush_telemetry_sink(sink);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO INITIALIZE TELEMETRY SINK OBJECT!\n");
+        }
+
+        pthread_mutex_destroy(&(scheduler.sink_lock));
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: FAILED TO INITIALIZE LSM9DS0 OBJECT(S)!\n");
+    }
+
+    //close the telemetry sink (if it was opened)
+    close_telemetry_sink(sink);
+
+    //deallocate the pipelines
+    for (i = 0; i < scheduler.pipeline_count; i++)
+    {
+        free_lsm9ds0_sat_pipeline(scheduler.pipelines[i]);
+    }
+
+    return operation_status;
+}
+
+//function definition
+//create the pipeline of a board (by its index in the options' devices), initializing, configuring, and calibrating the board
+static LSM9DS0_SAT_PIPELINE* new_lsm9ds0_sat_pipeline(const LSM9DS0_SAT_OPTIONS* options, uint32_t device_index)
+{
+    //local vars
+    LSM9DS0_SAT_PIPELINE* pipeline;
+    const LSM9DS0_SAT_DEVICE* device = &(options->devices[device_index]);
+    char calibration_file[256];             //the first board uses the calibration file, the others the file suffixed with their index
+    const char* board_calibration_file = options->calibration_file;
+    int path_size;
+
+    pipeline = allocate_sat_memory(SAT_MEMORY_LSM9DS0_PROCESSOR, sizeof (LSM9DS0_SAT_PIPELINE));
+    if (pipeline == NULL)
+    {
+        fprintf(stderr, "ERROR: FAILED TO ALLOCATE LSM9DS0 %u PIPELINE!\n", device_index);
+        return NULL;
+    }
+    pipeline->device_index = device_index;
+    pipeline->i2c_bus = device->i2c_bus;
+    pipeline->sequence_id = 0;
+    pipeline->accounted_overrun_count = 0;
+    pipeline->hardware_detections = 0;
+    pipeline->tunables_generation = 0;
+    pipeline->is_complete = false;
+
+    //start with an empty batch, that nothing has been lost before
+    clear_telemetry_batch(&(pipeline->batch));
+    pipeline->batch.header.device_id = options->device_id;
+    pipeline->batch.header.source_index = device_index;
+    memset(&(pipeline->batch.header.loss), 0, sizeof (pipeline->batch.header.loss));
+
+    if ((options->calibration_file != NULL) && (device_index > 0))
+    {
+        path_size = snprintf(calibration_file, sizeof (calibration_file), "%s.%u", options->calibration_file, device_index);
+        if ((path_size < 0) || ((size_t)path_size >= sizeof (calibration_file)))
+        {
+            fprintf(stderr, "ERROR: CALIBRATION FILE PATH IS TOO LONG!\n");
+            free_sat_memory(pipeline);
+            return NULL;
+        }
+        board_calibration_file = calibration_file;
+    }
+
+    //if the board (and its calibration), filter chain, window aggregator, ahrs filter, spectral analyzer and event detector (when requested) were successfully initialized
+    //(the board is configured first, everything downstream is sized from its actual sample rate)
+    if (init_lsm9ds0_at_address(&(pipeline->lsm), device->i2c_bus, device->gyro_address, device->accel_magneto_address) &&
+        configure_lsm9ds0(&(pipeline->lsm), &(options->sensor_config)) &&
+        calibrate_lsm9ds0(&(pipeline->lsm), options, board_calibration_file, &(pipeline->calibration)) &&
+        init_filter_chain(&(pipeline->filter_chain), (float)get_lsm9ds0_sample_rate(&(pipeline->lsm))) &&
+        ((options->filter_specification == NULL) || add_filter_stages_from_specification(&(pipeline->filter_chain), options->filter_specification)) &&
+        ((options->window_type == NO_WINDOW) || init_window_aggregator(&(pipeline->aggregator), options->window_type, options->window_length, options->window_hop, pipeline->lsm.accel_scale_factor, pipeline->lsm.magneto_scale_factor, pipeline->lsm.gyro_scale_factor)) &&
+        ((options->orientation_interval == 0) || init_ahrs_filter(&(pipeline->ahrs), AHRS_BETA, 1.0f / pipeline->filter_chain.output_rate_hz)) &&
+        ((options->spectrum_length == 0) || init_spectral_analyzer(&(pipeline->spectrum), options->spectrum_length, options->spectrum_hop, pipeline->filter_chain.output_rate_hz)) &&
+        ((!options->report_by_exception) || init_event_detector(&(pipeline->detector), &(options->event_detection))) &&
+        ((!options->report_by_exception) || (options->event_detection.gyro_threshold_dps == 0.0f) || enable_gyro_threshold_interrupt(&(pipeline->lsm), options->event_detection.gyro_threshold_dps)))
+    {
+        //display sensor info
+        display_sensor_info(&(pipeline->lsm), device_index, device);
+
+        //the board starts with the options' tunables, at the rates it was configured with and through the filters it was given
+        pipeline->tunables = options->tunables;
+        pipeline->tunables.gyro_odr = pipeline->lsm.config.gyro.odr_hz;
+        pipeline->tunables.accel_odr = pipeline->lsm.config.accel.odr_hz;
+        pipeline->tunables.magneto_odr = pipeline->lsm.config.magneto.odr_hz;
+        snprintf(pipeline->tunables.filters, sizeof (pipeline->tunables.filters), "%s", (options->filter_specification != NULL) ? options->filter_specification : "");
+        set_sat_config_applied_tunables(options->config_watcher, &(pipeline->tunables));
+
+        //batches and the debug print are sized in time, at the rate readings come out of the filter chain
+        size_lsm9ds0_sat_batch(pipeline);
+        pipeline->debug_print_interval = get_samples_per_duration(pipeline->filter_chain.output_rate_hz, DEBUG_PRINT_DURATION, UINT32_MAX);
+
+        //samples in every batch are scaled with the board's (fixed) scale factors, fused with the calibration's gyro bias and soft iron corrections
+        set_sample_batch_scale_factors(&(pipeline->batch.samples), pipeline->lsm.accel_scale_factor, pipeline->lsm.magneto_scale_factor, pipeline->lsm.gyro_scale_factor);
+        apply_imu_calibration_to_sample_batch(&(pipeline->calibration), &(pipeline->batch.samples));
+
+        return pipeline;
+    }
+
+    fprintf(stderr, "ERROR: FAILED TO INITIALIZE LSM9DS0 %u (I2C BUS %d)!\n", device_index, device->i2c_bus);
+    shutdown_lsm9ds0(&(pipeline->lsm));
+    free_sat_memory(pipeline);
+
+    return NULL;
+}
+
+//function definition
+//release a board and deallocate its pipeline
+static void free_lsm9ds0_sat_pipeline(LSM9DS0_SAT_PIPELINE* pipeline)
+{
+    if (pipeline != NULL)
+    {
+        shutdown_lsm9ds0(&(pipeline->lsm));
+        free_sat_memory(pipeline);
+    }
+}
+
+//function definition
+//bus thread, polls the boards on its bus in turn and processes whichever has a reading ready, until each has published its limit
+static void* run_lsm9ds0_sat_bus_worker(void* argument)
+{
+    //local vars
+    LSM9DS0_SAT_BUS_WORKER* worker = (LSM9DS0_SAT_BUS_WORKER*)argument;
+    LSM9DS0_SAT_SCHEDULER* scheduler = worker->scheduler;
+    LSM9DS0_SAT_PIPELINE* pipeline;
+    uint32_t remaining_count = 0;           //boards on the bus yet to publish their limit
+    uint32_t i;
+
+    for (i = 0; i < scheduler->pipeline_count; i++)
+    {
+        remaining_count += (scheduler->pipelines[i]->i2c_bus == worker->i2c_bus) ? 1 : 0;
+    }
+
+    TRACE_THREAD_NAME("i2c bus worker");
+    while (remaining_count > 0)
+    {
+        for (i = 0; i < scheduler->pipeline_count; i++)
+        {
+            pipeline = scheduler->pipelines[i];
+            if ((pipeline->i2c_bus == worker->i2c_bus) && (!pipeline->is_complete) && check_for_signal_readings(&(pipeline->lsm)))
+            {
+                TRACE_BEGIN("process reading");
+                process_lsm9ds0_sat_reading(scheduler, pipeline);
+                TRACE_END_WITH_VALUE("process reading", pipeline->device_index);
+                remaining_count -= pipeline->is_complete ? 1 : 0;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//function definition
+//acquire a board's latest reading and run it through the board's pipeline, publishing the batch when it is ready
+static void process_lsm9ds0_sat_reading(LSM9DS0_SAT_SCHEDULER* scheduler, LSM9DS0_SAT_PIPELINE* pipeline)
+{
+    //local vars
+    const LSM9DS0_SAT_OPTIONS* options = scheduler->options;
+    TELEMETRY_BATCH* batch = &(pipeline->batch);
+    bool stream_readings;                   //denotes if the latest reading is published (every reading, or only those during events when reporting by exception)
+    bool reading_availability;              //denotes if the latest reading was converted to a telemetry reading (when it is published)
+    bool summary_availability = false;      //denotes if the latest reading completed a window
+    bool heartbeat_availability;            //denotes if the latest reading completed a heartbeat
+    bool features_availability = false;     //denotes if the latest reading completed a spectral window
+    bool interrupt_occurrence;              //denotes if the gyro latched a threshold interrupt
+    bool acquisition_status;                //denotes if the latest reading was acquired (and filtered)
+    uint32_t sample_index;                  //index of the latest reading in the batch's samples
+    uint32_t previous_sample_count;         //number of samples in the batch before the latest reading was filtered into it
+    const float* accel_columns[3];          //scaled accelerometer values (for the debug print)
+    uint32_t i;
+    LSM9DS0_RAW_SIGNAL_READING_AGGREGATE raw_signal_reading_aggregate;
+    TELEMETRY_READING telemetry;
+    EVENT_TRANSITION transition = NO_EVENT_TRANSITION;
+    EVENT_HEARTBEAT heartbeat;
+    WINDOW_SUMMARY summary;
+    AHRS_ORIENTATION orientation;
+    int64_t encode_start_time;              //when the transformation of the reading started
+    SAT_TUNABLES tunables;
+
+    //readings are timestamped on the monotonic clock as they are acquired, map them to wall clock time once per batch
+    //(so a batch's timestamps are consistent with each other even if the wall clock is adjusted mid batch)
+    //and take on any tunables reloaded since the last batch (a single atomic load when there are none)
+    if (batch->reading_count == 0)
+    {
+        batch->wall_clock_offset_ns = get_wall_clock_offset();
+        if (get_sat_config_tunables(options->config_watcher, &(pipeline->tunables_generation), &tunables))
+        {
+            apply_lsm9ds0_sat_tunables(options, pipeline, &tunables);
+        }
+    }
+
+    //collect any gyro threshold interrupt latched since the last check (when reporting by exception), it counts toward the next filtered reading
+    if (options->report_by_exception && (options->event_detection.gyro_threshold_dps > 0.0f))
+    {
+        if (check_gyro_threshold_interrupt(&(pipeline->lsm), &interrupt_occurrence))
+        {
+            pipeline->hardware_detections |= interrupt_occurrence ? HARDWARE_EVENT_DETECTOR : 0;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO CHECK FOR GYRO THRESHOLD INTERRUPT!\n");
+        }
+    }
+
+    //** perform signal acquisition **
+    //get the latest raw accelerometer, magnetometer, and gyroscope readings (will also check for any overruns), and filter them into the batch's samples
+    clear_sample_batch(&(pipeline->acquired_samples));
+    previous_sample_count = batch->samples.sample_count;
+    TRACE_BEGIN("acquire");
+    acquisition_status = get_latest_raw_signal_reading(&(pipeline->lsm), ACCEL, &(raw_signal_reading_aggregate.accel)) &&
+                         get_latest_raw_signal_reading(&(pipeline->lsm), MAGNETO, &(raw_signal_reading_aggregate.magneto)) &&
+                         get_latest_raw_signal_reading(&(pipeline->lsm), GYRO, &(raw_signal_reading_aggregate.gyro)) &&
+                         append_lsm9ds0_raw_signal_reading_aggregate_to_sample_batch(&raw_signal_reading_aggregate, &(pipeline->acquired_samples), batch->wall_clock_offset_ns) &&
+                         run_filter_chain(&(pipeline->filter_chain), &(pipeline->acquired_samples), &(batch->samples));
+    TRACE_END("acquire");
+
+    //account for any overruns (the readings the sensors overwrote were lost ahead of this one)
+    if (pipeline->lsm.overrun_count != pipeline->accounted_overrun_count)
+    {
+        record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_SENSOR_OVERRUN, pipeline->sequence_id, pipeline->sequence_id, pipeline->lsm.overrun_count - pipeline->accounted_overrun_count);
+        pipeline->accounted_overrun_count = pipeline->lsm.overrun_count;
+    }
+    if (!acquisition_status)
+    {
+        fprintf(stderr, "ERROR: FAILED TO OBTAIN LATEST SIGNAL READINGS!\n");
+        return;
+    }
+
+    //a decimating filter chain only completes a sample every few readings, wait for the next one
+    if (batch->samples.sample_count == previous_sample_count)
+    {
+        return;
+    }
+    sample_index = batch->samples.sample_count - 1;
+
+    //** perform event detection **
+    //when reporting by exception, readings are only published during events, starting with the history leading up to the event
+    stream_readings = scheduler->publish_readings;
+    heartbeat_availability = false;
+    if (options->report_by_exception)
+    {
+        if (update_event_detector(&(pipeline->detector), &(batch->samples), sample_index, pipeline->hardware_detections, &transition))
+        {
+            pipeline->hardware_detections = 0;
+            if (transition == EVENT_STARTED)
+            {
+                sample_index = move_event_history_to_telemetry_batch(scheduler, pipeline);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO RUN EVENT DETECTORS!\n");
+        }
+
+        stream_readings = pipeline->detector.event_active || (transition == EVENT_ENDED);
+    }
+
+    //** perform signal transformation **
+    //convert the sample to a telemetry reading (when readings are published)
+    add_sequence_id_to_lsm9ds0_sat_batch(batch, pipeline->sequence_id);
+    encode_start_time = get_metrics_time_ns();
+    //if unsuccessful conversion (the reading is lost, but the sample still feeds the rest of the pipeline)
+    reading_availability = stream_readings && convert_sample_to_telemetry_reading(&(batch->samples), sample_index, &telemetry, options->device_id, pipeline->device_index, pipeline->sequence_id);
+    if (stream_readings && (!reading_availability))
+    {
+        fprintf(stderr, "ERROR: FAILED TO CONVERT SAMPLE TO TELEMETRY READING!\n");
+        record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, pipeline->sequence_id, pipeline->sequence_id, 1);
+    }
+
+    //** perform data transmission **
+    //encode the telemetry reading into the current batch (the sample is already in it)
+    if (reading_availability)
+    {
+        append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
+    }
+
+    //encode the start or end of an event, and every heartbeat interval samples a heartbeat, into the current batch
+    if ((transition != NO_EVENT_TRANSITION) && convert_event_transition_to_telemetry_reading(&(pipeline->detector), transition, &telemetry, options->device_id, pipeline->device_index, pipeline->sequence_id))
+    {
+        append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
+    }
+    if (options->report_by_exception && (pipeline->tunables.heartbeat_interval > 0) && ((pipeline->sequence_id % pipeline->tunables.heartbeat_interval) == 0))
+    {
+        if (get_event_heartbeat(&(pipeline->detector), &heartbeat) && convert_event_heartbeat_to_telemetry_reading(&heartbeat, &telemetry, options->device_id, pipeline->device_index, pipeline->sequence_id))
+        {
+            append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
+            heartbeat_availability = true;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO CONVERT HEARTBEAT TO TELEMETRY READING!\n");
+            record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, pipeline->sequence_id, pipeline->sequence_id, 1);
+        }
+    }
+
+    //add the sample to the window, encoding a summary (one reading per sensor) into the current batch each time a window completes
+    if ((options->window_type != NO_WINDOW) && add_sample_to_window_aggregator(&(pipeline->aggregator), &(batch->samples), sample_index, &summary, &summary_availability) && summary_availability)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            if (convert_window_summary_to_telemetry_reading(&summary, i, &telemetry, options->device_id, pipeline->device_index))
+            {
+                append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: FAILED TO CONVERT WINDOW SUMMARY TO TELEMETRY READING!\n");
+                record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, pipeline->sequence_id, pipeline->sequence_id, 1);
+            }
+        }
+    }
+
+    //add the sample to the spectral window, encoding its features (one reading per accelerometer axis) into the current batch each time a window completes
+    if ((options->spectrum_length > 0) && add_sample_to_spectral_analyzer(&(pipeline->spectrum), &(batch->samples), sample_index, &(pipeline->features), &features_availability) && features_availability)
+    {
+        for (i = 0; i < SPECTRAL_AXIS_COUNT; i++)
+        {
+            if (convert_spectral_features_to_telemetry_reading(&(pipeline->features), i, &telemetry, options->device_id, pipeline->device_index))
+            {
+                append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
             }
             else
             {
-                fprintf(stderr, "ERROR: FAILED TO OBTAIN LATEST SIGNAL READINGS!\n");
+                fprintf(stderr, "ERROR: FAILED TO CONVERT SPECTRAL FEATURES TO TELEMETRY READING!\n");
+                record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, pipeline->sequence_id, pipeline->sequence_id, 1);
             }
         }
     }
+
+    //fuse the sample into the orientation, encoding the orientation into the current batch every orientation interval samples
+    if ((options->orientation_interval > 0) && update_ahrs_filter(&(pipeline->ahrs), &(batch->samples), sample_index) && ((pipeline->sequence_id % options->orientation_interval) == 0))
+    {
+        if (get_ahrs_orientation(&(pipeline->ahrs), &orientation) && convert_ahrs_orientation_to_telemetry_reading(&orientation, &telemetry, options->device_id, pipeline->device_index, pipeline->sequence_id))
+        {
+            append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, pipeline->sequence_id);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: FAILED TO CONVERT ORIENTATION TO TELEMETRY READING!\n");
+            record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, pipeline->sequence_id, pipeline->sequence_id, 1);
+        }
+    }
+    record_metrics_histogram(METRICS_ENCODE_NS, (uint64_t)(get_metrics_time_ns() - encode_start_time));
+    TRACE_COMPLETE("encode", encode_start_time);
+
+    //periodically print the accelerometer reading
+    if ((pipeline->sequence_id % pipeline->debug_print_interval) == 0)
+    {
+        //print current accelerometer payload to stdout for testing purposes
+        //the readings are in Gauss (g) (earth gravitation units) and we must convert them to
+        //meters per second per second or meters per square second, by multiplying by the conversion factor 9.81
+        //1 g = 9.81 m/s^2
+        for (i = 0; i < 3; i++)
+        {
+            accel_columns[i] = get_scaled_sample_batch_column(&(batch->samples), SAMPLE_ACCEL_X + i);
+        }
+        fprintf(stdout, "IMU %u ACCEL X READING: %lf\n", pipeline->device_index, accel_columns[0][sample_index] * 9.81);
+        fprintf(stdout, "IMU %u ACCEL Y READING: %lf\n", pipeline->device_index, accel_columns[1][sample_index] * 9.81);
+        fprintf(stdout, "IMU %u ACCEL Z READING: %lf\n", pipeline->device_index, accel_columns[2][sample_index] * 9.81);
+    }
+
+    //when readings aren't published the samples were just staged for the window, spectrum, ahrs filter, and event detector, drop them
+    if (!stream_readings)
+    {
+        clear_sample_batch(&(batch->samples));
+    }
+
+    //publish the batch once it is full, or as soon as it holds a window summary, spectral features, heartbeat, or the start or end of an event (fire and forget)
+    //(and whatever is left in it once we've sent our limit of messages for this run of the SAT client)
+    if ((batch->reading_count >= pipeline->batch_size) || (batch->samples.sample_count >= pipeline->batch_size) || summary_availability || features_availability || heartbeat_availability || (transition != NO_EVENT_TRANSITION) ||
+        (pipeline->sequence_id == scheduler->desired_processing_limit))
+    {
+        publish_lsm9ds0_sat_batch(scheduler, batch);
+        clear_telemetry_batch(batch);
+    }
+
+    //the board is done once it has sent its limit of messages, otherwise advance the sequence id
+    if (pipeline->sequence_id == scheduler->desired_processing_limit)
+    {
+        pipeline->is_complete = true;
+    }
     else
     {
-        fprintf(stderr, "ERROR: FAILED TO INITIALIZE LSM9DS0 AND/OR IOT DEVICE GATEWAY OBJECT(S)!\n");
+        pipeline->sequence_id++;
+    }
+}
+
+//function definition
+//publish a board's batch to the sink shared by every board (fire and forget), headed by the board's loss accounting
+static void publish_lsm9ds0_sat_batch(LSM9DS0_SAT_SCHEDULER* scheduler, TELEMETRY_BATCH* batch)
+{
+    //local vars
+    int64_t publish_start_time;     //when the batch was handed to the sink
+    int64_t publish_end_time;       //when the sink returned
+    bool publish_status;
+    uint32_t i;
+
+    //nothing to send (so no header to deliver)
+    if ((batch->reading_count == 0) && (batch->samples.sample_count == 0))
+    {
+        return;
     }
 
-    //shutdown iot device gateway
-    shutdown_iot_device_gateway(&device_gateway);
+    encode_telemetry_batch_header(batch);
+    pthread_mutex_lock(&(scheduler->sink_lock));
+    publish_start_time = get_metrics_time_ns();
+    publish_status = publish_telemetry_batch_to_sink(scheduler->sink, batch);
+    publish_end_time = get_metrics_time_ns();
+    TRACE_COMPLETE("publish", publish_start_time);
+    pthread_mutex_unlock(&(scheduler->sink_lock));
 
-    return operation_status;
+    //record how long the sink took, and how old each sample was when it was handed over (samples are stamped with the batch's wall clock offset applied)
+    record_metrics_histogram(METRICS_PUBLISH_NS, (uint64_t)(publish_end_time - publish_start_time));
+    for (i = 0; i < batch->samples.sample_count; i++)
+    {
+        record_metrics_histogram(METRICS_SAMPLE_AGE_NS, (uint64_t)(publish_start_time + batch->wall_clock_offset_ns - batch->samples.timestamps_ns[i]));
+    }
+
+    //once a header has been delivered the ranges it listed are reported, otherwise the batch's readings are lost too (reported by the next header)
+    if (publish_status)
+    {
+        increment_metrics_counter(METRICS_BATCHES_PUBLISHED, 1);
+        increment_metrics_counter(METRICS_READINGS_PUBLISHED, batch->reading_count);
+        clear_telemetry_loss_gaps(&(batch->header.loss));
+    }
+    else
+    {
+        increment_metrics_counter(METRICS_PUBLISH_FAILURES, 1);
+        record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_PUBLISH_FAILURE, batch->header.first_sequence_id, batch->header.last_sequence_id, batch->reading_count);
+    }
+}
+
+//function definition
+//encode a reading into a board's batch, accounting for it as lost if the batch has no room left for it
+static void append_reading_to_lsm9ds0_sat_batch(TELEMETRY_BATCH* batch, const TELEMETRY_READING* telemetry, int sequence_id)
+{
+    if (!append_telemetry_reading_to_batch(batch, telemetry))
+    {
+        fprintf(stderr, "ERROR: FAILED TO ENCODE TELEMETRY READING INTO BATCH!\n");
+        record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, sequence_id, sequence_id, 1);
+    }
+}
+
+//function definition
+//widen the range of sequence ids a board's batch header gives to include a reading acquired into the batch
+static void add_sequence_id_to_lsm9ds0_sat_batch(TELEMETRY_BATCH* batch, int sequence_id)
+{
+    if ((batch->header.first_sequence_id < 0) || (sequence_id < batch->header.first_sequence_id))
+    {
+        batch->header.first_sequence_id = sequence_id;
+    }
+    if (sequence_id > batch->header.last_sequence_id)
+    {
+        batch->header.last_sequence_id = sequence_id;
+    }
+}
+
+//function definition
+//take on a set of tunables between batches, reconfiguring the board and rebuilding its filter chain when its rates or filters changed
+//(a combination rejected by either leaves the board as it was), then hand the values in effect back to the config watcher
+static void apply_lsm9ds0_sat_tunables(const LSM9DS0_SAT_OPTIONS* options, LSM9DS0_SAT_PIPELINE* pipeline, const SAT_TUNABLES* tunables)
+{
+    //local vars
+    LSM9DS0_CONFIG previous_config = pipeline->lsm.config;      //configuration the board is running with (with the bandwidths actually set)
+    LSM9DS0_CONFIG sensor_config = pipeline->lsm.config;
+    bool is_rate_changed;
+    bool is_filters_changed;
+
+    //a new gyro rate takes the rate's default bandwidth (each rate supports its own bandwidths)
+    sensor_config.gyro.odr_hz = tunables->gyro_odr;
+    sensor_config.gyro.bandwidth_hz = (tunables->gyro_odr == previous_config.gyro.odr_hz) ? previous_config.gyro.bandwidth_hz : 0.0;
+    sensor_config.accel.odr_hz = tunables->accel_odr;
+    sensor_config.magneto.odr_hz = tunables->magneto_odr;
+    is_rate_changed = (tunables->gyro_odr != previous_config.gyro.odr_hz) || (tunables->accel_odr != previous_config.accel.odr_hz) || (tunables->magneto_odr != previous_config.magneto.odr_hz);
+    is_filters_changed = (strcmp(tunables->filters, pipeline->tunables.filters) != 0);
+
+    if (is_rate_changed || is_filters_changed)
+    {
+        if (((!is_rate_changed) || configure_lsm9ds0(&(pipeline->lsm), &sensor_config)) && rebuild_lsm9ds0_sat_filter_chain(options, pipeline, tunables->filters))
+        {
+            snprintf(pipeline->tunables.filters, sizeof (pipeline->tunables.filters), "%s", tunables->filters);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: LSM9DS0 %u REJECTED OUTPUT DATA RATES %g/%g/%gHZ WITH FILTERS \"%s\", KEEPING ITS CURRENT ONES!\n", pipeline->device_index, tunables->gyro_odr, tunables->accel_odr, tunables->magneto_odr, tunables->filters);
+            if (is_rate_changed)
+            {
+                configure_lsm9ds0(&(pipeline->lsm), &previous_config);
+            }
+            rebuild_lsm9ds0_sat_filter_chain(options, pipeline, pipeline->tunables.filters);
+        }
+        pipeline->tunables.gyro_odr = pipeline->lsm.config.gyro.odr_hz;
+        pipeline->tunables.accel_odr = pipeline->lsm.config.accel.odr_hz;
+        pipeline->tunables.magneto_odr = pipeline->lsm.config.magneto.odr_hz;
+    }
+
+    //the rest always apply
+    pipeline->tunables.batch_size = tunables->batch_size;
+    pipeline->tunables.flush_latency_ms = tunables->flush_latency_ms;
+    pipeline->tunables.heartbeat_interval = tunables->heartbeat_interval;
+    size_lsm9ds0_sat_batch(pipeline);
+
+    set_sat_config_applied_tunables(options->config_watcher, &(pipeline->tunables));
+}
+
+//function definition
+//rebuild a board's filter chain (at the board's current sample rate), resizing what depends on the rate readings come out of it
+//(the orientation carries on, the spectral window restarts)
+static bool rebuild_lsm9ds0_sat_filter_chain(const LSM9DS0_SAT_OPTIONS* options, LSM9DS0_SAT_PIPELINE* pipeline, const char* filters)
+{
+    if (init_filter_chain(&(pipeline->filter_chain), (float)get_lsm9ds0_sample_rate(&(pipeline->lsm))) &&
+        ((filters[0] == '\0') || add_filter_stages_from_specification(&(pipeline->filter_chain), filters)) &&
+        ((options->spectrum_length == 0) || init_spectral_analyzer(&(pipeline->spectrum), options->spectrum_length, options->spectrum_hop, pipeline->filter_chain.output_rate_hz)))
+    {
+        if (options->orientation_interval > 0)
+        {
+            pipeline->ahrs.sample_period_s = 1.0f / pipeline->filter_chain.output_rate_hz;
+        }
+        pipeline->debug_print_interval = get_samples_per_duration(pipeline->filter_chain.output_rate_hz, DEBUG_PRINT_DURATION, UINT32_MAX);
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//size a board's batches from its tunables, in time at the rate readings come out of its filter chain (capped by what a batch holds)
+static void size_lsm9ds0_sat_batch(LSM9DS0_SAT_PIPELINE* pipeline)
+{
+    //local vars
+    uint32_t max_batch_size = (SAMPLE_BATCH_MAX_SAMPLES < TELEMETRY_BATCH_MAX_READINGS) ? SAMPLE_BATCH_MAX_SAMPLES : TELEMETRY_BATCH_MAX_READINGS;
+
+    if ((pipeline->tunables.batch_size > 0) && (pipeline->tunables.batch_size < max_batch_size))
+    {
+        max_batch_size = pipeline->tunables.batch_size;
+    }
+
+    pipeline->batch_size = get_samples_per_duration(pipeline->filter_chain.output_rate_hz, (float)pipeline->tunables.flush_latency_ms / 1000.0f, max_batch_size);
 }
 
 //function definition
 //display the onboard sensor info
-static void display_sensor_info(LSM9DS0* lsm)
+static void display_sensor_info(LSM9DS0* lsm, uint32_t device_index, const LSM9DS0_SAT_DEVICE* device)
 {
     //local vars
     uint8_t sensor_id;
 
     //check input
-    if (lsm != NULL)
+    if ((lsm != NULL) && (device != NULL))
     {
         //print sensor IDs
-        printf("IMU - ");
+        printf("IMU %u (i2c bus %d, gyro 0x%X, accel/magneto 0x%X) - ", device_index, device->i2c_bus, device->gyro_address, device->accel_magneto_address);
         get_sensor_id(lsm, ACCEL, &sensor_id);
         printf("Accel ID: 0x%X (should equal: 0x49), ", sensor_id);
         get_sensor_id(lsm, MAGNETO, &sensor_id);
@@ -126,62 +775,232 @@ static void display_sensor_info(LSM9DS0* lsm)
 }
 
 //function definition
-//loop until new signal readings are available
-static void poll_for_signal_readings(LSM9DS0* lsm)
+//check (once) if a new signal reading is available from the accelerometer, magnetometer, or gyroscope
+static bool check_for_signal_readings(LSM9DS0* lsm)
 {
     //local vars
     bool accel_reading_availability = false;
     bool magneto_reading_availability = false;
     bool gyro_reading_availability = false;
 
+    //check to see if a new accelerometer reading is available
+    if (!check_signal_reading_availability(lsm, ACCEL, &accel_reading_availability))
+    {
+        fprintf(stderr, "ERROR: FAILED TO CHECK FOR ACCEL SIGNAL READING AVAILABILITY!\n");
+    }
+    //check to see if a new magnetometer reading is available
+    if (!check_signal_reading_availability(lsm, MAGNETO, &magneto_reading_availability))
+    {
+        fprintf(stderr, "ERROR: FAILED TO CHECK FOR MAGNETO SIGNAL READING AVAILABILITY!\n");
+    }
+    //check to see if a new gyroscope reading is available
+    if (!check_signal_reading_availability(lsm, GYRO, &gyro_reading_availability))
+    {
+        fprintf(stderr, "ERROR: FAILED TO CHECK FOR GYRO SIGNAL READING AVAILABILITY!\n");
+    }
+
+    return accel_reading_availability || magneto_reading_availability || gyro_reading_availability;
+}
+
+//function definition
+//loop until new signal readings are available
+static void poll_for_signal_readings(LSM9DS0* lsm)
+{
     //check input
     if (lsm != NULL)
     {
-        //loop until a new signal reading is available from the accelerometer, magnetometer, and gyroscope
-        while ((!accel_reading_availability) && (!magneto_reading_availability) && (!gyro_reading_availability))
+        //loop until a new signal reading is available from the accelerometer, magnetometer, or gyroscope
+        while (!check_for_signal_readings(lsm))
         {
-            //check to see if a new accelerometer reading is available
-            if (!check_signal_reading_availability(lsm, ACCEL, &accel_reading_availability))
-            {
-                fprintf(stderr, "ERROR: FAILED TO CHECK FOR ACCEL SIGNAL READING AVAILABILITY!\n");
-            }
-            //check to see if a new magnetometer reading is available
-            if (!check_signal_reading_availability(lsm, MAGNETO, &magneto_reading_availability))
+        }
+    }
+}
+
+//function definition
+//load the board's calibration from its calibration file (when present), estimate the gyro bias and magnetometer hard/soft iron (when requested, saving them
+//to the file), and write the hard iron offsets to the magnetometer (zero, the power on default, when uncalibrated)
+static bool calibrate_lsm9ds0(LSM9DS0* lsm, const LSM9DS0_SAT_OPTIONS* options, const char* calibration_file, IMU_CALIBRATION* calibration)
+{
+    //local vars
+    static SAMPLE_BATCH samples;            //latest calibration reading
+    static MAGNETO_ELLIPSOID_FIT fit;       //normal equations of the fit (static as they're over half a kilobyte)
+    GYRO_BIAS_ESTIMATOR estimator;
+    bool at_rest;
+    uint32_t sample_count;                  //readings spanning the calibration's duration
+    uint32_t i;
+
+    //start uncalibrated, then take whatever was persisted
+    init_imu_calibration(calibration);
+    if ((calibration_file != NULL) && (access(calibration_file, F_OK) == 0) && (!load_imu_calibration(calibration, calibration_file)))
+    {
+        return false;
+    }
+
+    //the samples are only used for their raw values (the fit scales them to gauss)
+    set_sample_batch_scale_factors(&samples, lsm->accel_scale_factor, lsm->magneto_scale_factor, lsm->gyro_scale_factor);
+
+    //estimate the gyro bias
+    if (options->calibrate_gyro)
+    {
+        printf("Calibrating gyro - keep the board still...\n");
+        init_gyro_bias_estimator(&estimator);
+        sample_count = get_samples_per_duration((float)get_lsm9ds0_sample_rate(lsm), GYRO_CALIBRATION_DURATION, UINT32_MAX);
+        for (i = 0; i < sample_count; i++)
+        {
+            if (!(acquire_calibration_sample(lsm, &samples) && add_sample_to_gyro_bias_estimator(&estimator, &samples, 0)))
             {
-                fprintf(stderr, "ERROR: FAILED TO CHECK FOR MAGNETO SIGNAL READING AVAILABILITY!\n");
+                fprintf(stderr, "ERROR: FAILED TO OBTAIN GYRO CALIBRATION READINGS!\n");
+                return false;
             }
-            //check to see if a new gyroscope reading is available
-            if (!check_signal_reading_availability(lsm, GYRO, &gyro_reading_availability))
+        }
+        if (!(compute_gyro_bias(&estimator, lsm->gyro_scale_factor, GYRO_CALIBRATION_MAX_DEVIATION, calibration, &at_rest) && at_rest))
+        {
+            fprintf(stderr, "ERROR: FAILED TO CALIBRATE GYRO, THE BOARD WAS NOT AT REST!\n");
+            return false;
+        }
+        printf("Gyro bias (dps): %lf, %lf, %lf\n", calibration->gyro_bias[0] * lsm->gyro_scale_factor, calibration->gyro_bias[1] * lsm->gyro_scale_factor, calibration->gyro_bias[2] * lsm->gyro_scale_factor);
+    }
+
+    //fit the magnetometer's hard and soft iron (to readings with the persisted offsets already subtracted by the sensor)
+    if (options->calibrate_magneto)
+    {
+        printf("Calibrating magnetometer - rotate the board slowly through every orientation...\n");
+        init_magneto_ellipsoid_fit(&fit);
+        if (!set_magneto_hard_iron_offsets(lsm, calibration->magneto_offsets))
+        {
+            fprintf(stderr, "ERROR: FAILED TO SET MAGNETO HARD IRON OFFSETS!\n");
+            return false;
+        }
+        sample_count = get_samples_per_duration((float)get_lsm9ds0_sample_rate(lsm), MAGNETO_CALIBRATION_DURATION, UINT32_MAX);
+        for (i = 0; i < sample_count; i++)
+        {
+            if (!(acquire_calibration_sample(lsm, &samples) && add_sample_to_magneto_ellipsoid_fit(&fit, &samples, 0)))
             {
-                fprintf(stderr, "ERROR: FAILED TO CHECK FOR GYRO SIGNAL READING AVAILABILITY!\n");
+                fprintf(stderr, "ERROR: FAILED TO OBTAIN MAGNETO CALIBRATION READINGS!\n");
+                return false;
             }
         }
+        if (!compute_magneto_ellipsoid_fit(&fit, calibration))
+        {
+            fprintf(stderr, "ERROR: FAILED TO CALIBRATE MAGNETO, THE READINGS DID NOT DESCRIBE AN ELLIPSOID (ROTATE THROUGH MORE ORIENTATIONS)!\n");
+            return false;
+        }
+        printf("Magneto hard iron (raw): %d, %d, %d\n", calibration->magneto_offsets[0], calibration->magneto_offsets[1], calibration->magneto_offsets[2]);
+    }
+
+    //persist a new calibration
+    if ((options->calibrate_gyro || options->calibrate_magneto) && (calibration_file != NULL) && (!save_imu_calibration(calibration, calibration_file)))
+    {
+        return false;
+    }
+
+    //the sensor subtracts the hard iron from every reading from here on
+    if (!set_magneto_hard_iron_offsets(lsm, calibration->magneto_offsets))
+    {
+        fprintf(stderr, "ERROR: FAILED TO SET MAGNETO HARD IRON OFFSETS!\n");
+        return false;
     }
+
+    return true;
+}
+
+//function definition
+//acquire the latest raw readings as the only sample in a batch (for calibration, so untimed)
+static bool acquire_calibration_sample(LSM9DS0* lsm, SAMPLE_BATCH* samples)
+{
+    //local vars
+    LSM9DS0_RAW_SIGNAL_READING_AGGREGATE raw_signal_reading_aggregate;
+
+    clear_sample_batch(samples);
+    poll_for_signal_readings(lsm);
+
+    return get_latest_raw_signal_reading(lsm, ACCEL, &(raw_signal_reading_aggregate.accel)) &&
+           get_latest_raw_signal_reading(lsm, MAGNETO, &(raw_signal_reading_aggregate.magneto)) &&
+           get_latest_raw_signal_reading(lsm, GYRO, &(raw_signal_reading_aggregate.gyro)) &&
+           append_lsm9ds0_raw_signal_reading_aggregate_to_sample_batch(&raw_signal_reading_aggregate, samples, 0);
 }
 
 //function definition
-//convert a lsm9ds0 signal reading aggregate object to a telemetry reading object
-static bool convert_lsm9ds0_signal_reading_aggregate_to_telemetry_reading(LSM9DS0_SIGNAL_READING_AGGREGATE* signal_reading_aggregate, TELEMETRY_READING* telemetry, int sequence_id)
+//get the offset that maps CLOCK_MONOTONIC to wall clock (CLOCK_REALTIME) time, in nanoseconds
+static int64_t get_wall_clock_offset(void)
 {
     //local vars
+    struct timespec wall_clock_time;
+    struct timespec monotonic_time;
+
+    //sample both clocks back to back
+    clock_gettime(CLOCK_REALTIME, &wall_clock_time);
+    clock_gettime(CLOCK_MONOTONIC, &monotonic_time);
+
+    return (((int64_t)wall_clock_time.tv_sec - monotonic_time.tv_sec) * 1000000000) + (wall_clock_time.tv_nsec - monotonic_time.tv_nsec);
+}
+
+//function definition
+//add a lsm9ds0 raw signal reading aggregate onto the end of a sample batch
+static bool append_lsm9ds0_raw_signal_reading_aggregate_to_sample_batch(LSM9DS0_RAW_SIGNAL_READING_AGGREGATE* raw_signal_reading_aggregate, SAMPLE_BATCH* samples, int64_t wall_clock_offset_ns)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+
+    //check inputs
+    if ((raw_signal_reading_aggregate != NULL) && (samples != NULL))
+    {
+        //raw readings in sample batch axis order
+        values[SAMPLE_ACCEL_X] = raw_signal_reading_aggregate->accel.x;
+        values[SAMPLE_ACCEL_Y] = raw_signal_reading_aggregate->accel.y;
+        values[SAMPLE_ACCEL_Z] = raw_signal_reading_aggregate->accel.z;
+        values[SAMPLE_MAGNETO_X] = raw_signal_reading_aggregate->magneto.x;
+        values[SAMPLE_MAGNETO_Y] = raw_signal_reading_aggregate->magneto.y;
+        values[SAMPLE_MAGNETO_Z] = raw_signal_reading_aggregate->magneto.z;
+        values[SAMPLE_GYRO_X] = raw_signal_reading_aggregate->gyro.x;
+        values[SAMPLE_GYRO_Y] = raw_signal_reading_aggregate->gyro.y;
+        values[SAMPLE_GYRO_Z] = raw_signal_reading_aggregate->gyro.z;
+
+        //the sample is stamped with the wall clock time the accelerometer was read (the first sensor read for the aggregate)
+        return append_sample_to_sample_batch(samples, raw_signal_reading_aggregate->accel.timestamp_ns + wall_clock_offset_ns, values);
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//convert a sample (by its index in a sample batch) to a telemetry reading object
+static bool convert_sample_to_telemetry_reading(SAMPLE_BATCH* samples, uint32_t sample_index, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index, int sequence_id)
+{
+    //local vars
+    const float* columns[SAMPLE_BATCH_AXIS_COUNT];  //scaled values, per axis
+    int64_t timestamp_ns;                   //wall clock time the reading was acquired (nanoseconds since unix epoch)
     time_t timestamp;                       //number of seconds since unix epoch
-    struct tm* decomposed_timestamp;        //timestamp value broken up into a tm structure
+    struct tm decomposed_timestamp;         //timestamp value broken up into a tm structure
     char timestamp_string[25];              //formatted string version of the timestamp
+    int json_size;
+    uint32_t axis;
 
     //check inputs
-    if ((signal_reading_aggregate != NULL) && (telemetry != NULL))
+    if ((samples != NULL) && (sample_index < samples->sample_count) && (telemetry != NULL))
     {
-        //generate & format timestamp
-        time(&timestamp);                                                   //get current time (number of seconds since unix epoch)
-        decomposed_timestamp = gmtime(&timestamp);                          //broken down time into tm structure
-        strftime(timestamp_string, 25, "%F %T", decomposed_timestamp);      //format broken down time as 'yyyy-mm-dd hh:mm:ss'
+        //get the scaled columns (scales any samples added since they were last asked for)
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            columns[axis] = get_scaled_sample_batch_column(samples, axis);
+        }
+
+        timestamp_ns = samples->timestamps_ns[sample_index];
+
+        //format timestamp
+        timestamp = (time_t)(timestamp_ns / 1000000000);                    //whole seconds since unix epoch
+        gmtime_r(&timestamp, &decomposed_timestamp);                        //broken down time into tm structure
+        strftime(timestamp_string, 25, "%F %T", &decomposed_timestamp);     //format broken down time as 'yyyy-mm-dd hh:mm:ss'
 
         //generate json formatted payload
-        sprintf(telemetry->json,
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
                 "{"
-                "\"device_id\":\"edison_alva1\","
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
                 "\"sequence_id\":%d,"
                 "\"timestamp\":\"%s\","
+                "\"timestamp_ns\":%lld,"
                 "\"accel\":"
                     "{"
                       "\"x\":%f,"
@@ -201,21 +1020,367 @@ static bool convert_lsm9ds0_signal_reading_aggregate_to_telemetry_reading(LSM9DS
                       "\"z\":%f"
                     "}"
                 "}",
+                device_id,
+                device_index,
                 sequence_id,
                 timestamp_string,
-                signal_reading_aggregate->accel.x,
-                signal_reading_aggregate->accel.y,
-                signal_reading_aggregate->accel.z,
-                signal_reading_aggregate->magneto.x,
-                signal_reading_aggregate->magneto.y,
-                signal_reading_aggregate->magneto.z,
-                signal_reading_aggregate->gyro.x,
-                signal_reading_aggregate->gyro.y,
-                signal_reading_aggregate->gyro.z
+                (long long)timestamp_ns,
+                columns[SAMPLE_ACCEL_X][sample_index],
+                columns[SAMPLE_ACCEL_Y][sample_index],
+                columns[SAMPLE_ACCEL_Z][sample_index],
+                columns[SAMPLE_MAGNETO_X][sample_index],
+                columns[SAMPLE_MAGNETO_Y][sample_index],
+                columns[SAMPLE_MAGNETO_Z][sample_index],
+                columns[SAMPLE_GYRO_X][sample_index],
+                columns[SAMPLE_GYRO_Y][sample_index],
+                columns[SAMPLE_GYRO_Z][sample_index]
         );
 
-        //success
-        return true;
+        //if the reading fit in its buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//convert one sensor's statistics from a window summary (sensors in raw sample order: 0 = accel, 1 = magneto, 2 = gyro) to a telemetry reading object
+static bool convert_window_summary_to_telemetry_reading(WINDOW_SUMMARY* summary, uint32_t sensor_index, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index)
+{
+    //local vars
+    static const char* const sensor_names[] = {"accel", "magneto", "gyro"};
+    const WINDOW_AXIS_SUMMARY* axes;
+    int json_size;
+
+    //check inputs
+    if ((summary != NULL) && (sensor_index < 3) && (telemetry != NULL))
+    {
+        axes = &(summary->axes[sensor_index * 3]);
+
+        //generate json formatted payload
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"window_id\":%u,"
+                "\"window\":\"%s\","
+                "\"sensor\":\"%s\","
+                "\"sample_count\":%u,"
+                "\"start_timestamp_ns\":%lld,"
+                "\"end_timestamp_ns\":%lld,"
+                "\"x\":{\"mean\":%f,\"min\":%f,\"max\":%f,\"rms\":%f,\"variance\":%f,\"peak_to_peak\":%f},"
+                "\"y\":{\"mean\":%f,\"min\":%f,\"max\":%f,\"rms\":%f,\"variance\":%f,\"peak_to_peak\":%f},"
+                "\"z\":{\"mean\":%f,\"min\":%f,\"max\":%f,\"rms\":%f,\"variance\":%f,\"peak_to_peak\":%f}"
+                "}",
+                device_id,
+                device_index,
+                summary->window_id,
+                (summary->type == SLIDING_WINDOW) ? "sliding" : "tumbling",
+                sensor_names[sensor_index],
+                summary->sample_count,
+                (long long)summary->start_timestamp_ns,
+                (long long)summary->end_timestamp_ns,
+                axes[0].mean, axes[0].min, axes[0].max, axes[0].rms, axes[0].variance, axes[0].peak_to_peak,
+                axes[1].mean, axes[1].min, axes[1].max, axes[1].rms, axes[1].variance, axes[1].peak_to_peak,
+                axes[2].mean, axes[2].min, axes[2].max, axes[2].rms, axes[2].variance, axes[2].peak_to_peak
+        );
+
+        //if the summary fit in its buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//convert an orientation to a telemetry reading object (tagged with the sequence id of the latest reading fused)
+static bool convert_ahrs_orientation_to_telemetry_reading(AHRS_ORIENTATION* orientation, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index, int sequence_id)
+{
+    //local vars
+    int json_size;
+
+    //check inputs
+    if ((orientation != NULL) && (telemetry != NULL))
+    {
+        //generate json formatted payload
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"sequence_id\":%d,"
+                "\"timestamp_ns\":%lld,"
+                "\"orientation\":"
+                    "{"
+                      "\"w\":%f,"
+                      "\"x\":%f,"
+                      "\"y\":%f,"
+                      "\"z\":%f,"
+                      "\"roll\":%f,"
+                      "\"pitch\":%f,"
+                      "\"yaw\":%f"
+                    "}"
+                "}",
+                device_id,
+                device_index,
+                sequence_id,
+                (long long)orientation->timestamp_ns,
+                orientation->quaternion[0],
+                orientation->quaternion[1],
+                orientation->quaternion[2],
+                orientation->quaternion[3],
+                orientation->roll,
+                orientation->pitch,
+                orientation->yaw
+        );
+
+        //if the orientation fit in its buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get the number of samples (at least 1, at most the max) spanning a duration (seconds) at a rate (hz)
+static uint32_t get_samples_per_duration(float rate_hz, float duration, uint32_t max_samples)
+{
+    //local vars
+    float samples = rate_hz * duration;
+
+    if (samples < 1.0f)
+    {
+        return 1;
+    }
+
+    return (samples >= (float)max_samples) ? max_samples : (uint32_t)(samples + 0.5f);
+}
+
+//function definition
+//move the event detector's history (the samples leading up to an event, ending with the one that started it) into the batch's samples in place of
+//the sample that started the event, encoding every reading but that one (which is encoded as the latest reading) and publishing the batch each time
+//it fills, returns the index of the latest reading
+static uint32_t move_event_history_to_telemetry_batch(LSM9DS0_SAT_SCHEDULER* scheduler, LSM9DS0_SAT_PIPELINE* pipeline)
+{
+    //local vars
+    TELEMETRY_READING telemetry;
+    TELEMETRY_BATCH* batch = &(pipeline->batch);
+    EVENT_DETECTOR* detector = &(pipeline->detector);
+    int64_t wall_clock_offset_ns = batch->wall_clock_offset_ns;    //the history was stamped using it, keep it for every batch the history spans
+    int history_sequence_id;                //sequence id of the oldest reading in the history
+    uint32_t used_count;
+    uint32_t moved_count;
+    uint32_t i;
+
+    //readings aren't published between events, so the sample that started this one is the only sample in the batch (its copy ends the history)
+    clear_sample_batch(&(batch->samples));
+    history_sequence_id = pipeline->sequence_id - (int)(detector->history_count - 1);
+
+    while (detector->history_count > 0)
+    {
+        //publish the batch once it is full
+        if ((batch->reading_count >= pipeline->batch_size) || (batch->samples.sample_count >= pipeline->batch_size))
+        {
+            publish_lsm9ds0_sat_batch(scheduler, batch);
+            clear_telemetry_batch(batch);
+            batch->wall_clock_offset_ns = wall_clock_offset_ns;
+        }
+
+        //fill the rest of the batch from the history, encoding the readings that came before the one that started the event
+        used_count = (batch->reading_count > batch->samples.sample_count) ? batch->reading_count : batch->samples.sample_count;
+        moved_count = move_event_detector_history_to_sample_batch(detector, &(batch->samples), pipeline->batch_size - used_count);
+        for (i = batch->samples.sample_count - moved_count; i < batch->samples.sample_count; i++, history_sequence_id++)
+        {
+            if (history_sequence_id != pipeline->sequence_id)
+            {
+                add_sequence_id_to_lsm9ds0_sat_batch(batch, history_sequence_id);
+                if (convert_sample_to_telemetry_reading(&(batch->samples), i, &telemetry, scheduler->options->device_id, pipeline->device_index, history_sequence_id))
+                {
+                    append_reading_to_lsm9ds0_sat_batch(batch, &telemetry, history_sequence_id);
+                }
+                else
+                {
+                    fprintf(stderr, "ERROR: FAILED TO CONVERT SAMPLE TO TELEMETRY READING!\n");
+                    record_telemetry_loss(&(batch->header.loss), TELEMETRY_LOSS_ENCODE_FAILURE, history_sequence_id, history_sequence_id, 1);
+                }
+            }
+        }
+    }
+
+    return batch->samples.sample_count - 1;
+}
+
+//function definition
+//convert the start or end of an event to a telemetry reading object (tagged with the sequence id of the reading that started or ended it)
+static bool convert_event_transition_to_telemetry_reading(EVENT_DETECTOR* detector, EVENT_TRANSITION transition, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index, int sequence_id)
+{
+    //local vars
+    int json_size;
+
+    //check inputs
+    if ((detector != NULL) && (transition != NO_EVENT_TRANSITION) && (telemetry != NULL))
+    {
+        //generate json formatted payload
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"sequence_id\":%d,"
+                "\"event\":"
+                    "{"
+                      "\"state\":\"%s\","
+                      "\"event_id\":%u,"
+                      "\"start_timestamp_ns\":%lld,"
+                      "\"sample_count\":%u,"
+                      "\"threshold\":%s,"
+                      "\"baseline\":%s,"
+                      "\"zscore\":%s,"
+                      "\"hardware\":%s"
+                    "}"
+                "}",
+                device_id,
+                device_index,
+                sequence_id,
+                (transition == EVENT_STARTED) ? "start" : "end",
+                detector->event_count,
+                (long long)detector->event_start_timestamp_ns,
+                detector->event_sample_count,
+                ((detector->event_detections & THRESHOLD_EVENT_DETECTOR) != 0) ? "true" : "false",
+                ((detector->event_detections & BASELINE_EVENT_DETECTOR) != 0) ? "true" : "false",
+                ((detector->event_detections & ZSCORE_EVENT_DETECTOR) != 0) ? "true" : "false",
+                ((detector->event_detections & HARDWARE_EVENT_DETECTOR) != 0) ? "true" : "false"
+        );
+
+        //if the event fit in its buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//convert a heartbeat to a telemetry reading object (tagged with the sequence id of the latest reading)
+static bool convert_event_heartbeat_to_telemetry_reading(EVENT_HEARTBEAT* heartbeat, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index, int sequence_id)
+{
+    //local vars
+    int json_size;
+
+    //check inputs
+    if ((heartbeat != NULL) && (telemetry != NULL))
+    {
+        //generate json formatted payload
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"sequence_id\":%d,"
+                "\"timestamp_ns\":%lld,"
+                "\"heartbeat\":"
+                    "{"
+                      "\"sample_count\":%u,"
+                      "\"event_count\":%u,"
+                      "\"event_active\":%s,"
+                      "\"accel_magnitude\":{\"mean\":%f,\"max\":%f},"
+                      "\"gyro_magnitude\":{\"max\":%f}"
+                    "}"
+                "}",
+                device_id,
+                device_index,
+                sequence_id,
+                (long long)heartbeat->timestamp_ns,
+                heartbeat->sample_count,
+                heartbeat->event_count,
+                heartbeat->event_active ? "true" : "false",
+                heartbeat->accel_magnitude_mean,
+                heartbeat->accel_magnitude_max,
+                heartbeat->gyro_magnitude_max
+        );
+
+        //if the heartbeat fit in its buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//convert one accelerometer axis' spectral features (0 = x, 1 = y, 2 = z) to a telemetry reading object
+static bool convert_spectral_features_to_telemetry_reading(SPECTRAL_FEATURES* features, uint32_t axis, TELEMETRY_READING* telemetry, const char* device_id, uint32_t device_index)
+{
+    //local vars
+    static const char* const axis_names[] = {"x", "y", "z"};
+    const SPECTRAL_AXIS_FEATURES* axis_features;
+    int json_size;
+
+    //check inputs
+    if ((features != NULL) && (axis < SPECTRAL_AXIS_COUNT) && (telemetry != NULL))
+    {
+        axis_features = &(features->axes[axis]);
+
+        //generate json formatted payload (band energies from dc up, each band_width_hz wide)
+        json_size = snprintf(telemetry->json, sizeof (telemetry->json),
+                "{"
+                "\"device_id\":\"%s\","
+                "\"device_index\":%u,"
+                "\"spectrum_id\":%u,"
+                "\"sensor\":\"accel\","
+                "\"axis\":\"%s\","
+                "\"sample_count\":%u,"
+                "\"sample_rate_hz\":%g,"
+                "\"start_timestamp_ns\":%lld,"
+                "\"end_timestamp_ns\":%lld,"
+                "\"rms\":%g,"
+                "\"dominant_hz\":%g,"
+                "\"dominant_amplitude\":%g,"
+                "\"band_width_hz\":%g,"
+                "\"band_energies\":[%g,%g,%g,%g,%g,%g,%g,%g]"
+                "}",
+                device_id,
+                device_index,
+                features->spectrum_id,
+                axis_names[axis],
+                features->sample_count,
+                features->sample_rate_hz,
+                (long long)features->start_timestamp_ns,
+                (long long)features->end_timestamp_ns,
+                axis_features->rms,
+                axis_features->dominant_frequency_hz,
+                axis_features->dominant_amplitude,
+                features->band_width_hz,
+                axis_features->band_energies[0], axis_features->band_energies[1], axis_features->band_energies[2], axis_features->band_energies[3],
+                axis_features->band_energies[4], axis_features->band_energies[5], axis_features->band_energies[6], axis_features->band_energies[7]
+        );
+
+        //if the features fit in their buffer
+        if ((json_size > 0) && ((size_t)json_size < sizeof (telemetry->json)))
+        {
+            //success
+            return true;
+        }
     }
 
     //failure
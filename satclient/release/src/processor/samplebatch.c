@@ -0,0 +1,191 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include "samplebatch.h"
+
+//function declarations
+static void scale_sample_batch(SAMPLE_BATCH*);
+static void scale_corrected_sensor(SAMPLE_BATCH*, uint32_t);
+
+//function definition
+//empty a batch so it can be refilled (scale factors are left as they are)
+void clear_sample_batch(SAMPLE_BATCH* batch)
+{
+    //check input
+    if (batch != NULL)
+    {
+        batch->sample_count = 0;
+        batch->scaled_sample_count = 0;
+    }
+}
+
+//function definition
+//set the scale factors applied to each sensor's axes, removing any corrections (any scaled values are recomputed when next asked for)
+void set_sample_batch_scale_factors(SAMPLE_BATCH* batch, double accel_scale_factor, double magneto_scale_factor, double gyro_scale_factor)
+{
+    //local vars
+    uint32_t i;
+
+    //check input
+    if (batch != NULL)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            batch->scale_factors[SAMPLE_ACCEL_X + i] = accel_scale_factor;
+            batch->scale_factors[SAMPLE_MAGNETO_X + i] = magneto_scale_factor;
+            batch->scale_factors[SAMPLE_GYRO_X + i] = gyro_scale_factor;
+        }
+        for (i = 0; i < SAMPLE_BATCH_SENSOR_COUNT; i++)
+        {
+            batch->corrected[i] = false;
+        }
+
+        batch->scaled_sample_count = 0;
+    }
+}
+
+//function definition
+//set the correction applied to a sensor's (by its first axis) raw xyz values before they're scaled - a 3x3 matrix, then an offset (raw units)
+//(NULL for either leaves that part out, NULL for both removes the correction), any scaled values are recomputed when next asked for
+bool set_sample_batch_correction(SAMPLE_BATCH* batch, SAMPLE_BATCH_AXIS first_axis, const float (*matrix)[3], const float* offsets)
+{
+    //local vars
+    uint32_t sensor;
+    uint32_t row;
+    uint32_t column;
+
+    //check inputs
+    if ((batch != NULL) && ((first_axis == SAMPLE_ACCEL_X) || (first_axis == SAMPLE_MAGNETO_X) || (first_axis == SAMPLE_GYRO_X)))
+    {
+        sensor = first_axis / 3;
+        for (row = 0; row < 3; row++)
+        {
+            for (column = 0; column < 3; column++)
+            {
+                batch->correction_matrices[sensor][row][column] = (matrix != NULL) ? matrix[row][column] : ((row == column) ? 1.0f : 0.0f);
+            }
+            batch->correction_offsets[sensor][row] = (offsets != NULL) ? offsets[row] : 0.0f;
+        }
+        batch->corrected[sensor] = ((matrix != NULL) || (offsets != NULL));
+
+        batch->scaled_sample_count = 0;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add a sample (raw values in axis order) onto the end of a batch
+bool append_sample_to_sample_batch(SAMPLE_BATCH* batch, int64_t timestamp_ns, const int16_t* values)
+{
+    //local vars
+    uint32_t axis;
+
+    //check inputs
+    if ((batch != NULL) && (values != NULL) && (batch->sample_count < SAMPLE_BATCH_MAX_SAMPLES))
+    {
+        batch->timestamps_ns[batch->sample_count] = timestamp_ns;
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            batch->raw[axis][batch->sample_count] = values[axis];
+        }
+        batch->sample_count++;
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//get an axis' scaled values (sample_count floats long, valid until the batch is next modified)
+const float* get_scaled_sample_batch_column(SAMPLE_BATCH* batch, SAMPLE_BATCH_AXIS axis)
+{
+    //check input
+    if ((batch != NULL) && (axis < SAMPLE_BATCH_AXIS_COUNT))
+    {
+        //bring every column up to date (they're appended to together, so they're scaled together)
+        scale_sample_batch(batch);
+
+        return batch->scaled[axis];
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//scale the samples appended since the batch was last scaled
+//(a single float multiply per value for uncorrected sensors, so the results match the raw signal conversion kernels bit for bit)
+static void scale_sample_batch(SAMPLE_BATCH* batch)
+{
+    //local vars
+    float scale_factor;
+    uint32_t axis;
+    uint32_t i;
+
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        //corrected sensors are scaled all 3 axes at once (from their first axis)
+        if (batch->corrected[axis / 3])
+        {
+            if ((axis % 3) == 0)
+            {
+                scale_corrected_sensor(batch, axis / 3);
+            }
+            continue;
+        }
+
+        scale_factor = (float)batch->scale_factors[axis];
+
+        for (i = batch->scaled_sample_count; i < batch->sample_count; i++)
+        {
+            batch->scaled[axis][i] = (float)batch->raw[axis][i] * scale_factor;
+        }
+    }
+
+    batch->scaled_sample_count = batch->sample_count;
+}
+
+//function definition
+//scale a corrected sensor's samples appended since the batch was last scaled, with its correction fused into its scale factors
+//(a 3x3 matrix multiply-add per sample, over the columns, so it vectorizes like the plain scaling)
+static void scale_corrected_sensor(SAMPLE_BATCH* batch, uint32_t sensor)
+{
+    //local vars
+    const int16_t* x = batch->raw[sensor * 3];
+    const int16_t* y = batch->raw[(sensor * 3) + 1];
+    const int16_t* z = batch->raw[(sensor * 3) + 2];
+    float matrix[3][3];
+    float offsets[3];
+    uint32_t row;
+    uint32_t column;
+    uint32_t i;
+
+    //fold each output axis' scale factor into its row of the correction
+    for (row = 0; row < 3; row++)
+    {
+        for (column = 0; column < 3; column++)
+        {
+            matrix[row][column] = (float)(batch->correction_matrices[sensor][row][column] * batch->scale_factors[(sensor * 3) + row]);
+        }
+        offsets[row] = (float)(batch->correction_offsets[sensor][row] * batch->scale_factors[(sensor * 3) + row]);
+    }
+
+    for (row = 0; row < 3; row++)
+    {
+        for (i = batch->scaled_sample_count; i < batch->sample_count; i++)
+        {
+            batch->scaled[(sensor * 3) + row][i] = (matrix[row][0] * (float)x[i]) + (matrix[row][1] * (float)y[i]) + (matrix[row][2] * (float)z[i]) + offsets[row];
+        }
+    }
+}
@@ -0,0 +1,356 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include <math.h>               //using for "cos", "sin", and "sqrtf" functions
+#include "spectralanalyzer.h"
+
+//the butterflies have a vectorized kernel where the instruction set is always available (sse2 on x86-64, neon on aarch64)
+#if defined(__SSE2__)
+    #define SSE2_BUTTERFLY_KERNEL
+    #include <emmintrin.h>      //using for sse2 intrinsics
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define NEON_BUTTERFLY_KERNEL
+    #include <arm_neon.h>       //using for neon intrinsics
+#endif
+
+//global vars
+static const double PI = 3.14159265358979323846;
+
+//function declarations
+static void compute_spectral_features(SPECTRAL_ANALYZER*, SPECTRAL_FEATURES*);
+static void compute_axis_power_spectrum(SPECTRAL_ANALYZER*, uint32_t);
+static void run_butterflies(float*, float*, const float*, const float*, uint32_t);
+static void extract_axis_features(SPECTRAL_ANALYZER*, uint32_t, SPECTRAL_AXIS_FEATURES*);
+
+//function definition
+//init the analyzer (empty history), computing its tables for a window length (a power of two) and the sample rate (hz)
+bool init_spectral_analyzer(SPECTRAL_ANALYZER* analyzer, uint32_t length, uint32_t hop, float sample_rate_hz)
+{
+    //local vars
+    uint32_t half_length;
+    uint32_t bit_count = 0;
+    uint32_t reversed;
+    uint32_t h;
+    uint32_t i;
+    uint32_t j;
+
+    //check inputs
+    if ((analyzer != NULL) && (length >= SPECTRAL_ANALYZER_MIN_LENGTH) && (length <= SPECTRAL_ANALYZER_MAX_LENGTH) && ((length & (length - 1)) == 0) &&
+        (hop > 0) && (hop <= length) && (sample_rate_hz > 0.0f))
+    {
+        analyzer->length = length;
+        analyzer->hop = hop;
+        analyzer->sample_rate_hz = sample_rate_hz;
+        analyzer->position = 0;
+        analyzer->count = 0;
+        analyzer->samples_since_spectrum = 0;
+        analyzer->spectrum_count = 0;
+        half_length = length / 2;
+
+        //hann window (periodic, so it tiles without a gap)
+        analyzer->window_sum = 0.0f;
+        analyzer->window_square_sum = 0.0f;
+        for (i = 0; i < length; i++)
+        {
+            analyzer->window[i] = (float)(0.5 - (0.5 * cos((2.0 * PI * i) / length)));
+            analyzer->window_sum += analyzer->window[i];
+            analyzer->window_square_sum += analyzer->window[i] * analyzer->window[i];
+        }
+
+        //bit reversal permutation of the half length fft's inputs
+        while ((1u << bit_count) < half_length)
+        {
+            bit_count++;
+        }
+        for (i = 0; i < half_length; i++)
+        {
+            reversed = 0;
+            for (j = 0; j < bit_count; j++)
+            {
+                reversed |= ((i >> j) & 1) << (bit_count - 1 - j);
+            }
+            analyzer->bit_reversal[i] = (uint16_t)reversed;
+        }
+
+        //twiddles of each stage (e^(-i*pi*j/h) for its h butterflies per group), stored from index h so each stage's are contiguous
+        for (h = 1; h < half_length; h *= 2)
+        {
+            for (j = 0; j < h; j++)
+            {
+                analyzer->stage_twiddles[0][h + j] = (float)cos((-PI * j) / h);
+                analyzer->stage_twiddles[1][h + j] = (float)sin((-PI * j) / h);
+            }
+        }
+
+        //twiddles splitting the half length fft into the real spectrum (e^(-2*i*pi*k/length))
+        for (i = 0; i < half_length; i++)
+        {
+            analyzer->split_twiddles[0][i] = (float)cos((-2.0 * PI * i) / length);
+            analyzer->split_twiddles[1][i] = (float)sin((-2.0 * PI * i) / length);
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add a sample (by its index in a batch) to the history, rendering the features of the window ending with it every hop samples (once the history is full)
+bool add_sample_to_spectral_analyzer(SPECTRAL_ANALYZER* analyzer, const SAMPLE_BATCH* batch, uint32_t sample_index, SPECTRAL_FEATURES* features, bool* features_availability)
+{
+    //local vars
+    uint32_t axis;
+
+    //check inputs
+    if ((analyzer != NULL) && (batch != NULL) && (sample_index < batch->sample_count) && (features != NULL) && (features_availability != NULL))
+    {
+        //keep the accelerometer values (raw, the features are scaled once they're computed)
+        for (axis = 0; axis < SPECTRAL_AXIS_COUNT; axis++)
+        {
+            analyzer->history[axis][analyzer->position] = batch->raw[SAMPLE_ACCEL_X + axis][sample_index];
+            analyzer->scale_factors[axis] = batch->scale_factors[SAMPLE_ACCEL_X + axis];
+        }
+        analyzer->timestamps_ns[analyzer->position] = batch->timestamps_ns[sample_index];
+        analyzer->position = (analyzer->position + 1) & (analyzer->length - 1);
+        analyzer->count += (analyzer->count < analyzer->length) ? 1 : 0;
+        analyzer->samples_since_spectrum++;
+
+        //compute the features every hop samples, once there is a full window
+        *features_availability = false;
+        if ((analyzer->count == analyzer->length) && (analyzer->samples_since_spectrum >= analyzer->hop))
+        {
+            compute_spectral_features(analyzer, features);
+            analyzer->samples_since_spectrum = 0;
+            analyzer->spectrum_count++;
+            *features_availability = true;
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//compute the features of the window in the history (the history is full, so the oldest sample is at the write position)
+static void compute_spectral_features(SPECTRAL_ANALYZER* analyzer, SPECTRAL_FEATURES* features)
+{
+    //local vars
+    uint32_t axis;
+
+    features->spectrum_id = analyzer->spectrum_count;
+    features->sample_count = analyzer->length;
+    features->sample_rate_hz = analyzer->sample_rate_hz;
+    features->band_width_hz = (analyzer->sample_rate_hz / 2.0f) / SPECTRAL_BAND_COUNT;
+    features->start_timestamp_ns = analyzer->timestamps_ns[analyzer->position];
+    features->end_timestamp_ns = analyzer->timestamps_ns[(analyzer->position + analyzer->length - 1) & (analyzer->length - 1)];
+
+    for (axis = 0; axis < SPECTRAL_AXIS_COUNT; axis++)
+    {
+        compute_axis_power_spectrum(analyzer, axis);
+        extract_axis_features(analyzer, axis, &(features->axes[axis]));
+    }
+}
+
+//function definition
+//compute an axis' power spectrum (mean square per bin, in g^2) into the analyzer's power array
+static void compute_axis_power_spectrum(SPECTRAL_ANALYZER* analyzer, uint32_t axis)
+{
+    //local vars
+    const int16_t* history = analyzer->history[axis];
+    float* real = analyzer->work[0];
+    float* imaginary = analyzer->work[1];
+    uint32_t half_length = analyzer->length / 2;
+    uint32_t mask = analyzer->length - 1;
+    uint32_t oldest = analyzer->position;
+    int32_t sum = 0;
+    float mean;
+    float normalization;
+    float even_real;
+    float even_imaginary;
+    float odd_real;
+    float odd_imaginary;
+    float spectrum_real;
+    float spectrum_imaginary;
+    uint32_t start;
+    uint32_t h;
+    uint32_t i;
+    uint32_t k;
+
+    //remove the mean (gravity, and any offset)
+    for (i = 0; i < analyzer->length; i++)
+    {
+        sum += history[i];
+    }
+    mean = (float)sum / analyzer->length;
+
+    //pack the windowed samples as half as many complex values (even samples real, odd samples imaginary), in bit reversed order
+    for (i = 0; i < half_length; i++)
+    {
+        real[analyzer->bit_reversal[i]] = ((float)history[(oldest + (2 * i)) & mask] - mean) * analyzer->window[2 * i];
+        imaginary[analyzer->bit_reversal[i]] = ((float)history[(oldest + (2 * i) + 1) & mask] - mean) * analyzer->window[(2 * i) + 1];
+    }
+
+    //radix 2 decimation in time fft, in place
+    for (h = 1; h < half_length; h *= 2)
+    {
+        for (start = 0; start < half_length; start += 2 * h)
+        {
+            run_butterflies(&(real[start]), &(imaginary[start]), &(analyzer->stage_twiddles[0][h]), &(analyzer->stage_twiddles[1][h]), h);
+        }
+    }
+
+    //split into the spectrum of the real samples, as mean square per bin (one sided, so every bin but dc and nyquist is doubled)
+    //scaled from raw units to g^2, and by the window's power gain
+    normalization = (float)(analyzer->scale_factors[axis] * analyzer->scale_factors[axis]) / ((float)analyzer->length * analyzer->window_square_sum);
+    analyzer->power[0] = (real[0] + imaginary[0]) * (real[0] + imaginary[0]) * normalization;
+    analyzer->power[half_length] = (real[0] - imaginary[0]) * (real[0] - imaginary[0]) * normalization;
+    for (k = 1; k < half_length; k++)
+    {
+        //spectra of the even and odd samples
+        even_real = 0.5f * (real[k] + real[half_length - k]);
+        even_imaginary = 0.5f * (imaginary[k] - imaginary[half_length - k]);
+        odd_real = 0.5f * (imaginary[k] + imaginary[half_length - k]);
+        odd_imaginary = -0.5f * (real[k] - real[half_length - k]);
+
+        //combined, the odd samples shifted by the split twiddle
+        spectrum_real = even_real + (analyzer->split_twiddles[0][k] * odd_real) - (analyzer->split_twiddles[1][k] * odd_imaginary);
+        spectrum_imaginary = even_imaginary + (analyzer->split_twiddles[0][k] * odd_imaginary) + (analyzer->split_twiddles[1][k] * odd_real);
+
+        analyzer->power[k] = 2.0f * ((spectrum_real * spectrum_real) + (spectrum_imaginary * spectrum_imaginary)) * normalization;
+    }
+}
+
+//function definition
+//run the h butterflies of a group (the first half of the group combined with the second half, shifted by the stage's twiddles)
+static void run_butterflies(float* real, float* imaginary, const float* twiddle_real, const float* twiddle_imaginary, uint32_t h)
+{
+    //local vars
+    uint32_t j = 0;
+    float product_real;
+    float product_imaginary;
+#if defined(SSE2_BUTTERFLY_KERNEL)
+    __m128 vector_twiddle_real;
+    __m128 vector_twiddle_imaginary;
+    __m128 vector_real;
+    __m128 vector_imaginary;
+    __m128 vector_product_real;
+    __m128 vector_product_imaginary;
+
+    //4 butterflies at a time
+    for (; (j + 4) <= h; j += 4)
+    {
+        vector_twiddle_real = _mm_loadu_ps(&(twiddle_real[j]));
+        vector_twiddle_imaginary = _mm_loadu_ps(&(twiddle_imaginary[j]));
+        vector_real = _mm_loadu_ps(&(real[j + h]));
+        vector_imaginary = _mm_loadu_ps(&(imaginary[j + h]));
+        vector_product_real = _mm_sub_ps(_mm_mul_ps(vector_real, vector_twiddle_real), _mm_mul_ps(vector_imaginary, vector_twiddle_imaginary));
+        vector_product_imaginary = _mm_add_ps(_mm_mul_ps(vector_real, vector_twiddle_imaginary), _mm_mul_ps(vector_imaginary, vector_twiddle_real));
+        vector_real = _mm_loadu_ps(&(real[j]));
+        vector_imaginary = _mm_loadu_ps(&(imaginary[j]));
+        _mm_storeu_ps(&(real[j]), _mm_add_ps(vector_real, vector_product_real));
+        _mm_storeu_ps(&(imaginary[j]), _mm_add_ps(vector_imaginary, vector_product_imaginary));
+        _mm_storeu_ps(&(real[j + h]), _mm_sub_ps(vector_real, vector_product_real));
+        _mm_storeu_ps(&(imaginary[j + h]), _mm_sub_ps(vector_imaginary, vector_product_imaginary));
+    }
+#elif defined(NEON_BUTTERFLY_KERNEL)
+    float32x4_t vector_twiddle_real;
+    float32x4_t vector_twiddle_imaginary;
+    float32x4_t vector_real;
+    float32x4_t vector_imaginary;
+    float32x4_t vector_product_real;
+    float32x4_t vector_product_imaginary;
+
+    //4 butterflies at a time
+    for (; (j + 4) <= h; j += 4)
+    {
+        vector_twiddle_real = vld1q_f32(&(twiddle_real[j]));
+        vector_twiddle_imaginary = vld1q_f32(&(twiddle_imaginary[j]));
+        vector_real = vld1q_f32(&(real[j + h]));
+        vector_imaginary = vld1q_f32(&(imaginary[j + h]));
+        vector_product_real = vmlsq_f32(vmulq_f32(vector_real, vector_twiddle_real), vector_imaginary, vector_twiddle_imaginary);
+        vector_product_imaginary = vmlaq_f32(vmulq_f32(vector_real, vector_twiddle_imaginary), vector_imaginary, vector_twiddle_real);
+        vector_real = vld1q_f32(&(real[j]));
+        vector_imaginary = vld1q_f32(&(imaginary[j]));
+        vst1q_f32(&(real[j]), vaddq_f32(vector_real, vector_product_real));
+        vst1q_f32(&(imaginary[j]), vaddq_f32(vector_imaginary, vector_product_imaginary));
+        vst1q_f32(&(real[j + h]), vsubq_f32(vector_real, vector_product_real));
+        vst1q_f32(&(imaginary[j + h]), vsubq_f32(vector_imaginary, vector_product_imaginary));
+    }
+#endif
+
+    //remaining butterflies (all of them in the first two stages)
+    for (; j < h; j++)
+    {
+        product_real = (real[j + h] * twiddle_real[j]) - (imaginary[j + h] * twiddle_imaginary[j]);
+        product_imaginary = (real[j + h] * twiddle_imaginary[j]) + (imaginary[j + h] * twiddle_real[j]);
+        real[j + h] = real[j] - product_real;
+        imaginary[j + h] = imaginary[j] - product_imaginary;
+        real[j] += product_real;
+        imaginary[j] += product_imaginary;
+    }
+}
+
+//function definition
+//extract an axis' features from its power spectrum
+static void extract_axis_features(SPECTRAL_ANALYZER* analyzer, uint32_t axis, SPECTRAL_AXIS_FEATURES* features)
+{
+    //local vars
+    uint32_t half_length = analyzer->length / 2;
+    uint32_t dominant_bin = 1;
+    uint32_t band;
+    float total_power = 0.0f;
+    float bin_share;            //the doubling applied to a bin's power (one sided spectrum)
+    float previous_magnitude;
+    float magnitude;
+    float next_magnitude;
+    float curvature;
+    float offset = 0.0f;        //of the interpolated peak from the dominant bin (in bins)
+    uint32_t k;
+
+    for (band = 0; band < SPECTRAL_BAND_COUNT; band++)
+    {
+        features->band_energies[band] = 0.0f;
+    }
+
+    //band energies and the dominant bin (above dc)
+    for (k = 0; k <= half_length; k++)
+    {
+        band = (k * SPECTRAL_BAND_COUNT) / half_length;
+        features->band_energies[(band < SPECTRAL_BAND_COUNT) ? band : (SPECTRAL_BAND_COUNT - 1)] += analyzer->power[k];
+        total_power += analyzer->power[k];
+
+        if ((k > 0) && (analyzer->power[k] > analyzer->power[dominant_bin]))
+        {
+            dominant_bin = k;
+        }
+    }
+    features->rms = sqrtf(total_power);
+
+    //refine the peak by fitting a parabola to the magnitudes either side of it
+    if (dominant_bin < half_length)
+    {
+        previous_magnitude = sqrtf(analyzer->power[dominant_bin - 1]);
+        magnitude = sqrtf(analyzer->power[dominant_bin]);
+        next_magnitude = sqrtf(analyzer->power[dominant_bin + 1]);
+        curvature = previous_magnitude - (2.0f * magnitude) + next_magnitude;
+        if (curvature < 0.0f)
+        {
+            offset = (0.5f * (previous_magnitude - next_magnitude)) / curvature;
+            offset = (offset > 0.5f) ? 0.5f : ((offset < -0.5f) ? -0.5f : offset);
+        }
+    }
+    features->dominant_frequency_hz = (((float)dominant_bin + offset) * analyzer->sample_rate_hz) / analyzer->length;
+
+    //peak amplitude of a tone in the dominant bin (undoing the power normalization, then the window's coherent gain)
+    bin_share = (dominant_bin == half_length) ? 1.0f : 2.0f;
+    features->dominant_amplitude = (bin_share * sqrtf((analyzer->power[dominant_bin] * analyzer->length * analyzer->window_square_sum) / bin_share)) / analyzer->window_sum;
+}
@@ -0,0 +1,289 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#include <stdio.h>              //using for "NULL" macro
+#include <math.h>               //using for "sqrt" and "fabs" functions
+#include "windowaggregator.h"
+
+//function declarations
+static void add_sample_to_tumbling_window(WINDOW_AGGREGATOR*, const int16_t*, int64_t, WINDOW_SUMMARY*, bool*);
+static void add_sample_to_sliding_window(WINDOW_AGGREGATOR*, const int16_t*, int64_t, WINDOW_SUMMARY*, bool*);
+static void push_to_extreme_queue(WINDOW_EXTREME_QUEUE*, const int16_t*, uint32_t, uint32_t, bool);
+static void summarize_window(WINDOW_AGGREGATOR*, int64_t, int64_t, WINDOW_SUMMARY*);
+
+//function definition
+//init the window aggregator (hop is only used by sliding windows, a tumbling window always summarizes every window length samples)
+bool init_window_aggregator(WINDOW_AGGREGATOR* aggregator, WINDOW_TYPE type, uint32_t length, uint32_t hop, double accel_scale_factor, double magneto_scale_factor, double gyro_scale_factor)
+{
+    //local vars
+    uint32_t i;
+
+    //check inputs
+    if ((aggregator != NULL) && ((type == TUMBLING_WINDOW) || (type == SLIDING_WINDOW)) && (length > 0) && (length <= WINDOW_AGGREGATOR_MAX_LENGTH))
+    {
+        //a sliding window must summarize at least once per window
+        if ((type == SLIDING_WINDOW) && ((hop == 0) || (hop > length)))
+        {
+            fprintf(stderr, "ERROR: SLIDING WINDOW HOP MUST BE BETWEEN 1 AND THE WINDOW LENGTH!\n");
+
+            //failure
+            return false;
+        }
+
+        aggregator->type = type;
+        aggregator->length = length;
+        aggregator->hop = (type == SLIDING_WINDOW) ? hop : length;
+        aggregator->window_id = 0;
+        aggregator->sample_count = 0;
+        aggregator->position = 0;
+        aggregator->samples_since_summary = 0;
+        aggregator->start_timestamp_ns = 0;
+
+        //reset the per axis state (the value buffers are only read once written)
+        for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+        {
+            aggregator->axes[i].sum = 0;
+            aggregator->axes[i].sum_of_squares = 0;
+            aggregator->axes[i].min_queue.head = 0;
+            aggregator->axes[i].min_queue.count = 0;
+            aggregator->axes[i].max_queue.head = 0;
+            aggregator->axes[i].max_queue.count = 0;
+        }
+
+        //axes are in sample batch order
+        for (i = 0; i < 3; i++)
+        {
+            aggregator->scale_factors[SAMPLE_ACCEL_X + i] = accel_scale_factor;
+            aggregator->scale_factors[SAMPLE_MAGNETO_X + i] = magneto_scale_factor;
+            aggregator->scale_factors[SAMPLE_GYRO_X + i] = gyro_scale_factor;
+        }
+
+        //success
+        return true;
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//add a sample (by its index in a batch) to the window, summary_availability is set when the sample completed a window (and the summary was filled in)
+bool add_sample_to_window_aggregator(WINDOW_AGGREGATOR* aggregator, const SAMPLE_BATCH* batch, uint32_t sample_index, WINDOW_SUMMARY* summary, bool* summary_availability)
+{
+    //local vars
+    int16_t values[WINDOW_AGGREGATOR_AXIS_COUNT];
+    uint32_t axis;
+
+    //check inputs
+    if ((aggregator != NULL) && (batch != NULL) && (sample_index < batch->sample_count) && (summary != NULL) && (summary_availability != NULL))
+    {
+        *summary_availability = false;
+
+        //gather the sample from the batch columns
+        for (axis = 0; axis < WINDOW_AGGREGATOR_AXIS_COUNT; axis++)
+        {
+            values[axis] = batch->raw[axis][sample_index];
+        }
+
+        switch (aggregator->type)
+        {
+            case TUMBLING_WINDOW:
+                add_sample_to_tumbling_window(aggregator, values, batch->timestamps_ns[sample_index], summary, summary_availability);
+                return true;
+            case SLIDING_WINDOW:
+                add_sample_to_sliding_window(aggregator, values, batch->timestamps_ns[sample_index], summary, summary_availability);
+                return true;
+            default:
+                break;
+        }
+    }
+
+    //failure
+    return false;
+}
+
+//function definition
+//accumulate a sample, summarizing (and starting over) when the window is full
+static void add_sample_to_tumbling_window(WINDOW_AGGREGATOR* aggregator, const int16_t* values, int64_t timestamp_ns, WINDOW_SUMMARY* summary, bool* summary_availability)
+{
+    //local vars
+    WINDOW_AXIS_STATE* axis;
+    uint32_t i;
+
+    //the first sample of a window starts the min/max over
+    if (aggregator->sample_count == 0)
+    {
+        aggregator->start_timestamp_ns = timestamp_ns;
+        for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+        {
+            aggregator->axes[i].min = values[i];
+            aggregator->axes[i].max = values[i];
+        }
+    }
+
+    //accumulate
+    for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+    {
+        axis = &(aggregator->axes[i]);
+        axis->sum += values[i];
+        axis->sum_of_squares += (int64_t)values[i] * values[i];
+        if (values[i] < axis->min)
+        {
+            axis->min = values[i];
+        }
+        if (values[i] > axis->max)
+        {
+            axis->max = values[i];
+        }
+    }
+    aggregator->sample_count++;
+
+    //if the window is full
+    if (aggregator->sample_count == aggregator->length)
+    {
+        summarize_window(aggregator, aggregator->start_timestamp_ns, timestamp_ns, summary);
+        *summary_availability = true;
+
+        //start the next window
+        for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+        {
+            aggregator->axes[i].sum = 0;
+            aggregator->axes[i].sum_of_squares = 0;
+        }
+        aggregator->sample_count = 0;
+    }
+}
+
+//function definition
+//replace the oldest sample in the window with this one, summarizing every hop samples once the window is full
+static void add_sample_to_sliding_window(WINDOW_AGGREGATOR* aggregator, const int16_t* values, int64_t timestamp_ns, WINDOW_SUMMARY* summary, bool* summary_availability)
+{
+    //local vars
+    WINDOW_AXIS_STATE* axis;
+    uint32_t position = aggregator->position;
+    int16_t evicted_value;
+    uint32_t i;
+
+    for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+    {
+        axis = &(aggregator->axes[i]);
+
+        //if the window is full the sample at this position is the oldest, take it out of the window
+        if (aggregator->sample_count == aggregator->length)
+        {
+            evicted_value = axis->values[position];
+            axis->sum -= evicted_value;
+            axis->sum_of_squares -= (int64_t)evicted_value * evicted_value;
+
+            //the oldest sample can only be at the front of a queue
+            if ((axis->min_queue.count > 0) && (axis->min_queue.positions[axis->min_queue.head] == position))
+            {
+                axis->min_queue.head = (axis->min_queue.head + 1) % aggregator->length;
+                axis->min_queue.count--;
+            }
+            if ((axis->max_queue.count > 0) && (axis->max_queue.positions[axis->max_queue.head] == position))
+            {
+                axis->max_queue.head = (axis->max_queue.head + 1) % aggregator->length;
+                axis->max_queue.count--;
+            }
+        }
+
+        //add the new sample
+        axis->values[position] = values[i];
+        axis->sum += values[i];
+        axis->sum_of_squares += (int64_t)values[i] * values[i];
+        push_to_extreme_queue(&(axis->min_queue), axis->values, aggregator->length, position, true);
+        push_to_extreme_queue(&(axis->max_queue), axis->values, aggregator->length, position, false);
+    }
+    aggregator->timestamps_ns[position] = timestamp_ns;
+
+    //advance to the next (oldest) position
+    aggregator->position = (position + 1) % aggregator->length;
+    if (aggregator->sample_count < aggregator->length)
+    {
+        aggregator->sample_count++;
+    }
+    aggregator->samples_since_summary++;
+
+    //summarize if the window is full and a hop has passed since the last summary
+    if ((aggregator->sample_count == aggregator->length) && (aggregator->samples_since_summary >= aggregator->hop))
+    {
+        summarize_window(aggregator, aggregator->timestamps_ns[aggregator->position], timestamp_ns, summary);
+        *summary_availability = true;
+        aggregator->samples_since_summary = 0;
+    }
+}
+
+//function definition
+//add a position to the back of a min (or max) queue, first dropping the candidates it makes redundant
+//(a newer value that is at least as small/large as an older one outlives it, so the older one can never be the min/max again)
+static void push_to_extreme_queue(WINDOW_EXTREME_QUEUE* queue, const int16_t* values, uint32_t length, uint32_t position, bool is_min_queue)
+{
+    //local vars
+    uint32_t back;
+
+    //drop candidates from the back until the queue is ordered again
+    while (queue->count > 0)
+    {
+        back = queue->positions[(queue->head + queue->count - 1) % length];
+
+        if (is_min_queue ? (values[back] >= values[position]) : (values[back] <= values[position]))
+        {
+            queue->count--;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    queue->positions[(queue->head + queue->count) % length] = (uint16_t)position;
+    queue->count++;
+}
+
+//function definition
+//compute the scaled statistics of the samples currently in the window
+static void summarize_window(WINDOW_AGGREGATOR* aggregator, int64_t start_timestamp_ns, int64_t end_timestamp_ns, WINDOW_SUMMARY* summary)
+{
+    //local vars
+    const WINDOW_AXIS_STATE* axis;
+    int64_t n = aggregator->sample_count;
+    double scale_factor;
+    int16_t min;
+    int16_t max;
+    uint32_t i;
+
+    summary->type = aggregator->type;
+    summary->window_id = aggregator->window_id++;
+    summary->sample_count = aggregator->sample_count;
+    summary->start_timestamp_ns = start_timestamp_ns;
+    summary->end_timestamp_ns = end_timestamp_ns;
+
+    for (i = 0; i < WINDOW_AGGREGATOR_AXIS_COUNT; i++)
+    {
+        axis = &(aggregator->axes[i]);
+        scale_factor = aggregator->scale_factors[i];
+
+        //the min/max are at the front of the queues for a sliding window
+        if (aggregator->type == SLIDING_WINDOW)
+        {
+            min = axis->values[axis->min_queue.positions[axis->min_queue.head]];
+            max = axis->values[axis->max_queue.positions[axis->max_queue.head]];
+        }
+        else
+        {
+            min = axis->min;
+            max = axis->max;
+        }
+
+        //n * sum_of_squares - sum^2 is exact in integers (and never negative), so the variance can't suffer cancellation
+        summary->axes[i].mean = ((double)axis->sum / n) * scale_factor;
+        summary->axes[i].min = min * scale_factor;
+        summary->axes[i].max = max * scale_factor;
+        summary->axes[i].rms = sqrt((double)axis->sum_of_squares / n) * fabs(scale_factor);
+        summary->axes[i].variance = ((double)((n * axis->sum_of_squares) - (axis->sum * axis->sum)) / (double)(n * n)) * scale_factor * scale_factor;
+        summary->axes[i].peak_to_peak = (max - min) * scale_factor;
+    }
+}
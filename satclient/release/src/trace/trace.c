@@ -0,0 +1,315 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "clock_gettime" and "nanosleep" functions
+
+#include <stdio.h>              //using for "fopen", "fprintf", and "fclose" functions
+#include <stdlib.h>             //using for "NULL"
+#include <time.h>               //using for "clock_gettime" and "nanosleep" functions
+#include <unistd.h>             //using for "getpid" function
+#include <pthread.h>            //using for the trace writer thread
+#include "satmemory.h"          //using to allocate from the memory arena
+#include "trace.h"
+
+/*
+    Each ring is only written by its thread (the head) and only read by the trace writer (the tail), so the two sides
+    just publish their position to each other (release/acquire) and keep them on separate cache lines. Rings are
+    allocated the first time a thread records an event, and live as long as the process (a thread's events may still
+    be waiting to be written after it exits).
+*/
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+
+//trace event representation
+typedef struct trace_event
+{
+    int64_t timestamp_ns;       //CLOCK_MONOTONIC time of the event (the start, for a complete event)
+    const char* name;
+    int64_t value;              //duration (complete events), value (instant and counter events), or code (end events)
+    TRACE_PHASE phase;
+}TRACE_EVENT;
+
+//per thread ring of events
+typedef struct trace_ring
+{
+    uint32_t head __attribute__((aligned(64)));     //next slot the thread writes (only written by the thread)
+    uint32_t tail __attribute__((aligned(64)));     //next slot the writer reads (only written by the trace writer)
+    const char* thread_name __attribute__((aligned(64)));  //name the thread gave itself (NULL for none)
+    bool is_thread_name_written;                    //denotes if the writer has written the name (only touched by the writer)
+    TRACE_EVENT events[TRACE_RING_SIZE];
+}TRACE_RING;
+
+//trace writer state representation
+struct trace_writer
+{
+    pthread_t worker;               //thread draining the rings to the file
+    FILE* file;                     //trace file being written
+    uint32_t flush_interval_ms;     //milliseconds between drains
+    bool is_stopping;               //set (atomically) when the writer is being freed
+    bool is_first_event;            //denotes if no event has been written yet (so the next one has no leading comma)
+    int pid;                        //process id written with every event
+};
+
+//global vars
+static TRACE_RING* rings[TRACE_MAX_THREADS];
+static uint32_t claimed_ring_count;
+static uint64_t dropped_event_count;
+static __thread TRACE_RING* thread_ring;        //ring of the calling thread (claimed on first use)
+static __thread bool is_thread_ring_claimed;    //denotes if the calling thread has tried to claim a ring (it may not have got one)
+static const char* const PHASE_CODES[] = {"B", "E", "X", "i", "C"};
+
+//function declarations
+static TRACE_RING* get_thread_ring(void);
+static void* run_trace_writer_worker(void*);
+static void drain_trace_rings(TRACE_WRITER*);
+static void write_trace_event(TRACE_WRITER*, uint32_t, const TRACE_EVENT*);
+
+//function definition
+//get the current CLOCK_MONOTONIC time in nanoseconds (the clock every event is stamped with, the same as the metrics)
+int64_t get_trace_time_ns(void)
+{
+    //local vars
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+//function definition
+//record an event in the calling thread's ring (dropping it if the ring is full)
+void record_trace_event(TRACE_PHASE phase, const char* name, int64_t timestamp_ns, int64_t value)
+{
+    //local vars
+    TRACE_RING* ring = get_thread_ring();
+    TRACE_EVENT* event;
+    uint32_t head;
+
+    //if the thread has no ring, or the writer has fallen a ring behind
+    if (ring == NULL)
+    {
+        __atomic_fetch_add(&dropped_event_count, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    head = ring->head;
+    if ((head - __atomic_load_n(&(ring->tail), __ATOMIC_ACQUIRE)) >= TRACE_RING_SIZE)
+    {
+        __atomic_fetch_add(&dropped_event_count, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    //fill in the slot, then hand it to the writer
+    event = &(ring->events[head & TRACE_RING_MASK]);
+    event->timestamp_ns = timestamp_ns;
+    event->name = name;
+    event->value = value;
+    event->phase = phase;
+    __atomic_store_n(&(ring->head), head + 1, __ATOMIC_RELEASE);
+}
+
+//function definition
+//name the calling thread in the trace (the name must outlive the trace)
+void set_trace_thread_name(const char* name)
+{
+    //local vars
+    TRACE_RING* ring = get_thread_ring();
+
+    if (ring != NULL)
+    {
+        __atomic_store_n(&(ring->thread_name), name, __ATOMIC_RELEASE);
+    }
+}
+
+//function definition
+//get the number of events dropped because a ring was full (or a thread had none)
+uint64_t get_trace_dropped_event_count(void)
+{
+    return __atomic_load_n(&dropped_event_count, __ATOMIC_RELAXED);
+}
+
+//function definition
+//create a trace writer, draining every thread's events to the supplied file (truncated) every flush interval milliseconds
+//returns NULL on failure
+TRACE_WRITER* new_trace_writer(const char* file_location, uint32_t flush_interval_ms)
+{
+    //local vars
+    TRACE_WRITER* writer;
+
+    //check inputs
+    if ((file_location != NULL) && (flush_interval_ms > 0))
+    {
+        //allocate trace writer object
+        writer = allocate_sat_memory(SAT_MEMORY_TRACE, sizeof (TRACE_WRITER));
+
+        //if the object was successfully created
+        if (writer != NULL)
+        {
+            writer->file = fopen(file_location, "w");
+
+            //if the file was successfully opened
+            if (writer->file != NULL)
+            {
+                writer->flush_interval_ms = flush_interval_ms;
+                writer->is_stopping = false;
+                writer->is_first_event = true;
+                writer->pid = (int)getpid();
+                fprintf(writer->file, "{\"traceEvents\":[\n");
+
+                if (pthread_create(&(writer->worker), NULL, run_trace_writer_worker, writer) == 0)
+                {
+                    return writer;
+                }
+
+                fprintf(stderr, "ERROR: FAILED TO START TRACE WRITER THREAD!\n");
+                fclose(writer->file);
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: FAILED TO OPEN TRACE FILE: %s!\n", file_location);
+            }
+
+            free_sat_memory(writer);
+        }
+    }
+
+    //failure
+    return NULL;
+}
+
+//function definition
+//stop the trace writer, writing whatever events are left, and deallocate it
+void free_trace_writer(TRACE_WRITER* writer)
+{
+    //check input
+    if (writer != NULL)
+    {
+        __atomic_store_n(&(writer->is_stopping), true, __ATOMIC_RELEASE);
+        pthread_join(writer->worker, NULL);
+
+        //write the rest of the events, then close off the trace
+        drain_trace_rings(writer);
+        fprintf(writer->file, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":%llu}}\n", (unsigned long long)get_trace_dropped_event_count());
+        fclose(writer->file);
+        free_sat_memory(writer);
+    }
+}
+
+//function definition
+//get the calling thread's ring, allocating one the first time (NULL once every ring is claimed, or if it couldn't be allocated)
+static TRACE_RING* get_thread_ring(void)
+{
+    //local vars
+    uint32_t ring_index;
+
+    if (!is_thread_ring_claimed)
+    {
+        is_thread_ring_claimed = true;
+        ring_index = __atomic_fetch_add(&claimed_ring_count, 1, __ATOMIC_RELAXED);
+        if (ring_index < TRACE_MAX_THREADS)
+        {
+            thread_ring = allocate_zeroed_sat_memory(SAT_MEMORY_TRACE, sizeof (TRACE_RING));
+            __atomic_store_n(&(rings[ring_index]), thread_ring, __ATOMIC_RELEASE);
+        }
+    }
+
+    return thread_ring;
+}
+
+//function definition
+//drain the rings every flush interval until the writer is stopping
+static void* run_trace_writer_worker(void* parameter)
+{
+    //local vars
+    TRACE_WRITER* writer = (TRACE_WRITER*)parameter;
+    struct timespec interval;
+
+    interval.tv_sec = writer->flush_interval_ms / 1000;
+    interval.tv_nsec = (long)(writer->flush_interval_ms % 1000) * 1000000;
+
+    while (!__atomic_load_n(&(writer->is_stopping), __ATOMIC_ACQUIRE))
+    {
+        nanosleep(&interval, NULL);
+        drain_trace_rings(writer);
+    }
+
+    return NULL;
+}
+
+//function definition
+//write every event waiting in the rings to the trace file
+static void drain_trace_rings(TRACE_WRITER* writer)
+{
+    //local vars
+    TRACE_RING* ring;
+    const char* thread_name;
+    uint32_t ring_count;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t i;
+
+    ring_count = __atomic_load_n(&claimed_ring_count, __ATOMIC_RELAXED);
+    ring_count = (ring_count > TRACE_MAX_THREADS) ? TRACE_MAX_THREADS : ring_count;
+    for (i = 0; i < ring_count; i++)
+    {
+        ring = __atomic_load_n(&(rings[i]), __ATOMIC_ACQUIRE);
+        if (ring == NULL)
+        {
+            continue;
+        }
+
+        //name the thread (once)
+        thread_name = __atomic_load_n(&(ring->thread_name), __ATOMIC_ACQUIRE);
+        if ((thread_name != NULL) && (!ring->is_thread_name_written))
+        {
+            fprintf(writer->file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", writer->is_first_event ? "" : ",\n", writer->pid, i + 1, thread_name);
+            writer->is_first_event = false;
+            ring->is_thread_name_written = true;
+        }
+
+        //write the events the thread has published, then hand their slots back
+        head = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+        for (tail = ring->tail; tail != head; tail++)
+        {
+            write_trace_event(writer, i + 1, &(ring->events[tail & TRACE_RING_MASK]));
+        }
+        __atomic_store_n(&(ring->tail), tail, __ATOMIC_RELEASE);
+    }
+
+    fflush(writer->file);
+}
+
+//function definition
+//write an event as a chrome trace event (timestamps and durations in microseconds)
+static void write_trace_event(TRACE_WRITER* writer, uint32_t thread_id, const TRACE_EVENT* event)
+{
+    fprintf(writer->file, "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u", writer->is_first_event ? "" : ",\n",
+            event->name, PHASE_CODES[event->phase], (double)event->timestamp_ns / 1e3, writer->pid, thread_id);
+    writer->is_first_event = false;
+
+    switch (event->phase)
+    {
+        case TRACE_PHASE_COMPLETE:
+            fprintf(writer->file, ",\"dur\":%.3f}", (double)event->value / 1e3);
+            break;
+        case TRACE_PHASE_INSTANT:
+            fprintf(writer->file, ",\"s\":\"t\",\"args\":{\"value\":%lld}}", (long long)event->value);
+            break;
+        case TRACE_PHASE_COUNTER:
+            fprintf(writer->file, ",\"args\":{\"value\":%lld}}", (long long)event->value);
+            break;
+        case TRACE_PHASE_END:
+            if (event->value != 0)
+            {
+                fprintf(writer->file, ",\"args\":{\"value\":%lld}}", (long long)event->value);
+            }
+            else
+            {
+                fprintf(writer->file, "}");
+            }
+            break;
+        default:
+            fprintf(writer->file, "}");
+            break;
+    }
+}
@@ -0,0 +1,39 @@
+# Author: James Beasley
+# Repo: https://github.com/embeddedcognition/satclient
+
+#!/bin/bash
+
+#run benchcryptoutil with the cpu's full instruction set (aes-ni when present)
+./build/bin/bench/benchcryptoutil
+
+#run benchcryptoutil again with the aes-ni and pclmulqdq capability bits masked so openssl uses its portable aes/ghash code
+OPENSSL_ia32cap="~0x200000200000000" ./build/bin/bench/benchcryptoutil
+
+#run benchcolumnarsink (writes, then reads back, a temporary columnar telemetry file)
+./build/bin/bench/benchcolumnarsink
+
+
+#run benchrawsignalconvert (every conversion kernel this host supports, against the per reading conversion)
+./build/bin/bench/benchrawsignalconvert
+
+#run benchahrsfilter (pass a file written by the columnar sink to replay a real recording instead of the synthetic one)
+./build/bin/bench/benchahrsfilter
+
+#run benchfilterchain (chains decimating the 1600hz accelerometer rate to 25hz)
+./build/bin/bench/benchfilterchain
+
+#run benchspectralanalyzer (cost of the spectral features of each window length)
+./build/bin/bench/benchspectralanalyzer
+
+#run benchsat (the whole SAT process against simulated boards and a stand-in mqtt endpoint, results written as json)
+#pass a previous run's json second to compare against it, failing on a regression, e.g. ./build/bin/bench/benchsat satbench_new.json satbench.json
+./build/bin/bench/benchsat satbench.json
+
+#run benchmetrics (hot path cost of a counter, histogram, and timing update, against a shared atomic counter)
+./build/bin/bench/benchmetrics
+
+#run benchshadowdelta (dispatch of thing shadow deltas to 100 registered keys, against every key scanning the delta)
+./build/bin/bench/benchshadowdelta
+
+#run benchshadowack (thing shadow update ack tracking, with up to the most updates allowed in flight)
+./build/bin/bench/benchshadowack
\ No newline at end of file
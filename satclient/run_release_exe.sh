@@ -6,5 +6,64 @@
 #enable proton trace info
 export PN_TRACE_FRM=1;
 
+#non-interactive secret key provisioning (see keyprovisioner.h), leave unset to be prompted for the payload file and passphrase
+#export SATCLIENT_KEY_FILE=/home/root/secret_key.base64_encoded_ciphertext
+#export SATCLIENT_KDF=pbkdf2                                  #payload created with: openssl enc -e -aes-256-cfb -salt -pbkdf2 -iter 100000 -md sha256 ...
+#export SATCLIENT_KDF_COST=100000
+#export SATCLIENT_KEY_CACHE=/home/root/.satclient_key_cache   #sealed derived key, warm starts skip the kdf
+#export SATCLIENT_NONINTERACTIVE=1
+#passphrase from fd 3, or SATCLIENT_PASSPHRASE, or the kernel keyring: keyctl padd user satclient:passphrase @u
+
+#telemetry sink(s), comma separated: aws, azure, file, columnar (several are published to in parallel), defaults to aws
+#export SATCLIENT_SINKS=aws,file
+#export SATCLIENT_SINK_FILE=/home/root/satclient_telemetry.ndjson
+#export SATCLIENT_COLUMNAR_SINK_FILE=/home/root/satclient_telemetry.col   #raw samples, memory mapped columns (see columnarfile.h)
+
+#sensor output data rate (hz), bandwidth (hz, 0 for the default), and full scale range (dps, g, gauss), supported values are listed in lsm9ds0.h
+#batches, the filter chain, fusion, and spectra follow the fastest rate (window and event lengths stay in readings), recalibrate after changing a fsr
+#export SATCLIENT_GYRO_ODR=95                   #95 (default), 190, 380, 760
+#export SATCLIENT_GYRO_BANDWIDTH=12.5           #low pass cutoff, per rate (95hz: 12.5, 25)
+#export SATCLIENT_GYRO_FSR=245                  #245 (default), 500, 2000
+#export SATCLIENT_ACCEL_ODR=100                 #3.125 to 1600 (default 100)
+#export SATCLIENT_ACCEL_BANDWIDTH=773           #anti-alias filter: 50, 194, 362, 773 (default)
+#export SATCLIENT_ACCEL_FSR=2                   #2 (default), 4, 6, 8, 16
+#export SATCLIENT_MAGNETO_ODR=100               #3.125 to 100 (default 100, needs an accel rate over 50)
+#export SATCLIENT_MAGNETO_FSR=2                 #2 (default), 4, 8, 12
+
+#filter stages every reading goes through first, comma separated: lowpass:<hz>, highpass:<hz>, average:<factor>, fir:<factor> (decimators)
+#export SATCLIENT_FILTERS=lowpass:20,fir:4     #e.g. a clean 25hz stream from the 100hz readings
+
+#window summaries (mean, min, max, rms, variance, peak to peak per axis), published instead of every reading unless SATCLIENT_PUBLISH_READINGS=1
+#export SATCLIENT_WINDOW=sliding                #none (default), tumbling, sliding
+#export SATCLIENT_WINDOW_LENGTH=300             #samples per window (max 1024)
+#export SATCLIENT_WINDOW_HOP=100                #samples between sliding window summaries
+#
+#sensor fusion (madgwick ahrs) orientation as a quaternion and roll/pitch/yaw, also published instead of every reading unless SATCLIENT_PUBLISH_READINGS=1
+#export SATCLIENT_ORIENTATION_INTERVAL=10       #readings between published orientations (~10 per second), unset or 0 disables sensor fusion
+#
+#vibration (fft) features of the accelerometer per window - rms, dominant frequency & amplitude, 8 band energies - also published instead of every reading
+#export SATCLIENT_SPECTRUM_LENGTH=256           #samples per window, a power of two from 16 to 1024 (~2.5 seconds at 100hz, the nearest to the 300 sample window summaries)
+#export SATCLIENT_SPECTRUM_HOP=256              #samples between features (defaults to the length, shorter hops overlap the windows)
+#export SATCLIENT_PUBLISH_READINGS=1
+#
+#report by exception - readings are only published during events (with the history leading up to them), heartbeat summaries otherwise
+#export SATCLIENT_REPORT_BY_EXCEPTION=1
+#export SATCLIENT_HEARTBEAT_INTERVAL=1000       #readings between heartbeats (~10 seconds), 0 for none
+#export SATCLIENT_EVENT_ACCEL_THRESHOLD=0.25    #g the accel magnitude may depart from 1g, 0 disables (and likewise for each detector below)
+#export SATCLIENT_EVENT_GYRO_THRESHOLD=30       #dps, also programmed into the gyro's own threshold interrupt (INT1_THS_*_G)
+#export SATCLIENT_EVENT_ACCEL_DELTA=0.1         #g the accel magnitude may depart from its (slowly tracking) baseline
+#export SATCLIENT_EVENT_GYRO_DELTA=10           #dps a gyro rate may depart from its baseline
+#export SATCLIENT_EVENT_ZSCORE=6                #standard deviations from the mean of the last second of readings
+#export SATCLIENT_EVENT_HOLD=200                #readings without a detection before an event ends
+#export SATCLIENT_EVENT_PRE_TRIGGER=100         #readings of history published from before an event (max 255)
+
+#gyro bias and magnetometer hard/soft iron calibration, loaded at startup when the file exists (hard iron goes into the magnetometer's OFFSET_*_M registers)
+#export SATCLIENT_CALIBRATION_FILE=/home/root/satclient_calibration.txt   #none for no file
+#export SATCLIENT_CALIBRATE=all                 #calibrate before acquisition starts and save: gyro (~3 seconds, keep still), magneto (~30 seconds, rotate through every orientation), all
+
+#boards to acquire from (default: one board on bus 1), as i2c bus numbers suffixed ":alt" for a board with SA0 pulled low, one thread per bus
+#readings are tagged with the board's index (its position in the list), boards past the first use the calibration file suffixed ".<index>"
+#export SATCLIENT_DEVICES=1,1:alt,6
+
 #run sat (signal acquisition & telemetry) client
 ./build/bin/release/satclient
\ No newline at end of file
@@ -4,4 +4,52 @@
 #!/bin/bash
 
 #run testcryptoutil
-./build/bin/test/testcryptoutil
\ No newline at end of file
+./build/bin/test/testcryptoutil
+
+#run testwindowaggregator
+./build/bin/test/testwindowaggregator
+
+#run testrawsignalconvert (checks every vectorized kernel this host supports against the scalar kernel)
+./build/bin/test/testrawsignalconvert
+
+#run testsamplebatch
+./build/bin/test/testsamplebatch
+
+#run testahrsfilter
+./build/bin/test/testahrsfilter
+
+#run testfilterchain
+./build/bin/test/testfilterchain
+
+#run testeventdetector
+./build/bin/test/testeventdetector
+
+#run testspectralanalyzer
+./build/bin/test/testspectralanalyzer
+
+#run testimucalibration
+./build/bin/test/testimucalibration
+
+#run testmetrics
+./build/bin/test/testmetrics
+
+#run testtrace
+./build/bin/test/testtrace
+
+#run testtelemetrysink
+./build/bin/test/testtelemetrysink
+
+#run testsatconfig
+./build/bin/test/testsatconfig
+
+#run testsatmemory (links with the heap functions wrapped, fails if anything is allocated from the heap rather than the arena)
+./build/bin/test/testsatmemory
+
+#run testcolumnarsink
+./build/bin/test/testcolumnarsink
+
+#run testiotdeviceshadow
+./build/bin/test/testiotdeviceshadow
+
+#run testkeyprovisioner
+./build/bin/test/testkeyprovisioner
\ No newline at end of file
@@ -0,0 +1,341 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+
+   The connection is left out, the shadow calls the sdk's connect, yield, and update are stood in for by the suite (the
+   delta dispatch is the sdk's own), each yield hands the sdk's delta handler (or chunk handler) the delta the test
+   supplied, and each update keeps the reported document.
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "nanosleep" function
+
+#include <stdio.h>                      //using for "fopen", "fputs", "fclose", "remove", and "snprintf" functions
+#include <string.h>                     //using for "memset", "strlen", and "strstr" functions
+#include <time.h>                       //using for "nanosleep" function
+#include "unity.h"
+#include "aws_iot_shadow_interface.h"
+#include "aws_iot_shadow_records.h"     //using for the sdk's delta registration
+#include "satconfig.h"
+#include "iotdeviceshadow.h"
+
+//global vars
+#define DELTA_DOCUMENT_SIZE 1024
+#define OVERLONG_VALUE_SIZE (SAT_CONFIG_MAX_VALUE_SIZE + 44)       //longer than a delta value may be, but short enough for the rx buffer
+#define STREAM_CHUNK_SIZE 64                                       //chunk a streamed delta is handed over in
+static const char expected_config_file[] = "/tmp/testiotdeviceshadow.conf";
+static pApplicationHandler_t delta_handler;                        //the sdk's delta handler (captured when it subscribes)
+static pApplicationChunkHandler_t delta_chunk_handler;             //the sdk's delta chunk handler (captured when it sets it)
+static char delta_document[DELTA_DOCUMENT_SIZE];                   //delta the next yield hands over
+static bool is_delta_streamed;
+static bool is_delta_pending;                                      //set (atomically) by the test, cleared by the yield that handed the delta over
+static uint32_t yield_count;                                       //yields entered (atomically)
+static char reported_document[AWS_IOT_MQTT_TX_BUF_LEN];            //latest reported state
+static uint32_t report_count;                                      //reports made (atomically)
+const ShadowInitParameters_t ShadowInitParametersDefault;          //stand-ins for the sdk's defaults (the shadow sets what it uses)
+const ShadowConnectParameters_t ShadowConnectParametersDefault;
+
+//function declarations
+static void hand_delta_to_iot_device_shadow(const char*, bool);
+static bool wait_for_iot_device_shadow_reports(uint32_t);
+static void test_new_iot_device_shadow_if_delta_value_too_long_renders_delta_rejected(void);
+
+//function definition
+//stand-in for the sdk's shadow init
+IoT_Error_t aws_iot_shadow_init(AWS_IoT_Client* client, ShadowInitParameters_t* parameters)
+{
+    (void)client;
+    (void)parameters;
+    initDeltaTokens();
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the sdk's shadow connect
+IoT_Error_t aws_iot_shadow_connect(AWS_IoT_Client* client, ShadowConnectParameters_t* parameters)
+{
+    (void)client;
+    (void)parameters;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the sdk's delta registration (without the connection check)
+IoT_Error_t aws_iot_shadow_register_delta(AWS_IoT_Client* client, jsonStruct_t* key)
+{
+    (void)client;
+
+    return registerJsonTokenOnDelta(key);
+}
+
+//function definition
+//stand-in for the sdk's yield, hand over the pending delta (if any)
+IoT_Error_t aws_iot_shadow_yield(AWS_IoT_Client* client, uint32_t timeout)
+{
+    //local vars
+    IoT_Publish_Message_Params parameters;
+    struct timespec step = {0, 1000000L};
+    uint32_t document_length;
+    uint32_t offset;
+
+    (void)client;
+    (void)timeout;
+    __atomic_add_fetch(&yield_count, 1, __ATOMIC_ACQ_REL);
+    if (!__atomic_load_n(&is_delta_pending, __ATOMIC_ACQUIRE))
+    {
+        nanosleep(&step, NULL);
+        return SUCCESS;
+    }
+
+    document_length = (uint32_t)strlen(delta_document);
+    parameters.qos = QOS0;
+    parameters.isRetained = 0;
+    parameters.isDup = 0;
+    parameters.id = 0;
+    if (!is_delta_streamed)
+    {
+        parameters.payload = delta_document;
+        parameters.payloadLen = document_length;
+        delta_handler(NULL, NULL, 0, &parameters, NULL);
+    }
+    else
+    {
+        //a chunk at a time, as the mqtt client hands over a delta larger than its read buffer
+        for (offset = 0; offset < document_length; offset += STREAM_CHUNK_SIZE)
+        {
+            parameters.payload = delta_document + offset;
+            parameters.payloadLen = ((document_length - offset) < STREAM_CHUNK_SIZE) ? (document_length - offset) : STREAM_CHUNK_SIZE;
+            delta_chunk_handler(NULL, NULL, 0, &parameters, offset, document_length, NULL);
+        }
+    }
+    __atomic_store_n(&is_delta_pending, false, __ATOMIC_RELEASE);
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the sdk's shadow disconnect
+IoT_Error_t aws_iot_shadow_disconnect(AWS_IoT_Client* client)
+{
+    (void)client;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the sdk's shadow update, keep the reported document
+IoT_Error_t aws_iot_shadow_update(AWS_IoT_Client* client, const char* thing_name, char* document, fpActionCallback_t callback, void* context, uint8_t timeout_seconds, bool is_persistent_subscribe)
+{
+    (void)client;
+    (void)thing_name;
+    (void)callback;
+    (void)context;
+    (void)timeout_seconds;
+    (void)is_persistent_subscribe;
+    snprintf(reported_document, sizeof (reported_document), "%s", document);
+    __atomic_add_fetch(&report_count, 1, __ATOMIC_ACQ_REL);
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the sdk's setting (the deltas the test supplies are numbered in order)
+void aws_iot_shadow_enable_discard_old_delta_msgs(void)
+{
+    shadowDiscardOldDeltaFlag = true;
+}
+
+//function definition
+//stand-in for the sdk's setting
+IoT_Error_t aws_iot_shadow_set_autoreconnect_status(AWS_IoT_Client* client, bool status)
+{
+    (void)client;
+    (void)status;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's subscribe, capture the handler the sdk subscribes to the delta topic with
+IoT_Error_t aws_iot_mqtt_subscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, QoS qos, pApplicationHandler_t handler, void* handler_data)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)qos;
+    (void)handler_data;
+    delta_handler = handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's chunk handler setter, capture the chunk handler the sdk sets on the delta topic
+IoT_Error_t aws_iot_mqtt_set_chunk_handler(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, pApplicationChunkHandler_t handler)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    delta_chunk_handler = handler;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's unsubscribe (not called by the delta dispatch)
+IoT_Error_t aws_iot_mqtt_unsubscribe(AWS_IoT_Client* client, const char* topic, uint16_t topic_length)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+
+    return SUCCESS;
+}
+
+//function definition
+//stand-in for the mqtt client's publish (not called by the delta dispatch)
+IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client* client, const char* topic, uint16_t topic_length, IoT_Publish_Message_Params* parameters)
+{
+    (void)client;
+    (void)topic;
+    (void)topic_length;
+    (void)parameters;
+
+    return SUCCESS;
+}
+
+//function definition
+//hand the supplied delta to the shadow's next yield, returning once the shadow has handled it (the yield after it has begun)
+static void hand_delta_to_iot_device_shadow(const char* document, bool is_streamed)
+{
+    //local vars
+    struct timespec step = {0, 1000000L};
+    uint32_t handled_yield_count;
+    uint32_t i;
+
+    TEST_ASSERT_TRUE(strlen(document) < sizeof (delta_document));
+    snprintf(delta_document, sizeof (delta_document), "%s", document);
+    is_delta_streamed = is_streamed;
+    __atomic_store_n(&is_delta_pending, true, __ATOMIC_RELEASE);
+    for (i = 0; (i < 5000) && __atomic_load_n(&is_delta_pending, __ATOMIC_ACQUIRE); i++)
+    {
+        nanosleep(&step, NULL);
+    }
+    TEST_ASSERT_FALSE(__atomic_load_n(&is_delta_pending, __ATOMIC_ACQUIRE));
+    handled_yield_count = __atomic_load_n(&yield_count, __ATOMIC_ACQUIRE);
+    for (i = 0; (i < 5000) && (__atomic_load_n(&yield_count, __ATOMIC_ACQUIRE) == handled_yield_count); i++)
+    {
+        nanosleep(&step, NULL);
+    }
+    TEST_ASSERT_NOT_EQUAL(handled_yield_count, __atomic_load_n(&yield_count, __ATOMIC_ACQUIRE));
+}
+
+//function definition
+//wait (up to 5 seconds) for the shadow to have made the supplied number of reports
+static bool wait_for_iot_device_shadow_reports(uint32_t expected_report_count)
+{
+    //local vars
+    struct timespec step = {0, 1000000L};
+    uint32_t i;
+
+    for (i = 0; (i < 5000) && (__atomic_load_n(&report_count, __ATOMIC_ACQUIRE) < expected_report_count); i++)
+    {
+        nanosleep(&step, NULL);
+    }
+
+    return (__atomic_load_n(&report_count, __ATOMIC_ACQUIRE) >= expected_report_count);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The new_iot_device_shadow function should provide the delta rejected (the tunables in effect reported
+ *   over it, untouched) when:
+ *   - a delta, whole or streamed, holds a string value longer than a delta value may be
+ *   then a valid delta should be taken
+ */
+static void test_new_iot_device_shadow_if_delta_value_too_long_renders_delta_rejected(void)
+{
+    //local vars
+    SAT_CONFIG config;
+    SAT_CONFIG_WATCHER* watcher;
+    SAT_TUNABLES tunables;
+    IOT_DEVICE_SHADOW* shadow;
+    IOT_DEVICE_GATEWAY_SETTINGS settings;
+    char overlong_value[OVERLONG_VALUE_SIZE];
+    char document[DELTA_DOCUMENT_SIZE];
+    uint32_t generation = 0;
+    FILE* file;
+
+    //setup
+    file = fopen(expected_config_file, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs("batch_size 24\nfilters lowpass:20\n", file);
+    fclose(file);
+    TEST_ASSERT_TRUE(load_sat_config(&config, expected_config_file));
+    watcher = new_sat_config_watcher(expected_config_file, &config);
+    TEST_ASSERT_NOT_NULL(watcher);
+    memset(&settings, 0, sizeof (settings));
+    settings.host = "localhost";
+    settings.port = 8883;
+    settings.client_id = "testiotdeviceshadow";
+    memset(overlong_value, 'x', sizeof (overlong_value) - 1);
+    overlong_value[sizeof (overlong_value) - 1] = '\0';
+
+    //test the specific behavior
+    shadow = new_iot_device_shadow(&settings, "edison", watcher);
+    TEST_ASSERT_NOT_NULL(shadow);
+
+    //assert the expected results
+    //ensure the tunables in effect are reported once connected
+    TEST_ASSERT_TRUE(wait_for_iot_device_shadow_reports(1));
+    TEST_ASSERT_NOT_NULL(strstr(reported_document, "\"batch_size\":24"));
+
+    //ensure a whole delta with a value that doesn't fit is rejected (reported over), leaving what is reported as it was
+    snprintf(document, sizeof (document), "{\"version\":2,\"timestamp\":1792319094,\"state\":{\"filters\":\"%s\"}}", overlong_value);
+    hand_delta_to_iot_device_shadow(document, false);
+    TEST_ASSERT_TRUE(wait_for_iot_device_shadow_reports(2));
+    TEST_ASSERT_FALSE(get_sat_config_tunables(watcher, &generation, &tunables));
+    TEST_ASSERT_NOT_NULL(strstr(reported_document, "\"batch_size\":24"));
+    TEST_ASSERT_NOT_NULL(strstr(reported_document, "\"filters\":\"lowpass:20\""));
+    TEST_ASSERT_NULL(strstr(reported_document, "xxxx"));
+
+    //ensure the same goes for a streamed delta
+    snprintf(document, sizeof (document), "{\"version\":3,\"timestamp\":1792319094,\"state\":{\"filters\":\"%s\"}}", overlong_value);
+    hand_delta_to_iot_device_shadow(document, true);
+    TEST_ASSERT_TRUE(wait_for_iot_device_shadow_reports(3));
+    TEST_ASSERT_FALSE(get_sat_config_tunables(watcher, &generation, &tunables));
+    TEST_ASSERT_NOT_NULL(strstr(reported_document, "\"batch_size\":24"));
+    TEST_ASSERT_NOT_NULL(strstr(reported_document, "\"filters\":\"lowpass:20\""));
+    TEST_ASSERT_NULL(strstr(reported_document, "xxxx"));
+
+    //ensure a valid delta is still taken whole
+    hand_delta_to_iot_device_shadow("{\"version\":4,\"timestamp\":1792319094,\"state\":{\"accel_odr\":50,\"filters\":\"lowpass:10\"}}", false);
+    TEST_ASSERT_TRUE(get_sat_config_tunables(watcher, &generation, &tunables));
+    TEST_ASSERT_EQUAL_UINT32(24, tunables.batch_size);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, (float)tunables.accel_odr);
+    TEST_ASSERT_EQUAL_STRING("lowpass:10", tunables.filters);
+
+    //tear down
+    free_iot_device_shadow(shadow);
+    free_sat_config_watcher(watcher);
+    remove(expected_config_file);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_new_iot_device_shadow_if_delta_value_too_long_renders_delta_rejected);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -0,0 +1,251 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in stdlib.h and time.h so we can use the "setenv", "unsetenv", and "nanosleep" functions
+
+#include <stdio.h>              //using for "fopen", "fputs", "fclose", and "remove" functions
+#include <stdlib.h>             //using for "setenv" and "unsetenv" functions
+#include <string.h>             //using for "strcmp" function
+#include <time.h>               //using for "nanosleep" function
+#include <signal.h>             //using for "kill" function
+#include <unistd.h>             //using for "getpid" function
+#include "unity.h"
+#include "satconfig.h"
+
+//global vars
+static const char expected_config_file[] = "/tmp/testsatconfig.conf";
+
+//function declarations
+static void write_config_file(const char*);
+static void test_load_sat_config_if_file_has_settings_renders_defaults_overridden_by_file(void);
+static void test_load_sat_config_if_file_has_unknown_or_out_of_range_setting_renders_failure(void);
+static void test_load_sat_config_if_environment_variable_set_renders_file_overridden_by_environment(void);
+static void test_new_sat_config_watcher_if_process_gets_sighup_renders_reloaded_tunables(void);
+static void test_update_sat_config_tunables_if_some_values_invalid_renders_none_updated(void);
+
+//function definition
+//write the supplied text as the config file
+static void write_config_file(const char* text)
+{
+    //local vars
+    FILE* file = fopen(expected_config_file, "w");
+
+    TEST_ASSERT_NOT_NULL(file);
+    fputs(text, file);
+    fclose(file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The load_sat_config function should provide the defaults overridden by the file when:
+ *   - the file sets a name, a whole number, a number, a flag, a cpu list, and a tunable, among comments and blank lines
+ */
+static void test_load_sat_config_if_file_has_settings_renders_defaults_overridden_by_file(void)
+{
+    //local vars
+    SAT_CONFIG defaults;
+    SAT_CONFIG config;
+
+    //setup
+    get_default_sat_config(&defaults);
+    write_config_file("# test configuration\n\n   device_id   edison_alva2  \ngyro_odr 190 # faster\nqueue_depth 4\nreport_by_exception 1\nbus_cpus 0,2\nflush_latency_ms 100\n");
+
+    //test the specific behavior
+    TEST_ASSERT_TRUE(load_sat_config(&config, expected_config_file));
+    remove(expected_config_file);
+
+    //assert the expected results
+    //ensure the settings in the file were taken, and the rest left at their defaults
+    TEST_ASSERT_EQUAL_STRING("edison_alva2", config.device_id);
+    TEST_ASSERT_EQUAL_DOUBLE(190, config.tunables.gyro_odr);
+    TEST_ASSERT_EQUAL_UINT32(4, config.queue_depth);
+    TEST_ASSERT_TRUE(config.report_by_exception);
+    TEST_ASSERT_EQUAL_UINT64(0x5, config.bus_cpu_mask);
+    TEST_ASSERT_EQUAL_UINT32(100, config.tunables.flush_latency_ms);
+    TEST_ASSERT_EQUAL_STRING("edison_alva1", defaults.device_id);
+    TEST_ASSERT_EQUAL_STRING(defaults.aws_host, config.aws_host);
+    TEST_ASSERT_EQUAL_DOUBLE(defaults.tunables.accel_odr, config.tunables.accel_odr);
+    TEST_ASSERT_EQUAL_UINT32(defaults.processing_limit, config.processing_limit);
+    TEST_ASSERT_EQUAL_UINT32(defaults.tunables.heartbeat_interval, config.tunables.heartbeat_interval);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The load_sat_config function should provide failure when:
+ *   - the file has a misspelled key
+ *   - the file has a value out of its range
+ *   - the file has a value that isn't one of the setting's choices
+ */
+static void test_load_sat_config_if_file_has_unknown_or_out_of_range_setting_renders_failure(void)
+{
+    //local vars
+    SAT_CONFIG config;
+
+    //test the specific behavior & assert the expected results
+    write_config_file("gyro_odrr 190\n");
+    TEST_ASSERT_FALSE(load_sat_config(&config, expected_config_file));
+    write_config_file("queue_depth 1000\n");
+    TEST_ASSERT_FALSE(load_sat_config(&config, expected_config_file));
+    write_config_file("window hopping\n");
+    TEST_ASSERT_FALSE(load_sat_config(&config, expected_config_file));
+    remove(expected_config_file);
+
+    //ensure a missing file is a failure too
+    TEST_ASSERT_FALSE(load_sat_config(&config, expected_config_file));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The load_sat_config function should provide the file overridden by the environment when:
+ *   - the file and an environment variable both set the gyro output data rate
+ */
+static void test_load_sat_config_if_environment_variable_set_renders_file_overridden_by_environment(void)
+{
+    //local vars
+    SAT_CONFIG config;
+
+    //setup
+    write_config_file("gyro_odr 190\n");
+    setenv("SATCLIENT_GYRO_ODR", "380", 1);
+
+    //test the specific behavior
+    TEST_ASSERT_TRUE(load_sat_config(&config, expected_config_file));
+
+    //assert the expected results
+    TEST_ASSERT_EQUAL_DOUBLE(380, config.tunables.gyro_odr);
+
+    //ensure an invalid environment variable is a failure (rather than ignored)
+    setenv("SATCLIENT_GYRO_ODR", "fast", 1);
+    TEST_ASSERT_FALSE(load_sat_config(&config, expected_config_file));
+
+    //tear down
+    unsetenv("SATCLIENT_GYRO_ODR");
+    remove(expected_config_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The new_sat_config_watcher function should provide the reloaded tunables when:
+ *   - the file's tunables change, then the process gets SIGHUP
+ */
+static void test_new_sat_config_watcher_if_process_gets_sighup_renders_reloaded_tunables(void)
+{
+    //local vars
+    SAT_CONFIG config;
+    SAT_CONFIG_WATCHER* watcher;
+    SAT_TUNABLES tunables;
+    uint32_t generation = 0;
+    struct timespec interval = {0, 1000000};
+    uint32_t i;
+
+    //setup
+    write_config_file("batch_size 24\n");
+    TEST_ASSERT_TRUE(load_sat_config(&config, expected_config_file));
+    watcher = new_sat_config_watcher(expected_config_file, &config);
+    TEST_ASSERT_NOT_NULL(watcher);
+
+    //ensure there is nothing new before a reload
+    TEST_ASSERT_FALSE(get_sat_config_tunables(watcher, &generation, &tunables));
+
+    //test the specific behavior
+    write_config_file("batch_size 16\nflush_latency_ms 500\nheartbeat_interval 0\n");
+    kill(getpid(), SIGHUP);
+    for (i = 0; (i < 5000) && (!get_sat_config_tunables(watcher, &generation, &tunables)); i++)
+    {
+        nanosleep(&interval, NULL);
+    }
+
+    //assert the expected results
+    TEST_ASSERT_EQUAL_UINT32(1, generation);
+    TEST_ASSERT_EQUAL_UINT32(16, tunables.batch_size);
+    TEST_ASSERT_EQUAL_UINT32(500, tunables.flush_latency_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, tunables.heartbeat_interval);
+    //ensure the same generation isn't handed out twice
+    TEST_ASSERT_FALSE(get_sat_config_tunables(watcher, &generation, &tunables));
+
+    //tear down
+    free_sat_config_watcher(watcher);
+    remove(expected_config_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_sat_config_tunables function should provide none of the values updated (then all of them) when:
+ *   - an update names a setting that isn't a tunable, or holds a value that doesn't parse, then a valid update follows
+ *   - a board hands back the tunables it applied
+ */
+static void test_update_sat_config_tunables_if_some_values_invalid_renders_none_updated(void)
+{
+    //local vars
+    SAT_CONFIG config;
+    SAT_CONFIG_WATCHER* watcher;
+    SAT_TUNABLES tunables;
+    uint32_t generation = 0;
+    uint32_t applied_generation = 0;
+    const char* const restart_keys[2] = {"batch_size", "device_id"};
+    const char* const restart_values[2] = {"16", "edison_alva3"};
+    const char* const invalid_keys[2] = {"batch_size", "gyro_odr"};
+    const char* const invalid_values[2] = {"16", "fast"};
+    const char* const valid_keys[3] = {"accel_odr", "flush_latency_ms", "filters"};
+    const char* const valid_values[3] = {"50", "1000", "lowpass:10"};
+
+    //setup
+    write_config_file("batch_size 24\n");
+    TEST_ASSERT_TRUE(load_sat_config(&config, expected_config_file));
+    watcher = new_sat_config_watcher(expected_config_file, &config);
+    TEST_ASSERT_NOT_NULL(watcher);
+
+    //test the specific behavior
+    TEST_ASSERT_FALSE(update_sat_config_tunables(watcher, restart_keys, restart_values, 2));
+    TEST_ASSERT_FALSE(update_sat_config_tunables(watcher, invalid_keys, invalid_values, 2));
+
+    //assert the expected results
+    //ensure neither update was taken (not even the valid batch size)
+    TEST_ASSERT_FALSE(get_sat_config_tunables(watcher, &generation, &tunables));
+
+    //ensure a valid update is taken whole, leaving the other tunables as they were
+    TEST_ASSERT_TRUE(update_sat_config_tunables(watcher, valid_keys, valid_values, 3));
+    TEST_ASSERT_TRUE(get_sat_config_tunables(watcher, &generation, &tunables));
+    TEST_ASSERT_EQUAL_UINT32(1, generation);
+    TEST_ASSERT_EQUAL_UINT32(24, tunables.batch_size);
+    TEST_ASSERT_EQUAL_UINT32(1000, tunables.flush_latency_ms);
+    TEST_ASSERT_EQUAL_DOUBLE(50.0, tunables.accel_odr);
+    TEST_ASSERT_EQUAL_DOUBLE(95.0, tunables.gyro_odr);
+    TEST_ASSERT_EQUAL_STRING("lowpass:10", tunables.filters);
+
+    //ensure the tunables a board applied are handed out once
+    tunables.accel_odr = 100.0;
+    set_sat_config_applied_tunables(watcher, &tunables);
+    tunables.accel_odr = 0.0;
+    TEST_ASSERT_TRUE(get_sat_config_applied_tunables(watcher, &applied_generation, &tunables));
+    TEST_ASSERT_EQUAL_DOUBLE(100.0, tunables.accel_odr);
+    TEST_ASSERT_FALSE(get_sat_config_applied_tunables(watcher, &applied_generation, &tunables));
+
+    //tear down
+    free_sat_config_watcher(watcher);
+    remove(expected_config_file);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_load_sat_config_if_file_has_settings_renders_defaults_overridden_by_file);
+    RUN_TEST(test_load_sat_config_if_file_has_unknown_or_out_of_range_setting_renders_failure);
+    RUN_TEST(test_load_sat_config_if_environment_variable_set_renders_file_overridden_by_environment);
+    RUN_TEST(test_new_sat_config_watcher_if_process_gets_sighup_renders_reloaded_tunables);
+    RUN_TEST(test_update_sat_config_tunables_if_some_values_invalid_renders_none_updated);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -75,9 +75,10 @@
  * openssl enc -d -aes-256-cfb -salt -md sha256 -pass pass:"The sparrow flies at sunset." -base64 -A -in ciphertext.base64 -out plaintext.txt
  */
 
-#include <stdlib.h>         //using for "free" function and "NULL"
-#include <string.h>         //using for "strlen" function
+#include <stdlib.h>         //using for "NULL"
+#include <string.h>         //using for "strlen", "memcpy", and "memcmp" functions
 #include "unity.h"          //using unity unit testing framework/harness
+#include "satmemory.h"      //using to free the buffers the crypto functions allocate
 #include "cryptoutil.h"     //testing functions in the crypto module
 
 //global vars
@@ -96,6 +97,12 @@ static const uint8_t expected_key[] = {0xfb, 0x59, 0x27, 0xf2, 0x2e, 0xaa, 0x9b,
                                        0x0e, 0x4e, 0x37, 0xf7, 0x9b, 0x44, 0x37, 0x3c, 0x3b, 0x51, 0xfc, 0x47, 0xa8, 0xbd, 0xc2, 0x7f};
 //128-bit initialization vector generated using the passphrase and the salt
 static const uint8_t expected_iv[] = {0x37, 0x2c, 0x1e, 0xdf, 0xc6, 0x23, 0x33, 0x22, 0xf2, 0x7f, 0x6f, 0xe7, 0xd7, 0xaf, 0x34, 0x56};
+//256-bit secret key and 128-bit initialization vector generated using the passphrase, the salt, and pbkdf2 (10000 iterations), obtained by executing the following:
+//openssl enc -e -aes-256-cfb -pbkdf2 -iter 10000 -md sha256 -S CCD3729694A02D65 -pass pass:"The sparrow flies at sunset." -P
+static const uint8_t expected_pbkdf2_key[] = {0x5d, 0x6b, 0xb0, 0x10, 0xfc, 0xdf, 0x79, 0xb1, 0x53, 0xf8, 0x7e, 0x46, 0x9a, 0x49, 0x9a, 0x43, \
+                                              0x7c, 0x09, 0xc2, 0x9d, 0x58, 0x03, 0x6f, 0x4f, 0xfd, 0x98, 0xb5, 0xe0, 0xa7, 0x81, 0x72, 0x7b};
+static const uint8_t expected_pbkdf2_iv[] = {0x12, 0x62, 0xbb, 0x92, 0xe8, 0xa6, 0x20, 0x84, 0xda, 0x85, 0xc2, 0xbb, 0xf8, 0x27, 0xaf, 0xbf};
+static const uint32_t expected_pbkdf2_iteration_count = 10000;
 //salt header + ciphertext, (processed version of plaintext) generated by openssl command line utility - first 16 bytes are the salt header, remaining bytes are the ciphertext
 static const uint8_t expected_openssl_payload[] = {0x53, 0x61, 0x6c, 0x74, 0x65, 0x64, 0x5f, 0x5f, 0xcc, 0xd3, 0x72, 0x96, 0x94, 0xa0, 0x2d, 0x65, \
                                                    0x26, 0x31, 0x76, 0xdb, 0x58, 0x07, 0xd0, 0xde, 0x61, 0x25, 0x70, 0xf6, 0xca, 0x20, 0x30, 0x47, \
@@ -125,10 +132,14 @@ static const uint32_t expected_hmac_size = 32;
 //function declarations
 static void test_extract_salt_and_ciphertext_from_openssl_payload_if_valid_inputs_renders_valid_salt_and_ciphertext(void);
 static void test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_if_valid_inputs_renders_valid_key_and_iv(void);
+static void test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf_if_pbkdf2_renders_valid_key_and_iv(void);
 static void test_compute_aes256cfb_cipher_if_decrypt_mode_and_valid_inputs_renders_valid_plaintext(void);
 static void test_compute_sha256_hmac_if_valid_inputs_renders_valid_hmac(void);
 static void test_compute_base64_encode_if_valid_inputs_renders_valid_encoded_text_string(void);
 static void test_compute_base64_decode_if_valid_inputs_renders_valid_decoded_byte_data(void);
+static void test_open_sealed_telemetry_batch_if_sealed_with_same_key_renders_valid_plaintext(void);
+static void test_open_sealed_telemetry_batch_if_ciphertext_tampered_renders_failure(void);
+static void test_seal_telemetry_batch_if_contexts_share_master_key_renders_distinct_salts_and_batches_each_opens(void);
 int main(void);
 
 //function definition
@@ -178,8 +189,8 @@ static void test_extract_salt_and_ciphertext_from_openssl_payload_if_valid_input
     TEST_ASSERT_EQUAL_HEX8(expected_openssl_payload_ciphertext[expected_openssl_payload_ciphertext_size - 1], openssl_payload_ciphertext[openssl_payload_ciphertext_size - 1]); //end
 
     //free buffers
-    free(openssl_payload_salt);
-    free(openssl_payload_ciphertext);
+    free_sat_memory(openssl_payload_salt);
+    free_sat_memory(openssl_payload_ciphertext);
 }
 
 //function definition
@@ -215,8 +226,41 @@ static void test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_if_
     TEST_ASSERT_EQUAL_HEX8(expected_iv[expected_iv_size - 1], iv[iv_size - 1]); //end
 
     //free buffers
-    free(key);
-    free(iv);
+    free_sat_memory(key);
+    free_sat_memory(iv);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf function should provide the expected key and iv values when:
+ *   - the PBKDF2_SHA256 kdf is selected with the iteration count used by the openssl command line utility
+ *   - a valid passphrase and salt are supplied
+ */
+static void test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf_if_pbkdf2_renders_valid_key_and_iv(void)
+{
+    //local vars
+    bool operation_status;
+    uint8_t* key;
+    uint32_t key_size;
+    uint8_t* iv;
+    uint32_t iv_size;
+
+    //test the specific behavior
+    operation_status = derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf(PBKDF2_SHA256, expected_pbkdf2_iteration_count, expected_passphrase, expected_passphrase_size, expected_openssl_payload_salt, expected_openssl_payload_salt_size, &key, &key_size, &iv, &iv_size);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the size of the outputted byte arrays match the expected sizes
+    TEST_ASSERT_EQUAL_INT(expected_key_size, key_size);
+    TEST_ASSERT_EQUAL_INT(expected_iv_size, iv_size);
+    //ensure the key and iv match those produced by "openssl enc -pbkdf2"
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_pbkdf2_key, key, expected_key_size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_pbkdf2_iv, iv, expected_iv_size);
+
+    //free buffers
+    free_sat_memory(key);
+    free_sat_memory(iv);
 }
 
 //function definition
@@ -248,7 +292,7 @@ static void test_compute_aes256cfb_cipher_if_decrypt_mode_and_valid_inputs_rende
     TEST_ASSERT_EQUAL_HEX8(expected_plaintext[expected_plaintext_size - 1], plaintext[plaintext_size - 1]); //end
 
     //free buffer
-    free(plaintext);
+    free_sat_memory(plaintext);
 }
 
 //function definition
@@ -278,7 +322,7 @@ static void test_compute_sha256_hmac_if_valid_inputs_renders_valid_hmac(void)
     TEST_ASSERT_EQUAL_HEX8(expected_hmac[expected_hmac_size - 1], hmac[hmac_size - 1]); //end
 
     //free buffer
-    free(hmac);
+    free_sat_memory(hmac);
 }
 
 //function definition
@@ -307,7 +351,7 @@ static void test_compute_base64_encode_if_valid_inputs_renders_valid_encoded_tex
     TEST_ASSERT_EQUAL_STRING(expected_base64_encoded_string, base64_encoded_string);
 
     //free buffer
-    free(base64_encoded_string);
+    free_sat_memory(base64_encoded_string);
 }
 
 //function definition
@@ -339,7 +383,132 @@ static void test_compute_base64_decode_if_valid_inputs_renders_valid_decoded_byt
     TEST_ASSERT_EQUAL_HEX8(expected_base64_decoded_byte_data[expected_base64_decoded_byte_data_size - 1], base64_decoded_byte_data[base64_decoded_byte_data_size - 1]); //end
 
     //free buffer
-    free(base64_decoded_byte_data);
+    free_sat_memory(base64_decoded_byte_data);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The open_sealed_telemetry_batch function should provide the expected plaintext when:
+ *   - the batch was sealed in place by seal_telemetry_batch using a context initialized with the same master key
+ *   - the nonce, tag, and additional authenticated data produced/used by seal_telemetry_batch are supplied
+ */
+static void test_open_sealed_telemetry_batch_if_sealed_with_same_key_renders_valid_plaintext(void)
+{
+    //local vars
+    bool operation_status;
+    SEALED_BATCH_CONTEXT sealing_context;
+    SEALED_BATCH_CONTEXT opening_context;
+    uint8_t batch[45];
+    uint8_t nonce[SEALED_BATCH_NONCE_SIZE_BYTES];
+    uint8_t tag[SEALED_BATCH_TAG_SIZE_BYTES];
+    const uint8_t aad[] = {0x01, 0x00, 0x2d, 0x00}; //stand-in batch header
+
+    //setup
+    memcpy(batch, expected_plaintext, expected_plaintext_size);
+    TEST_ASSERT_TRUE(init_sealed_batch_context(&sealing_context, get_preferred_aead_cipher(), expected_key, expected_key_size));
+    TEST_ASSERT_TRUE(init_sealed_batch_context(&opening_context, get_preferred_aead_cipher(), expected_key, expected_key_size));
+    TEST_ASSERT_TRUE(seal_telemetry_batch(&sealing_context, aad, sizeof (aad), batch, expected_plaintext_size, nonce, tag));
+    //the batch should no longer hold the plaintext
+    TEST_ASSERT_TRUE(memcmp(batch, expected_plaintext, expected_plaintext_size) != 0);
+
+    //test the specific behavior
+    operation_status = open_sealed_telemetry_batch(&opening_context, aad, sizeof (aad), batch, expected_plaintext_size, nonce, tag);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the batch holds the original plaintext again
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_plaintext, batch, expected_plaintext_size);
+
+    //tear down
+    shutdown_sealed_batch_context(&sealing_context);
+    shutdown_sealed_batch_context(&opening_context);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The open_sealed_telemetry_batch function should provide failure (and a zeroed batch) when:
+ *   - a single bit of the sealed batch is flipped after sealing
+ */
+static void test_open_sealed_telemetry_batch_if_ciphertext_tampered_renders_failure(void)
+{
+    //local vars
+    bool operation_status;
+    SEALED_BATCH_CONTEXT sbcontext;
+    uint8_t batch[45];
+    uint8_t nonce[SEALED_BATCH_NONCE_SIZE_BYTES];
+    uint8_t tag[SEALED_BATCH_TAG_SIZE_BYTES];
+    const uint8_t zeroed_batch[45] = {0};
+
+    //setup
+    memcpy(batch, expected_plaintext, expected_plaintext_size);
+    TEST_ASSERT_TRUE(init_sealed_batch_context(&sbcontext, get_preferred_aead_cipher(), expected_key, expected_key_size));
+    TEST_ASSERT_TRUE(seal_telemetry_batch(&sbcontext, NULL, 0, batch, expected_plaintext_size, nonce, tag));
+    batch[expected_plaintext_size / 2] ^= 0x01;
+
+    //test the specific behavior
+    operation_status = open_sealed_telemetry_batch(&sbcontext, NULL, 0, batch, expected_plaintext_size, nonce, tag);
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+    //ensure no unauthenticated plaintext was handed back
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(zeroed_batch, batch, expected_plaintext_size);
+
+    //tear down
+    shutdown_sealed_batch_context(&sbcontext);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The seal_telemetry_batch function should provide nonces with distinct salts (batches every context opens) when:
+ *   - two contexts (e.g., before and after a restart) are initialized with the same master key and each seals its first batch
+ *   - one context opens the other's batch (rekeying it to the other's subkey), then seals another batch of its own
+ */
+static void test_seal_telemetry_batch_if_contexts_share_master_key_renders_distinct_salts_and_batches_each_opens(void)
+{
+    //local vars
+    SEALED_BATCH_CONTEXT first_context;
+    SEALED_BATCH_CONTEXT second_context;
+    uint8_t batches[3][45];
+    uint8_t nonces[3][SEALED_BATCH_NONCE_SIZE_BYTES];
+    uint8_t tags[3][SEALED_BATCH_TAG_SIZE_BYTES];
+    const uint8_t zeroed_counter[SEALED_BATCH_NONCE_SIZE_BYTES - SEALED_BATCH_SALT_SIZE_BYTES] = {0};
+    uint32_t i;
+
+    //setup
+    for (i = 0; i < 3; i++)
+    {
+        memcpy(batches[i], expected_plaintext, expected_plaintext_size);
+    }
+    TEST_ASSERT_TRUE(init_sealed_batch_context(&first_context, get_preferred_aead_cipher(), expected_key, expected_key_size));
+    TEST_ASSERT_TRUE(init_sealed_batch_context(&second_context, get_preferred_aead_cipher(), expected_key, expected_key_size));
+
+    //test the specific behavior
+    TEST_ASSERT_TRUE(seal_telemetry_batch(&first_context, NULL, 0, batches[0], expected_plaintext_size, nonces[0], tags[0]));
+    TEST_ASSERT_TRUE(seal_telemetry_batch(&second_context, NULL, 0, batches[1], expected_plaintext_size, nonces[1], tags[1]));
+
+    //assert the expected results
+    //ensure both first batches carry counter zero, but under different salts (so different subkeys, and different ciphertexts)
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(zeroed_counter, &(nonces[0][SEALED_BATCH_SALT_SIZE_BYTES]), sizeof (zeroed_counter));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(zeroed_counter, &(nonces[1][SEALED_BATCH_SALT_SIZE_BYTES]), sizeof (zeroed_counter));
+    TEST_ASSERT_TRUE(memcmp(nonces[0], nonces[1], SEALED_BATCH_SALT_SIZE_BYTES) != 0);
+    TEST_ASSERT_TRUE(memcmp(batches[0], batches[1], expected_plaintext_size) != 0);
+
+    //ensure the second context opens the first's batch, then still seals under its own salt (counter one) a batch the first context opens
+    TEST_ASSERT_TRUE(open_sealed_telemetry_batch(&second_context, NULL, 0, batches[0], expected_plaintext_size, nonces[0], tags[0]));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_plaintext, batches[0], expected_plaintext_size);
+    TEST_ASSERT_TRUE(seal_telemetry_batch(&second_context, NULL, 0, batches[2], expected_plaintext_size, nonces[2], tags[2]));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(nonces[1], nonces[2], SEALED_BATCH_SALT_SIZE_BYTES);
+    TEST_ASSERT_EQUAL_UINT8(1, nonces[2][SEALED_BATCH_NONCE_SIZE_BYTES - 1]);
+    TEST_ASSERT_TRUE(open_sealed_telemetry_batch(&first_context, NULL, 0, batches[2], expected_plaintext_size, nonces[2], tags[2]));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_plaintext, batches[2], expected_plaintext_size);
+    TEST_ASSERT_TRUE(open_sealed_telemetry_batch(&first_context, NULL, 0, batches[1], expected_plaintext_size, nonces[1], tags[1]));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_plaintext, batches[1], expected_plaintext_size);
+
+    //tear down
+    shutdown_sealed_batch_context(&first_context);
+    shutdown_sealed_batch_context(&second_context);
 }
 
 //function definition
@@ -352,10 +521,14 @@ int main(void)
     //run tests
     RUN_TEST(test_extract_salt_and_ciphertext_from_openssl_payload_if_valid_inputs_renders_valid_salt_and_ciphertext);
     RUN_TEST(test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_if_valid_inputs_renders_valid_key_and_iv);
+    RUN_TEST(test_derive_aes256cfb_cipher_key_and_iv_from_passphrase_and_salt_using_kdf_if_pbkdf2_renders_valid_key_and_iv);
     RUN_TEST(test_compute_aes256cfb_cipher_if_decrypt_mode_and_valid_inputs_renders_valid_plaintext);
     RUN_TEST(test_compute_sha256_hmac_if_valid_inputs_renders_valid_hmac);
     RUN_TEST(test_compute_base64_encode_if_valid_inputs_renders_valid_encoded_text_string);
     RUN_TEST(test_compute_base64_decode_if_valid_inputs_renders_valid_decoded_byte_data);
+    RUN_TEST(test_open_sealed_telemetry_batch_if_sealed_with_same_key_renders_valid_plaintext);
+    RUN_TEST(test_open_sealed_telemetry_batch_if_ciphertext_tampered_renders_failure);
+    RUN_TEST(test_seal_telemetry_batch_if_contexts_share_master_key_renders_distinct_salts_and_batches_each_opens);
 
     //tear down & display test results, returns the number of tests that failed
     return UNITY_END();
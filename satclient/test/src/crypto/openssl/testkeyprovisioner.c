@@ -0,0 +1,376 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+
+   Each payload is encrypted by the suite (with a cheap pbkdf2 cost) and written to a temporary file. The derived key
+   cache is sealed with the key kept in the kernel user keyring (created by the first cold start if it isn't there).
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in stdlib.h so we can use the "setenv" and "unsetenv" functions
+
+#include <stdio.h>                  //using for "fopen", "fputs", "fclose", and "remove" functions
+#include <stdlib.h>                 //using for "setenv", "unsetenv", and "getenv" functions
+#include <string.h>                 //using for "memset" and "strlen" functions
+#include <errno.h>                  //using for "errno" and "EBADF"
+#include <fcntl.h>                  //using for "fcntl" function
+#include <unistd.h>                 //using for "pipe", "write", "close", and "access" functions
+#include "unity.h"
+#include "satmemory.h"              //using to free the plaintext
+#include "keyprovisioner.h"
+
+//global vars
+static const char expected_payload_file[] = "/tmp/testkeyprovisioner.key";
+static const char expected_cache_file[] = "/tmp/testkeyprovisioner.cache";
+static const char expected_passphrase_env_name[] = "TESTKEYPROVISIONER_PASSPHRASE";
+static const char expected_passphrase[] = "The sparrow flies at sunset.";
+static const char expected_secret_key[] = "q8Xz2Fv0oB7nq1H0i3c1mJt5ZyN6mX0k8zq9z0a1b2c=";
+static const uint32_t expected_pbkdf2_iteration_count = 1000;
+#define TOO_LONG_PASSPHRASE_SIZE_BYTES 1025         //one byte longer than the provisioner accepts
+
+//function declarations
+static void write_payload_file(const char*);
+static void get_test_config(KEY_PROVISIONING_CONFIG*);
+static void test_provision_secret_key_if_passphrase_from_fd_renders_valid_plaintext_and_fd_closed(void);
+static void test_provision_secret_key_if_passphrase_from_environment_renders_valid_plaintext_and_variable_unset(void);
+static void test_provision_secret_key_if_passphrase_too_long_renders_failure(void);
+static void test_provision_secret_key_if_cache_written_by_cold_start_renders_warm_start(void);
+static void test_provision_secret_key_if_cache_header_mismatched_renders_cold_start(void);
+static void test_provision_secret_key_if_plaintext_only_line_feed_renders_failure(void);
+static void test_invalidate_derived_key_cache_if_file_missing_renders_success(void);
+int main(void);
+
+//function definition
+//encrypt the supplied plaintext with the passphrase (pbkdf2, fresh salt) and write it as the payload file
+static void write_payload_file(const char* plaintext)
+{
+    //local vars
+    char* base64_encoded_openssl_payload;
+    FILE* file;
+
+    TEST_ASSERT_TRUE(encrypt_to_base64_encoded_openssl_payload((const uint8_t*)expected_passphrase, (uint32_t)strlen(expected_passphrase), PBKDF2_SHA256, expected_pbkdf2_iteration_count, (const uint8_t*)plaintext, (uint32_t)strlen(plaintext), &base64_encoded_openssl_payload));
+    file = fopen(expected_payload_file, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs(base64_encoded_openssl_payload, file);
+    fputs("\n", file);
+    fclose(file);
+    free_sat_memory(base64_encoded_openssl_payload);
+}
+
+//function definition
+//a config reading the payload file, with no passphrase source, no cache, and no prompts (tests add what they need)
+static void get_test_config(KEY_PROVISIONING_CONFIG* config)
+{
+    config->payload_file_location = expected_payload_file;
+    config->passphrase_fd = -1;
+    config->passphrase_env_name = expected_passphrase_env_name;
+    config->passphrase_keyring_description = NULL;
+    config->kdf = PBKDF2_SHA256;
+    config->kdf_cost = expected_pbkdf2_iteration_count;
+    config->derived_key_cache_location = NULL;
+    config->allow_interactive_prompt = false;
+    unsetenv(expected_passphrase_env_name);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide the secret key (and the fd closed) when:
+ *   - the passphrase is written to a pipe whose read end is the configured fd
+ */
+static void test_provision_secret_key_if_passphrase_from_fd_renders_valid_plaintext_and_fd_closed(void)
+{
+    //local vars
+    bool operation_status;
+    KEY_PROVISIONING_CONFIG config;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+    int pipe_fds[2];
+
+    //setup
+    write_payload_file(expected_secret_key);
+    get_test_config(&config);
+    TEST_ASSERT_EQUAL_INT(0, pipe(pipe_fds));
+    TEST_ASSERT_EQUAL_INT((int)strlen(expected_passphrase), (int)write(pipe_fds[1], expected_passphrase, strlen(expected_passphrase)));
+    TEST_ASSERT_EQUAL_INT(1, (int)write(pipe_fds[1], "\n", 1));
+    close(pipe_fds[1]);
+    config.passphrase_fd = pipe_fds[0];
+
+    //test the specific behavior
+    operation_status = provision_secret_key(&config, &plaintext, &plaintext_size, NULL);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected_secret_key), plaintext_size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_secret_key, plaintext, plaintext_size);
+    //ensure the fd was closed once read
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, fcntl(pipe_fds[0], F_GETFD));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+
+    //tear down
+    free_sat_memory(plaintext);
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide the secret key (and the variable unset) when:
+ *   - the passphrase is held in the configured environment variable
+ */
+static void test_provision_secret_key_if_passphrase_from_environment_renders_valid_plaintext_and_variable_unset(void)
+{
+    //local vars
+    bool operation_status;
+    KEY_PROVISIONING_CONFIG config;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+
+    //setup
+    write_payload_file(expected_secret_key);
+    get_test_config(&config);
+    setenv(expected_passphrase_env_name, expected_passphrase, 1);
+
+    //test the specific behavior
+    operation_status = provision_secret_key(&config, &plaintext, &plaintext_size, NULL);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected_secret_key), plaintext_size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_secret_key, plaintext, plaintext_size);
+    //ensure the variable was unset once read (so child processes don't inherit it)
+    TEST_ASSERT_NULL(getenv(expected_passphrase_env_name));
+
+    //tear down
+    free_sat_memory(plaintext);
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide failure (rather than a passphrase cut short) when:
+ *   - the passphrase read from the fd is longer than the provisioner accepts (the fd is still closed)
+ *   - the passphrase held in the environment variable is longer than the provisioner accepts (the variable is still unset)
+ */
+static void test_provision_secret_key_if_passphrase_too_long_renders_failure(void)
+{
+    //local vars
+    KEY_PROVISIONING_CONFIG config;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+    char too_long_passphrase[TOO_LONG_PASSPHRASE_SIZE_BYTES + 1];
+    int pipe_fds[2];
+
+    //setup
+    write_payload_file(expected_secret_key);
+    memset(too_long_passphrase, 'p', TOO_LONG_PASSPHRASE_SIZE_BYTES);
+    too_long_passphrase[TOO_LONG_PASSPHRASE_SIZE_BYTES] = '\0';
+
+    //test the specific behavior, assert the expected results
+    //ensure a too long passphrase from the fd isn't used (nor the environment variable tried after it)
+    get_test_config(&config);
+    TEST_ASSERT_EQUAL_INT(0, pipe(pipe_fds));
+    TEST_ASSERT_EQUAL_INT(TOO_LONG_PASSPHRASE_SIZE_BYTES, (int)write(pipe_fds[1], too_long_passphrase, TOO_LONG_PASSPHRASE_SIZE_BYTES));
+    TEST_ASSERT_EQUAL_INT(1, (int)write(pipe_fds[1], "\n", 1));
+    close(pipe_fds[1]);
+    config.passphrase_fd = pipe_fds[0];
+    setenv(expected_passphrase_env_name, expected_passphrase, 1);
+    TEST_ASSERT_FALSE(provision_secret_key(&config, &plaintext, &plaintext_size, NULL));
+    TEST_ASSERT_NULL(plaintext);
+    TEST_ASSERT_EQUAL_INT(-1, fcntl(pipe_fds[0], F_GETFD));
+
+    //ensure a too long passphrase from the environment variable isn't used
+    get_test_config(&config);
+    setenv(expected_passphrase_env_name, too_long_passphrase, 1);
+    TEST_ASSERT_FALSE(provision_secret_key(&config, &plaintext, &plaintext_size, NULL));
+    TEST_ASSERT_NULL(plaintext);
+    TEST_ASSERT_NULL(getenv(expected_passphrase_env_name));
+
+    //tear down
+    unsetenv(expected_passphrase_env_name);
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide a warm start (the secret key without a passphrase) when:
+ *   - a cold start (passphrase from the environment variable) has written the derived key cache
+ */
+static void test_provision_secret_key_if_cache_written_by_cold_start_renders_warm_start(void)
+{
+    //local vars
+    KEY_PROVISIONING_CONFIG config;
+    KEY_PROVISIONING_REPORT report;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+
+    //setup
+    write_payload_file(expected_secret_key);
+    get_test_config(&config);
+    config.derived_key_cache_location = expected_cache_file;
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+
+    //test the specific behavior, assert the expected results
+    //ensure the first start is cold and writes the cache
+    setenv(expected_passphrase_env_name, expected_passphrase, 1);
+    TEST_ASSERT_TRUE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_FALSE(report.warm_start);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_secret_key, plaintext, plaintext_size);
+    TEST_ASSERT_EQUAL_INT(0, access(expected_cache_file, F_OK));
+    free_sat_memory(plaintext);
+    plaintext = NULL;
+
+    //ensure the next start is warm (no passphrase source is left)
+    TEST_ASSERT_NULL(getenv(expected_passphrase_env_name));
+    TEST_ASSERT_TRUE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_TRUE(report.warm_start);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected_secret_key), plaintext_size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_secret_key, plaintext, plaintext_size);
+
+    //tear down
+    free_sat_memory(plaintext);
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide a cold start (failure, with no passphrase source) when:
+ *   - the cache was written for a different kdf cost, kdf, or payload salt
+ *   while the unchanged configuration still starts warm
+ */
+static void test_provision_secret_key_if_cache_header_mismatched_renders_cold_start(void)
+{
+    //local vars
+    KEY_PROVISIONING_CONFIG config;
+    KEY_PROVISIONING_REPORT report;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+
+    //setup
+    write_payload_file(expected_secret_key);
+    get_test_config(&config);
+    config.derived_key_cache_location = expected_cache_file;
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+    setenv(expected_passphrase_env_name, expected_passphrase, 1);
+    TEST_ASSERT_TRUE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_FALSE(report.warm_start);
+    free_sat_memory(plaintext);
+    plaintext = NULL;
+
+    //test the specific behavior, assert the expected results
+    //ensure a different kdf cost isn't started warm
+    config.kdf_cost = expected_pbkdf2_iteration_count + 1;
+    TEST_ASSERT_FALSE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_FALSE(report.warm_start);
+    TEST_ASSERT_NULL(plaintext);
+    config.kdf_cost = expected_pbkdf2_iteration_count;
+
+    //ensure a different kdf isn't started warm
+    config.kdf = OPENSSL_BYTESTOKEY;
+    TEST_ASSERT_FALSE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_FALSE(report.warm_start);
+    TEST_ASSERT_NULL(plaintext);
+    config.kdf = PBKDF2_SHA256;
+
+    //ensure the cache is still good for the configuration it was written for
+    TEST_ASSERT_TRUE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_TRUE(report.warm_start);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_secret_key, plaintext, plaintext_size);
+    free_sat_memory(plaintext);
+    plaintext = NULL;
+
+    //ensure a payload with a different salt (the same secret key re-encrypted) isn't started warm
+    write_payload_file(expected_secret_key);
+    TEST_ASSERT_FALSE(provision_secret_key(&config, &plaintext, &plaintext_size, &report));
+    TEST_ASSERT_FALSE(report.warm_start);
+    TEST_ASSERT_NULL(plaintext);
+
+    //tear down
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The provision_secret_key function should provide failure (and no plaintext to free) when:
+ *   - the payload decrypts to a line feed alone (nothing is left once it's stripped)
+ */
+static void test_provision_secret_key_if_plaintext_only_line_feed_renders_failure(void)
+{
+    //local vars
+    bool operation_status;
+    KEY_PROVISIONING_CONFIG config;
+    uint8_t* plaintext = NULL;
+    uint32_t plaintext_size = 0;
+
+    //setup
+    write_payload_file("\n");
+    get_test_config(&config);
+    setenv(expected_passphrase_env_name, expected_passphrase, 1);
+
+    //test the specific behavior
+    operation_status = provision_secret_key(&config, &plaintext, &plaintext_size, NULL);
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+    TEST_ASSERT_NULL(plaintext);
+
+    //tear down
+    remove(expected_payload_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The invalidate_derived_key_cache function should provide success when:
+ *   - the cache file doesn't exist (a missing cache is already invalid)
+ *   - the cache file exists (it's removed)
+ */
+static void test_invalidate_derived_key_cache_if_file_missing_renders_success(void)
+{
+    //local vars
+    KEY_PROVISIONING_CONFIG config;
+    FILE* file;
+
+    //setup
+    get_test_config(&config);
+    config.derived_key_cache_location = expected_cache_file;
+    remove(expected_cache_file);
+
+    //test the specific behavior, assert the expected results
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+    file = fopen(expected_cache_file, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fclose(file);
+    TEST_ASSERT_TRUE(invalidate_derived_key_cache(&config));
+    TEST_ASSERT_EQUAL_INT(-1, access(expected_cache_file, F_OK));
+
+    //ensure a config without a cache can't be invalidated
+    config.derived_key_cache_location = NULL;
+    TEST_ASSERT_FALSE(invalidate_derived_key_cache(&config));
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_provision_secret_key_if_passphrase_from_fd_renders_valid_plaintext_and_fd_closed);
+    RUN_TEST(test_provision_secret_key_if_passphrase_from_environment_renders_valid_plaintext_and_variable_unset);
+    RUN_TEST(test_provision_secret_key_if_passphrase_too_long_renders_failure);
+    RUN_TEST(test_provision_secret_key_if_cache_written_by_cold_start_renders_warm_start);
+    RUN_TEST(test_provision_secret_key_if_cache_header_mismatched_renders_cold_start);
+    RUN_TEST(test_provision_secret_key_if_plaintext_only_line_feed_renders_failure);
+    RUN_TEST(test_invalidate_derived_key_cache_if_file_missing_renders_success);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
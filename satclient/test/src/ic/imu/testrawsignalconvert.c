@@ -0,0 +1,110 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include "unity.h"
+#include "rawsignalconvert.h"
+
+//global vars
+#define WORD_SAMPLE_COUNT 21851     //enough samples for every 16 bit word to appear in the buffer, plus a tail that doesn't fill a vector
+static const float expected_scale_factor = 0.000061f;
+static uint8_t buffer[WORD_SAMPLE_COUNT * 6];
+static float expected_x[WORD_SAMPLE_COUNT];
+static float expected_y[WORD_SAMPLE_COUNT];
+static float expected_z[WORD_SAMPLE_COUNT];
+static float x[WORD_SAMPLE_COUNT];
+static float y[WORD_SAMPLE_COUNT];
+static float z[WORD_SAMPLE_COUNT];
+
+//function declarations
+static void test_convert_raw_signal_buffer_if_scalar_kernel_renders_valid_columns(void);
+static void test_convert_raw_signal_buffer_if_available_vector_kernels_renders_same_columns_as_scalar_kernel(void);
+
+//function definition
+/*
+ *   Behavior Tested: The convert_raw_signal_buffer function should provide valid x, y, and z columns when:
+ *   - the scalar kernel is used on a buffer holding the bytes 1E F8 01 00 FF 7F (little endian words 0xF81E = -2018, 0x0001 = 1, 0x7FFF = 32767)
+ */
+static void test_convert_raw_signal_buffer_if_scalar_kernel_renders_valid_columns(void)
+{
+    //local vars
+    bool operation_status;
+    const uint8_t raw_buffer[] = {0x1E, 0xF8, 0x01, 0x00, 0xFF, 0x7F};
+    float column_x;
+    float column_y;
+    float column_z;
+
+    //test the specific behavior
+    operation_status = convert_raw_signal_buffer(SCALAR_CONVERSION_KERNEL, raw_buffer, 1, expected_scale_factor, &column_x, &column_y, &column_z);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure each axis is the word times the scale factor (exactly, as a float multiply)
+    TEST_ASSERT_TRUE(column_x == (float)-2018 * expected_scale_factor);
+    TEST_ASSERT_TRUE(column_y == (float)1 * expected_scale_factor);
+    TEST_ASSERT_TRUE(column_z == (float)32767 * expected_scale_factor);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The convert_raw_signal_buffer function should provide bit identical columns to the scalar kernel when:
+ *   - each vectorized kernel this host supports is used
+ *   - the buffer holds every 16 bit word, and its length is not a multiple of any vector width
+ */
+static void test_convert_raw_signal_buffer_if_available_vector_kernels_renders_same_columns_as_scalar_kernel(void)
+{
+    //local vars
+    const RAW_SIGNAL_CONVERSION_KERNEL kernels[] = {SSE2_CONVERSION_KERNEL, AVX2_CONVERSION_KERNEL, NEON_CONVERSION_KERNEL};
+    uint16_t word;
+    uint32_t i;
+
+    //setup
+    //consecutive words, so the buffer holds every word (spread across the three axes)
+    for (i = 0; i < (WORD_SAMPLE_COUNT * 3); i++)
+    {
+        word = (uint16_t)i;
+        buffer[(i * 2)] = (uint8_t)(word & 0xFF);
+        buffer[(i * 2) + 1] = (uint8_t)(word >> 8);
+    }
+    TEST_ASSERT_TRUE(convert_raw_signal_buffer(SCALAR_CONVERSION_KERNEL, buffer, WORD_SAMPLE_COUNT, expected_scale_factor, expected_x, expected_y, expected_z));
+
+    for (i = 0; i < (sizeof (kernels) / sizeof (kernels[0])); i++)
+    {
+        //skip kernels this host can't run
+        if (!is_raw_signal_conversion_kernel_available(kernels[i]))
+        {
+            continue;
+        }
+
+        //test the specific behavior
+        //the function should return "true" denoting operation success
+        TEST_ASSERT_TRUE(convert_raw_signal_buffer(kernels[i], buffer, WORD_SAMPLE_COUNT, expected_scale_factor, x, y, z));
+
+        //assert the expected results
+        //ensure every column is bit identical to the scalar kernel's
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected_x, x, sizeof (x), get_raw_signal_conversion_kernel_name(kernels[i]));
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected_y, y, sizeof (y), get_raw_signal_conversion_kernel_name(kernels[i]));
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected_z, z, sizeof (z), get_raw_signal_conversion_kernel_name(kernels[i]));
+    }
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_convert_raw_signal_buffer_if_scalar_kernel_renders_valid_columns);
+    RUN_TEST(test_convert_raw_signal_buffer_if_available_vector_kernels_renders_same_columns_as_scalar_kernel);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <stdio.h>              //using for "fopen", "fseek", "fwrite", "fclose", and "remove" functions
+#include <stddef.h>             //using for "offsetof" macro
+#include "unity.h"
+#include "columnarsink.h"
+#include "columnarfile.h"
+
+//global vars
+#define TEST_BATCH_SAMPLE_COUNT 30      //doesn't divide the samples per page, so a batch straddles each page boundary
+static const char expected_columnar_file[] = "/tmp/testcolumnarsink.col";
+static TELEMETRY_BATCH batch;           //batch reused for every publish
+
+//function declarations
+static int16_t get_test_axis_value(uint32_t, uint32_t);
+static void publish_test_samples(TELEMETRY_SINK*, uint32_t, uint32_t);
+static void assert_test_samples_in_page(const COLUMNAR_PAGE_VIEW*, uint32_t, uint32_t);
+static void write_columnar_file_bytes(long, const void*, size_t);
+static void test_open_columnar_file_reader_if_samples_span_page_boundary_renders_every_sample_round_tripped(void);
+static void test_get_columnar_file_sample_count_if_writer_mid_page_renders_only_committed_samples(void);
+static void test_open_columnar_file_reader_if_bad_magic_or_page_size_renders_failure(void);
+
+//function definition
+//deterministic stand-in for a raw axis value, so what is read back can be checked
+static int16_t get_test_axis_value(uint32_t sample_index, uint32_t axis)
+{
+    return (int16_t)((sample_index * 31) + (axis * 4099) + 1);
+}
+
+//function definition
+//publish samples first_sample_index onwards (sample_count of them, 10ms apart) in batches of TEST_BATCH_SAMPLE_COUNT
+static void publish_test_samples(TELEMETRY_SINK* sink, uint32_t first_sample_index, uint32_t sample_count)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t sample_index = first_sample_index;
+    uint32_t axis;
+
+    set_sample_batch_scale_factors(&(batch.samples), 0.000061, 0.00008, 0.00875);
+    while (sample_index < (first_sample_index + sample_count))
+    {
+        clear_telemetry_batch(&batch);
+        while ((batch.samples.sample_count < TEST_BATCH_SAMPLE_COUNT) && (sample_index < (first_sample_index + sample_count)))
+        {
+            for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+            {
+                values[axis] = get_test_axis_value(sample_index, axis);
+            }
+            append_sample_to_sample_batch(&(batch.samples), (int64_t)sample_index * 10000000, values);
+            sample_index++;
+        }
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(sink, &batch));
+    }
+}
+
+//function definition
+//assert a page view holds sample_count samples, starting at first_sample_index, with the expected columns
+static void assert_test_samples_in_page(const COLUMNAR_PAGE_VIEW* view, uint32_t first_sample_index, uint32_t sample_count)
+{
+    //local vars
+    uint32_t i;
+    uint32_t axis;
+
+    TEST_ASSERT_EQUAL_UINT32(sample_count, view->sample_count);
+    for (i = 0; i < sample_count; i++)
+    {
+        TEST_ASSERT_EQUAL_INT64((int64_t)(first_sample_index + i) * 10000000, view->timestamps_ns[i]);
+        for (axis = 0; axis < COLUMNAR_FILE_AXIS_COUNT; axis++)
+        {
+            TEST_ASSERT_EQUAL_INT16(get_test_axis_value(first_sample_index + i, axis), view->axes[axis][i]);
+        }
+    }
+}
+
+//function definition
+//overwrite bytes of the columnar file at the supplied offset
+static void write_columnar_file_bytes(long offset, const void* bytes, size_t size)
+{
+    //local vars
+    FILE* file = fopen(expected_columnar_file, "r+b");
+
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(0, fseek(file, offset, SEEK_SET));
+    TEST_ASSERT_EQUAL_UINT64(size, fwrite(bytes, 1, size, file));
+    fclose(file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The open_columnar_file_reader function should provide every sample written (with the scale factors) when:
+ *   - the columnar sink writes more samples than a page holds (a batch straddling the page boundary), is closed, and the file is read back
+ */
+static void test_open_columnar_file_reader_if_samples_span_page_boundary_renders_every_sample_round_tripped(void)
+{
+    //local vars
+    const uint32_t sample_count = COLUMNAR_FILE_SAMPLES_PER_PAGE + 100;
+    TELEMETRY_SINK* sink;
+    COLUMNAR_FILE_READER reader;
+    COLUMNAR_PAGE_VIEW view;
+    bool operation_status;
+
+    //setup
+    sink = new_columnar_telemetry_sink(expected_columnar_file);
+    TEST_ASSERT_NOT_NULL(sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(sink));
+    publish_test_samples(sink, 0, sample_count);
+    TEST_ASSERT_TRUE(flush_telemetry_sink(sink));
+    TEST_ASSERT_TRUE(close_telemetry_sink(sink));
+    free_telemetry_sink(sink);
+
+    //test the specific behavior
+    operation_status = open_columnar_file_reader(&reader, expected_columnar_file);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure every sample is readable, a full first page and the rest in the second (with nothing past it), and the scale factors were recorded
+    TEST_ASSERT_EQUAL_UINT64(sample_count, get_columnar_file_sample_count(&reader));
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 0.000061, reader.header->scale_factors[COLUMNAR_ACCEL_X]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 0.00008, reader.header->scale_factors[COLUMNAR_MAGNETO_Y]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 0.00875, reader.header->scale_factors[COLUMNAR_GYRO_Z]);
+    TEST_ASSERT_TRUE(get_columnar_file_page(&reader, 0, &view));
+    assert_test_samples_in_page(&view, 0, COLUMNAR_FILE_SAMPLES_PER_PAGE);
+    TEST_ASSERT_TRUE(get_columnar_file_page(&reader, 1, &view));
+    assert_test_samples_in_page(&view, COLUMNAR_FILE_SAMPLES_PER_PAGE, 100);
+    TEST_ASSERT_FALSE(get_columnar_file_page(&reader, 2, &view));
+
+    //tear down
+    close_columnar_file_reader(&reader);
+    remove(expected_columnar_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The get_columnar_file_sample_count function should provide only the samples the writer has committed when:
+ *   - the file is read while the columnar sink is part way through a page, then after it has written more (into the next page)
+ */
+static void test_get_columnar_file_sample_count_if_writer_mid_page_renders_only_committed_samples(void)
+{
+    //local vars
+    TELEMETRY_SINK* sink;
+    COLUMNAR_FILE_READER reader;
+    COLUMNAR_PAGE_VIEW view;
+    uint64_t sample_count;
+
+    //setup
+    sink = new_columnar_telemetry_sink(expected_columnar_file);
+    TEST_ASSERT_NOT_NULL(sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(sink));
+    TEST_ASSERT_TRUE(open_columnar_file_reader(&reader, expected_columnar_file));
+
+    //ensure a file the writer has yet to publish to reads as empty
+    TEST_ASSERT_EQUAL_UINT64(0, get_columnar_file_sample_count(&reader));
+
+    //test the specific behavior
+    publish_test_samples(sink, 0, 100);
+    TEST_ASSERT_TRUE(refresh_columnar_file_reader(&reader));
+    sample_count = get_columnar_file_sample_count(&reader);
+
+    //assert the expected results
+    //ensure the reader sees the published samples, and the page's count stops at them (the rest of the page hasn't been written)
+    TEST_ASSERT_EQUAL_UINT64(100, sample_count);
+    TEST_ASSERT_TRUE(get_columnar_file_page(&reader, 0, &view));
+    assert_test_samples_in_page(&view, 0, 100);
+    TEST_ASSERT_EQUAL_INT64(0, view.timestamps_ns[100]);
+    TEST_ASSERT_EQUAL_INT16(0, view.axes[COLUMNAR_ACCEL_X][100]);
+
+    //ensure samples published later show up through the same mapping, and the page the writer moved on to only once the reader is refreshed
+    publish_test_samples(sink, 100, COLUMNAR_FILE_SAMPLES_PER_PAGE);
+    TEST_ASSERT_EQUAL_UINT64(COLUMNAR_FILE_SAMPLES_PER_PAGE + 100, get_columnar_file_sample_count(&reader));
+    TEST_ASSERT_TRUE(get_columnar_file_page(&reader, 0, &view));
+    assert_test_samples_in_page(&view, 0, COLUMNAR_FILE_SAMPLES_PER_PAGE);
+    TEST_ASSERT_FALSE(get_columnar_file_page(&reader, 1, &view));
+    TEST_ASSERT_TRUE(refresh_columnar_file_reader(&reader));
+    TEST_ASSERT_TRUE(get_columnar_file_page(&reader, 1, &view));
+    assert_test_samples_in_page(&view, COLUMNAR_FILE_SAMPLES_PER_PAGE, 100);
+
+    //tear down
+    close_columnar_file_reader(&reader);
+    TEST_ASSERT_TRUE(close_telemetry_sink(sink));
+    free_telemetry_sink(sink);
+    remove(expected_columnar_file);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The open_columnar_file_reader function should provide failure when:
+ *   - the file's magic isn't the columnar file's, its page size isn't the one we read, or it is too short to hold a header
+ */
+static void test_open_columnar_file_reader_if_bad_magic_or_page_size_renders_failure(void)
+{
+    //local vars
+    static const char bad_magic[8] = {'S', 'A', 'T', 'C', 'O', 'L', '9', '9'};
+    const uint32_t bad_page_size = COLUMNAR_FILE_PAGE_SIZE_BYTES / 2;
+    TELEMETRY_SINK* sink;
+    COLUMNAR_FILE_READER reader;
+    FILE* file;
+
+    //setup
+    sink = new_columnar_telemetry_sink(expected_columnar_file);
+    TEST_ASSERT_NOT_NULL(sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(sink));
+    publish_test_samples(sink, 0, 10);
+    TEST_ASSERT_TRUE(close_telemetry_sink(sink));
+    free_telemetry_sink(sink);
+    TEST_ASSERT_TRUE(open_columnar_file_reader(&reader, expected_columnar_file));
+    close_columnar_file_reader(&reader);
+
+    //test the specific behavior
+    //assert the expected results
+    //ensure a file with another magic is rejected (and the reader left closed)
+    write_columnar_file_bytes(0, bad_magic, sizeof (bad_magic));
+    TEST_ASSERT_FALSE(open_columnar_file_reader(&reader, expected_columnar_file));
+    TEST_ASSERT_EQUAL_INT(-1, reader.fd);
+    TEST_ASSERT_NULL(reader.header);
+
+    //ensure a file with the right magic but another page size is rejected
+    write_columnar_file_bytes(0, COLUMNAR_FILE_MAGIC, sizeof (bad_magic));
+    write_columnar_file_bytes((long)offsetof(COLUMNAR_FILE_HEADER, page_size), &bad_page_size, sizeof (bad_page_size));
+    TEST_ASSERT_FALSE(open_columnar_file_reader(&reader, expected_columnar_file));
+
+    //ensure a file too short to hold a header is rejected
+    file = fopen(expected_columnar_file, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_UINT64(8, fwrite(COLUMNAR_FILE_MAGIC, 1, 8, file));
+    fclose(file);
+    TEST_ASSERT_FALSE(open_columnar_file_reader(&reader, expected_columnar_file));
+
+    //ensure a missing file is rejected
+    remove(expected_columnar_file);
+    TEST_ASSERT_FALSE(open_columnar_file_reader(&reader, expected_columnar_file));
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_open_columnar_file_reader_if_samples_span_page_boundary_renders_every_sample_round_tripped);
+    RUN_TEST(test_get_columnar_file_sample_count_if_writer_mid_page_renders_only_committed_samples);
+    RUN_TEST(test_open_columnar_file_reader_if_bad_magic_or_page_size_renders_failure);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
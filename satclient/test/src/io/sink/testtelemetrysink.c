@@ -0,0 +1,549 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#define _POSIX_C_SOURCE 200809L     //enable POSIX extensions in time.h so we can use the "nanosleep" function
+
+#include <stdio.h>              //using for "snprintf" function
+#include <string.h>             //using for "memset", "memcpy", "memchr", and "strstr" functions
+#include <time.h>               //using for "nanosleep" function
+#include <pthread.h>            //using for the gate holding up the slow sink
+#include "unity.h"
+#include "telemetrysink.h"
+#include "fanoutsink.h"
+
+//global vars
+#define CAPTURED_HEADER_MAX_COUNT 16
+static const char expected_device_id[] = "test_device";
+
+//capturing sink representation (records the header line of every batch it is handed)
+typedef struct capture_context
+{
+    pthread_mutex_t* gate;                  //held by the test to hold up publishing (NULL for a sink that never waits)
+    uint32_t publish_count;                 //number of batches handed to the sink (read by the test while the sink waits)
+    bool is_closed;                         //denotes the sink was closed
+    char headers[CAPTURED_HEADER_MAX_COUNT][TELEMETRY_BATCH_MAX_HEADER_SIZE];
+}CAPTURE_CONTEXT;
+
+//function declarations
+static bool open_capture_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_capture_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_capture_sink(TELEMETRY_SINK*);
+static bool close_capture_sink(TELEMETRY_SINK*);
+static void fill_test_batch(TELEMETRY_BATCH*, uint32_t);
+static void wait_for_capture_count(CAPTURE_CONTEXT*, uint32_t);
+static void* close_sink_in_thread(void*);
+static void test_record_telemetry_loss_if_ranges_recorded_renders_merged_gaps(void);
+static void test_encode_telemetry_batch_header_if_encoded_twice_renders_single_header_ahead_of_readings(void);
+static void test_publish_telemetry_batch_to_sink_if_fanout_lanes_keep_up_renders_every_batch_delivered_to_every_sink(void);
+static void test_publish_telemetry_batch_to_sink_if_fanout_lane_stalls_renders_drops_counted_while_other_lanes_receive(void);
+static void test_close_telemetry_sink_if_fanout_lane_has_batches_queued_renders_queue_drained_before_close(void);
+static void test_publish_telemetry_batch_to_sink_if_fanout_lane_drops_batch_renders_ring_drop_in_lanes_next_header(void);
+
+//capturing telemetry sink implementation
+static const TELEMETRY_SINK_INTERFACE CAPTURE_SINK_INTERFACE =
+{
+    open_capture_sink,
+    publish_batch_to_capture_sink,
+    flush_capture_sink,
+    close_capture_sink,
+    NULL
+};
+
+//function definition
+//nothing to open
+static bool open_capture_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//record the batch's header line (waiting at the gate, when the sink has one)
+static bool publish_batch_to_capture_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    //local vars
+    CAPTURE_CONTEXT* context = (CAPTURE_CONTEXT*)sink->context;
+    uint32_t publish_count = __atomic_load_n(&(context->publish_count), __ATOMIC_ACQUIRE);
+
+    if (publish_count < CAPTURED_HEADER_MAX_COUNT)
+    {
+        memcpy(context->headers[publish_count], batch->payload, batch->header_size);
+        context->headers[publish_count][batch->header_size] = '\0';
+    }
+    __atomic_store_n(&(context->publish_count), publish_count + 1, __ATOMIC_RELEASE);
+
+    if (context->gate != NULL)
+    {
+        pthread_mutex_lock(context->gate);
+        pthread_mutex_unlock(context->gate);
+    }
+
+    return true;
+}
+
+//function definition
+//nothing to flush
+static bool flush_capture_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//record that the sink was closed
+static bool close_capture_sink(TELEMETRY_SINK* sink)
+{
+    //local vars
+    CAPTURE_CONTEXT* context = (CAPTURE_CONTEXT*)sink->context;
+
+    __atomic_store_n(&(context->is_closed), true, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+//function definition
+//fill a batch as a board would: readings for sequence ids index * 10 to index * 10 + 9, headed by its loss accounting
+static void fill_test_batch(TELEMETRY_BATCH* batch, uint32_t index)
+{
+    //local vars
+    TELEMETRY_READING reading;
+    uint32_t i;
+
+    clear_telemetry_batch(batch);
+    for (i = 0; i < 10; i++)
+    {
+        snprintf(reading.json, sizeof (reading.json), "{\"sequence_id\":%u}", (index * 10) + i);
+        append_telemetry_reading_to_batch(batch, &reading);
+    }
+    batch->header.first_sequence_id = (int)(index * 10);
+    batch->header.last_sequence_id = (int)(index * 10) + 9;
+    encode_telemetry_batch_header(batch);
+}
+
+//function definition
+//wait for a capturing sink to have been handed a number of batches
+static void wait_for_capture_count(CAPTURE_CONTEXT* context, uint32_t count)
+{
+    //local vars
+    struct timespec interval = {0, 1000000};
+
+    while (__atomic_load_n(&(context->publish_count), __ATOMIC_ACQUIRE) < count)
+    {
+        nanosleep(&interval, NULL);
+    }
+}
+
+//function definition
+//close the supplied sink (on a thread of its own, as closing a fan-out sink waits for its lanes to drain)
+static void* close_sink_in_thread(void* parameter)
+{
+    close_telemetry_sink((TELEMETRY_SINK*)parameter);
+
+    return NULL;
+}
+
+//function definition
+/*
+ *   Behavior Tested: The record_telemetry_loss function should provide merged gaps when:
+ *   - ranges continuing the latest at the same stage are recorded (extending it), along with ranges at other stages, and more ranges than a header lists
+ */
+static void test_record_telemetry_loss_if_ranges_recorded_renders_merged_gaps(void)
+{
+    //local vars
+    TELEMETRY_LOSS_RECORD record;
+    TELEMETRY_LOSS_RECORD other;
+    uint32_t i;
+
+    //setup
+    memset(&record, 0, sizeof (record));
+
+    //test the specific behavior
+    record_telemetry_loss(&record, TELEMETRY_LOSS_PUBLISH_FAILURE, 0, 9, 10);
+    record_telemetry_loss(&record, TELEMETRY_LOSS_PUBLISH_FAILURE, 10, 19, 10);
+    record_telemetry_loss(&record, TELEMETRY_LOSS_SENSOR_OVERRUN, 20, 20, 2);
+    record_telemetry_loss(&record, TELEMETRY_LOSS_PUBLISH_FAILURE, 21, 29, 9);
+
+    //assert the expected results
+    //ensure the continued range was extended, and the counts are the readings lost at each stage
+    TEST_ASSERT_EQUAL_UINT32(3, record.gap_count);
+    TEST_ASSERT_EQUAL_INT(TELEMETRY_LOSS_PUBLISH_FAILURE, record.gaps[0].stage);
+    TEST_ASSERT_EQUAL_INT(0, record.gaps[0].first_sequence_id);
+    TEST_ASSERT_EQUAL_INT(19, record.gaps[0].last_sequence_id);
+    TEST_ASSERT_EQUAL_INT(TELEMETRY_LOSS_SENSOR_OVERRUN, record.gaps[1].stage);
+    TEST_ASSERT_EQUAL_INT(20, record.gaps[1].first_sequence_id);
+    TEST_ASSERT_EQUAL_INT(20, record.gaps[1].last_sequence_id);
+    TEST_ASSERT_EQUAL_UINT64(29, record.lost_counts[TELEMETRY_LOSS_PUBLISH_FAILURE]);
+    TEST_ASSERT_EQUAL_UINT64(2, record.lost_counts[TELEMETRY_LOSS_SENSOR_OVERRUN]);
+
+    //ensure ranges past what a header lists are only counted
+    for (i = 0; i < TELEMETRY_MAX_GAPS; i++)
+    {
+        record_telemetry_loss(&record, TELEMETRY_LOSS_ENCODE_FAILURE, 100 + (int)(i * 2), 100 + (int)(i * 2), 1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_MAX_GAPS, record.gap_count);
+    TEST_ASSERT_EQUAL_UINT32(3, record.omitted_gap_count);
+    TEST_ASSERT_EQUAL_UINT64(TELEMETRY_MAX_GAPS, record.lost_counts[TELEMETRY_LOSS_ENCODE_FAILURE]);
+
+    //ensure merging adds the counts and ranges of another record, and clearing the ranges keeps the counts
+    memset(&other, 0, sizeof (other));
+    clear_telemetry_loss_gaps(&record);
+    record_telemetry_loss(&other, TELEMETRY_LOSS_RING_DROP, 30, 39, 10);
+    merge_telemetry_loss(&record, &other);
+    TEST_ASSERT_EQUAL_UINT32(1, record.gap_count);
+    TEST_ASSERT_EQUAL_UINT32(0, record.omitted_gap_count);
+    TEST_ASSERT_EQUAL_INT(TELEMETRY_LOSS_RING_DROP, record.gaps[0].stage);
+    TEST_ASSERT_EQUAL_UINT64(10, record.lost_counts[TELEMETRY_LOSS_RING_DROP]);
+    TEST_ASSERT_EQUAL_UINT64(29, record.lost_counts[TELEMETRY_LOSS_PUBLISH_FAILURE]);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The encode_telemetry_batch_header function should provide a single header line ahead of the readings when:
+ *   - the header of a batch of readings is encoded, then encoded again once a range (and the longest values) was lost
+ */
+static void test_encode_telemetry_batch_header_if_encoded_twice_renders_single_header_ahead_of_readings(void)
+{
+    //local vars
+    bool operation_status;
+    static TELEMETRY_BATCH batch;
+    uint32_t offset = 0;
+    const char* line;
+    uint32_t line_size;
+    uint32_t line_count = 0;
+    uint32_t i;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    batch.header.device_id = expected_device_id;
+    batch.header.source_index = 1;
+    fill_test_batch(&batch, 2);
+
+    //test the specific behavior
+    record_telemetry_loss(&(batch.header.loss), TELEMETRY_LOSS_PUBLISH_FAILURE, 10, 19, 10);
+    operation_status = encode_telemetry_batch_header(&batch);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the header (only the latest) is the first line, followed by every reading
+    TEST_ASSERT_EQUAL_INT(0, strncmp(batch.payload, "{\"device_id\":\"test_device\",\"device_index\":1,\"batch\":{\"first_sequence_id\":20,\"last_sequence_id\":29,\"reading_count\":10,"
+                                                    "\"lost\":{\"sensor_overrun\":0,\"ring_drop\":0,\"encode_failure\":0,\"publish_failure\":10},\"omitted_gap_count\":0,"
+                                                    "\"gaps\":[{\"stage\":\"publish_failure\",\"first_sequence_id\":10,\"last_sequence_id\":19}]}}\n{\"sequence_id\":20}\n", batch.header_size + 19));
+    while (get_next_telemetry_batch_line(&batch, &offset, &line, &line_size))
+    {
+        line_count++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(11, line_count);
+    TEST_ASSERT_NOT_NULL(strstr(batch.payload, "{\"sequence_id\":29}\n"));
+
+    //ensure a header with every range listed, and the longest values, still fits in its room
+    for (i = 0; i < TELEMETRY_MAX_GAPS; i++)
+    {
+        record_telemetry_loss(&(batch.header.loss), (TELEMETRY_LOSS_STAGE)(i % TELEMETRY_LOSS_STAGE_COUNT), -2147483647 + (int)(i * 2), -2147483647 + (int)(i * 2), UINT64_MAX / 2);
+    }
+    batch.header.source_index = UINT32_MAX;
+    batch.header.first_sequence_id = -2147483647;
+    batch.header.last_sequence_id = -2147483647;
+    TEST_ASSERT_TRUE(encode_telemetry_batch_header(&batch));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(&(batch.payload[batch.header_size]), "{\"sequence_id\":20}\n", 19));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The publish_telemetry_batch_to_sink function should provide every batch delivered (in order) to every sink when:
+ *   - a fan-out sink over three sinks is published more batches than a lane's queue holds, flushed whenever the queues may be full
+ */
+static void test_publish_telemetry_batch_to_sink_if_fanout_lanes_keep_up_renders_every_batch_delivered_to_every_sink(void)
+{
+    //local vars
+    static TELEMETRY_BATCH batch;
+    static CAPTURE_CONTEXT contexts[3];
+    char expected_range[64];
+    TELEMETRY_SINK* sinks[3];
+    TELEMETRY_SINK* fanout_sink;
+    FANOUT_SINK_STATISTICS statistics;
+    uint32_t i;
+    uint32_t j;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    memset(contexts, 0, sizeof (contexts));
+    batch.header.device_id = expected_device_id;
+    for (i = 0; i < 3; i++)
+    {
+        sinks[i] = new_telemetry_sink("CAPTURE", &CAPTURE_SINK_INTERFACE, &(contexts[i]));
+    }
+    fanout_sink = new_fanout_telemetry_sink(sinks, 3, FANOUT_DEFAULT_QUEUE_DEPTH, 0);
+    TEST_ASSERT_NOT_NULL(fanout_sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(fanout_sink));
+
+    //test the specific behavior
+    for (i = 0; i < CAPTURED_HEADER_MAX_COUNT; i++)
+    {
+        fill_test_batch(&batch, i);
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+        if ((i % FANOUT_DEFAULT_QUEUE_DEPTH) == (FANOUT_DEFAULT_QUEUE_DEPTH - 1))
+        {
+            TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+        }
+    }
+    TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+
+    //assert the expected results
+    //ensure every sink was handed every batch, in the order published, and none was dropped or failed
+    for (i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(CAPTURED_HEADER_MAX_COUNT, contexts[i].publish_count);
+        for (j = 0; j < CAPTURED_HEADER_MAX_COUNT; j++)
+        {
+            snprintf(expected_range, sizeof (expected_range), "\"first_sequence_id\":%u,\"last_sequence_id\":%u,", j * 10, (j * 10) + 9);
+            TEST_ASSERT_NOT_NULL(strstr(contexts[i].headers[j], expected_range));
+        }
+        TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, i, &statistics));
+        TEST_ASSERT_EQUAL_UINT64(CAPTURED_HEADER_MAX_COUNT, statistics.published_batch_count);
+        TEST_ASSERT_EQUAL_UINT64(0, statistics.dropped_batch_count);
+        TEST_ASSERT_EQUAL_UINT64(0, statistics.failed_batch_count);
+    }
+
+    //tear down
+    TEST_ASSERT_TRUE(close_telemetry_sink(fanout_sink));
+    free_telemetry_sink(fanout_sink);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The publish_telemetry_batch_to_sink function should provide the stalled lane's drops counted (while the other lanes receive every batch) when:
+ *   - one lane's sink is held up while far more batches are published than its queue holds
+ */
+static void test_publish_telemetry_batch_to_sink_if_fanout_lane_stalls_renders_drops_counted_while_other_lanes_receive(void)
+{
+    //local vars
+    static TELEMETRY_BATCH batch;
+    static CAPTURE_CONTEXT fast_contexts[2];
+    static CAPTURE_CONTEXT slow_context;
+    const uint32_t published_count = (FANOUT_DEFAULT_QUEUE_DEPTH * 4) + 1;
+    pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+    TELEMETRY_SINK* sinks[3];
+    TELEMETRY_SINK* fanout_sink;
+    FANOUT_SINK_STATISTICS statistics;
+    uint32_t i;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    memset(fast_contexts, 0, sizeof (fast_contexts));
+    memset(&slow_context, 0, sizeof (slow_context));
+    batch.header.device_id = expected_device_id;
+    slow_context.gate = &gate;
+    sinks[0] = new_telemetry_sink("FAST", &CAPTURE_SINK_INTERFACE, &(fast_contexts[0]));
+    sinks[1] = new_telemetry_sink("SLOW", &CAPTURE_SINK_INTERFACE, &slow_context);
+    sinks[2] = new_telemetry_sink("FAST", &CAPTURE_SINK_INTERFACE, &(fast_contexts[1]));
+    fanout_sink = new_fanout_telemetry_sink(sinks, 3, FANOUT_DEFAULT_QUEUE_DEPTH, 0);
+    TEST_ASSERT_NOT_NULL(fanout_sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(fanout_sink));
+    pthread_mutex_lock(&gate);
+
+    //test the specific behavior
+    //the slow lane takes batch 0 and waits at the gate, the next FANOUT_DEFAULT_QUEUE_DEPTH fill its queue, and every batch after that is dropped by it
+    for (i = 0; i < published_count; i++)
+    {
+        fill_test_batch(&batch, i);
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+        wait_for_capture_count(&(fast_contexts[0]), i + 1);
+        wait_for_capture_count(&(fast_contexts[1]), i + 1);
+        if (i == 0)
+        {
+            wait_for_capture_count(&slow_context, 1);
+        }
+    }
+
+    //assert the expected results
+    //ensure the fast lanes were handed every batch while the slow lane was held up, and only the slow lane counted drops
+    TEST_ASSERT_EQUAL_UINT32(1, __atomic_load_n(&(slow_context.publish_count), __ATOMIC_ACQUIRE));
+    TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, 1, &statistics));
+    TEST_ASSERT_EQUAL_UINT64(published_count - (FANOUT_DEFAULT_QUEUE_DEPTH + 1), statistics.dropped_batch_count);
+    for (i = 0; i < 3; i += 2)
+    {
+        TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, i, &statistics));
+        TEST_ASSERT_EQUAL_UINT64(0, statistics.dropped_batch_count);
+    }
+
+    //ensure the slow lane publishes what it queued once it catches up (and nothing it dropped)
+    pthread_mutex_unlock(&gate);
+    TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+    TEST_ASSERT_EQUAL_UINT32(FANOUT_DEFAULT_QUEUE_DEPTH + 1, slow_context.publish_count);
+    TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, 1, &statistics));
+    TEST_ASSERT_EQUAL_UINT64(FANOUT_DEFAULT_QUEUE_DEPTH + 1, statistics.published_batch_count);
+    TEST_ASSERT_EQUAL_UINT64(published_count - (FANOUT_DEFAULT_QUEUE_DEPTH + 1), statistics.dropped_batch_count);
+    for (i = 0; i < 3; i += 2)
+    {
+        TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, i, &statistics));
+        TEST_ASSERT_EQUAL_UINT64(published_count, statistics.published_batch_count);
+        TEST_ASSERT_EQUAL_UINT32(published_count, fast_contexts[i / 2].publish_count);
+    }
+
+    //tear down
+    TEST_ASSERT_TRUE(close_telemetry_sink(fanout_sink));
+    free_telemetry_sink(fanout_sink);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The close_telemetry_sink function should provide the queued batches published before the sinks are closed when:
+ *   - a fan-out sink is closed while a lane's sink is held up with a full queue behind it
+ */
+static void test_close_telemetry_sink_if_fanout_lane_has_batches_queued_renders_queue_drained_before_close(void)
+{
+    //local vars
+    static TELEMETRY_BATCH batch;
+    static CAPTURE_CONTEXT fast_context;
+    static CAPTURE_CONTEXT slow_context;
+    struct timespec interval = {0, 20000000};
+    pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t closer;
+    TELEMETRY_SINK* sinks[2];
+    TELEMETRY_SINK* fanout_sink;
+    FANOUT_SINK_STATISTICS statistics;
+    uint32_t i;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    memset(&fast_context, 0, sizeof (fast_context));
+    memset(&slow_context, 0, sizeof (slow_context));
+    batch.header.device_id = expected_device_id;
+    slow_context.gate = &gate;
+    sinks[0] = new_telemetry_sink("FAST", &CAPTURE_SINK_INTERFACE, &fast_context);
+    sinks[1] = new_telemetry_sink("SLOW", &CAPTURE_SINK_INTERFACE, &slow_context);
+    fanout_sink = new_fanout_telemetry_sink(sinks, 2, FANOUT_DEFAULT_QUEUE_DEPTH, 0);
+    TEST_ASSERT_NOT_NULL(fanout_sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(fanout_sink));
+    pthread_mutex_lock(&gate);
+    for (i = 0; i <= FANOUT_DEFAULT_QUEUE_DEPTH; i++)
+    {
+        fill_test_batch(&batch, i);
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+        wait_for_capture_count(&fast_context, i + 1);
+        if (i == 0)
+        {
+            wait_for_capture_count(&slow_context, 1);
+        }
+    }
+
+    //test the specific behavior
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&closer, NULL, close_sink_in_thread, fanout_sink));
+    nanosleep(&interval, NULL);
+
+    //assert the expected results
+    //ensure closing waits on the held up lane (its queue is untouched and neither sink is closed yet)
+    TEST_ASSERT_EQUAL_UINT32(1, __atomic_load_n(&(slow_context.publish_count), __ATOMIC_ACQUIRE));
+    TEST_ASSERT_FALSE(__atomic_load_n(&(slow_context.is_closed), __ATOMIC_ACQUIRE));
+    TEST_ASSERT_FALSE(__atomic_load_n(&(fast_context.is_closed), __ATOMIC_ACQUIRE));
+
+    //ensure once the lane is let go every queued batch is published, then every sink is closed
+    pthread_mutex_unlock(&gate);
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(closer, NULL));
+    TEST_ASSERT_EQUAL_UINT32(FANOUT_DEFAULT_QUEUE_DEPTH + 1, slow_context.publish_count);
+    TEST_ASSERT_EQUAL_UINT32(FANOUT_DEFAULT_QUEUE_DEPTH + 1, fast_context.publish_count);
+    TEST_ASSERT_TRUE(slow_context.is_closed);
+    TEST_ASSERT_TRUE(fast_context.is_closed);
+    TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, 1, &statistics));
+    TEST_ASSERT_EQUAL_UINT64(FANOUT_DEFAULT_QUEUE_DEPTH + 1, statistics.published_batch_count);
+    TEST_ASSERT_EQUAL_UINT64(0, statistics.dropped_batch_count);
+
+    //tear down
+    free_telemetry_sink(fanout_sink);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The publish_telemetry_batch_to_sink function should provide the ring drop in the next header a fan-out lane publishes when:
+ *   - a slow lane's queue is full when a batch (taken by the other lane) is published, then the slow lane catches up (publishing its queue and one more)
+ */
+static void test_publish_telemetry_batch_to_sink_if_fanout_lane_drops_batch_renders_ring_drop_in_lanes_next_header(void)
+{
+    //local vars
+    static TELEMETRY_BATCH batch;
+    static CAPTURE_CONTEXT fast_context;
+    static CAPTURE_CONTEXT slow_context;
+    pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+    TELEMETRY_SINK* sinks[2];
+    TELEMETRY_SINK* fanout_sink;
+    FANOUT_SINK_STATISTICS statistics;
+    uint32_t i;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    batch.header.device_id = expected_device_id;
+    fast_context.gate = NULL;
+    slow_context.gate = &gate;
+    sinks[0] = new_telemetry_sink("FAST", &CAPTURE_SINK_INTERFACE, &fast_context);
+    sinks[1] = new_telemetry_sink("SLOW", &CAPTURE_SINK_INTERFACE, &slow_context);
+    fanout_sink = new_fanout_telemetry_sink(sinks, 2, FANOUT_DEFAULT_QUEUE_DEPTH, 0);
+    TEST_ASSERT_TRUE(open_telemetry_sink(fanout_sink));
+    pthread_mutex_lock(&gate);
+
+    //test the specific behavior
+    //the slow lane takes batch 0 and waits at the gate, batches 1 to FANOUT_DEFAULT_QUEUE_DEPTH fill its queue, and the next is dropped by it
+    for (i = 0; i <= (FANOUT_DEFAULT_QUEUE_DEPTH + 1); i++)
+    {
+        fill_test_batch(&batch, i);
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+        wait_for_capture_count(&fast_context, i + 1);
+        if (i == 0)
+        {
+            wait_for_capture_count(&slow_context, 1);
+        }
+    }
+    //let the slow lane catch up (it has taken every batch it queued once it has been handed FANOUT_DEFAULT_QUEUE_DEPTH + 1)
+    pthread_mutex_unlock(&gate);
+    wait_for_capture_count(&slow_context, FANOUT_DEFAULT_QUEUE_DEPTH + 1);
+    fill_test_batch(&batch, FANOUT_DEFAULT_QUEUE_DEPTH + 2);
+    TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+    TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+
+    //assert the expected results
+    //ensure only the slow lane dropped a batch, the header of the first batch it published after the drop lists the batch's range, and every
+    //header after that counts it (the other lane's headers don't)
+    TEST_ASSERT_TRUE(get_fanout_sink_statistics(fanout_sink, 1, &statistics));
+    TEST_ASSERT_EQUAL_UINT64(1, statistics.dropped_batch_count);
+    TEST_ASSERT_EQUAL_UINT32(FANOUT_DEFAULT_QUEUE_DEPTH + 2, slow_context.publish_count);
+    TEST_ASSERT_EQUAL_UINT32(FANOUT_DEFAULT_QUEUE_DEPTH + 3, fast_context.publish_count);
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[0], "\"ring_drop\":0,"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[1], "\"first_sequence_id\":10,"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[1], "\"ring_drop\":10,"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[1], "\"gaps\":[{\"stage\":\"ring_drop\",\"first_sequence_id\":90,\"last_sequence_id\":99}]"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[FANOUT_DEFAULT_QUEUE_DEPTH + 1], "\"first_sequence_id\":100,"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[FANOUT_DEFAULT_QUEUE_DEPTH + 1], "\"ring_drop\":10,"));
+    TEST_ASSERT_NOT_NULL(strstr(slow_context.headers[FANOUT_DEFAULT_QUEUE_DEPTH + 1], "\"gaps\":[]"));
+    TEST_ASSERT_NOT_NULL(strstr(fast_context.headers[FANOUT_DEFAULT_QUEUE_DEPTH + 2], "\"ring_drop\":0,"));
+    TEST_ASSERT_NOT_NULL(strstr(fast_context.headers[FANOUT_DEFAULT_QUEUE_DEPTH + 2], "\"gaps\":[]"));
+
+    //tear down
+    free_telemetry_sink(fanout_sink);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_record_telemetry_loss_if_ranges_recorded_renders_merged_gaps);
+    RUN_TEST(test_encode_telemetry_batch_header_if_encoded_twice_renders_single_header_ahead_of_readings);
+    RUN_TEST(test_publish_telemetry_batch_to_sink_if_fanout_lanes_keep_up_renders_every_batch_delivered_to_every_sink);
+    RUN_TEST(test_publish_telemetry_batch_to_sink_if_fanout_lane_stalls_renders_drops_counted_while_other_lanes_receive);
+    RUN_TEST(test_close_telemetry_sink_if_fanout_lane_has_batches_queued_renders_queue_drained_before_close);
+    RUN_TEST(test_publish_telemetry_batch_to_sink_if_fanout_lane_drops_batch_renders_ring_drop_in_lanes_next_header);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -0,0 +1,378 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+
+   The suite is linked with malloc, calloc, realloc, and free wrapped (-Wl,--wrap=...), so every call the SAT client
+   objects make to the heap is counted.
+*/
+
+#include <stdio.h>              //using for "snprintf" function
+#include <stdint.h>             //using for "uintptr_t" type
+#include <string.h>             //using for "memset" function
+#include "unity.h"
+#include "satmemory.h"
+#include "telemetrysink.h"
+#include "fanoutsink.h"
+#include "filesink.h"
+
+//global vars
+#define ARENA_FILL_BLOCK_SIZE (1024 * 1024)
+static uint64_t heap_call_count;        //calls to the heap made by the SAT client objects (counted by the wrappers)
+
+//function declarations
+void* __real_malloc(size_t);
+void* __real_calloc(size_t, size_t);
+void* __real_realloc(void*, size_t);
+void __real_free(void*);
+void* __wrap_malloc(size_t);
+void* __wrap_calloc(size_t, size_t);
+void* __wrap_realloc(void*, size_t);
+void __wrap_free(void*);
+static bool open_null_sink(TELEMETRY_SINK*);
+static bool publish_batch_to_null_sink(TELEMETRY_SINK*, const TELEMETRY_BATCH*);
+static bool flush_null_sink(TELEMETRY_SINK*);
+static bool close_null_sink(TELEMETRY_SINK*);
+static void fill_test_batch(TELEMETRY_BATCH*, uint32_t);
+static void test_allocate_sat_memory_if_blocks_allocated_and_freed_renders_aligned_blocks_accounted_to_owner(void);
+static void test_allocate_sat_memory_if_block_freed_renders_block_reused_by_same_class(void);
+static void test_publish_telemetry_batch_to_sink_if_fanout_pipeline_runs_renders_no_heap_allocations(void);
+static void test_allocate_sat_memory_if_arena_exhausted_renders_failures_until_blocks_freed(void);
+
+//sink that drops every batch (stands in for a transport)
+static const TELEMETRY_SINK_INTERFACE NULL_SINK_INTERFACE =
+{
+    open_null_sink,
+    publish_batch_to_null_sink,
+    flush_null_sink,
+    close_null_sink,
+    NULL
+};
+
+//function definition
+//count a call to malloc made by the SAT client objects
+void* __wrap_malloc(size_t size)
+{
+    __atomic_add_fetch(&heap_call_count, 1, __ATOMIC_RELAXED);
+
+    return __real_malloc(size);
+}
+
+//function definition
+//count a call to calloc made by the SAT client objects
+void* __wrap_calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&heap_call_count, 1, __ATOMIC_RELAXED);
+
+    return __real_calloc(count, size);
+}
+
+//function definition
+//count a call to realloc made by the SAT client objects
+void* __wrap_realloc(void* memory, size_t size)
+{
+    __atomic_add_fetch(&heap_call_count, 1, __ATOMIC_RELAXED);
+
+    return __real_realloc(memory, size);
+}
+
+//function definition
+//count a call to free made by the SAT client objects
+void __wrap_free(void* memory)
+{
+    __atomic_add_fetch(&heap_call_count, 1, __ATOMIC_RELAXED);
+    __real_free(memory);
+}
+
+//function definition
+//nothing to open
+static bool open_null_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//drop the batch
+static bool publish_batch_to_null_sink(TELEMETRY_SINK* sink, const TELEMETRY_BATCH* batch)
+{
+    (void)sink;
+    (void)batch;
+
+    return true;
+}
+
+//function definition
+//nothing to flush
+static bool flush_null_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//nothing to close
+static bool close_null_sink(TELEMETRY_SINK* sink)
+{
+    (void)sink;
+
+    return true;
+}
+
+//function definition
+//fill a batch as a board would: readings for sequence ids index * 10 to index * 10 + 9, headed by its loss accounting
+static void fill_test_batch(TELEMETRY_BATCH* batch, uint32_t index)
+{
+    //local vars
+    TELEMETRY_READING reading;
+    uint32_t i;
+
+    clear_telemetry_batch(batch);
+    for (i = 0; i < 10; i++)
+    {
+        snprintf(reading.json, sizeof (reading.json), "{\"sequence_id\":%u}", (index * 10) + i);
+        append_telemetry_reading_to_batch(batch, &reading);
+    }
+    batch->header.first_sequence_id = (int)(index * 10);
+    batch->header.last_sequence_id = (int)(index * 10) + 9;
+    encode_telemetry_batch_header(batch);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The allocate_sat_memory function should provide aligned blocks accounted to their owner when:
+ *   - blocks of a range of sizes are allocated for a module, then freed
+ */
+static void test_allocate_sat_memory_if_blocks_allocated_and_freed_renders_aligned_blocks_accounted_to_owner(void)
+{
+    //local vars
+    static const size_t SIZES[] = {1, 16, 17, 100, 1000, 4096, 60032};
+    void* blocks[sizeof (SIZES) / sizeof (SIZES[0])];
+    SAT_MEMORY_USAGE before;
+    SAT_MEMORY_USAGE during;
+    SAT_MEMORY_USAGE after;
+    uint64_t previous_bytes;
+    uint32_t i;
+
+    //setup
+    get_sat_memory_usage(SAT_MEMORY_CRYPTO, &before);
+
+    //test the specific behavior
+    previous_bytes = before.allocated_bytes;
+    for (i = 0; i < (sizeof (SIZES) / sizeof (SIZES[0])); i++)
+    {
+        blocks[i] = allocate_sat_memory(SAT_MEMORY_CRYPTO, SIZES[i]);
+
+        //assert the expected results
+        //ensure the block is 16 byte aligned, usable for its whole size, and accounted as at least that large (and within 12.5% plus the header)
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        TEST_ASSERT_EQUAL_UINT64(0, ((uintptr_t)blocks[i]) % 16);
+        memset(blocks[i], 0xA5, SIZES[i]);
+        get_sat_memory_usage(SAT_MEMORY_CRYPTO, &during);
+        TEST_ASSERT_TRUE((during.allocated_bytes - previous_bytes) >= (SIZES[i] + 16));
+        TEST_ASSERT_TRUE((during.allocated_bytes - previous_bytes) <= (((SIZES[i] + 16) * 9) / 8) + 32);
+        previous_bytes = during.allocated_bytes;
+    }
+    TEST_ASSERT_EQUAL_UINT64(before.allocation_count + (sizeof (SIZES) / sizeof (SIZES[0])), during.allocation_count);
+    TEST_ASSERT_EQUAL_UINT64(during.allocated_bytes, during.peak_bytes);
+    TEST_ASSERT_EQUAL_UINT64(before.failure_count, during.failure_count);
+
+    //ensure freeing every block hands back every byte, and the peak is kept
+    for (i = 0; i < (sizeof (SIZES) / sizeof (SIZES[0])); i++)
+    {
+        free_sat_memory(blocks[i]);
+    }
+    get_sat_memory_usage(SAT_MEMORY_CRYPTO, &after);
+    TEST_ASSERT_EQUAL_UINT64(before.allocated_bytes, after.allocated_bytes);
+    TEST_ASSERT_EQUAL_UINT64(during.peak_bytes, after.peak_bytes);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The allocate_sat_memory function should provide the block reused by an allocation of the same class when:
+ *   - a block is freed, then a (slightly larger) block of the same class is allocated zeroed by another module
+ */
+static void test_allocate_sat_memory_if_block_freed_renders_block_reused_by_same_class(void)
+{
+    //local vars
+    uint8_t* block;
+    uint8_t* reused_block;
+    size_t used_bytes;
+    SAT_MEMORY_USAGE usage;
+    uint32_t i;
+
+    //setup
+    block = allocate_sat_memory(SAT_MEMORY_CRYPTO, 500);
+    TEST_ASSERT_NOT_NULL(block);
+    memset(block, 0xA5, 500);
+    used_bytes = get_sat_memory_arena_used_bytes();
+
+    //test the specific behavior
+    free_sat_memory(block);
+    reused_block = allocate_zeroed_sat_memory(SAT_MEMORY_SAT_CONFIG, 540);
+
+    //assert the expected results
+    //ensure the freed block was handed back (nothing more was carved out of the arena), zeroed, and is accounted to its new owner
+    TEST_ASSERT_EQUAL_PTR(block, reused_block);
+    TEST_ASSERT_EQUAL_UINT64(used_bytes, get_sat_memory_arena_used_bytes());
+    for (i = 0; i < 540; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, reused_block[i]);
+    }
+    get_sat_memory_usage(SAT_MEMORY_SAT_CONFIG, &usage);
+    TEST_ASSERT_TRUE(usage.allocated_bytes >= 556);
+
+    //tear down
+    free_sat_memory(reused_block);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The publish_telemetry_batch_to_sink function should provide no heap allocations when:
+ *   - a fan-out sink (over a file sink and a sink that drops every batch) is created, publishes many batches, and is freed
+ */
+static void test_publish_telemetry_batch_to_sink_if_fanout_pipeline_runs_renders_no_heap_allocations(void)
+{
+    //local vars
+    static TELEMETRY_BATCH batch;
+    static const SAT_MEMORY_OWNER OWNERS[] = {SAT_MEMORY_TELEMETRY_SINK, SAT_MEMORY_FANOUT_SINK, SAT_MEMORY_FILE_SINK};
+    SAT_MEMORY_USAGE before[sizeof (OWNERS) / sizeof (OWNERS[0])];
+    SAT_MEMORY_USAGE running[sizeof (OWNERS) / sizeof (OWNERS[0])];
+    SAT_MEMORY_USAGE after[sizeof (OWNERS) / sizeof (OWNERS[0])];
+    TELEMETRY_SINK* sinks[2];
+    TELEMETRY_SINK* fanout_sink;
+    uint64_t heap_call_count_before;
+    uint32_t i;
+
+    //setup
+    memset(&(batch.header), 0, sizeof (batch.header));
+    batch.header.device_id = "test_device";
+    for (i = 0; i < (sizeof (OWNERS) / sizeof (OWNERS[0])); i++)
+    {
+        get_sat_memory_usage(OWNERS[i], &(before[i]));
+    }
+    heap_call_count_before = __atomic_load_n(&heap_call_count, __ATOMIC_RELAXED);
+
+    //test the specific behavior
+    sinks[0] = new_file_telemetry_sink("/dev/null");
+    sinks[1] = new_telemetry_sink("NULL", &NULL_SINK_INTERFACE, NULL);
+    fanout_sink = new_fanout_telemetry_sink(sinks, 2, FANOUT_DEFAULT_QUEUE_DEPTH, 0);
+    TEST_ASSERT_NOT_NULL(fanout_sink);
+    TEST_ASSERT_TRUE(open_telemetry_sink(fanout_sink));
+    for (i = 0; i < (sizeof (OWNERS) / sizeof (OWNERS[0])); i++)
+    {
+        get_sat_memory_usage(OWNERS[i], &(running[i]));
+    }
+    for (i = 0; i < 1000; i++)
+    {
+        fill_test_batch(&batch, i);
+        TEST_ASSERT_TRUE(publish_telemetry_batch_to_sink(fanout_sink, &batch));
+
+        //let the lanes drain their queues now and then (a batch every lane drops fails to publish)
+        if ((i % FANOUT_DEFAULT_QUEUE_DEPTH) == (FANOUT_DEFAULT_QUEUE_DEPTH - 1))
+        {
+            TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+        }
+    }
+    TEST_ASSERT_TRUE(flush_telemetry_sink(fanout_sink));
+
+    //assert the expected results
+    //ensure nothing was allocated while the batches were published (everything was allocated as the sinks were created)
+    for (i = 0; i < (sizeof (OWNERS) / sizeof (OWNERS[0])); i++)
+    {
+        get_sat_memory_usage(OWNERS[i], &(after[i]));
+        TEST_ASSERT_EQUAL_UINT64(running[i].allocation_count, after[i].allocation_count);
+        TEST_ASSERT_EQUAL_UINT64(running[i].allocated_bytes, after[i].allocated_bytes);
+    }
+
+    //tear down
+    TEST_ASSERT_TRUE(close_telemetry_sink(fanout_sink));
+    free_telemetry_sink(fanout_sink);
+
+    //ensure freeing the sinks handed back everything they held, and the heap was never called (from creation to teardown)
+    for (i = 0; i < (sizeof (OWNERS) / sizeof (OWNERS[0])); i++)
+    {
+        get_sat_memory_usage(OWNERS[i], &(after[i]));
+        TEST_ASSERT_EQUAL_UINT64(before[i].allocated_bytes, after[i].allocated_bytes);
+        TEST_ASSERT_EQUAL_UINT64(before[i].failure_count, after[i].failure_count);
+    }
+    TEST_ASSERT_EQUAL_UINT64(heap_call_count_before, __atomic_load_n(&heap_call_count, __ATOMIC_RELAXED));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The allocate_sat_memory function should provide failures (counted against the module) until blocks are freed when:
+ *   - a block larger than the arena is asked for, then blocks are allocated until the arena is full
+ */
+static void test_allocate_sat_memory_if_arena_exhausted_renders_failures_until_blocks_freed(void)
+{
+    //local vars
+    static void* blocks[(SAT_MEMORY_ARENA_SIZE / ARENA_FILL_BLOCK_SIZE) + 1];
+    SAT_MEMORY_USAGE before;
+    SAT_MEMORY_USAGE after;
+    void* block;
+    uint32_t block_count = 0;
+    uint32_t i;
+
+    //setup
+    get_sat_memory_usage(SAT_MEMORY_CRYPTO, &before);
+
+    //test the specific behavior
+    block = allocate_sat_memory(SAT_MEMORY_CRYPTO, SAT_MEMORY_ARENA_SIZE + 1);
+    TEST_ASSERT_NULL(block);
+    block = allocate_sat_memory(SAT_MEMORY_CRYPTO, SIZE_MAX);
+    TEST_ASSERT_NULL(block);
+    while (block_count < (sizeof (blocks) / sizeof (blocks[0])))
+    {
+        blocks[block_count] = allocate_sat_memory(SAT_MEMORY_CRYPTO, ARENA_FILL_BLOCK_SIZE);
+        if (blocks[block_count] == NULL)
+        {
+            break;
+        }
+        block_count++;
+    }
+
+    //assert the expected results
+    //ensure the arena ran out (short of its size, the other tests hold some of it), each failure was counted, and the arena was never overrun
+    TEST_ASSERT_TRUE(block_count > 0);
+    TEST_ASSERT_TRUE(block_count < (sizeof (blocks) / sizeof (blocks[0])));
+    TEST_ASSERT_TRUE(get_sat_memory_arena_used_bytes() <= SAT_MEMORY_ARENA_SIZE);
+    get_sat_memory_usage(SAT_MEMORY_CRYPTO, &after);
+    TEST_ASSERT_EQUAL_UINT64(before.failure_count + 3, after.failure_count);
+    TEST_ASSERT_EQUAL_UINT64(before.allocation_count + block_count, after.allocation_count);
+
+    //ensure freeing a block lets the next allocation of its class succeed
+    free_sat_memory(blocks[0]);
+    blocks[0] = allocate_sat_memory(SAT_MEMORY_CRYPTO, ARENA_FILL_BLOCK_SIZE);
+    TEST_ASSERT_NOT_NULL(blocks[0]);
+
+    //tear down
+    for (i = 0; i < block_count; i++)
+    {
+        free_sat_memory(blocks[i]);
+    }
+    get_sat_memory_usage(SAT_MEMORY_CRYPTO, &after);
+    TEST_ASSERT_EQUAL_UINT64(before.allocated_bytes, after.allocated_bytes);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests (the arena is left with blocks only a 1 MiB allocation can reuse by the last one, so it runs last)
+    RUN_TEST(test_allocate_sat_memory_if_blocks_allocated_and_freed_renders_aligned_blocks_accounted_to_owner);
+    RUN_TEST(test_allocate_sat_memory_if_block_freed_renders_block_reused_by_same_class);
+    RUN_TEST(test_publish_telemetry_batch_to_sink_if_fanout_pipeline_runs_renders_no_heap_allocations);
+    RUN_TEST(test_allocate_sat_memory_if_arena_exhausted_renders_failures_until_blocks_freed);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
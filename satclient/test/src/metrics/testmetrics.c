@@ -0,0 +1,214 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <string.h>             //using for "strstr" function
+#include <pthread.h>            //using for the recording threads
+#include "unity.h"
+#include "metrics.h"
+
+//global vars
+#define RECORDING_THREAD_COUNT 4
+static const uint32_t expected_updates_per_thread = 100000;
+
+//function declarations
+static void* record_metrics(void*);
+static void test_get_metrics_histogram_bucket_index_if_every_magnitude_renders_bounds_within_an_eighth(void);
+static void test_take_metrics_snapshot_if_several_threads_record_renders_every_update(void);
+static void test_get_metrics_snapshot_quantile_if_known_distribution_renders_bucket_of_quantile(void);
+static void test_format_metrics_snapshot_as_prometheus_if_recorded_metrics_renders_exposition(void);
+
+//function definition
+//count an update, and record the update's index in the encode histogram, expected_updates_per_thread times
+static void* record_metrics(void* parameter)
+{
+    //local vars
+    uint32_t i;
+
+    (void)parameter;
+    for (i = 0; i < expected_updates_per_thread; i++)
+    {
+        increment_metrics_counter(METRICS_READINGS_PUBLISHED, 1);
+        record_metrics_histogram(METRICS_ENCODE_NS, i);
+    }
+
+    return NULL;
+}
+
+//function definition
+/*
+ *   Behavior Tested: The get_metrics_histogram_bucket_index function should provide a bucket whose lower bound is within an eighth below the value when:
+ *   - values at, just below, and between every power of two are bucketed (and the buckets only ever increase with the value)
+ */
+static void test_get_metrics_histogram_bucket_index_if_every_magnitude_renders_bounds_within_an_eighth(void)
+{
+    //local vars
+    uint64_t values[3];
+    uint64_t lower_bound;
+    uint32_t bucket_index;
+    uint32_t previous_bucket_index = 0;
+    uint32_t magnitude;
+    uint32_t i;
+
+    //the smallest values get a bucket each
+    for (i = 0; i < 16; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT64(i, get_metrics_histogram_bucket_lower_bound(get_metrics_histogram_bucket_index(i)));
+    }
+
+    for (magnitude = 4; magnitude <= METRICS_HISTOGRAM_MAX_MAGNITUDE; magnitude++)
+    {
+        values[0] = ((uint64_t)1 << magnitude) - 1;
+        values[1] = (uint64_t)1 << magnitude;
+        values[2] = ((uint64_t)1 << magnitude) + ((uint64_t)1 << (magnitude - 1)) + 3;
+
+        for (i = 0; i < 3; i++)
+        {
+            //test the specific behavior
+            bucket_index = get_metrics_histogram_bucket_index(values[i]);
+            lower_bound = get_metrics_histogram_bucket_lower_bound(bucket_index);
+
+            //assert the expected results
+            //ensure the bucket holds the value, is at most an eighth below it, and is past the last value's
+            TEST_ASSERT_TRUE(bucket_index < METRICS_HISTOGRAM_BUCKET_COUNT);
+            TEST_ASSERT_TRUE(lower_bound <= values[i]);
+            TEST_ASSERT_TRUE((values[i] - lower_bound) <= (values[i] / 8));
+            TEST_ASSERT_TRUE(bucket_index >= previous_bucket_index);
+            previous_bucket_index = bucket_index;
+        }
+    }
+
+    //ensure values past the largest magnitude land in the last bucket
+    TEST_ASSERT_EQUAL_UINT32(METRICS_HISTOGRAM_BUCKET_COUNT - 1, get_metrics_histogram_bucket_index((uint64_t)1 << (METRICS_HISTOGRAM_MAX_MAGNITUDE + 1)));
+    TEST_ASSERT_EQUAL_UINT32(METRICS_HISTOGRAM_BUCKET_COUNT - 1, get_metrics_histogram_bucket_index(UINT64_MAX));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The take_metrics_snapshot function should provide every update when:
+ *   - several threads (each with a shard of its own) count and record concurrently
+ */
+static void test_take_metrics_snapshot_if_several_threads_record_renders_every_update(void)
+{
+    //local vars
+    static METRICS_SNAPSHOT before;
+    static METRICS_SNAPSHOT after;
+    pthread_t threads[RECORDING_THREAD_COUNT];
+    uint64_t expected_sum;
+    uint32_t i;
+
+    //setup
+    take_metrics_snapshot(&before);
+
+    //test the specific behavior
+    for (i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&(threads[i]), NULL, record_metrics, NULL));
+    }
+    for (i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    take_metrics_snapshot(&after);
+
+    //assert the expected results
+    //ensure no update was lost (each thread's values sum to 0 + 1 + ... + (n - 1))
+    expected_sum = (uint64_t)RECORDING_THREAD_COUNT * (((uint64_t)expected_updates_per_thread * (expected_updates_per_thread - 1)) / 2);
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)RECORDING_THREAD_COUNT * expected_updates_per_thread, after.counters[METRICS_READINGS_PUBLISHED] - before.counters[METRICS_READINGS_PUBLISHED]);
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)RECORDING_THREAD_COUNT * expected_updates_per_thread, after.histograms[METRICS_ENCODE_NS].count - before.histograms[METRICS_ENCODE_NS].count);
+    TEST_ASSERT_EQUAL_UINT64(expected_sum, after.histograms[METRICS_ENCODE_NS].sum - before.histograms[METRICS_ENCODE_NS].sum);
+    //ensure the other metrics were untouched
+    TEST_ASSERT_EQUAL_UINT64(before.counters[METRICS_BYTES_SENT], after.counters[METRICS_BYTES_SENT]);
+    TEST_ASSERT_EQUAL_UINT64(before.histograms[METRICS_PUBLISH_NS].count, after.histograms[METRICS_PUBLISH_NS].count);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The get_metrics_snapshot_quantile function should provide the bucket the quantile falls in when:
+ *   - 99 values of 1000ns and one of 1000000ns are recorded
+ */
+static void test_get_metrics_snapshot_quantile_if_known_distribution_renders_bucket_of_quantile(void)
+{
+    //local vars
+    static METRICS_SNAPSHOT snapshot;
+    uint32_t i;
+
+    //setup
+    for (i = 0; i < 99; i++)
+    {
+        record_metrics_histogram(METRICS_SAMPLE_AGE_NS, 1000);
+    }
+    record_metrics_histogram(METRICS_SAMPLE_AGE_NS, 1000000);
+
+    //test the specific behavior
+    take_metrics_snapshot(&snapshot);
+
+    //assert the expected results
+    //ensure the median and 98th percentile are in 1000's bucket, and the maximum in 1000000's
+    TEST_ASSERT_EQUAL_UINT64(get_metrics_histogram_bucket_lower_bound(get_metrics_histogram_bucket_index(1000)), get_metrics_snapshot_quantile(&snapshot, METRICS_SAMPLE_AGE_NS, 0.5));
+    TEST_ASSERT_EQUAL_UINT64(get_metrics_histogram_bucket_lower_bound(get_metrics_histogram_bucket_index(1000)), get_metrics_snapshot_quantile(&snapshot, METRICS_SAMPLE_AGE_NS, 0.98));
+    TEST_ASSERT_EQUAL_UINT64(get_metrics_histogram_bucket_lower_bound(get_metrics_histogram_bucket_index(1000000)), get_metrics_snapshot_quantile(&snapshot, METRICS_SAMPLE_AGE_NS, 1.0));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The format_metrics_snapshot_as_prometheus function should provide the exposition of every metric when:
+ *   - counters, a gauge, and a histogram are recorded, then a snapshot is formatted into a buffer large enough and one too small
+ */
+static void test_format_metrics_snapshot_as_prometheus_if_recorded_metrics_renders_exposition(void)
+{
+    //local vars
+    bool operation_status;
+    static METRICS_SNAPSHOT snapshot;
+    static char buffer[32768];
+    size_t output_size = 0;
+
+    //setup
+    increment_metrics_counter(METRICS_SIGNAL_OVERRUNS, 3);
+    add_to_metrics_gauge(METRICS_QUEUE_DEPTH, 5);
+    add_to_metrics_gauge(METRICS_QUEUE_DEPTH, -2);
+    record_metrics_histogram(METRICS_PUBLISH_NS, 1500);
+    take_metrics_snapshot(&snapshot);
+
+    //test the specific behavior
+    operation_status = format_metrics_snapshot_as_prometheus(&snapshot, buffer, sizeof (buffer), &output_size);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    TEST_ASSERT_EQUAL_UINT64(strlen(buffer), output_size);
+    //ensure the metrics are present, the histogram's 2^10 ns bucket excludes the 1500ns value and its 2^11 ns bucket includes it
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "# TYPE satclient_signal_overruns_total counter\nsatclient_signal_overruns_total 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "# TYPE satclient_queue_depth gauge\nsatclient_queue_depth 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "# TYPE satclient_publish_seconds histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "satclient_publish_seconds_bucket{le=\"1.024e-06\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "satclient_publish_seconds_bucket{le=\"2.048e-06\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "satclient_publish_seconds_bucket{le=\"+Inf\"} 1\nsatclient_publish_seconds_sum 0.000001500\nsatclient_publish_seconds_count 1\n"));
+
+    //ensure a buffer too small is reported (and left null terminated)
+    operation_status = format_metrics_snapshot_as_prometheus(&snapshot, buffer, 64, &output_size);
+    TEST_ASSERT_FALSE(operation_status);
+    TEST_ASSERT_TRUE(strlen(buffer) < 64);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_get_metrics_histogram_bucket_index_if_every_magnitude_renders_bounds_within_an_eighth);
+    RUN_TEST(test_take_metrics_snapshot_if_several_threads_record_renders_every_update);
+    RUN_TEST(test_get_metrics_snapshot_quantile_if_known_distribution_renders_bucket_of_quantile);
+    RUN_TEST(test_format_metrics_snapshot_as_prometheus_if_recorded_metrics_renders_exposition);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <math.h>               //using for "sinf" and "cosf" functions
+#include "unity.h"
+#include "ahrsfilter.h"
+
+//global vars
+static const double expected_accel_scale_factor = 0.000061;
+static const double expected_magneto_scale_factor = 0.00008;
+static const double expected_gyro_scale_factor = 0.00875;
+static const float expected_beta = 0.1f;
+static const float expected_sample_period_s = 0.01f;
+
+//function declarations
+static void append_scaled_sample(SAMPLE_BATCH*, int64_t, const float*);
+static void test_init_ahrs_filter_if_sample_period_not_positive_renders_failure(void);
+static void test_update_ahrs_filter_if_board_held_tilted_renders_converged_orientation(void);
+static void test_update_ahrs_filter_if_rotating_without_reference_renders_integrated_yaw(void);
+
+//function definition
+//replace the batch's contents with a sample, given in the sensors' units (g, gauss, dps) in sample batch axis order
+static void append_scaled_sample(SAMPLE_BATCH* batch, int64_t timestamp_ns, const float* scaled_values)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t axis;
+
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        values[axis] = (int16_t)lrintf(scaled_values[axis] / (float)batch->scale_factors[axis]);
+    }
+
+    clear_sample_batch(batch);
+    append_sample_to_sample_batch(batch, timestamp_ns, values);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The init_ahrs_filter function should provide failure when:
+ *   - the nominal sample period is zero
+ */
+static void test_init_ahrs_filter_if_sample_period_not_positive_renders_failure(void)
+{
+    //local vars
+    bool operation_status;
+    AHRS_FILTER filter;
+
+    //test the specific behavior
+    operation_status = init_ahrs_filter(&filter, expected_beta, 0.0f);
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_ahrs_filter function should provide a converged orientation when:
+ *   - the board is held still, rolled 30 degrees, for 30 seconds of samples (gravity and a magnetic field pointing north and down)
+ */
+static void test_update_ahrs_filter_if_board_held_tilted_renders_converged_orientation(void)
+{
+    //local vars
+    bool operation_status = true;
+    AHRS_FILTER filter;
+    AHRS_ORIENTATION orientation;
+    static SAMPLE_BATCH batch;
+    const float roll = 30.0f * 0.0174532925f;
+    float values[SAMPLE_BATCH_AXIS_COUNT] = {0.0f};
+    uint32_t i;
+
+    //setup
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    TEST_ASSERT_TRUE(init_ahrs_filter(&filter, expected_beta, expected_sample_period_s));
+
+    //earth frame gravity (0, 0, 1) and field (0.3, 0, -0.5) as seen by a board rolled about x
+    values[SAMPLE_ACCEL_Y] = sinf(roll);
+    values[SAMPLE_ACCEL_Z] = cosf(roll);
+    values[SAMPLE_MAGNETO_X] = 0.3f;
+    values[SAMPLE_MAGNETO_Y] = -0.5f * sinf(roll);
+    values[SAMPLE_MAGNETO_Z] = -0.5f * cosf(roll);
+
+    //test the specific behavior
+    for (i = 0; i < 3000; i++)
+    {
+        append_scaled_sample(&batch, (int64_t)i * 10000000, values);
+        operation_status &= update_ahrs_filter(&filter, &batch, 0);
+    }
+    operation_status &= get_ahrs_orientation(&filter, &orientation);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the orientation has converged on the board's attitude and heading
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 30.0f, orientation.roll);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, orientation.pitch);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, orientation.yaw);
+    //ensure the quaternion is unit length and stamped with the latest sample
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, (orientation.quaternion[0] * orientation.quaternion[0]) + (orientation.quaternion[1] * orientation.quaternion[1]) +
+                                          (orientation.quaternion[2] * orientation.quaternion[2]) + (orientation.quaternion[3] * orientation.quaternion[3]));
+    TEST_ASSERT_TRUE(orientation.timestamp_ns == (int64_t)2999 * 10000000);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_ahrs_filter function should provide the integrated yaw when:
+ *   - the board spins about z at 90 dps for 1 second with no accelerometer or magnetometer reading,
+ *     sampled every 20ms (twice the nominal period, so the timestamps must be what sets the integration step)
+ */
+static void test_update_ahrs_filter_if_rotating_without_reference_renders_integrated_yaw(void)
+{
+    //local vars
+    bool operation_status = true;
+    AHRS_FILTER filter;
+    AHRS_ORIENTATION orientation;
+    static SAMPLE_BATCH batch;
+    float values[SAMPLE_BATCH_AXIS_COUNT] = {0.0f};
+    uint32_t i;
+
+    //setup
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    TEST_ASSERT_TRUE(init_ahrs_filter(&filter, expected_beta, expected_sample_period_s));
+    values[SAMPLE_GYRO_Z] = 90.0f;
+
+    //test the specific behavior
+    //(the first sample has no predecessor so it integrates the nominal 10ms, the next follows 10ms later, then every 20ms)
+    append_scaled_sample(&batch, 0, values);
+    operation_status &= update_ahrs_filter(&filter, &batch, 0);
+    for (i = 1; i <= 50; i++)
+    {
+        append_scaled_sample(&batch, ((int64_t)i * 20000000) - 10000000, values);
+        operation_status &= update_ahrs_filter(&filter, &batch, 0);
+    }
+    operation_status &= get_ahrs_orientation(&filter, &orientation);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the rotation was integrated over 1 second (0.01s + 0.01s + 49 * 0.02s)
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 90.0f, orientation.yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, orientation.roll);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, orientation.pitch);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_init_ahrs_filter_if_sample_period_not_positive_renders_failure);
+    RUN_TEST(test_update_ahrs_filter_if_board_held_tilted_renders_converged_orientation);
+    RUN_TEST(test_update_ahrs_filter_if_rotating_without_reference_renders_integrated_yaw);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
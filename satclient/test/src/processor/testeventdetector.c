@@ -0,0 +1,196 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include "unity.h"
+#include "eventdetector.h"
+
+//global vars
+static const int16_t expected_raw_1g = 16393;               //1g at the accelerometer's 2g full scale (0.000061 g per lsb)
+static const int16_t expected_raw_40dps = 4571;             //40dps at the gyroscope's 245dps full scale (0.00875 dps per lsb)
+
+//function declarations
+static void set_default_options(EVENT_DETECTOR_OPTIONS*);
+static bool run_sample(EVENT_DETECTOR*, SAMPLE_BATCH*, int64_t, int16_t, int16_t, EVENT_TRANSITION*);
+static void test_update_event_detector_if_gyro_spike_after_rest_renders_event_with_pre_trigger_history(void);
+static void test_update_event_detector_if_quiet_for_hold_length_renders_event_end(void);
+static void test_update_event_detector_if_step_within_thresholds_renders_baseline_and_zscore_detections(void);
+
+//function definition
+//options with only the threshold detector enabled (1g +/- 0.5g, 30dps), a hold of 5 samples and 3 samples of pre-trigger history
+static void set_default_options(EVENT_DETECTOR_OPTIONS* options)
+{
+    options->accel_threshold_g = 0.5f;
+    options->gyro_threshold_dps = 30.0f;
+    options->accel_delta_g = 0.0f;
+    options->gyro_delta_dps = 0.0f;
+    options->baseline_length = 100;
+    options->zscore_threshold = 0.0f;
+    options->zscore_length = 20;
+    options->hold_length = 5;
+    options->pre_trigger_length = 3;
+}
+
+//function definition
+//run a sample (level board, accelerometer z and gyroscope x as given, every other axis zero) through the detector, as the only sample in the batch
+static bool run_sample(EVENT_DETECTOR* detector, SAMPLE_BATCH* batch, int64_t timestamp_ns, int16_t accel_z, int16_t gyro_x, EVENT_TRANSITION* transition)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {0};
+
+    values[SAMPLE_ACCEL_Z] = accel_z;
+    values[SAMPLE_GYRO_X] = gyro_x;
+
+    clear_sample_batch(batch);
+    set_sample_batch_scale_factors(batch, 0.000061, 0.00008, 0.00875);
+
+    return append_sample_to_sample_batch(batch, timestamp_ns, values) && update_event_detector(detector, batch, 0, 0, transition);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_event_detector function should provide the start of an event, with the pre-trigger history leading up to it, when:
+ *   - 10 samples at rest (1g, 0dps) are followed by a 40dps sample (threshold 30dps, pre-trigger length 3)
+ */
+static void test_update_event_detector_if_gyro_spike_after_rest_renders_event_with_pre_trigger_history(void)
+{
+    //local vars
+    bool operation_status = true;
+    static EVENT_DETECTOR detector;
+    static SAMPLE_BATCH batch;
+    static SAMPLE_BATCH history;
+    EVENT_DETECTOR_OPTIONS options;
+    EVENT_TRANSITION transition;
+    uint32_t moved_count;
+    int64_t i;
+
+    //setup
+    set_default_options(&options);
+    TEST_ASSERT_TRUE(init_event_detector(&detector, &options));
+    for (i = 0; i < 10; i++)
+    {
+        operation_status &= run_sample(&detector, &batch, i * 10000000, expected_raw_1g, 0, &transition);
+        TEST_ASSERT_EQUAL_INT(NO_EVENT_TRANSITION, transition);
+    }
+
+    //test the specific behavior
+    operation_status &= run_sample(&detector, &batch, 100000000, expected_raw_1g, expected_raw_40dps, &transition);
+    clear_sample_batch(&history);
+    moved_count = move_event_detector_history_to_sample_batch(&detector, &history, SAMPLE_BATCH_MAX_SAMPLES);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the event started, by the threshold detector
+    TEST_ASSERT_EQUAL_INT(EVENT_STARTED, transition);
+    TEST_ASSERT_TRUE(detector.event_active);
+    TEST_ASSERT_EQUAL_UINT8(THRESHOLD_EVENT_DETECTOR, detector.event_detections);
+    TEST_ASSERT_EQUAL_UINT32(1, detector.event_count);
+    //ensure the history holds the 3 samples before the event (oldest first), then the sample that started it
+    TEST_ASSERT_EQUAL_UINT32(4, moved_count);
+    TEST_ASSERT_EQUAL_UINT32(0, detector.history_count);
+    TEST_ASSERT_TRUE(history.timestamps_ns[0] == 70000000);
+    TEST_ASSERT_TRUE(history.timestamps_ns[2] == 90000000);
+    TEST_ASSERT_TRUE(history.timestamps_ns[3] == 100000000);
+    TEST_ASSERT_EQUAL_INT16(0, history.raw[SAMPLE_GYRO_X][2]);
+    TEST_ASSERT_EQUAL_INT16(expected_raw_40dps, history.raw[SAMPLE_GYRO_X][3]);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_event_detector function should provide the end of an event when:
+ *   - an event (started by a 0.4g accelerometer magnitude, threshold 0.5g from 1g) is followed by the hold length (5) of samples at rest
+ */
+static void test_update_event_detector_if_quiet_for_hold_length_renders_event_end(void)
+{
+    //local vars
+    bool operation_status = true;
+    static EVENT_DETECTOR detector;
+    static SAMPLE_BATCH batch;
+    EVENT_DETECTOR_OPTIONS options;
+    EVENT_TRANSITION transition;
+    int64_t i;
+
+    //setup
+    set_default_options(&options);
+    TEST_ASSERT_TRUE(init_event_detector(&detector, &options));
+    operation_status &= run_sample(&detector, &batch, 0, expected_raw_1g, 0, &transition);
+    operation_status &= run_sample(&detector, &batch, 10000000, (int16_t)(expected_raw_1g * 0.4f), 0, &transition);
+    TEST_ASSERT_EQUAL_INT(EVENT_STARTED, transition);
+
+    //test the specific behavior
+    for (i = 0; i < 4; i++)
+    {
+        operation_status &= run_sample(&detector, &batch, (i + 2) * 10000000, expected_raw_1g, 0, &transition);
+        TEST_ASSERT_EQUAL_INT(NO_EVENT_TRANSITION, transition);
+    }
+    operation_status &= run_sample(&detector, &batch, 60000000, expected_raw_1g, 0, &transition);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the event ended on the 5th quiet sample, which is the last of its 6 samples
+    TEST_ASSERT_EQUAL_INT(EVENT_ENDED, transition);
+    TEST_ASSERT_FALSE(detector.event_active);
+    TEST_ASSERT_EQUAL_UINT32(6, detector.event_sample_count);
+    TEST_ASSERT_TRUE(detector.event_start_timestamp_ns == 10000000);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The update_event_detector function should provide baseline and z-score detections, but no threshold detection, when:
+ *   - the gyroscope rate steps from a steady 5dps (with +/-0.1dps of noise) to 20dps, under the 30dps threshold
+ *     but more than the 10dps delta from its baseline and more than 6 standard deviations from its recent mean
+ */
+static void test_update_event_detector_if_step_within_thresholds_renders_baseline_and_zscore_detections(void)
+{
+    //local vars
+    bool operation_status = true;
+    static EVENT_DETECTOR detector;
+    static SAMPLE_BATCH batch;
+    EVENT_DETECTOR_OPTIONS options;
+    EVENT_TRANSITION transition;
+    int64_t i;
+
+    //setup
+    set_default_options(&options);
+    options.gyro_delta_dps = 10.0f;
+    options.zscore_threshold = 6.0f;
+    TEST_ASSERT_TRUE(init_event_detector(&detector, &options));
+    for (i = 0; i < 50; i++)
+    {
+        operation_status &= run_sample(&detector, &batch, i * 10000000, expected_raw_1g, (int16_t)(571 + (((i % 3) - 1) * 11)), &transition);
+        TEST_ASSERT_EQUAL_INT(NO_EVENT_TRANSITION, transition);
+    }
+
+    //test the specific behavior
+    operation_status &= run_sample(&detector, &batch, 500000000, expected_raw_1g, 2286, &transition);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the event started, by the baseline and z-score detectors only
+    TEST_ASSERT_EQUAL_INT(EVENT_STARTED, transition);
+    TEST_ASSERT_EQUAL_UINT8(BASELINE_EVENT_DETECTOR | ZSCORE_EVENT_DETECTOR, detector.event_detections);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_update_event_detector_if_gyro_spike_after_rest_renders_event_with_pre_trigger_history);
+    RUN_TEST(test_update_event_detector_if_quiet_for_hold_length_renders_event_end);
+    RUN_TEST(test_update_event_detector_if_step_within_thresholds_renders_baseline_and_zscore_detections);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
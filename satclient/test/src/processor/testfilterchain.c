@@ -0,0 +1,226 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <stdlib.h>             //using for "abs" function
+#include <math.h>               //using for "sinf" and "lrintf" functions
+#include "unity.h"
+#include "filterchain.h"
+
+//global vars
+static const float expected_input_rate_hz = 100.0f;
+
+//function declarations
+static void fill_sample_batch(SAMPLE_BATCH*, const int16_t*, uint32_t, int64_t);
+static void test_add_filter_stages_from_specification_if_cutoff_above_nyquist_renders_failure(void);
+static void test_run_filter_chain_if_constant_input_renders_unchanged_lowpass_and_zero_highpass(void);
+static void test_run_filter_chain_if_average_decimator_renders_means_with_completing_timestamps(void);
+static void test_run_filter_chain_if_fir_decimator_given_tone_above_decimated_nyquist_renders_attenuated_output(void);
+
+//function definition
+//replace the batch's contents with count samples, every axis of a sample holding the same value (timestamps 10ms apart from the first)
+static void fill_sample_batch(SAMPLE_BATCH* batch, const int16_t* values, uint32_t count, int64_t first_timestamp_ns)
+{
+    //local vars
+    int16_t sample_values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t axis;
+    uint32_t i;
+
+    clear_sample_batch(batch);
+    for (i = 0; i < count; i++)
+    {
+        for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+        {
+            sample_values[axis] = values[i];
+        }
+
+        append_sample_to_sample_batch(batch, first_timestamp_ns + ((int64_t)i * 10000000), sample_values);
+    }
+}
+
+//function definition
+/*
+ *   Behavior Tested: The add_filter_stages_from_specification function should provide failure when:
+ *   - a low-pass cutoff is above the nyquist frequency of the stage's input (100hz decimated by 4 = 25hz, nyquist 12.5hz)
+ */
+static void test_add_filter_stages_from_specification_if_cutoff_above_nyquist_renders_failure(void)
+{
+    //local vars
+    bool operation_status;
+    static FILTER_CHAIN chain;
+
+    //setup
+    TEST_ASSERT_TRUE(init_filter_chain(&chain, expected_input_rate_hz));
+
+    //test the specific behavior
+    operation_status = add_filter_stages_from_specification(&chain, "fir:4,lowpass:20");
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+    //ensure only the valid stage was added
+    TEST_ASSERT_EQUAL_UINT32(1, chain.stage_count);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, chain.output_rate_hz);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The run_filter_chain function should provide an unchanged low-pass output and zero high-pass output when:
+ *   - a constant input (1000) is run through a low-pass chain and a high-pass chain, a batch at a time
+ */
+static void test_run_filter_chain_if_constant_input_renders_unchanged_lowpass_and_zero_highpass(void)
+{
+    //local vars
+    bool operation_status = true;
+    static FILTER_CHAIN lowpass_chain;
+    static FILTER_CHAIN highpass_chain;
+    static SAMPLE_BATCH input;
+    static SAMPLE_BATCH lowpass_output;
+    static SAMPLE_BATCH highpass_output;
+    int16_t values[SAMPLE_BATCH_MAX_SAMPLES];
+    uint32_t batch_index;
+    uint32_t i;
+
+    //setup
+    TEST_ASSERT_TRUE(init_filter_chain(&lowpass_chain, expected_input_rate_hz) && add_filter_stages_from_specification(&lowpass_chain, "lowpass:5"));
+    TEST_ASSERT_TRUE(init_filter_chain(&highpass_chain, expected_input_rate_hz) && add_filter_stages_from_specification(&highpass_chain, "highpass:5"));
+    for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+    {
+        values[i] = 1000;
+    }
+
+    for (batch_index = 0; batch_index < 4; batch_index++)
+    {
+        fill_sample_batch(&input, values, SAMPLE_BATCH_MAX_SAMPLES, 0);
+        clear_sample_batch(&lowpass_output);
+        clear_sample_batch(&highpass_output);
+
+        //test the specific behavior
+        operation_status &= run_filter_chain(&lowpass_chain, &input, &lowpass_output);
+        operation_status &= run_filter_chain(&highpass_chain, &input, &highpass_output);
+
+        //assert the expected results
+        //ensure every sample passes straight through the low-pass and is removed by the high-pass (no start up transient)
+        TEST_ASSERT_EQUAL_UINT32(SAMPLE_BATCH_MAX_SAMPLES, lowpass_output.sample_count);
+        TEST_ASSERT_EQUAL_UINT32(SAMPLE_BATCH_MAX_SAMPLES, highpass_output.sample_count);
+        for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+        {
+            TEST_ASSERT_EQUAL_INT16(1000, lowpass_output.raw[SAMPLE_GYRO_Z][i]);
+            TEST_ASSERT_EQUAL_INT16(0, highpass_output.raw[SAMPLE_ACCEL_X][i]);
+        }
+    }
+
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The run_filter_chain function should provide the means of each pair of samples, stamped with the second sample's timestamp, when:
+ *   - the samples 1, 3, 5, 7, 9 then (in a second batch) 11 are run through an average decimator of 2
+ */
+static void test_run_filter_chain_if_average_decimator_renders_means_with_completing_timestamps(void)
+{
+    //local vars
+    bool operation_status = true;
+    static FILTER_CHAIN chain;
+    static SAMPLE_BATCH input;
+    static SAMPLE_BATCH output;
+    const int16_t first_values[] = {1, 3, 5, 7, 9};
+    const int16_t second_values[] = {11};
+
+    //setup
+    TEST_ASSERT_TRUE(init_filter_chain(&chain, expected_input_rate_hz) && add_filter_stages_from_specification(&chain, "average:2"));
+    clear_sample_batch(&output);
+
+    //test the specific behavior
+    fill_sample_batch(&input, first_values, 5, 0);
+    operation_status &= run_filter_chain(&chain, &input, &output);
+    fill_sample_batch(&input, second_values, 1, 50000000);
+    operation_status &= run_filter_chain(&chain, &input, &output);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the pairs (including the one split across batches) were averaged
+    TEST_ASSERT_EQUAL_UINT32(3, output.sample_count);
+    TEST_ASSERT_EQUAL_INT16(2, output.raw[SAMPLE_MAGNETO_Y][0]);
+    TEST_ASSERT_EQUAL_INT16(6, output.raw[SAMPLE_MAGNETO_Y][1]);
+    TEST_ASSERT_EQUAL_INT16(10, output.raw[SAMPLE_MAGNETO_Y][2]);
+    TEST_ASSERT_TRUE(output.timestamps_ns[0] == 10000000);
+    TEST_ASSERT_TRUE(output.timestamps_ns[1] == 30000000);
+    TEST_ASSERT_TRUE(output.timestamps_ns[2] == 50000000);
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, chain.output_rate_hz);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The run_filter_chain function should provide an attenuated output when:
+ *   - a 40hz tone (amplitude 10000) sampled at 100hz is run through a fir decimator of 4 (which would alias it to 10hz)
+ */
+static void test_run_filter_chain_if_fir_decimator_given_tone_above_decimated_nyquist_renders_attenuated_output(void)
+{
+    //local vars
+    bool operation_status = true;
+    static FILTER_CHAIN chain;
+    static SAMPLE_BATCH input;
+    static SAMPLE_BATCH output;
+    int16_t values[SAMPLE_BATCH_MAX_SAMPLES];
+    int16_t peak = 0;
+    uint32_t sample_index = 0;
+    uint32_t batch_index;
+    uint32_t i;
+
+    //setup
+    TEST_ASSERT_TRUE(init_filter_chain(&chain, expected_input_rate_hz) && add_filter_stages_from_specification(&chain, "fir:4"));
+
+    for (batch_index = 0; batch_index < 20; batch_index++)
+    {
+        for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++, sample_index++)
+        {
+            values[i] = (int16_t)lrintf(10000.0f * sinf(2.0f * 3.14159265f * 40.0f * ((float)sample_index / expected_input_rate_hz)));
+        }
+        fill_sample_batch(&input, values, SAMPLE_BATCH_MAX_SAMPLES, 0);
+        clear_sample_batch(&output);
+
+        //test the specific behavior
+        operation_status &= run_filter_chain(&chain, &input, &output);
+
+        //assert the expected results
+        //ensure every 4th sample was output
+        TEST_ASSERT_EQUAL_UINT32(SAMPLE_BATCH_MAX_SAMPLES / 4, output.sample_count);
+
+        //track the output's peak once the filter's history holds only the tone
+        for (i = 0; (batch_index > 4) && (i < output.sample_count); i++)
+        {
+            peak = (abs(output.raw[SAMPLE_ACCEL_Z][i]) > peak) ? abs(output.raw[SAMPLE_ACCEL_Z][i]) : peak;
+        }
+    }
+
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the tone was attenuated by at least 40db
+    TEST_ASSERT_INT16_WITHIN(100, 0, peak);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_add_filter_stages_from_specification_if_cutoff_above_nyquist_renders_failure);
+    RUN_TEST(test_run_filter_chain_if_constant_input_renders_unchanged_lowpass_and_zero_highpass);
+    RUN_TEST(test_run_filter_chain_if_average_decimator_renders_means_with_completing_timestamps);
+    RUN_TEST(test_run_filter_chain_if_fir_decimator_given_tone_above_decimated_nyquist_renders_attenuated_output);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
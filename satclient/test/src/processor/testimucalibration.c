@@ -0,0 +1,242 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <stdio.h>              //using for "remove" function
+#include <math.h>               //using for "sqrtf", "sinf", "cosf", and "lrintf" functions
+#include "unity.h"
+#include "imucalibration.h"
+
+//global vars
+static const double expected_magneto_scale_factor = 0.00008;    //gauss per lsb at the magnetometer's 2 gauss full scale
+static const double expected_gyro_scale_factor = 0.00875;       //dps per lsb at the gyroscope's 245dps full scale
+static const char* expected_calibration_file = "/tmp/testimucalibration.txt";
+
+//function declarations
+static void get_distorted_field_sample(uint32_t, uint32_t, const int16_t*, int16_t*);
+static void test_compute_magneto_ellipsoid_fit_if_hard_and_soft_iron_distortion_renders_offsets_and_matrix(void);
+static void test_compute_gyro_bias_if_at_rest_or_moving_renders_bias_or_rejection(void);
+static void test_load_imu_calibration_if_saved_calibration_renders_same_calibration(void);
+
+//function definition
+//the sample_index-th (of sample_count, spread evenly over the sphere) raw magnetometer reading of a 0.5 gauss field, distorted by hard iron
+//(an offset of 1200, -800, 400) and soft iron (a stretched and skewed matrix), as read with the supplied offsets already subtracted by the sensor
+static void get_distorted_field_sample(uint32_t sample_index, uint32_t sample_count, const int16_t* applied_offsets, int16_t* values)
+{
+    //local vars
+    static const float soft_iron[3][3] = {{1.20f, 0.10f, 0.05f}, {0.10f, 0.90f, -0.08f}, {0.05f, -0.08f, 1.05f}};
+    static const float hard_iron[3] = {1200.0f, -800.0f, 400.0f};
+    float direction[3];
+    float height;
+    float radius;
+    float angle;
+    uint32_t row;
+
+    //fibonacci sphere
+    height = 1.0f - ((2.0f * (sample_index + 0.5f)) / sample_count);
+    radius = sqrtf(1.0f - (height * height));
+    angle = 2.39996323f * sample_index;
+    direction[0] = radius * cosf(angle);
+    direction[1] = radius * sinf(angle);
+    direction[2] = height;
+
+    for (row = 0; row < 3; row++)
+    {
+        values[SAMPLE_MAGNETO_X + row] = (int16_t)lrintf(((0.5f * ((soft_iron[row][0] * direction[0]) + (soft_iron[row][1] * direction[1]) + (soft_iron[row][2] * direction[2]))) /
+                                                          (float)expected_magneto_scale_factor) + hard_iron[row] - applied_offsets[row]);
+    }
+}
+
+//function definition
+/*
+ *   Behavior Tested: The compute_magneto_ellipsoid_fit function should provide the hard iron offsets and a soft iron matrix that restores a constant field magnitude when:
+ *   - 1000 readings spread over the sphere are distorted by hard iron (1200, -800, 400) and soft iron, with offsets of 100 already applied by the sensor
+ */
+static void test_compute_magneto_ellipsoid_fit_if_hard_and_soft_iron_distortion_renders_offsets_and_matrix(void)
+{
+    //local vars
+    bool operation_status = true;
+    static MAGNETO_ELLIPSOID_FIT fit;
+    static SAMPLE_BATCH batch;
+    IMU_CALIBRATION calibration;
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {0};
+    const float* columns[3];
+    float magnitudes[SAMPLE_BATCH_MAX_SAMPLES];
+    float mean_magnitude = 0.0f;
+    uint32_t axis;
+    uint32_t i;
+
+    //setup
+    init_imu_calibration(&calibration);
+    calibration.magneto_offsets[0] = calibration.magneto_offsets[1] = calibration.magneto_offsets[2] = 100;
+    init_magneto_ellipsoid_fit(&fit);
+    clear_sample_batch(&batch);
+    set_sample_batch_scale_factors(&batch, 0.000061, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    for (i = 0; i < 1000; i++)
+    {
+        get_distorted_field_sample(i, 1000, calibration.magneto_offsets, values);
+        clear_sample_batch(&batch);
+        operation_status &= append_sample_to_sample_batch(&batch, i, values) && add_sample_to_magneto_ellipsoid_fit(&fit, &batch, 0);
+    }
+
+    //test the specific behavior
+    operation_status &= compute_magneto_ellipsoid_fit(&fit, &calibration);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the offsets are the hard iron (within rounding)
+    TEST_ASSERT_INT16_WITHIN(2, 1200, calibration.magneto_offsets[0]);
+    TEST_ASSERT_INT16_WITHIN(2, -800, calibration.magneto_offsets[1]);
+    TEST_ASSERT_INT16_WITHIN(2, 400, calibration.magneto_offsets[2]);
+    //ensure the matrix is symmetric
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, calibration.magneto_matrix[0][1], calibration.magneto_matrix[1][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, calibration.magneto_matrix[1][2], calibration.magneto_matrix[2][1]);
+
+    //ensure readings taken with the new offsets, corrected by the batch as it scales, have a constant magnitude (within 0.5%)
+    clear_sample_batch(&batch);
+    TEST_ASSERT_TRUE(apply_imu_calibration_to_sample_batch(&calibration, &batch));
+    for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+    {
+        get_distorted_field_sample(i * 31, SAMPLE_BATCH_MAX_SAMPLES * 31, calibration.magneto_offsets, values);
+        TEST_ASSERT_TRUE(append_sample_to_sample_batch(&batch, i, values));
+    }
+    for (axis = 0; axis < 3; axis++)
+    {
+        columns[axis] = get_scaled_sample_batch_column(&batch, SAMPLE_MAGNETO_X + axis);
+    }
+    for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+    {
+        magnitudes[i] = sqrtf((columns[0][i] * columns[0][i]) + (columns[1][i] * columns[1][i]) + (columns[2][i] * columns[2][i]));
+        mean_magnitude += magnitudes[i] / SAMPLE_BATCH_MAX_SAMPLES;
+    }
+    for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(0.005f * mean_magnitude, mean_magnitude, magnitudes[i]);
+    }
+    //ensure the magnitude is the ellipsoid's mean radius (the soft iron's determinant is ~1.113, so 0.5 gauss * its cube root)
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, 0.518f, mean_magnitude);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The compute_gyro_bias function should provide the bias when at rest, and reject it when moving, when:
+ *   - 300 samples of a bias (100, -50, 20) with +/-2 lsb of noise are followed by 300 samples rotating at +/-20dps
+ */
+static void test_compute_gyro_bias_if_at_rest_or_moving_renders_bias_or_rejection(void)
+{
+    //local vars
+    bool operation_status = true;
+    GYRO_BIAS_ESTIMATOR estimator;
+    static SAMPLE_BATCH batch;
+    IMU_CALIBRATION calibration;
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {0};
+    bool at_rest = false;
+    int16_t noise;
+    uint32_t i;
+
+    //setup
+    init_imu_calibration(&calibration);
+    init_gyro_bias_estimator(&estimator);
+    for (i = 0; i < 300; i++)
+    {
+        noise = (int16_t)((i % 5) - 2);
+        values[SAMPLE_GYRO_X] = 100 + noise;
+        values[SAMPLE_GYRO_Y] = -50 - noise;
+        values[SAMPLE_GYRO_Z] = 20 + noise;
+        clear_sample_batch(&batch);
+        operation_status &= append_sample_to_sample_batch(&batch, i, values) && add_sample_to_gyro_bias_estimator(&estimator, &batch, 0);
+    }
+
+    //test the specific behavior
+    operation_status &= compute_gyro_bias(&estimator, expected_gyro_scale_factor, 1.0, &calibration, &at_rest);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the board was at rest and its bias found
+    TEST_ASSERT_TRUE(at_rest);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, calibration.gyro_bias[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -50.0f, calibration.gyro_bias[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, calibration.gyro_bias[2]);
+
+    //ensure a moving board is rejected, leaving the calibration untouched
+    init_gyro_bias_estimator(&estimator);
+    for (i = 0; i < 300; i++)
+    {
+        values[SAMPLE_GYRO_X] = ((i % 2) == 0) ? 2286 : -2286;
+        clear_sample_batch(&batch);
+        TEST_ASSERT_TRUE(append_sample_to_sample_batch(&batch, i, values) && add_sample_to_gyro_bias_estimator(&estimator, &batch, 0));
+    }
+    TEST_ASSERT_TRUE(compute_gyro_bias(&estimator, expected_gyro_scale_factor, 1.0, &calibration, &at_rest));
+    TEST_ASSERT_FALSE(at_rest);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, calibration.gyro_bias[0]);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The load_imu_calibration function should provide the saved calibration when:
+ *   - a calibration with a bias, offsets, and a matrix is saved, then loaded over an uncalibrated one
+ */
+static void test_load_imu_calibration_if_saved_calibration_renders_same_calibration(void)
+{
+    //local vars
+    bool operation_status = true;
+    IMU_CALIBRATION saved_calibration;
+    IMU_CALIBRATION loaded_calibration;
+    uint32_t row;
+    uint32_t column;
+
+    //setup
+    init_imu_calibration(&saved_calibration);
+    init_imu_calibration(&loaded_calibration);
+    saved_calibration.gyro_bias[0] = 12.345678f;
+    saved_calibration.gyro_bias[2] = -0.1f;
+    saved_calibration.magneto_offsets[0] = -32768;
+    saved_calibration.magneto_offsets[1] = 1234;
+    saved_calibration.magneto_matrix[0][1] = saved_calibration.magneto_matrix[1][0] = 0.0123456789f;
+    saved_calibration.magneto_matrix[2][2] = 0.987654321f;
+
+    //test the specific behavior
+    operation_status &= save_imu_calibration(&saved_calibration, expected_calibration_file);
+    operation_status &= load_imu_calibration(&loaded_calibration, expected_calibration_file);
+    remove(expected_calibration_file);
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure every value was read back
+    for (row = 0; row < 3; row++)
+    {
+        TEST_ASSERT_EQUAL_FLOAT(saved_calibration.gyro_bias[row], loaded_calibration.gyro_bias[row]);
+        TEST_ASSERT_EQUAL_INT16(saved_calibration.magneto_offsets[row], loaded_calibration.magneto_offsets[row]);
+        for (column = 0; column < 3; column++)
+        {
+            TEST_ASSERT_EQUAL_FLOAT(saved_calibration.magneto_matrix[row][column], loaded_calibration.magneto_matrix[row][column]);
+        }
+    }
+    //ensure a missing file fails, leaving the calibration untouched
+    TEST_ASSERT_FALSE(load_imu_calibration(&loaded_calibration, expected_calibration_file));
+    TEST_ASSERT_EQUAL_INT16(1234, loaded_calibration.magneto_offsets[1]);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_compute_magneto_ellipsoid_fit_if_hard_and_soft_iron_distortion_renders_offsets_and_matrix);
+    RUN_TEST(test_compute_gyro_bias_if_at_rest_or_moving_renders_bias_or_rejection);
+    RUN_TEST(test_load_imu_calibration_if_saved_calibration_renders_same_calibration);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
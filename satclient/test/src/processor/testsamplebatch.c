@@ -0,0 +1,157 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include "unity.h"
+#include "samplebatch.h"
+
+//global vars
+static const double expected_accel_scale_factor = 0.000061;
+static const double expected_magneto_scale_factor = 0.00008;
+static const double expected_gyro_scale_factor = 0.00875;
+
+//function declarations
+static void test_append_sample_to_sample_batch_if_batch_full_renders_failure(void);
+static void test_get_scaled_sample_batch_column_if_samples_appended_after_scaling_renders_valid_column(void);
+static void test_get_scaled_sample_batch_column_if_sensors_corrected_renders_corrected_columns(void);
+
+//function definition
+/*
+ *   Behavior Tested: The append_sample_to_sample_batch function should provide failure when:
+ *   - the batch already holds SAMPLE_BATCH_MAX_SAMPLES samples
+ */
+static void test_append_sample_to_sample_batch_if_batch_full_renders_failure(void)
+{
+    //local vars
+    bool operation_status = true;
+    static SAMPLE_BATCH batch;
+    const int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint32_t i;
+
+    //setup
+    clear_sample_batch(&batch);
+    for (i = 0; i < SAMPLE_BATCH_MAX_SAMPLES; i++)
+    {
+        operation_status &= append_sample_to_sample_batch(&batch, i, values);
+    }
+    TEST_ASSERT_TRUE(operation_status);
+
+    //test the specific behavior
+    operation_status = append_sample_to_sample_batch(&batch, SAMPLE_BATCH_MAX_SAMPLES, values);
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+    //ensure the batch is unchanged
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_BATCH_MAX_SAMPLES, batch.sample_count);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The get_scaled_sample_batch_column function should provide a valid column when:
+ *   - a sample (raw values -2018, 1, 32767 on each sensor) is appended after the column was already scaled once
+ */
+static void test_get_scaled_sample_batch_column_if_samples_appended_after_scaling_renders_valid_column(void)
+{
+    //local vars
+    static SAMPLE_BATCH batch;
+    const int16_t first_values[SAMPLE_BATCH_AXIS_COUNT] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    const int16_t second_values[SAMPLE_BATCH_AXIS_COUNT] = {-2018, 1, 32767, -2018, 1, 32767, -2018, 1, 32767};
+    const float* accel_x;
+    const float* magneto_y;
+    const float* gyro_z;
+
+    //setup
+    clear_sample_batch(&batch);
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    TEST_ASSERT_TRUE(append_sample_to_sample_batch(&batch, 10, first_values));
+    TEST_ASSERT_NOT_NULL(get_scaled_sample_batch_column(&batch, SAMPLE_ACCEL_X));
+    TEST_ASSERT_TRUE(append_sample_to_sample_batch(&batch, 20, second_values));
+
+    //test the specific behavior
+    accel_x = get_scaled_sample_batch_column(&batch, SAMPLE_ACCEL_X);
+    magneto_y = get_scaled_sample_batch_column(&batch, SAMPLE_MAGNETO_Y);
+    gyro_z = get_scaled_sample_batch_column(&batch, SAMPLE_GYRO_Z);
+
+    //assert the expected results
+    //ensure the columns exist
+    TEST_ASSERT_NOT_NULL(accel_x);
+    TEST_ASSERT_NOT_NULL(magneto_y);
+    TEST_ASSERT_NOT_NULL(gyro_z);
+    //ensure both samples are scaled (the second one after the first was already scaled)
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, accel_x[0]);
+    TEST_ASSERT_EQUAL_FLOAT(-2018 * (float)expected_accel_scale_factor, accel_x[1]);
+    TEST_ASSERT_EQUAL_FLOAT((float)expected_magneto_scale_factor, magneto_y[1]);
+    TEST_ASSERT_EQUAL_FLOAT(32767 * (float)expected_gyro_scale_factor, gyro_z[1]);
+    //ensure the timestamps are kept
+    TEST_ASSERT_TRUE(batch.timestamps_ns[1] == 20);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The get_scaled_sample_batch_column function should provide corrected columns when:
+ *   - the gyroscope has an offset correction (a bias of 100, -50, 0 removed) and the magnetometer a matrix correction (axes swapped and doubled),
+ *     leaving the accelerometer uncorrected
+ */
+static void test_get_scaled_sample_batch_column_if_sensors_corrected_renders_corrected_columns(void)
+{
+    //local vars
+    static SAMPLE_BATCH batch;
+    const int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {-2018, 1, 32767, 1000, 2000, 3000, 100, 50, -400};
+    const float magneto_matrix[3][3] = {{0.0f, 2.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 2.0f}};
+    const float gyro_offsets[3] = {-100.0f, 50.0f, 0.0f};
+    const float* columns[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t axis;
+
+    //setup
+    clear_sample_batch(&batch);
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    TEST_ASSERT_TRUE(append_sample_to_sample_batch(&batch, 10, values));
+    TEST_ASSERT_NOT_NULL(get_scaled_sample_batch_column(&batch, SAMPLE_ACCEL_X));
+
+    //test the specific behavior
+    TEST_ASSERT_TRUE(set_sample_batch_correction(&batch, SAMPLE_MAGNETO_X, magneto_matrix, NULL));
+    TEST_ASSERT_TRUE(set_sample_batch_correction(&batch, SAMPLE_GYRO_X, NULL, gyro_offsets));
+    for (axis = 0; axis < SAMPLE_BATCH_AXIS_COUNT; axis++)
+    {
+        columns[axis] = get_scaled_sample_batch_column(&batch, axis);
+        TEST_ASSERT_NOT_NULL(columns[axis]);
+    }
+
+    //assert the expected results
+    //ensure a correction can't be set from the middle of a sensor
+    TEST_ASSERT_FALSE(set_sample_batch_correction(&batch, SAMPLE_MAGNETO_Y, magneto_matrix, NULL));
+    //ensure the uncorrected sensor is scaled as before (bit for bit)
+    TEST_ASSERT_EQUAL_FLOAT(-2018 * (float)expected_accel_scale_factor, columns[SAMPLE_ACCEL_X][0]);
+    //ensure the corrected sensors were rescaled (already scaled samples included) with their corrections
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 4000 * expected_magneto_scale_factor, columns[SAMPLE_MAGNETO_X][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2000 * expected_magneto_scale_factor, columns[SAMPLE_MAGNETO_Y][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6000 * expected_magneto_scale_factor, columns[SAMPLE_MAGNETO_Z][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, columns[SAMPLE_GYRO_X][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 100 * expected_gyro_scale_factor, columns[SAMPLE_GYRO_Y][0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -400 * expected_gyro_scale_factor, columns[SAMPLE_GYRO_Z][0]);
+    //ensure setting the scale factors removes the corrections
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+    TEST_ASSERT_EQUAL_FLOAT(100 * (float)expected_gyro_scale_factor, get_scaled_sample_batch_column(&batch, SAMPLE_GYRO_X)[0]);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_append_sample_to_sample_batch_if_batch_full_renders_failure);
+    RUN_TEST(test_get_scaled_sample_batch_column_if_samples_appended_after_scaling_renders_valid_column);
+    RUN_TEST(test_get_scaled_sample_batch_column_if_sensors_corrected_renders_corrected_columns);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <math.h>               //using for "sinf" and "lrintf" functions
+#include "unity.h"
+#include "spectralanalyzer.h"
+
+//global vars
+static const float expected_sample_rate_hz = 100.0f;
+static const double expected_accel_scale_factor = 0.000061;     //g per lsb at the accelerometer's 2g full scale
+
+//function declarations
+static bool add_tone_sample(SPECTRAL_ANALYZER*, uint32_t, float, float, SPECTRAL_FEATURES*, bool*);
+static void test_init_spectral_analyzer_if_length_not_power_of_two_renders_failure(void);
+static void test_add_sample_to_spectral_analyzer_if_tone_on_bin_renders_frequency_amplitude_and_band(void);
+static void test_add_sample_to_spectral_analyzer_if_sliding_tone_between_bins_renders_interpolated_frequency_every_hop(void);
+
+//function definition
+//add the sample_index-th sample of a tone (frequency in hz, amplitude in g) on the x axis, with the board level (1g on z)
+static bool add_tone_sample(SPECTRAL_ANALYZER* analyzer, uint32_t sample_index, float frequency_hz, float amplitude_g, SPECTRAL_FEATURES* features, bool* features_availability)
+{
+    //local vars
+    static SAMPLE_BATCH batch;
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT] = {0};
+
+    values[SAMPLE_ACCEL_X] = (int16_t)lrintf((amplitude_g * sinf(2.0f * 3.14159265f * frequency_hz * ((float)sample_index / expected_sample_rate_hz))) / (float)expected_accel_scale_factor);
+    values[SAMPLE_ACCEL_Z] = (int16_t)lrintf(1.0f / (float)expected_accel_scale_factor);
+
+    clear_sample_batch(&batch);
+    set_sample_batch_scale_factors(&batch, expected_accel_scale_factor, 0.00008, 0.00875);
+
+    return append_sample_to_sample_batch(&batch, (int64_t)sample_index * 10000000, values) && add_sample_to_spectral_analyzer(analyzer, &batch, 0, features, features_availability);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The init_spectral_analyzer function should provide failure when:
+ *   - the window length (300, the default window summary length) is not a power of two
+ */
+static void test_init_spectral_analyzer_if_length_not_power_of_two_renders_failure(void)
+{
+    //local vars
+    static SPECTRAL_ANALYZER analyzer;
+
+    //test the specific behavior & assert the expected results
+    //the function should return "false" denoting operation failure (and "true" for the nearest power of two)
+    TEST_ASSERT_FALSE(init_spectral_analyzer(&analyzer, 300, 300, expected_sample_rate_hz));
+    TEST_ASSERT_TRUE(init_spectral_analyzer(&analyzer, 256, 256, expected_sample_rate_hz));
+}
+
+//function definition
+/*
+ *   Behavior Tested: The add_sample_to_spectral_analyzer function should provide the tone's frequency, amplitude, and band when:
+ *   - a 0.5g 15.625hz tone (exactly on bin 40 of a 256 sample window at 100hz) is on the x axis, with 1g of gravity on z
+ */
+static void test_add_sample_to_spectral_analyzer_if_tone_on_bin_renders_frequency_amplitude_and_band(void)
+{
+    //local vars
+    bool operation_status = true;
+    static SPECTRAL_ANALYZER analyzer;
+    SPECTRAL_FEATURES features;
+    bool features_availability = false;
+    uint32_t i;
+
+    //setup
+    TEST_ASSERT_TRUE(init_spectral_analyzer(&analyzer, 256, 256, expected_sample_rate_hz));
+
+    //test the specific behavior
+    for (i = 0; i < 256; i++)
+    {
+        TEST_ASSERT_FALSE(features_availability);
+        operation_status &= add_tone_sample(&analyzer, i, 15.625f, 0.5f, &features, &features_availability);
+    }
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure the features of the first window are available once it is full
+    TEST_ASSERT_TRUE(features_availability);
+    TEST_ASSERT_EQUAL_UINT32(0, features.spectrum_id);
+    TEST_ASSERT_TRUE(features.start_timestamp_ns == 0);
+    TEST_ASSERT_TRUE(features.end_timestamp_ns == 2550000000LL);
+    TEST_ASSERT_EQUAL_FLOAT(6.25f, features.band_width_hz);
+    //ensure the tone was found, with its rms (amplitude / sqrt(2)) all in the third band (12.5hz - 18.75hz)
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.625f, features.axes[0].dominant_frequency_hz);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.5f, features.axes[0].dominant_amplitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.35355f, features.axes[0].rms);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.125f, features.axes[0].band_energies[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, features.axes[0].band_energies[0]);
+    //ensure gravity (dc) was removed from z
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, features.axes[2].rms);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The add_sample_to_spectral_analyzer function should provide the interpolated frequency every hop samples when:
+ *   - a 0.25g 13hz tone (between bins 33 and 34 of a 256 sample window at 100hz) is added over sliding windows with a hop of 64
+ */
+static void test_add_sample_to_spectral_analyzer_if_sliding_tone_between_bins_renders_interpolated_frequency_every_hop(void)
+{
+    //local vars
+    bool operation_status = true;
+    static SPECTRAL_ANALYZER analyzer;
+    SPECTRAL_FEATURES features;
+    bool features_availability;
+    uint32_t features_count = 0;
+    uint32_t i;
+
+    //setup
+    TEST_ASSERT_TRUE(init_spectral_analyzer(&analyzer, 256, 64, expected_sample_rate_hz));
+
+    //test the specific behavior
+    for (i = 0; i < 448; i++)
+    {
+        operation_status &= add_tone_sample(&analyzer, i, 13.0f, 0.25f, &features, &features_availability);
+
+        //assert the expected results
+        //ensure features are available once the first window is full, then every hop
+        TEST_ASSERT_EQUAL((i >= 255) && (((i - 255) % 64) == 0), features_availability);
+        if (features_availability)
+        {
+            //ensure the frequency was refined to within a tenth of a bin (0.39hz bins)
+            TEST_ASSERT_FLOAT_WITHIN(0.04f, 13.0f, features.axes[0].dominant_frequency_hz);
+            TEST_ASSERT_EQUAL_UINT32(features_count++, features.spectrum_id);
+        }
+    }
+
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    TEST_ASSERT_EQUAL_UINT32(4, features_count);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_init_spectral_analyzer_if_length_not_power_of_two_renders_failure);
+    RUN_TEST(test_add_sample_to_spectral_analyzer_if_tone_on_bin_renders_frequency_amplitude_and_band);
+    RUN_TEST(test_add_sample_to_spectral_analyzer_if_sliding_tone_between_bins_renders_interpolated_frequency_every_hop);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
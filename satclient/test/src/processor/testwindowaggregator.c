@@ -0,0 +1,201 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+*/
+
+#include <stdlib.h>             //using for "rand" and "srand" functions
+#include <math.h>               //using for "sqrt" function
+#include "unity.h"
+#include "windowaggregator.h"
+
+//global vars
+static const double expected_accel_scale_factor = 0.000061;
+static const double expected_magneto_scale_factor = 0.00008;
+static const double expected_gyro_scale_factor = 0.00875;
+
+//function declarations
+static void append_filled_sample(SAMPLE_BATCH*, int16_t, int64_t);
+static void test_init_window_aggregator_if_sliding_hop_exceeds_length_renders_failure(void);
+static void test_add_sample_to_window_aggregator_if_tumbling_window_filled_renders_valid_summary(void);
+static void test_add_sample_to_window_aggregator_if_sliding_window_renders_same_summary_as_recomputing_window(void);
+
+//function definition
+//replace the batch's contents with a sample that has the same value on every axis (the gyro axes are negated so min/max are exercised in both directions)
+static void append_filled_sample(SAMPLE_BATCH* batch, int16_t value, int64_t timestamp_ns)
+{
+    //local vars
+    int16_t values[SAMPLE_BATCH_AXIS_COUNT];
+    uint32_t i;
+
+    for (i = 0; i < 3; i++)
+    {
+        values[SAMPLE_ACCEL_X + i] = value;
+        values[SAMPLE_MAGNETO_X + i] = value;
+        values[SAMPLE_GYRO_X + i] = -value;
+    }
+
+    clear_sample_batch(batch);
+    append_sample_to_sample_batch(batch, timestamp_ns, values);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The init_window_aggregator function should provide failure when:
+ *   - a sliding window's hop is longer than the window (some samples would never be summarized)
+ */
+static void test_init_window_aggregator_if_sliding_hop_exceeds_length_renders_failure(void)
+{
+    //local vars
+    bool operation_status;
+    static WINDOW_AGGREGATOR aggregator;
+
+    //test the specific behavior
+    operation_status = init_window_aggregator(&aggregator, SLIDING_WINDOW, 10, 11, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor);
+
+    //assert the expected results
+    //the function should return "false" denoting operation failure
+    TEST_ASSERT_FALSE(operation_status);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The add_sample_to_window_aggregator function should provide a valid summary when:
+ *   - a tumbling window of 4 samples is filled with the raw values 1, -3, 5, 9
+ *   - and no summary for the samples before the window filled
+ */
+static void test_add_sample_to_window_aggregator_if_tumbling_window_filled_renders_valid_summary(void)
+{
+    //local vars
+    bool operation_status = true;
+    bool summary_availability;
+    uint32_t summary_count = 0;
+    static WINDOW_AGGREGATOR aggregator;
+    WINDOW_SUMMARY summary;
+    static SAMPLE_BATCH batch;
+    const int16_t values[] = {1, -3, 5, 9};
+    uint32_t i;
+
+    //setup
+    TEST_ASSERT_TRUE(init_window_aggregator(&aggregator, TUMBLING_WINDOW, 4, 0, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor));
+
+    //test the specific behavior
+    for (i = 0; i < 4; i++)
+    {
+        append_filled_sample(&batch, values[i], 1000 + i);
+        operation_status &= add_sample_to_window_aggregator(&aggregator, &batch, 0, &summary, &summary_availability);
+        summary_count += summary_availability ? 1 : 0;
+    }
+
+    //assert the expected results
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    //ensure only the last sample completed the window
+    TEST_ASSERT_TRUE(summary_availability);
+    TEST_ASSERT_EQUAL_UINT32(1, summary_count);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.window_id);
+    TEST_ASSERT_EQUAL_UINT32(4, summary.sample_count);
+    TEST_ASSERT_TRUE(summary.start_timestamp_ns == 1000);
+    TEST_ASSERT_TRUE(summary.end_timestamp_ns == 1003);
+    //ensure the statistics are valid (mean 3, min -3, max 9, rms sqrt(29), variance 20, peak to peak 12) - accel x
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 3 * expected_accel_scale_factor, summary.axes[0].mean);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, -3 * expected_accel_scale_factor, summary.axes[0].min);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 9 * expected_accel_scale_factor, summary.axes[0].max);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, sqrt(29) * expected_accel_scale_factor, summary.axes[0].rms);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 20 * expected_accel_scale_factor * expected_accel_scale_factor, summary.axes[0].variance);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 12 * expected_accel_scale_factor, summary.axes[0].peak_to_peak);
+    //ensure the negated gyro z axis has its min/max swapped
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, -9 * expected_gyro_scale_factor, summary.axes[8].min);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 3 * expected_gyro_scale_factor, summary.axes[8].max);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The add_sample_to_window_aggregator function should provide the same summary as recomputing the window from scratch when:
+ *   - a sliding window of 7 samples with a hop of 3 is fed 500 random samples (long enough for every position and queue to wrap many times)
+ */
+static void test_add_sample_to_window_aggregator_if_sliding_window_renders_same_summary_as_recomputing_window(void)
+{
+    //local vars
+    bool operation_status = true;
+    bool summary_availability;
+    uint32_t summary_count = 0;
+    static WINDOW_AGGREGATOR aggregator;
+    WINDOW_SUMMARY summary;
+    static SAMPLE_BATCH batch;
+    int16_t values[500];
+    int64_t sum;
+    int64_t sum_of_squares;
+    int16_t min;
+    int16_t max;
+    uint32_t i;
+    uint32_t j;
+
+    //setup
+    srand(1);
+    TEST_ASSERT_TRUE(init_window_aggregator(&aggregator, SLIDING_WINDOW, 7, 3, expected_accel_scale_factor, expected_magneto_scale_factor, expected_gyro_scale_factor));
+
+    for (i = 0; i < 500; i++)
+    {
+        //small range so repeated values (ties in the min/max queues) are common
+        values[i] = (int16_t)((rand() % 41) - 20);
+
+        //test the specific behavior
+        append_filled_sample(&batch, values[i], i);
+        operation_status &= add_sample_to_window_aggregator(&aggregator, &batch, 0, &summary, &summary_availability);
+
+        //assert the expected results
+        //summaries start once the window is full, then come every hop samples
+        TEST_ASSERT_EQUAL((i >= 6) && (((i - 6) % 3) == 0), summary_availability);
+        if (summary_availability)
+        {
+            //recompute the window from scratch
+            sum = 0;
+            sum_of_squares = 0;
+            min = values[i];
+            max = values[i];
+            for (j = i - 6; j <= i; j++)
+            {
+                sum += values[j];
+                sum_of_squares += values[j] * values[j];
+                min = (values[j] < min) ? values[j] : min;
+                max = (values[j] > max) ? values[j] : max;
+            }
+
+            TEST_ASSERT_EQUAL_UINT32(summary_count, summary.window_id);
+            TEST_ASSERT_EQUAL_UINT32(7, summary.sample_count);
+            TEST_ASSERT_TRUE(summary.start_timestamp_ns == (i - 6));
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, (sum / 7.0) * expected_magneto_scale_factor, summary.axes[4].mean);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, min * expected_magneto_scale_factor, summary.axes[4].min);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, max * expected_magneto_scale_factor, summary.axes[4].max);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, sqrt(sum_of_squares / 7.0) * expected_magneto_scale_factor, summary.axes[4].rms);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, ((sum_of_squares / 7.0) - ((sum / 7.0) * (sum / 7.0))) * expected_magneto_scale_factor * expected_magneto_scale_factor, summary.axes[4].variance);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, -min * expected_gyro_scale_factor, summary.axes[7].max);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-12, (max - min) * expected_gyro_scale_factor, summary.axes[7].peak_to_peak);
+            summary_count++;
+        }
+    }
+
+    //the function should return "true" denoting operation success
+    TEST_ASSERT_TRUE(operation_status);
+    TEST_ASSERT_EQUAL_UINT32(165, summary_count);
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_init_window_aggregator_if_sliding_hop_exceeds_length_renders_failure);
+    RUN_TEST(test_add_sample_to_window_aggregator_if_tumbling_window_filled_renders_valid_summary);
+    RUN_TEST(test_add_sample_to_window_aggregator_if_sliding_window_renders_same_summary_as_recomputing_window);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}
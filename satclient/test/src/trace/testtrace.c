@@ -0,0 +1,172 @@
+/*
+   Author: James Beasley
+   Repo: https://github.com/embeddedcognition/satclient
+
+   Tests in this suite are of the form:
+   Test Name: test_[Name of function being tested]_[condition tested]_renders_[expected result]
+   Behavior Tested: The [Name of function being tested] function should provide [expected result] when [condition tested] is applied.
+
+   (built with -DSATCLIENT_TRACE, so the trace macros are compiled in)
+*/
+
+#include <stdio.h>              //using for "fopen", "fread", and "remove" functions
+#include <string.h>             //using for "strstr" and "strncmp" functions
+#include <pthread.h>            //using for the recording threads
+#include "unity.h"
+#include "trace.h"
+
+//global vars
+#define RECORDING_THREAD_COUNT 2
+static const char expected_trace_file[] = "/tmp/testtrace.json";
+static const uint32_t expected_spans_per_thread = 1000;     //fewer than a ring holds, so none are dropped
+static const char* const THREAD_NAMES[RECORDING_THREAD_COUNT] = {"recorder one", "recorder two"};
+static char trace[4194304];
+
+//function declarations
+static void* record_spans(void*);
+static void* overflow_ring(void*);
+static uint32_t count_occurrences(const char*, const char*);
+static void test_record_trace_event_if_ring_full_renders_dropped_events(void);
+static void test_new_trace_writer_if_several_threads_record_renders_chrome_trace_of_every_event(void);
+
+//function definition
+//name the thread, then record expected_spans_per_thread spans, each with an instant and a counter inside it
+static void* record_spans(void* parameter)
+{
+    //local vars
+    uint32_t i;
+
+    TRACE_THREAD_NAME((const char*)parameter);
+    for (i = 0; i < expected_spans_per_thread; i++)
+    {
+        TRACE_BEGIN("test span");
+        TRACE_INSTANT("test instant", i);
+        TRACE_COUNTER("test counter", i);
+        TRACE_END_WITH_VALUE("test span", -7);
+    }
+
+    return NULL;
+}
+
+//function definition
+//record 10 more events than the (fresh) ring holds, with no writer draining it
+static void* overflow_ring(void* parameter)
+{
+    //local vars
+    uint32_t i;
+
+    (void)parameter;
+    for (i = 0; i < (TRACE_RING_SIZE + 10); i++)
+    {
+        TRACE_INSTANT("overflow instant", i);
+    }
+
+    return NULL;
+}
+
+//function definition
+//count the occurrences of a string in another
+static uint32_t count_occurrences(const char* text, const char* pattern)
+{
+    //local vars
+    uint32_t count = 0;
+
+    while ((text = strstr(text, pattern)) != NULL)
+    {
+        count++;
+        text++;
+    }
+
+    return count;
+}
+
+//function definition
+/*
+ *   Behavior Tested: The record_trace_event function should provide dropped events (rather than waiting) when:
+ *   - a thread records 10 more events than its ring holds, with no trace writer draining it
+ */
+static void test_record_trace_event_if_ring_full_renders_dropped_events(void)
+{
+    //local vars
+    uint64_t dropped_count;
+    pthread_t thread;
+
+    //setup
+    dropped_count = get_trace_dropped_event_count();
+
+    //test the specific behavior
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, overflow_ring, NULL));
+    pthread_join(thread, NULL);
+
+    //assert the expected results
+    //ensure exactly the events past the ring's capacity were dropped
+    TEST_ASSERT_EQUAL_UINT64(10, get_trace_dropped_event_count() - dropped_count);
+}
+
+//function definition
+/*
+ *   Behavior Tested: The new_trace_writer function should provide a chrome trace of every event when:
+ *   - two named threads record spans, instants, and counters while the writer drains their rings
+ */
+static void test_new_trace_writer_if_several_threads_record_renders_chrome_trace_of_every_event(void)
+{
+    //local vars
+    TRACE_WRITER* writer;
+    pthread_t threads[RECORDING_THREAD_COUNT];
+    FILE* file;
+    size_t trace_size;
+    uint32_t i;
+
+    //setup
+    writer = new_trace_writer(expected_trace_file, 10);
+    TEST_ASSERT_NOT_NULL(writer);
+
+    //test the specific behavior
+    for (i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&(threads[i]), NULL, record_spans, (void*)THREAD_NAMES[i]));
+    }
+    for (i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free_trace_writer(writer);
+
+    //read the trace back
+    file = fopen(expected_trace_file, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    trace_size = fread(trace, 1, sizeof (trace) - 1, file);
+    trace[trace_size] = '\0';
+    fclose(file);
+    remove(expected_trace_file);
+
+    //assert the expected results
+    //ensure the trace is a complete chrome trace, with every thread named and every event in it
+    TEST_ASSERT_EQUAL_INT(0, strncmp(trace, "{\"traceEvents\":[\n", 16));
+    TEST_ASSERT_NOT_NULL(strstr(trace, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":"));
+    TEST_ASSERT_NOT_NULL(strstr(trace, "\"ph\":\"M\",\"pid\":"));
+    TEST_ASSERT_NOT_NULL(strstr(trace, "\"args\":{\"name\":\"recorder one\"}}"));
+    TEST_ASSERT_NOT_NULL(strstr(trace, "\"args\":{\"name\":\"recorder two\"}}"));
+    TEST_ASSERT_EQUAL_UINT32(RECORDING_THREAD_COUNT * expected_spans_per_thread, count_occurrences(trace, "{\"name\":\"test span\",\"ph\":\"B\""));
+    TEST_ASSERT_EQUAL_UINT32(RECORDING_THREAD_COUNT * expected_spans_per_thread, count_occurrences(trace, "{\"name\":\"test span\",\"ph\":\"E\""));
+    TEST_ASSERT_EQUAL_UINT32(RECORDING_THREAD_COUNT * expected_spans_per_thread, count_occurrences(trace, "\"args\":{\"value\":-7}}"));
+    TEST_ASSERT_EQUAL_UINT32(RECORDING_THREAD_COUNT * expected_spans_per_thread, count_occurrences(trace, "{\"name\":\"test instant\",\"ph\":\"i\""));
+    TEST_ASSERT_EQUAL_UINT32(RECORDING_THREAD_COUNT * expected_spans_per_thread, count_occurrences(trace, "{\"name\":\"test counter\",\"ph\":\"C\""));
+    //ensure the events of the earlier test's full ring were written (up to its capacity)
+    TEST_ASSERT_EQUAL_UINT32(TRACE_RING_SIZE, count_occurrences(trace, "{\"name\":\"overflow instant\""));
+}
+
+//function definition
+//main thread of execution
+int main(void)
+{
+    //setup
+    UNITY_BEGIN();
+
+    //run tests
+    RUN_TEST(test_record_trace_event_if_ring_full_renders_dropped_events);
+    RUN_TEST(test_new_trace_writer_if_several_threads_record_renders_chrome_trace_of_every_event);
+
+    //tear down & display test results, returns the number of tests that failed
+    return UNITY_END();
+}